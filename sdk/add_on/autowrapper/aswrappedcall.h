@@ -8,6 +8,13 @@
 
 #include <new>
 
+// The variadic templates are used when the compiler supports C++11. Define
+// AS_NO_VARIADIC_WRAPPERS to use the fixed arity templates regardless.
+#if !defined(AS_NO_VARIADIC_WRAPPERS) && (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1800))
+	#define AS_VARIADIC_WRAPPERS
+	#include <type_traits>
+#endif
+
 namespace gw {
 
 template <typename T> class Proxy {
@@ -31,6 +38,192 @@ template <typename T>
 void destroy(asIScriptGeneric * gen) {
   static_cast<T *>(gen->GetObject())->~T();
 }
+
+#ifdef AS_VARIADIC_WRAPPERS
+
+// With variadic templates the arguments are read directly from the
+// argument buffer of the generic interface. The offset of each argument
+// is computed at compile time from the C++ type, so each wrapper compiles
+// into a single function with no loops or calls per argument.
+
+// Number of dwords the argument occupies on the script stack. References,
+// handles and objects passed by value are all passed as pointers.
+template <typename A> struct ArgSize {
+	enum { value = (std::is_reference<A>::value || std::is_pointer<A>::value || std::is_class<typename std::remove_cv<A>::type>::value) ? 
+	               int(sizeof(void*)/4) : int((sizeof(A)+3)/4) };
+};
+
+template <int N, typename... A> struct ArgOffset;
+template <typename A0, typename... A> struct ArgOffset<0, A0, A...> {
+	enum { value = 0 };
+};
+template <int N, typename A0, typename... A> struct ArgOffset<N, A0, A...> {
+	enum { value = ArgSize<A0>::value + ArgOffset<N-1, A...>::value };
+};
+
+template <int N, typename... A> struct ArgType;
+template <typename A0, typename... A> struct ArgType<0, A0, A...> {
+	typedef A0 type;
+};
+template <int N, typename A0, typename... A> struct ArgType<N, A0, A...> {
+	typedef typename ArgType<N-1, A...>::type type;
+};
+
+template <int... I> struct Indices {};
+template <int N, int... I> struct MakeIndices : MakeIndices<N-1, N-1, I...> {};
+template <int... I> struct MakeIndices<0, I...> {
+	typedef Indices<I...> type;
+};
+
+// Primitives, enums and handles are stored in place
+template <typename A, bool isObj = std::is_class<typename std::remove_cv<A>::type>::value> struct Arg {
+	static A get(AS_NAMESPACE_QUALIFIER asDWORD * p) { return *reinterpret_cast<A *>(p); }
+};
+// References are stored as a pointer to the value
+template <typename A> struct Arg<A &, false> {
+	static A & get(AS_NAMESPACE_QUALIFIER asDWORD * p) { return **reinterpret_cast<A **>(p); }
+};
+// Objects passed by value are stored as a pointer to the object
+template <typename A> struct Arg<A, true> {
+	static A & get(AS_NAMESPACE_QUALIFIER asDWORD * p) { return **reinterpret_cast<A **>(p); }
+};
+
+template <typename R, typename... A>
+struct Wrapper<R (*)(A...)> {
+	template <R (*fp)(A...), int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		new (gen->GetAddressOfReturnLocation()) Proxy<R>((fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...));
+	}
+	template <R (*fp)(A...)>
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());
+	}
+};
+template <typename... A>
+struct Wrapper<void (*)(A...)> {
+	template <void (*fp)(A...), int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		(fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...);
+	}
+	template <void (*fp)(A...)>
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());
+	}
+};
+template <typename T, typename R, typename... A>
+struct Wrapper<R (T::*)(A...)> {
+	template <R (T::*fp)(A...), int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		new (gen->GetAddressOfReturnLocation()) Proxy<R>((static_cast<T *>(gen->GetObject())->*fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...));
+	}
+	template <R (T::*fp)(A...)>
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());
+	}
+};
+template <typename T, typename... A>
+struct Wrapper<void (T::*)(A...)> {
+	template <void (T::*fp)(A...), int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		(static_cast<T *>(gen->GetObject())->*fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...);
+	}
+	template <void (T::*fp)(A...)>
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());
+	}
+};
+template <typename T, typename R, typename... A>
+struct Wrapper<R (T::*)(A...) const> {
+	template <R (T::*fp)(A...) const, int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		new (gen->GetAddressOfReturnLocation()) Proxy<R>((static_cast<T *>(gen->GetObject())->*fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...));
+	}
+	template <R (T::*fp)(A...) const>
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());
+	}
+};
+template <typename T, typename... A>
+struct Wrapper<void (T::*)(A...) const> {
+	template <void (T::*fp)(A...) const, int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		(static_cast<T *>(gen->GetObject())->*fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...);
+	}
+	template <void (T::*fp)(A...) const>
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());
+	}
+};
+template <typename T, typename R, typename... A>
+struct ObjFirst<R (*)(T, A...)> {
+	template <R (*fp)(T, A...), int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		new (gen->GetAddressOfReturnLocation()) Proxy<R>((fp)(Proxy<T>::cast(gen->GetObject()), Arg<A>::get(args + ArgOffset<I, A...>::value)...));
+	}
+	template <R (*fp)(T, A...)>
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());
+	}
+};
+template <typename T, typename... A>
+struct ObjFirst<void (*)(T, A...)> {
+	template <void (*fp)(T, A...), int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		(fp)(Proxy<T>::cast(gen->GetObject()), Arg<A>::get(args + ArgOffset<I, A...>::value)...);
+	}
+	template <void (*fp)(T, A...)>
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());
+	}
+};
+// The object is the last parameter, so the script arguments are all but the last
+template <typename R, typename... A>
+struct ObjLast<R (*)(A...)> {
+	typedef typename ArgType<sizeof...(A)-1, A...>::type T;
+	template <R (*fp)(A...), int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		new (gen->GetAddressOfReturnLocation()) Proxy<R>((fp)(Arg<typename ArgType<I, A...>::type>::get(args + ArgOffset<I, A...>::value)..., Proxy<T>::cast(gen->GetObject())));
+	}
+	template <R (*fp)(A...)>
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call<fp>(gen, typename MakeIndices<sizeof...(A)-1>::type());
+	}
+};
+template <typename... A>
+struct ObjLast<void (*)(A...)> {
+	typedef typename ArgType<sizeof...(A)-1, A...>::type T;
+	template <void (*fp)(A...), int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		(fp)(Arg<typename ArgType<I, A...>::type>::get(args + ArgOffset<I, A...>::value)..., Proxy<T>::cast(gen->GetObject()));
+	}
+	template <void (*fp)(A...)>
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call<fp>(gen, typename MakeIndices<sizeof...(A)-1>::type());
+	}
+};
+template <typename T, typename... A>
+struct Constructor <T (A...)> {
+	template <int... I>
+	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {
+		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;
+		new (gen->GetObject()) T(Arg<A>::get(args + ArgOffset<I, A...>::value)...);
+	}
+	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {
+		call(gen, typename MakeIndices<sizeof...(A)>::type());
+	}
+};
+
+#else
 template <>
 struct Wrapper<void (*)(void)> {
 	template <void (*fp)(void)>
@@ -541,6 +734,9 @@ struct Constructor <T (A0, A1, A2, A3)> {
 				static_cast<Proxy <A3> *>(gen->GetAddressOfArg(3))->value);
 	}
 };
+
+#endif // AS_VARIADIC_WRAPPERS
+
 template <typename T>
 struct Id {
 	template <T fn_ptr> AS_NAMESPACE_QUALIFIER asSFuncPtr  f(void) { return asFUNCTION(&Wrapper<T>::template f<fn_ptr>); }
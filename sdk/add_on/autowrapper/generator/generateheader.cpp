@@ -35,6 +35,13 @@ int main()
 	"#endif\n"
 	"#include <new>\n"
 	"\n"
+	"// The variadic templates are used when the compiler supports C++11. Define\n"
+	"// AS_NO_VARIADIC_WRAPPERS to use the fixed arity templates regardless.\n"
+	"#if !defined(AS_NO_VARIADIC_WRAPPERS) && (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1800))\n"
+	"	#define AS_VARIADIC_WRAPPERS\n"
+	"	#include <type_traits>\n"
+	"#endif\n"
+	"\n"
 	"namespace gw {\n"
 	"\n"
 	"template <typename T> class Proxy {\n"
@@ -59,6 +66,195 @@ int main()
 	"	static_cast<T *>(gen->GetObject())->~T();\n"
 	"}\n");
 
+	// The variadic templates are printed as is, the fixed arity templates below
+	// are only used by compilers that don't support C++11
+	printf("\n"
+	"#ifdef AS_VARIADIC_WRAPPERS\n"
+	"\n"
+	"// With variadic templates the arguments are read directly from the\n"
+	"// argument buffer of the generic interface. The offset of each argument\n"
+	"// is computed at compile time from the C++ type, so each wrapper compiles\n"
+	"// into a single function with no loops or calls per argument.\n"
+	"\n"
+	"// Number of dwords the argument occupies on the script stack. References,\n"
+	"// handles and objects passed by value are all passed as pointers.\n"
+	"template <typename A> struct ArgSize {\n"
+	"	enum { value = (std::is_reference<A>::value || std::is_pointer<A>::value || std::is_class<typename std::remove_cv<A>::type>::value) ? \n"
+	"	               int(sizeof(void*)/4) : int((sizeof(A)+3)/4) };\n"
+	"};\n"
+	"\n"
+	"template <int N, typename... A> struct ArgOffset;\n"
+	"template <typename A0, typename... A> struct ArgOffset<0, A0, A...> {\n"
+	"	enum { value = 0 };\n"
+	"};\n"
+	"template <int N, typename A0, typename... A> struct ArgOffset<N, A0, A...> {\n"
+	"	enum { value = ArgSize<A0>::value + ArgOffset<N-1, A...>::value };\n"
+	"};\n"
+	"\n"
+	"template <int N, typename... A> struct ArgType;\n"
+	"template <typename A0, typename... A> struct ArgType<0, A0, A...> {\n"
+	"	typedef A0 type;\n"
+	"};\n"
+	"template <int N, typename A0, typename... A> struct ArgType<N, A0, A...> {\n"
+	"	typedef typename ArgType<N-1, A...>::type type;\n"
+	"};\n"
+	"\n"
+	"template <int... I> struct Indices {};\n"
+	"template <int N, int... I> struct MakeIndices : MakeIndices<N-1, N-1, I...> {};\n"
+	"template <int... I> struct MakeIndices<0, I...> {\n"
+	"	typedef Indices<I...> type;\n"
+	"};\n"
+	"\n"
+	"// Primitives, enums and handles are stored in place\n"
+	"template <typename A, bool isObj = std::is_class<typename std::remove_cv<A>::type>::value> struct Arg {\n"
+	"	static A get(AS_NAMESPACE_QUALIFIER asDWORD * p) { return *reinterpret_cast<A *>(p); }\n"
+	"};\n"
+	"// References are stored as a pointer to the value\n"
+	"template <typename A> struct Arg<A &, false> {\n"
+	"	static A & get(AS_NAMESPACE_QUALIFIER asDWORD * p) { return **reinterpret_cast<A **>(p); }\n"
+	"};\n"
+	"// Objects passed by value are stored as a pointer to the object\n"
+	"template <typename A> struct Arg<A, true> {\n"
+	"	static A & get(AS_NAMESPACE_QUALIFIER asDWORD * p) { return **reinterpret_cast<A **>(p); }\n"
+	"};\n"
+	"\n"
+	"template <typename R, typename... A>\n"
+	"struct Wrapper<R (*)(A...)> {\n"
+	"	template <R (*fp)(A...), int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		new (gen->GetAddressOfReturnLocation()) Proxy<R>((fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...));\n"
+	"	}\n"
+	"	template <R (*fp)(A...)>\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());\n"
+	"	}\n"
+	"};\n"
+	"template <typename... A>\n"
+	"struct Wrapper<void (*)(A...)> {\n"
+	"	template <void (*fp)(A...), int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		(fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...);\n"
+	"	}\n"
+	"	template <void (*fp)(A...)>\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());\n"
+	"	}\n"
+	"};\n"
+	"template <typename T, typename R, typename... A>\n"
+	"struct Wrapper<R (T::*)(A...)> {\n"
+	"	template <R (T::*fp)(A...), int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		new (gen->GetAddressOfReturnLocation()) Proxy<R>((static_cast<T *>(gen->GetObject())->*fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...));\n"
+	"	}\n"
+	"	template <R (T::*fp)(A...)>\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());\n"
+	"	}\n"
+	"};\n"
+	"template <typename T, typename... A>\n"
+	"struct Wrapper<void (T::*)(A...)> {\n"
+	"	template <void (T::*fp)(A...), int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		(static_cast<T *>(gen->GetObject())->*fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...);\n"
+	"	}\n"
+	"	template <void (T::*fp)(A...)>\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());\n"
+	"	}\n"
+	"};\n"
+	"template <typename T, typename R, typename... A>\n"
+	"struct Wrapper<R (T::*)(A...) const> {\n"
+	"	template <R (T::*fp)(A...) const, int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		new (gen->GetAddressOfReturnLocation()) Proxy<R>((static_cast<T *>(gen->GetObject())->*fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...));\n"
+	"	}\n"
+	"	template <R (T::*fp)(A...) const>\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());\n"
+	"	}\n"
+	"};\n"
+	"template <typename T, typename... A>\n"
+	"struct Wrapper<void (T::*)(A...) const> {\n"
+	"	template <void (T::*fp)(A...) const, int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		(static_cast<T *>(gen->GetObject())->*fp)(Arg<A>::get(args + ArgOffset<I, A...>::value)...);\n"
+	"	}\n"
+	"	template <void (T::*fp)(A...) const>\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());\n"
+	"	}\n"
+	"};\n"
+	"template <typename T, typename R, typename... A>\n"
+	"struct ObjFirst<R (*)(T, A...)> {\n"
+	"	template <R (*fp)(T, A...), int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		new (gen->GetAddressOfReturnLocation()) Proxy<R>((fp)(Proxy<T>::cast(gen->GetObject()), Arg<A>::get(args + ArgOffset<I, A...>::value)...));\n"
+	"	}\n"
+	"	template <R (*fp)(T, A...)>\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());\n"
+	"	}\n"
+	"};\n"
+	"template <typename T, typename... A>\n"
+	"struct ObjFirst<void (*)(T, A...)> {\n"
+	"	template <void (*fp)(T, A...), int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		(fp)(Proxy<T>::cast(gen->GetObject()), Arg<A>::get(args + ArgOffset<I, A...>::value)...);\n"
+	"	}\n"
+	"	template <void (*fp)(T, A...)>\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call<fp>(gen, typename MakeIndices<sizeof...(A)>::type());\n"
+	"	}\n"
+	"};\n"
+	"// The object is the last parameter, so the script arguments are all but the last\n"
+	"template <typename R, typename... A>\n"
+	"struct ObjLast<R (*)(A...)> {\n"
+	"	typedef typename ArgType<sizeof...(A)-1, A...>::type T;\n"
+	"	template <R (*fp)(A...), int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		new (gen->GetAddressOfReturnLocation()) Proxy<R>((fp)(Arg<typename ArgType<I, A...>::type>::get(args + ArgOffset<I, A...>::value)..., Proxy<T>::cast(gen->GetObject())));\n"
+	"	}\n"
+	"	template <R (*fp)(A...)>\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call<fp>(gen, typename MakeIndices<sizeof...(A)-1>::type());\n"
+	"	}\n"
+	"};\n"
+	"template <typename... A>\n"
+	"struct ObjLast<void (*)(A...)> {\n"
+	"	typedef typename ArgType<sizeof...(A)-1, A...>::type T;\n"
+	"	template <void (*fp)(A...), int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		(fp)(Arg<typename ArgType<I, A...>::type>::get(args + ArgOffset<I, A...>::value)..., Proxy<T>::cast(gen->GetObject()));\n"
+	"	}\n"
+	"	template <void (*fp)(A...)>\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call<fp>(gen, typename MakeIndices<sizeof...(A)-1>::type());\n"
+	"	}\n"
+	"};\n"
+	"template <typename T, typename... A>\n"
+	"struct Constructor <T (A...)> {\n"
+	"	template <int... I>\n"
+	"	static void call(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen, Indices<I...>) {\n"
+	"		AS_NAMESPACE_QUALIFIER asDWORD * args = static_cast<AS_NAMESPACE_QUALIFIER asDWORD *>(gen->GetAddressOfArgs()); (void)args;\n"
+	"		new (gen->GetObject()) T(Arg<A>::get(args + ArgOffset<I, A...>::value)...);\n"
+	"	}\n"
+	"	static void f(AS_NAMESPACE_QUALIFIER asIScriptGeneric * gen) {\n"
+	"		call(gen, typename MakeIndices<sizeof...(A)>::type());\n"
+	"	}\n"
+	"};\n"
+	"\n"
+	"#else\n");
+
 	string typename_list = "typename A0";
 	string type_list     = "A0";
 	string arg_list      = "\n				static_cast<Proxy <A0> *>(gen->GetAddressOfArg(0))->value";
@@ -103,7 +299,10 @@ int main()
 		arg_list      += ",\n				static_cast<Proxy <A" + string(buf) + "> *>(gen->GetAddressOfArg(" + string(buf) + "))->value";
 	}
 
-	printf("template <typename T>\n"
+	printf("\n"
+	"#endif // AS_VARIADIC_WRAPPERS\n"
+	"\n"
+	"template <typename T>\n"
 	"struct Id {\n"
 	"	template <T fn_ptr> AS_NAMESPACE_QUALIFIER asSFuncPtr  f(void) { return asFUNCTION(&Wrapper<T>::template f<fn_ptr>); }\n"
 	"	template <T fn_ptr> AS_NAMESPACE_QUALIFIER asSFuncPtr of(void) { return asFUNCTION(&ObjFirst<T>::template f<fn_ptr>); }\n"
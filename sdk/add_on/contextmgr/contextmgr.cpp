@@ -1,5 +1,7 @@
 #include <assert.h>
 #include <string>
+#include <deque>
+#include <algorithm>
 
 #include "contextmgr.h"
 
@@ -16,14 +18,54 @@ using namespace std;
 
 BEGIN_AS_NAMESPACE
 
+#ifdef AS_CONTEXTMGR_THREADS
+	// Each worker thread keeps track of the manager and script it is executing
+	#define CONTEXTMGR_THREAD_LOCAL thread_local
+	#define CONTEXTMGR_LOCK(x) std::lock_guard<std::mutex> contextMgrLock(x)
+#else
+	#define CONTEXTMGR_THREAD_LOCAL
+	#define CONTEXTMGR_LOCK(x)
+#endif
+
 struct SContextInfo
 {
     asUINT sleepUntil;
-	vector<asIScriptContext*> coRoutines;
-	asUINT currentCoRoutine;
+	bool   isSleeping;
+	bool   inSleepQueue;
+	asIScriptContext *ctx;
+	vector<asIScriptCoroutine*> coRoutines;
+	asUINT currentCoRoutine; // 0 is the main script function, n is coRoutines[n-1]
+	asUINT index;            // The position in m_threads
+	asUINT worker;           // The worker thread that last executed the script
+};
+
+struct SWorker
+{
+	// The scripts this worker will execute in the current call to ExecuteScripts(). The 
+	// worker takes them from the front, and other workers steal from the back when idle
+	deque<SContextInfo*> queue;
+#ifdef AS_CONTEXTMGR_THREADS
+	std::mutex           queueLock;
+#endif
+
+	// The outcome of the executions, which the manager gathers when all workers are done
+	vector<SContextInfo*> ready;
+	vector<SContextInfo*> sleeping;
+	vector<SContextInfo*> finished;
+	asUINT                numExecutions;
+	asUINT                numGCObjectsCreated;
+	asUINT                numGCObjectsDestroyed;
 };
 
-static CContextMgr *g_ctxMgr = 0;
+static CONTEXTMGR_THREAD_LOCAL CContextMgr  *g_ctxMgr = 0;
+static CONTEXTMGR_THREAD_LOCAL SContextInfo *g_currentThread = 0;
+
+// The heap of sleeping scripts keeps the one that wakes up first at the front
+static bool WakesUpLater(const SContextInfo *a, const SContextInfo *b)
+{
+	return a->sleepUntil > b->sleepUntil;
+}
+
 static void ScriptSleep(asUINT milliSeconds)
 {
 	// Get a pointer to the context that is currently being executed
@@ -73,28 +115,62 @@ void ScriptCreateCoRoutine(string &func, CScriptAny *arg)
 			return;
 		}
 
-		// Create a new context for the co-routine
-		asIScriptContext *coctx = g_ctxMgr->AddContextForCoRoutine(ctx, func);
+		if( g_ctxMgr->GetLightWeightCoRoutines() )
+		{
+			// Create the co-routine in the current context
+			asIScriptCoroutine *co = g_ctxMgr->AddCoRoutine(ctx, func);
+			if( co == 0 )
+			{
+				ctx->SetException("Failed to create the co-routine");
+				return;
+			}
 
-		// Pass the argument to the context
-		coctx->SetArgObject(0, arg);
+			// Pass the argument to the co-routine
+			co->SetArgObject(0, arg);
+		}
+		else
+		{
+			// Create a new context for the co-routine
+			asIScriptContext *coctx = g_ctxMgr->AddContextForCoRoutine(ctx, func);
+			if( coctx == 0 )
+			{
+				ctx->SetException("Failed to create the co-routine");
+				return;
+			}
+
+			// Pass the argument to the context
+			coctx->SetArgObject(0, arg);
+		}
 	}
 }
 
 CContextMgr::CContextMgr()
 {
     m_getTimeFunc   = 0;
-	m_currentThread = 0;
+	m_lightWeightCoRoutines = false;
 
 	m_numExecutions         = 0;
 	m_numGCObjectsCreated   = 0;
 	m_numGCObjectsDestroyed = 0;
+
+	// The calling thread is always the first worker
+	m_workers.push_back(new SWorker);
+	m_nextWorker = 0;
+
+#ifdef AS_CONTEXTMGR_THREADS
+	m_workRound   = 0;
+	m_busyWorkers = 0;
+	m_stopWorkers = false;
+#endif
 }
 
 CContextMgr::~CContextMgr()
 {
 	asUINT n;
 
+	SetWorkerThreadCount(1);
+	delete m_workers[0];
+
 	// Free the memory
 	for( n = 0; n < m_threads.size(); n++ )
 	{
@@ -106,6 +182,9 @@ CContextMgr::~CContextMgr()
 					m_threads[n]->coRoutines[c]->Release();
 			}
 
+			if( m_threads[n]->ctx )
+				m_threads[n]->ctx->Release();
+
 			delete m_threads[n];
 		}
 	}
@@ -121,10 +200,148 @@ CContextMgr::~CContextMgr()
 	}
 }
 
-void CContextMgr::ExecuteScripts()
+int CContextMgr::SetWorkerThreadCount(asUINT numThreads)
+{
+	if( numThreads == 0 )
+		return asINVALID_ARG;
+
+#ifdef AS_CONTEXTMGR_THREADS
+	if( numThreads == m_workers.size() )
+		return 0;
+
+	StopWorkers();
+
+	if( m_workers.size() > 1 )
+	{
+		for( asUINT n = 1; n < m_workers.size(); n++ )
+			delete m_workers[n];
+		m_workers.resize(1);
+
+		// Release the thread manager that was kept while the workers existed
+		asUnprepareMultithread();
+	}
+
+	if( numThreads > 1 )
+	{
+		// The engine must be prepared for multithreading before the threads
+		// are created, so they will share the same thread manager
+		int r = asPrepareMultithread();
+		if( r < 0 )
+			return r;
+
+		for( asUINT n = 1; n < numThreads; n++ )
+			m_workers.push_back(new SWorker);
+
+		m_stopWorkers = false;
+		for( asUINT n = 1; n < numThreads; n++ )
+			m_workerThreads.push_back(std::thread(&CContextMgr::WorkerThread, this, n, m_workRound));
+	}
+
+	return 0;
+#else
+	return numThreads == 1 ? 0 : asNOT_SUPPORTED;
+#endif
+}
+
+asUINT CContextMgr::GetWorkerThreadCount() const
+{
+	return asUINT(m_workers.size());
+}
+
+void CContextMgr::StopWorkers()
+{
+#ifdef AS_CONTEXTMGR_THREADS
+	{
+		CONTEXTMGR_LOCK(m_lock);
+		m_stopWorkers = true;
+	}
+	m_workCond.notify_all();
+
+	for( asUINT n = 0; n < m_workerThreads.size(); n++ )
+		m_workerThreads[n].join();
+	m_workerThreads.clear();
+#endif
+}
+
+#ifdef AS_CONTEXTMGR_THREADS
+void CContextMgr::WorkerThread(asUINT workerIndex, asUINT round)
+{
+	for(;;)
+	{
+		// Wait until ExecuteScripts() has handed out the scripts
+		{
+			std::unique_lock<std::mutex> lock(m_lock);
+			while( !m_stopWorkers && m_workRound == round )
+				m_workCond.wait(lock);
+			if( m_stopWorkers )
+				break;
+			round = m_workRound;
+		}
+
+		DoWork(workerIndex);
+
+		{
+			CONTEXTMGR_LOCK(m_lock);
+			if( --m_busyWorkers == 0 )
+				m_doneCond.notify_one();
+		}
+	}
+
+	// Free the memory the engine has allocated for this thread
+	asThreadCleanup();
+}
+#endif
+
+SContextInfo *CContextMgr::TakeWork(asUINT workerIndex)
+{
+	SContextInfo *thread = 0;
+
+	// Take the next script from the worker's own queue
+	SWorker *worker = m_workers[workerIndex];
+	{
+		CONTEXTMGR_LOCK(worker->queueLock);
+		if( worker->queue.size() )
+		{
+			thread = worker->queue.front();
+			worker->queue.pop_front();
+			return thread;
+		}
+	}
+
+	// Steal from the other workers when the own queue is empty. No new 
+	// scripts are handed out during the round, so when all queues are 
+	// empty the worker's job is done
+	for( asUINT n = 1; n < m_workers.size(); n++ )
+	{
+		SWorker *victim = m_workers[(workerIndex + n) % m_workers.size()];
+		CONTEXTMGR_LOCK(victim->queueLock);
+		if( victim->queue.size() )
+		{
+			thread = victim->queue.back();
+			victim->queue.pop_back();
+
+			// The script stays with the new worker in the next rounds too
+			thread->worker = workerIndex;
+			return thread;
+		}
+	}
+
+	return 0;
+}
+
+void CContextMgr::DoWork(asUINT workerIndex)
 {
-	g_ctxMgr = this; 
+	g_ctxMgr = this;
+
+	SContextInfo *thread;
+	while( (thread = TakeWork(workerIndex)) != 0 )
+		ExecuteThread(thread, m_workers[workerIndex]);
+
+	g_ctxMgr = 0;
+}
 
+void CContextMgr::ExecuteScripts()
+{
 	// TODO: Should have an optional time out for this function. If not all scripts executed before the 
 	//       time out, the next time the function is called the loop should continue
 	//       where it left off.
@@ -134,80 +351,245 @@ void CContextMgr::ExecuteScripts()
 
 	// Check if the system time is higher than the time set for the contexts
 	asUINT time = m_getTimeFunc ? m_getTimeFunc() : asUINT(-1);
-	for( m_currentThread = 0; m_currentThread < m_threads.size(); m_currentThread++ )
-	{
-		SContextInfo *thread = m_threads[m_currentThread];
-		if( thread->sleepUntil < time )
-		{
-			int currentCoRoutine = thread->currentCoRoutine;
 
-			// Gather some statistics from the GC
-			asIScriptEngine *engine = thread->coRoutines[currentCoRoutine]->GetEngine();
-			asUINT gcSize1, gcSize2, gcSize3;
-			engine->GetGCStatistics(&gcSize1);
+	// Wake up the scripts whose time has come. Only the front of the heap needs to be checked
+	while( m_sleepingThreads.size() && m_sleepingThreads.front()->sleepUntil < time )
+	{
+		pop_heap(m_sleepingThreads.begin(), m_sleepingThreads.end(), WakesUpLater);
+		SContextInfo *thread = m_sleepingThreads.back();
+		m_sleepingThreads.pop_back();
 
-			// Execute the script for this thread and co-routine
-			int r = thread->coRoutines[currentCoRoutine]->Execute();
+		thread->inSleepQueue = false;
+		thread->isSleeping = false;
+		m_readyThreads.push_back(thread);
+	}
 
-			// Determine how many new objects were created in the GC
-			engine->GetGCStatistics(&gcSize2);
-			m_numGCObjectsCreated += gcSize2 - gcSize1;
-			m_numExecutions++;
+	// Hand out the scripts to the workers that executed them the last time
+	vector<SContextInfo*> ready;
+	{
+		CONTEXTMGR_LOCK(m_lock);
+		ready.swap(m_readyThreads);
+	}
+	asUINT numWorkers = asUINT(m_workers.size());
+	asUINT n;
+	for( n = 0; n < ready.size(); n++ )
+	{
+		SContextInfo *thread = ready[n];
 
-			if( r != asEXECUTION_SUSPENDED )
+		// The application may have put the script to sleep
+		if( thread->isSleeping )
+		{
+			if( thread->sleepUntil < time )
+				thread->isSleeping = false;
+			else
 			{
-				// TODO: It should be possible to retrieve the return value before the context is released.
-				//       Maybe by calling a callback, or by storing the context somewhere until it has been
-				//       accessed.
-
-				// The context has terminated execution (for one reason or other)
-				thread->coRoutines[currentCoRoutine]->Release();
-				thread->coRoutines[currentCoRoutine] = 0;
-
-				thread->coRoutines.erase(thread->coRoutines.begin() + thread->currentCoRoutine);
-				if( thread->currentCoRoutine >= thread->coRoutines.size() )
-					thread->currentCoRoutine = 0;
-
-				// If this was the last co-routine terminate the thread
-				if( thread->coRoutines.size() == 0 )
-				{
-					m_freeThreads.push_back(thread);
-					m_threads.erase(m_threads.begin() + m_currentThread);
-					m_currentThread--;
-				}
+				PushSleeping(thread);
+				continue;
 			}
+		}
 
-			// Destroy all known garbage if any new objects were created
-			if( gcSize2 > gcSize1 )
-			{
-				engine->GarbageCollect(asGC_FULL_CYCLE | asGC_DESTROY_GARBAGE);
+		if( thread->worker >= numWorkers )
+			thread->worker %= numWorkers;
+		m_workers[thread->worker]->queue.push_back(thread);
+	}
 
-				// Determine how many objects were destroyed
- 				engine->GetGCStatistics(&gcSize3);
-				m_numGCObjectsDestroyed += gcSize3 - gcSize2;
-			}
+#ifdef AS_CONTEXTMGR_THREADS
+	if( numWorkers > 1 )
+	{
+		// Start a new round for the worker threads
+		{
+			CONTEXTMGR_LOCK(m_lock);
+			m_busyWorkers = numWorkers - 1;
+			m_workRound++;
+		}
+		m_workCond.notify_all();
+
+		// The calling thread does its share of the work too
+		DoWork(0);
+
+		std::unique_lock<std::mutex> lock(m_lock);
+		while( m_busyWorkers > 0 )
+			m_doneCond.wait(lock);
+	}
+	else
+#endif
+		DoWork(0);
 
-			// TODO: If more objects are created per execution than destroyed on average
-			//       then it may be necessary to run more iterations of the detection of
-			//       cyclic references. At the startup of an application there is usually
-			//       a lot of objects created that will live on through out the application
-			//       so the average number of objects created per execution will be higher
-			//       than the number of destroyed objects in the beginning, but afterwards
-			//       it usually levels out to be more or less equal.
+	// Gather the outcome from the workers
+	CONTEXTMGR_LOCK(m_lock);
+	for( n = 0; n < numWorkers; n++ )
+	{
+		SWorker *worker = m_workers[n];
+		asUINT i;
+
+		m_readyThreads.insert(m_readyThreads.end(), worker->ready.begin(), worker->ready.end());
+		worker->ready.resize(0);
+
+		for( i = 0; i < worker->sleeping.size(); i++ )
+			PushSleeping(worker->sleeping[i]);
+		worker->sleeping.resize(0);
 
-			// Just run an incremental step for detecting cyclic references
-			engine->GarbageCollect(asGC_ONE_STEP | asGC_DETECT_GARBAGE);
+		for( i = 0; i < worker->finished.size(); i++ )
+		{
+			// Remove the script by moving the last one to its position
+			SContextInfo *thread = worker->finished[i];
+			SContextInfo *last = m_threads.back();
+			m_threads[thread->index] = last;
+			last->index = thread->index;
+			m_threads.pop_back();
+
+			m_freeThreads.push_back(thread);
 		}
+		worker->finished.resize(0);
+
+		m_numExecutions         += worker->numExecutions;
+		m_numGCObjectsCreated   += worker->numGCObjectsCreated;
+		m_numGCObjectsDestroyed += worker->numGCObjectsDestroyed;
+		worker->numExecutions         = 0;
+		worker->numGCObjectsCreated   = 0;
+		worker->numGCObjectsDestroyed = 0;
 	}
+}
 
-	g_ctxMgr = 0;
+void CContextMgr::ExecuteThread(SContextInfo *thread, SWorker *worker)
+{
+	asIScriptContext *ctx = thread->ctx;
+	g_currentThread = thread;
+
+	// The context returns to the main script function when a co-routine 
+	// yields, so switch to the co-routine whose turn it is to execute
+	if( thread->currentCoRoutine > 0 && ctx->GetCoroutine() == 0 )
+		ctx->ResumeCoroutine(thread->coRoutines[thread->currentCoRoutine-1]);
+
+	// Gather some statistics from the GC
+	asIScriptEngine *engine = ctx->GetEngine();
+	asUINT gcSize1, gcSize2, gcSize3;
+	engine->GetGCStatistics(&gcSize1);
+
+	// Execute the script for this thread and co-routine
+	int r = ctx->Execute();
+
+	// Determine how many new objects were created in the GC
+	engine->GetGCStatistics(&gcSize2);
+	worker->numGCObjectsCreated += gcSize2 - gcSize1;
+	worker->numExecutions++;
+
+	// Remove the co-routines that have finished
+	for( asUINT n = (asUINT)thread->coRoutines.size(); n-- > 0; )
+	{
+		asEContextState state = thread->coRoutines[n]->GetState();
+		if( state == asEXECUTION_PREPARED || state == asEXECUTION_SUSPENDED || state == asEXECUTION_ACTIVE )
+			continue;
+
+		thread->coRoutines[n]->Release();
+		thread->coRoutines.erase(thread->coRoutines.begin() + n);
+		if( thread->currentCoRoutine > n + 1 )
+			thread->currentCoRoutine--;
+	}
+	if( thread->currentCoRoutine > thread->coRoutines.size() )
+		thread->currentCoRoutine = 0;
+
+	g_currentThread = 0;
+
+	if( r != asEXECUTION_SUSPENDED )
+	{
+		// TODO: It should be possible to retrieve the return value before the context is released.
+		//       Maybe by calling a callback, or by storing the context somewhere until it has been
+		//       accessed.
+
+		// The context has terminated execution (for one reason or other), so 
+		// the co-routines that it was executing cannot continue either
+		for( asUINT c = 0; c < thread->coRoutines.size(); c++ )
+			thread->coRoutines[c]->Release();
+		thread->coRoutines.resize(0);
+
+		thread->ctx->Release();
+		thread->ctx = 0;
+
+		worker->finished.push_back(thread);
+	}
+	else if( thread->isSleeping )
+		worker->sleeping.push_back(thread);
+	else
+		worker->ready.push_back(thread);
+
+	// Destroy all known garbage if any new objects were created
+	if( gcSize2 > gcSize1 )
+	{
+		engine->GarbageCollect(asGC_FULL_CYCLE | asGC_DESTROY_GARBAGE);
+
+		// Determine how many objects were destroyed
+		engine->GetGCStatistics(&gcSize3);
+		worker->numGCObjectsDestroyed += gcSize3 - gcSize2;
+	}
+
+	// TODO: If more objects are created per execution than destroyed on average
+	//       then it may be necessary to run more iterations of the detection of
+	//       cyclic references. At the startup of an application there is usually
+	//       a lot of objects created that will live on through out the application
+	//       so the average number of objects created per execution will be higher
+	//       than the number of destroyed objects in the beginning, but afterwards
+	//       it usually levels out to be more or less equal.
+
+	// Just run an incremental step for detecting cyclic references
+	engine->GarbageCollect(asGC_ONE_STEP | asGC_DETECT_GARBAGE);
+}
+
+void CContextMgr::PushSleeping(SContextInfo *thread)
+{
+	thread->inSleepQueue = true;
+	m_sleepingThreads.push_back(thread);
+	push_heap(m_sleepingThreads.begin(), m_sleepingThreads.end(), WakesUpLater);
+}
+
+SContextInfo *CContextMgr::FindThread(asIScriptContext *ctx)
+{
+	// The script that is currently executing in this thread is the most likely
+	if( g_currentThread && g_currentThread->ctx == ctx )
+		return g_currentThread;
+
+	CONTEXTMGR_LOCK(m_lock);
+	for( asUINT n = 0; n < m_threads.size(); n++ )
+	{
+		if( m_threads[n]->ctx == ctx )
+			return m_threads[n];
+	}
+
+	return 0;
+}
+
+void CContextMgr::NextCoRoutine(asIScriptCoroutine *current)
+{
+	SContextInfo *thread = g_currentThread;
+	if( thread == 0 )
+		return;
+
+	// Find the position of the co-routine that is yielding
+	asUINT n = 0;
+	if( current )
+	{
+		while( n < thread->coRoutines.size() && thread->coRoutines[n] != current )
+			n++;
+		n++;
+	}
+
+	thread->currentCoRoutine = n + 1;
+	if( thread->currentCoRoutine > thread->coRoutines.size() )
+		thread->currentCoRoutine = 0;
 }
 
 void CContextMgr::NextCoRoutine()
 {
-	m_threads[m_currentThread]->currentCoRoutine++;
-	if( m_threads[m_currentThread]->currentCoRoutine >= m_threads[m_currentThread]->coRoutines.size() )
-		m_threads[m_currentThread]->currentCoRoutine = 0;
+	asIScriptContext *ctx = asGetActiveContext();
+	if( ctx == 0 )
+		return;
+
+	// Return to the main script function if a co-routine is executing
+	asIScriptCoroutine *co = ctx->GetCoroutine();
+	if( co )
+		ctx->YieldCoroutine();
+
+	NextCoRoutine(co);
 }
 
 void CContextMgr::AbortAll()
@@ -215,25 +597,30 @@ void CContextMgr::AbortAll()
 	// Abort all contexts and release them. The script engine will make 
 	// sure that all resources held by the scripts are properly released.
 
+	CONTEXTMGR_LOCK(m_lock);
 	for( asUINT n = 0; n < m_threads.size(); n++ )
 	{
+		m_threads[n]->ctx->Abort();
+
 		for( asUINT c = 0; c < m_threads[n]->coRoutines.size(); c++ )
 		{
 			if( m_threads[n]->coRoutines[c] )
 			{
-				m_threads[n]->coRoutines[c]->Abort();
 				m_threads[n]->coRoutines[c]->Release();
 				m_threads[n]->coRoutines[c] = 0;
 			}
 		}
 		m_threads[n]->coRoutines.resize(0);
 
+		m_threads[n]->ctx->Release();
+		m_threads[n]->ctx = 0;
+
 		m_freeThreads.push_back(m_threads[n]);
 	}
 
 	m_threads.resize(0);
-
-	m_currentThread = 0;
+	m_readyThreads.resize(0);
+	m_sleepingThreads.resize(0);
 }
 
 asIScriptContext *CContextMgr::AddContext(asIScriptEngine *engine, asIScriptFunction *func)
@@ -251,7 +638,9 @@ asIScriptContext *CContextMgr::AddContext(asIScriptEngine *engine, asIScriptFunc
 		return 0;
 	}
 
-	// Add the context to the list for execution
+	// Add the context to the list for execution. Scripts that are 
+	// executing on the worker threads may add new contexts too
+	CONTEXTMGR_LOCK(m_lock);
 	SContextInfo *info = 0;
 	if( m_freeThreads.size() > 0 )
 	{
@@ -263,44 +652,54 @@ asIScriptContext *CContextMgr::AddContext(asIScriptEngine *engine, asIScriptFunc
 		info = new SContextInfo;
 	}
 
-    info->coRoutines.push_back(ctx);
+    info->ctx = ctx;
 	info->currentCoRoutine = 0;
     info->sleepUntil = 0;
+	info->isSleeping = false;
+	info->inSleepQueue = false;
+	info->index = asUINT(m_threads.size());
+	info->worker = m_nextWorker++;
 	m_threads.push_back(info);
+	m_readyThreads.push_back(info);
 
 	return ctx;
 }
 
-asIScriptContext *CContextMgr::AddContextForCoRoutine(asIScriptContext *currCtx, asIScriptFunction *func)
+asIScriptCoroutine *CContextMgr::AddCoRoutine(asIScriptContext *currCtx, asIScriptFunction *func)
 {
-	asIScriptEngine *engine = currCtx->GetEngine();
-	asIScriptContext *coctx = engine->CreateContext();
-	if( coctx == 0 )
-	{
+	// Find the current context thread info
+	SContextInfo *thread = FindThread(currCtx);
+	if( thread == 0 )
 		return 0;
-	}
 
-	// Prepare the context
-	int r = coctx->Prepare(func);
-	if( r < 0 )
-	{
-		// Couldn't prepare the context
-		coctx->Release();
+	// The co-routine shares the context with the rest of the group
+	asIScriptCoroutine *co = currCtx->CreateCoroutine(func);
+	if( co == 0 )
 		return 0;
-	}
 
+	// Add the coRoutine to the list
+	thread->coRoutines.push_back(co);
+	return co;
+}
+
+asIScriptContext *CContextMgr::AddContextForCoRoutine(asIScriptContext *currCtx, asIScriptFunction *func)
+{
 	// Find the current context thread info
-	// TODO: Start with the current thread so that we can find the group faster
-	for( asUINT n = 0; n < m_threads.size(); n++ )
-	{
-		if( m_threads[n]->coRoutines[m_threads[n]->currentCoRoutine] == currCtx )
-		{
-			// Add the coRoutine to the list
-			m_threads[n]->coRoutines.push_back(coctx);
-		}
-	}
+	SContextInfo *thread = FindThread(currCtx);
+	if( thread == 0 )
+		return 0;
+
+	asIScriptContext *ctx = AddContext(currCtx->GetEngine(), func);
+	if( ctx == 0 )
+		return 0;
+
+	// Give the new script to the same worker as the current one, so they 
+	// will normally be executed one after the other as the co-routines
+	SContextInfo *info = FindThread(ctx);
+	CONTEXTMGR_LOCK(m_lock);
+	info->worker = thread->worker;
 
-	return coctx; 
+	return ctx;
 }
 
 void CContextMgr::SetSleeping(asIScriptContext *ctx, asUINT milliSeconds)
@@ -309,16 +708,17 @@ void CContextMgr::SetSleeping(asIScriptContext *ctx, asUINT milliSeconds)
     
 	// Find the context and update the timeStamp  
 	// for when the context is to be continued
+	SContextInfo *thread = FindThread(ctx);
+	if( thread == 0 )
+		return;
 
-	// TODO: Start with the current thread
+	CONTEXTMGR_LOCK(m_lock);
+	thread->sleepUntil = (m_getTimeFunc ? m_getTimeFunc() : 0) + milliSeconds;
+	thread->isSleeping = true;
 
-	for( asUINT n = 0; n < m_threads.size(); n++ )
-	{
-		if( m_threads[n]->coRoutines[m_threads[n]->currentCoRoutine] == ctx )
-		{
-			m_threads[n]->sleepUntil = (m_getTimeFunc ? m_getTimeFunc() : 0) + milliSeconds;
-		}
-	}
+	// If the script was already sleeping the heap must be reordered
+	if( thread->inSleepQueue )
+		make_heap(m_sleepingThreads.begin(), m_sleepingThreads.end(), WakesUpLater);
 }
 
 void CContextMgr::RegisterThreadSupport(asIScriptEngine *engine)
@@ -347,4 +747,14 @@ void CContextMgr::SetGetTimeCallback(TIMEFUNC_t func)
 	m_getTimeFunc = func;
 }
 
+void CContextMgr::SetLightWeightCoRoutines(bool enable)
+{
+	m_lightWeightCoRoutines = enable;
+}
+
+bool CContextMgr::GetLightWeightCoRoutines() const
+{
+	return m_lightWeightCoRoutines;
+}
+
 END_AS_NAMESPACE
@@ -6,7 +6,10 @@
 // More than one context manager can be used, if you wish to control different
 // groups of scripts separately, e.g. game object scripts, and GUI scripts.
 
-// OBSERVATION: This class is currently not thread safe.
+// The scripts can be executed by multiple threads, see SetWorkerThreadCount(). 
+// Apart from that the class is not thread safe, i.e. the application must not
+// call the methods from other threads while ExecuteScripts() is running. The
+// scripts executed by the manager may call them though.
 
 #ifndef ANGELSCRIPT_H 
 // Avoid having to inform include path if header is already include before
@@ -15,6 +18,15 @@
 
 #include <vector>
 
+// The worker threads use the C++11 thread library. Define 
+// AS_NO_CONTEXTMGR_THREADS to compile the manager without them
+#if !defined(AS_NO_CONTEXTMGR_THREADS) && (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900))
+	#define AS_CONTEXTMGR_THREADS
+	#include <thread>
+	#include <mutex>
+	#include <condition_variable>
+#endif
+
 BEGIN_AS_NAMESPACE
 
 class CScriptAny;
@@ -22,6 +34,9 @@ class CScriptAny;
 // The internal structure for holding contexts
 struct SContextInfo;
 
+// The internal structure for the threads that execute the scripts
+struct SWorker;
+
 // The signature of the get time callback function
 typedef asUINT (*TIMEFUNC_t)();
 
@@ -45,16 +60,34 @@ public:
 	//
 	//  void createCoRoutine(const string &in functionName, any @arg)
 	//  void yield()
+	//
+	// Each co-routine is executed in a context of its own, and continues after the
+	// script that created it has ended, unless SetLightWeightCoRoutines() is used.
 	void RegisterCoRoutineSupport(asIScriptEngine *engine);
 
+	// Let createCoRoutine() create light weight co-routines that are executed by the
+	// context of the script that created them, so each co-routine only needs its own
+	// small stack. These co-routines end with the main script function of the thread.
+	// The default is false, i.e. each co-routine is given a context of its own.
+	void SetLightWeightCoRoutines(bool enable);
+	bool GetLightWeightCoRoutines() const;
+
 	// Create a new context, prepare it with the function id, then return 
 	// it so that the application can pass the argument values. The context
 	// will be released by the manager after the execution has completed.
     asIScriptContext *AddContext(asIScriptEngine *engine, asIScriptFunction *func);
 
+	// Create a new co-routine for the function in the context, then return
+	// it so that the application can pass the argument values. The co-routine
+	// will be added in the same thread as the currCtx.
+	asIScriptCoroutine *AddCoRoutine(asIScriptContext *currCtx, asIScriptFunction *func);
+
 	// Create a new context, prepare it with the function id, then return
-	// it so that the application can pass the argument values. The context
-	// will be added as a co-routine in the same thread as the currCtx.
+	// it so that the application can pass the argument values. The function
+	// is executed in a context of its own, like the scripts added with 
+	// AddContext(), so unlike the co-routines above it continues after the 
+	// currCtx has finished, and with multiple worker threads it may be 
+	// executed at the same time.
 	asIScriptContext *AddContextForCoRoutine(asIScriptContext *currCtx, asIScriptFunction *func);
 
 	// Execute each script that is not currently sleeping. The function returns after 
@@ -62,21 +95,64 @@ public:
 	// for each iteration of the message pump, or game loop, or whatever.
     void ExecuteScripts();
 
+	// Set the number of threads that ExecuteScripts() uses, including the calling thread.
+	// The default is 1, i.e. all scripts are executed by the calling thread. With more
+	// threads each script is still executed once per call, and a script is always executed
+	// by one thread at a time, together with its co-routines. Each script is given to the
+	// thread that executed it the last time, and threads that run out of scripts take over
+	// scripts from the others. Returns asNOT_SUPPORTED if compiled without thread support.
+	int    SetWorkerThreadCount(asUINT numThreads);
+	asUINT GetWorkerThreadCount() const;
+
 	// Put a script to sleep for a while
     void SetSleeping(asIScriptContext *ctx, asUINT milliSeconds);
 
-	// Switch the execution to the next co-routine in the group.
-	// Returns true if the switch was successful.
+	// Switch the execution to the next co-routine in the group after
+	// the current one. The switch is done when the context is suspended.
+	void NextCoRoutine(asIScriptCoroutine *current);
+
+	// Switch the execution to the next co-routine in the group of the script that
+	// is executing, e.g. from a registered function. As before, the switch is done
+	// when the context is suspended.
 	void NextCoRoutine();
 
 	// Abort all scripts
     void AbortAll();
 
 protected:
+	SContextInfo *FindThread(asIScriptContext *ctx);
+	void          PushSleeping(SContextInfo *thread);
+	void          ExecuteThread(SContextInfo *thread, SWorker *worker);
+	SContextInfo *TakeWork(asUINT workerIndex);
+	void          DoWork(asUINT workerIndex);
+	void          StopWorkers();
+#ifdef AS_CONTEXTMGR_THREADS
+	void          WorkerThread(asUINT workerIndex, asUINT round);
+#endif
+
+	// All scripts that haven't finished yet
 	std::vector<SContextInfo*> m_threads;
 	std::vector<SContextInfo*> m_freeThreads;
-	asUINT                     m_currentThread;
+
+	// The scripts that will be executed in the next call to ExecuteScripts(), and the 
+	// scripts that are sleeping ordered as a heap with the first to wake up at the front
+	std::vector<SContextInfo*> m_readyThreads;
+	std::vector<SContextInfo*> m_sleepingThreads;
     TIMEFUNC_t                 m_getTimeFunc;
+	bool                       m_lightWeightCoRoutines;
+
+	// The threads that execute the scripts. The first is the one calling ExecuteScripts()
+	std::vector<SWorker*>      m_workers;
+	asUINT                     m_nextWorker;
+#ifdef AS_CONTEXTMGR_THREADS
+	std::vector<std::thread>   m_workerThreads;
+	std::mutex                 m_lock;
+	std::condition_variable    m_workCond;
+	std::condition_variable    m_doneCond;
+	asUINT                     m_workRound;
+	asUINT                     m_busyWorkers;
+	bool                       m_stopWorkers;
+#endif
 
 	// Statistics for Garbage Collection
 	asUINT   m_numExecutions;
@@ -6,12 +6,28 @@
 
 #include "scriptarray.h"
 
+#ifdef AS_SCRIPTARRAY_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#endif
+
+// SSE2 is always available on x64, and on x86 if the compiler is told to use it. 
+// Define AS_NO_SCRIPTARRAY_SIMD to compile the add-on with only the scalar code
+#if !defined(AS_NO_SCRIPTARRAY_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define AS_SCRIPTARRAY_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 BEGIN_AS_NAMESPACE
 
 static void RegisterScriptArray_Native(asIScriptEngine *engine);
 static void RegisterScriptArray_Generic(asIScriptEngine *engine);
+static void ScriptArraySum_Generic(asIScriptGeneric *gen);
+static void ScriptArrayViewSum_Generic(asIScriptGeneric *gen);
 
 struct SArrayBuffer
 {
@@ -24,6 +40,7 @@ struct SArrayCache
 {
 	asIScriptFunction *cmpFunc;
 	asIScriptFunction *eqFunc;
+	asIObjectType     *indexArrayType;
 };
 
 // We just define a number here that we assume nobody else is using for 
@@ -38,6 +55,408 @@ static void CleanupObjectTypeArrayCache(asIObjectType *type)
 		delete cache;
 }
 
+// The array<uint> type returned by findAll is taken from the return type of the
+// registered method. It is looked up only once per type as searching for the
+// method by name each time is quite time consuming.
+static asIObjectType *GetIndexArrayType(asIObjectType *type)
+{
+	SArrayCache *cache = reinterpret_cast<SArrayCache*>(type->GetUserData(ARRAY_CACHE));
+	if( cache && cache->indexArrayType )
+		return cache->indexArrayType;
+
+	asIObjectType *indexArrayType = type->GetEngine()->GetObjectTypeById(type->GetMethodByName("findAll")->GetReturnTypeId());
+
+	// The cache doesn't exist for arrays of primitives so it may have to be created here
+	asAcquireExclusiveLock();
+	cache = reinterpret_cast<SArrayCache*>(type->GetUserData(ARRAY_CACHE));
+	if( cache == 0 )
+	{
+		cache = new SArrayCache();
+		memset(cache, 0, sizeof(SArrayCache));
+		type->SetUserData(cache, ARRAY_CACHE);
+	}
+	cache->indexArrayType = indexArrayType;
+	asReleaseExclusiveLock();
+
+	return indexArrayType;
+}
+
+// The parallel algorithms never divide the work in more tasks than this
+const asUINT MAX_PARALLEL_TASKS = 64;
+
+// The parallelism is stored as engine user data
+const asPWORD ARRAY_PARALLELISM = 1002;
+
+#ifdef AS_SCRIPTARRAY_THREADS
+// The worker threads are started when the parallelism is set and then wait for
+// work until the setting is changed or the engine is released. The calling thread
+// executes tasks too, so there is one worker less than the number of threads.
+class CArrayWorkerPool
+{
+public:
+	CArrayWorkerPool(asUINT numWorkers) : task(0), param(0), numTasks(0), nextTask(0), pendingTasks(0), generation(0), quit(false)
+	{
+		for( asUINT n = 0; n < numWorkers; n++ )
+			workers.push_back(std::thread(&CArrayWorkerPool::WorkerMain, this));
+	}
+
+	~CArrayWorkerPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quit = true;
+		}
+		wakeUp.notify_all();
+		for( size_t n = 0; n < workers.size(); n++ )
+			workers[n].join();
+	}
+
+	// Returns when all tasks have completed
+	void Run(ARRAYTASKFUNC_t func, void *arg, asUINT count)
+	{
+		// The pool works on one call at a time. If another thread is already
+		// using it the calling thread will do the work on its own instead
+		std::unique_lock<std::mutex> runLock(runMutex, std::try_to_lock);
+		if( !runLock.owns_lock() )
+		{
+			for( asUINT n = 0; n < count; n++ )
+				func(n, arg);
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			task         = func;
+			param        = arg;
+			numTasks     = count;
+			nextTask     = 0;
+			pendingTasks = count;
+			generation++;
+		}
+		wakeUp.notify_all();
+
+		RunTasks();
+
+		std::unique_lock<std::mutex> lock(mutex);
+		while( pendingTasks > 0 )
+			done.wait(lock);
+	}
+
+protected:
+	void WorkerMain()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		asUINT seen = generation;
+		for(;;)
+		{
+			while( !quit && seen == generation )
+				wakeUp.wait(lock);
+			if( quit )
+				return;
+			seen = generation;
+
+			lock.unlock();
+			RunTasks();
+			lock.lock();
+		}
+	}
+
+	// Executes the tasks that haven't been taken by another thread yet
+	void RunTasks()
+	{
+		std::unique_lock<std::mutex> lock(mutex);
+		while( nextTask < numTasks )
+		{
+			asUINT n = nextTask++;
+			ARRAYTASKFUNC_t func = task;
+			void *arg = param;
+
+			lock.unlock();
+			func(n, arg);
+			lock.lock();
+
+			if( --pendingTasks == 0 )
+				done.notify_all();
+		}
+	}
+
+	std::vector<std::thread> workers;
+	std::mutex               runMutex;
+	std::mutex               mutex;
+	std::condition_variable  wakeUp;
+	std::condition_variable  done;
+	ARRAYTASKFUNC_t          task;
+	void                    *param;
+	asUINT                   numTasks;
+	asUINT                   nextTask;
+	asUINT                   pendingTasks;
+	asUINT                   generation;
+	bool                     quit;
+};
+#endif
+
+struct SArrayParallelism
+{
+	asUINT              numThreads;
+	asUINT              minElements;
+	ARRAYPARALLELFUNC_t callback;
+#ifdef AS_SCRIPTARRAY_THREADS
+	CArrayWorkerPool   *pool;
+#endif
+};
+
+static void CleanupEngineArrayParallelism(asIScriptEngine *engine)
+{
+	SArrayParallelism *par = reinterpret_cast<SArrayParallelism*>(engine->GetUserData(ARRAY_PARALLELISM));
+	if( par )
+	{
+#ifdef AS_SCRIPTARRAY_THREADS
+		delete par->pool;
+#endif
+		delete par;
+	}
+}
+
+void SetScriptArrayParallelism(asIScriptEngine *engine, asUINT numThreads, asUINT minElements, ARRAYPARALLELFUNC_t callback)
+{
+	if( numThreads < 1 )
+		numThreads = 1;
+	if( numThreads > MAX_PARALLEL_TASKS )
+		numThreads = MAX_PARALLEL_TASKS;
+
+	asAcquireExclusiveLock();
+
+	SArrayParallelism *par = reinterpret_cast<SArrayParallelism*>(engine->GetUserData(ARRAY_PARALLELISM));
+	if( par == 0 )
+	{
+		par = new SArrayParallelism();
+		memset(par, 0, sizeof(SArrayParallelism));
+		engine->SetUserData(par, ARRAY_PARALLELISM);
+		engine->SetEngineUserDataCleanupCallback(CleanupEngineArrayParallelism, ARRAY_PARALLELISM);
+	}
+
+	par->numThreads  = numThreads;
+	par->minElements = minElements;
+	par->callback    = callback;
+
+#ifdef AS_SCRIPTARRAY_THREADS
+	// The workers are only needed when the application doesn't provide its own thread pool
+	delete par->pool;
+	par->pool = 0;
+	if( callback == 0 && numThreads > 1 )
+		par->pool = new CArrayWorkerPool(numThreads - 1);
+#endif
+
+	asReleaseExclusiveLock();
+}
+
+// Returns the parallelism set for the engine, or 0 if it hasn't been set
+static const SArrayParallelism *GetParallelism(asIObjectType *ot)
+{
+	return reinterpret_cast<const SArrayParallelism*>(ot->GetEngine()->GetUserData(ARRAY_PARALLELISM));
+}
+
+// Returns the number of tasks that the work on the elements should be divided in
+static asUINT GetParallelTaskCount(const SArrayParallelism *par, asUINT numElements)
+{
+	if( par == 0 || par->numThreads < 2 || numElements < par->minElements || numElements < par->numThreads )
+		return 1;
+
+#ifndef AS_SCRIPTARRAY_THREADS
+	if( par->callback == 0 )
+		return 1;
+#endif
+
+	return par->numThreads;
+}
+
+// Returns the first element of the part n when dividing count elements in numParts parts
+static asUINT GetPartStart(asUINT n, asUINT numParts, asUINT count)
+{
+	return asUINT(asQWORD(count) * n / numParts);
+}
+
+// Executes the tasks and returns when all of them have completed
+static void RunParallelTasks(const SArrayParallelism *par, ARRAYTASKFUNC_t task, void *param, asUINT numTasks)
+{
+	if( numTasks < 2 )
+	{
+		task(0, param);
+		return;
+	}
+
+	// SetScriptArrayParallelism changes the settings under the exclusive lock, 
+	// so the shared lock keeps the worker pool alive until the tasks are done
+	asAcquireSharedLock();
+	if( par->callback )
+		par->callback(task, param, numTasks);
+#ifdef AS_SCRIPTARRAY_THREADS
+	else if( par->pool )
+		par->pool->Run(task, param, numTasks);
+#endif
+	else
+	{
+		for( asUINT n = 0; n < numTasks; n++ )
+			task(n, param);
+	}
+	asReleaseSharedLock();
+}
+
+// The kernels below work on arrays of primitives, handles, or object pointers. Except for
+// float and double the elements are treated as integers of the same size, as they are 
+// equal if the bytes are equal. With SSE2 they process 16 bytes at a time.
+
+#ifdef AS_SCRIPTARRAY_SSE2
+// Compares the elements in the 16 bytes and returns a mask with one bit set 
+// for each byte of the equal elements, as returned by _mm_movemask_epi8
+static inline int SimdEqual(__m128i a, __m128i b, asBYTE)  { return _mm_movemask_epi8(_mm_cmpeq_epi8(a, b)); }
+static inline int SimdEqual(__m128i a, __m128i b, asWORD)  { return _mm_movemask_epi8(_mm_cmpeq_epi16(a, b)); }
+static inline int SimdEqual(__m128i a, __m128i b, asDWORD) { return _mm_movemask_epi8(_mm_cmpeq_epi32(a, b)); }
+static inline int SimdEqual(__m128i a, __m128i b, asQWORD)
+{
+	// SSE2 cannot compare 64bit integers, so both halves are compared separately
+	__m128i c = _mm_cmpeq_epi32(a, b);
+	return _mm_movemask_epi8(_mm_and_si128(c, _mm_shuffle_epi32(c, _MM_SHUFFLE(2,3,0,1))));
+}
+static inline int SimdEqual(__m128i a, __m128i b, float)   { return _mm_movemask_epi8(_mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)))); }
+static inline int SimdEqual(__m128i a, __m128i b, double)  { return _mm_movemask_epi8(_mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)))); }
+
+// Returns 16 bytes with the value repeated in all elements
+static inline __m128i SimdSplat(asBYTE v)  { return _mm_set1_epi8((char)v); }
+static inline __m128i SimdSplat(asWORD v)  { return _mm_set1_epi16((short)v); }
+static inline __m128i SimdSplat(asDWORD v) { return _mm_set1_epi32((int)v); }
+static inline __m128i SimdSplat(asQWORD v) { return _mm_set_epi32(int(v >> 32), int(v), int(v >> 32), int(v)); }
+static inline __m128i SimdSplat(float v)   { return _mm_castps_si128(_mm_set1_ps(v)); }
+static inline __m128i SimdSplat(double v)  { return _mm_castpd_si128(_mm_set1_pd(v)); }
+
+// Reverses the order of the elements in the 16 bytes
+static inline __m128i SimdReverse(__m128i a, asQWORD) { return _mm_shuffle_epi32(a, _MM_SHUFFLE(1,0,3,2)); }
+static inline __m128i SimdReverse(__m128i a, asDWORD) { return _mm_shuffle_epi32(a, _MM_SHUFFLE(0,1,2,3)); }
+static inline __m128i SimdReverse(__m128i a, asWORD)
+{
+	a = _mm_shufflelo_epi16(a, _MM_SHUFFLE(0,1,2,3));
+	a = _mm_shufflehi_epi16(a, _MM_SHUFFLE(0,1,2,3));
+	return _mm_shuffle_epi32(a, _MM_SHUFFLE(1,0,3,2));
+}
+static inline __m128i SimdReverse(__m128i a, asBYTE)
+{
+	// Swap the bytes in each word, then reverse the words
+	a = _mm_or_si128(_mm_slli_epi16(a, 8), _mm_srli_epi16(a, 8));
+	return SimdReverse(a, asWORD());
+}
+#endif
+
+// Returns the index of the first element that is equal to the value, or count if there is none
+template<class T>
+static asUINT FindFirstEqual(const T *data, asUINT count, T value)
+{
+	asUINT n = 0;
+#ifdef AS_SCRIPTARRAY_SSE2
+	const asUINT N = 16 / sizeof(T);
+	__m128i v = SimdSplat(value);
+	for( ; n + N <= count; n += N )
+	{
+		int mask = SimdEqual(_mm_loadu_si128((const __m128i*)(data + n)), v, T());
+		if( mask )
+		{
+			// The lowest bits belong to the first element
+			for( ; !(mask & 1); mask >>= sizeof(T) )
+				n++;
+			return n;
+		}
+	}
+#endif
+	for( ; n < count; n++ )
+		if( data[n] == value )
+			return n;
+	return count;
+}
+
+// Stores the indices of the elements that are equal to the value in the 
+// indices array, unless it is null. Returns the number of equal elements
+template<class T>
+static asUINT FindAllEqual(const T *data, asUINT count, T value, asUINT *indices)
+{
+	asUINT found = 0;
+	asUINT n = 0;
+#ifdef AS_SCRIPTARRAY_SSE2
+	const asUINT N = 16 / sizeof(T);
+	__m128i v = SimdSplat(value);
+	for( ; n + N <= count; n += N )
+	{
+		int mask = SimdEqual(_mm_loadu_si128((const __m128i*)(data + n)), v, T());
+		for( asUINT i = 0; mask; i++, mask >>= sizeof(T) )
+			if( mask & 1 )
+			{
+				if( indices )
+					indices[found] = n + i;
+				found++;
+			}
+	}
+#endif
+	for( ; n < count; n++ )
+		if( data[n] == value )
+		{
+			if( indices )
+				indices[found] = n;
+			found++;
+		}
+	return found;
+}
+
+template<class T>
+static bool AllEqual(const T *a, const T *b, asUINT count)
+{
+	asUINT n = 0;
+#ifdef AS_SCRIPTARRAY_SSE2
+	const asUINT N = 16 / sizeof(T);
+	for( ; n + N <= count; n += N )
+		if( SimdEqual(_mm_loadu_si128((const __m128i*)(a + n)), _mm_loadu_si128((const __m128i*)(b + n)), T()) != 0xFFFF )
+			return false;
+#endif
+	for( ; n < count; n++ )
+		if( !(a[n] == b[n]) )
+			return false;
+	return true;
+}
+
+template<class T>
+static void ReverseElements(T *data, asUINT count)
+{
+	asUINT lo = 0, hi = count;
+#ifdef AS_SCRIPTARRAY_SSE2
+	// Swap 16 bytes from each end at a time until they meet
+	const asUINT N = 16 / sizeof(T);
+	for( ; hi - lo >= 2*N; lo += N, hi -= N )
+	{
+		__m128i a = _mm_loadu_si128((const __m128i*)(data + lo));
+		__m128i b = _mm_loadu_si128((const __m128i*)(data + hi - N));
+		_mm_storeu_si128((__m128i*)(data + lo), SimdReverse(b, T()));
+		_mm_storeu_si128((__m128i*)(data + hi - N), SimdReverse(a, T()));
+	}
+#endif
+	for( ; hi - lo >= 2; lo++, hi-- )
+	{
+		T tmp = data[lo];
+		data[lo] = data[hi-1];
+		data[hi-1] = tmp;
+	}
+}
+
+template<class T>
+static void FillElements(T *data, asUINT count, T value)
+{
+	asUINT n = 0;
+#ifdef AS_SCRIPTARRAY_SSE2
+	const asUINT N = 16 / sizeof(T);
+	__m128i v = SimdSplat(value);
+	for( ; n + N <= count; n += N )
+		_mm_storeu_si128((__m128i*)(data + n), v);
+#endif
+	for( ; n < count; n++ )
+		data[n] = value;
+}
+
 static CScriptArray* ScriptArrayFactory2(asIObjectType *ot, asUINT length)
 {
 	CScriptArray *a = new CScriptArray(length, ot);
@@ -75,6 +494,34 @@ static CScriptArray* ScriptArrayFactory(asIObjectType *ot)
 	return ScriptArrayFactory2(ot, 0);
 }
 
+// The script passes the comparison function as a function handle
+static asIScriptFunction *ScriptArrayGetLessFunc(asIObjectType *ot, void *ref, int typeId)
+{
+	if( ot->GetEngine()->GetFuncdefFromTypeId(typeId) == 0 )
+		return 0;
+	return *(asIScriptFunction**)ref;
+}
+
+static void ScriptArraySortLess(void *ref, int typeId, asUINT index, asUINT count, CScriptArray *self)
+{
+	self->Sort(ScriptArrayGetLessFunc(self->GetArrayObjectType(), ref, typeId), index, count, false);
+}
+
+static void ScriptArrayStableSortLess(void *ref, int typeId, asUINT index, asUINT count, CScriptArray *self)
+{
+	self->Sort(ScriptArrayGetLessFunc(self->GetArrayObjectType(), ref, typeId), index, count, true);
+}
+
+static void ScriptArrayViewSortLess(void *ref, int typeId, CScriptArrayView *self)
+{
+	self->Sort(ScriptArrayGetLessFunc(self->GetViewObjectType(), ref, typeId), false);
+}
+
+static void ScriptArrayViewStableSortLess(void *ref, int typeId, CScriptArrayView *self)
+{
+	self->Sort(ScriptArrayGetLessFunc(self->GetViewObjectType(), ref, typeId), true);
+}
+
 // This optional callback is called when the template type is first used by the compiler.
 // It allows the application to validate if the template can be instanciated for the requested 
 // subtype at compile time, instead of at runtime. The output argument dontGarbageCollect
@@ -217,9 +664,22 @@ static void RegisterScriptArray_Native(asIScriptEngine *engine)
 	r = engine->RegisterObjectMethod("array<T>", "void sortAsc(uint, uint)", asMETHODPR(CScriptArray, SortAsc, (asUINT, asUINT), void), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "void sortDesc()", asMETHODPR(CScriptArray, SortDesc, (), void), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "void sortDesc(uint, uint)", asMETHODPR(CScriptArray, SortDesc, (asUINT, asUINT), void), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void stableSortAsc()", asMETHODPR(CScriptArray, StableSortAsc, (), void), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void stableSortAsc(uint, uint)", asMETHODPR(CScriptArray, StableSortAsc, (asUINT, asUINT), void), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void stableSortDesc()", asMETHODPR(CScriptArray, StableSortDesc, (), void), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void stableSortDesc(uint, uint)", asMETHODPR(CScriptArray, StableSortDesc, (asUINT, asUINT), void), asCALL_THISCALL); assert( r >= 0 );
+	// The function handle must be for a function declared as bool less(const T&in, const T&in)
+	r = engine->RegisterObjectMethod("array<T>", "void sort(?&in less, uint startAt = 0, uint count = uint(-1))", asFUNCTION(ScriptArraySortLess), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void stableSort(?&in less, uint startAt = 0, uint count = uint(-1))", asFUNCTION(ScriptArrayStableSortLess), asCALL_CDECL_OBJLAST); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "void reverse()", asMETHOD(CScriptArray, Reverse), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "int find(const T&in) const", asMETHODPR(CScriptArray, Find, (void*) const, int), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "int find(uint, const T&in) const", asMETHODPR(CScriptArray, Find, (asUINT, void*) const, int), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "array<uint>@ findAll(const T&in) const", asMETHOD(CScriptArray, FindAll), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void fill(const T&in)", asMETHOD(CScriptArray, Fill), asCALL_THISCALL); assert( r >= 0 );
+	// The size of the returned value depends on the subtype, so only the generic calling convention can return it
+	r = engine->RegisterObjectMethod("array<T>", "T sum() const", asFUNCTION(ScriptArraySum_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "const T &min() const", asMETHOD(CScriptArray, Min), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "const T &max() const", asMETHOD(CScriptArray, Max), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "bool opEquals(const array<T>&in) const", asMETHOD(CScriptArray, operator==), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "bool isEmpty() const", asMETHOD(CScriptArray, IsEmpty), asCALL_THISCALL); assert( r >= 0 );
 
@@ -234,6 +694,44 @@ static void RegisterScriptArray_Native(asIScriptEngine *engine)
 	r = engine->RegisterObjectBehaviour("array<T>", asBEHAVE_ENUMREFS, "void f(int&in)", asMETHOD(CScriptArray, EnumReferences), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectBehaviour("array<T>", asBEHAVE_RELEASEREFS, "void f(int&in)", asMETHOD(CScriptArray, ReleaseAllHandles), asCALL_THISCALL); assert( r >= 0 );
 
+	// Register the array view type. The views can only be created by the arrays, 
+	// and they are garbage collected when the array of the same subtype is
+	r = engine->RegisterObjectType("arrayview<class T>", 0, asOBJ_REF | asOBJ_GC | asOBJ_TEMPLATE); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_TEMPLATE_CALLBACK, "bool f(int&in, bool&out)", asFUNCTION(ScriptArrayTemplateCallback), asCALL_CDECL); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_ADDREF, "void f()", asMETHOD(CScriptArrayView,AddRef), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_RELEASE, "void f()", asMETHOD(CScriptArrayView,Release), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "T &opIndex(uint)", asMETHODPR(CScriptArrayView, At, (asUINT), void*), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "const T &opIndex(uint) const", asMETHODPR(CScriptArrayView, At, (asUINT) const, const void*), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "arrayview<T>@ view(uint start = 0, uint count = uint(-1), uint stride = 1)", asMETHOD(CScriptArrayView, View), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "uint length() const", asMETHOD(CScriptArrayView, GetSize), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "bool isEmpty() const", asMETHOD(CScriptArrayView, IsEmpty), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void sortAsc()", asMETHOD(CScriptArrayView, SortAsc), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void sortDesc()", asMETHOD(CScriptArrayView, SortDesc), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void stableSortAsc()", asMETHOD(CScriptArrayView, StableSortAsc), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void stableSortDesc()", asMETHOD(CScriptArrayView, StableSortDesc), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void sort(?&in less)", asFUNCTION(ScriptArrayViewSortLess), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void stableSort(?&in less)", asFUNCTION(ScriptArrayViewStableSortLess), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void reverse()", asMETHOD(CScriptArrayView, Reverse), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "int find(const T&in) const", asMETHODPR(CScriptArrayView, Find, (void*) const, int), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "int find(uint, const T&in) const", asMETHODPR(CScriptArrayView, Find, (asUINT, void*) const, int), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "array<uint>@ findAll(const T&in) const", asMETHOD(CScriptArrayView, FindAll), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void fill(const T&in)", asMETHOD(CScriptArrayView, Fill), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "T sum() const", asFUNCTION(ScriptArrayViewSum_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "const T &min() const", asMETHOD(CScriptArrayView, Min), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "const T &max() const", asMETHOD(CScriptArrayView, Max), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "bool opEquals(const arrayview<T>&in) const", asMETHOD(CScriptArrayView, operator==), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "uint get_length() const", asMETHOD(CScriptArrayView, GetSize), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "uint get_offset() const", asMETHOD(CScriptArrayView, GetOffset), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "uint get_stride() const", asMETHOD(CScriptArrayView, GetStride), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_GETREFCOUNT, "int f()", asMETHOD(CScriptArrayView, GetRefCount), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_SETGCFLAG, "void f()", asMETHOD(CScriptArrayView, SetFlag), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_GETGCFLAG, "bool f()", asMETHOD(CScriptArrayView, GetFlag), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_ENUMREFS, "void f(int&in)", asMETHOD(CScriptArrayView, EnumReferences), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_RELEASEREFS, "void f(int&in)", asMETHOD(CScriptArrayView, ReleaseAllHandles), asCALL_THISCALL); assert( r >= 0 );
+
+	// The array method is registered after the view type is complete
+	r = engine->RegisterObjectMethod("array<T>", "arrayview<T>@ view(uint start = 0, uint count = uint(-1), uint stride = 1)", asMETHOD(CScriptArray, View), asCALL_THISCALL); assert( r >= 0 );
+
 #if AS_USE_STLNAMES == 1
 	// Same as length
 	r = engine->RegisterObjectMethod("array<T>", "uint size() const", asMETHOD(CScriptArray, GetSize), asCALL_THISCALL); assert( r >= 0 );
@@ -715,78 +1213,21 @@ void CScriptArray::Destruct(SArrayBuffer *buf, asUINT start, asUINT end)
 }
 
 
-// internal
-bool CScriptArray::Less(const void *a, const void *b, bool asc, asIScriptContext *ctx)
+void CScriptArray::Reverse()
 {
-	if( !asc )
-	{
-		// Swap items
-		const void *TEMP = a;
-		a = b;
-		b = TEMP;
-	}
-
-	if( !(subTypeId & ~asTYPEID_MASK_SEQNBR) )
-	{
-		// Simple compare of values
-		switch( subTypeId )
-		{
-			#define COMPARE(T) *((T*)a) < *((T*)b)
-			case asTYPEID_BOOL: return COMPARE(bool);
-			case asTYPEID_INT8: return COMPARE(signed char);
-			case asTYPEID_UINT8: return COMPARE(unsigned char);
-			case asTYPEID_INT16: return COMPARE(signed short);
-			case asTYPEID_UINT16: return COMPARE(unsigned short);
-			case asTYPEID_INT32: return COMPARE(signed int);
-			case asTYPEID_UINT32: return COMPARE(unsigned int);
-			case asTYPEID_FLOAT: return COMPARE(float);
-			case asTYPEID_DOUBLE: return COMPARE(double);
-			default: return COMPARE(signed int); // All enums fall in this case
-			#undef COMPARE
-		}
-	}
-	else if( subTypeId & asTYPEID_OBJHANDLE )
-	{
-		return *((void**)a) < *((void**)b);
-	}
-	else
-	{
-		int r = 0;
-
-		// Execute object opCmp
-		SArrayCache *cache = reinterpret_cast<SArrayCache*>(objType->GetUserData(ARRAY_CACHE));
-		if( cache && cache->cmpFunc )
-		{
-			// TODO: Add proper error handling
-			r = ctx->Prepare(cache->cmpFunc); assert(r >= 0);
-			r = ctx->SetObject((void*)a); assert(r >= 0);
-			r = ctx->SetArgObject(0, (void*)b); assert(r >= 0);
-			r = ctx->Execute();
-
-			if( r == asEXECUTION_FINISHED )
-			{
-				return (int)ctx->GetReturnDWord() < 0;
-			}
-		}
-	}
-
-	return false;
+	ReverseRange(buffer->data, GetSize());
 }
 
-void CScriptArray::Reverse()
+// internal
+void CScriptArray::ReverseRange(asBYTE *data, asUINT count)
 {
-	asUINT size = GetSize();
-
-	if( size >= 2 )
+	// The elements are either primitives or pointers, so they can be moved as integers
+	switch( elementSize )
 	{
-		asBYTE TEMP[16];
-
-		for( asUINT i = 0; i < size / 2; i++ )
-		{
-			Copy(TEMP, GetArrayItemPointer(i));
-			Copy(GetArrayItemPointer(i), GetArrayItemPointer(size - i - 1));
-			Copy(GetArrayItemPointer(size - i - 1), TEMP);
-		}
+	case 1:  ReverseElements((asBYTE*)data, count); break;
+	case 2:  ReverseElements((asWORD*)data, count); break;
+	case 4:  ReverseElements((asDWORD*)data, count); break;
+	default: ReverseElements((asQWORD*)data, count); break;
 	}
 }
 
@@ -798,6 +1239,29 @@ bool CScriptArray::operator==(const CScriptArray &other) const
 	if( GetSize() != other.GetSize() )
 		return false;
 
+	return EqualRanges(buffer->data, other.buffer->data, GetSize());
+}
+
+// internal
+bool CScriptArray::EqualRanges(const asBYTE *a, const asBYTE *b, asUINT count) const
+{
+	// Primitives and handles are compared without involving the script engine
+	if( !(subTypeId & ~asTYPEID_MASK_SEQNBR) || (subTypeId & asTYPEID_OBJHANDLE) )
+	{
+		if( subTypeId == asTYPEID_FLOAT )
+			return AllEqual((const float*)a, (const float*)b, count);
+		if( subTypeId == asTYPEID_DOUBLE )
+			return AllEqual((const double*)a, (const double*)b, count);
+
+		switch( elementSize )
+		{
+		case 1:  return AllEqual((const asBYTE*)a, (const asBYTE*)b, count);
+		case 2:  return AllEqual((const asWORD*)a, (const asWORD*)b, count);
+		case 4:  return AllEqual((const asDWORD*)a, (const asDWORD*)b, count);
+		default: return AllEqual((const asQWORD*)a, (const asQWORD*)b, count);
+		}
+	}
+
 	asIScriptContext *cmpContext = 0;
 	bool isNested = false;
 
@@ -824,8 +1288,8 @@ bool CScriptArray::operator==(const CScriptArray &other) const
 	// Check if all elements are equal
 	bool isEqual = true;
 	SArrayCache *cache = reinterpret_cast<SArrayCache*>(objType->GetUserData(ARRAY_CACHE));
-	for( asUINT n = 0; n < GetSize(); n++ )
-		if( !Equals(At(n), other.At(n), cmpContext, cache) )
+	for( asUINT n = 0; n < count; n++ )
+		if( !Equals(ElementAt(a, n), ElementAt(b, n), cmpContext, cache) )
 		{
 			isEqual = false;
 			break;
@@ -909,6 +1373,44 @@ bool CScriptArray::Equals(const void *a, const void *b, asIScriptContext *ctx, S
 	return false;
 }
 
+// Searches for the value in one part of the elements
+template<class T>
+struct SFindTask
+{
+	const T *data;
+	asUINT   count;
+	asUINT   numTasks;
+	T        value;
+	int      found[MAX_PARALLEL_TASKS];
+
+	static void Run(asUINT n, void *param)
+	{
+		SFindTask *task = reinterpret_cast<SFindTask*>(param);
+		asUINT start = GetPartStart(n, task->numTasks, task->count);
+		asUINT end = GetPartStart(n+1, task->numTasks, task->count);
+		asUINT i = start + FindFirstEqual(task->data + start, end - start, task->value);
+		task->found[n] = i < end ? (int)i : -1;
+	}
+};
+
+template<class T>
+static int FindNative(const SArrayParallelism *par, const void *data, asUINT start, asUINT end, const void *value)
+{
+	SFindTask<T> task;
+	task.data     = (const T*)data + start;
+	task.count    = end - start;
+	task.numTasks = GetParallelTaskCount(par, task.count);
+	task.value    = *(const T*)value;
+	RunParallelTasks(par, SFindTask<T>::Run, &task, task.numTasks);
+
+	// The first part where the value was found holds the lowest index
+	for( asUINT n = 0; n < task.numTasks; n++ )
+		if( task.found[n] >= 0 )
+			return task.found[n] + (int)start;
+
+	return -1;
+}
+
 int CScriptArray::Find(void *value) const
 {
 	return Find(0, value);
@@ -916,6 +1418,34 @@ int CScriptArray::Find(void *value) const
 
 int CScriptArray::Find(asUINT index, void *value) const
 {
+	return FindRange(buffer->data, index, GetSize(), value);
+}
+
+// internal
+int CScriptArray::FindRange(const asBYTE *data, asUINT start, asUINT end, void *value) const
+{
+	// Primitives and handles are compared without involving the script engine
+	if( !(subTypeId & ~asTYPEID_MASK_SEQNBR) || (subTypeId & asTYPEID_OBJHANDLE) )
+	{
+		if( start >= end )
+			return -1;
+
+		const SArrayParallelism *par = GetParallelism(objType);
+		if( subTypeId == asTYPEID_FLOAT )
+			return FindNative<float>(par, data, start, end, value);
+		if( subTypeId == asTYPEID_DOUBLE )
+			return FindNative<double>(par, data, start, end, value);
+
+		// The other types are equal if the bytes are equal
+		switch( elementSize )
+		{
+		case 1:  return FindNative<asBYTE>(par, data, start, end, value);
+		case 2:  return FindNative<asWORD>(par, data, start, end, value);
+		case 4:  return FindNative<asDWORD>(par, data, start, end, value);
+		default: return FindNative<asQWORD>(par, data, start, end, value);
+		}
+	}
+
 	// Check if the subtype really supports find()
 	// TODO: Can't this be done at compile time too by the template callback
 	SArrayCache *cache = 0;
@@ -968,18 +1498,13 @@ int CScriptArray::Find(asUINT index, void *value) const
 
 	// Find the matching element
 	int ret = -1;
-	asUINT size = GetSize();
-
-	if( index < size )
+	for( asUINT i = start; i < end; i++ )
 	{
-		for( asUINT i = index; i < size; i++ )
+		// value passed by reference
+		if( Equals(ElementAt(data, i), (value), cmpContext, cache) )
 		{
-			// value passed by reference
-			if( Equals(At(i), (value), cmpContext, cache) )
-			{
-				ret = (int)i;
-				break;
-			}
+			ret = (int)i;
+			break;
 		}
 	}
 
@@ -999,37 +1524,447 @@ int CScriptArray::Find(asUINT index, void *value) const
 
 
 
-// internal
-// Copy object handle or primitive value
-void CScriptArray::Copy(void *dst, void *src)
+template<class T>
+static void FindAllNative(const void *data, asUINT count, const void *value, CScriptArray *indices)
 {
-	memcpy(dst, src, elementSize);
+	// Count the elements first so the array is only resized once
+	T v = *(const T*)value;
+	asUINT found = FindAllEqual((const T*)data, count, v, 0);
+	if( found == 0 )
+		return;
+
+	indices->Resize(found);
+	if( indices->GetSize() == found )
+		FindAllEqual((const T*)data, count, v, (asUINT*)indices->At(0));
 }
 
+// Returns a new array<uint> with the indices of all the elements that are equal to the value
+CScriptArray *CScriptArray::FindAll(void *value) const
+{
+	CScriptArray *indices = new CScriptArray(0, GetIndexArrayType(objType));
+	FindAllRange(buffer->data, GetSize(), value, indices);
+	return indices;
+}
 
 // internal
-// Return pointer to array item (object handle or primitive value)
+void CScriptArray::FindAllRange(const asBYTE *data, asUINT count, void *value, CScriptArray *indices) const
+{
+	if( !(subTypeId & ~asTYPEID_MASK_SEQNBR) || (subTypeId & asTYPEID_OBJHANDLE) )
+	{
+		if( subTypeId == asTYPEID_FLOAT )
+			FindAllNative<float>(data, count, value, indices);
+		else if( subTypeId == asTYPEID_DOUBLE )
+			FindAllNative<double>(data, count, value, indices);
+		else
+		{
+			switch( elementSize )
+			{
+			case 1:  FindAllNative<asBYTE>(data, count, value, indices); break;
+			case 2:  FindAllNative<asWORD>(data, count, value, indices); break;
+			case 4:  FindAllNative<asDWORD>(data, count, value, indices); break;
+			default: FindAllNative<asQWORD>(data, count, value, indices); break;
+			}
+		}
+	}
+	else
+	{
+		// Objects are compared with opEquals or opCmp by FindRange(). The 
+		// capacity is doubled as needed to avoid reallocating for each index
+		asUINT capacity = 0;
+		for( int n = FindRange(data, 0, count, value); n >= 0; n = FindRange(data, n + 1, count, value) )
+		{
+			if( indices->GetSize() == capacity )
+				indices->Reserve(capacity = capacity ? 2*capacity : 16);
+
+			asUINT index = n;
+			indices->InsertLast(&index);
+		}
+	}
+}
+
+// internal
+// Copy object handle or primitive value
+void CScriptArray::Copy(void *dst, void *src)
+{
+	memcpy(dst, src, elementSize);
+}
+
+
+// internal
+// Return pointer to array item (object handle or primitive value)
 void *CScriptArray::GetArrayItemPointer(int index)
 {
 	return buffer->data + index * elementSize;
 }
 
 // internal
-// Return pointer to data in buffer (object or primitive)
-void *CScriptArray::GetDataPointer(void *buffer)
+// Return pointer to the object, or to the handle or primitive value, like At()
+const void *CScriptArray::ElementAt(const asBYTE *data, asUINT index) const
+{
+	if( (subTypeId & asTYPEID_MASK_OBJECT) && !(subTypeId & asTYPEID_OBJHANDLE) )
+		return ((void**)data)[index];
+	else
+		return data + elementSize*index;
+}
+
+// The sorting algorithms work directly on the buffer, where each element is either a
+// primitive value or a pointer to the object or handle. The comparators may not be
+// consistent, e.g. for float NaNs or a script function that doesn't give a strict
+// ordering, so the algorithms must never rely on the comparator to stop at the bounds.
+// If a comparator fails, e.g. because of a script exception, the sorting is interrupted
+// but all the elements are still kept in the array.
+
+template<class T, class LESS>
+static void InsertionSort(T *first, T *last, LESS &less)
 {
-	if ((subTypeId & asTYPEID_MASK_OBJECT) && !(subTypeId & asTYPEID_OBJHANDLE) )
+	for( T *i = first + 1; i < last && !less.failed; i++ )
 	{
-		// Real address of object
-		return reinterpret_cast<void*>(*(size_t*)buffer);
+		T tmp = *i;
+		T *j = i;
+		for( ; j > first && less(tmp, *(j-1)); j-- )
+			*j = *(j-1);
+		*j = tmp;
 	}
-	else
+}
+
+template<class T, class LESS>
+static void SiftDown(T *first, size_t root, size_t count, LESS &less)
+{
+	T tmp = first[root];
+	for(;;)
+	{
+		size_t child = 2*root + 1;
+		if( child >= count )
+			break;
+		if( child + 1 < count && less(first[child], first[child+1]) )
+			child++;
+		if( !less(tmp, first[child]) )
+			break;
+		first[root] = first[child];
+		root = child;
+	}
+	first[root] = tmp;
+}
+
+template<class T, class LESS>
+static void HeapSort(T *first, T *last, LESS &less)
+{
+	size_t count = last - first;
+	for( size_t n = count/2; n-- > 0 && !less.failed; )
+		SiftDown(first, n, count, less);
+	for( size_t n = count; n-- > 1 && !less.failed; )
+	{
+		T tmp = first[0];
+		first[0] = first[n];
+		first[n] = tmp;
+		SiftDown(first, 0, n, less);
+	}
+}
+
+// Quicksort that switches to heapsort if the partitioning gets too deep,
+// so the worst case is O(n log n). Small partitions use insertion sort.
+template<class T, class LESS>
+static void IntroSort(T *first, T *last, LESS &less, int depth)
+{
+	while( last - first > 16 && !less.failed )
+	{
+		if( depth-- == 0 )
+		{
+			HeapSort(first, last, less);
+			return;
+		}
+
+		// Use the median of the first, middle, and last elements as pivot
+		T *mid = first + (last - first)/2;
+		T a = *first, b = *mid, c = *(last-1);
+		T pivot = less(a, b) ? (less(b, c) ? b : (less(a, c) ? c : a)) : (less(a, c) ? a : (less(b, c) ? c : b));
+
+		ptrdiff_t lo = 0, hi = (last - first) - 1;
+		while( lo <= hi )
+		{
+			while( lo <= hi && less(first[lo], pivot) ) lo++;
+			while( lo <= hi && less(pivot, first[hi]) ) hi--;
+			if( lo <= hi )
+			{
+				T tmp = first[lo];
+				first[lo++] = first[hi];
+				first[hi--] = tmp;
+			}
+		}
+
+		// Recurse on the smaller partition to limit the stack usage
+		if( hi + 1 < (last - first) - lo )
+		{
+			IntroSort(first, first + hi + 1, less, depth);
+			first += lo;
+		}
+		else
+		{
+			IntroSort(first + lo, last, less, depth);
+			last = first + hi + 1;
+		}
+	}
+
+	InsertionSort(first, last, less);
+}
+
+// Bottom-up merge sort that keeps the order of equal elements. Returns false if out of memory
+template<class T, class LESS>
+static bool MergeSort(T *first, T *last, LESS &less)
+{
+	const size_t RUN = 16;
+	size_t count = last - first;
+	for( size_t n = 0; n < count; n += RUN )
+		InsertionSort(first + n, first + (n + RUN < count ? n + RUN : count), less);
+	if( count <= RUN )
+		return true;
+
+	T *tmp = new (nothrow) T[count];
+	if( tmp == 0 )
+		return false;
+
+	T *src = first, *dst = tmp;
+	for( size_t width = RUN; width < count && !less.failed; width *= 2 )
+	{
+		for( size_t n = 0; n < count; n += 2*width )
+		{
+			size_t mid = n + width < count ? n + width : count;
+			size_t end = n + 2*width < count ? n + 2*width : count;
+			size_t a = n, b = mid, d = n;
+			while( a < mid && b < end )
+				dst[d++] = less(src[b], src[a]) ? src[b++] : src[a++];
+			while( a < mid )
+				dst[d++] = src[a++];
+			while( b < end )
+				dst[d++] = src[b++];
+		}
+
+		T *t = src; src = dst; dst = t;
+	}
+
+	if( src != first )
+		memcpy(first, src, count*sizeof(T));
+	delete[] tmp;
+
+	return true;
+}
+
+template<class T, class LESS>
+static bool SortElements(T *first, T *last, LESS &less, bool stable)
+{
+	if( stable )
+		return MergeSort(first, last, less);
+
+	int depth = 0;
+	for( size_t n = last - first; n > 1; n >>= 1 )
+		depth += 2;
+	IntroSort(first, last, less, depth);
+	return true;
+}
+
+// Compares primitives and handles without involving the script engine
+template<class T>
+struct SNativeLess
+{
+	bool asc;
+	bool failed;
+	bool operator()(const T &a, const T &b) { return asc ? a < b : b < a; }
+};
+
+// NaNs are placed last in ascending order so the comparison stays consistent
+template<class T>
+struct SFloatLess
+{
+	bool asc;
+	bool failed;
+	bool operator()(const T &a, const T &b) { return asc ? (a < b || (b != b && a == a)) : (b < a || (a != a && b == b)); }
+};
+
+// Calls the opCmp method of the objects
+struct SOpCmpLess
+{
+	asIScriptContext  *ctx;
+	asIScriptFunction *func;
+	bool               asc;
+	bool               failed;
+
+	bool operator()(void *a, void *b)
+	{
+		if( failed )
+			return false;
+		if( !asc )
+		{
+			void *tmp = a;
+			a = b;
+			b = tmp;
+		}
+
+		ctx->Prepare(func);
+		ctx->SetObject(a);
+		ctx->SetArgObject(0, b);
+		if( ctx->Execute() != asEXECUTION_FINISHED )
+		{
+			failed = true;
+			return false;
+		}
+		return (int)ctx->GetReturnDWord() < 0;
+	}
+};
+
+// Calls the script function given to sort(). T only tells the size of the element
+template<class T>
+struct SFuncLess
+{
+	asIScriptContext  *ctx;
+	asIScriptFunction *func;
+	bool               isObject; // The elements are pointers to the objects
+	bool               isHandle;
+	bool               byRef[2];
+	bool               failed;
+
+	int SetArg(asUINT arg, T &value)
+	{
+		// Objects and handles are always stored as pointers
+		const bool isPointerSize = sizeof(T) == sizeof(void*);
+		if( byRef[arg] )
+			return ctx->SetArgAddress(arg, (isPointerSize && isObject) ? *(void**)&value : (void*)&value);
+		if( isPointerSize && isHandle )
+			return ctx->SetArgObject(arg, *(void**)&value);
+		switch( sizeof(T) )
+		{
+		case 1:  return ctx->SetArgByte(arg, *(asBYTE*)&value);
+		case 2:  return ctx->SetArgWord(arg, *(asWORD*)&value);
+		case 4:  return ctx->SetArgDWord(arg, *(asDWORD*)&value);
+		default: return ctx->SetArgQWord(arg, *(asQWORD*)&value);
+		}
+	}
+
+	bool operator()(T &a, T &b)
+	{
+		if( failed )
+			return false;
+
+		ctx->Prepare(func);
+		SetArg(0, a);
+		SetArg(1, b);
+		if( ctx->Execute() != asEXECUTION_FINISHED )
+		{
+			failed = true;
+			return false;
+		}
+		return ctx->GetReturnByte() != 0;
+	}
+};
+
+// Each task first sorts its own part of the elements, then the sorted parts are merged 
+// pairwise in parallel until only one remains. The merge takes the element from the first
+// part when they are equal, so the order of equal elements is kept for the stable sort.
+// Only the comparators that don't call the script engine can be used in parallel.
+template<class T, class LESS>
+struct SSortTask
+{
+	T     *src;
+	T     *dst;
+	asUINT count;
+	asUINT numTasks;
+	asUINT width;    // The number of sorted parts that are merged into each part of the next round
+	LESS   less;
+	bool   stable;
+	bool   sorted[MAX_PARALLEL_TASKS];
+
+	static void Sort(asUINT n, void *param)
+	{
+		SSortTask *task = reinterpret_cast<SSortTask*>(param);
+		LESS less = task->less;
+		T *data = task->src;
+		task->sorted[n] = SortElements(data + GetPartStart(n, task->numTasks, task->count), data + GetPartStart(n+1, task->numTasks, task->count), less, task->stable);
+	}
+
+	static void Merge(asUINT n, void *param)
+	{
+		SSortTask *task = reinterpret_cast<SSortTask*>(param);
+		LESS less = task->less;
+		asUINT first = 2*n*task->width;
+		asUINT a   = GetPartStart(first, task->numTasks, task->count);
+		asUINT mid = GetPartStart(first + task->width < task->numTasks ? first + task->width : task->numTasks, task->numTasks, task->count);
+		asUINT end = GetPartStart(first + 2*task->width < task->numTasks ? first + 2*task->width : task->numTasks, task->numTasks, task->count);
+		asUINT b = mid, d = a;
+		const T *src = task->src;
+		T *dst = task->dst;
+		while( a < mid && b < end )
+			dst[d++] = less(src[b], src[a]) ? src[b++] : src[a++];
+		while( a < mid )
+			dst[d++] = src[a++];
+		while( b < end )
+			dst[d++] = src[b++];
+	}
+};
+
+template<class T, class LESS>
+static bool SortParallel(const SArrayParallelism *par, T *first, T *last, LESS &less, bool stable)
+{
+	asUINT count = asUINT(last - first);
+	asUINT numTasks = GetParallelTaskCount(par, count);
+	T *tmp = numTasks > 1 ? new (nothrow) T[count] : 0;
+	if( tmp == 0 )
+		return SortElements(first, last, less, stable);
+
+	SSortTask<T, LESS> task;
+	task.src      = first;
+	task.dst      = tmp;
+	task.count    = count;
+	task.numTasks = numTasks;
+	task.width    = 1;
+	task.less     = less;
+	task.stable   = stable;
+	RunParallelTasks(par, SSortTask<T, LESS>::Sort, &task, numTasks);
+	for( asUINT n = 0; n < numTasks; n++ )
+		if( !task.sorted[n] )
+		{
+			delete[] tmp;
+			return false;
+		}
+
+	for( ; task.width < numTasks; task.width *= 2 )
 	{
-		// Primitive is just a raw data
-		return buffer;
+		RunParallelTasks(par, SSortTask<T, LESS>::Merge, &task, (numTasks + 2*task.width - 1) / (2*task.width));
+
+		T *t = task.src; task.src = task.dst; task.dst = t;
 	}
+
+	if( task.src != first )
+		memcpy(first, task.src, count*sizeof(T));
+	delete[] tmp;
+
+	return true;
+}
+
+template<class T>
+static bool SortNative(const SArrayParallelism *par, void *data, asUINT start, asUINT end, bool asc, bool stable)
+{
+	SNativeLess<T> less = {asc, false};
+	return SortParallel(par, (T*)data + start, (T*)data + end, less, stable);
+}
+
+template<class T>
+static bool SortFloat(const SArrayParallelism *par, void *data, asUINT start, asUINT end, bool asc, bool stable)
+{
+	SFloatLess<T> less = {asc, false};
+	return SortParallel(par, (T*)data + start, (T*)data + end, less, stable);
 }
 
+template<class T>
+static bool SortFunc(void *data, asUINT start, asUINT end, asIScriptContext *ctx, asIScriptFunction *func, bool isObject, bool isHandle, bool stable)
+{
+	SFuncLess<T> less = {ctx, func, isObject, isHandle, {true, true}, false};
+	for( asUINT n = 0; n < 2; n++ )
+	{
+		asDWORD flags;
+		func->GetParamTypeId(n, &flags);
+		less.byRef[n] = (flags & asTM_INREF) ? true : false;
+	}
+	return SortElements((T*)data + start, (T*)data + end, less, stable);
+}
 
 // Sort ascending
 void CScriptArray::SortAsc()
@@ -1055,9 +1990,58 @@ void CScriptArray::SortDesc(asUINT index, asUINT count)
 	Sort(index, count, false);
 }
 
+// Sort ascending, keeping the order of equal elements
+void CScriptArray::StableSortAsc()
+{
+	Sort(0, GetSize(), true, true);
+}
+
+// Sort ascending, keeping the order of equal elements
+void CScriptArray::StableSortAsc(asUINT index, asUINT count)
+{
+	Sort(index, count, true, true);
+}
+
+// Sort descending, keeping the order of equal elements
+void CScriptArray::StableSortDesc()
+{
+	Sort(0, GetSize(), false, true);
+}
+
+// Sort descending, keeping the order of equal elements
+void CScriptArray::StableSortDesc(asUINT index, asUINT count)
+{
+	Sort(index, count, false, true);
+}
+
+void CScriptArray::Sort(asUINT index, asUINT count, bool asc, bool stable)
+{
+	if( !CheckCmpFunc() )
+		return;
+
+	if( !CheckSortRange(index, count) )
+		return;
+
+	SortRange(buffer->data + index*elementSize, count, asc, stable, 0);
+}
+
+void CScriptArray::Sort(asIScriptFunction *less, asUINT index, asUINT count, bool stable)
+{
+	if( !CheckLessFunc(less) )
+		return;
+
+	// Sort until the end of the array if the count is larger than the remaining elements
+	if( index <= buffer->numElements && count > buffer->numElements - index )
+		count = buffer->numElements - index;
+
+	if( !CheckSortRange(index, count) )
+		return;
+
+	SortRange(buffer->data + index*elementSize, count, true, stable, less);
+}
 
 // internal
-void CScriptArray::Sort(asUINT index, asUINT count, bool asc)
+bool CScriptArray::CheckCmpFunc() const
 {
 	// Subtype isn't primitive and doesn't have opCmp
 	SArrayCache *cache = reinterpret_cast<SArrayCache*>(objType->GetUserData(ARRAY_CACHE));
@@ -1080,21 +2064,50 @@ void CScriptArray::Sort(asUINT index, asUINT count, bool asc)
 				ctx->SetException(tmp);
 			}
 
-			return;
+			return false;
 		}
 	}
 
-	// No need to sort
-	if( count < 2 )
+	return true;
+}
+
+// internal
+bool CScriptArray::CheckLessFunc(asIScriptFunction *less) const
+{
+	// The function must be declared as bool less(const T&in a, const T&in b).
+	// Primitives and handles may also be passed by value.
+	bool isValid = less && less->GetReturnTypeId() == asTYPEID_BOOL && less->GetParamCount() == 2;
+	for( asUINT n = 0; isValid && n < 2; n++ )
 	{
-		return;
+		asDWORD flags;
+		int typeId = less->GetParamTypeId(n, &flags);
+		if( (typeId & ~asTYPEID_HANDLETOCONST) != (subTypeId & ~asTYPEID_HANDLETOCONST) )
+			isValid = false;
+		else if( flags != asTM_INREF &&
+				 (flags != asTM_NONE || ((subTypeId & asTYPEID_MASK_OBJECT) && !(subTypeId & asTYPEID_OBJHANDLE))) )
+			isValid = false;
+	}
+
+	if( !isValid )
+	{
+		asIScriptContext *ctx = asGetActiveContext();
+		if( ctx )
+			ctx->SetException("Invalid comparison function");
+		return false;
 	}
 
-	int start = index;
-	int end = index + count;
+	return true;
+}
+
+// internal
+bool CScriptArray::CheckSortRange(asUINT index, asUINT count)
+{
+	// No need to sort
+	if( count < 2 )
+		return false;
 
 	// Check if we could access invalid item while sorting
-	if( start >= (int)buffer->numElements || end > (int)buffer->numElements )
+	if( index >= buffer->numElements || count > buffer->numElements - index )
 	{
 		asIScriptContext *ctx = asGetActiveContext();
 
@@ -1104,14 +2117,20 @@ void CScriptArray::Sort(asUINT index, asUINT count, bool asc)
 			ctx->SetException("Index out of bounds");
 		}
 
-		return;
+		return false;
 	}
 
-	asBYTE tmp[16];
+	return true;
+}
+
+// internal
+void CScriptArray::SortRange(asBYTE *data, asUINT count, bool asc, bool stable, asIScriptFunction *less)
+{
 	asIScriptContext *cmpContext = 0;
 	bool isNested = false;
 
-	if( (subTypeId & ~asTYPEID_MASK_SEQNBR) && !(subTypeId & asTYPEID_OBJHANDLE) )
+	// Only the script functions need a context. The same context is used for all the comparisons
+	if( less || ((subTypeId & ~asTYPEID_MASK_SEQNBR) && !(subTypeId & asTYPEID_OBJHANDLE)) )
 	{
 		// Try to reuse the active context
 		cmpContext = asGetActiveContext();
@@ -1131,20 +2150,48 @@ void CScriptArray::Sort(asUINT index, asUINT count, bool asc)
 		}
 	}
 
-	// Insertion sort
-	for( int i = start + 1; i < end; i++ )
+	const SArrayParallelism *par = GetParallelism(objType);
+	bool ok = true;
+	if( less )
 	{
-		Copy(tmp, GetArrayItemPointer(i));
-
-		int j = i - 1;
-
-		while( j >= start && Less(GetDataPointer(tmp), At(j), asc, cmpContext) )
+		bool isObject = (subTypeId & asTYPEID_MASK_OBJECT) && !(subTypeId & asTYPEID_OBJHANDLE);
+		bool isHandle = (subTypeId & asTYPEID_OBJHANDLE) ? true : false;
+		switch( elementSize )
 		{
-			Copy(GetArrayItemPointer(j + 1), GetArrayItemPointer(j));
-			j--;
+		case 1:  ok = SortFunc<asBYTE>(data, 0, count, cmpContext, less, isObject, isHandle, stable); break;
+		case 2:  ok = SortFunc<asWORD>(data, 0, count, cmpContext, less, isObject, isHandle, stable); break;
+		case 4:  ok = SortFunc<asDWORD>(data, 0, count, cmpContext, less, isObject, isHandle, stable); break;
+		default: ok = SortFunc<asQWORD>(data, 0, count, cmpContext, less, isObject, isHandle, stable); break;
+		}
+	}
+	else if( subTypeId & asTYPEID_OBJHANDLE )
+	{
+		// Handles are ordered by their address
+		ok = SortNative<asPWORD>(par, data, 0, count, asc, stable);
+	}
+	else if( subTypeId & ~asTYPEID_MASK_SEQNBR )
+	{
+		SArrayCache *cache = reinterpret_cast<SArrayCache*>(objType->GetUserData(ARRAY_CACHE));
+		SOpCmpLess cmp = {cmpContext, cache->cmpFunc, asc, false};
+		ok = SortElements((void**)data, (void**)data + count, cmp, stable);
+	}
+	else
+	{
+		switch( subTypeId )
+		{
+		case asTYPEID_BOOL:   ok = SortNative<bool>(par, data, 0, count, asc, stable); break;
+		case asTYPEID_INT8:   ok = SortNative<signed char>(par, data, 0, count, asc, stable); break;
+		case asTYPEID_UINT8:  ok = SortNative<unsigned char>(par, data, 0, count, asc, stable); break;
+		case asTYPEID_INT16:  ok = SortNative<signed short>(par, data, 0, count, asc, stable); break;
+		case asTYPEID_UINT16: ok = SortNative<unsigned short>(par, data, 0, count, asc, stable); break;
+		case asTYPEID_INT32:  ok = SortNative<signed int>(par, data, 0, count, asc, stable); break;
+		case asTYPEID_UINT32: ok = SortNative<unsigned int>(par, data, 0, count, asc, stable); break;
+		case asTYPEID_INT64:  ok = SortNative<asINT64>(par, data, 0, count, asc, stable); break;
+		case asTYPEID_UINT64: ok = SortNative<asQWORD>(par, data, 0, count, asc, stable); break;
+		case asTYPEID_FLOAT:  ok = SortFloat<float>(par, data, 0, count, asc, stable); break;
+		case asTYPEID_DOUBLE: ok = SortFloat<double>(par, data, 0, count, asc, stable); break;
+		default:              ok = SortNative<signed int>(par, data, 0, count, asc, stable); break; // All enums fall in this case
 		}
-
-		Copy(GetArrayItemPointer(j + 1), tmp);
 	}
 
 	if( cmpContext )
@@ -1157,18 +2204,231 @@ void CScriptArray::Sort(asUINT index, asUINT count, bool asc)
 		}
 		else
 			cmpContext->Release();
+
+	if( !ok )
+	{
+		// Out of memory
+		asIScriptContext *ctx = asGetActiveContext();
+		if( ctx )
+			ctx->SetException("Out of memory");
+	}
+}
+
+// Sets one part of the elements to the value
+template<class T>
+struct SFillTask
+{
+	T     *data;
+	asUINT count;
+	asUINT numTasks;
+	T      value;
+
+	static void Run(asUINT n, void *param)
+	{
+		SFillTask *task = reinterpret_cast<SFillTask*>(param);
+		asUINT start = GetPartStart(n, task->numTasks, task->count);
+		FillElements(task->data + start, GetPartStart(n+1, task->numTasks, task->count) - start, task->value);
+	}
+};
+
+template<class T>
+static void FillNative(const SArrayParallelism *par, void *data, asUINT count, const void *value)
+{
+	// The value is copied first as it may be one of the elements
+	SFillTask<T> task = {(T*)data, count, GetParallelTaskCount(par, count), *(const T*)value};
+	RunParallelTasks(par, SFillTask<T>::Run, &task, task.numTasks);
+}
+
+// Set all elements to the value
+void CScriptArray::Fill(void *value)
+{
+	// Objects and handles must be assigned one by one so the references are updated
+	if( subTypeId & asTYPEID_MASK_OBJECT )
+	{
+		for( asUINT n = 0; n < GetSize(); n++ )
+			SetValue(n, value);
+		return;
+	}
+
+	FillRange(buffer->data, GetSize(), value);
 }
 
 // internal
-void CScriptArray::CopyBuffer(SArrayBuffer *dst, SArrayBuffer *src)
+// Only for primitives, as objects and handles must be assigned one by one
+void CScriptArray::FillRange(asBYTE *data, asUINT count, void *value)
 {
-	asIScriptEngine *engine = objType->GetEngine();
-	if( subTypeId & asTYPEID_OBJHANDLE )
+	const SArrayParallelism *par = GetParallelism(objType);
+	switch( elementSize )
 	{
-		// Copy the references and increase the reference counters
-		if( dst->numElements > 0 && src->numElements > 0 )
+	case 1:  FillNative<asBYTE>(par, data, count, value); break;
+	case 2:  FillNative<asWORD>(par, data, count, value); break;
+	case 4:  FillNative<asDWORD>(par, data, count, value); break;
+	default: FillNative<asQWORD>(par, data, count, value); break;
+	}
+}
+
+enum EArrayReduceOp
+{
+	REDUCE_SUM,
+	REDUCE_MIN,
+	REDUCE_MAX
+};
+
+// The sum is always computed over the same parts and then added in order, so the 
+// result is the same regardless of the number of tasks, even with rounding errors
+template<class T>
+struct SSumTask
+{
+	const T *data;
+	asUINT   count;
+	asUINT   numTasks;
+	T        partial[MAX_PARALLEL_TASKS];
+
+	static void Run(asUINT n, void *param)
+	{
+		SSumTask *task = reinterpret_cast<SSumTask*>(param);
+		asUINT lastPart = GetPartStart(n+1, task->numTasks, MAX_PARALLEL_TASKS);
+		for( asUINT p = GetPartStart(n, task->numTasks, MAX_PARALLEL_TASKS); p < lastPart; p++ )
 		{
-			int count = dst->numElements > src->numElements ? src->numElements : dst->numElements;
+			asUINT end = GetPartStart(p+1, MAX_PARALLEL_TASKS, task->count);
+			T sum = T(0);
+			for( asUINT i = GetPartStart(p, MAX_PARALLEL_TASKS, task->count); i < end; i++ )
+				sum = T(sum + task->data[i]);
+			task->partial[p] = sum;
+		}
+	}
+};
+
+// The comparator decides which is the smallest, so NaNs are ignored by min() but returned by max()
+template<class T, class LESS>
+struct SMinMaxTask
+{
+	const T *data;
+	asUINT   count;
+	asUINT   numTasks;
+	bool     isMax;
+	LESS     less;
+	asUINT   found[MAX_PARALLEL_TASKS];
+
+	static void Run(asUINT n, void *param)
+	{
+		SMinMaxTask *task = reinterpret_cast<SMinMaxTask*>(param);
+		LESS less = task->less;
+		const T *data = task->data;
+		asUINT found = GetPartStart(n, task->numTasks, task->count);
+		asUINT end = GetPartStart(n+1, task->numTasks, task->count);
+		for( asUINT i = found + 1; i < end; i++ )
+			if( task->isMax ? less(data[found], data[i]) : less(data[i], data[found]) )
+				found = i;
+		task->found[n] = found;
+	}
+};
+
+// Returns a pointer to the sum, or to the smallest or largest element
+template<class T, class LESS>
+static const void *ReduceNative(const SArrayParallelism *par, const void *data, asUINT count, int op, void *sum)
+{
+	if( op == REDUCE_SUM )
+	{
+		SSumTask<T> task;
+		task.data     = (const T*)data;
+		task.count    = count;
+		task.numTasks = GetParallelTaskCount(par, count);
+		RunParallelTasks(par, SSumTask<T>::Run, &task, task.numTasks);
+
+		T result = T(0);
+		for( asUINT p = 0; p < MAX_PARALLEL_TASKS; p++ )
+			result = T(result + task.partial[p]);
+		*(T*)sum = result;
+		return sum;
+	}
+
+	SMinMaxTask<T, LESS> task;
+	task.data        = (const T*)data;
+	task.count       = count;
+	task.numTasks    = GetParallelTaskCount(par, count);
+	task.isMax       = op == REDUCE_MAX;
+	task.less.asc    = true;
+	task.less.failed = false;
+	RunParallelTasks(par, SMinMaxTask<T, LESS>::Run, &task, task.numTasks);
+
+	// Pick the first of the equal elements
+	asUINT found = task.found[0];
+	for( asUINT n = 1; n < task.numTasks; n++ )
+		if( task.isMax ? task.less(task.data[found], task.data[task.found[n]]) : task.less(task.data[task.found[n]], task.data[found]) )
+			found = task.found[n];
+	return task.data + found;
+}
+
+// Stores the sum of the elements in sum, which must have room for one element.
+// Returns false on failure
+bool CScriptArray::Sum(void *sum) const
+{
+	return ReduceRange(buffer->data, GetSize(), REDUCE_SUM, sum) != 0;
+}
+
+// Returns a pointer to the smallest element, or 0 on failure
+const void *CScriptArray::Min() const
+{
+	return ReduceRange(buffer->data, GetSize(), REDUCE_MIN, 0);
+}
+
+// Returns a pointer to the largest element, or 0 on failure
+const void *CScriptArray::Max() const
+{
+	return ReduceRange(buffer->data, GetSize(), REDUCE_MAX, 0);
+}
+
+// internal
+// Returns a pointer to sum, or to the smallest or largest of the elements at data
+const void *CScriptArray::ReduceRange(const asBYTE *data, asUINT count, int op, void *sum) const
+{
+	const char *error = 0;
+	if( subTypeId & ~asTYPEID_MASK_SEQNBR )
+		error = "The element type is not a primitive";
+	else if( op != REDUCE_SUM && count == 0 )
+		error = "The array is empty";
+	else if( op == REDUCE_SUM && subTypeId == asTYPEID_BOOL )
+		error = "The sum of bool elements is not defined";
+
+	if( error )
+	{
+		// Throw an exception
+		asIScriptContext *ctx = asGetActiveContext();
+		if( ctx )
+			ctx->SetException(error);
+
+		return 0;
+	}
+
+	const SArrayParallelism *par = GetParallelism(objType);
+	switch( subTypeId )
+	{
+	case asTYPEID_BOOL:   return ReduceNative<bool, SNativeLess<bool> >(par, data, count, op, sum);
+	case asTYPEID_INT8:   return ReduceNative<signed char, SNativeLess<signed char> >(par, data, count, op, sum);
+	case asTYPEID_UINT8:  return ReduceNative<unsigned char, SNativeLess<unsigned char> >(par, data, count, op, sum);
+	case asTYPEID_INT16:  return ReduceNative<signed short, SNativeLess<signed short> >(par, data, count, op, sum);
+	case asTYPEID_UINT16: return ReduceNative<unsigned short, SNativeLess<unsigned short> >(par, data, count, op, sum);
+	case asTYPEID_INT32:  return ReduceNative<signed int, SNativeLess<signed int> >(par, data, count, op, sum);
+	case asTYPEID_UINT32: return ReduceNative<unsigned int, SNativeLess<unsigned int> >(par, data, count, op, sum);
+	case asTYPEID_INT64:  return ReduceNative<asINT64, SNativeLess<asINT64> >(par, data, count, op, sum);
+	case asTYPEID_UINT64: return ReduceNative<asQWORD, SNativeLess<asQWORD> >(par, data, count, op, sum);
+	case asTYPEID_FLOAT:  return ReduceNative<float, SFloatLess<float> >(par, data, count, op, sum);
+	case asTYPEID_DOUBLE: return ReduceNative<double, SFloatLess<double> >(par, data, count, op, sum);
+	default:              return ReduceNative<signed int, SNativeLess<signed int> >(par, data, count, op, sum); // All enums fall in this case
+	}
+}
+
+// internal
+void CScriptArray::CopyBuffer(SArrayBuffer *dst, SArrayBuffer *src)
+{
+	asIScriptEngine *engine = objType->GetEngine();
+	if( subTypeId & asTYPEID_OBJHANDLE )
+	{
+		// Copy the references and increase the reference counters
+		if( dst->numElements > 0 && src->numElements > 0 )
+		{
+			int count = dst->numElements > src->numElements ? src->numElements : dst->numElements;
 
 			void **max = (void**)(dst->data + count * sizeof(void*));
 			void **d   = (void**)dst->data;
@@ -1241,78 +2501,498 @@ void CScriptArray::Precache()
 		return;
 	}
 
-	// Create the cache
-	cache = new SArrayCache();
-	memset(cache, 0, sizeof(SArrayCache));
+	// Create the cache
+	cache = new SArrayCache();
+	memset(cache, 0, sizeof(SArrayCache));
+
+	asIObjectType *subType = objType->GetEngine()->GetObjectTypeById(subTypeId);
+	if( subType )
+	{
+		for( asUINT i = 0; i < subType->GetMethodCount(); i++ )
+		{
+			asIScriptFunction *func = subType->GetMethodByIndex(i);
+
+			if( func->GetParamCount() == 1 /* && func->IsReadOnly() */ )
+			{
+				asDWORD flags = 0;
+				int returnTypeId = func->GetReturnTypeId();
+				int paramTypeId = func->GetParamTypeId(0, &flags);
+
+				// The parameter must either be a reference to the subtype or a handle to the subtype			
+				if( ((flags & asTM_INREF) && paramTypeId == subTypeId) ||
+					(flags == 0 && 
+					 (paramTypeId & asTYPEID_OBJHANDLE) &&
+					 (paramTypeId & ~(asTYPEID_OBJHANDLE | asTYPEID_HANDLETOCONST)) == (subTypeId & ~(asTYPEID_OBJHANDLE | asTYPEID_HANDLETOCONST))) )
+				{
+					if( returnTypeId == asTYPEID_INT32 && strcmp(func->GetName(), "opCmp") == 0 )
+						cache->cmpFunc = subType->GetMethodByIndex(i);
+
+					if( returnTypeId == asTYPEID_BOOL && strcmp(func->GetName(), "opEquals") == 0 )
+						cache->eqFunc = subType->GetMethodByIndex(i);
+
+					if( cache->cmpFunc && cache->eqFunc )
+						break;
+				}
+			}
+		}
+	}
+
+	// Set the user data only at the end so others that retrieve it will know it is complete
+	objType->SetUserData(cache, ARRAY_CACHE);
+
+	asReleaseExclusiveLock();
+}
+
+// GC behaviour
+void CScriptArray::EnumReferences(asIScriptEngine *engine)
+{
+	// If the array is holding handles, then we need to notify the GC of them
+	if( subTypeId & asTYPEID_MASK_OBJECT )
+	{
+		void **d = (void**)buffer->data;
+		for( asUINT n = 0; n < buffer->numElements; n++ )
+		{
+			if( d[n] )
+				engine->GCEnumCallback(d[n]);
+		}
+	}
+}
+
+// GC behaviour
+void CScriptArray::ReleaseAllHandles(asIScriptEngine *engine)
+{
+	// Resizing to zero will release everything
+	Resize(0);
+}
+
+void CScriptArray::AddRef() const
+{
+	// Clear the GC flag then increase the counter
+	gcFlag = false;
+	asAtomicInc(refCount);
+}
+
+void CScriptArray::Release() const
+{
+	// Clearing the GC flag then descrease the counter
+	gcFlag = false;
+	if( asAtomicDec(refCount) == 0 )
+	{
+		// When reaching 0 no more references to this instance 
+		// exists and the object should be destroyed
+		delete this;
+	}
+}
+
+// GC behaviour
+int CScriptArray::GetRefCount()
+{
+	return refCount;
+}
+
+// GC behaviour
+void CScriptArray::SetFlag()
+{
+	gcFlag = true;
+}
+
+// GC behaviour
+bool CScriptArray::GetFlag()
+{
+	return gcFlag;
+}
+
+// Returns a new view of count elements beginning at start, and then every stride element
+CScriptArrayView *CScriptArray::View(asUINT start, asUINT count, asUINT stride)
+{
+	const char *error = 0;
+	if( stride == 0 )
+		error = "Invalid stride";
+	else if( start > GetSize() )
+		error = "Index out of bounds";
+
+	if( error )
+	{
+		// Throw an exception
+		asIScriptContext *ctx = asGetActiveContext();
+		if( ctx )
+			ctx->SetException(error);
+
+		return 0;
+	}
+
+	// Reduce the count to the number of available elements
+	asUINT available = start < GetSize() ? (GetSize() - start - 1) / stride + 1 : 0;
+	if( count > available )
+		count = available;
+
+	// The view type is taken from the return type of the registered method
+	asIObjectType *viewType = objType->GetEngine()->GetObjectTypeById(objType->GetMethodByName("view")->GetReturnTypeId());
+	return new CScriptArrayView(this, start, count, count > 1 ? stride : 1, viewType);
+}
+
+//--------------------------------------------
+// Array view
+
+CScriptArrayView::CScriptArrayView(CScriptArray *arr, asUINT off, asUINT len, asUINT str, asIObjectType *ot)
+{
+	refCount = 1;
+	gcFlag = false;
+	objType = ot;
+	objType->AddRef();
+	array = arr;
+	array->AddRef();
+	offset = off;
+	length = len;
+	stride = str;
+
+	// Notify the GC of the successful creation
+	if( objType->GetFlags() & asOBJ_GC )
+		objType->GetEngine()->NotifyGarbageCollectorOfNewObject(this, objType);
+}
+
+CScriptArrayView::~CScriptArrayView()
+{
+	if( array ) array->Release();
+	if( objType ) objType->Release();
+}
+
+asIObjectType *CScriptArrayView::GetViewObjectType() const
+{
+	return objType;
+}
+
+int CScriptArrayView::GetElementTypeId() const
+{
+	return objType->GetSubTypeId();
+}
+
+CScriptArray *CScriptArrayView::GetArray() const
+{
+	return array;
+}
+
+asUINT CScriptArrayView::GetOffset() const
+{
+	return offset;
+}
+
+asUINT CScriptArrayView::GetStride() const
+{
+	return stride;
+}
+
+asUINT CScriptArrayView::GetSize() const
+{
+	return length;
+}
+
+bool CScriptArrayView::IsEmpty() const
+{
+	return length == 0;
+}
+
+// Return a pointer to the array element. Returns 0 if the index is out of bounds
+const void *CScriptArrayView::At(asUINT index) const
+{
+	if( array == 0 || index >= length )
+	{
+		// If this is called from a script we raise a script exception
+		asIScriptContext *ctx = asGetActiveContext();
+		if( ctx )
+			ctx->SetException("Index out of bounds");
+		return 0;
+	}
+
+	// The array checks that it still has the element
+	return const_cast<const CScriptArray *>(array)->At(offset + index*stride);
+}
+void *CScriptArrayView::At(asUINT index)
+{
+	return const_cast<void*>(const_cast<const CScriptArrayView *>(this)->At(index));
+}
+
+void CScriptArrayView::SetValue(asUINT index, void *value)
+{
+	if( At(index) )
+		array->SetValue(offset + index*stride, value);
+}
+
+// Returns a new view of count of the elements of this view beginning at 
+// start, and then every stride element. The new view refers to the array
+CScriptArrayView *CScriptArrayView::View(asUINT start, asUINT count, asUINT step)
+{
+	if( !CheckRange() )
+		return 0;
+
+	const char *error = 0;
+	if( step == 0 )
+		error = "Invalid stride";
+	else if( start > length )
+		error = "Index out of bounds";
+
+	if( error )
+	{
+		// Throw an exception
+		asIScriptContext *ctx = asGetActiveContext();
+		if( ctx )
+			ctx->SetException(error);
+
+		return 0;
+	}
+
+	asUINT available = start < length ? (length - start - 1) / step + 1 : 0;
+	if( count > available )
+		count = available;
+
+	// The offset and stride are only computed when they are used, so they cannot overflow
+	return new CScriptArrayView(array, count ? offset + start*stride : 0, count, count > 1 ? stride*step : 1, objType);
+}
+
+bool CScriptArrayView::operator==(const CScriptArrayView &other) const
+{
+	if( objType != other.objType )
+		return false;
+
+	if( length != other.length )
+		return false;
+
+	asBYTE *a = GetElements();
+	if( a == 0 )
+		return false;
+
+	bool isEqual = false;
+	asBYTE *b = other.GetElements();
+	if( b )
+	{
+		isEqual = array->EqualRanges(a, b, length);
+		other.PutElements(b, false);
+	}
+	PutElements(a, false);
+
+	return isEqual;
+}
+
+void CScriptArrayView::SortAsc()
+{
+	SortView(true, false, 0);
+}
+
+void CScriptArrayView::SortDesc()
+{
+	SortView(false, false, 0);
+}
+
+void CScriptArrayView::StableSortAsc()
+{
+	SortView(true, true, 0);
+}
+
+void CScriptArrayView::StableSortDesc()
+{
+	SortView(false, true, 0);
+}
+
+void CScriptArrayView::Sort(asIScriptFunction *less, bool stable)
+{
+	if( !CheckRange() || !array->CheckLessFunc(less) )
+		return;
+
+	SortView(true, stable, less);
+}
+
+// internal
+void CScriptArrayView::SortView(bool asc, bool stable, asIScriptFunction *less)
+{
+	if( !CheckRange() )
+		return;
+
+	if( less == 0 && !array->CheckCmpFunc() )
+		return;
+
+	// No need to sort
+	if( length < 2 )
+		return;
+
+	asBYTE *data = GetElements();
+	if( data == 0 )
+		return;
+
+	array->SortRange(data, length, asc, stable, less);
+	PutElements(data, true);
+}
+
+void CScriptArrayView::Reverse()
+{
+	asBYTE *data = GetElements();
+	if( data == 0 )
+		return;
+
+	array->ReverseRange(data, length);
+	PutElements(data, true);
+}
+
+int CScriptArrayView::Find(void *value) const
+{
+	return Find(0, value);
+}
+
+int CScriptArrayView::Find(asUINT index, void *value) const
+{
+	asBYTE *data = GetElements();
+	if( data == 0 )
+		return -1;
+
+	int ret = array->FindRange(data, index, length, value);
+	PutElements(data, false);
+
+	return ret;
+}
+
+// Returns a new array<uint> with the indices in the view of all the elements that are equal to the value
+CScriptArray *CScriptArrayView::FindAll(void *value) const
+{
+	CScriptArray *indices = new CScriptArray(0, GetIndexArrayType(objType));
+
+	asBYTE *data = GetElements();
+	if( data )
+	{
+		array->FindAllRange(data, length, value, indices);
+		PutElements(data, false);
+	}
+
+	return indices;
+}
+
+// Set all elements of the view to the value
+void CScriptArrayView::Fill(void *value)
+{
+	if( !CheckRange() )
+		return;
+
+	// Objects and handles must be assigned one by one so the references are updated
+	if( (array->subTypeId & asTYPEID_MASK_OBJECT) || stride != 1 )
+	{
+		for( asUINT n = 0; n < length; n++ )
+			array->SetValue(offset + n*stride, value);
+		return;
+	}
+
+	array->FillRange(array->buffer->data + offset*array->elementSize, length, value);
+}
+
+// Stores the sum of the elements in sum, which must have room for one element.
+// Returns false on failure
+bool CScriptArrayView::Sum(void *sum) const
+{
+	return Reduce(REDUCE_SUM, sum) != 0;
+}
+
+// Returns a pointer to the smallest element, or 0 on failure
+const void *CScriptArrayView::Min() const
+{
+	return Reduce(REDUCE_MIN, 0);
+}
+
+// Returns a pointer to the largest element, or 0 on failure
+const void *CScriptArrayView::Max() const
+{
+	return Reduce(REDUCE_MAX, 0);
+}
+
+// internal
+const void *CScriptArrayView::Reduce(int op, void *sum) const
+{
+	asBYTE *data = GetElements();
+	if( data == 0 )
+		return 0;
+
+	const void *ret = array->ReduceRange(data, length, op, sum);
 
-	asIObjectType *subType = objType->GetEngine()->GetObjectTypeById(subTypeId);
-	if( subType )
+	// The smallest and largest are returned from the array rather than from the copy
+	if( ret && op != REDUCE_SUM )
+		ret = At(asUINT(((const asBYTE*)ret - data) / array->elementSize));
+
+	PutElements(data, false);
+
+	return ret;
+}
+
+// internal
+// Raises an exception if the array no longer holds all the elements of the view
+bool CScriptArrayView::CheckRange() const
+{
+	if( array == 0 || (length > 0 && offset + asQWORD(length - 1)*stride >= array->GetSize()) )
 	{
-		for( asUINT i = 0; i < subType->GetMethodCount(); i++ )
-		{
-			asIScriptFunction *func = subType->GetMethodByIndex(i);
+		asIScriptContext *ctx = asGetActiveContext();
+		if( ctx )
+			ctx->SetException("Index out of bounds");
+		return false;
+	}
 
-			if( func->GetParamCount() == 1 /* && func->IsReadOnly() */ )
-			{
-				asDWORD flags = 0;
-				int returnTypeId = func->GetReturnTypeId();
-				int paramTypeId = func->GetParamTypeId(0, &flags);
+	return true;
+}
 
-				// The parameter must either be a reference to the subtype or a handle to the subtype			
-				if( ((flags & asTM_INREF) && paramTypeId == subTypeId) ||
-					(flags == 0 && 
-					 (paramTypeId & asTYPEID_OBJHANDLE) &&
-					 (paramTypeId & ~(asTYPEID_OBJHANDLE | asTYPEID_HANDLETOCONST)) == (subTypeId & ~(asTYPEID_OBJHANDLE | asTYPEID_HANDLETOCONST))) )
-				{
-					if( returnTypeId == asTYPEID_INT32 && strcmp(func->GetName(), "opCmp") == 0 )
-						cache->cmpFunc = subType->GetMethodByIndex(i);
+// internal
+// Returns the elements of the view as consecutive elements. These are in the array's 
+// buffer unless the view has a stride, in which case they are copied. Returns 0 on failure
+asBYTE *CScriptArrayView::GetElements() const
+{
+	if( !CheckRange() )
+		return 0;
 
-					if( returnTypeId == asTYPEID_BOOL && strcmp(func->GetName(), "opEquals") == 0 )
-						cache->eqFunc = subType->GetMethodByIndex(i);
+	int elementSize = array->elementSize;
+	if( stride == 1 )
+		return array->buffer->data + offset*elementSize;
 
-					if( cache->cmpFunc && cache->eqFunc )
-						break;
-				}
-			}
-		}
+	// Only the primitive values or the pointers are copied, so no references are added
+	asBYTE *data;
+	#if defined(__S3E__) // Marmalade doesn't understand (nothrow)
+	data = new asBYTE[length*elementSize];
+	#else
+	data = new (nothrow) asBYTE[length*elementSize];
+	#endif
+	if( data == 0 )
+	{
+		// Out of memory
+		asIScriptContext *ctx = asGetActiveContext();
+		if( ctx )
+			ctx->SetException("Out of memory");
+		return 0;
 	}
 
-	// Set the user data only at the end so others that retrieve it will know it is complete
-	objType->SetUserData(cache, ARRAY_CACHE);
+	for( asUINT n = 0; n < length; n++ )
+		memcpy(data + n*elementSize, array->buffer->data + (offset + n*stride)*elementSize, elementSize);
 
-	asReleaseExclusiveLock();
+	return data;
 }
 
-// GC behaviour
-void CScriptArray::EnumReferences(asIScriptEngine *engine)
+// internal
+// Moves the elements back to the array if they had been copied by GetElements()
+void CScriptArrayView::PutElements(asBYTE *data, bool modified) const
 {
-	// If the array is holding handles, then we need to notify the GC of them
-	if( subTypeId & asTYPEID_MASK_OBJECT )
+	if( stride == 1 )
+		return;
+
+	// A comparison function may have resized the array while sorting
+	if( modified && CheckRange() )
 	{
-		void **d = (void**)buffer->data;
-		for( asUINT n = 0; n < buffer->numElements; n++ )
-		{
-			if( d[n] )
-				engine->GCEnumCallback(d[n]);
-		}
+		int elementSize = array->elementSize;
+		for( asUINT n = 0; n < length; n++ )
+			memcpy(array->buffer->data + (offset + n*stride)*elementSize, data + n*elementSize, elementSize);
 	}
-}
 
-// GC behaviour
-void CScriptArray::ReleaseAllHandles(asIScriptEngine *engine)
-{
-	// Resizing to zero will release everything
-	Resize(0);
+	delete[] data;
 }
 
-void CScriptArray::AddRef() const
+void CScriptArrayView::AddRef() const
 {
 	// Clear the GC flag then increase the counter
 	gcFlag = false;
 	asAtomicInc(refCount);
 }
 
-void CScriptArray::Release() const
+void CScriptArrayView::Release() const
 {
 	// Clearing the GC flag then descrease the counter
 	gcFlag = false;
@@ -1325,23 +3005,41 @@ void CScriptArray::Release() const
 }
 
 // GC behaviour
-int CScriptArray::GetRefCount()
+int CScriptArrayView::GetRefCount()
 {
 	return refCount;
 }
 
 // GC behaviour
-void CScriptArray::SetFlag()
+void CScriptArrayView::SetFlag()
 {
 	gcFlag = true;
 }
 
 // GC behaviour
-bool CScriptArray::GetFlag()
+bool CScriptArrayView::GetFlag()
 {
 	return gcFlag;
 }
 
+// GC behaviour
+void CScriptArrayView::EnumReferences(asIScriptEngine *engine)
+{
+	// The view holds a reference to the array
+	if( array )
+		engine->GCEnumCallback(array);
+}
+
+// GC behaviour
+void CScriptArrayView::ReleaseAllHandles(asIScriptEngine *)
+{
+	if( array )
+	{
+		array->Release();
+		array = 0;
+	}
+}
+
 //--------------------------------------------
 // Generic calling conventions
 
@@ -1406,6 +3104,38 @@ static void ScriptArrayFind2_Generic(asIScriptGeneric *gen)
 	gen->SetReturnDWord(self->Find(index, value));
 }
 
+static void ScriptArrayFindAll_Generic(asIScriptGeneric *gen)
+{
+	void *value = gen->GetArgAddress(0);
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	*(CScriptArray**)gen->GetAddressOfReturnLocation() = self->FindAll(value);
+}
+
+static void ScriptArrayFill_Generic(asIScriptGeneric *gen)
+{
+	void *value = gen->GetArgAddress(0);
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	self->Fill(value);
+}
+
+static void ScriptArraySum_Generic(asIScriptGeneric *gen)
+{
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	self->Sum(gen->GetAddressOfReturnLocation());
+}
+
+static void ScriptArrayMin_Generic(asIScriptGeneric *gen)
+{
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	gen->SetReturnAddress((void*)self->Min());
+}
+
+static void ScriptArrayMax_Generic(asIScriptGeneric *gen)
+{
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	gen->SetReturnAddress((void*)self->Max());
+}
+
 static void ScriptArrayAt_Generic(asIScriptGeneric *gen)
 {
 	asUINT index = gen->GetArgDWord(0);
@@ -1504,6 +3234,54 @@ static void ScriptArraySortDesc2_Generic(asIScriptGeneric *gen)
 	self->SortDesc(index, count);
 }
 
+static void ScriptArrayStableSortAsc_Generic(asIScriptGeneric *gen)
+{
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	self->StableSortAsc();
+}
+
+static void ScriptArrayStableSortAsc2_Generic(asIScriptGeneric *gen)
+{
+	asUINT index = gen->GetArgDWord(0);
+	asUINT count = gen->GetArgDWord(1);
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	self->StableSortAsc(index, count);
+}
+
+static void ScriptArrayStableSortDesc_Generic(asIScriptGeneric *gen)
+{
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	self->StableSortDesc();
+}
+
+static void ScriptArrayStableSortDesc2_Generic(asIScriptGeneric *gen)
+{
+	asUINT index = gen->GetArgDWord(0);
+	asUINT count = gen->GetArgDWord(1);
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	self->StableSortDesc(index, count);
+}
+
+static void ScriptArraySortLess_Generic(asIScriptGeneric *gen)
+{
+	void *ref = gen->GetArgAddress(0);
+	int typeId = gen->GetArgTypeId(0);
+	asUINT index = gen->GetArgDWord(1);
+	asUINT count = gen->GetArgDWord(2);
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	ScriptArraySortLess(ref, typeId, index, count, self);
+}
+
+static void ScriptArrayStableSortLess_Generic(asIScriptGeneric *gen)
+{
+	void *ref = gen->GetArgAddress(0);
+	int typeId = gen->GetArgTypeId(0);
+	asUINT index = gen->GetArgDWord(1);
+	asUINT count = gen->GetArgDWord(2);
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	ScriptArrayStableSortLess(ref, typeId, index, count, self);
+}
+
 static void ScriptArrayAddRef_Generic(asIScriptGeneric *gen)
 {
 	CScriptArray *self = (CScriptArray*)gen->GetObject();
@@ -1548,6 +3326,199 @@ static void ScriptArrayReleaseAllHandles_Generic(asIScriptGeneric *gen)
 	self->ReleaseAllHandles(engine);
 }
 
+static void ScriptArrayView_Generic(asIScriptGeneric *gen)
+{
+	asUINT start = gen->GetArgDWord(0);
+	asUINT count = gen->GetArgDWord(1);
+	asUINT stride = gen->GetArgDWord(2);
+	CScriptArray *self = (CScriptArray*)gen->GetObject();
+	*(CScriptArrayView**)gen->GetAddressOfReturnLocation() = self->View(start, count, stride);
+}
+
+static void ScriptArrayViewAddRef_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	self->AddRef();
+}
+
+static void ScriptArrayViewRelease_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	self->Release();
+}
+
+static void ScriptArrayViewAt_Generic(asIScriptGeneric *gen)
+{
+	asUINT index = gen->GetArgDWord(0);
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	gen->SetReturnAddress(self->At(index));
+}
+
+static void ScriptArrayViewView_Generic(asIScriptGeneric *gen)
+{
+	asUINT start = gen->GetArgDWord(0);
+	asUINT count = gen->GetArgDWord(1);
+	asUINT stride = gen->GetArgDWord(2);
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	*(CScriptArrayView**)gen->GetAddressOfReturnLocation() = self->View(start, count, stride);
+}
+
+static void ScriptArrayViewLength_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	gen->SetReturnDWord(self->GetSize());
+}
+
+static void ScriptArrayViewIsEmpty_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	*(bool*)gen->GetAddressOfReturnLocation() = self->IsEmpty();
+}
+
+static void ScriptArrayViewGetOffset_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	gen->SetReturnDWord(self->GetOffset());
+}
+
+static void ScriptArrayViewGetStride_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	gen->SetReturnDWord(self->GetStride());
+}
+
+static void ScriptArrayViewSortAsc_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	self->SortAsc();
+}
+
+static void ScriptArrayViewSortDesc_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	self->SortDesc();
+}
+
+static void ScriptArrayViewStableSortAsc_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	self->StableSortAsc();
+}
+
+static void ScriptArrayViewStableSortDesc_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	self->StableSortDesc();
+}
+
+static void ScriptArrayViewSortLess_Generic(asIScriptGeneric *gen)
+{
+	void *ref = gen->GetArgAddress(0);
+	int typeId = gen->GetArgTypeId(0);
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	ScriptArrayViewSortLess(ref, typeId, self);
+}
+
+static void ScriptArrayViewStableSortLess_Generic(asIScriptGeneric *gen)
+{
+	void *ref = gen->GetArgAddress(0);
+	int typeId = gen->GetArgTypeId(0);
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	ScriptArrayViewStableSortLess(ref, typeId, self);
+}
+
+static void ScriptArrayViewReverse_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	self->Reverse();
+}
+
+static void ScriptArrayViewFind_Generic(asIScriptGeneric *gen)
+{
+	void *value = gen->GetArgAddress(0);
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	gen->SetReturnDWord(self->Find(value));
+}
+
+static void ScriptArrayViewFind2_Generic(asIScriptGeneric *gen)
+{
+	asUINT index = gen->GetArgDWord(0);
+	void *value = gen->GetArgAddress(1);
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	gen->SetReturnDWord(self->Find(index, value));
+}
+
+static void ScriptArrayViewFindAll_Generic(asIScriptGeneric *gen)
+{
+	void *value = gen->GetArgAddress(0);
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	*(CScriptArray**)gen->GetAddressOfReturnLocation() = self->FindAll(value);
+}
+
+static void ScriptArrayViewFill_Generic(asIScriptGeneric *gen)
+{
+	void *value = gen->GetArgAddress(0);
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	self->Fill(value);
+}
+
+static void ScriptArrayViewSum_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	self->Sum(gen->GetAddressOfReturnLocation());
+}
+
+static void ScriptArrayViewMin_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	gen->SetReturnAddress((void*)self->Min());
+}
+
+static void ScriptArrayViewMax_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	gen->SetReturnAddress((void*)self->Max());
+}
+
+static void ScriptArrayViewEquals_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *other = (CScriptArrayView*)gen->GetArgObject(0);
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	gen->SetReturnByte(self->operator==(*other));
+}
+
+static void ScriptArrayViewGetRefCount_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	*(int*)gen->GetAddressOfReturnLocation() = self->GetRefCount();
+}
+
+static void ScriptArrayViewSetFlag_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	self->SetFlag();
+}
+
+static void ScriptArrayViewGetFlag_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	*(bool*)gen->GetAddressOfReturnLocation() = self->GetFlag();
+}
+
+static void ScriptArrayViewEnumReferences_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	asIScriptEngine *engine = *(asIScriptEngine**)gen->GetAddressOfArg(0);
+	self->EnumReferences(engine);
+}
+
+static void ScriptArrayViewReleaseAllHandles_Generic(asIScriptGeneric *gen)
+{
+	CScriptArrayView *self = (CScriptArrayView*)gen->GetObject();
+	asIScriptEngine *engine = *(asIScriptEngine**)gen->GetAddressOfArg(0);
+	self->ReleaseAllHandles(engine);
+}
+
 static void RegisterScriptArray_Generic(asIScriptEngine *engine)
 {
 	int r;
@@ -1578,9 +3549,20 @@ static void RegisterScriptArray_Generic(asIScriptEngine *engine)
 	r = engine->RegisterObjectMethod("array<T>", "void sortAsc(uint, uint)", asFUNCTION(ScriptArraySortAsc2_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "void sortDesc()", asFUNCTION(ScriptArraySortDesc_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "void sortDesc(uint, uint)", asFUNCTION(ScriptArraySortDesc2_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void stableSortAsc()", asFUNCTION(ScriptArrayStableSortAsc_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void stableSortAsc(uint, uint)", asFUNCTION(ScriptArrayStableSortAsc2_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void stableSortDesc()", asFUNCTION(ScriptArrayStableSortDesc_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void stableSortDesc(uint, uint)", asFUNCTION(ScriptArrayStableSortDesc2_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void sort(?&in less, uint startAt = 0, uint count = uint(-1))", asFUNCTION(ScriptArraySortLess_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void stableSort(?&in less, uint startAt = 0, uint count = uint(-1))", asFUNCTION(ScriptArrayStableSortLess_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "void reverse()", asFUNCTION(ScriptArrayReverse_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "int find(const T&in) const", asFUNCTION(ScriptArrayFind_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "int find(uint, const T&in) const", asFUNCTION(ScriptArrayFind2_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "array<uint>@ findAll(const T&in) const", asFUNCTION(ScriptArrayFindAll_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "void fill(const T&in)", asFUNCTION(ScriptArrayFill_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "T sum() const", asFUNCTION(ScriptArraySum_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "const T &min() const", asFUNCTION(ScriptArrayMin_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("array<T>", "const T &max() const", asFUNCTION(ScriptArrayMax_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "bool opEquals(const array<T>&in) const", asFUNCTION(ScriptArrayEquals_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "bool isEmpty() const", asFUNCTION(ScriptArrayIsEmpty_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("array<T>", "uint get_length() const", asFUNCTION(ScriptArrayLength_Generic), asCALL_GENERIC); assert( r >= 0 );
@@ -1590,6 +3572,41 @@ static void RegisterScriptArray_Generic(asIScriptEngine *engine)
 	r = engine->RegisterObjectBehaviour("array<T>", asBEHAVE_GETGCFLAG, "bool f()", asFUNCTION(ScriptArrayGetFlag_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectBehaviour("array<T>", asBEHAVE_ENUMREFS, "void f(int&in)", asFUNCTION(ScriptArrayEnumReferences_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectBehaviour("array<T>", asBEHAVE_RELEASEREFS, "void f(int&in)", asFUNCTION(ScriptArrayReleaseAllHandles_Generic), asCALL_GENERIC); assert( r >= 0 );
+
+	r = engine->RegisterObjectType("arrayview<class T>", 0, asOBJ_REF | asOBJ_GC | asOBJ_TEMPLATE); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_TEMPLATE_CALLBACK, "bool f(int&in, bool&out)", asFUNCTION(ScriptArrayTemplateCallback_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_ADDREF, "void f()", asFUNCTION(ScriptArrayViewAddRef_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_RELEASE, "void f()", asFUNCTION(ScriptArrayViewRelease_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "T &opIndex(uint)", asFUNCTION(ScriptArrayViewAt_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "const T &opIndex(uint) const", asFUNCTION(ScriptArrayViewAt_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "arrayview<T>@ view(uint start = 0, uint count = uint(-1), uint stride = 1)", asFUNCTION(ScriptArrayViewView_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "uint length() const", asFUNCTION(ScriptArrayViewLength_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "bool isEmpty() const", asFUNCTION(ScriptArrayViewIsEmpty_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void sortAsc()", asFUNCTION(ScriptArrayViewSortAsc_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void sortDesc()", asFUNCTION(ScriptArrayViewSortDesc_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void stableSortAsc()", asFUNCTION(ScriptArrayViewStableSortAsc_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void stableSortDesc()", asFUNCTION(ScriptArrayViewStableSortDesc_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void sort(?&in less)", asFUNCTION(ScriptArrayViewSortLess_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void stableSort(?&in less)", asFUNCTION(ScriptArrayViewStableSortLess_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void reverse()", asFUNCTION(ScriptArrayViewReverse_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "int find(const T&in) const", asFUNCTION(ScriptArrayViewFind_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "int find(uint, const T&in) const", asFUNCTION(ScriptArrayViewFind2_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "array<uint>@ findAll(const T&in) const", asFUNCTION(ScriptArrayViewFindAll_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "void fill(const T&in)", asFUNCTION(ScriptArrayViewFill_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "T sum() const", asFUNCTION(ScriptArrayViewSum_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "const T &min() const", asFUNCTION(ScriptArrayViewMin_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "const T &max() const", asFUNCTION(ScriptArrayViewMax_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "bool opEquals(const arrayview<T>&in) const", asFUNCTION(ScriptArrayViewEquals_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "uint get_length() const", asFUNCTION(ScriptArrayViewLength_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "uint get_offset() const", asFUNCTION(ScriptArrayViewGetOffset_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("arrayview<T>", "uint get_stride() const", asFUNCTION(ScriptArrayViewGetStride_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_GETREFCOUNT, "int f()", asFUNCTION(ScriptArrayViewGetRefCount_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_SETGCFLAG, "void f()", asFUNCTION(ScriptArrayViewSetFlag_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_GETGCFLAG, "bool f()", asFUNCTION(ScriptArrayViewGetFlag_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_ENUMREFS, "void f(int&in)", asFUNCTION(ScriptArrayViewEnumReferences_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("arrayview<T>", asBEHAVE_RELEASEREFS, "void f(int&in)", asFUNCTION(ScriptArrayViewReleaseAllHandles_Generic), asCALL_GENERIC); assert( r >= 0 );
+
+	r = engine->RegisterObjectMethod("array<T>", "arrayview<T>@ view(uint start = 0, uint count = uint(-1), uint stride = 1)", asFUNCTION(ScriptArrayView_Generic), asCALL_GENERIC); assert( r >= 0 );
 }
 
 END_AS_NAMESPACE
@@ -17,10 +17,18 @@
 #define AS_USE_STLNAMES 0
 #endif
 
+// The parallel algorithms use the C++11 thread library when the application 
+// doesn't provide its own thread pool. Define AS_NO_SCRIPTARRAY_THREADS to
+// compile the add-on without it
+#if !defined(AS_NO_SCRIPTARRAY_THREADS) && (__cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900))
+#define AS_SCRIPTARRAY_THREADS
+#endif
+
 BEGIN_AS_NAMESPACE
 
 struct SArrayBuffer;
 struct SArrayCache;
+class CScriptArrayView;
 
 class CScriptArray
 {
@@ -61,10 +69,30 @@ public:
 	void SortDesc();
 	void SortAsc(asUINT index, asUINT count);
 	void SortDesc(asUINT index, asUINT count);
-	void Sort(asUINT index, asUINT count, bool asc);
+	void Sort(asUINT index, asUINT count, bool asc, bool stable = false);
+	void StableSortAsc();
+	void StableSortDesc();
+	void StableSortAsc(asUINT index, asUINT count);
+	void StableSortDesc(asUINT index, asUINT count);
+	// Sort with a script function declared as bool less(const T&in a, const T&in b)
+	void Sort(asIScriptFunction *less, asUINT index, asUINT count, bool stable = false);
 	void Reverse();
 	int  Find(void *value) const;
 	int  Find(asUINT index, void *value) const;
+	// Returns a new array<uint> with the indices of the equal elements
+	CScriptArray *FindAll(void *value) const;
+	void Fill(void *value);
+
+	// Compute the sum, or find the smallest or largest element. Only arrays of
+	// primitives are supported. Sum stores the result in sum, which must have room
+	// for one element, and returns false on failure. Min and Max return 0 on failure
+	bool        Sum(void *sum) const;
+	const void *Min() const;
+	const void *Max() const;
+
+	// Returns a new arrayview<T> of count elements beginning at start, and then every 
+	// stride element. The count is reduced to the number of available elements
+	CScriptArrayView *View(asUINT start = 0, asUINT count = asUINT(-1), asUINT stride = 1);
 
 	// GC methods
 	int  GetRefCount();
@@ -74,6 +102,8 @@ public:
 	void ReleaseAllHandles(asIScriptEngine *engine);
 
 protected:
+	friend class CScriptArrayView;
+
 	mutable int       refCount;
 	mutable bool      gcFlag;
 	asIObjectType    *objType;
@@ -81,9 +111,10 @@ protected:
 	int               elementSize;
 	int               subTypeId;
 
-	bool  Less(const void *a, const void *b, bool asc, asIScriptContext *ctx);
 	void *GetArrayItemPointer(int index);
-	void *GetDataPointer(void *buffer);
+	bool  CheckSortRange(asUINT index, asUINT count);
+	bool  CheckCmpFunc() const;
+	bool  CheckLessFunc(asIScriptFunction *less) const;
 	void  Copy(void *dst, void *src);
 	void  Precache();
 	bool  CheckMaxSize(asUINT numElements);
@@ -94,10 +125,111 @@ protected:
 	void  Construct(SArrayBuffer *buf, asUINT start, asUINT end);
 	void  Destruct(SArrayBuffer *buf, asUINT start, asUINT end);
 	bool  Equals(const void *a, const void *b, asIScriptContext *ctx, SArrayCache *cache) const;
+
+	// The algorithms work on consecutive elements at data, which is either the 
+	// array's own buffer or the elements of a view that were copied by stride
+	const void *ElementAt(const asBYTE *data, asUINT index) const;
+	int   FindRange(const asBYTE *data, asUINT start, asUINT end, void *value) const;
+	void  FindAllRange(const asBYTE *data, asUINT count, void *value, CScriptArray *indices) const;
+	bool  EqualRanges(const asBYTE *a, const asBYTE *b, asUINT count) const;
+	void  ReverseRange(asBYTE *data, asUINT count);
+	void  FillRange(asBYTE *data, asUINT count, void *value);
+	void  SortRange(asBYTE *data, asUINT count, bool asc, bool stable, asIScriptFunction *less);
+	const void *ReduceRange(const asBYTE *data, asUINT count, int op, void *sum) const;
+};
+
+// A view of a part of an array. The view shares the elements with the array and 
+// keeps the array alive. The view doesn't change size if the array is resized, 
+// instead accessing an element that no longer exists raises an exception
+class CScriptArrayView
+{
+public:
+	CScriptArrayView(CScriptArray *array, asUINT offset, asUINT length, asUINT stride, asIObjectType *ot);
+	virtual ~CScriptArrayView();
+
+	void AddRef() const;
+	void Release() const;
+
+	// Type information
+	asIObjectType *GetViewObjectType() const;
+	int            GetElementTypeId() const;
+
+	// The array and the position of the elements in it
+	CScriptArray  *GetArray() const;
+	asUINT         GetOffset() const;
+	asUINT         GetStride() const;
+
+	asUINT GetSize() const;
+	bool   IsEmpty() const;
+
+	// Get a pointer to an element. Returns 0 if out of bounds
+	void       *At(asUINT index);
+	const void *At(asUINT index) const;
+
+	// Set value of an element
+	void  SetValue(asUINT index, void *value);
+
+	bool operator==(const CScriptArrayView &) const;
+
+	// Returns a new view of the elements of this view
+	CScriptArrayView *View(asUINT start = 0, asUINT count = asUINT(-1), asUINT stride = 1);
+
+	void SortAsc();
+	void SortDesc();
+	void StableSortAsc();
+	void StableSortDesc();
+	// Sort with a script function declared as bool less(const T&in a, const T&in b)
+	void Sort(asIScriptFunction *less, bool stable = false);
+	void Reverse();
+	int  Find(void *value) const;
+	int  Find(asUINT index, void *value) const;
+	// Returns a new array<uint> with the indices of the equal elements
+	CScriptArray *FindAll(void *value) const;
+	void Fill(void *value);
+	bool        Sum(void *sum) const;
+	const void *Min() const;
+	const void *Max() const;
+
+	// GC methods
+	int  GetRefCount();
+	void SetFlag();
+	bool GetFlag();
+	void EnumReferences(asIScriptEngine *engine);
+	void ReleaseAllHandles(asIScriptEngine *engine);
+
+protected:
+	mutable int       refCount;
+	mutable bool      gcFlag;
+	asIObjectType    *objType;
+	CScriptArray     *array;
+	asUINT            offset;
+	asUINT            length;
+	asUINT            stride;
+
+	bool    CheckRange() const;
+	asBYTE *GetElements() const;
+	void    PutElements(asBYTE *data, bool modified) const;
+	void    SortView(bool asc, bool stable, asIScriptFunction *less);
+	const void *Reduce(int op, void *sum) const;
 };
 
 void RegisterScriptArray(asIScriptEngine *engine, bool defaultArray);
 
+// The signature of the callback that executes the tasks of the parallel algorithms on the 
+// application's thread pool. It must call task(n, param) once for each n from 0 to numTasks-1
+// and return only when all of them have completed.
+typedef void (*ARRAYTASKFUNC_t)(asUINT n, void *param);
+typedef void (*ARRAYPARALLELFUNC_t)(ARRAYTASKFUNC_t task, void *param, asUINT numTasks);
+
+// Sorting, fill(), sum(), min(), max(), and find() split the work between up to numThreads
+// threads for arrays of primitives and handles with at least minElements elements. The 
+// default is 1 thread, i.e. all the work is done by the calling thread. If no callback 
+// is given the add-on keeps its own worker threads until the setting is changed or the 
+// engine is released, or if compiled without thread support the work is done by the 
+// calling thread. The setting is stored per engine and must not be changed while scripts
+// are executing in the engine.
+void SetScriptArrayParallelism(asIScriptEngine *engine, asUINT numThreads, asUINT minElements = 100000, ARRAYPARALLELFUNC_t callback = 0);
+
 END_AS_NAMESPACE
 
 #endif
@@ -1,5 +1,6 @@
 #include <assert.h>
 #include <string.h>
+#include <algorithm>
 #include "scriptdictionary.h"
 #include "../scriptarray/scriptarray.h"
 
@@ -7,6 +8,22 @@ BEGIN_AS_NAMESPACE
 
 using namespace std;
 
+// The table grows when more than 3 out of 4 slots are in use
+static const asUINT MIN_SLOTS = 8;
+
+// FNV-1a hash of the key
+static asUINT HashKey(const string &key)
+{
+	asUINT hash = 2166136261u;
+	const char *s = key.c_str();
+	for( size_t n = key.length(); n > 0; n--, s++ )
+	{
+		hash ^= asBYTE(*s);
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
 //--------------------------------------------------------------------------
 // CScriptDictionary implementation
 
@@ -21,6 +38,10 @@ CScriptDictionary::CScriptDictionary(asIScriptEngine *engine)
 	// engine will hold a pointer to the object. 
     this->engine = engine;
 
+#if AS_USE_DICTIONARY_KEYCACHE == 1
+	memset(keyCache, 0, sizeof(keyCache));
+#endif
+
 	// Notify the garbage collector of this object
 	// TODO: The type id should be cached
 	engine->NotifyGarbageCollectorOfNewObject(this, engine->GetObjectTypeByName("dictionary"));
@@ -65,12 +86,11 @@ bool CScriptDictionary::GetGCFlag()
 void CScriptDictionary::EnumReferences(asIScriptEngine *engine)
 {
 	// Call the gc enum callback for each of the objects
-    map<string, valueStruct>::iterator it;
-    for( it = dict.begin(); it != dict.end(); it++ )
-    {
-		if( it->second.typeId & asTYPEID_MASK_OBJECT )
-			engine->GCEnumCallback(it->second.valueObj);
-    }
+	for( asUINT n = 0; n < entries.size(); n++ )
+	{
+		if( entries[n].value.typeId & asTYPEID_MASK_OBJECT )
+			engine->GCEnumCallback(entries[n].value.valueObj);
+	}
 }
 
 void CScriptDictionary::ReleaseAllReferences(asIScriptEngine * /*engine*/)
@@ -86,16 +106,17 @@ CScriptDictionary &CScriptDictionary::operator =(const CScriptDictionary &other)
 	DeleteAll();
 
 	// Do a shallow copy of the dictionary
-    map<string, valueStruct>::const_iterator it;
-    for( it = other.dict.begin(); it != other.dict.end(); it++ )
-    {
-		if( it->second.typeId & asTYPEID_OBJHANDLE )
-			Set(it->first, (void*)&it->second.valueObj, it->second.typeId);
-		else if( it->second.typeId & asTYPEID_MASK_OBJECT )
-			Set(it->first, (void*)it->second.valueObj, it->second.typeId);
+	Reserve(other.GetSize());
+	for( asUINT n = 0; n < other.entries.size(); n++ )
+	{
+		const entryStruct &entry = other.entries[n];
+		if( entry.value.typeId & asTYPEID_OBJHANDLE )
+			Set(entry.key, (void*)&entry.value.valueObj, entry.value.typeId);
+		else if( entry.value.typeId & asTYPEID_MASK_OBJECT )
+			Set(entry.key, (void*)entry.value.valueObj, entry.value.typeId);
 		else
-			Set(it->first, (void*)&it->second.valueInt, it->second.typeId);
-    }
+			Set(entry.key, (void*)&entry.value.valueInt, entry.value.typeId);
+	}
 
     return *this;
 }
@@ -123,19 +144,27 @@ void CScriptDictionary::Set(const string &key, void *value, int typeId)
 		memcpy(&valStruct.valueInt, value, size);
 	}
 
-    map<string, valueStruct>::iterator it;
-    it = dict.find(key);
-    if( it != dict.end() )
-    {
-        FreeValue(it->second);
+	asUINT hash;
+	int index = FindEntry(key, hash);
+	if( index >= 0 )
+	{
+		FreeValue(entries[index].value);
 
-        // Insert the new value
-        it->second = valStruct;
-    }
-    else
-    {
-        dict.insert(map<string, valueStruct>::value_type(key, valStruct));
-    }
+		// Insert the new value
+		entries[index].value = valStruct;
+	}
+	else
+	{
+		if( (entries.size() + 1) * 4 > slots.size() * 3 )
+			Rehash(slots.size() ? asUINT(slots.size()) * 2 : MIN_SLOTS);
+
+		entries.push_back(entryStruct());
+		entryStruct &entry = entries.back();
+		entry.key   = key;
+		entry.hash  = hash;
+		entry.value = valStruct;
+		InsertSlot(hash, asUINT(entries.size()) - 1);
+	}
 }
 
 // This overloaded method is implemented so that all integer and
@@ -160,20 +189,22 @@ void CScriptDictionary::Set(const string &key, double &value)
 // Returns true if the value was successfully retrieved
 bool CScriptDictionary::Get(const string &key, void *value, int typeId) const
 {
-    map<string, valueStruct>::const_iterator it;
-    it = dict.find(key);
-    if( it != dict.end() )
-    {
-        // Return the value
+	asUINT hash;
+	int index = FindEntry(key, hash);
+	if( index >= 0 )
+	{
+		const valueStruct *val = &entries[index].value;
+
+		// Return the value
 		if( typeId & asTYPEID_OBJHANDLE )
 		{
 			// A handle can be retrieved if the stored type is a handle of same or compatible type
 			// or if the stored type is an object that implements the interface that the handle refer to.
-			if( (it->second.typeId & asTYPEID_MASK_OBJECT) && 
-				engine->IsHandleCompatibleWithObject(it->second.valueObj, it->second.typeId, typeId) )
+			if( (val->typeId & asTYPEID_MASK_OBJECT) && 
+				engine->IsHandleCompatibleWithObject(val->valueObj, val->typeId, typeId) )
 			{
-				engine->AddRefScriptObject(it->second.valueObj, it->second.typeId);
-				*(void**)value = it->second.valueObj;
+				engine->AddRefScriptObject(val->valueObj, val->typeId);
+				*(void**)value = val->valueObj;
 
 				return true;
 			}
@@ -182,35 +213,35 @@ bool CScriptDictionary::Get(const string &key, void *value, int typeId) const
 		{
 			// Verify that the copy can be made
 			bool isCompatible = false;
-			if( it->second.typeId == typeId )
+			if( val->typeId == typeId )
 				isCompatible = true;
 
 			// Copy the object into the given reference
 			if( isCompatible )
 			{
-				engine->AssignScriptObject(value, it->second.valueObj, typeId);
+				engine->AssignScriptObject(value, val->valueObj, typeId);
 
 				return true;
 			}
 		}
 		else
 		{
-			if( it->second.typeId == typeId )
+			if( val->typeId == typeId )
 			{
 				int size = engine->GetSizeOfPrimitiveType(typeId);
-				memcpy(value, &it->second.valueInt, size);
+				memcpy(value, &val->valueInt, size);
 				return true;
 			}
 
 			// We know all numbers are stored as either int64 or double, since we register overloaded functions for those
-			if( it->second.typeId == asTYPEID_INT64 && typeId == asTYPEID_DOUBLE )
+			if( val->typeId == asTYPEID_INT64 && typeId == asTYPEID_DOUBLE )
 			{
-				*(double*)value = double(it->second.valueInt);
+				*(double*)value = double(val->valueInt);
 				return true;
 			}
-			else if( it->second.typeId == asTYPEID_DOUBLE && typeId == asTYPEID_INT64 )
+			else if( val->typeId == asTYPEID_DOUBLE && typeId == asTYPEID_INT64 )
 			{
-				*(asINT64*)value = asINT64(it->second.valueFlt);
+				*(asINT64*)value = asINT64(val->valueFlt);
 				return true;
 			}
 		}
@@ -235,17 +266,16 @@ bool CScriptDictionary::Get(const string &key, double &value) const
 
 bool CScriptDictionary::Exists(const string &key) const
 {
-    map<string, valueStruct>::const_iterator it;
-    it = dict.find(key);
-    if( it != dict.end() )
-        return true;
+	asUINT hash;
+	if( FindEntry(key, hash) >= 0 )
+		return true;
 
-    return false;
+	return false;
 }
 
 bool CScriptDictionary::IsEmpty() const
 {
-	if( dict.size() == 0 )
+	if( entries.size() == 0 )
 		return true;
 
 	return false;
@@ -253,27 +283,146 @@ bool CScriptDictionary::IsEmpty() const
 
 asUINT CScriptDictionary::GetSize() const
 {
-	return asUINT(dict.size());
+	return asUINT(entries.size());
+}
+
+void CScriptDictionary::Reserve(asUINT numKeys)
+{
+	entries.reserve(numKeys);
+
+	asUINT numSlots = slots.size() ? asUINT(slots.size()) : MIN_SLOTS;
+	while( numKeys * 4 > numSlots * 3 )
+		numSlots *= 2;
+	if( numSlots != slots.size() )
+		Rehash(numSlots);
 }
 
 void CScriptDictionary::Delete(const string &key)
 {
-    map<string, valueStruct>::iterator it;
-    it = dict.find(key);
-    if( it != dict.end() )
-    {
-        FreeValue(it->second);
-        dict.erase(it);
-    }
+	asUINT hash;
+	int index = FindEntry(key, hash);
+	if( index < 0 )
+		return;
+
+	FreeValue(entries[index].value);
+	RemoveSlot(FindSlot(hash, index));
+
+	// Move the last entry into the place of the removed one to keep the entries consecutive
+	asUINT last = asUINT(entries.size()) - 1;
+	if( asUINT(index) != last )
+	{
+		slots[FindSlot(entries[last].hash, last)] = index + 1;
+		entries[index].key.swap(entries[last].key);
+		entries[index].hash  = entries[last].hash;
+		entries[index].value = entries[last].value;
+	}
+	entries.pop_back();
 }
 
 void CScriptDictionary::DeleteAll()
 {
-    map<string, valueStruct>::iterator it;
-    for( it = dict.begin(); it != dict.end(); it++ )
-        FreeValue(it->second);
+	for( asUINT n = 0; n < entries.size(); n++ )
+		FreeValue(entries[n].value);
+
+	// Keep the memory for the table, as the dictionary is likely to be filled again
+	entries.clear();
+	for( asUINT n = 0; n < slots.size(); n++ )
+		slots[n] = 0;
+}
+
+// Returns the index of the entry with the key, or -1 if there is none. The 
+// hash of the key is returned too, so the caller can add the key without 
+// computing it again
+int CScriptDictionary::FindEntry(const string &key, asUINT &hash) const
+{
+#if AS_USE_DICTIONARY_KEYCACHE == 1
+	// The cached entry is only used if it still holds the same key, since the 
+	// string may have been modified or the entries may have been moved
+	keyCacheStruct &cache = keyCache[((asPWORD(&key) >> 4) ^ (asPWORD(&key) >> 10)) & (KEYCACHE_SIZE-1)];
+	if( cache.key == &key && cache.entry < entries.size() && entries[cache.entry].key == key )
+	{
+		hash = entries[cache.entry].hash;
+		return int(cache.entry);
+	}
+#endif
+
+	hash = HashKey(key);
+	if( slots.size() == 0 )
+		return -1;
+
+	asUINT mask = asUINT(slots.size()) - 1;
+	for( asUINT n = hash & mask; slots[n]; n = (n + 1) & mask )
+	{
+		const entryStruct &entry = entries[slots[n] - 1];
+		if( entry.hash == hash && entry.key == key )
+		{
+#if AS_USE_DICTIONARY_KEYCACHE == 1
+			cache.key   = &key;
+			cache.entry = slots[n] - 1;
+#endif
+			return int(slots[n] - 1);
+		}
+	}
+
+	return -1;
+}
+
+// Returns the slot that refers to the entry
+int CScriptDictionary::FindSlot(asUINT hash, asUINT entry) const
+{
+	asUINT mask = asUINT(slots.size()) - 1;
+	asUINT n = hash & mask;
+	while( slots[n] != entry + 1 )
+		n = (n + 1) & mask;
+
+	return int(n);
+}
+
+void CScriptDictionary::InsertSlot(asUINT hash, asUINT entry)
+{
+	// There is always a free slot, since the table is never more than 3/4 full
+	asUINT mask = asUINT(slots.size()) - 1;
+	asUINT n = hash & mask;
+	while( slots[n] )
+		n = (n + 1) & mask;
+
+	slots[n] = entry + 1;
+}
+
+void CScriptDictionary::RemoveSlot(asUINT slot)
+{
+	// Move back the following entries in the same cluster that can't be 
+	// found anymore when the slot is freed. Entries are only moved towards 
+	// the slot where their probing starts, so no tombstones are needed
+	asUINT mask = asUINT(slots.size()) - 1;
+	asUINT n = slot;
+	for(;;)
+	{
+		slots[n] = 0;
+		asUINT m = n;
+		for(;;)
+		{
+			m = (m + 1) & mask;
+			if( slots[m] == 0 )
+				return;
+
+			// The entry can be moved unless its first slot is cyclically in (n, m]
+			asUINT first = entries[slots[m] - 1].hash & mask;
+			if( n <= m ? (n < first && first <= m) : (n < first || first <= m) )
+				continue;
+
+			slots[n] = slots[m];
+			n = m;
+			break;
+		}
+	}
+}
 
-    dict.clear();
+void CScriptDictionary::Rehash(asUINT numSlots)
+{
+	slots.assign(numSlots, 0);
+	for( asUINT n = 0; n < entries.size(); n++ )
+		InsertSlot(entries[n].hash, n);
 }
 
 void CScriptDictionary::FreeValue(valueStruct &value)
@@ -290,6 +439,11 @@ void CScriptDictionary::FreeValue(valueStruct &value)
     // For primitives, there's nothing to do
 }
 
+static bool KeyLess(const string *a, const string *b)
+{
+	return *a < *b;
+}
+
 CScriptArray* CScriptDictionary::GetKeys() const
 {
 	// TODO: optimize: The string array type should only be determined once. 
@@ -300,15 +454,18 @@ CScriptArray* CScriptDictionary::GetKeys() const
 	int stringArrayType = engine->GetTypeIdByDecl("array<string>");
 	asIObjectType *ot = engine->GetObjectTypeById(stringArrayType);
 
+	// The keys are returned in alphabetical order, just as when the 
+	// dictionary was a map, rather than in the order of the entries
+	vector<const string*> keys(entries.size());
+	asUINT n;
+	for( n = 0; n < entries.size(); n++ )
+		keys[n] = &entries[n].key;
+	std::sort(keys.begin(), keys.end(), KeyLess);
+
 	// Create the array object
-	CScriptArray *array = new CScriptArray(asUINT(dict.size()), ot);
-	long current = -1;
-	std::map<string, valueStruct>::const_iterator it;
-	for( it = dict.begin(); it != dict.end(); it++ )
-	{
-		current++;
-		*(string*)array->At(current) = it->first;
-	}
+	CScriptArray *array = new CScriptArray(asUINT(keys.size()), ot);
+	for( n = 0; n < keys.size(); n++ )
+		*(string*)array->At(n) = *keys[n];
 
 	return array;
 }
@@ -399,6 +556,25 @@ void ScriptDictionaryExists_Generic(asIScriptGeneric *gen)
     *(bool*)gen->GetAddressOfReturnLocation() = ret;
 }
 
+void ScriptDictionaryIsEmpty_Generic(asIScriptGeneric *gen)
+{
+    CScriptDictionary *dict = (CScriptDictionary*)gen->GetObject();
+    *(bool*)gen->GetAddressOfReturnLocation() = dict->IsEmpty();
+}
+
+void ScriptDictionaryGetSize_Generic(asIScriptGeneric *gen)
+{
+    CScriptDictionary *dict = (CScriptDictionary*)gen->GetObject();
+    *(asUINT*)gen->GetAddressOfReturnLocation() = dict->GetSize();
+}
+
+void ScriptDictionaryReserve_Generic(asIScriptGeneric *gen)
+{
+    CScriptDictionary *dict = (CScriptDictionary*)gen->GetObject();
+    asUINT numKeys = gen->GetArgDWord(0);
+    dict->Reserve(numKeys);
+}
+
 void ScriptDictionaryDelete_Generic(asIScriptGeneric *gen)
 {
     CScriptDictionary *dict = (CScriptDictionary*)gen->GetObject();
@@ -485,6 +661,7 @@ void RegisterScriptDictionary_Native(asIScriptEngine *engine)
 	r = engine->RegisterObjectMethod("dictionary", "bool exists(const string &in) const", asMETHOD(CScriptDictionary,Exists), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("dictionary", "bool isEmpty() const", asMETHOD(CScriptDictionary, IsEmpty), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("dictionary", "uint getSize() const", asMETHOD(CScriptDictionary, GetSize), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("dictionary", "void reserve(uint)", asMETHOD(CScriptDictionary, Reserve), asCALL_THISCALL); assert( r >= 0 );
     r = engine->RegisterObjectMethod("dictionary", "void delete(const string &in)", asMETHOD(CScriptDictionary,Delete), asCALL_THISCALL); assert( r >= 0 );
     r = engine->RegisterObjectMethod("dictionary", "void deleteAll()", asMETHOD(CScriptDictionary,DeleteAll), asCALL_THISCALL); assert( r >= 0 );
 
@@ -530,6 +707,9 @@ void RegisterScriptDictionary_Generic(asIScriptEngine *engine)
     r = engine->RegisterObjectMethod("dictionary", "bool get(const string &in, double&out) const", asFUNCTION(ScriptDictionaryGetFlt_Generic), asCALL_GENERIC); assert( r >= 0 );
 
 	r = engine->RegisterObjectMethod("dictionary", "bool exists(const string &in) const", asFUNCTION(ScriptDictionaryExists_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("dictionary", "bool isEmpty() const", asFUNCTION(ScriptDictionaryIsEmpty_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("dictionary", "uint getSize() const", asFUNCTION(ScriptDictionaryGetSize_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("dictionary", "void reserve(uint)", asFUNCTION(ScriptDictionaryReserve_Generic), asCALL_GENERIC); assert( r >= 0 );
     r = engine->RegisterObjectMethod("dictionary", "void delete(const string &in)", asFUNCTION(ScriptDictionaryDelete_Generic), asCALL_GENERIC); assert( r >= 0 );
     r = engine->RegisterObjectMethod("dictionary", "void deleteAll()", asFUNCTION(ScriptDictionaryDeleteAll_Generic), asCALL_GENERIC); assert( r >= 0 );
 
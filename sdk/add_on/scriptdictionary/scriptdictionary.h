@@ -17,7 +17,7 @@
 #pragma warning (disable:4786)
 #endif
 
-#include <map>
+#include <vector>
 
 // Sometimes it may be desired to use the same method names as used by C++ STL.
 // This may for example reduce time when converting code from script to C++ or
@@ -30,6 +30,20 @@
 #define AS_USE_STLNAMES 0
 #endif
 
+// The dictionary can remember where it found the most recently used keys by the 
+// address of the key string. The string add-on keeps the string constants in 
+// a pool, so a script that uses literals as keys will find the entries without
+// computing the hash of the key again. The cache is updated by the const methods
+// too, so it is off by default as the same dictionary can then not be read by
+// multiple threads at the same time.
+//
+//  0 = off
+//  1 = on
+
+#ifndef AS_USE_DICTIONARY_KEYCACHE
+#define AS_USE_DICTIONARY_KEYCACHE 0
+#endif
+
 
 BEGIN_AS_NAMESPACE
 
@@ -62,6 +76,9 @@ public:
 	bool IsEmpty() const;
 	asUINT GetSize() const;
 
+	// Allocates memory for numKeys keys, so they can be added without growing the table
+	void Reserve(asUINT numKeys);
+
     // Deletes the key
     void Delete(const std::string &key);
 
@@ -90,20 +107,50 @@ protected:
         };
         int   typeId;
     };
-    
+
+	// The entries are kept consecutively, so they can be enumerated quickly. The 
+	// hash of the key is computed once when the entry is added
+	struct entryStruct
+	{
+		std::string key;
+		asUINT      hash;
+		valueStruct value;
+	};
+
+#if AS_USE_DICTIONARY_KEYCACHE == 1
+	struct keyCacheStruct
+	{
+		const std::string *key;
+		asUINT             entry;
+	};
+	enum { KEYCACHE_SIZE = 8 };
+#endif
+
 	// We don't want anyone to call the destructor directly, it should be called through the Release method
 	virtual ~CScriptDictionary();
 
 	// Helper methods
     void FreeValue(valueStruct &value);
+	int  FindEntry(const std::string &key, asUINT &hash) const;
+	int  FindSlot(asUINT hash, asUINT entry) const;
+	void InsertSlot(asUINT hash, asUINT entry);
+	void RemoveSlot(asUINT slot);
+	void Rehash(asUINT numSlots);
 	
 	// Our properties
     asIScriptEngine *engine;
     mutable int refCount;
 	mutable bool gcFlag;
 
-	// TODO: optimize: Use C++11 std::unordered_map instead
-    std::map<std::string, valueStruct> dict;
+	// The keys are found with an open addressing hash table with linear probing. 
+	// Each slot holds the index of the entry plus 1, or 0 if the slot is free. 
+	// The number of slots is always a power of 2
+	std::vector<entryStruct> entries;
+	std::vector<asUINT>      slots;
+
+#if AS_USE_DICTIONARY_KEYCACHE == 1
+	mutable keyCacheStruct   keyCache[KEYCACHE_SIZE];
+#endif
 };
 
 // This function will determine the configuration of the engine
@@ -12,10 +12,53 @@
 #endif
 #endif
 
+// Determine how the "rm" mode maps the file into memory. Platforms 
+// that are not listed here will read the file through the buffer instead
+#if defined(_WIN32) && !defined(_WIN32_WCE)
+#define AS_SCRIPTFILE_MMAP_WIN32
+#include <windows.h>
+#include <io.h>     // For _get_osfhandle
+#ifdef GetObject
+#undef GetObject
+#endif
+#elif defined(__unix__) || defined(__APPLE__)
+#define AS_SCRIPTFILE_MMAP_POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 using namespace std;
 
 BEGIN_AS_NAMESPACE
 
+// The positions are 64bit so that files larger than 2GB can be handled
+// on the platforms where long is only 32bit
+static asINT64 FileTell(FILE *file)
+{
+#if _MSC_VER >= 1400 && !defined(__S3E__)
+	return _ftelli64(file);
+#elif defined(__MINGW32__)
+	return ftello64(file);
+#elif defined(AS_SCRIPTFILE_MMAP_POSIX)
+	return ftello(file);
+#else
+	return ftell(file);
+#endif
+}
+
+static int FileSeek(FILE *file, asINT64 offset, int origin)
+{
+#if _MSC_VER >= 1400 && !defined(__S3E__)
+	return _fseeki64(file, offset, origin);
+#elif defined(__MINGW32__)
+	return fseeko64(file, offset, origin);
+#elif defined(AS_SCRIPTFILE_MMAP_POSIX)
+	return fseeko(file, off_t(offset), origin);
+#else
+	return fseek(file, long(offset), origin);
+#endif
+}
+
 CScriptFile *ScriptFile_Factory()
 {
     return new CScriptFile();
@@ -57,8 +100,8 @@ void ScriptFile_Close_Generic(asIScriptGeneric *gen)
 void ScriptFile_GetSize_Generic(asIScriptGeneric *gen)
 {
 	CScriptFile *file = (CScriptFile*)gen->GetObject();
-	int r = file->GetSize();
-	gen->SetReturnDWord(r);
+	asINT64 r = file->GetSize();
+	gen->SetReturnQWord(r);
 }
 
 void ScriptFile_ReadString_Generic(asIScriptGeneric *gen)
@@ -104,6 +147,25 @@ void ScriptFile_ReadDouble_Generic(asIScriptGeneric *gen)
 	*(double*)gen->GetAddressOfReturnLocation() = file->ReadDouble();
 }
 
+void ScriptFile_ReadToEnd_Generic(asIScriptGeneric *gen)
+{
+	CScriptFile *file = (CScriptFile*)gen->GetObject();
+	std::string *str = (std::string*)gen->GetArgAddress(0);
+	gen->SetReturnQWord(file->ReadToEnd(*str));
+}
+
+void ScriptFile_ReadNextLine_Generic(asIScriptGeneric *gen)
+{
+	CScriptFile *file = (CScriptFile*)gen->GetObject();
+	gen->SetReturnByte(file->ReadNextLine());
+}
+
+void ScriptFile_GetLine_Generic(asIScriptGeneric *gen)
+{
+	CScriptFile *file = (CScriptFile*)gen->GetObject();
+	gen->SetReturnAddress(const_cast<std::string*>(&file->GetLine()));
+}
+
 void ScriptFile_WriteString_Generic(asIScriptGeneric *gen)
 {
 	CScriptFile *file = (CScriptFile*)gen->GetObject();
@@ -151,20 +213,20 @@ void ScriptFile_IsEOF_Generic(asIScriptGeneric *gen)
 void ScriptFile_GetPos_Generic(asIScriptGeneric *gen)
 {
 	CScriptFile *file = (CScriptFile*)gen->GetObject();
-	gen->SetReturnDWord(file->GetPos());
+	gen->SetReturnQWord(file->GetPos());
 }
 
 void ScriptFile_SetPos_Generic(asIScriptGeneric *gen)
 {
 	CScriptFile *file = (CScriptFile*)gen->GetObject();
-	int pos = (int)gen->GetArgDWord(0);
+	asINT64 pos = (asINT64)gen->GetArgQWord(0);
 	gen->SetReturnDWord(file->SetPos(pos));
 }
 
 void ScriptFile_MovePos_Generic(asIScriptGeneric *gen)
 {
 	CScriptFile *file = (CScriptFile*)gen->GetObject();
-	int delta = (int)gen->GetArgDWord(0);
+	asINT64 delta = (asINT64)gen->GetArgQWord(0);
 	gen->SetReturnDWord(file->MovePos(delta));
 }
 
@@ -179,7 +241,7 @@ void RegisterScriptFile_Native(asIScriptEngine *engine)
 
     r = engine->RegisterObjectMethod("file", "int open(const string &in, const string &in)", asMETHOD(CScriptFile,Open), asCALL_THISCALL); assert( r >= 0 );
     r = engine->RegisterObjectMethod("file", "int close()", asMETHOD(CScriptFile,Close), asCALL_THISCALL); assert( r >= 0 );
-	r = engine->RegisterObjectMethod("file", "int getSize() const", asMETHOD(CScriptFile,GetSize), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "int64 getSize() const", asMETHOD(CScriptFile,GetSize), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "bool isEndOfFile() const", asMETHOD(CScriptFile,IsEOF), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "int readString(uint, string &out)", asMETHOD(CScriptFile,ReadString), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "int readLine(string &out)", asMETHOD(CScriptFile,ReadLine), asCALL_THISCALL); assert( r >= 0 );
@@ -187,6 +249,9 @@ void RegisterScriptFile_Native(asIScriptEngine *engine)
 	r = engine->RegisterObjectMethod("file", "uint64 readUInt(uint)", asMETHOD(CScriptFile,ReadUInt), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "float readFloat()", asMETHOD(CScriptFile,ReadFloat), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "double readDouble()", asMETHOD(CScriptFile,ReadDouble), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "int64 readToEnd(string &out)", asMETHOD(CScriptFile,ReadToEnd), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "bool readNextLine()", asMETHOD(CScriptFile,ReadNextLine), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "const string &get_line() const", asMETHOD(CScriptFile,GetLine), asCALL_THISCALL); assert( r >= 0 );
 #if AS_WRITE_OPS == 1
 	r = engine->RegisterObjectMethod("file", "int writeString(const string &in)", asMETHOD(CScriptFile,WriteString), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "int writeInt(int64, uint)", asMETHOD(CScriptFile,WriteInt), asCALL_THISCALL); assert( r >= 0 );
@@ -194,9 +259,9 @@ void RegisterScriptFile_Native(asIScriptEngine *engine)
 	r = engine->RegisterObjectMethod("file", "int writeFloat(float)", asMETHOD(CScriptFile,WriteFloat), asCALL_THISCALL); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "int writeDouble(double)", asMETHOD(CScriptFile,WriteDouble), asCALL_THISCALL); assert( r >= 0 );
 #endif
-	r = engine->RegisterObjectMethod("file", "int getPos() const", asMETHOD(CScriptFile,GetPos), asCALL_THISCALL); assert( r >= 0 );
-	r = engine->RegisterObjectMethod("file", "int setPos(int)", asMETHOD(CScriptFile,SetPos), asCALL_THISCALL); assert( r >= 0 );
-	r = engine->RegisterObjectMethod("file", "int movePos(int)", asMETHOD(CScriptFile,MovePos), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "int64 getPos() const", asMETHOD(CScriptFile,GetPos), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "int setPos(int64)", asMETHOD(CScriptFile,SetPos), asCALL_THISCALL); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "int movePos(int64)", asMETHOD(CScriptFile,MovePos), asCALL_THISCALL); assert( r >= 0 );
 
 	r = engine->RegisterObjectProperty("file", "bool mostSignificantByteFirst", asOFFSET(CScriptFile, mostSignificantByteFirst)); assert( r >= 0 );
 }
@@ -212,7 +277,7 @@ void RegisterScriptFile_Generic(asIScriptEngine *engine)
 
     r = engine->RegisterObjectMethod("file", "int open(const string &in, const string &in)", asFUNCTION(ScriptFile_Open_Generic), asCALL_GENERIC); assert( r >= 0 );
     r = engine->RegisterObjectMethod("file", "int close()", asFUNCTION(ScriptFile_Close_Generic), asCALL_GENERIC); assert( r >= 0 );
-	r = engine->RegisterObjectMethod("file", "int getSize() const", asFUNCTION(ScriptFile_GetSize_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "int64 getSize() const", asFUNCTION(ScriptFile_GetSize_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "bool isEndOfFile() const", asFUNCTION(ScriptFile_IsEOF_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "int readString(uint, string &out)", asFUNCTION(ScriptFile_ReadString_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "int readLine(string &out)", asFUNCTION(ScriptFile_ReadLine_Generic), asCALL_GENERIC); assert( r >= 0 );
@@ -220,6 +285,9 @@ void RegisterScriptFile_Generic(asIScriptEngine *engine)
 	r = engine->RegisterObjectMethod("file", "uint64 readUInt(uint)", asFUNCTION(ScriptFile_ReadUInt_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "float readFloat()", asFUNCTION(ScriptFile_ReadFloat_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "double readDouble()", asFUNCTION(ScriptFile_ReadDouble_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "int64 readToEnd(string &out)", asFUNCTION(ScriptFile_ReadToEnd_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "bool readNextLine()", asFUNCTION(ScriptFile_ReadNextLine_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "const string &get_line() const", asFUNCTION(ScriptFile_GetLine_Generic), asCALL_GENERIC); assert( r >= 0 );
 #if AS_WRITE_OPS == 1
 	r = engine->RegisterObjectMethod("file", "int writeString(const string &in)", asFUNCTION(ScriptFile_WriteString_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "int writeInt(int64, uint)", asFUNCTION(ScriptFile_WriteInt_Generic), asCALL_GENERIC); assert( r >= 0 );
@@ -227,9 +295,9 @@ void RegisterScriptFile_Generic(asIScriptEngine *engine)
 	r = engine->RegisterObjectMethod("file", "int writeFloat(float)", asFUNCTION(ScriptFile_WriteFloat_Generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterObjectMethod("file", "int writeDouble(double)", asFUNCTION(ScriptFile_WriteDouble_Generic), asCALL_GENERIC); assert( r >= 0 );
 #endif
-	r = engine->RegisterObjectMethod("file", "int getPos() const", asFUNCTION(ScriptFile_GetPos_Generic), asCALL_GENERIC); assert( r >= 0 );
-	r = engine->RegisterObjectMethod("file", "int setPos(int)", asFUNCTION(ScriptFile_SetPos_Generic), asCALL_GENERIC); assert( r >= 0 );
-	r = engine->RegisterObjectMethod("file", "int movePos(int)", asFUNCTION(ScriptFile_MovePos_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "int64 getPos() const", asFUNCTION(ScriptFile_GetPos_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "int setPos(int64)", asFUNCTION(ScriptFile_SetPos_Generic), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("file", "int movePos(int64)", asFUNCTION(ScriptFile_MovePos_Generic), asCALL_GENERIC); assert( r >= 0 );
 
 	r = engine->RegisterObjectProperty("file", "bool mostSignificantByteFirst", asOFFSET(CScriptFile, mostSignificantByteFirst)); assert( r >= 0 );
 }
@@ -247,6 +315,13 @@ CScriptFile::CScriptFile()
     refCount = 1;
     file = 0;
 	mostSignificantByteFirst = false;
+	readMode = READ_STDIO;
+	buffer = 0;
+	bufferLength = 0;
+	bufferPos = 0;
+	bufferOffset = 0;
+	reachedEOF = false;
+	mapping = 0;
 }
 
 CScriptFile::~CScriptFile()
@@ -275,10 +350,16 @@ int CScriptFile::Open(const std::string &filename, const std::string &mode)
 
     // Validate the mode
 	string m;
+	EReadMode newReadMode = READ_STDIO;
+	if( mode == "rl" || mode == "rm" )
+	{
+		m = "r";
+		newReadMode = mode == "rl" ? READ_BUFFERED : READ_MAPPED;
+	}
 #if AS_WRITE_OPS == 1
-    if( mode != "r" && mode != "w" && mode != "a" )
+    else if( mode != "r" && mode != "w" && mode != "a" )
 #else
-	if( mode != "r" )
+	else if( mode != "r" )
 #endif
         return -1;
 	else
@@ -326,58 +407,160 @@ int CScriptFile::Open(const std::string &filename, const std::string &mode)
     if( file == 0 )
         return -1;
 
+	bufferLength = 0;
+	bufferPos = 0;
+	bufferOffset = 0;
+	reachedEOF = false;
+
+	// Empty files and files that are too large for the address space cannot be mapped
+	if( newReadMode == READ_MAPPED && !MapFile() )
+		newReadMode = READ_BUFFERED;
+	if( newReadMode == READ_BUFFERED )
+		buffer = new char[AS_SCRIPTFILE_BUFFER_SIZE];
+	readMode = newReadMode;
+
     return 0;
 }
 
+bool CScriptFile::MapFile()
+{
+#if defined(AS_SCRIPTFILE_MMAP_POSIX)
+	struct stat st;
+	int fd = fileno(file);
+	if( fstat(fd, &st) != 0 || st.st_size <= 0 || asQWORD(st.st_size) > asQWORD(size_t(-1)) )
+		return false;
+
+	void *view = mmap(0, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	if( view == MAP_FAILED )
+		return false;
+
+	// Tell the system that the file will be read from start to end
+	madvise(view, size_t(st.st_size), MADV_SEQUENTIAL);
+
+	buffer = (char*)view;
+	bufferLength = size_t(st.st_size);
+	return true;
+#elif defined(AS_SCRIPTFILE_MMAP_WIN32)
+	HANDLE handle = (HANDLE)_get_osfhandle(_fileno(file));
+	LARGE_INTEGER size;
+	if( !GetFileSizeEx(handle, &size) || size.QuadPart <= 0 || asQWORD(size.QuadPart) > asQWORD(size_t(-1)) )
+		return false;
+
+	HANDLE map = CreateFileMapping(handle, 0, PAGE_READONLY, 0, 0, 0);
+	if( map == 0 )
+		return false;
+
+	void *view = MapViewOfFile(map, FILE_MAP_READ, 0, 0, 0);
+	if( view == 0 )
+	{
+		CloseHandle(map);
+		return false;
+	}
+
+	mapping = map;
+	buffer = (char*)view;
+	bufferLength = size_t(size.QuadPart);
+	return true;
+#else
+	return false;
+#endif
+}
+
 int CScriptFile::Close()
 {
     if( file == 0 )
         return -1;
 
+	if( readMode == READ_MAPPED )
+	{
+#if defined(AS_SCRIPTFILE_MMAP_POSIX)
+		munmap(buffer, bufferLength);
+#elif defined(AS_SCRIPTFILE_MMAP_WIN32)
+		UnmapViewOfFile(buffer);
+		CloseHandle((HANDLE)mapping);
+#endif
+	}
+	else if( readMode == READ_BUFFERED )
+		delete[] buffer;
+
+	readMode = READ_STDIO;
+	buffer = 0;
+	mapping = 0;
+
     fclose(file);
     file = 0;
 
     return 0;
 }
 
-int CScriptFile::GetSize() const
+asINT64 CScriptFile::GetSize() const
 {
 	if( file == 0 )
 		return -1;
 
-	int pos = ftell(file);
-	fseek(file, 0, SEEK_END);
-	int size = ftell(file);
-	fseek(file, pos, SEEK_SET);
+	asINT64 pos = FileTell(file);
+	FileSeek(file, 0, SEEK_END);
+	asINT64 size = FileTell(file);
+	FileSeek(file, pos, SEEK_SET);
 
 	return size;
 }
 
-int CScriptFile::GetPos() const
+asINT64 CScriptFile::GetPos() const
 {
 	if( file == 0 )
 		return -1;
 
-	return ftell(file);
+	if( readMode != READ_STDIO )
+		return bufferOffset + asINT64(bufferPos);
+
+	return FileTell(file);
 }
  
-int CScriptFile::SetPos(int pos)
+int CScriptFile::SetPos(asINT64 pos)
 {
 	if( file == 0 )
 		return -1;
 
-	int r = fseek(file, pos, SEEK_SET);
+	if( readMode != READ_STDIO )
+	{
+		if( pos < 0 )
+			return -1;
+
+		reachedEOF = false;
+
+		// The mapped file and a position within the current buffer doesn't require a seek
+		if( readMode == READ_MAPPED ||
+			(pos >= bufferOffset && asQWORD(pos - bufferOffset) <= bufferLength) )
+		{
+			bufferPos = size_t(pos - bufferOffset);
+			return 0;
+		}
+
+		if( FileSeek(file, pos, SEEK_SET) )
+			return -1;
+
+		bufferOffset = pos;
+		bufferLength = 0;
+		bufferPos = 0;
+		return 0;
+	}
+
+	int r = FileSeek(file, pos, SEEK_SET);
 
 	// Return -1 on error
 	return r ? -1 : 0;
 }
 
-int CScriptFile::MovePos(int delta)
+int CScriptFile::MovePos(asINT64 delta)
 {
 	if( file == 0 )
 		return -1;
 
-	int r = fseek(file, delta, SEEK_CUR);
+	if( readMode != READ_STDIO )
+		return SetPos(GetPos() + delta);
+
+	int r = FileSeek(file, delta, SEEK_CUR);
 
 	// Return -1 on error
 	return r ? -1 : 0;
@@ -390,12 +573,89 @@ int CScriptFile::ReadString(unsigned int length, std::string &str)
 
 	// Read the string
 	str.resize(length);
-	int size = (int)fread(&str[0], 1, length, file); 
+	int size = (int)ReadBytes(&str[0], length); 
 	str.resize(size);
 
 	return size;
 }
 
+// Refills the buffer with the next part of the file when all of it has been read
+size_t CScriptFile::FillBuffer()
+{
+	bufferOffset += asINT64(bufferLength);
+	bufferPos = 0;
+	bufferLength = fread(buffer, 1, AS_SCRIPTFILE_BUFFER_SIZE, file);
+
+	return bufferLength;
+}
+
+size_t CScriptFile::ReadBytes(void *buf, size_t length)
+{
+	if( readMode == READ_STDIO )
+		return fread(buf, 1, length, file);
+
+	size_t total = 0;
+	while( total < length )
+	{
+		if( bufferPos >= bufferLength )
+		{
+			if( readMode == READ_BUFFERED && length - total >= AS_SCRIPTFILE_BUFFER_SIZE )
+			{
+				// Large reads go directly to the destination instead of through the buffer
+				size_t r = fread((char*)buf + total, 1, length - total, file);
+				bufferOffset += asINT64(bufferLength + r);
+				bufferLength = 0;
+				bufferPos = 0;
+				total += r;
+				if( total < length )
+					reachedEOF = true;
+				break;
+			}
+
+			if( readMode == READ_MAPPED || FillBuffer() == 0 )
+			{
+				reachedEOF = true;
+				break;
+			}
+		}
+
+		size_t count = bufferLength - bufferPos;
+		if( count > length - total )
+			count = length - total;
+		memcpy((char*)buf + total, buffer + bufferPos, count);
+		bufferPos += count;
+		total += count;
+	}
+
+	return total;
+}
+
+// Appends the characters up to and including the next new-line character
+void CScriptFile::ReadLineFromBuffer(std::string &str)
+{
+	for(;;)
+	{
+		if( bufferPos >= bufferLength && 
+			(readMode == READ_MAPPED || FillBuffer() == 0) )
+		{
+			reachedEOF = true;
+			break;
+		}
+
+		const char *start = buffer + bufferPos;
+		size_t count = bufferLength - bufferPos;
+		const char *end = (const char*)memchr(start, '\n', count);
+		if( end )
+			count = size_t(end - start) + 1;
+
+		str.append(start, count);
+		bufferPos += count;
+
+		if( end )
+			break;
+	}
+}
+
 int CScriptFile::ReadLine(std::string &str)
 {
 	if( file == 0 )
@@ -403,12 +663,18 @@ int CScriptFile::ReadLine(std::string &str)
 
 	// Read until the first new-line character
 	str = "";
+
+	if( readMode != READ_STDIO )
+	{
+		ReadLineFromBuffer(str);
+		return int(str.size());
+	}
 	char buf[256];
 
 	do
 	{
 		// Get the current position so we can determine how many characters were read
-		int start = ftell(file);
+		asINT64 start = FileTell(file);
 
 		// Set the last byte to something different that 0, so that we can check if the buffer was filled up
 		buf[255] = 1;
@@ -418,52 +684,48 @@ int CScriptFile::ReadLine(std::string &str)
 		if( r == 0 ) break;
 		
 		// Get the position after the read
-		int end = ftell(file);
+		asINT64 end = FileTell(file);
 
 		// Add the read characters to the output buffer
-		str.append(buf, end-start);
+		str.append(buf, size_t(end-start));
 	}
 	while( !feof(file) && buf[255] == 0 && buf[254] != '\n' );
 
 	return int(str.size());
 }
 
-asINT64 CScriptFile::ReadInt(asUINT bytes)
+asQWORD CScriptFile::DecodeUInt(const unsigned char *buf, asUINT bytes) const
 {
-	if( file == 0 )
-		return 0;
-
-	if( bytes > 8 ) bytes = 8;
-	if( bytes == 0 ) return 0;
-
-	unsigned char buf[8];
-	size_t r = fread(buf, bytes, 1, file);
-	if( r == 0 ) return 0;
-
-	asINT64 val = 0;
+	asQWORD val = 0;
 	if( mostSignificantByteFirst )
 	{
 		unsigned int n = 0;
 		for( ; n < bytes; n++ )
 			val |= asQWORD(buf[n]) << ((bytes-n-1)*8);
-		if( buf[0] & 0x80 )
-			for( ; n < 8; n++ )
-				val |= asQWORD(0xFF) << (n*8);
 	}
 	else
 	{
 		unsigned int n = 0;
 		for( ; n < bytes; n++ )
 			val |= asQWORD(buf[n]) << (n*8);
-		if( buf[0] & 0x80 )
-			for( ; n < 8; n++ )
-				val |= asQWORD(0xFF) << (n*8);
 	}
 
 	return val;
 }
 
-asQWORD CScriptFile::ReadUInt(asUINT bytes)
+asINT64 CScriptFile::DecodeInt(const unsigned char *buf, asUINT bytes) const
+{
+	asQWORD val = DecodeUInt(buf, bytes);
+
+	// Extend the sign bit to the remaining bytes
+	unsigned char msb = mostSignificantByteFirst ? buf[0] : buf[bytes-1];
+	if( (msb & 0x80) && bytes < 8 )
+		val |= asQWORD(-1) << (bytes*8);
+
+	return asINT64(val);
+}
+
+asINT64 CScriptFile::ReadInt(asUINT bytes)
 {
 	if( file == 0 )
 		return 0;
@@ -472,24 +734,23 @@ asQWORD CScriptFile::ReadUInt(asUINT bytes)
 	if( bytes == 0 ) return 0;
 
 	unsigned char buf[8];
-	size_t r = fread(buf, bytes, 1, file);
-	if( r == 0 ) return 0;
+	if( ReadBytes(buf, bytes) < bytes ) return 0;
 
-	asQWORD val = 0;
-	if( mostSignificantByteFirst )
-	{
-		unsigned int n = 0;
-		for( ; n < bytes; n++ )
-			val |= asQWORD(buf[n]) << ((bytes-n-1)*8);
-	}
-	else
-	{
-		unsigned int n = 0;
-		for( ; n < bytes; n++ )
-			val |= asQWORD(buf[n]) << (n*8);
-	}
+	return DecodeInt(buf, bytes);
+}
 
-	return val;
+asQWORD CScriptFile::ReadUInt(asUINT bytes)
+{
+	if( file == 0 )
+		return 0;
+
+	if( bytes > 8 ) bytes = 8;
+	if( bytes == 0 ) return 0;
+
+	unsigned char buf[8];
+	if( ReadBytes(buf, bytes) < bytes ) return 0;
+
+	return DecodeUInt(buf, bytes);
 }
 
 float CScriptFile::ReadFloat()
@@ -498,22 +759,9 @@ float CScriptFile::ReadFloat()
 		return 0;
 
 	unsigned char buf[4];
-	size_t r = fread(buf, 4, 1, file);
-	if( r == 0 ) return 0;
+	if( ReadBytes(buf, 4) < 4 ) return 0;
 
-	asUINT val = 0;
-	if( mostSignificantByteFirst )
-	{
-		unsigned int n = 0;
-		for( ; n < 4; n++ )
-			val |= asUINT(buf[n]) << ((3-n)*8);
-	}
-	else
-	{
-		unsigned int n = 0;
-		for( ; n < 4; n++ )
-			val |= asUINT(buf[n]) << (n*8);
-	}
+	asUINT val = asUINT(DecodeUInt(buf, 4));
 
 	return *reinterpret_cast<float*>(&val);
 }
@@ -524,24 +772,77 @@ double CScriptFile::ReadDouble()
 		return 0;
 
 	unsigned char buf[8];
-	size_t r = fread(buf, 8, 1, file);
-	if( r == 0 ) return 0;
+	if( ReadBytes(buf, 8) < 8 ) return 0;
 
-	asQWORD val = 0;
-	if( mostSignificantByteFirst )
+	asQWORD val = DecodeUInt(buf, 8);
+
+	return *reinterpret_cast<double*>(&val);
+}
+
+asINT64 CScriptFile::ReadToEnd(std::string &str)
+{
+	str = "";
+	if( file == 0 )
+		return 0;
+
+	if( readMode == READ_MAPPED )
 	{
-		unsigned int n = 0;
-		for( ; n < 8; n++ )
-			val |= asQWORD(buf[n]) << ((7-n)*8);
+		// The whole file is already in memory
+		if( bufferPos < bufferLength )
+			str.assign(buffer + bufferPos, bufferLength - bufferPos);
+		bufferPos = bufferLength;
+		reachedEOF = true;
+		return asINT64(str.size());
 	}
+
+	// Allocate the string for the remaining part of the file once,
+	// unless it is larger than a string can be on this platform
+	asINT64 remaining = GetSize() - GetPos();
+	if( remaining > 0 && asQWORD(remaining) <= asQWORD(str.max_size()) )
+	{
+		str.resize(size_t(remaining));
+		str.resize(ReadBytes(&str[0], size_t(remaining)));
+	}
+
+	// Continue until the end is detected in case the file grew while reading
+	char buf[256];
+	size_t r;
+	while( (r = ReadBytes(buf, sizeof(buf))) > 0 )
+		str.append(buf, r);
+
+	return asINT64(str.size());
+}
+
+// Reads the next line into a string that is reused between the calls, 
+// so that iterating over the lines of a file doesn't allocate memory 
+// for each line. The new-line characters are not included in the line.
+bool CScriptFile::ReadNextLine()
+{
+	line.clear();
+	if( file == 0 )
+		return false;
+
+	if( readMode != READ_STDIO )
+		ReadLineFromBuffer(line);
 	else
+		ReadLine(line);
+
+	if( line.empty() )
+		return false;
+
+	if( line[line.size()-1] == '\n' )
 	{
-		unsigned int n = 0;
-		for( ; n < 8; n++ )
-			val |= asQWORD(buf[n]) << (n*8);
+		line.resize(line.size()-1);
+		if( line.size() && line[line.size()-1] == '\r' )
+			line.resize(line.size()-1);
 	}
 
-	return *reinterpret_cast<double*>(&val);
+	return true;
+}
+
+const std::string &CScriptFile::GetLine() const
+{
+	return line;
 }
 
 bool CScriptFile::IsEOF() const
@@ -549,6 +850,9 @@ bool CScriptFile::IsEOF() const
 	if( file == 0 )
 		return true;
 
+	if( readMode != READ_STDIO )
+		return reachedEOF;
+
 	return feof(file) ? true : false;
 }
 
@@ -20,6 +20,13 @@
 #define AS_WRITE_OPS 1
 #endif
 
+// Set the size in bytes of the read buffer 
+// that is allocated for the "rl" mode
+
+#ifndef AS_SCRIPTFILE_BUFFER_SIZE
+#define AS_SCRIPTFILE_BUFFER_SIZE (1024*1024)
+#endif
+
 
 
 
@@ -37,6 +44,8 @@
 
 BEGIN_AS_NAMESPACE
 
+class CScriptArray;
+
 class CScriptFile
 {
 public:
@@ -49,10 +58,13 @@ public:
 	// mode = "r" -> open the file for reading
 	//        "w" -> open the file for writing (overwrites existing file)
 	//        "a" -> open the file for appending
+	//        "rl" -> open the file for reading through a large buffer
+	//        "rm" -> map the file into memory for reading. Falls back 
+	//                to "rl" if the file cannot be mapped
     int  Open(const std::string &filename, const std::string &mode);
     int  Close();
-    int  GetSize() const;
-    bool IsEOF() const;
+    asINT64 GetSize() const;
+    bool    IsEOF() const;
 
     // Reading
     int      ReadString(unsigned int length, std::string &str);
@@ -62,6 +74,18 @@ public:
     float    ReadFloat();
     double   ReadDouble();
 
+    // Bulk reading
+    asINT64  ReadToEnd(std::string &str);
+    bool     ReadNextLine();
+    const std::string &GetLine() const;
+
+    // These are implemented in scriptfile_utils.cpp and 
+    // require that the array add-on is also compiled
+    CScriptArray *ReadInts(asUINT count, asUINT bytes);
+    CScriptArray *ReadUInts(asUINT count, asUINT bytes);
+    CScriptArray *ReadFloats(asUINT count);
+    CScriptArray *ReadDoubles(asUINT count);
+
     // Writing
     int WriteString(const std::string &str);
     int WriteInt(asINT64 v, asUINT bytes);
@@ -70,9 +94,9 @@ public:
     int WriteDouble(double v);
 
     // Cursor
-	int GetPos() const;
-    int SetPos(int pos);
-    int MovePos(int delta);
+    asINT64 GetPos() const;
+    int     SetPos(asINT64 pos);
+    int     MovePos(asINT64 delta);
 
     // Big-endian = most significant byte first
     bool mostSignificantByteFirst;
@@ -80,8 +104,35 @@ public:
 protected:
     ~CScriptFile();
 
+    bool    MapFile();
+    size_t  FillBuffer();
+    size_t  ReadBytes(void *buf, size_t length);
+    void    ReadLineFromBuffer(std::string &str);
+    asQWORD DecodeUInt(const unsigned char *buf, asUINT bytes) const;
+    asINT64 DecodeInt(const unsigned char *buf, asUINT bytes) const;
+
+    enum EReadMode
+    {
+        READ_STDIO,
+        READ_BUFFERED,
+        READ_MAPPED
+    };
+
     mutable int refCount;
     FILE       *file;
+
+    // In the "rl" and "rm" modes the reads are made from the buffer, which 
+    // holds either a part of the file or the whole file mapped into memory
+    EReadMode   readMode;
+    char       *buffer;
+    size_t      bufferLength;
+    size_t      bufferPos;
+    asINT64     bufferOffset;
+    bool        reachedEOF;
+    void       *mapping;
+
+    // The current line for ReadNextLine()
+    std::string line;
 };
 
 // This function will determine the configuration of the engine
@@ -96,6 +147,10 @@ void RegisterScriptFile_Native(asIScriptEngine *engine);
 // are not supported on the target platform
 void RegisterScriptFile_Generic(asIScriptEngine *engine);
 
+// Call this function to register the bulk array readers.
+// The array add-on must have been registered first.
+void RegisterScriptFileUtils(asIScriptEngine *engine);
+
 END_AS_NAMESPACE
 
 #endif
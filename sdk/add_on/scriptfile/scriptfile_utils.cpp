@@ -0,0 +1,182 @@
+#include <assert.h>
+#include "scriptfile.h"
+#include "../scriptarray/scriptarray.h"
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+BEGIN_AS_NAMESPACE
+
+// The array type is the return type of the called function, so it
+// doesn't have to be looked up by the declaration each time
+static asIObjectType *GetArrayType()
+{
+	asIScriptContext *ctx = asGetActiveContext();
+	asIScriptFunction *func = ctx->GetSystemFunction();
+	return ctx->GetEngine()->GetObjectTypeById(func->GetReturnTypeId());
+}
+
+// The buffer is limited to the bytes left in the file, so a large count
+// doesn't allocate memory that can never be filled. One byte more than
+// what is left is read so the end of the file is still reached. Streams
+// where the size cannot be determined are not limited.
+static size_t GetReadLength(const CScriptFile *file, asUINT count, asUINT bytes)
+{
+	asQWORD length = asQWORD(count) * bytes;
+
+	asINT64 size = file->GetSize();
+	asINT64 pos  = file->GetPos();
+	if( size >= 0 && pos >= 0 )
+	{
+		asQWORD left = size > pos ? asQWORD(size - pos) : 0;
+		if( length > left + 1 )
+			length = left + 1;
+	}
+
+	return size_t(length);
+}
+
+// The values are read from the file with a single read, and then decoded
+// directly into the array's buffer. The array will only hold the values
+// that could be read completely.
+
+CScriptArray *CScriptFile::ReadInts(asUINT count, asUINT bytes)
+{
+	CScriptArray *arr = new CScriptArray(0, GetArrayType());
+	if( file == 0 || count == 0 )
+		return arr;
+
+	if( bytes > 8 ) bytes = 8;
+	if( bytes == 0 ) return arr;
+
+	vector<unsigned char> data(GetReadLength(this, count, bytes));
+	count = asUINT(ReadBytes(&data[0], data.size()) / bytes);
+
+	arr->Resize(count);
+	if( count )
+	{
+		asINT64 *values = (asINT64*)arr->At(0);
+		for( asUINT n = 0; n < count; n++ )
+			values[n] = DecodeInt(&data[n*bytes], bytes);
+	}
+
+	return arr;
+}
+
+CScriptArray *CScriptFile::ReadUInts(asUINT count, asUINT bytes)
+{
+	CScriptArray *arr = new CScriptArray(0, GetArrayType());
+	if( file == 0 || count == 0 )
+		return arr;
+
+	if( bytes > 8 ) bytes = 8;
+	if( bytes == 0 ) return arr;
+
+	vector<unsigned char> data(GetReadLength(this, count, bytes));
+	count = asUINT(ReadBytes(&data[0], data.size()) / bytes);
+
+	arr->Resize(count);
+	if( count )
+	{
+		asQWORD *values = (asQWORD*)arr->At(0);
+		for( asUINT n = 0; n < count; n++ )
+			values[n] = DecodeUInt(&data[n*bytes], bytes);
+	}
+
+	return arr;
+}
+
+CScriptArray *CScriptFile::ReadFloats(asUINT count)
+{
+	CScriptArray *arr = new CScriptArray(0, GetArrayType());
+	if( file == 0 || count == 0 )
+		return arr;
+
+	vector<unsigned char> data(GetReadLength(this, count, 4));
+	count = asUINT(ReadBytes(&data[0], data.size()) / 4);
+
+	arr->Resize(count);
+	if( count )
+	{
+		asUINT *values = (asUINT*)arr->At(0);
+		for( asUINT n = 0; n < count; n++ )
+			values[n] = asUINT(DecodeUInt(&data[n*4], 4));
+	}
+
+	return arr;
+}
+
+CScriptArray *CScriptFile::ReadDoubles(asUINT count)
+{
+	CScriptArray *arr = new CScriptArray(0, GetArrayType());
+	if( file == 0 || count == 0 )
+		return arr;
+
+	vector<unsigned char> data(GetReadLength(this, count, 8));
+	count = asUINT(ReadBytes(&data[0], data.size()) / 8);
+
+	arr->Resize(count);
+	if( count )
+	{
+		asQWORD *values = (asQWORD*)arr->At(0);
+		for( asUINT n = 0; n < count; n++ )
+			values[n] = DecodeUInt(&data[n*8], 8);
+	}
+
+	return arr;
+}
+
+static void ScriptFile_ReadInts_Generic(asIScriptGeneric *gen)
+{
+	CScriptFile *file = (CScriptFile*)gen->GetObject();
+	asUINT count = gen->GetArgDWord(0);
+	asUINT bytes = gen->GetArgDWord(1);
+	*(CScriptArray**)gen->GetAddressOfReturnLocation() = file->ReadInts(count, bytes);
+}
+
+static void ScriptFile_ReadUInts_Generic(asIScriptGeneric *gen)
+{
+	CScriptFile *file = (CScriptFile*)gen->GetObject();
+	asUINT count = gen->GetArgDWord(0);
+	asUINT bytes = gen->GetArgDWord(1);
+	*(CScriptArray**)gen->GetAddressOfReturnLocation() = file->ReadUInts(count, bytes);
+}
+
+static void ScriptFile_ReadFloats_Generic(asIScriptGeneric *gen)
+{
+	CScriptFile *file = (CScriptFile*)gen->GetObject();
+	asUINT count = gen->GetArgDWord(0);
+	*(CScriptArray**)gen->GetAddressOfReturnLocation() = file->ReadFloats(count);
+}
+
+static void ScriptFile_ReadDoubles_Generic(asIScriptGeneric *gen)
+{
+	CScriptFile *file = (CScriptFile*)gen->GetObject();
+	asUINT count = gen->GetArgDWord(0);
+	*(CScriptArray**)gen->GetAddressOfReturnLocation() = file->ReadDoubles(count);
+}
+
+// This is where the bulk readers are registered.
+// The file type and the array add-on must have been registered first.
+void RegisterScriptFileUtils(asIScriptEngine *engine)
+{
+	int r;
+
+	if( strstr(asGetLibraryOptions(), "AS_MAX_PORTABILITY") )
+	{
+		r = engine->RegisterObjectMethod("file", "array<int64>@ readInts(uint, uint)", asFUNCTION(ScriptFile_ReadInts_Generic), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("file", "array<uint64>@ readUInts(uint, uint)", asFUNCTION(ScriptFile_ReadUInts_Generic), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("file", "array<float>@ readFloats(uint)", asFUNCTION(ScriptFile_ReadFloats_Generic), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("file", "array<double>@ readDoubles(uint)", asFUNCTION(ScriptFile_ReadDoubles_Generic), asCALL_GENERIC); assert( r >= 0 );
+	}
+	else
+	{
+		r = engine->RegisterObjectMethod("file", "array<int64>@ readInts(uint, uint)", asMETHOD(CScriptFile,ReadInts), asCALL_THISCALL); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("file", "array<uint64>@ readUInts(uint, uint)", asMETHOD(CScriptFile,ReadUInts), asCALL_THISCALL); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("file", "array<float>@ readFloats(uint)", asMETHOD(CScriptFile,ReadFloats), asCALL_THISCALL); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("file", "array<double>@ readDoubles(uint)", asMETHOD(CScriptFile,ReadDoubles), asCALL_THISCALL); assert( r >= 0 );
+	}
+}
+
+END_AS_NAMESPACE
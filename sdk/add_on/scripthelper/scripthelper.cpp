@@ -160,6 +160,208 @@ int ExecuteString(asIScriptEngine *engine, const char *code, asIScriptModule *mo
 	return r;
 }
 
+CExecuteStringCache::CExecuteStringCache(asIScriptEngine *engine, asUINT maxFunctions)
+{
+	this->engine = engine;
+	this->maxFunctions = maxFunctions > 0 ? maxFunctions : 1;
+	engine->AddRef();
+}
+
+// The module where the statements are compiled when no module is given
+static const char *CACHE_MODULE = "ExecuteStringCache";
+
+CExecuteStringCache::~CExecuteStringCache()
+{
+	Clear();
+
+	for( asUINT n = 0; n < contexts.size(); n++ )
+		contexts[n]->Release();
+	contexts.clear();
+
+	if( engine->GetModule(CACHE_MODULE, asGM_ONLY_IF_EXISTS) )
+		engine->DiscardModule(CACHE_MODULE);
+
+	engine->Release();
+}
+
+asIScriptFunction *CExecuteStringCache::GetFunction(const char *code, const char *params, asIScriptModule *mod, int &r)
+{
+	// Wrap the code in a function so that it can be compiled and executed
+	string funcCode = "void ExecuteString(";
+	funcCode += params;
+	funcCode += ") {\n";
+	funcCode += code;
+	funcCode += "\n;}";
+
+	// If no module was provided, get a dummy from the engine. Unlike ExecuteString() 
+	// the module is kept, since the cached functions are compiled in it
+	asIScriptModule *execMod = mod ? mod : engine->GetModule(CACHE_MODULE, asGM_CREATE_IF_NOT_EXISTS);
+	string module = execMod->GetName();
+
+	EntryMap::iterator it = entryMap.find(make_pair(module, funcCode));
+	if( it != entryMap.end() )
+	{
+		if( it->second->mod == execMod && it->second->buildId == execMod->GetBuildId() )
+		{
+			// Move the entry to the front of the list as it is now the most recently used
+			entries.splice(entries.begin(), entries, it->second);
+			r = 0;
+			return it->second->func;
+		}
+
+		// The module was rebuilt, or discarded and another one was created with the same name
+		RemoveEntries(module);
+	}
+
+	// The functions compiled for the modules that have been discarded are 
+	// released before compiling a new one, so they don't take up the cache
+	RemoveDiscardedModules();
+
+	// Compile the function. Functions that fail to compile are not cached, 
+	// so the errors will be reported again the next time
+	asIScriptFunction *func = 0;
+	r = execMod->CompileFunction("ExecuteString", funcCode.c_str(), -1, 0, &func);
+	if( r < 0 )
+		return 0;
+
+	SEntry entry;
+	entry.module  = module;
+	entry.mod     = execMod;
+	entry.buildId = execMod->GetBuildId();
+	entry.code    = funcCode;
+	entry.func    = func;
+	entries.push_front(entry);
+	entryMap[make_pair(module, funcCode)] = entries.begin();
+
+	// Discard the least recently used function when the cache is full
+	if( entries.size() > maxFunctions )
+	{
+		SEntry &last = entries.back();
+		entryMap.erase(make_pair(last.module, last.code));
+		last.func->Release();
+		entries.pop_back();
+	}
+
+	return func;
+}
+
+asIScriptContext *CExecuteStringCache::GetContext()
+{
+	if( contexts.size() )
+	{
+		asIScriptContext *ctx = contexts.back();
+		contexts.pop_back();
+		return ctx;
+	}
+
+	return engine->CreateContext();
+}
+
+void CExecuteStringCache::ReturnContext(asIScriptContext *ctx)
+{
+	if( ctx == 0 )
+		return;
+
+	// The context must not hold on to the function or the objects from the execution
+	if( ctx->GetState() == asEXECUTION_SUSPENDED )
+		ctx->Abort();
+	ctx->Unprepare();
+
+	contexts.push_back(ctx);
+}
+
+int CExecuteStringCache::Execute(const char *code, asIScriptModule *mod, asIScriptContext *ctx)
+{
+	int r;
+	asIScriptFunction *func = GetFunction(code, "", mod, r);
+	if( func == 0 )
+		return r;
+
+	// If no context was provided, reuse one of the cached contexts
+	asIScriptContext *execCtx = ctx ? ctx : GetContext();
+	r = execCtx->Prepare(func);
+	if( r >= 0 )
+		r = execCtx->Execute();
+
+	if( !ctx ) ReturnContext(execCtx);
+
+	return r;
+}
+
+int CExecuteStringCache::Prepare(const char *code, const char *params, asIScriptModule *mod, asIScriptContext **ctx)
+{
+	*ctx = 0;
+
+	int r;
+	asIScriptFunction *func = GetFunction(code, params ? params : "", mod, r);
+	if( func == 0 )
+		return r;
+
+	asIScriptContext *execCtx = GetContext();
+	r = execCtx->Prepare(func);
+	if( r < 0 )
+	{
+		ReturnContext(execCtx);
+		return r;
+	}
+
+	*ctx = execCtx;
+	return 0;
+}
+
+void CExecuteStringCache::Clear()
+{
+	for( EntryList::iterator it = entries.begin(); it != entries.end(); it++ )
+		it->func->Release();
+	entries.clear();
+	entryMap.clear();
+}
+
+void CExecuteStringCache::ClearModule(asIScriptModule *mod)
+{
+	RemoveEntries(mod ? mod->GetName() : CACHE_MODULE);
+}
+
+void CExecuteStringCache::RemoveEntries(const string &module)
+{
+	EntryList::iterator it = entries.begin();
+	while( it != entries.end() )
+	{
+		if( it->module == module )
+		{
+			entryMap.erase(make_pair(it->module, it->code));
+			it->func->Release();
+			it = entries.erase(it);
+		}
+		else
+			it++;
+	}
+}
+
+// Removes the functions whose module no longer exists, has been rebuilt, or has been replaced by another with the same name.
+// The build id tells if the module is still the same, even if another module has been allocated at the same address.
+void CExecuteStringCache::RemoveDiscardedModules()
+{
+	EntryList::iterator it = entries.begin();
+	while( it != entries.end() )
+	{
+		asIScriptModule *mod = engine->GetModule(it->module.c_str(), asGM_ONLY_IF_EXISTS);
+		if( mod == 0 || mod != it->mod || mod->GetBuildId() != it->buildId )
+		{
+			entryMap.erase(make_pair(it->module, it->code));
+			it->func->Release();
+			it = entries.erase(it);
+		}
+		else
+			it++;
+	}
+}
+
+asUINT CExecuteStringCache::GetCachedCount() const
+{
+	return asUINT(entries.size());
+}
+
 int WriteConfigToFile(asIScriptEngine *engine, const char *filename)
 {
 	int c, n;
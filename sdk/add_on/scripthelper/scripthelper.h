@@ -6,6 +6,10 @@
 #include <angelscript.h>
 #endif
 
+#include <string>
+#include <list>
+#include <map>
+#include <vector>
 
 BEGIN_AS_NAMESPACE
 
@@ -20,6 +24,62 @@ int CompareEquality(asIScriptEngine *engine, void *lobj, void *robj, int typeId,
 // The caller can optionally provide its own context, for example if a context should be reused.
 int ExecuteString(asIScriptEngine *engine, const char *code, asIScriptModule *mod = 0, asIScriptContext *ctx = 0);
 
+// Keeps the functions compiled for the statements in an LRU cache, so statements 
+// that are executed repeatedly only have to be compiled once. The contexts are 
+// also reused between the calls. The functions are cached by the name of the 
+// module, and the ones compiled for a module that has been rebuilt or no longer
+// exists are not used again, and are dropped when the next function is compiled.
+// The cached functions keep references to the entities in the module, so call 
+// ClearModule() before rebuilding a module to release them right away. The module
+// used for the statements without a module is discarded with the cache. The cache
+// is not thread safe.
+class CExecuteStringCache
+{
+public:
+	CExecuteStringCache(asIScriptEngine *engine, asUINT maxFunctions = 64);
+	~CExecuteStringCache();
+
+	// Same as ExecuteString(), but uses the cached function if the same code has already been compiled for the module
+	int Execute(const char *code, asIScriptModule *mod = 0, asIScriptContext *ctx = 0);
+
+	// Prepares a context for executing the code with parameters, e.g. "int a, const string &in b".
+	// Set the arguments with the context's SetArg methods and call Execute() on the context. 
+	// Then give the context back with ReturnContext() so it can be reused.
+	int  Prepare(const char *code, const char *params, asIScriptModule *mod, asIScriptContext **ctx);
+	void ReturnContext(asIScriptContext *ctx);
+
+	// Releases the cached functions
+	void   Clear();
+	void   ClearModule(asIScriptModule *mod);
+	asUINT GetCachedCount() const;
+
+protected:
+	asIScriptFunction *GetFunction(const char *code, const char *params, asIScriptModule *mod, int &r);
+	asIScriptContext  *GetContext();
+
+	void               RemoveEntries(const std::string &module);
+	void               RemoveDiscardedModules();
+
+	struct SEntry
+	{
+		std::string        module;
+		asIScriptModule   *mod;
+		asUINT             buildId;
+		std::string        code;
+		asIScriptFunction *func;
+	};
+
+	// The most recently used functions are at the front of the list
+	typedef std::list<SEntry> EntryList;
+	typedef std::map<std::pair<std::string, std::string>, EntryList::iterator> EntryMap;
+
+	asIScriptEngine                *engine;
+	asUINT                          maxFunctions;
+	EntryList                       entries;
+	EntryMap                        entryMap;
+	std::vector<asIScriptContext*>  contexts;
+};
+
 // Write the registered application interface to a file for an offline compiler.
 // The format is compatible with the offline compiler in /sdk/samples/asbuild/.
 int WriteConfigToFile(asIScriptEngine *engine, const char *filename);
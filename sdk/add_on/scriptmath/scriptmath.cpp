@@ -71,6 +71,35 @@ double fraction(double v)
 }
 #endif
 
+// The math functions have no side effects, so the compiler can
+// evaluate them already when they are called with constant args
+static void SetMathFunctionsPure(asIScriptEngine *engine)
+{
+	static const char *decls[] =
+	{
+#if AS_USE_FLOAT
+		"float cos(float)", "float sin(float)", "float tan(float)",
+		"float acos(float)", "float asin(float)", "float atan(float)", "float atan2(float,float)",
+		"float cosh(float)", "float sinh(float)", "float tanh(float)",
+		"float log(float)", "float log10(float)",
+		"float pow(float, float)", "float sqrt(float)",
+		"float ceil(float)", "float abs(float)", "float floor(float)", "float fraction(float)"
+#else
+		"double cos(double)", "double sin(double)", "double tan(double)",
+		"double acos(double)", "double asin(double)", "double atan(double)", "double atan2(double,double)",
+		"double cosh(double)", "double sinh(double)", "double tanh(double)",
+		"double log(double)", "double log10(double)",
+		"double pow(double, double)", "double sqrt(double)",
+		"double ceil(double)", "double abs(double)", "double floor(double)", "double fraction(double)"
+#endif
+	};
+
+	for( asUINT n = 0; n < sizeof(decls)/sizeof(decls[0]); n++ )
+	{
+		int r = engine->SetGlobalFunctionPure(engine->GetGlobalFunctionByDecl(decls[n]), true); assert( r >= 0 );
+	}
+}
+
 void RegisterScriptMath_Native(asIScriptEngine *engine)
 {
 	int r;
@@ -127,6 +156,8 @@ void RegisterScriptMath_Native(asIScriptEngine *engine)
 	r = engine->RegisterGlobalFunction("double floor(double)", asFUNCTIONPR(floor, (double), double), asCALL_CDECL); assert( r >= 0 );
 	r = engine->RegisterGlobalFunction("double fraction(double)", asFUNCTIONPR(fraction, (double), double), asCALL_CDECL); assert( r >= 0 );
 #endif
+
+	SetMathFunctionsPure(engine);
 }
 
 #if AS_USE_FLOAT
@@ -263,6 +294,8 @@ void RegisterScriptMath_Generic(asIScriptEngine *engine)
 	r = engine->RegisterGlobalFunction("double floor(double)", asFUNCTION(floor_generic), asCALL_GENERIC); assert( r >= 0 );
 	r = engine->RegisterGlobalFunction("double fraction(double)", asFUNCTION(fraction_generic), asCALL_GENERIC); assert( r >= 0 );
 #endif
+
+	SetMathFunctionsPure(engine);
 }
 
 void RegisterScriptMath(asIScriptEngine *engine)
@@ -31,18 +31,9 @@ const asPWORD STRING_POOL = 1001;
 // IwGxInit() and finished with IwGxTerminate().
 static const string emptyString;
 
-static const string &StringFactory(asUINT length, const char *s)
+// Returns the string pool of the engine, or creates it if it doesn't exist yet
+static map<const char *, string> *GetStringPool(asIScriptEngine *engine)
 {
-	// Each engine instance has its own string pool
-	asIScriptContext *ctx = asGetActiveContext();
-	if( ctx == 0 )
-	{
-		// The string factory can only be called from a script
-		assert( ctx );
-		return emptyString;
-	}
-	asIScriptEngine *engine = ctx->GetEngine();
-
 	// TODO: runtime optimize: Use unordered_map if C++11 is supported, i.e. MSVC10+, gcc 4.?+
 	map<const char *, string> *pool = reinterpret_cast< map<const char *, string>* >(engine->GetUserData(STRING_POOL));
 
@@ -60,18 +51,69 @@ static const string &StringFactory(asUINT length, const char *s)
 			#else
 			pool = new (nothrow) map<const char *, string>;
 			#endif
-			if( pool == 0 )
-			{
-				ctx->SetException("Out of memory");
-				asReleaseExclusiveLock();
-				return emptyString;
-			}
-			engine->SetUserData(pool, STRING_POOL);
+			if( pool )
+				engine->SetUserData(pool, STRING_POOL);
 		}
 
 		asReleaseExclusiveLock();
 	}
 
+	return pool;
+}
+
+// Adds the string to the pool, unless it is already there
+static const string *AddStringToPool(map<const char *, string> *pool, asUINT length, const char *s)
+{
+	// Acquire an exclusive lock so we can add the new string to the pool
+	asAcquireExclusiveLock();
+
+	// Make sure the string wasn't created while we were waiting for the exclusive lock
+	map<const char *, string>::iterator it;
+	it = pool->find(s);
+	if( it == pool->end() )
+	{
+		// Create a new string object
+		it = pool->insert(map<const char *, string>::value_type(s, string(s, length))).first;
+	}
+
+	asReleaseExclusiveLock();
+	return &it->second;
+}
+
+// The engine calls this when a script with a new string constant is built or 
+// loaded. The engine keeps the returned object for the constant, so normally 
+// the context uses the object directly without calling the string factory
+static void *CreateStringConstant(const char *s, asUINT length, void *param)
+{
+	asIScriptEngine *engine = reinterpret_cast<asIScriptEngine*>(param);
+	map<const char *, string> *pool = GetStringPool(engine);
+	if( pool == 0 )
+		return 0;
+
+	return const_cast<string*>(AddStringToPool(pool, length, s));
+}
+
+// The string factory is still called by JIT compiled code, and if the
+// engine couldn't create the string object in advance
+static const string &StringFactory(asUINT length, const char *s)
+{
+	// Each engine instance has its own string pool
+	asIScriptContext *ctx = asGetActiveContext();
+	if( ctx == 0 )
+	{
+		// The string factory can only be called from a script
+		assert( ctx );
+		return emptyString;
+	}
+	asIScriptEngine *engine = ctx->GetEngine();
+
+	map<const char *, string> *pool = GetStringPool(engine);
+	if( pool == 0 )
+	{
+		ctx->SetException("Out of memory");
+		return emptyString;
+	}
+
 	// We can't let other threads modify the pool while we query it
 	asAcquireSharedLock();
 
@@ -86,19 +128,7 @@ static const string &StringFactory(asUINT length, const char *s)
 
 	asReleaseSharedLock();
 
-	// Acquire an exclusive lock so we can add the new string to the pool
-	asAcquireExclusiveLock();
-
-	// Make sure the string wasn't created while we were waiting for the exclusive lock
-	it = pool->find(s);
-	if( it == pool->end() )
-	{
-		// Create a new string object
-		it = pool->insert(map<const char *, string>::value_type(s, string(s, length))).first;
-	}
-
-	asReleaseExclusiveLock();
-	return it->second;
+	return *AddStringToPool(pool, length, s);
 }
 
 static void CleanupEngineStringPool(asIScriptEngine *engine)
@@ -337,9 +367,8 @@ static void StringResize(asUINT l, string &str)
 	str.resize(l);
 }
 
-// AngelScript signature:
-// string formatInt(int64 val, const string &in options, uint width)
-static string formatInt(asINT64 value, const string &options, asUINT width)
+// Formats the value and appends it to dest. Used by formatInt and the string builder
+static void AppendFormattedInt(string &dest, asINT64 value, const string &options, asUINT width)
 {
 	bool leftJustify = options.find("l") != string::npos;
 	bool padWithZero = options.find("0") != string::npos;
@@ -368,22 +397,29 @@ static string formatInt(asINT64 value, const string &options, asUINT width)
 	else if( hexLarge ) fmt += "X";
 	else fmt += "d";
 
-	string buf;
-	buf.resize(width+20);
+	// Format the value directly at the end of the destination
+	size_t pos = dest.size();
+	dest.resize(pos+width+20);
 #if _MSC_VER >= 1400 && !defined(__S3E__)
 	// MSVC 8.0 / 2005 or newer
-	sprintf_s(&buf[0], buf.size(), fmt.c_str(), width, value);
+	sprintf_s(&dest[pos], dest.size()-pos, fmt.c_str(), width, value);
 #else
-	sprintf(&buf[0], fmt.c_str(), width, value);
+	sprintf(&dest[pos], fmt.c_str(), width, value);
 #endif
-	buf.resize(strlen(&buf[0]));
-	
-	return buf;
+	dest.resize(pos+strlen(&dest[pos]));
 }
 
 // AngelScript signature:
-// string formatFloat(double val, const string &in options, uint width, uint precision)
-static string formatFloat(double value, const string &options, asUINT width, asUINT precision)
+// string formatInt(int64 val, const string &in options, uint width)
+static string formatInt(asINT64 value, const string &options, asUINT width)
+{
+	string buf;
+	AppendFormattedInt(buf, value, options, width);
+	return buf;
+}
+
+// Formats the value and appends it to dest. Used by formatFloat and the string builder
+static void AppendFormattedFloat(string &dest, double value, const string &options, asUINT width, asUINT precision)
 {
 	bool leftJustify = options.find("l") != string::npos;
 	bool padWithZero = options.find("0") != string::npos;
@@ -404,16 +440,24 @@ static string formatFloat(double value, const string &options, asUINT width, asU
 	else if( expLarge ) fmt += "E";
 	else fmt += "f";
 
-	string buf;
-	buf.resize(width+precision+50);
+	// Format the value directly at the end of the destination
+	size_t pos = dest.size();
+	dest.resize(pos+width+precision+50);
 #if _MSC_VER >= 1400 && !defined(__S3E__)
 	// MSVC 8.0 / 2005 or newer
-	sprintf_s(&buf[0], buf.size(), fmt.c_str(), width, precision, value);
+	sprintf_s(&dest[pos], dest.size()-pos, fmt.c_str(), width, precision, value);
 #else
-	sprintf(&buf[0], fmt.c_str(), width, precision, value);
+	sprintf(&dest[pos], fmt.c_str(), width, precision, value);
 #endif
-	buf.resize(strlen(&buf[0]));
-	
+	dest.resize(pos+strlen(&dest[pos]));
+}
+
+// AngelScript signature:
+// string formatFloat(double val, const string &in options, uint width, uint precision)
+static string formatFloat(double value, const string &options, asUINT width, asUINT precision)
+{
+	string buf;
+	AppendFormattedFloat(buf, value, options, width, precision);
 	return buf;
 }
 
@@ -540,6 +584,9 @@ void RegisterStdString_Native(asIScriptEngine *engine)
 	// Register the string factory
 	r = engine->RegisterStringFactory("const string &", asFUNCTION(StringFactory), asCALL_CDECL); assert( r >= 0 );
 
+	// Let the engine create the string objects for the constants in advance
+	r = engine->SetStringConstantCallback(CreateStringConstant, engine); assert( r >= 0 );
+
 	// Register the cleanup callback for the string pool
 	engine->SetEngineUserDataCleanupCallback(CleanupEngineStringPool, STRING_POOL);
 #else
@@ -975,6 +1022,9 @@ void RegisterStdString_Generic(asIScriptEngine *engine)
 	// Register the string factory
 	r = engine->RegisterStringFactory("const string &", asFUNCTION(StringFactoryGeneric), asCALL_GENERIC); assert( r >= 0 );
 
+	// Let the engine create the string objects for the constants in advance
+	r = engine->SetStringConstantCallback(CreateStringConstant, engine); assert( r >= 0 );
+
 	// Register the cleanup callback for the string pool
 	engine->SetEngineUserDataCleanupCallback(CleanupEngineStringPool, STRING_POOL);
 #else
@@ -1043,8 +1093,300 @@ void RegisterStdString(asIScriptEngine * engine)
 		RegisterStdString_Native(engine);
 }
 
-END_AS_NAMESPACE
+//--------------------------------------------------------------------------
+// String builder
+//
+// The string builder appends to a single buffer that grows geometrically, 
+// so building a long text with many small pieces doesn't create a temporary
+// string for each piece, nor copy the text built so far on each append.
+
+struct SStringBuilder
+{
+	string buffer;
+};
+
+static void ConstructStringBuilder(SStringBuilder *thisPointer)
+{
+	new(thisPointer) SStringBuilder();
+}
+
+static void CopyConstructStringBuilder(const SStringBuilder &other, SStringBuilder *thisPointer)
+{
+	new(thisPointer) SStringBuilder(other);
+}
+
+static void DestructStringBuilder(SStringBuilder *thisPointer)
+{
+	thisPointer->~SStringBuilder();
+}
+
+static SStringBuilder &AssignStringBuilder(const SStringBuilder &other, SStringBuilder &dest)
+{
+	dest.buffer = other.buffer;
+	return dest;
+}
+
+static SStringBuilder &StringBuilderAppend(const string &str, SStringBuilder &dest)
+{
+	dest.buffer += str;
+	return dest;
+}
+
+static SStringBuilder &StringBuilderAppendUInt64(asQWORD value, SStringBuilder &dest)
+{
+	// Write the digits backwards into a small buffer
+	char buf[24];
+	char *p = buf + sizeof(buf);
+	do
+	{
+		*--p = char('0' + value % 10);
+		value /= 10;
+	} while( value );
+
+	dest.buffer.append(p, buf + sizeof(buf) - p);
+	return dest;
+}
+
+static SStringBuilder &StringBuilderAppendInt64(asINT64 value, SStringBuilder &dest)
+{
+	if( value < 0 )
+	{
+		dest.buffer += '-';
+		// Negate as unsigned so the smallest value doesn't overflow
+		return StringBuilderAppendUInt64(asQWORD(0) - asQWORD(value), dest);
+	}
+
+	return StringBuilderAppendUInt64(asQWORD(value), dest);
+}
+
+static SStringBuilder &StringBuilderAppendDouble(double value, SStringBuilder &dest)
+{
+	// Same format as when appending a double to a string
+	char buf[32];
+#if _MSC_VER >= 1400 && !defined(__S3E__)
+	// MSVC 8.0 / 2005 or newer
+	sprintf_s(buf, sizeof(buf), "%g", value);
+#else
+	sprintf(buf, "%g", value);
+#endif
+	dest.buffer += buf;
+	return dest;
+}
+
+static SStringBuilder &StringBuilderAppendBool(bool value, SStringBuilder &dest)
+{
+	dest.buffer += (value ? "true" : "false");
+	return dest;
+}
+
+static SStringBuilder &StringBuilderAppendInt(asINT64 value, const string &options, asUINT width, SStringBuilder &dest)
+{
+	AppendFormattedInt(dest.buffer, value, options, width);
+	return dest;
+}
+
+static SStringBuilder &StringBuilderAppendFloat(double value, const string &options, asUINT width, asUINT precision, SStringBuilder &dest)
+{
+	AppendFormattedFloat(dest.buffer, value, options, width, precision);
+	return dest;
+}
+
+static void StringBuilderReserve(asUINT length, SStringBuilder &sb)
+{
+	sb.buffer.reserve(length);
+}
+
+static asUINT StringBuilderLength(const SStringBuilder &sb)
+{
+	return asUINT(sb.buffer.size());
+}
+
+static bool StringBuilderIsEmpty(const SStringBuilder &sb)
+{
+	return sb.buffer.empty();
+}
+
+static void StringBuilderClear(SStringBuilder &sb)
+{
+	sb.buffer.clear();
+}
+
+// AngelScript signature:
+// string stringbuilder::str()
+static string StringBuilderStr(SStringBuilder &sb)
+{
+	// Move the text out instead of copying it. The returned string is 
+	// constructed in place, so the buffer is never copied
+	string str;
+	str.swap(sb.buffer);
+	return str;
+}
+
+static void ConstructStringBuilderGeneric(asIScriptGeneric *gen)
+{
+	ConstructStringBuilder((SStringBuilder*)gen->GetObject());
+}
+
+static void CopyConstructStringBuilderGeneric(asIScriptGeneric *gen)
+{
+	SStringBuilder *other = (SStringBuilder*)gen->GetArgObject(0);
+	CopyConstructStringBuilder(*other, (SStringBuilder*)gen->GetObject());
+}
+
+static void DestructStringBuilderGeneric(asIScriptGeneric *gen)
+{
+	DestructStringBuilder((SStringBuilder*)gen->GetObject());
+}
+
+static void AssignStringBuilderGeneric(asIScriptGeneric *gen)
+{
+	SStringBuilder *other = (SStringBuilder*)gen->GetArgObject(0);
+	SStringBuilder *self  = (SStringBuilder*)gen->GetObject();
+	gen->SetReturnAddress(&AssignStringBuilder(*other, *self));
+}
 
+static void StringBuilderAppendGeneric(asIScriptGeneric *gen)
+{
+	string         *str  = (string*)gen->GetArgObject(0);
+	SStringBuilder *self = (SStringBuilder*)gen->GetObject();
+	gen->SetReturnAddress(&StringBuilderAppend(*str, *self));
+}
 
+static void StringBuilderAppendInt64Generic(asIScriptGeneric *gen)
+{
+	asINT64         value = (asINT64)gen->GetArgQWord(0);
+	SStringBuilder *self  = (SStringBuilder*)gen->GetObject();
+	gen->SetReturnAddress(&StringBuilderAppendInt64(value, *self));
+}
 
+static void StringBuilderAppendUInt64Generic(asIScriptGeneric *gen)
+{
+	asQWORD         value = gen->GetArgQWord(0);
+	SStringBuilder *self  = (SStringBuilder*)gen->GetObject();
+	gen->SetReturnAddress(&StringBuilderAppendUInt64(value, *self));
+}
 
+static void StringBuilderAppendDoubleGeneric(asIScriptGeneric *gen)
+{
+	double          value = gen->GetArgDouble(0);
+	SStringBuilder *self  = (SStringBuilder*)gen->GetObject();
+	gen->SetReturnAddress(&StringBuilderAppendDouble(value, *self));
+}
+
+static void StringBuilderAppendBoolGeneric(asIScriptGeneric *gen)
+{
+	bool            value = gen->GetArgByte(0) ? true : false;
+	SStringBuilder *self  = (SStringBuilder*)gen->GetObject();
+	gen->SetReturnAddress(&StringBuilderAppendBool(value, *self));
+}
+
+static void StringBuilderAppendIntGeneric(asIScriptGeneric *gen)
+{
+	asINT64         value   = (asINT64)gen->GetArgQWord(0);
+	string         *options = (string*)gen->GetArgAddress(1);
+	asUINT          width   = gen->GetArgDWord(2);
+	SStringBuilder *self    = (SStringBuilder*)gen->GetObject();
+	gen->SetReturnAddress(&StringBuilderAppendInt(value, *options, width, *self));
+}
+
+static void StringBuilderAppendFloatGeneric(asIScriptGeneric *gen)
+{
+	double          value     = gen->GetArgDouble(0);
+	string         *options   = (string*)gen->GetArgAddress(1);
+	asUINT          width     = gen->GetArgDWord(2);
+	asUINT          precision = gen->GetArgDWord(3);
+	SStringBuilder *self      = (SStringBuilder*)gen->GetObject();
+	gen->SetReturnAddress(&StringBuilderAppendFloat(value, *options, width, precision, *self));
+}
+
+static void StringBuilderReserveGeneric(asIScriptGeneric *gen)
+{
+	StringBuilderReserve(gen->GetArgDWord(0), *(SStringBuilder*)gen->GetObject());
+}
+
+static void StringBuilderLengthGeneric(asIScriptGeneric *gen)
+{
+	*(asUINT*)gen->GetAddressOfReturnLocation() = StringBuilderLength(*(SStringBuilder*)gen->GetObject());
+}
+
+static void StringBuilderIsEmptyGeneric(asIScriptGeneric *gen)
+{
+	*(bool*)gen->GetAddressOfReturnLocation() = StringBuilderIsEmpty(*(SStringBuilder*)gen->GetObject());
+}
+
+static void StringBuilderClearGeneric(asIScriptGeneric *gen)
+{
+	StringBuilderClear(*(SStringBuilder*)gen->GetObject());
+}
+
+static void StringBuilderStrGeneric(asIScriptGeneric *gen)
+{
+	SStringBuilder *self = (SStringBuilder*)gen->GetObject();
+	string *str = new(gen->GetAddressOfReturnLocation()) string();
+	str->swap(self->buffer);
+}
+
+// The string type must have been registered first
+void RegisterStdStringBuilder(asIScriptEngine *engine)
+{
+	int r;
+
+	r = engine->RegisterObjectType("stringbuilder", sizeof(SStringBuilder), asOBJ_VALUE | asOBJ_APP_CLASS_CDAK); assert( r >= 0 );
+
+	if( strstr(asGetLibraryOptions(), "AS_MAX_PORTABILITY") )
+	{
+		r = engine->RegisterObjectBehaviour("stringbuilder", asBEHAVE_CONSTRUCT, "void f()", asFUNCTION(ConstructStringBuilderGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectBehaviour("stringbuilder", asBEHAVE_CONSTRUCT, "void f(const stringbuilder &in)", asFUNCTION(CopyConstructStringBuilderGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectBehaviour("stringbuilder", asBEHAVE_DESTRUCT, "void f()", asFUNCTION(DestructStringBuilderGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAssign(const stringbuilder &in)", asFUNCTION(AssignStringBuilderGeneric), asCALL_GENERIC); assert( r >= 0 );
+
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAddAssign(const string &in)", asFUNCTION(StringBuilderAppendGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAddAssign(int64)", asFUNCTION(StringBuilderAppendInt64Generic), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAddAssign(uint64)", asFUNCTION(StringBuilderAppendUInt64Generic), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAddAssign(double)", asFUNCTION(StringBuilderAppendDoubleGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAddAssign(bool)", asFUNCTION(StringBuilderAppendBoolGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &append(const string &in)", asFUNCTION(StringBuilderAppendGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &append(int64)", asFUNCTION(StringBuilderAppendInt64Generic), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &append(uint64)", asFUNCTION(StringBuilderAppendUInt64Generic), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &append(double)", asFUNCTION(StringBuilderAppendDoubleGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &append(bool)", asFUNCTION(StringBuilderAppendBoolGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &appendInt(int64 val, const string &in options, uint width = 0)", asFUNCTION(StringBuilderAppendIntGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &appendFloat(double val, const string &in options, uint width = 0, uint precision = 0)", asFUNCTION(StringBuilderAppendFloatGeneric), asCALL_GENERIC); assert( r >= 0 );
+
+		r = engine->RegisterObjectMethod("stringbuilder", "void reserve(uint)", asFUNCTION(StringBuilderReserveGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "uint length() const", asFUNCTION(StringBuilderLengthGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "uint get_length() const", asFUNCTION(StringBuilderLengthGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "bool isEmpty() const", asFUNCTION(StringBuilderIsEmptyGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "void clear()", asFUNCTION(StringBuilderClearGeneric), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "string str()", asFUNCTION(StringBuilderStrGeneric), asCALL_GENERIC); assert( r >= 0 );
+	}
+	else
+	{
+		r = engine->RegisterObjectBehaviour("stringbuilder", asBEHAVE_CONSTRUCT, "void f()", asFUNCTION(ConstructStringBuilder), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectBehaviour("stringbuilder", asBEHAVE_CONSTRUCT, "void f(const stringbuilder &in)", asFUNCTION(CopyConstructStringBuilder), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectBehaviour("stringbuilder", asBEHAVE_DESTRUCT, "void f()", asFUNCTION(DestructStringBuilder), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAssign(const stringbuilder &in)", asFUNCTION(AssignStringBuilder), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAddAssign(const string &in)", asFUNCTION(StringBuilderAppend), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAddAssign(int64)", asFUNCTION(StringBuilderAppendInt64), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAddAssign(uint64)", asFUNCTION(StringBuilderAppendUInt64), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAddAssign(double)", asFUNCTION(StringBuilderAppendDouble), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &opAddAssign(bool)", asFUNCTION(StringBuilderAppendBool), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &append(const string &in)", asFUNCTION(StringBuilderAppend), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &append(int64)", asFUNCTION(StringBuilderAppendInt64), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &append(uint64)", asFUNCTION(StringBuilderAppendUInt64), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &append(double)", asFUNCTION(StringBuilderAppendDouble), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &append(bool)", asFUNCTION(StringBuilderAppendBool), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &appendInt(int64 val, const string &in options, uint width = 0)", asFUNCTION(StringBuilderAppendInt), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "stringbuilder &appendFloat(double val, const string &in options, uint width = 0, uint precision = 0)", asFUNCTION(StringBuilderAppendFloat), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+
+		r = engine->RegisterObjectMethod("stringbuilder", "void reserve(uint)", asFUNCTION(StringBuilderReserve), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "uint length() const", asFUNCTION(StringBuilderLength), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "uint get_length() const", asFUNCTION(StringBuilderLength), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "bool isEmpty() const", asFUNCTION(StringBuilderIsEmpty), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "void clear()", asFUNCTION(StringBuilderClear), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("stringbuilder", "string str()", asFUNCTION(StringBuilderStr), asCALL_CDECL_OBJLAST); assert( r >= 0 );
+	}
+}
+
+END_AS_NAMESPACE
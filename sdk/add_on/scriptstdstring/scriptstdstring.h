@@ -48,6 +48,10 @@ BEGIN_AS_NAMESPACE
 void RegisterStdString(asIScriptEngine *engine);
 void RegisterStdStringUtils(asIScriptEngine *engine);
 
+// The stringbuilder type appends to a single buffer, which is 
+// faster than concatenating strings when building long texts
+void RegisterStdStringBuilder(asIScriptEngine *engine);
+
 END_AS_NAMESPACE
 
 #endif
@@ -4,10 +4,75 @@
 #include <stdio.h>
 #include <string.h>
 
+// SSE2 is always available on x64, and on x86 if the compiler is told to use it. 
+// Define AS_NO_SCRIPTSTRING_SIMD to compile the utilities with only the scalar code
+#if !defined(AS_NO_SCRIPTSTRING_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define AS_SCRIPTSTRING_SSE2
+#include <emmintrin.h>
+#endif
+
 using namespace std;
 
 BEGIN_AS_NAMESPACE
 
+// Returns the number of times the character appears in the data. With SSE2 
+// 16 characters are compared at a time, and the matches are summed in byte 
+// counters that are added together before they can overflow
+static asUINT CountChar(const char *data, size_t length, char c)
+{
+	asUINT count = 0;
+	size_t n = 0;
+
+#ifdef AS_SCRIPTSTRING_SSE2
+	const __m128i key  = _mm_set1_epi8(c);
+	const __m128i zero = _mm_setzero_si128();
+	while( length - n >= 16 )
+	{
+		size_t blocks = (length - n) / 16;
+		if( blocks > 255 ) blocks = 255;
+
+		// Each matching byte is -1, so subtracting it increments the counter
+		__m128i counters = zero;
+		for( ; blocks > 0; blocks--, n += 16 )
+			counters = _mm_sub_epi8(counters, _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(data + n)), key));
+
+		__m128i sums = _mm_sad_epu8(counters, zero);
+		count += asUINT(_mm_cvtsi128_si32(sums) + _mm_extract_epi16(sums, 4));
+	}
+#endif
+
+	for( ; n < length; n++ )
+		if( data[n] == c )
+			count++;
+
+	return count;
+}
+
+// Returns the number of non-overlapping occurrences of sub in str
+static asUINT CountOccurrences(const string &str, const string &sub)
+{
+	if( sub.length() == 0 )
+		return 0;
+
+	if( sub.length() == 1 )
+		return CountChar(str.data(), str.length(), sub[0]);
+
+	asUINT count = 0;
+	for( size_t pos = str.find(sub); pos != string::npos; pos = str.find(sub, pos + sub.length()) )
+		count++;
+
+	return count;
+}
+
+// The array<string> type is the return type of the called function, so it 
+// doesn't have to be looked up by the declaration each time
+static asIObjectType *GetStringArrayType()
+{
+	asIScriptContext *ctx = asGetActiveContext();
+	asIScriptFunction *func = ctx->GetSystemFunction();
+	return ctx->GetEngine()->GetObjectTypeById(func->GetReturnTypeId());
+}
+
 // This function takes an input string and splits it into parts by looking
 // for a specified delimiter. Example:
 //
@@ -22,33 +87,23 @@ BEGIN_AS_NAMESPACE
 // array<string>@ string::split(const string &in delim) const
 static CScriptArray *StringSplit(const string &delim, const string &str)
 {
-    // Obtain a pointer to the engine
-    asIScriptContext *ctx = asGetActiveContext();
-    asIScriptEngine *engine = ctx->GetEngine();
-
-    // TODO: This should only be done once
-	// TODO: This assumes that CScriptArray was already registered
-	asIObjectType *arrayType = engine->GetObjectTypeById(engine->GetTypeIdByDecl("array<string>"));
-
-    // Create the array object
-    CScriptArray *array = new CScriptArray(0, arrayType);
-
-    // Find the existence of the delimiter in the input string
-    int pos = 0, prev = 0, count = 0;
-    while( (pos = (int)str.find(delim, prev)) != (int)string::npos )
-    {
-        // Add the part to the array
-        array->Resize(array->GetSize()+1);
-        ((string*)array->At(count))->assign(&str[prev], pos-prev);
-
-        // Find the next part
-        count++;
-        prev = pos + (int)delim.length();
-    }
-
-    // Add the remaining part
-    array->Resize(array->GetSize()+1);
-    ((string*)array->At(count))->assign(&str[prev]);
+	// Count the parts first so the array is created with the final size
+	asUINT count = CountOccurrences(str, delim) + 1;
+	CScriptArray *array = new CScriptArray(count, GetStringArrayType());
+
+	size_t prev = 0;
+	for( asUINT n = 0; n < count - 1; n++ )
+	{
+		// Add the part to the array
+		size_t pos = str.find(delim, prev);
+		((string*)array->At(n))->assign(str, prev, pos - prev);
+
+		// Find the next part
+		prev = pos + delim.length();
+	}
+
+	// Add the remaining part
+	((string*)array->At(count - 1))->assign(str, prev, string::npos);
 
 	return array;
 }
@@ -63,7 +118,118 @@ static void StringSplit_Generic(asIScriptGeneric *gen)
     *(CScriptArray**)gen->GetAddressOfReturnLocation() = StringSplit(*delim, *str);
 }
 
+// This function splits the string at each of the characters in delimiters.
+// Unlike split() the empty parts are skipped. Example:
+//
+// string str = "a, b;;c";
+// array<string>@ array = str.tokenize(",; ");
+//
+// The resulting array has the following elements:
+//
+// {"a", "b", "c"}
+//
+// AngelScript signature:
+// array<string>@ string::tokenize(const string &in delimiters) const
+static CScriptArray *StringTokenize(const string &delimiters, const string &str)
+{
+	bool isDelimiter[256] = {false};
+	for( size_t n = 0; n < delimiters.length(); n++ )
+		isDelimiter[(asBYTE)delimiters[n]] = true;
+
+	const char *data = str.data();
+	size_t length = str.length();
+
+	// Count the tokens first so the array is created with the final size. A
+	// token starts at each non-delimiter that follows a delimiter or the start
+	asUINT count = 0;
+	for( size_t n = 0; n < length; n++ )
+		if( !isDelimiter[(asBYTE)data[n]] && (n == 0 || isDelimiter[(asBYTE)data[n-1]]) )
+			count++;
+
+	CScriptArray *array = new CScriptArray(count, GetStringArrayType());
+
+	size_t n = 0;
+	for( asUINT t = 0; t < count; t++ )
+	{
+		// Skip the delimiters before the token
+		while( isDelimiter[(asBYTE)data[n]] )
+			n++;
 
+		size_t start = n;
+		while( n < length && !isDelimiter[(asBYTE)data[n]] )
+			n++;
+
+		((string*)array->At(t))->assign(data + start, n - start);
+	}
+
+	return array;
+}
+
+static void StringTokenize_Generic(asIScriptGeneric *gen)
+{
+	string *str        = (string*)gen->GetObject();
+	string *delimiters = *(string**)gen->GetAddressOfArg(0);
+
+	*(CScriptArray**)gen->GetAddressOfReturnLocation() = StringTokenize(*delimiters, *str);
+}
+
+// AngelScript signature:
+// uint string::count(const string &in sub) const
+static asUINT StringCount(const string &sub, const string &str)
+{
+	return CountOccurrences(str, sub);
+}
+
+static void StringCount_Generic(asIScriptGeneric *gen)
+{
+	string *str = (string*)gen->GetObject();
+	string *sub = *(string**)gen->GetAddressOfArg(0);
+
+	*(asUINT*)gen->GetAddressOfReturnLocation() = StringCount(*sub, *str);
+}
+
+// This function returns a copy of the string where all non-overlapping 
+// occurrences of search have been replaced. Example:
+//
+// string str = "a-b-c".replace("-", "+-");
+//
+// The resulting string is:
+//
+// "a+-b+-c"
+//
+// AngelScript signature:
+// string string::replace(const string &in search, const string &in replacement) const
+static string StringReplace(const string &search, const string &replacement, const string &str)
+{
+	asUINT count = CountOccurrences(str, search);
+	if( count == 0 )
+		return str;
+
+	// Compute the length of the result so the string is only allocated once
+	string result;
+	result.reserve(str.length() - count * search.length() + count * replacement.length());
+
+	size_t prev = 0;
+	for( asUINT n = 0; n < count; n++ )
+	{
+		size_t pos = str.find(search, prev);
+		result.append(str, prev, pos - prev);
+		result += replacement;
+		prev = pos + search.length();
+	}
+	result.append(str, prev, string::npos);
+
+	return result;
+}
+
+static void StringReplace_Generic(asIScriptGeneric *gen)
+{
+	string *str         = (string*)gen->GetObject();
+	string *search      = *(string**)gen->GetAddressOfArg(0);
+	string *replacement = *(string**)gen->GetAddressOfArg(1);
+
+	new(gen->GetAddressOfReturnLocation()) string(StringReplace(*search, *replacement, *str));
+}
 
 // This function takes as input an array of string handles as well as a
 // delimiter and concatenates the array elements into one delimited string.
@@ -82,17 +248,24 @@ static string StringJoin(const CScriptArray &array, const string &delim)
 {
     // Create the new string
     string str = "";
-	if( array.GetSize() )
+	asUINT count = array.GetSize();
+	if( count )
 	{
-		int n;
-		for( n = 0; n < (int)array.GetSize() - 1; n++ )
+		// Compute the length of the result so the string is only allocated once
+		size_t length = delim.length() * (count - 1);
+		for( asUINT n = 0; n < count; n++ )
+			length += ((const string*)array.At(n))->length();
+		str.reserve(length);
+
+		asUINT n;
+		for( n = 0; n < count - 1; n++ )
 		{
-			str += *(string*)array.At(n);
+			str += *(const string*)array.At(n);
 			str += delim;
 		}
 
 		// Add the last part
-		str += *(string*)array.At(n);
+		str += *(const string*)array.At(n);
 	}
 
 	return str;
@@ -117,11 +290,17 @@ void RegisterStdStringUtils(asIScriptEngine *engine)
 	if( strstr(asGetLibraryOptions(), "AS_MAX_PORTABILITY") )
 	{
 		r = engine->RegisterObjectMethod("string", "array<string>@ split(const string &in) const", asFUNCTION(StringSplit_Generic), asCALL_GENERIC); assert(r >= 0);
+		r = engine->RegisterObjectMethod("string", "array<string>@ tokenize(const string &in) const", asFUNCTION(StringTokenize_Generic), asCALL_GENERIC); assert(r >= 0);
+		r = engine->RegisterObjectMethod("string", "uint count(const string &in) const", asFUNCTION(StringCount_Generic), asCALL_GENERIC); assert(r >= 0);
+		r = engine->RegisterObjectMethod("string", "string replace(const string &in, const string &in) const", asFUNCTION(StringReplace_Generic), asCALL_GENERIC); assert(r >= 0);
 		r = engine->RegisterGlobalFunction("string join(const array<string> &in, const string &in)", asFUNCTION(StringJoin_Generic), asCALL_GENERIC); assert(r >= 0);
 	}
 	else
 	{
 		r = engine->RegisterObjectMethod("string", "array<string>@ split(const string &in) const", asFUNCTION(StringSplit), asCALL_CDECL_OBJLAST); assert(r >= 0);
+		r = engine->RegisterObjectMethod("string", "array<string>@ tokenize(const string &in) const", asFUNCTION(StringTokenize), asCALL_CDECL_OBJLAST); assert(r >= 0);
+		r = engine->RegisterObjectMethod("string", "uint count(const string &in) const", asFUNCTION(StringCount), asCALL_CDECL_OBJLAST); assert(r >= 0);
+		r = engine->RegisterObjectMethod("string", "string replace(const string &in, const string &in) const", asFUNCTION(StringReplace), asCALL_CDECL_OBJLAST); assert(r >= 0);
 		r = engine->RegisterGlobalFunction("string join(const array<string> &in, const string &in)", asFUNCTION(StringJoin), asCALL_CDECL); assert(r >= 0);
 	}
 }
@@ -66,11 +66,14 @@ BEGIN_AS_NAMESPACE
 class asIScriptEngine;
 class asIScriptModule;
 class asIScriptContext;
+class asIScriptCoroutine;
+class asIAsyncCall;
 class asIScriptGeneric;
 class asIScriptObject;
 class asIObjectType;
 class asIScriptFunction;
 class asIBinaryStream;
+class asIContextSerializer;
 class asIJITCompiler;
 class asIThreadManager;
 
@@ -98,7 +101,12 @@ enum asEEngineProp
 	asEP_DISALLOW_GLOBAL_VARS               = 17,
 	asEP_ALWAYS_IMPL_DEFAULT_CONSTRUCT      = 18,
 	asEP_COMPILER_WARNINGS                  = 19,
-	asEP_DISALLOW_VALUE_ASSIGN_FOR_REF_TYPE = 20
+	asEP_DISALLOW_VALUE_ASSIGN_FOR_REF_TYPE = 20,
+	asEP_RECORD_CONFIG_IMAGE                = 21,
+	asEP_LAZY_LOAD_FUNCTIONS                = 22,
+	asEP_COMPRESS_BYTECODE                  = 23,
+	asEP_VERIFY_BYTECODE                    = 24,
+	asEP_ELIMINATE_TAIL_CALLS               = 25
 };
 
 // Calling conventions
@@ -378,6 +386,7 @@ typedef void (*asCLEANMODULEFUNC_t)(asIScriptModule *);
 typedef void (*asCLEANCONTEXTFUNC_t)(asIScriptContext *);
 typedef void (*asCLEANFUNCTIONFUNC_t)(asIScriptFunction *);
 typedef void (*asCLEANOBJECTTYPEFUNC_t)(asIObjectType *);
+typedef void *(*asSTRINGCONSTANTFUNC_t)(const char *, asUINT, void *);
 
 // This macro does basically the same thing as offsetof defined in stddef.h, but
 // GNUC should not complain about the usage as I'm not using 0 as the base pointer.
@@ -556,6 +565,10 @@ public:
 	virtual int SetJITCompiler(asIJITCompiler *compiler) = 0;
 	virtual asIJITCompiler *GetJITCompiler() const = 0;
 
+	// Asynchronous calls
+	virtual int SetAsyncCallCallback(const asSFuncPtr &callback, void *obj, asDWORD callConv) = 0;
+	virtual int ClearAsyncCallCallback() = 0;
+
 	// Global functions
 	virtual int                RegisterGlobalFunction(const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall = 0) = 0;
 	virtual asUINT             GetGlobalFunctionCount() const = 0;
@@ -565,6 +578,7 @@ public:
 #endif
 	virtual asIScriptFunction *GetGlobalFunctionByIndex(asUINT index) const = 0;
 	virtual asIScriptFunction *GetGlobalFunctionByDecl(const char *declaration) const = 0;
+	virtual int                SetGlobalFunctionPure(asIScriptFunction *func, bool isPure) = 0;
 
 	// Global properties
 	virtual int    RegisterGlobalProperty(const char *declaration, void *pointer) = 0;
@@ -577,6 +591,7 @@ public:
 	virtual int            RegisterObjectType(const char *obj, int byteSize, asDWORD flags) = 0;
 	virtual int            RegisterObjectProperty(const char *obj, const char *declaration, int byteOffset) = 0;
 	virtual int            RegisterObjectMethod(const char *obj, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv) = 0;
+	virtual int            RegisterObjectFieldAccessor(const char *obj, const char *declaration, int byteOffset) = 0;
 	virtual int            RegisterObjectBehaviour(const char *obj, asEBehaviours behaviour, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv) = 0;
 	virtual int            RegisterInterface(const char *name) = 0;
 	virtual int            RegisterInterfaceMethod(const char *intf, const char *declaration) = 0;
@@ -587,6 +602,7 @@ public:
 	// String factory
 	virtual int RegisterStringFactory(const char *datatype, const asSFuncPtr &factoryFunc, asDWORD callConv) = 0;
 	virtual int GetStringFactoryReturnTypeId() const = 0;
+	virtual int SetStringConstantCallback(asSTRINGCONSTANTFUNC_t callback, void *param) = 0;
 
 	// Default array type
 	virtual int RegisterDefaultArrayType(const char *type) = 0;
@@ -604,6 +620,7 @@ public:
 	virtual int                RegisterFuncdef(const char *decl) = 0;
 	virtual asUINT             GetFuncdefCount() const = 0;
 	virtual asIScriptFunction *GetFuncdefByIndex(asUINT index) const = 0;
+	virtual asIScriptFunction *GetFuncdefFromTypeId(int typeId) const = 0;
 
 	// Typedefs
 	virtual int         RegisterTypedef(const char *type, const char *decl) = 0;
@@ -618,9 +635,15 @@ public:
 	virtual int         SetDefaultNamespace(const char *nameSpace) = 0;
 	virtual const char *GetDefaultNamespace() const = 0;
 
+	// Configuration image
+	virtual int SaveConfigImage(asIBinaryStream *out) const = 0;
+	virtual int LoadConfigImage(asIBinaryStream *in) = 0;
+
 	// Script modules
 	virtual asIScriptModule *GetModule(const char *module, asEGMFlags flag = asGM_ONLY_IF_EXISTS) = 0;
 	virtual int              DiscardModule(const char *module) = 0;
+	virtual int              SaveByteCodeBundle(asIScriptModule **modules, asUINT count, asIBinaryStream *out, bool stripDebugInfo = false) const = 0;
+	virtual int              LoadByteCodeBundle(asIBinaryStream *in, bool *wasDebugInfoStripped = 0) = 0;
 
 	// Script functions
 	virtual asIScriptFunction *GetFunctionById(int funcId) const = 0;
@@ -685,6 +708,7 @@ public:
 	// Compilation
 	virtual int         AddScriptSection(const char *name, const char *code, size_t codeLength = 0, int lineOffset = 0) = 0;
 	virtual int         Build() = 0;
+	virtual asUINT      GetBuildId() const = 0;
 	virtual int         CompileFunction(const char *sectionName, const char *code, int lineOffset, asDWORD compileFlags, asIScriptFunction **outFunc) = 0;
 	virtual int         CompileGlobalVar(const char *sectionName, const char *code, int lineOffset) = 0;
 	virtual asDWORD     SetAccessMask(asDWORD accessMask) = 0;
@@ -781,6 +805,20 @@ public:
 	virtual int             PopState() = 0;
 	virtual bool            IsNested(asUINT *nestCount = 0) const = 0;
 
+	// Co-routines
+	virtual asIScriptCoroutine *CreateCoroutine(asIScriptFunction *func) = 0;
+	virtual int                 ResumeCoroutine(asIScriptCoroutine *co) = 0;
+	virtual int                 YieldCoroutine() = 0;
+	virtual asIScriptCoroutine *GetCoroutine() const = 0;
+
+	// Asynchronous calls
+	virtual asIAsyncCall *BeginAsyncCall() = 0;
+	virtual asIAsyncCall *GetAsyncCall() const = 0;
+
+	// Saving and restoring a suspended execution
+	virtual int SaveExecutionState(asIBinaryStream *out, asIContextSerializer *serializer) = 0;
+	virtual int LoadExecutionState(asIBinaryStream *in, asIContextSerializer *serializer) = 0;
+
 	// Object pointer for calling class methods
 	virtual int   SetObject(void *obj) = 0;
 
@@ -838,6 +876,66 @@ protected:
 	virtual ~asIScriptContext() {}
 };
 
+class asIScriptCoroutine
+{
+public:
+	// Memory management
+	virtual int AddRef() const = 0;
+	virtual int Release() const = 0;
+
+	// Miscellaneous
+	virtual asIScriptContext  *GetContext() const = 0;
+	virtual asIScriptFunction *GetFunction() const = 0;
+	virtual asEContextState    GetState() const = 0;
+
+	// Arguments
+	virtual int   SetArgDWord(asUINT arg, asDWORD value) = 0;
+	virtual int   SetArgQWord(asUINT arg, asQWORD value) = 0;
+	virtual int   SetArgObject(asUINT arg, void *obj) = 0;
+	virtual void *GetAddressOfArg(asUINT arg) = 0;
+
+	// User data
+	virtual void *SetUserData(void *data) = 0;
+	virtual void *GetUserData() const = 0;
+
+protected:
+	virtual ~asIScriptCoroutine() {}
+};
+
+class asIAsyncCall
+{
+public:
+	// Memory management
+	virtual int AddRef() const = 0;
+	virtual int Release() const = 0;
+
+	// Miscellaneous
+	virtual asIScriptContext  *GetContext() const = 0;
+	virtual asIScriptFunction *GetFunction() const = 0;
+	virtual bool               IsCompleted() const = 0;
+
+	// Return value
+	virtual int SetReturnByte(asBYTE val) = 0;
+	virtual int SetReturnWord(asWORD val) = 0;
+	virtual int SetReturnDWord(asDWORD val) = 0;
+	virtual int SetReturnQWord(asQWORD val) = 0;
+	virtual int SetReturnFloat(float val) = 0;
+	virtual int SetReturnDouble(double val) = 0;
+	virtual int SetReturnAddress(void *addr) = 0;
+	virtual int SetReturnObject(void *obj) = 0;
+
+	// Completion
+	virtual int Complete() = 0;
+	virtual int CompleteWithException(const char *info) = 0;
+
+	// User data
+	virtual void *SetUserData(void *data) = 0;
+	virtual void *GetUserData() const = 0;
+
+protected:
+	virtual ~asIAsyncCall() {}
+};
+
 class asIScriptGeneric
 {
 public:
@@ -866,6 +964,7 @@ public:
 	virtual void   *GetArgAddress(asUINT arg) = 0;
 	virtual void   *GetArgObject(asUINT arg) = 0;
 	virtual void   *GetAddressOfArg(asUINT arg) = 0;
+	virtual void   *GetAddressOfArgs() = 0;
 
 	// Return value
 	virtual int     GetReturnTypeId() const = 0;
@@ -1002,6 +1101,7 @@ public:
 	virtual bool             IsFinal() const = 0;
 	virtual bool             IsOverride() const = 0;
 	virtual bool             IsShared() const = 0;
+	virtual bool             IsPure() const = 0;
 	virtual asUINT           GetParamCount() const = 0;
 	virtual int              GetParamTypeId(asUINT index, asDWORD *flags = 0) const = 0;
 	virtual int              GetReturnTypeId() const = 0;
@@ -1018,6 +1118,7 @@ public:
 
 	// For JIT compilation
 	virtual asDWORD         *GetByteCode(asUINT *length = 0) = 0;
+	virtual bool             IsByteCodeVerified() const = 0;
 
 	// User data
 	virtual void            *SetUserData(void *userData) = 0;
@@ -1037,6 +1138,16 @@ public:
 	virtual ~asIBinaryStream() {}
 };
 
+class asIContextSerializer
+{
+public:
+	virtual int   SaveObject(asIBinaryStream *out, void *obj, int typeId) = 0;
+	virtual void *LoadObject(asIBinaryStream *in, void *mem, int typeId) = 0;
+
+public:
+	virtual ~asIContextSerializer() {}
+};
+
 //-----------------------------------------------------------------
 // Function pointers
 
@@ -1419,8 +1530,9 @@ enum asEBCInstr
 	asBC_RefCpyV		= 186,
 	asBC_JLowZ			= 187,
 	asBC_JLowNZ			= 188,
+	asBC_TAILCALL		= 189,
 
-	asBC_MAXBYTECODE	= 189,
+	asBC_MAXBYTECODE	= 190,
 
 	// Temporary tokens. Can't be output to the final program
 	asBC_VarDecl		= 251,
@@ -1701,8 +1813,8 @@ const asSBCInfo asBCInfo[256] =
 	asBCINFO(RefCpyV,	wW_PTR_ARG,		0),
 	asBCINFO(JLowZ,		DW_ARG,			0),
 	asBCINFO(JLowNZ,	DW_ARG,			0),
+	asBCINFO(TAILCALL,	DW_ARG,			0xFFFF),
 
-	asBCINFO_DUMMY(189),
 	asBCINFO_DUMMY(190),
 	asBCINFO_DUMMY(191),
 	asBCINFO_DUMMY(192),
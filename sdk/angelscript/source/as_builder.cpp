@@ -85,6 +85,10 @@ asCBuilder::asCBuilder(asCScriptEngine *engine, asCModule *module)
 {
 	this->engine = engine;
 	this->module = module;
+
+#ifndef AS_NO_COMPILER
+	pureFunctionContext = 0;
+#endif
 }
 
 asCBuilder::~asCBuilder()
@@ -92,6 +96,9 @@ asCBuilder::~asCBuilder()
 #ifndef AS_NO_COMPILER
 	asUINT n;
 
+	if( pureFunctionContext )
+		pureFunctionContext->Release();
+
 	// Free all functions
 	for( n = 0; n < functions.GetLength(); n++ )
 	{
@@ -4763,6 +4770,19 @@ int asCBuilder::GetEnumValue(const char *name, asCDataType &outDt, asDWORD &outV
 	return 0;
 }
 
+asIScriptContext *asCBuilder::GetPureFunctionContext()
+{
+	// The same context is reused for all the calls to pure functions in the build
+	if( pureFunctionContext == 0 )
+		pureFunctionContext = engine->CreateContext();
+
+	// A pure function that compiles code would use the context while it is active
+	else if( pureFunctionContext->GetState() == asEXECUTION_ACTIVE )
+		return 0;
+
+	return pureFunctionContext;
+}
+
 #endif // AS_NO_COMPILER
 
 END_AS_NAMESPACE
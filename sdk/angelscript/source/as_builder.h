@@ -236,6 +236,7 @@ protected:
 	void               CompileGlobalVariables();
 	int                GetEnumValueFromObjectType(asCObjectType *objType, const char *name, asCDataType &outDt, asDWORD &outValue);
 	int                GetEnumValue(const char *name, asCDataType &outDt, asDWORD &outValue, asSNameSpace *ns);
+	asIScriptContext  *GetPureFunctionContext();
 
 	asCArray<asCScriptCode *>                  scripts;
 	asCArray<sFunctionDescription *>           functions;
@@ -245,6 +246,9 @@ protected:
 	asCArray<sClassDeclaration *>              namedTypeDeclarations;
 	asCArray<sFuncDef *>                       funcDefs;
 	asCArray<sMixinClass *>                    mixinClasses;
+
+	// The context used for evaluating the calls to pure functions during the build
+	asIScriptContext                          *pureFunctionContext;
 #endif
 };
 
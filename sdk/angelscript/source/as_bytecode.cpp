@@ -1164,6 +1164,81 @@ void asCByteCode::Optimize()
 				instr = GoBack(DeleteInstruction(curr));
 		}
 	}
+
+	// CALL, (CpyRtoV, CpyVtoR), (JMP), RET -> TAILCALL
+	// This is done after the other optimizations as they may remove instructions that follow the call
+	if( engine->ep.eliminateTailCalls )
+	{
+		for( instr = first; instr; instr = instr->next )
+			if( instr->op == asBC_CALL && IsTailCall(instr) )
+				instr->op = asBC_TAILCALL;
+	}
+}
+
+bool asCByteCode::IsTailCall(asCByteInstruction *curr)
+{
+	// The frame of the current function is reused by the called function, so the
+	// arguments cannot refer to anything on it and the value cannot be returned in it
+	asCScriptFunction *func = engine->scriptFunctions[*(int*)ARG_DW(curr->arg)];
+	if( func == 0 || func->funcType != asFUNC_SCRIPT || func->DoesReturnOnStack() )
+		return false;
+	for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
+		if( func->parameterTypes[n].IsReference() )
+			return false;
+
+	// The call is in tail position if nothing but the return follows it. The value
+	// returned by the called function may be passed through a temporary variable
+	// on the way, and the return statement may jump to the end of the function.
+	// The instructions after the call are kept for the initial function, which
+	// has no caller that the called function can return to.
+	int jumps = 0;
+	asCByteInstruction *copy = 0;
+	asCByteInstruction *instr = curr->next;
+	while( instr )
+	{
+		switch( instr->op )
+		{
+		case asBC_RET:
+			return copy == 0;
+
+		case asBC_CpyRtoV4:
+		case asBC_CpyRtoV8:
+			if( copy )
+				return false;
+			copy = instr;
+			break;
+
+		case asBC_CpyVtoR4:
+		case asBC_CpyVtoR8:
+			if( copy == 0 ||
+				instr->op != (copy->op == asBC_CpyRtoV4 ? asBC_CpyVtoR4 : asBC_CpyVtoR8) ||
+				instr->wArg[0] != copy->wArg[0] )
+				return false;
+			copy = 0;
+			break;
+
+		case asBC_JMP:
+			if( ++jumps > 2 || FindLabel(*(int*)ARG_DW(instr->arg), instr, &instr, 0) < 0 )
+				return false;
+			break;
+
+		case asBC_LABEL:
+		case asBC_LINE:
+		case asBC_SUSPEND:
+		case asBC_Block:
+		case asBC_ObjInfo:
+		case asBC_VarDecl:
+		case asBC_JitEntry:
+			break;
+
+		default:
+			return false;
+		}
+
+		instr = instr->next;
+	}
+
+	return false;
 }
 
 bool asCByteCode::IsTempVarReadByInstr(asCByteInstruction *curr, int offset)
@@ -1368,6 +1443,7 @@ bool asCByteCode::IsTempRegUsed(asCByteInstruction *curr)
 
 		// Which instructions overwrite the register or discard the value?
 		if( curr->op == asBC_CALL      ||
+			curr->op == asBC_TAILCALL  ||
 			curr->op == asBC_PopRPtr   ||
 			curr->op == asBC_CALLSYS   ||
 			curr->op == asBC_CALLBND   ||
@@ -1419,6 +1495,7 @@ bool asCByteCode::IsSimpleExpression()
 	{
 		if( instr->op == asBC_ALLOC ||
 			instr->op == asBC_CALL ||
+			instr->op == asBC_TAILCALL ||
 			instr->op == asBC_CALLSYS ||
 			instr->op == asBC_SUSPEND ||
 			instr->op == asBC_LINE ||
@@ -2169,6 +2246,7 @@ void asCByteCode::DebugOutput(const char *name, asCScriptEngine *engine, asCScri
 				break;
 
 			case asBC_CALL:
+			case asBC_TAILCALL:
 			case asBC_CALLSYS:
 			case asBC_CALLBND:
 			case asBC_CALLINTF:
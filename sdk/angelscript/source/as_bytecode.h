@@ -154,6 +154,7 @@ protected:
 	bool IsTempVarReadByInstr(asCByteInstruction *curr, int var);
 	bool IsTempVarOverwrittenByInstr(asCByteInstruction *curr, int var);
 	bool IsInstrJmpOrLabel(asCByteInstruction *curr);
+	bool IsTailCall(asCByteInstruction *curr);
 
 	int AddInstruction();
 	int AddInstructionFirst();
@@ -355,6 +355,11 @@ int PrepareSystemFunction(asCScriptFunction *func, asSSystemFunctionInterface *i
 		}
 	}
 
+#if defined(AS_X64_GCC) && !defined(AS_MAX_PORTABILITY) && !defined(AS_NO_CALL_TRAMPOLINES)
+	// Determine if the function can be called without the generic marshalling of the arguments
+	PrepareSystemFunctionX64(func, internal);
+#endif
+
 	return 0;
 }
 
@@ -54,6 +54,10 @@ int PrepareSystemFunctionGeneric(asCScriptFunction *func, asSSystemFunctionInter
 
 int PrepareSystemFunction(asCScriptFunction *func, asSSystemFunctionInterface *internal, asCScriptEngine *engine);
 
+#if defined(AS_X64_GCC) && !defined(AS_MAX_PORTABILITY) && !defined(AS_NO_CALL_TRAMPOLINES)
+void PrepareSystemFunctionX64(asCScriptFunction *func, asSSystemFunctionInterface *internal);
+#endif
+
 int CallSystemFunction(int id, asCContext *context, void *objectPointer);
 
 inline asPWORD FuncPtrToUInt(asFUNCTION_t func)
@@ -102,7 +106,22 @@ struct asSSystemFunctionInterface
 	bool                 hasAutoHandles;
 	void                *objForThiscall;
 
-	asSSystemFunctionInterface() {}
+	// The register arguments for the platforms that can
+	// call functions with simple signatures directly
+	bool                 useTrampoline;
+	asCArray<asDWORD>    trampolineIntArgs;
+	asCArray<asDWORD>    trampolineFloatArgs;
+
+	// Accessors registered with RegisterObjectFieldAccessor
+	// only read or write the field at this offset
+	bool                 isFieldAccessor;
+	int                  fieldOffset;
+
+	// Pure functions have no side effects and can be
+	// evaluated by the compiler if the args are constant
+	bool                 isPure;
+
+	asSSystemFunctionInterface() : useTrampoline(false), isFieldAccessor(false), fieldOffset(0) {}
 
 	asSSystemFunctionInterface(const asSSystemFunctionInterface &in)
 	{
@@ -111,19 +130,25 @@ struct asSSystemFunctionInterface
 
 	asSSystemFunctionInterface &operator=(const asSSystemFunctionInterface &in)
 	{
-		func               = in.func;
-		baseOffset         = in.baseOffset;
-		callConv           = in.callConv;
-		scriptReturnSize   = in.scriptReturnSize;
-		hostReturnInMemory = in.hostReturnInMemory;
-		hostReturnFloat    = in.hostReturnFloat;
-		hostReturnSize     = in.hostReturnSize;
-		paramSize          = in.paramSize;
-		takesObjByVal      = in.takesObjByVal;
-		paramAutoHandles   = in.paramAutoHandles;
-		returnAutoHandle   = in.returnAutoHandle;
-		hasAutoHandles     = in.hasAutoHandles;
-		objForThiscall     = in.objForThiscall;
+		func                = in.func;
+		baseOffset          = in.baseOffset;
+		callConv            = in.callConv;
+		scriptReturnSize    = in.scriptReturnSize;
+		hostReturnInMemory  = in.hostReturnInMemory;
+		hostReturnFloat     = in.hostReturnFloat;
+		hostReturnSize      = in.hostReturnSize;
+		paramSize           = in.paramSize;
+		takesObjByVal       = in.takesObjByVal;
+		paramAutoHandles    = in.paramAutoHandles;
+		returnAutoHandle    = in.returnAutoHandle;
+		hasAutoHandles      = in.hasAutoHandles;
+		objForThiscall      = in.objForThiscall;
+		useTrampoline       = in.useTrampoline;
+		trampolineIntArgs   = in.trampolineIntArgs;
+		trampolineFloatArgs = in.trampolineFloatArgs;
+		isFieldAccessor     = in.isFieldAccessor;
+		fieldOffset         = in.fieldOffset;
+		isPure              = in.isPure;
 		return *this;
 	}
 };
@@ -151,6 +151,117 @@ static inline bool IsVariableArgument( asCDataType type )
 	return ( type.GetTokenType() == ttQuestion ) ? true : false;
 }
 
+#ifndef AS_NO_CALL_TRAMPOLINES
+
+// The trampolines are used for functions that take all their arguments in registers
+// and return the value in RAX or XMM0. The registers are loaded from the precomputed
+// argument list, so the types don't have to be examined on each call, and the call
+// itself is made by X64_CallFunction. Each argument is described with its source
+// in the lower 2 bits and the offset on the script stack in the remaining bits.
+enum x64ArgSource { x64SRC_DWORD = 0, x64SRC_QWORD = 1, x64SRC_OBJECT = 2, x64SRC_RETPOINTER = 3 };
+
+void PrepareSystemFunctionX64(asCScriptFunction *descr, asSSystemFunctionInterface *sysFunc)
+{
+	sysFunc->useTrampoline = false;
+	sysFunc->trampolineIntArgs.SetLength(0);
+	sysFunc->trampolineFloatArgs.SetLength(0);
+
+	// Objects passed by value and values returned in two registers need the generic code
+	if( sysFunc->takesObjByVal ||
+		(!sysFunc->hostReturnInMemory && sysFunc->hostReturnSize > 2) )
+		return;
+
+	asCArray<asDWORD> &intArgs   = sysFunc->trampolineIntArgs;
+	asCArray<asDWORD> &floatArgs = sysFunc->trampolineFloatArgs;
+
+	// The hidden arguments are placed in the same order as in CallSystemFunctionNative
+	int callConv = sysFunc->callConv;
+	if( sysFunc->hostReturnInMemory )
+	{
+		callConv++;
+		intArgs.PushLast(x64SRC_RETPOINTER);
+	}
+	if( callConv == ICC_THISCALL || callConv == ICC_THISCALL_RETURNINMEM ||
+		callConv == ICC_VIRTUAL_THISCALL || callConv == ICC_VIRTUAL_THISCALL_RETURNINMEM ||
+		callConv == ICC_CDECL_OBJFIRST || callConv == ICC_CDECL_OBJFIRST_RETURNINMEM )
+		intArgs.PushLast(x64SRC_OBJECT);
+
+	asDWORD pos = 0;
+	for( asUINT a = 0; a < descr->parameterTypes.GetLength(); a++ )
+	{
+		const asCDataType &parmType = descr->parameterTypes[a];
+		if( parmType.IsFloatType() && !parmType.IsReference() )
+		{
+			floatArgs.PushLast((pos << 2) | x64SRC_DWORD);
+			pos++;
+		}
+		else if( parmType.IsDoubleType() && !parmType.IsReference() )
+		{
+			floatArgs.PushLast((pos << 2) | x64SRC_QWORD);
+			pos += 2;
+		}
+		else if( IsVariableArgument( parmType ) )
+		{
+			// The variable args are really two, one pointer and one type id
+			intArgs.PushLast((pos << 2) | x64SRC_QWORD);
+			intArgs.PushLast(((pos + 2) << 2) | x64SRC_DWORD);
+			pos += 3;
+		}
+		else
+		{
+			// Only primitives, references, and handles remain as objects by value were excluded above
+			if( parmType.GetSizeOnStackDWords() == 1 )
+				intArgs.PushLast((pos << 2) | x64SRC_DWORD);
+			else
+				intArgs.PushLast((pos << 2) | x64SRC_QWORD);
+			pos += parmType.GetSizeOnStackDWords();
+		}
+	}
+
+	if( callConv == ICC_CDECL_OBJLAST || callConv == ICC_CDECL_OBJLAST_RETURNINMEM )
+		intArgs.PushLast(x64SRC_OBJECT);
+
+	// Arguments that must be passed on the stack need the generic code
+	if( intArgs.GetLength() > MAX_CALL_INT_REGISTERS ||
+		floatArgs.GetLength() > MAX_CALL_SSE_REGISTERS )
+	{
+		intArgs.SetLength(0);
+		floatArgs.SetLength(0);
+		return;
+	}
+
+	sysFunc->useTrampoline = true;
+}
+
+static inline asQWORD GetTrampolineArg(asDWORD src, const asDWORD *args, void *obj, void *retPointer)
+{
+	switch( src & 3 )
+	{
+	case x64SRC_DWORD:  return *(asDWORD*)(args + (src >> 2));
+	case x64SRC_QWORD:  return *(asQWORD*)(args + (src >> 2));
+	case x64SRC_OBJECT: return (asPWORD)obj;
+	default:            return (asPWORD)retPointer;
+	}
+}
+
+static asQWORD CallTrampoline(asSSystemFunctionInterface *sysFunc, funcptr_t func, void *obj, const asDWORD *args, void *retPointer, asQWORD &retQW2)
+{
+	// The arguments are placed directly where X64_CallFunction loads the registers from,
+	// i.e. the integer registers first followed by the floating point registers. The
+	// floats are passed in the lower bits of the registers so the bits are copied as they are.
+	asQWORD regs[MAX_CALL_INT_REGISTERS + MAX_CALL_SSE_REGISTERS] = { 0 };
+	asUINT n;
+	for( n = 0; n < sysFunc->trampolineIntArgs.GetLength(); n++ )
+		regs[n] = GetTrampolineArg(sysFunc->trampolineIntArgs[n], args, obj, retPointer);
+	for( n = 0; n < sysFunc->trampolineFloatArgs.GetLength(); n++ )
+		regs[MAX_CALL_INT_REGISTERS + n] = GetTrampolineArg(sysFunc->trampolineFloatArgs[n], args, obj, retPointer);
+
+	// No arguments are passed on the stack
+	return X64_CallFunction(regs, 0, func, retQW2, sysFunc->hostReturnFloat);
+}
+
+#endif // AS_NO_CALL_TRAMPOLINES
+
 asQWORD CallSystemFunctionNative(asCContext *context, asCScriptFunction *descr, void *obj, asDWORD *args, void *retPointer, asQWORD &retQW2)
 {
 	asCScriptEngine            *engine             = context->m_engine;
@@ -178,6 +289,12 @@ asQWORD CallSystemFunctionNative(asCContext *context, asCScriptFunction *descr,
 		func = vftable[FuncPtrToUInt(asFUNCTION_t(func)) >> 3];
 	}
 
+#ifndef AS_NO_CALL_TRAMPOLINES
+	// Functions with simple signatures are called directly with the arguments prepared in PrepareSystemFunctionX64
+	if( sysFunc->useTrampoline )
+		return CallTrampoline(sysFunc, func, obj, args, retPointer, retQW2);
+#endif
+
 	// Determine the type of the arguments, and prepare the input array for the X64_CallFunction 
 	asQWORD  paramBuffer[X64_CALLSTACK_SIZE] = { 0 };
 	asBYTE	 argsType[X64_CALLSTACK_SIZE] = { 0 };
@@ -164,7 +164,8 @@ int asCCompiler::CompileDefaultConstructor(asCBuilder *builder, asCScriptCode *s
 	int varSize = GetVariableOffset((int)variableAllocations.GetLength()) - 1;
 	outFunc->variableSpace = varSize;
 
-	FinalizeFunction();
+	if( FinalizeFunction() < 0 )
+		return -1;
 
 #ifdef AS_DEBUG
 	// DEBUG: output byte code
@@ -233,7 +234,8 @@ int asCCompiler::CompileFactory(asCBuilder *builder, asCScriptCode *script, asCS
 
 	byteCode.Ret(argDwords);
 
-	FinalizeFunction();
+	if( FinalizeFunction() < 0 )
+		return -1;
 
 	// Tell the virtual machine not to clean up parameters on exception
 	outFunc->dontCleanUpOnException = true;
@@ -249,7 +251,7 @@ int asCCompiler::CompileFactory(asCBuilder *builder, asCScriptCode *script, asCS
 	return 0;
 }
 
-void asCCompiler::FinalizeFunction()
+int asCCompiler::FinalizeFunction()
 {
 	TimeIt("asCCompiler::FinalizeFunction");
 
@@ -287,6 +289,7 @@ void asCCompiler::FinalizeFunction()
 			}
 		}
 	}
+	outFunc->ComputeLiveObjectRanges();
 
 	// Copy byte code to the function
 	asASSERT( outFunc->byteCode.GetLength() == 0 );
@@ -307,6 +310,30 @@ void asCCompiler::FinalizeFunction()
 			outFunc->sectionIdxs.PushLast(lastIdx);
 		}
 	}
+
+	// Verify the produced bytecode if the application asked for it, see asEP_VERIFY_BYTECODE.
+	// There is no need to do it if the build has already failed, as the code will be discarded
+	if( engine->ep.verifyByteCode && builder->numErrors == 0 )
+	{
+		// The build must fail if the verification fails, so the error is counted by the builder
+		int stackSize;
+		if( outFunc->VerifyByteCode(&stackSize) < 0 )
+		{
+			builder->numErrors++;
+			return -1;
+		}
+		if( stackSize > outFunc->stackNeeded )
+		{
+			asCString msg;
+			msg.Format(TXT_FUNC_s_FAILED_VERIFICATION_s_d, outFunc->GetDeclaration(), TXT_VERIFY_STACK_OVERFLOW, 0);
+			engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, msg.AddressOf());
+			outFunc->isByteCodeVerified = false;
+			builder->numErrors++;
+			return -1;
+		}
+	}
+
+	return 0;
 }
 
 // internal
@@ -684,7 +711,8 @@ int asCCompiler::CompileFunction(asCBuilder *builder, asCScriptCode *script, asC
 
 	byteCode.Ret(-stackPos);
 
-	FinalizeFunction();
+	if( FinalizeFunction() < 0 )
+		return -1;
 
 #ifdef AS_DEBUG
 	// DEBUG: output byte code
@@ -1134,7 +1162,8 @@ int asCCompiler::CompileGlobalVariable(asCBuilder *builder, asCScriptCode *scrip
 
 	byteCode.Ret(0);
 
-	FinalizeFunction();
+	if( FinalizeFunction() < 0 )
+		return -1;
 
 #ifdef AS_DEBUG
 	// DEBUG: output byte code
@@ -3418,8 +3447,10 @@ void asCCompiler::CompileExpressionStatement(asCScriptNode *enode, asCByteCode *
 		if( !hasCompileErrors )
 			ProcessPropertyGetAccessor(&expr, enode);
 
-		// Pop the value from the stack
-		if( !expr.type.dataType.IsPrimitive() )
+		// Pop the value from the stack. The name of a global function by itself 
+		// hasn't pushed anything yet, as it is evaluated only when it is used
+		if( !expr.type.dataType.IsPrimitive() && 
+			!(expr.type.IsNullConstant() && expr.methodName != "") )
 			expr.bc.Instr(asBC_PopPtr);
 
 		// Release temporary variables used by expression
@@ -9202,6 +9233,19 @@ int asCCompiler::FindPropertyAccessor(const asCString &name, asSExprContext *ctx
 		}
 	}
 
+	// Accessors registered with RegisterObjectFieldAccessor are aliases for a field
+	// in the object, so the field is accessed directly through the property instead.
+	// This is only done when the getter is an alias, since reading the property must
+	// otherwise fail, and the setter must also be an alias if there is one.
+	if( ctx->type.dataType.IsObject() && arg == 0 && getId )
+	{
+		asCScriptFunction *getFunc = builder->GetFunctionDescription(getId);
+		asCScriptFunction *setFunc = setId ? builder->GetFunctionDescription(setId) : 0;
+		if( getFunc->sysFuncIntf && getFunc->sysFuncIntf->isFieldAccessor &&
+			(setFunc == 0 || (setFunc->sysFuncIntf && setFunc->sysFuncIntf->isFieldAccessor)) )
+			return 0;
+	}
+
 	// Check for type compatibility between get and set accessor
 	if( getId && setId )
 	{
@@ -9411,6 +9455,14 @@ void asCCompiler::ProcessPropertyGetAccessor(asSExprContext *ctx, asCScriptNode
 		// Raise error on missing accessor
 		Error(TXT_PROPERTY_HAS_NO_GET_ACCESSOR, node);
 		ctx->type.SetDummy();
+
+		// The set accessor must not be used for the dummy value either
+		ctx->property_set = 0;
+		if( ctx->property_arg )
+		{
+			asDELETE(ctx->property_arg, asSExprContext);
+			ctx->property_arg = 0;
+		}
 		return;
 	}
 
@@ -10433,8 +10485,13 @@ int asCCompiler::CompileOverloadedDualOperator2(asCScriptNode *node, const char
 	return 0;
 }
 
-void asCCompiler::MakeFunctionCall(asSExprContext *ctx, int funcId, asCObjectType *objectType, asCArray<asSExprContext*> &args, asCScriptNode * /*node*/, bool useVariable, int stackOffset, int funcPtrVar)
+void asCCompiler::MakeFunctionCall(asSExprContext *ctx, int funcId, asCObjectType *objectType, asCArray<asSExprContext*> &args, asCScriptNode *node, bool useVariable, int stackOffset, int funcPtrVar)
 {
+	// Calls to pure functions with constant arguments are evaluated at compile time
+	if( objectType == 0 && funcPtrVar == 0 && !useVariable &&
+		EvaluatePureFunctionCall(ctx, funcId, args, node) )
+		return;
+
 	if( objectType )
 	{
 		Dereference(ctx, true);
@@ -10508,6 +10565,60 @@ void asCCompiler::MakeFunctionCall(asSExprContext *ctx, int funcId, asCObjectTyp
 	PerformFunctionCall(funcId, ctx, false, &args, 0, useVariable, stackOffset, funcPtrVar);
 }
 
+bool asCCompiler::EvaluatePureFunctionCall(asSExprContext *ctx, int funcId, asCArray<asSExprContext*> &args, asCScriptNode *node)
+{
+	asCScriptFunction *func = builder->GetFunctionDescription(funcId);
+	if( !func->IsPure() || ctx->bc.GetLastInstr() != -1 )
+		return false;
+
+	// All the args must be constants that can be converted to the parameter types. The
+	// conversion is done without the node so no warnings are reported in case the function
+	// can't be evaluated, as the same conversion will then be done again for the call
+	asCArray<asQWORD> values;
+	asUINT n;
+	for( n = 0; n < args.GetLength(); n++ )
+	{
+		if( !args[n]->type.isConstant || args[n]->bc.GetLastInstr() != -1 )
+			return false;
+
+		asSExprContext arg(engine);
+		arg.type = args[n]->type;
+		ImplicitConversion(&arg, func->parameterTypes[n], 0, asIC_IMPLICIT_CONV, false);
+		if( !arg.type.isConstant || !arg.type.dataType.IsEqualExceptRefAndConst(func->parameterTypes[n]) )
+			return false;
+
+		values.PushLast(arg.type.qwordValue);
+	}
+
+	// Call the function as the application would
+	asIScriptContext *exec = builder->GetPureFunctionContext();
+	if( exec == 0 )
+		return false;
+
+	int r = exec->Prepare(func);
+	for( n = 0; r >= 0 && n < values.GetLength(); n++ )
+		memcpy(exec->GetAddressOfArg(n), &values[n], func->parameterTypes[n].GetSizeInMemoryBytes());
+	if( r >= 0 )
+		r = exec->Execute();
+
+	// If the function raised an exception it will be called at runtime instead
+	asQWORD value = 0;
+	if( r == asEXECUTION_FINISHED )
+		memcpy(&value, exec->GetAddressOfReturnValue(), func->returnType.GetSizeInMemoryBytes());
+	if( r != asEXECUTION_FINISHED )
+		return false;
+
+	// Report the warnings for the conversions of the args
+	for( n = 0; n < args.GetLength(); n++ )
+		ImplicitConversion(args[n], func->parameterTypes[n], node, asIC_IMPLICIT_CONV, false);
+
+	asCDataType dt = func->returnType;
+	dt.MakeReadOnly(true);
+	ctx->type.SetConstantQW(dt, value);
+
+	return true;
+}
+
 int asCCompiler::CompileOperator(asCScriptNode *node, asSExprContext *lctx, asSExprContext *rctx, asSExprContext *ctx)
 {
 	// Don't allow any operators on expressions that take address of class method, but allow it on global functions
@@ -94,6 +94,12 @@
 // AS_NO_EXCEPTIONS
 // Define this if exception handling is turned off or not available on the target platform.
 
+// AS_NO_CALL_TRAMPOLINES
+// On platforms where it is supported (currently only 64bit gcc) the library calls
+// registered functions with simple signatures directly, moving the arguments from
+// the script stack to the registers without the generic argument marshalling. Define
+// this flag to turn this off and always use the generic code.
+
 // AS_NO_MEMBER_INIT
 // Disable the support for initialization of class members directly in the declaration.
 // This was as a form to maintain backwards compatibility with versions before 2.26.0
@@ -61,6 +61,10 @@ const int RESERVE_STACK = 2*AS_PTR_SIZE;
 // For each script function call we push 5 PTRs on the call stack
 const int CALLSTACK_FRAME_SIZE = 5;
 
+// The first stack block of a co-routine is only as large as the entry function
+// needs, but never smaller than this. It grows like the context stack when needed
+const asUINT MIN_COROUTINE_STACK_SIZE = 64;
+
 
 #if defined(AS_DEBUG)
 
@@ -184,6 +188,12 @@ asCContext::asCContext(asCScriptEngine *engine, bool holdRef)
 	m_regs.doProcessSuspend     = false;
 	m_doSuspend                 = false;
 	m_userData                  = 0;
+	m_coroutine                 = 0;
+	m_coroutineList             = 0;
+	m_coroutineRequest          = 0;
+	m_yieldRequest              = false;
+	m_nestedLevel               = 0;
+	m_asyncCall                 = 0;
 	m_regs.ctx                  = this;
 }
 
@@ -256,6 +266,18 @@ void asCContext::DetachEngine()
 	}
 	while( IsNested() );
 
+	// Discard the co-routines that are still alive, while the engine is still available
+	while( m_coroutineList )
+	{
+		asCCoroutine *co = m_coroutineList;
+		co->AddRef();
+		if( co->m_status == asEXECUTION_PREPARED || co->m_status == asEXECUTION_SUSPENDED )
+			DiscardCoroutine(co);
+		co->FreeStack();
+		co->RemoveFromContext();
+		co->Release();
+	}
+
 	// Free the stack blocks
 	for( asUINT n = 0; n < m_stackBlocks.GetLength(); n++ )
 	{
@@ -338,6 +360,16 @@ int asCContext::Prepare(asIScriptFunction *func)
 		return asCONTEXT_ACTIVE;
 	}
 
+	// The stack size needed by the function is only known once the bytecode is loaded
+	asCScriptFunction *scriptFunc = reinterpret_cast<asCScriptFunction *>(func);
+	if( scriptFunc->isBodyPending && (scriptFunc->module == 0 || scriptFunc->module->LoadFunctionBody(scriptFunc) < 0) )
+	{
+		asCString str;
+		str.Format(TXT_FAILED_IN_FUNC_s_d, "Prepare", asERROR);
+		m_engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, str.AddressOf());
+		return asERROR;
+	}
+
 	// Clean the stack if not done before
 	if( m_status != asEXECUTION_FINISHED && m_status != asEXECUTION_UNINITIALIZED )
 		CleanStack();
@@ -1028,8 +1060,13 @@ int asCContext::Abort()
 	// TODO: multithread: Make thread safe. There is a chance that the status
 	//                    changes to something else after being set to ABORTED here.
 	if( m_status == asEXECUTION_SUSPENDED )
+	{
 		m_status = asEXECUTION_ABORTED;
 
+		// The application can no longer complete an asynchronous call
+		DiscardAsyncCall();
+	}
+
 	m_doSuspend = true;
 	m_regs.doProcessSuspend = true;
 	m_externalSuspendRequest = true;
@@ -1067,10 +1104,17 @@ int asCContext::Execute()
 		return asCONTEXT_NOT_PREPARED;
 	}
 
+	// A context that waits for an asynchronous call cannot continue until the call is completed
+	if( m_asyncCall && !m_asyncCall->IsCompleted() )
+		return asEXECUTION_SUSPENDED;
+
 	m_status = asEXECUTION_ACTIVE;
 
 	asPushActiveContext((asIScriptContext *)this);
 
+	if( m_asyncCall )
+		ResumeAfterAsyncCall();
+
 	if( m_regs.programPointer == 0 )
 	{
 		if( m_currentFunction->funcType == asFUNC_DELEGATE )
@@ -1137,6 +1181,11 @@ int asCContext::Execute()
 
 		if( m_currentFunction->funcType == asFUNC_SCRIPT )
 		{
+			// The real function of a delegate or virtual method may not have been loaded yet
+			if( m_currentFunction->isBodyPending && 
+				(m_currentFunction->module == 0 || m_currentFunction->module->LoadFunctionBody(m_currentFunction) < 0) )
+				SetInternalException(TXT_BYTECODE_NOT_LOADED);
+
 			m_regs.programPointer = m_currentFunction->byteCode.AddressOf();
 
 			// Set up the internal registers for executing the script function
@@ -1166,8 +1215,25 @@ int asCContext::Execute()
 	if( m_engine->ep.autoGarbageCollect )
 		m_engine->gc.GetStatistics(&gcPreObjects, 0, 0, 0, 0);
 
-	while( m_status == asEXECUTION_ACTIVE )
-		ExecuteNext();
+	for(;;)
+	{
+		while( m_status == asEXECUTION_ACTIVE )
+			ExecuteNext();
+
+		// There is no need to leave the VM if the asynchronous
+		// call was completed before the registered function returned
+		if( m_status == asEXECUTION_SUSPENDED && m_asyncCall && 
+			!m_externalSuspendRequest && m_asyncCall->IsCompleted() )
+		{
+			m_status = asEXECUTION_ACTIVE;
+			ResumeAfterAsyncCall();
+			continue;
+		}
+
+		// Switching between co-routines is done without leaving the VM
+		if( !ProcessCoroutineSwitch() )
+			break;
+	}
 
 	if( m_lineCallback )
 	{
@@ -1193,9 +1259,19 @@ int asCContext::Execute()
 		}
 	}
 
+	bool externalSuspend = m_externalSuspendRequest;
 	m_doSuspend = false;
+	m_externalSuspendRequest = false;
 	m_regs.doProcessSuspend = m_lineCallback;
 
+	// A co-routine switch that couldn't be done because of an exception is discarded
+	if( m_coroutineRequest )
+	{
+		m_coroutineRequest->Release();
+		m_coroutineRequest = 0;
+	}
+	m_yieldRequest = false;
+
 	asPopActiveContext((asIScriptContext *)this);
 
 	if( m_status == asEXECUTION_FINISHED )
@@ -1213,7 +1289,14 @@ int asCContext::Execute()
 	}
 
 	if( m_status == asEXECUTION_SUSPENDED )
+	{
+		// The thread is released while the context waits for the asynchronous call. This must
+		// be the last thing done, as the context may be resumed by another thread right away
+		if( m_asyncCall )
+			m_asyncCall->Wait(!externalSuspend);
+
 		return asEXECUTION_SUSPENDED;
+	}
 
 	if( m_status == asEXECUTION_EXCEPTION )
 		return asEXECUTION_EXCEPTION;
@@ -1267,6 +1350,8 @@ int asCContext::PushState()
 	// should call Prepare() after this to reuse the context
 	m_status = asEXECUTION_UNINITIALIZED;
 
+	m_nestedLevel++;
+
 	return asSUCCESS;
 }
 
@@ -1278,6 +1363,8 @@ int asCContext::PopState()
 	// Clean up the current execution
 	Unprepare();
 
+	m_nestedLevel--;
+
 	// The topmost state must be a marker for nested call
 	asASSERT( m_callStack[m_callStack.GetLength() - CALLSTACK_FRAME_SIZE] == 0 );
 
@@ -1305,872 +1392,2417 @@ int asCContext::PopState()
 	return asSUCCESS;
 }
 
-void asCContext::PushCallState()
+// interface
+asIScriptCoroutine *asCContext::CreateCoroutine(asIScriptFunction *func)
 {
-	if( m_callStack.GetLength() == m_callStack.GetCapacity() )
+	// Only global script functions that return void can be executed as co-routines
+	asCScriptFunction *coFunc = reinterpret_cast<asCScriptFunction*>(func);
+	if( coFunc == 0 || coFunc->engine != m_engine || coFunc->funcType != asFUNC_SCRIPT ||
+		coFunc->objectType || coFunc->returnType.GetTokenType() != ttVoid )
 	{
-		// Allocate space for 10 call states at a time to save time
-		m_callStack.AllocateNoConstruct(m_callStack.GetLength() + 10*CALLSTACK_FRAME_SIZE, true);
+		asCString str;
+		str.Format(TXT_FAILED_IN_FUNC_s_d, "CreateCoroutine", asINVALID_ARG);
+		m_engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, str.AddressOf());
+		return 0;
 	}
-	m_callStack.SetLengthNoConstruct(m_callStack.GetLength() + CALLSTACK_FRAME_SIZE);
 
-    // Separating the loads and stores limits data cache trash, and with a smart compiler
-    // could turn into SIMD style loading/storing if available.
-    // The compiler can't do this itself due to potential pointer aliasing between the pointers,
-    // ie writing to tmp could overwrite the data contained in registers.stackFramePointer for example
-    // for all the compiler knows. So introducing the local variable s, which is never referred to by
-    // its address we avoid this issue.
+	// The stack size needed by the function is only known once the bytecode is loaded
+	if( coFunc->isBodyPending && (coFunc->module == 0 || coFunc->module->LoadFunctionBody(coFunc) < 0) )
+	{
+		asCString str;
+		str.Format(TXT_FAILED_IN_FUNC_s_d, "CreateCoroutine", asERROR);
+		m_engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, str.AddressOf());
+		return 0;
+	}
 
-	asPWORD s[5];
-	s[0] = (asPWORD)m_regs.stackFramePointer;
-	s[1] = (asPWORD)m_currentFunction;
-	s[2] = (asPWORD)m_regs.programPointer;
-	s[3] = (asPWORD)m_regs.stackPointer;
-	s[4] = m_stackIndex;
+	asCCoroutine *co = asNEW(asCCoroutine)(this, coFunc);
+	if( co == 0 )
+		return 0;
 
-	asPWORD *tmp = m_callStack.AddressOf() + m_callStack.GetLength() - CALLSTACK_FRAME_SIZE;
-	tmp[0] = s[0];
-	tmp[1] = s[1];
-	tmp[2] = s[2];
-	tmp[3] = s[3];
-	tmp[4] = s[4];
+	if( !co->Prepare() )
+	{
+		co->Release();
+		return 0;
+	}
+
+	return co;
 }
 
-void asCContext::PopCallState()
+// interface
+int asCContext::ResumeCoroutine(asIScriptCoroutine *coroutine)
 {
-	// See comments in PushCallState about pointer aliasing and data cache trashing
-	asPWORD *tmp = m_callStack.AddressOf() + m_callStack.GetLength() - CALLSTACK_FRAME_SIZE;
-	asPWORD s[5];
-	s[0] = tmp[0];
-	s[1] = tmp[1];
-	s[2] = tmp[2];
-	s[3] = tmp[3];
-	s[4] = tmp[4];
+	asCCoroutine *co = reinterpret_cast<asCCoroutine*>(coroutine);
+	if( co == 0 || co->m_ctx != this )
+		return asINVALID_ARG;
 
-	m_regs.stackFramePointer = (asDWORD*)s[0];
-	m_currentFunction        = (asCScriptFunction*)s[1];
-	m_regs.programPointer    = (asDWORD*)s[2];
-	m_regs.stackPointer      = (asDWORD*)s[3];
-	m_stackIndex             = (int)s[4];
+	if( co->m_status == asEXECUTION_ACTIVE )
+		return asCONTEXT_ACTIVE;
 
-	m_callStack.SetLength(m_callStack.GetLength() - CALLSTACK_FRAME_SIZE);
+	if( co->m_status != asEXECUTION_PREPARED && co->m_status != asEXECUTION_SUSPENDED )
+		return asCONTEXT_NOT_PREPARED;
+
+	// Only one switch can be pending at a time, and not while waiting for an asynchronous call
+	if( m_coroutineRequest || m_yieldRequest || m_asyncCall )
+		return asERROR;
+
+	if( m_status == asEXECUTION_SUSPENDED )
+	{
+		// The state can be exchanged immediately, and the
+		// co-routine will start on the next call to Execute()
+		SwitchToCoroutine(co);
+		return asSUCCESS;
+	}
+
+	if( m_status != asEXECUTION_ACTIVE )
+		return asCONTEXT_NOT_PREPARED;
+
+	// The switch is done when the VM returns from the
+	// system function that is currently being called
+	co->AddRef();
+	m_coroutineRequest = co;
+	m_doSuspend = true;
+	m_regs.doProcessSuspend = true;
+
+	return asSUCCESS;
 }
 
 // interface
-asUINT asCContext::GetCallstackSize() const
+int asCContext::YieldCoroutine()
 {
-	if( m_currentFunction == 0 ) return 0;
+	// A co-routine cannot yield from within a nested call, as
+	// the state that resumed it is in an outer call to Execute()
+	if( m_coroutine == 0 || m_coroutine->m_resumeLevel != m_nestedLevel )
+		return asERROR;
 
-	// The current function is accessed at stackLevel 0
-	return asUINT(1 + m_callStack.GetLength() / CALLSTACK_FRAME_SIZE);
+	if( m_coroutineRequest || m_yieldRequest || m_asyncCall )
+		return asERROR;
+
+	if( m_status == asEXECUTION_SUSPENDED )
+	{
+		SwitchFromCoroutine(asEXECUTION_SUSPENDED);
+		return asSUCCESS;
+	}
+
+	if( m_status != asEXECUTION_ACTIVE )
+		return asCONTEXT_NOT_PREPARED;
+
+	m_yieldRequest = true;
+	m_doSuspend = true;
+	m_regs.doProcessSuspend = true;
+
+	return asSUCCESS;
 }
 
 // interface
-asIScriptFunction *asCContext::GetFunction(asUINT stackLevel)
+asIScriptCoroutine *asCContext::GetCoroutine() const
 {
-	if( stackLevel >= GetCallstackSize() ) return 0;
+	return m_coroutine;
+}
 
-	if( stackLevel == 0 ) return m_currentFunction;
+// interface
+asIAsyncCall *asCContext::BeginAsyncCall()
+{
+	// Only a registered function that is called directly from a script function can complete
+	// asynchronously, as the script must be able to continue right after the call. Objects
+	// returned by value cannot be supported since the native function has already initialized them
+	asCScriptFunction *func = m_callingSystemFunction;
+	asBYTE instr = m_regs.programPointer ? *(asBYTE*)m_regs.programPointer : asBYTE(asBC_MAXBYTECODE);
+	if( func == 0 || m_status != asEXECUTION_ACTIVE || m_asyncCall || IsNested() ||
+		m_coroutineRequest || m_yieldRequest || func->DoesReturnOnStack() ||
+		m_currentFunction->funcType != asFUNC_SCRIPT ||
+		(instr != asBC_CALLSYS && instr != asBC_CallPtr) )
+	{
+		asCString str;
+		str.Format(TXT_FAILED_IN_FUNC_s_d, "BeginAsyncCall", asERROR);
+		m_engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, str.AddressOf());
+		return 0;
+	}
 
-	asPWORD *s = m_callStack.AddressOf() + (GetCallstackSize() - stackLevel - 1)*CALLSTACK_FRAME_SIZE;
-	asCScriptFunction *func = (asCScriptFunction*)s[1];
+	asCAsyncCall *call = asNEW(asCAsyncCall)(this, func);
+	if( call == 0 )
+		return 0;
 
-	return func;
+	// The context holds one reference and the application the other
+	call->AddRef();
+	m_asyncCall = call;
+
+	// The execution is suspended as soon as the registered function returns
+	m_doSuspend = true;
+	m_regs.doProcessSuspend = true;
+
+	return call;
 }
 
 // interface
-int asCContext::GetLineNumber(asUINT stackLevel, int *column, const char **sectionName)
+asIAsyncCall *asCContext::GetAsyncCall() const
 {
-	if( stackLevel >= GetCallstackSize() ) return asINVALID_ARG;
+	return m_asyncCall;
+}
 
-	asCScriptFunction *func;
-	asDWORD *bytePos;
-	if( stackLevel == 0 )
-	{
-		func = m_currentFunction;
-		bytePos = m_regs.programPointer;
-	}
-	else
-	{
-		asPWORD *s = m_callStack.AddressOf() + (GetCallstackSize()-stackLevel-1)*CALLSTACK_FRAME_SIZE;
-		func = (asCScriptFunction*)s[1];
-		bytePos = (asDWORD*)s[2];
+// internal
+void asCContext::ResumeAfterAsyncCall()
+{
+	asCAsyncCall *call = m_asyncCall;
+	m_asyncCall = 0;
 
-		// Subract 1 from the bytePos, because we want the line where
-		// the call was made, and not the instruction after the call
-		bytePos -= 1;
-	}
+	m_doSuspend = m_externalSuspendRequest;
+	m_regs.doProcessSuspend = m_doSuspend || m_lineCallback;
 
-	// For nested calls it is possible that func is null
-	if( func == 0 )
+	// The value returned by the registered function itself is replaced with the result of the call
+	asCDataType &dt = call->m_function->returnType;
+	if( dt.IsObject() && !dt.IsReference() )
 	{
-		if( column ) *column = 0;
-		if( sectionName ) *sectionName = 0;
-		return 0;
+		if( m_regs.objectRegister )
+			m_engine->ReleaseScriptObject(m_regs.objectRegister, dt.GetObjectType());
+		m_regs.objectRegister = call->m_objectRegister;
+		call->m_objectRegister = 0;
 	}
+	else
+		m_regs.valueRegister = call->m_returnVal;
+	m_regs.objectType = dt.GetObjectType();
 
-	int sectionIdx;
-	asDWORD line = func->GetLineNumber(int(bytePos - func->byteCode.AddressOf()), &sectionIdx);
-	if( column ) *column = (line >> 20);
-	if( sectionName )
-	{
-		asASSERT( sectionIdx < int(m_engine->scriptSectionNames.GetLength()) );
-		if( sectionIdx >= 0 && asUINT(sectionIdx) < m_engine->scriptSectionNames.GetLength() )
-			*sectionName = m_engine->scriptSectionNames[sectionIdx]->AddressOf();
-		else
-			*sectionName = 0;
-	}
-	return (line & 0xFFFFF);
+	if( call->m_hasException )
+		SetInternalException(call->m_exceptionString.AddressOf());
+
+	bool holdsContextRef = call->TakeContextRef();
+	call->Release();
+	if( holdsContextRef )
+		Release();
 }
 
 // internal
-bool asCContext::ReserveStackSpace(asUINT size)
+void asCContext::DiscardAsyncCall()
 {
-	// Make sure the first stack block is allocated
-	if( m_stackBlocks.GetLength() == 0 )
-	{
-		m_stackBlockSize = m_engine->initialContextStackSize;
-		asASSERT( m_stackBlockSize > 0 );
+	if( m_asyncCall == 0 )
+		return;
 
-		asDWORD *stack = asNEWARRAY(asDWORD,m_stackBlockSize);
-		if( stack == 0 )
-		{
-			// Out of memory
-			return false;
-		}
+	asCAsyncCall *call = m_asyncCall;
+	m_asyncCall = 0;
 
-		m_stackBlocks.PushLast(stack);
-		m_stackIndex = 0;
-		m_regs.stackPointer = m_stackBlocks[0] + m_stackBlockSize;
-	}
+	// The application will be told that the context no longer waits when it tries to complete the call
+	bool holdsContextRef = call->Discard();
+	call->Release();
+	if( holdsContextRef )
+		Release();
+}
 
-	// Check if there is enough space on the current stack block, otherwise move
-	// to the next one. New and larger blocks will be allocated as necessary
-	while( m_regs.stackPointer - (size + RESERVE_STACK) < m_stackBlocks[m_stackIndex] )
-	{
-		// Make sure we don't allocate more space than allowed
-		if( m_engine->ep.maximumContextStackSize )
-		{
-			// This test will only stop growth once it has already crossed the limit
-			if( m_stackBlockSize * ((1 << (m_stackIndex+1)) - 1) > m_engine->ep.maximumContextStackSize )
-			{
-				m_isStackMemoryNotAllocated = true;
+// The saved execution refers to script functions by module and declaration, and
+// to objects through the application's serializer. References held by a function
+// can only be restored if they refer to something that is restored too, i.e. the
+// stack of a calling function, an object held by a calling function, or a global
+// variable in the module.
+enum asEStateRef
+{
+	asSTATE_REF_NULL   = 0,
+	asSTATE_REF_STACK  = 1,
+	asSTATE_REF_SLOT   = 2,
+	asSTATE_REF_GLOBAL = 3
+};
 
-				// Set the stackFramePointer, even though the stackPointer wasn't updated
-				m_regs.stackFramePointer = m_regs.stackPointer;
+struct asSStateFrame
+{
+	asCScriptFunction *func;
+	asDWORD           *stackFramePointer;
+};
 
-				SetInternalException(TXT_STACK_OVERFLOW);
-				return false;
-			}
-		}
+// The objects that have been restored are kept track of
+// so they can be destroyed again if the restore fails
+struct asSStateObject
+{
+	void          *obj;
+	asCObjectType *type;
+	asPWORD       *slot;
+};
 
-		m_stackIndex++;
-		if( m_stackBlocks.GetLength() == m_stackIndex )
-		{
-			// Allocate the new stack block, with twice the size of the previous
-			asDWORD *stack = asNEWARRAY(asDWORD,(m_stackBlockSize << m_stackIndex));
-			if( stack == 0 )
-			{
-				// Out of memory
-				m_isStackMemoryNotAllocated = true;
+static asUINT GetStateArgsSize(asCScriptFunction *func)
+{
+	return func->GetSpaceNeededForArguments() + (func->objectType ? AS_PTR_SIZE : 0) + (func->DoesReturnOnStack() ? AS_PTR_SIZE : 0);
+}
 
-				// Set the stackFramePointer, even though the stackPointer wasn't updated
-				m_regs.stackFramePointer = m_regs.stackPointer;
+// Methods hold a reference to the object once they have been entered,
+// except for constructors and methods that return a reference
+static bool IsStateThisOwned(asCScriptFunction *func, asUINT pos)
+{
+	if( pos == 0 || func->returnType.IsReference() )
+		return false;
 
-				SetInternalException(TXT_STACK_OVERFLOW);
-				return false;
-			}
-			m_stackBlocks.PushLast(stack);
-		}
+	asSTypeBehaviour &beh = func->objectType->beh;
+	return beh.construct != func->id && beh.constructors.IndexOf(func->id) < 0;
+}
 
-		// Update the stack pointer to point to the new block.
-		// Leave enough room above the stackpointer to copy the arguments from the previous stackblock
-		m_regs.stackPointer = m_stackBlocks[m_stackIndex] +
-			                  (m_stackBlockSize<<m_stackIndex) -
-			                  m_currentFunction->GetSpaceNeededForArguments() -
-			                  (m_currentFunction->objectType ? AS_PTR_SIZE : 0) -
-			                  (m_currentFunction->DoesReturnOnStack() ? AS_PTR_SIZE : 0);
+// The suspend instructions are placed between the statements, where no temporary
+// values that may refer to memory outside the context are held in the variables
+// or the value register. So the execution is only saved at these positions.
+static bool IsStateAtStatement(asCScriptFunction *func, asUINT pos)
+{
+	asDWORD *bc = func->byteCode.AddressOf();
+	asUINT length = func->byteCode.GetLength();
+
+	// Was the execution suspended by the line callback?
+	asUINT prev = 0;
+	for( asUINT n = 0; n < pos; n += asBCTypeSize[asBCInfo[*(asBYTE*)&bc[n]].type] )
+		prev = n;
+	if( pos > 0 && *(asBYTE*)&bc[prev] == asBC_SUSPEND )
+		return true;
+
+	// Otherwise the call that suspended the execution must complete the statement, which
+	// in a loop or condition is followed by a jump to the next statement
+	for( asUINT jumps = 0; pos < length && jumps < 4; jumps++ )
+	{
+		asBYTE c = *(asBYTE*)&bc[pos];
+		if( c == asBC_SUSPEND )
+			return true;
+		if( c != asBC_JMP )
+			break;
+		pos += asBCTypeSize[asBCInfo[asBC_JMP].type] + asBC_INTARG(&bc[pos]);
 	}
 
-	return true;
+	return false;
 }
 
-// internal
-void asCContext::CallScriptFunction(asCScriptFunction *func)
+static void WriteStateString(asIBinaryStream *out, const asCString &str)
 {
-	// Push the framepointer, function id and programCounter on the stack
-	PushCallState();
+	asUINT len = (asUINT)str.GetLength();
+	out->Write(&len, sizeof(len));
+	if( len )
+		out->Write(str.AddressOf(), len);
+}
 
-	// Update the current function and program position before increasing the stack
-	// so the exception handler will know what to do if there is a stack overflow
-	m_currentFunction = func;
-	m_regs.programPointer = m_currentFunction->byteCode.AddressOf();
+static void ReadStateString(asIBinaryStream *in, asCString &str)
+{
+	asUINT len = 0;
+	in->Read(&len, sizeof(len));
+	str.SetLength(len);
+	if( len )
+		in->Read(str.AddressOf(), len);
+}
 
-	// Make sure there is space on the stack to execute the function
-	asDWORD *oldStackPointer = m_regs.stackPointer;
-	if( !ReserveStackSpace(func->stackNeeded) )
-		return;
+static int WriteStateFunction(asIBinaryStream *out, asCScriptFunction *func)
+{
+	if( func->funcType != asFUNC_SCRIPT || func->module == 0 )
+		return asNOT_SUPPORTED;
 
-	// If a new stack block was allocated then we'll need to move
-	// over the function arguments to the new block
-	if( m_regs.stackPointer != oldStackPointer )
-	{
-		int numDwords = func->GetSpaceNeededForArguments() + (func->objectType ? AS_PTR_SIZE : 0) + (func->DoesReturnOnStack() ? AS_PTR_SIZE : 0);
-		memcpy(m_regs.stackPointer, oldStackPointer, sizeof(asDWORD)*numDwords);
-	}
+	int index = func->module->scriptFunctions.IndexOf(func);
+	if( index < 0 )
+		return asNOT_SUPPORTED;
 
-	PrepareScriptFunction();
+	WriteStateString(out, func->module->name);
+	WriteStateString(out, func->GetDeclarationStr(true, true));
+
+	asUINT idx = index;
+	asUINT length = func->byteCode.GetLength();
+	out->Write(&idx, sizeof(idx));
+	out->Write(&length, sizeof(length));
+
+	return asSUCCESS;
 }
 
-void asCContext::PrepareScriptFunction()
+static asCScriptFunction *ReadStateFunction(asCScriptEngine *engine, asIBinaryStream *in)
 {
-	// Update framepointer
-	m_regs.stackFramePointer = m_regs.stackPointer;
+	asCString modName, decl;
+	asUINT index = 0, length = 0;
+	ReadStateString(in, modName);
+	ReadStateString(in, decl);
+	in->Read(&index, sizeof(index));
+	in->Read(&length, sizeof(length));
+
+	asCModule *mod = engine->GetModule(modName.AddressOf(), false);
+	if( mod == 0 )
+		return 0;
 
-	// Set all object variables to 0 to guarantee that they are null before they are used
-	// Only variables on the heap should be cleared. The rest will be cleared by calling the constructor
-	asUINT n = m_currentFunction->objVariablesOnHeap;
-	while( n-- > 0 )
+	// Unless the module was built differently the function is found at the same index
+	asCScriptFunction *func = 0;
+	if( index < mod->scriptFunctions.GetLength() && mod->scriptFunctions[index]->GetDeclarationStr(true, true) == decl )
+		func = mod->scriptFunctions[index];
+	for( asUINT n = 0; func == 0 && n < mod->scriptFunctions.GetLength(); n++ )
 	{
-		int pos = m_currentFunction->objVariablePos[n];
-		*(asPWORD*)&m_regs.stackFramePointer[-pos] = 0;
+		if( mod->scriptFunctions[n]->GetDeclarationStr(true, true) == decl )
+			func = mod->scriptFunctions[n];
 	}
+	if( func == 0 || func->funcType != asFUNC_SCRIPT )
+		return 0;
 
-	// Initialize the stack pointer with the space needed for local variables
-	m_regs.stackPointer -= m_currentFunction->variableSpace;
+	// The bytecode must be loaded to verify that it is the same as when the execution was saved
+	if( func->isBodyPending && func->module->LoadFunctionBody(func) < 0 )
+		return 0;
+	if( func->byteCode.GetLength() != length )
+		return 0;
 
-	// Call the line callback for each script function, to guarantee that infinitely recursive scripts can
-	// be interrupted, even if the scripts have been compiled with asEP_BUILD_WITHOUT_LINE_CUES
-	if( m_regs.doProcessSuspend )
-	{
-		if( m_lineCallback )
-			CallLineCallback();
-		if( m_doSuspend )
-			m_status = asEXECUTION_SUSPENDED;
-	}
+	return func;
 }
 
-void asCContext::CallInterfaceMethod(asCScriptFunction *func)
+static int WriteStateRef(asIBinaryStream *out, void *ref, asCScriptFunction *func, const asCArray<asSStateFrame> &frames)
 {
-	// Resolve the interface method using the current script type
-	asCScriptObject *obj = *(asCScriptObject**)(asPWORD*)m_regs.stackPointer;
-	if( obj == 0 )
-	{
-		// Tell the exception handler to clean up the arguments to this method
-		m_needToCleanupArgs = true;
-		SetInternalException(TXT_NULL_POINTER_ACCESS);
-		return;
-	}
+	asBYTE kind = asSTATE_REF_NULL;
+	asUINT index = 0;
+	int offset = 0;
 
-	asCObjectType *objType = obj->objType;
+	// Search the calling functions, starting with the closest one
+	for( asUINT n = frames.GetLength(); ref && kind == asSTATE_REF_NULL && n-- > 0; )
+	{
+		asCScriptFunction *f = frames[n].func;
+		asDWORD *sf = frames[n].stackFramePointer;
+		index = n;
 
-	// TODO: runtime optimize: The object type should have a list of only those methods that
-	//                         implement interface methods. This list should be ordered by
-	//                         the signatureId so that a binary search can be made, instead
-	//                         of a linear search.
-	//
-	//                         When this is done, we must also make sure the signatureId of a
-	//                         function never changes, e.g. when if the signature functions are
-	//                         released.
+		// Is it an object held in a variable of the function?
+		for( asUINT v = 0; kind == asSTATE_REF_NULL && v < f->objVariablesOnHeap; v++ )
+		{
+			if( *(void**)(sf - f->objVariablePos[v]) == ref )
+			{
+				kind = asSTATE_REF_SLOT;
+				offset = -f->objVariablePos[v];
+			}
+		}
 
-	// Search the object type for a function that matches the interface function
-	asCScriptFunction *realFunc = 0;
-	if( func->funcType == asFUNC_INTERFACE )
-	{
-		for( asUINT n = 0; n < objType->methods.GetLength(); n++ )
+		// Or an object that was given to the function?
+		int pos = 0;
+		if( f->objectType )
 		{
-			asCScriptFunction *f2 = m_engine->scriptFunctions[objType->methods[n]];
-			if( f2->signatureId == func->signatureId )
+			if( kind == asSTATE_REF_NULL && *(void**)sf == ref )
 			{
-				if( f2->funcType == asFUNC_VIRTUAL )
-					realFunc = objType->virtualFunctionTable[f2->vfTableIdx];
-				else
-					realFunc = f2;
-				break;
+				kind = asSTATE_REF_SLOT;
+				offset = 0;
+			}
+			pos += AS_PTR_SIZE;
+		}
+		if( f->DoesReturnOnStack() )
+			pos += AS_PTR_SIZE;
+		for( asUINT p = 0; kind == asSTATE_REF_NULL && p < f->parameterTypes.GetLength(); p++ )
+		{
+			if( f->parameterTypes[p].IsObject() && !f->parameterTypes[p].IsReference() && *(void**)(sf + pos) == ref )
+			{
+				kind = asSTATE_REF_SLOT;
+				offset = pos;
 			}
+			pos += f->parameterTypes[p].GetSizeOnStackDWords();
 		}
 
-		if( realFunc == 0 )
+		// Or a location on the function's stack frame?
+		if( kind == asSTATE_REF_NULL && (asDWORD*)ref >= sf - f->variableSpace && (asDWORD*)ref < sf + pos )
 		{
-			// Tell the exception handler to clean up the arguments to this method
-			m_needToCleanupArgs = true;
-			SetInternalException(TXT_NULL_POINTER_ACCESS);
-			return;
+			kind = asSTATE_REF_STACK;
+			offset = int((asBYTE*)ref - (asBYTE*)sf);
 		}
 	}
-	else // if( func->funcType == asFUNC_VIRTUAL )
+
+	// Or a global variable?
+	for( asUINT g = 0; ref && kind == asSTATE_REF_NULL && g < func->module->GetGlobalVarCount(); g++ )
 	{
-		realFunc = objType->virtualFunctionTable[func->vfTableIdx];
+		if( func->module->GetAddressOfGlobalVar(g) == ref )
+		{
+			kind = asSTATE_REF_GLOBAL;
+			index = g;
+		}
 	}
 
-	// Then call the true script function
-	CallScriptFunction(realFunc);
+	if( ref && kind == asSTATE_REF_NULL )
+		return asNOT_SUPPORTED;
+
+	out->Write(&kind, sizeof(kind));
+	if( kind != asSTATE_REF_NULL )
+		out->Write(&index, sizeof(index));
+	if( kind == asSTATE_REF_STACK || kind == asSTATE_REF_SLOT )
+		out->Write(&offset, sizeof(offset));
+
+	return asSUCCESS;
 }
 
-void asCContext::ExecuteNext()
+static int ReadStateRef(asIBinaryStream *in, void **ref, asCScriptFunction *func, const asCArray<asSStateFrame> &frames)
 {
-	asDWORD *l_bc = m_regs.programPointer;
-	asDWORD *l_sp = m_regs.stackPointer;
-	asDWORD *l_fp = m_regs.stackFramePointer;
+	asBYTE kind = asSTATE_REF_NULL;
+	asUINT index = 0;
+	int offset = 0;
 
-	for(;;)
+	*ref = 0;
+	in->Read(&kind, sizeof(kind));
+	if( kind == asSTATE_REF_NULL )
+		return asSUCCESS;
+
+	in->Read(&index, sizeof(index));
+	if( kind == asSTATE_REF_GLOBAL )
 	{
+		if( index >= func->module->GetGlobalVarCount() )
+			return asERROR;
+		*ref = func->module->GetAddressOfGlobalVar(index);
+		return asSUCCESS;
+	}
 
-#ifdef AS_DEBUG
-	// Gather statistics on executed bytecode
-	stats.Instr(*(asBYTE*)l_bc);
+	in->Read(&offset, sizeof(offset));
+	if( index >= frames.GetLength() )
+		return asERROR;
 
-	// Used to verify that the size of the instructions are correct
-	asDWORD *old = l_bc;
-#endif
+	// The offset to a location on the stack is given in bytes, but the offset to an object slot in dwords
+	asDWORD *sf = frames[index].stackFramePointer;
+	if( kind == asSTATE_REF_STACK )
+		*ref = (asBYTE*)sf + offset;
+	else if( kind == asSTATE_REF_SLOT )
+		*ref = *(void**)(sf + offset);
+	else
+		return asERROR;
+
+	return asSUCCESS;
+}
 
+static int WriteStateObject(asCScriptEngine *engine, asIBinaryStream *out, asIContextSerializer *serializer, void *obj, asCObjectType *type)
+{
+	asBYTE hasObject = obj ? 1 : 0;
+	out->Write(&hasObject, sizeof(hasObject));
+	if( obj == 0 )
+		return asSUCCESS;
 
-	// Remember to keep the cases in order and without
-	// gaps, because that will make the switch faster.
-	// It will be faster since only one lookup will be
-	// made to find the correct jump destination. If not
-	// in order, the switch will make two lookups.
-	switch( *(asBYTE*)l_bc )
-	{
-//--------------
-// memory access functions
+	// Function handles cannot be saved
+	if( type == 0 )
+		return asNOT_SUPPORTED;
 
-	case asBC_PopPtr:
-		// Pop a pointer from the stack
-		l_sp += AS_PTR_SIZE;
-		l_bc++;
-		break;
+	int typeId = engine->GetTypeIdFromDataType(asCDataType::CreateObject(type, false));
+	int r = serializer->SaveObject(out, obj, typeId);
+	return r < 0 ? r : asSUCCESS;
+}
 
-	case asBC_PshGPtr:
-		// Replaces PGA + RDSPtr
-		l_sp -= AS_PTR_SIZE;
-		*(asPWORD*)l_sp = *(asPWORD*)asBC_PTRARG(l_bc);
-		l_bc += 1 + AS_PTR_SIZE;
-		break;
+// Value types are constructed by the serializer in the given memory, while
+// reference types are returned with a reference that the context will own
+static int ReadStateObject(asCScriptEngine *engine, asIBinaryStream *in, asIContextSerializer *serializer, asCObjectType *type, void *mem, asPWORD *slot, asCArray<asSStateObject> &objects)
+{
+	asBYTE hasObject = 0;
+	in->Read(&hasObject, sizeof(hasObject));
+	if( hasObject == 0 )
+		return asSUCCESS;
+	if( type == 0 )
+		return asERROR;
 
-	// Push a dword value on the stack
-	case asBC_PshC4:
-		--l_sp;
-		*l_sp = asBC_DWORDARG(l_bc);
-		l_bc += 2;
-		break;
+	bool isValue = (type->flags & asOBJ_VALUE) ? true : false;
+	if( isValue && mem == 0 )
+	{
+		mem = engine->CallAlloc(type);
+		if( mem == 0 )
+			return asOUT_OF_MEMORY;
+	}
 
-	// Push the dword value of a variable on the stack
-	case asBC_PshV4:
-		--l_sp;
-		*l_sp = *(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
+	int typeId = engine->GetTypeIdFromDataType(asCDataType::CreateObject(type, false));
+	void *obj = serializer->LoadObject(in, isValue ? mem : 0, typeId);
+	if( obj == 0 )
+	{
+		if( isValue && slot )
+			engine->CallFree(mem);
+		return asERROR;
+	}
 
-	// Push the address of a variable on the stack
-	case asBC_PSF:
-		l_sp -= AS_PTR_SIZE;
-		*(asPWORD*)l_sp = asPWORD(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
+	if( slot )
+		*slot = (asPWORD)obj;
 
-	// Swap the top 2 pointers on the stack
-	case asBC_SwapPtr:
+	asSStateObject o = {obj, type, slot};
+	objects.PushLast(o);
+
+	return asSUCCESS;
+}
+
+static void FreeStateObjects(asCScriptEngine *engine, asCArray<asSStateObject> &objects)
+{
+	for( asUINT n = objects.GetLength(); n-- > 0; )
+	{
+		asSStateObject &o = objects[n];
+		if( o.type->flags & asOBJ_REF )
 		{
-			asPWORD p = (asPWORD)*l_sp;
-			*(asPWORD*)l_sp = *(asPWORD*)(l_sp+AS_PTR_SIZE);
-			*(asPWORD*)(l_sp+AS_PTR_SIZE) = p;
-			l_bc++;
+			if( o.type->beh.release )
+				engine->CallObjectMethod(o.obj, o.type->beh.release);
 		}
-		break;
-
-	// Do a boolean not operation, modifying the value of the variable
-	case asBC_NOT:
-#if AS_SIZEOF_BOOL == 1
+		else
 		{
-			// Set the value to true if it is equal to 0
-
-			// We need to use volatile here to tell the compiler it cannot
-			// change the order of read and write operations on the pointer.
-
-			volatile asBYTE *ptr = (asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
-			asBYTE val = (ptr[0] == 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
-			ptr[0] = val; // The result is stored in the lower byte
-			ptr[1] = 0;   // Make sure the rest of the DWORD is 0
-			ptr[2] = 0;
-			ptr[3] = 0;
+			if( o.type->beh.destruct )
+				engine->CallObjectMethod(o.obj, o.type->beh.destruct);
+			if( o.slot )
+				engine->CallFree(o.obj);
 		}
-#else
-		*(l_fp - asBC_SWORDARG0(l_bc)) = (*(l_fp - asBC_SWORDARG0(l_bc)) == 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
-#endif
-		l_bc++;
-		break;
-
-	// Push the dword value of a global variable on the stack
-	case asBC_PshG4:
-		--l_sp;
-		*l_sp = *(asDWORD*)asBC_PTRARG(l_bc);
-		l_bc += 1 + AS_PTR_SIZE;
-		break;
 
-	// Load the address of a global variable in the register, then
-	// copy the value of the global variable into a local variable
-	case asBC_LdGRdR4:
-		*(void**)&m_regs.valueRegister = (void*)asBC_PTRARG(l_bc);
-		*(l_fp - asBC_SWORDARG0(l_bc)) = **(asDWORD**)&m_regs.valueRegister;
-		l_bc += 1+AS_PTR_SIZE;
-		break;
+		if( o.slot )
+			*o.slot = 0;
+	}
+	objects.SetLength(0);
+}
 
-//----------------
-// path control instructions
+static int WriteStateArgs(asCScriptEngine *engine, asIBinaryStream *out, asIContextSerializer *serializer, asCScriptFunction *func, asDWORD *args, asUINT pos, const asCArray<asSStateFrame> &frames)
+{
+	int r;
+	int offset = 0;
+	if( func->objectType )
+	{
+		if( IsStateThisOwned(func, pos) )
+			r = WriteStateObject(engine, out, serializer, *(void**)args, func->objectType);
+		else
+			r = WriteStateRef(out, *(void**)args, func, frames);
+		if( r < 0 ) return r;
+		offset += AS_PTR_SIZE;
+	}
 
-	// Begin execution of a script function
-	case asBC_CALL:
+	if( func->DoesReturnOnStack() )
+	{
+		// The initial function returns the value in memory that is set up by Prepare
+		if( frames.GetLength() )
 		{
-			int i = asBC_INTARG(l_bc);
-			l_bc += 2;
+			r = WriteStateRef(out, *(void**)(args + offset), func, frames);
+			if( r < 0 ) return r;
+		}
+		offset += AS_PTR_SIZE;
+	}
 
-			asASSERT( i >= 0 );
-			asASSERT( (i & FUNC_IMPORTED) == 0 );
+	for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
+	{
+		asCDataType &dt = func->parameterTypes[n];
+		asUINT size = dt.GetSizeOnStackDWords();
+		if( dt.IsReference() )
+		{
+			r = WriteStateRef(out, *(void**)(args + offset), func, frames);
+			if( r < 0 ) return r;
 
-			// Need to move the values back to the context
-			m_regs.programPointer = l_bc;
-			m_regs.stackPointer = l_sp;
-			m_regs.stackFramePointer = l_fp;
+			// A variable type parameter is followed by the type id
+			if( size > AS_PTR_SIZE )
+				out->Write(args + offset + AS_PTR_SIZE, sizeof(asDWORD)*(size - AS_PTR_SIZE));
+		}
+		else if( dt.GetFuncDef() )
+		{
+			r = WriteStateObject(engine, out, serializer, *(void**)(args + offset), 0);
+			if( r < 0 ) return r;
+		}
+		else if( dt.IsObject() )
+		{
+			r = WriteStateObject(engine, out, serializer, *(void**)(args + offset), dt.GetObjectType());
+			if( r < 0 ) return r;
+		}
+		else
+			out->Write(args + offset, sizeof(asDWORD)*size);
 
-			CallScriptFunction(m_engine->scriptFunctions[i]);
+		offset += size;
+	}
 
-			// Extract the values from the context again
-			l_bc = m_regs.programPointer;
-			l_sp = m_regs.stackPointer;
-			l_fp = m_regs.stackFramePointer;
+	return asSUCCESS;
+}
 
-			// If status isn't active anymore then we must stop
-			if( m_status != asEXECUTION_ACTIVE )
-				return;
+static int ReadStateArgs(asCScriptEngine *engine, asIBinaryStream *in, asIContextSerializer *serializer, asCScriptFunction *func, asDWORD *args, asUINT pos, const asCArray<asSStateFrame> &frames, asCArray<asSStateObject> &objects)
+{
+	int r;
+	int offset = 0;
+	if( func->objectType )
+	{
+		if( IsStateThisOwned(func, pos) )
+			r = ReadStateObject(engine, in, serializer, func->objectType, 0, (asPWORD*)args, objects);
+		else
+			r = ReadStateRef(in, (void**)args, func, frames);
+		if( r < 0 ) return r;
+		offset += AS_PTR_SIZE;
+	}
+
+	if( func->DoesReturnOnStack() )
+	{
+		if( frames.GetLength() )
+		{
+			r = ReadStateRef(in, (void**)(args + offset), func, frames);
+			if( r < 0 ) return r;
 		}
-		break;
+		offset += AS_PTR_SIZE;
+	}
 
-	// Return to the caller, and remove the arguments from the stack
-	case asBC_RET:
+	for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
+	{
+		asCDataType &dt = func->parameterTypes[n];
+		asUINT size = dt.GetSizeOnStackDWords();
+		if( dt.IsReference() )
 		{
-			// Return if this was the first function, or a nested execution
-			if( m_callStack.GetLength() == 0 ||
-				m_callStack[m_callStack.GetLength() - CALLSTACK_FRAME_SIZE] == 0 )
-			{
-				m_status = asEXECUTION_FINISHED;
-				return;
-			}
+			r = ReadStateRef(in, (void**)(args + offset), func, frames);
+			if( r < 0 ) return r;
 
-			asWORD w = asBC_WORDARG0(l_bc);
+			if( size > AS_PTR_SIZE )
+				in->Read(args + offset + AS_PTR_SIZE, sizeof(asDWORD)*(size - AS_PTR_SIZE));
+		}
+		else if( dt.GetFuncDef() )
+		{
+			r = ReadStateObject(engine, in, serializer, 0, 0, (asPWORD*)(args + offset), objects);
+			if( r < 0 ) return r;
+		}
+		else if( dt.IsObject() )
+		{
+			r = ReadStateObject(engine, in, serializer, dt.GetObjectType(), 0, (asPWORD*)(args + offset), objects);
+			if( r < 0 ) return r;
+		}
+		else
+			in->Read(args + offset, sizeof(asDWORD)*size);
 
-			// Read the old framepointer, functionid, and programCounter from the call stack
-			PopCallState();
+		offset += size;
+	}
 
-			// Extract the values from the context again
-			l_bc = m_regs.programPointer;
-			l_sp = m_regs.stackPointer;
-			l_fp = m_regs.stackFramePointer;
+	return asSUCCESS;
+}
 
-			// Pop arguments from stack
-			l_sp += w;
+static int WriteStateVars(asCScriptEngine *engine, asIBinaryStream *out, asIContextSerializer *serializer, asCScriptFunction *func, asDWORD *sf, const asCArray<int> &liveObjects)
+{
+	// The plain values are saved as they are, except for the objects
+	// on the heap and on the stack that are saved separately
+	asUINT space = func->variableSpace;
+	if( space )
+	{
+		asCArray<asDWORD> vars;
+		vars.SetLength(space);
+		memcpy(vars.AddressOf(), sf - space, sizeof(asDWORD)*space);
+		for( asUINT n = 0; n < func->objVariablePos.GetLength(); n++ )
+		{
+			int pos = func->objVariablePos[n];
+			if( n < func->objVariablesOnHeap )
+				*(asPWORD*)&vars[space - pos] = 0;
+			else if( func->objVariableTypes[n] )
+				memset(&vars[space - pos], 0, func->objVariableTypes[n]->GetSize());
 		}
-		break;
+		out->Write(vars.AddressOf(), sizeof(asDWORD)*space);
+	}
 
-	// Jump to a relative position
-	case asBC_JMP:
-		l_bc += 2 + asBC_INTARG(l_bc);
-		break;
+	for( asUINT n = 0; n < func->objVariablePos.GetLength(); n++ )
+	{
+		int pos = func->objVariablePos[n];
+		asCObjectType *type = func->funcVariableTypes[n] ? 0 : func->objVariableTypes[n];
+		int r;
+		if( n < func->objVariablesOnHeap )
+			r = WriteStateObject(engine, out, serializer, *(void**)(sf - pos), type);
+		else
+			r = WriteStateObject(engine, out, serializer, liveObjects[n] > 0 ? (void*)(sf - pos) : 0, type);
+		if( r < 0 ) return r;
+	}
 
-//----------------
-// Conditional jumps
+	return asSUCCESS;
+}
 
-	// Jump to a relative position if the value in the register is 0
-	case asBC_JZ:
-		if( *(int*)&m_regs.valueRegister == 0 )
-			l_bc += asBC_INTARG(l_bc) + 2;
-		else
-			l_bc += 2;
-		break;
+static int ReadStateVars(asCScriptEngine *engine, asIBinaryStream *in, asIContextSerializer *serializer, asCScriptFunction *func, asDWORD *sf, asCArray<asSStateObject> &objects)
+{
+	asUINT space = func->variableSpace;
+	if( space )
+		in->Read(sf - space, sizeof(asDWORD)*space);
 
-	// Jump to a relative position if the value in the register is not 0
-	case asBC_JNZ:
-		if( *(int*)&m_regs.valueRegister != 0 )
-			l_bc += asBC_INTARG(l_bc) + 2;
+	for( asUINT n = 0; n < func->objVariablePos.GetLength(); n++ )
+	{
+		int pos = func->objVariablePos[n];
+		asCObjectType *type = func->funcVariableTypes[n] ? 0 : func->objVariableTypes[n];
+		int r;
+		if( n < func->objVariablesOnHeap )
+			r = ReadStateObject(engine, in, serializer, type, 0, (asPWORD*)(sf - pos), objects);
 		else
-			l_bc += 2;
-		break;
+			r = ReadStateObject(engine, in, serializer, type, sf - pos, 0, objects);
+		if( r < 0 ) return r;
+	}
 
-	// Jump to a relative position if the value in the register is negative
-	case asBC_JS:
-		if( *(int*)&m_regs.valueRegister < 0 )
-			l_bc += asBC_INTARG(l_bc) + 2;
-		else
-			l_bc += 2;
-		break;
+	return asSUCCESS;
+}
 
-	// Jump to a relative position if the value in the register it not negative
-	case asBC_JNS:
-		if( *(int*)&m_regs.valueRegister >= 0 )
-			l_bc += asBC_INTARG(l_bc) + 2;
-		else
-			l_bc += 2;
-		break;
+// interface
+int asCContext::SaveExecutionState(asIBinaryStream *out, asIContextSerializer *serializer)
+{
+	if( out == 0 || serializer == 0 )
+		return asINVALID_ARG;
 
-	// Jump to a relative position if the value in the register is greater than 0
-	case asBC_JP:
-		if( *(int*)&m_regs.valueRegister > 0 )
-			l_bc += asBC_INTARG(l_bc) + 2;
-		else
-			l_bc += 2;
-		break;
+	if( m_status != asEXECUTION_SUSPENDED || m_regs.programPointer == 0 )
+		return asERROR;
 
-	// Jump to a relative position if the value in the register is not greater than 0
-	case asBC_JNP:
-		if( *(int*)&m_regs.valueRegister <= 0 )
-			l_bc += asBC_INTARG(l_bc) + 2;
-		else
-			l_bc += 2;
-		break;
-//--------------------
-// test instructions
+	// The execution cannot be saved while it depends on state that cannot be restored
+	if( IsNested() || m_coroutine || m_coroutineList || m_coroutineRequest || m_yieldRequest || m_asyncCall || m_regs.objectRegister )
+		return asNOT_SUPPORTED;
 
-	// If the value in the register is 0, then set the register to 1, else to 0
-	case asBC_TZ:
-#if AS_SIZEOF_BOOL == 1
+	// The frames are saved starting with the initial function, so
+	// the callers are known when the references are restored
+	asUINT count = GetCallstackSize();
+	out->Write(&count, sizeof(count));
+
+	asCArray<asSStateFrame> frames;
+	asCArray<int> liveObjects;
+	for( asUINT f = 0; f < count; f++ )
+	{
+		asUINT level = count - f - 1;
+		asCScriptFunction *func;
+		asDWORD *sf, *pp, *sp;
+		if( level == 0 )
 		{
-			// Set the value to true if it is equal to 0
+			func = m_currentFunction;
+			sf   = m_regs.stackFramePointer;
+			pp   = m_regs.programPointer;
+			sp   = m_regs.stackPointer;
+		}
+		else
+		{
+			asPWORD *s = m_callStack.AddressOf() + f*CALLSTACK_FRAME_SIZE;
+			func = (asCScriptFunction*)s[1];
+			sf   = (asDWORD*)s[0];
+			pp   = (asDWORD*)s[2];
+			sp   = (asDWORD*)s[3];
+		}
 
-			// We need to use volatile here to tell the compiler it cannot
-			// change the order of read and write operations on valueRegister.
+		// Nothing but the arguments for the called function may have been pushed on the stack
+		asUINT pushed = level ? GetStateArgsSize((asCScriptFunction*)GetFunction(level - 1)) : 0;
+		if( sp + pushed != sf - func->variableSpace )
+			return asNOT_SUPPORTED;
 
-			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
-			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
-			asBYTE val = (regPtr[0] == 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
-			regBptr[0] = val; // The result is stored in the lower byte
-			regBptr[1] = 0;   // Make sure the rest of the register is 0
-			regBptr[2] = 0;
-			regBptr[3] = 0;
-			regBptr[4] = 0;
-			regBptr[5] = 0;
-			regBptr[6] = 0;
-			regBptr[7] = 0;
-		}
-#else
-		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister == 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
-#endif
-		l_bc++;
-		break;
+		asUINT pos = asUINT(pp - func->byteCode.AddressOf());
+		if( !IsStateAtStatement(func, pos) )
+			return asNOT_SUPPORTED;
 
-	// If the value in the register is not 0, then set the register to 1, else to 0
-	case asBC_TNZ:
-#if AS_SIZEOF_BOOL == 1
-		{
-			// Set the value to true if it is not equal to 0
+		int r = WriteStateFunction(out, func);
+		if( r < 0 ) return r;
 
-			// We need to use volatile here to tell the compiler it cannot
-			// change the order of read and write operations on valueRegister.
+		out->Write(&pos, sizeof(pos));
 
-			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
-			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
-			asBYTE val = (regPtr[0] == 0) ? 0 : VALUE_OF_BOOLEAN_TRUE;
-			regBptr[0] = val; // The result is stored in the lower byte
-			regBptr[1] = 0;   // Make sure the rest of the register is 0
-			regBptr[2] = 0;
-			regBptr[3] = 0;
-			regBptr[4] = 0;
-			regBptr[5] = 0;
-			regBptr[6] = 0;
-			regBptr[7] = 0;
-		}
-#else
-		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister == 0 ? 0 : VALUE_OF_BOOLEAN_TRUE);
-#endif
-		l_bc++;
-		break;
+		r = WriteStateArgs(m_engine, out, serializer, func, sf, pos, frames);
+		if( r < 0 ) return r;
 
-	// If the value in the register is negative, then set the register to 1, else to 0
-	case asBC_TS:
-#if AS_SIZEOF_BOOL == 1
-		{
-			// Set the value to true if it is less than 0
+		DetermineLiveObjects(liveObjects, level);
+		r = WriteStateVars(m_engine, out, serializer, func, sf, liveObjects);
+		if( r < 0 ) return r;
 
-			// We need to use volatile here to tell the compiler it cannot
-			// change the order of read and write operations on valueRegister.
+		asSStateFrame frame = {func, sf};
+		frames.PushLast(frame);
+	}
 
-			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
-			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
-			asBYTE val = (regPtr[0] < 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
-			regBptr[0] = val; // The result is stored in the lower byte
-			regBptr[1] = 0;   // Make sure the rest of the register is 0
-			regBptr[2] = 0;
-			regBptr[3] = 0;
-			regBptr[4] = 0;
-			regBptr[5] = 0;
-			regBptr[6] = 0;
-			regBptr[7] = 0;
-		}
-#else
-		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister < 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
-#endif
-		l_bc++;
-		break;
+	return asSUCCESS;
+}
 
-	// If the value in the register is not negative, then set the register to 1, else to 0
-	case asBC_TNS:
-#if AS_SIZEOF_BOOL == 1
-		{
-			// Set the value to true if it is not less than 0
+// interface
+int asCContext::LoadExecutionState(asIBinaryStream *in, asIContextSerializer *serializer)
+{
+	if( in == 0 || serializer == 0 )
+		return asINVALID_ARG;
 
-			// We need to use volatile here to tell the compiler it cannot
-			// change the order of read and write operations on valueRegister.
+	if( m_status == asEXECUTION_ACTIVE || m_status == asEXECUTION_SUSPENDED )
+		return asCONTEXT_ACTIVE;
 
-			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
-			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
-			asBYTE val = (regPtr[0] >= 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
-			regBptr[0] = val; // The result is stored in the lower byte
-			regBptr[1] = 0;   // Make sure the rest of the register is 0
-			regBptr[2] = 0;
-			regBptr[3] = 0;
-			regBptr[4] = 0;
-			regBptr[5] = 0;
-			regBptr[6] = 0;
-			regBptr[7] = 0;
+	if( IsNested() )
+		return asNOT_SUPPORTED;
+
+	asUINT count = 0;
+	in->Read(&count, sizeof(count));
+	if( count == 0 )
+		return asERROR;
+
+	asCArray<asSStateFrame> frames;
+	asCArray<asSStateObject> objects;
+	bool     isPrepared        = false;
+	bool     doProcessSuspend  = false;
+	asUINT   stackIndex        = 0;
+	asDWORD *stackFramePointer = 0;
+	int r = asSUCCESS;
+	for( asUINT f = 0; f < count; f++ )
+	{
+		asCScriptFunction *func = ReadStateFunction(m_engine, in);
+		asUINT pos = 0;
+		in->Read(&pos, sizeof(pos));
+		if( func == 0 || pos >= func->byteCode.GetLength() )
+		{
+			r = asERROR;
+			break;
 		}
-#else
-		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister < 0 ? 0 : VALUE_OF_BOOLEAN_TRUE);
-#endif
-		l_bc++;
-		break;
 
-	// If the value in the register is greater than 0, then set the register to 1, else to 0
-	case asBC_TP:
-#if AS_SIZEOF_BOOL == 1
+		if( f == 0 )
 		{
-			// Set the value to true if it is greater than 0
+			// The initial function is prepared as usual, after
+			// which the arguments are restored directly on the stack
+			r = Prepare(func);
+			if( r < 0 ) break;
 
-			// We need to use volatile here to tell the compiler it cannot
-			// change the order of read and write operations on valueRegister.
+			isPrepared        = true;
+			doProcessSuspend  = m_regs.doProcessSuspend;
+			stackIndex        = m_stackIndex;
+			stackFramePointer = m_regs.stackFramePointer;
 
-			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
-			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
-			asBYTE val = (regPtr[0] > 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
-			regBptr[0] = val; // The result is stored in the lower byte
-			regBptr[1] = 0;   // Make sure the rest of the register is 0
-			regBptr[2] = 0;
-			regBptr[3] = 0;
-			regBptr[4] = 0;
-			regBptr[5] = 0;
-			regBptr[6] = 0;
-			regBptr[7] = 0;
-		}
-#else
-		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister > 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
-#endif
-		l_bc++;
-		break;
-
-	// If the value in the register is not greater than 0, then set the register to 1, else to 0
-	case asBC_TNP:
-#if AS_SIZEOF_BOOL == 1
-		{
-			// Set the value to true if it is not greater than 0
+			// The line callback mustn't be invoked while the call stack is rebuilt
+			m_regs.doProcessSuspend = false;
 
-			// We need to use volatile here to tell the compiler it cannot
-			// change the order of read and write operations on valueRegister.
+			r = ReadStateArgs(m_engine, in, serializer, func, m_regs.stackFramePointer, pos, frames, objects);
+			if( r < 0 ) break;
 
-			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
-			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
-			asBYTE val = (regPtr[0] <= 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
-			regBptr[0] = val; // The result is stored in the lower byte
-			regBptr[1] = 0;   // Make sure the rest of the register is 0
-			regBptr[2] = 0;
-			regBptr[3] = 0;
-			regBptr[4] = 0;
-			regBptr[5] = 0;
-			regBptr[6] = 0;
-			regBptr[7] = 0;
+			m_regs.programPointer = func->byteCode.AddressOf();
+			PrepareScriptFunction();
 		}
-#else
-		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister > 0 ? 0 : VALUE_OF_BOOLEAN_TRUE);
-#endif
-		l_bc++;
-		break;
+		else
+		{
+			// The arguments are pushed on the stack of the calling function before the call
+			m_regs.stackPointer -= GetStateArgsSize(func);
+			r = ReadStateArgs(m_engine, in, serializer, func, m_regs.stackPointer, pos, frames, objects);
+			if( r < 0 ) break;
 
-//--------------------
-// negate value
+			CallScriptFunction(func);
+			if( m_status == asEXECUTION_EXCEPTION )
+			{
+				r = asOUT_OF_MEMORY;
+				break;
+			}
+		}
 
-	// Negate the integer value in the variable
-	case asBC_NEGi:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = asDWORD(-int(*(l_fp - asBC_SWORDARG0(l_bc))));
-		l_bc++;
-		break;
+		r = ReadStateVars(m_engine, in, serializer, func, m_regs.stackFramePointer, objects);
+		if( r < 0 ) break;
 
-	// Negate the float value in the variable
-	case asBC_NEGf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = -*(float*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
+		m_regs.programPointer = func->byteCode.AddressOf() + pos;
 
-	// Negate the double value in the variable
-	case asBC_NEGd:
-		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = -*(double*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
+		asSStateFrame frame = {func, m_regs.stackFramePointer};
+		frames.PushLast(frame);
+	}
 
-//-------------------------
-// Increment value pointed to by address in register
+	if( r < 0 )
+	{
+		FreeStateObjects(m_engine, objects);
 
-	// Increment the short value pointed to by the register
-	case asBC_INCi16:
-		(**(short**)&m_regs.valueRegister)++;
-		l_bc++;
-		break;
+		if( isPrepared )
+		{
+			// Discard the partially restored call stack and leave the context unprepared
+			m_callStack.SetLength(0);
+			m_stackIndex                = stackIndex;
+			m_currentFunction           = m_initialFunction;
+			m_regs.stackFramePointer    = stackFramePointer;
+			m_regs.programPointer       = 0;
+			m_regs.doProcessSuspend     = doProcessSuspend;
+			m_isStackMemoryNotAllocated = false;
+			m_status                    = asEXECUTION_PREPARED;
+			Unprepare();
+		}
 
-	// Increment the byte value pointed to by the register
-	case asBC_INCi8:
-		(**(char**)&m_regs.valueRegister)++;
-		l_bc++;
-		break;
+		return r;
+	}
 
-	// Decrement the short value pointed to by the register
-	case asBC_DECi16:
-		(**(short**)&m_regs.valueRegister)--;
-		l_bc++;
-		break;
+	// The registers don't hold any values between the statements
+	m_regs.valueRegister    = 0;
+	m_regs.objectRegister   = 0;
+	m_regs.objectType       = 0;
+	m_regs.doProcessSuspend = doProcessSuspend;
+	m_status = asEXECUTION_SUSPENDED;
 
-	// Decrement the byte value pointed to by the register
-	case asBC_DECi8:
-		(**(char**)&m_regs.valueRegister)--;
-		l_bc++;
-		break;
+	return asSUCCESS;
+}
 
-	// Increment the integer value pointed to by the register
-	case asBC_INCi:
-		++(**(int**)&m_regs.valueRegister);
-		l_bc++;
-		break;
+// internal
+void asCContext::SwapCoroutineState(asCCoroutine *co)
+{
+	m_callStack.SwapWith(co->m_callStack);
+	m_stackBlocks.SwapWith(co->m_stackBlocks);
+
+	asUINT stackBlockSize = m_stackBlockSize;
+	m_stackBlockSize = co->m_stackBlockSize;
+	co->m_stackBlockSize = stackBlockSize;
+
+	asUINT stackIndex = m_stackIndex;
+	m_stackIndex = co->m_stackIndex;
+	co->m_stackIndex = stackIndex;
+
+	asCScriptFunction *currentFunction = m_currentFunction;
+	m_currentFunction = co->m_currentFunction;
+	co->m_currentFunction = currentFunction;
+
+	// The registers must also be exchanged, as the resumer may
+	// not yet have read the return value of the system function
+	asDWORD *programPointer = m_regs.programPointer;
+	asDWORD *stackFramePointer = m_regs.stackFramePointer;
+	asDWORD *stackPointer = m_regs.stackPointer;
+	asQWORD valueRegister = m_regs.valueRegister;
+	void *objectRegister = m_regs.objectRegister;
+	asIObjectType *objectType = m_regs.objectType;
+
+	m_regs.programPointer    = co->m_programPointer;
+	m_regs.stackFramePointer = co->m_stackFramePointer;
+	m_regs.stackPointer      = co->m_stackPointer;
+	m_regs.valueRegister     = co->m_valueRegister;
+	m_regs.objectRegister    = co->m_objectRegister;
+	m_regs.objectType        = co->m_objectType;
+
+	co->m_programPointer    = programPointer;
+	co->m_stackFramePointer = stackFramePointer;
+	co->m_stackPointer      = stackPointer;
+	co->m_valueRegister     = valueRegister;
+	co->m_objectRegister    = objectRegister;
+	co->m_objectType        = objectType;
+}
 
-	// Decrement the integer value pointed to by the register
-	case asBC_DECi:
-		--(**(int**)&m_regs.valueRegister);
-		l_bc++;
-		break;
+// internal
+void asCContext::SwitchToCoroutine(asCCoroutine *co)
+{
+	// The context holds a reference to the co-routine while it is executing
+	co->AddRef();
+	co->m_resumer = m_coroutine;
+	co->m_resumeLevel = m_nestedLevel;
+	co->m_status = asEXECUTION_ACTIVE;
+
+	// After this the co-routine holds the state of the resumer
+	SwapCoroutineState(co);
+	m_coroutine = co;
+}
 
-	// Increment the float value pointed to by the register
-	case asBC_INCf:
-		++(**(float**)&m_regs.valueRegister);
-		l_bc++;
-		break;
+// internal
+void asCContext::SwitchFromCoroutine(asEContextState coStatus)
+{
+	asCCoroutine *co = m_coroutine;
 
-	// Decrement the float value pointed to by the register
-	case asBC_DECf:
-		--(**(float**)&m_regs.valueRegister);
-		l_bc++;
-		break;
+	// Restore the state of the resumer
+	SwapCoroutineState(co);
+	m_coroutine = co->m_resumer;
 
-	// Increment the double value pointed to by the register
-	case asBC_INCd:
-		++(**(double**)&m_regs.valueRegister);
-		l_bc++;
-		break;
+	co->m_resumer = 0;
+	co->m_status = coStatus;
 
-	// Decrement the double value pointed to by the register
-	case asBC_DECd:
-		--(**(double**)&m_regs.valueRegister);
-		l_bc++;
-		break;
+	// The stack memory is no longer needed if the co-routine won't continue
+	if( coStatus != asEXECUTION_SUSPENDED )
+		co->FreeStack();
 
-	// Increment the local integer variable
-	case asBC_IncVi:
-		(*(int*)(l_fp - asBC_SWORDARG0(l_bc)))++;
-		l_bc++;
-		break;
+	co->Release();
+}
 
-	// Decrement the local integer variable
-	case asBC_DecVi:
-		(*(int*)(l_fp - asBC_SWORDARG0(l_bc)))--;
-		l_bc++;
-		break;
+// internal
+bool asCContext::ProcessCoroutineSwitch()
+{
+	if( m_status == asEXECUTION_SUSPENDED && !m_doAbort && (m_coroutineRequest || m_yieldRequest) )
+	{
+		if( m_yieldRequest )
+		{
+			m_yieldRequest = false;
+			SwitchFromCoroutine(asEXECUTION_SUSPENDED);
+		}
+		else
+		{
+			asCCoroutine *co = m_coroutineRequest;
+			m_coroutineRequest = 0;
+			SwitchToCoroutine(co);
+			co->Release();
+		}
+	}
+	else if( m_status == asEXECUTION_FINISHED && m_coroutine && m_coroutine->m_resumeLevel == m_nestedLevel )
+	{
+		// The co-routine returned, so the execution continues where it was resumed
+		SwitchFromCoroutine(asEXECUTION_FINISHED);
+	}
+	else
+		return false;
 
-//--------------------
-// bits instructions
+	// Only stay suspended if the application also asked for it
+	m_doSuspend = m_externalSuspendRequest;
+	m_regs.doProcessSuspend = m_doSuspend || m_lineCallback;
+	if( m_doSuspend )
+	{
+		m_status = asEXECUTION_SUSPENDED;
+		return false;
+	}
 
-	// Do a bitwise not on the value in the variable
-	case asBC_BNOT:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = ~*(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
+	m_status = asEXECUTION_ACTIVE;
 
-	// Do a bitwise and of two variables and store the result in a third variable
-	case asBC_BAND:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) & *(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+	// Set up the stack frame if the co-routine hasn't been started yet
+	if( m_regs.programPointer == 0 )
+	{
+		if( m_currentFunction->isBodyPending &&
+			(m_currentFunction->module == 0 || m_currentFunction->module->LoadFunctionBody(m_currentFunction) < 0) )
+			SetInternalException(TXT_BYTECODE_NOT_LOADED);
 
-	// Do a bitwise or of two variables and store the result in a third variable
-	case asBC_BOR:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) | *(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+		m_regs.programPointer = m_currentFunction->byteCode.AddressOf();
 
-	// Do a bitwise xor of two variables and store the result in a third variable
-	case asBC_BXOR:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) ^ *(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+		PrepareScriptFunction();
+	}
 
-	// Do a logical shift left of two variables and store the result in a third variable
-	case asBC_BSLL:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) << *(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+	return m_status == asEXECUTION_ACTIVE;
+}
 
-	// Do a logical shift right of two variables and store the result in a third variable
-	case asBC_BSRL:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) >> *(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+// internal
+void asCContext::DiscardCoroutine(asCCoroutine *co)
+{
+	// The co-routine's state is temporarily exchanged with the context's
+	// so the objects on its stack can be cleaned up by the exception handler
+	asEContextState status = m_status;
+	bool inExceptionHandler = m_inExceptionHandler;
+	bool needToCleanupArgs = m_needToCleanupArgs;
+	bool isStackMemoryNotAllocated = m_isStackMemoryNotAllocated;
+
+	m_status = asEXECUTION_SUSPENDED;
+	m_inExceptionHandler = true;
+	m_needToCleanupArgs = false;
+	m_isStackMemoryNotAllocated = false;
 
-	// Do an arithmetic shift right of two variables and store the result in a third variable
-	case asBC_BSRA:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(l_fp - asBC_SWORDARG1(l_bc))) >> *(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+	SwapCoroutineState(co);
+	CleanCallStack();
+	SwapCoroutineState(co);
 
-	case asBC_COPY:
-		{
-			void *d = (void*)*(asPWORD*)l_sp; l_sp += AS_PTR_SIZE;
-			void *s = (void*)*(asPWORD*)l_sp;
-			if( s == 0 || d == 0 )
-			{
-				// Need to move the values back to the context
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+	m_status = status;
+	m_inExceptionHandler = inExceptionHandler;
+	m_needToCleanupArgs = needToCleanupArgs;
+	m_isStackMemoryNotAllocated = isStackMemoryNotAllocated;
 
-				// Raise exception
-				SetInternalException(TXT_NULL_POINTER_ACCESS);
-				return;
-			}
-			memcpy(d, s, asBC_WORDARG0(l_bc)*4);
+	co->m_status = asEXECUTION_ABORTED;
+}
 
-			// replace the pointer on the stack with the lvalue
-			*(asPWORD**)l_sp = (asPWORD*)d;
-		}
-		l_bc += 2;
-		break;
+void asCContext::PushCallState()
+{
+	if( m_callStack.GetLength() == m_callStack.GetCapacity() )
+	{
+		// Allocate space for 10 call states at a time to save time
+		m_callStack.AllocateNoConstruct(m_callStack.GetLength() + 10*CALLSTACK_FRAME_SIZE, true);
+	}
+	m_callStack.SetLengthNoConstruct(m_callStack.GetLength() + CALLSTACK_FRAME_SIZE);
 
-	case asBC_PshC8:
-		l_sp -= 2;
-		*(asQWORD*)l_sp = asBC_QWORDARG(l_bc);
-		l_bc += 3;
-		break;
+    // Separating the loads and stores limits data cache trash, and with a smart compiler
+    // could turn into SIMD style loading/storing if available.
+    // The compiler can't do this itself due to potential pointer aliasing between the pointers,
+    // ie writing to tmp could overwrite the data contained in registers.stackFramePointer for example
+    // for all the compiler knows. So introducing the local variable s, which is never referred to by
+    // its address we avoid this issue.
 
-	case asBC_PshVPtr:
-		l_sp -= AS_PTR_SIZE;
-		*(asPWORD*)l_sp = *(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
+	asPWORD s[5];
+	s[0] = (asPWORD)m_regs.stackFramePointer;
+	s[1] = (asPWORD)m_currentFunction;
+	s[2] = (asPWORD)m_regs.programPointer;
+	s[3] = (asPWORD)m_regs.stackPointer;
+	s[4] = m_stackIndex;
 
-	case asBC_RDSPtr:
-		{
-			// The pointer must not be null
+	asPWORD *tmp = m_callStack.AddressOf() + m_callStack.GetLength() - CALLSTACK_FRAME_SIZE;
+	tmp[0] = s[0];
+	tmp[1] = s[1];
+	tmp[2] = s[2];
+	tmp[3] = s[3];
+	tmp[4] = s[4];
+}
+
+void asCContext::PopCallState()
+{
+	// See comments in PushCallState about pointer aliasing and data cache trashing
+	asPWORD *tmp = m_callStack.AddressOf() + m_callStack.GetLength() - CALLSTACK_FRAME_SIZE;
+	asPWORD s[5];
+	s[0] = tmp[0];
+	s[1] = tmp[1];
+	s[2] = tmp[2];
+	s[3] = tmp[3];
+	s[4] = tmp[4];
+
+	m_regs.stackFramePointer = (asDWORD*)s[0];
+	m_currentFunction        = (asCScriptFunction*)s[1];
+	m_regs.programPointer    = (asDWORD*)s[2];
+	m_regs.stackPointer      = (asDWORD*)s[3];
+	m_stackIndex             = (int)s[4];
+
+	m_callStack.SetLength(m_callStack.GetLength() - CALLSTACK_FRAME_SIZE);
+}
+
+// interface
+asUINT asCContext::GetCallstackSize() const
+{
+	if( m_currentFunction == 0 ) return 0;
+
+	// The current function is accessed at stackLevel 0
+	return asUINT(1 + m_callStack.GetLength() / CALLSTACK_FRAME_SIZE);
+}
+
+// interface
+asIScriptFunction *asCContext::GetFunction(asUINT stackLevel)
+{
+	if( stackLevel >= GetCallstackSize() ) return 0;
+
+	if( stackLevel == 0 ) return m_currentFunction;
+
+	asPWORD *s = m_callStack.AddressOf() + (GetCallstackSize() - stackLevel - 1)*CALLSTACK_FRAME_SIZE;
+	asCScriptFunction *func = (asCScriptFunction*)s[1];
+
+	return func;
+}
+
+// interface
+int asCContext::GetLineNumber(asUINT stackLevel, int *column, const char **sectionName)
+{
+	if( stackLevel >= GetCallstackSize() ) return asINVALID_ARG;
+
+	asCScriptFunction *func;
+	asDWORD *bytePos;
+	if( stackLevel == 0 )
+	{
+		func = m_currentFunction;
+		bytePos = m_regs.programPointer;
+	}
+	else
+	{
+		asPWORD *s = m_callStack.AddressOf() + (GetCallstackSize()-stackLevel-1)*CALLSTACK_FRAME_SIZE;
+		func = (asCScriptFunction*)s[1];
+		bytePos = (asDWORD*)s[2];
+
+		// Subract 1 from the bytePos, because we want the line where
+		// the call was made, and not the instruction after the call
+		bytePos -= 1;
+	}
+
+	// For nested calls it is possible that func is null
+	if( func == 0 )
+	{
+		if( column ) *column = 0;
+		if( sectionName ) *sectionName = 0;
+		return 0;
+	}
+
+	int sectionIdx;
+	asDWORD line = func->GetLineNumber(int(bytePos - func->byteCode.AddressOf()), &sectionIdx);
+	if( column ) *column = (line >> 20);
+	if( sectionName )
+	{
+		asASSERT( sectionIdx < int(m_engine->scriptSectionNames.GetLength()) );
+		if( sectionIdx >= 0 && asUINT(sectionIdx) < m_engine->scriptSectionNames.GetLength() )
+			*sectionName = m_engine->scriptSectionNames[sectionIdx]->AddressOf();
+		else
+			*sectionName = 0;
+	}
+	return (line & 0xFFFFF);
+}
+
+// internal
+bool asCContext::ReserveStackSpace(asUINT size)
+{
+	// Make sure the first stack block is allocated
+	if( m_stackBlocks.GetLength() == 0 )
+	{
+		m_stackBlockSize = m_engine->initialContextStackSize;
+		asASSERT( m_stackBlockSize > 0 );
+
+		asDWORD *stack = asNEWARRAY(asDWORD,m_stackBlockSize);
+		if( stack == 0 )
+		{
+			// Out of memory
+			return false;
+		}
+
+		m_stackBlocks.PushLast(stack);
+		m_stackIndex = 0;
+		m_regs.stackPointer = m_stackBlocks[0] + m_stackBlockSize;
+	}
+
+	// Check if there is enough space on the current stack block, otherwise move
+	// to the next one. New and larger blocks will be allocated as necessary
+	while( m_regs.stackPointer - (size + RESERVE_STACK) < m_stackBlocks[m_stackIndex] )
+	{
+		// Make sure we don't allocate more space than allowed
+		if( m_engine->ep.maximumContextStackSize )
+		{
+			// This test will only stop growth once it has already crossed the limit
+			if( m_stackBlockSize * ((1 << (m_stackIndex+1)) - 1) > m_engine->ep.maximumContextStackSize )
+			{
+				m_isStackMemoryNotAllocated = true;
+
+				// Set the stackFramePointer, even though the stackPointer wasn't updated
+				m_regs.stackFramePointer = m_regs.stackPointer;
+
+				SetInternalException(TXT_STACK_OVERFLOW);
+				return false;
+			}
+		}
+
+		m_stackIndex++;
+		if( m_stackBlocks.GetLength() == m_stackIndex )
+		{
+			// Allocate the new stack block, with twice the size of the previous
+			asDWORD *stack = asNEWARRAY(asDWORD,(m_stackBlockSize << m_stackIndex));
+			if( stack == 0 )
+			{
+				// Out of memory
+				m_isStackMemoryNotAllocated = true;
+
+				// Set the stackFramePointer, even though the stackPointer wasn't updated
+				m_regs.stackFramePointer = m_regs.stackPointer;
+
+				SetInternalException(TXT_STACK_OVERFLOW);
+				return false;
+			}
+			m_stackBlocks.PushLast(stack);
+		}
+
+		// Update the stack pointer to point to the new block.
+		// Leave enough room above the stackpointer to copy the arguments from the previous stackblock
+		m_regs.stackPointer = m_stackBlocks[m_stackIndex] +
+			                  (m_stackBlockSize<<m_stackIndex) -
+			                  m_currentFunction->GetSpaceNeededForArguments() -
+			                  (m_currentFunction->objectType ? AS_PTR_SIZE : 0) -
+			                  (m_currentFunction->DoesReturnOnStack() ? AS_PTR_SIZE : 0);
+	}
+
+	return true;
+}
+
+// internal
+void asCContext::CallScriptFunction(asCScriptFunction *func)
+{
+	// Load the bytecode if the function hasn't been called before, see asEP_LAZY_LOAD_FUNCTIONS
+	if( func->isBodyPending && (func->module == 0 || func->module->LoadFunctionBody(func) < 0) )
+	{
+		// Tell the exception handler to clean up the arguments to this function
+		m_needToCleanupArgs = true;
+		SetInternalException(TXT_BYTECODE_NOT_LOADED);
+		return;
+	}
+
+	// Push the framepointer, function id and programCounter on the stack
+	PushCallState();
+
+	// Update the current function and program position before increasing the stack
+	// so the exception handler will know what to do if there is a stack overflow
+	m_currentFunction = func;
+	m_regs.programPointer = m_currentFunction->byteCode.AddressOf();
+
+	// Make sure there is space on the stack to execute the function
+	asDWORD *oldStackPointer = m_regs.stackPointer;
+	if( !ReserveStackSpace(func->stackNeeded) )
+		return;
+
+	// If a new stack block was allocated then we'll need to move
+	// over the function arguments to the new block
+	if( m_regs.stackPointer != oldStackPointer )
+	{
+		int numDwords = func->GetSpaceNeededForArguments() + (func->objectType ? AS_PTR_SIZE : 0) + (func->DoesReturnOnStack() ? AS_PTR_SIZE : 0);
+		memcpy(m_regs.stackPointer, oldStackPointer, sizeof(asDWORD)*numDwords);
+	}
+
+	PrepareScriptFunction();
+}
+
+void asCContext::TailCallScriptFunction(asCScriptFunction *func)
+{
+	// Load the bytecode if the function hasn't been called before, see asEP_LAZY_LOAD_FUNCTIONS
+	if( func->isBodyPending && (func->module == 0 || func->module->LoadFunctionBody(func) < 0) )
+	{
+		// Tell the exception handler to clean up the arguments to this function
+		m_needToCleanupArgs = true;
+		SetInternalException(TXT_BYTECODE_NOT_LOADED);
+		return;
+	}
+
+	// The initial function has no caller that the called function can return to, so
+	// it makes a normal call and continues with the instructions after the tail call
+	if( m_callStack.GetLength() == 0 || m_callStack[m_callStack.GetLength() - CALLSTACK_FRAME_SIZE] == 0 )
+	{
+		CallScriptFunction(func);
+		return;
+	}
+
+	// The compiler only emits the tail call when the current function has nothing left to
+	// do after the call, so its frame can be discarded. The arguments are moved up to take
+	// the place of the current function's arguments, and the called function will return
+	// directly to the caller of the current function.
+	int numDwords    = func->GetSpaceNeededForArguments() + (func->objectType ? AS_PTR_SIZE : 0) + (func->DoesReturnOnStack() ? AS_PTR_SIZE : 0);
+	int oldNumDwords = m_currentFunction->GetSpaceNeededForArguments() + (m_currentFunction->objectType ? AS_PTR_SIZE : 0) + (m_currentFunction->DoesReturnOnStack() ? AS_PTR_SIZE : 0);
+	asDWORD *args = m_regs.stackFramePointer + oldNumDwords - numDwords;
+	memmove(args, m_regs.stackPointer, sizeof(asDWORD)*numDwords);
+	m_regs.stackPointer = args;
+
+	// The caller will pop the arguments of the called function when it returns,
+	// so its stack pointer must be adjusted for the difference in size
+	asPWORD *s = m_callStack.AddressOf() + m_callStack.GetLength() - CALLSTACK_FRAME_SIZE;
+	s[3] = (asPWORD)((asDWORD*)s[3] + oldNumDwords - numDwords);
+
+	m_currentFunction = func;
+	m_regs.programPointer = m_currentFunction->byteCode.AddressOf();
+
+	// Make sure there is space on the stack to execute the function
+	asDWORD *oldStackPointer = m_regs.stackPointer;
+	if( !ReserveStackSpace(func->stackNeeded) )
+		return;
+
+	// If a new stack block was allocated then we'll need to move
+	// over the function arguments to the new block
+	if( m_regs.stackPointer != oldStackPointer )
+		memcpy(m_regs.stackPointer, oldStackPointer, sizeof(asDWORD)*numDwords);
+
+	PrepareScriptFunction();
+}
+
+void asCContext::PrepareScriptFunction()
+{
+	// Update framepointer
+	m_regs.stackFramePointer = m_regs.stackPointer;
+
+	// Set all object variables to 0 to guarantee that they are null before they are used
+	// Only variables on the heap should be cleared. The rest will be cleared by calling the constructor
+	asUINT n = m_currentFunction->objVariablesOnHeap;
+	while( n-- > 0 )
+	{
+		int pos = m_currentFunction->objVariablePos[n];
+		*(asPWORD*)&m_regs.stackFramePointer[-pos] = 0;
+	}
+
+	// Initialize the stack pointer with the space needed for local variables
+	m_regs.stackPointer -= m_currentFunction->variableSpace;
+
+	// Call the line callback for each script function, to guarantee that infinitely recursive scripts can
+	// be interrupted, even if the scripts have been compiled with asEP_BUILD_WITHOUT_LINE_CUES
+	if( m_regs.doProcessSuspend )
+	{
+		if( m_lineCallback )
+			CallLineCallback();
+		if( m_doSuspend )
+			m_status = asEXECUTION_SUSPENDED;
+	}
+}
+
+void asCContext::CallInterfaceMethod(asCScriptFunction *func)
+{
+	// Resolve the interface method using the current script type
+	asCScriptObject *obj = *(asCScriptObject**)(asPWORD*)m_regs.stackPointer;
+	if( obj == 0 )
+	{
+		// Tell the exception handler to clean up the arguments to this method
+		m_needToCleanupArgs = true;
+		SetInternalException(TXT_NULL_POINTER_ACCESS);
+		return;
+	}
+
+	asCObjectType *objType = obj->objType;
+
+	// TODO: runtime optimize: The object type should have a list of only those methods that
+	//                         implement interface methods. This list should be ordered by
+	//                         the signatureId so that a binary search can be made, instead
+	//                         of a linear search.
+	//
+	//                         When this is done, we must also make sure the signatureId of a
+	//                         function never changes, e.g. when if the signature functions are
+	//                         released.
+
+	// Search the object type for a function that matches the interface function
+	asCScriptFunction *realFunc = 0;
+	if( func->funcType == asFUNC_INTERFACE )
+	{
+		for( asUINT n = 0; n < objType->methods.GetLength(); n++ )
+		{
+			asCScriptFunction *f2 = m_engine->scriptFunctions[objType->methods[n]];
+			if( f2->signatureId == func->signatureId )
+			{
+				if( f2->funcType == asFUNC_VIRTUAL )
+					realFunc = objType->virtualFunctionTable[f2->vfTableIdx];
+				else
+					realFunc = f2;
+				break;
+			}
+		}
+
+		if( realFunc == 0 )
+		{
+			// Tell the exception handler to clean up the arguments to this method
+			m_needToCleanupArgs = true;
+			SetInternalException(TXT_NULL_POINTER_ACCESS);
+			return;
+		}
+	}
+	else // if( func->funcType == asFUNC_VIRTUAL )
+	{
+		realFunc = objType->virtualFunctionTable[func->vfTableIdx];
+	}
+
+	// Then call the true script function
+	CallScriptFunction(realFunc);
+}
+
+void asCContext::ExecuteNext()
+{
+	asDWORD *l_bc = m_regs.programPointer;
+	asDWORD *l_sp = m_regs.stackPointer;
+	asDWORD *l_fp = m_regs.stackFramePointer;
+
+	for(;;)
+	{
+
+#ifdef AS_DEBUG
+	// Gather statistics on executed bytecode
+	stats.Instr(*(asBYTE*)l_bc);
+
+	// Used to verify that the size of the instructions are correct
+	asDWORD *old = l_bc;
+#endif
+
+
+	// Remember to keep the cases in order and without
+	// gaps, because that will make the switch faster.
+	// It will be faster since only one lookup will be
+	// made to find the correct jump destination. If not
+	// in order, the switch will make two lookups.
+	switch( *(asBYTE*)l_bc )
+	{
+//--------------
+// memory access functions
+
+	case asBC_PopPtr:
+		// Pop a pointer from the stack
+		l_sp += AS_PTR_SIZE;
+		l_bc++;
+		break;
+
+	case asBC_PshGPtr:
+		// Replaces PGA + RDSPtr
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = *(asPWORD*)asBC_PTRARG(l_bc);
+		l_bc += 1 + AS_PTR_SIZE;
+		break;
+
+	// Push a dword value on the stack
+	case asBC_PshC4:
+		--l_sp;
+		*l_sp = asBC_DWORDARG(l_bc);
+		l_bc += 2;
+		break;
+
+	// Push the dword value of a variable on the stack
+	case asBC_PshV4:
+		--l_sp;
+		*l_sp = *(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	// Push the address of a variable on the stack
+	case asBC_PSF:
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = asPWORD(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	// Swap the top 2 pointers on the stack
+	case asBC_SwapPtr:
+		{
+			asPWORD p = (asPWORD)*l_sp;
+			*(asPWORD*)l_sp = *(asPWORD*)(l_sp+AS_PTR_SIZE);
+			*(asPWORD*)(l_sp+AS_PTR_SIZE) = p;
+			l_bc++;
+		}
+		break;
+
+	// Do a boolean not operation, modifying the value of the variable
+	case asBC_NOT:
+#if AS_SIZEOF_BOOL == 1
+		{
+			// Set the value to true if it is equal to 0
+
+			// We need to use volatile here to tell the compiler it cannot
+			// change the order of read and write operations on the pointer.
+
+			volatile asBYTE *ptr = (asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
+			asBYTE val = (ptr[0] == 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
+			ptr[0] = val; // The result is stored in the lower byte
+			ptr[1] = 0;   // Make sure the rest of the DWORD is 0
+			ptr[2] = 0;
+			ptr[3] = 0;
+		}
+#else
+		*(l_fp - asBC_SWORDARG0(l_bc)) = (*(l_fp - asBC_SWORDARG0(l_bc)) == 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
+#endif
+		l_bc++;
+		break;
+
+	// Push the dword value of a global variable on the stack
+	case asBC_PshG4:
+		--l_sp;
+		*l_sp = *(asDWORD*)asBC_PTRARG(l_bc);
+		l_bc += 1 + AS_PTR_SIZE;
+		break;
+
+	// Load the address of a global variable in the register, then
+	// copy the value of the global variable into a local variable
+	case asBC_LdGRdR4:
+		*(void**)&m_regs.valueRegister = (void*)asBC_PTRARG(l_bc);
+		*(l_fp - asBC_SWORDARG0(l_bc)) = **(asDWORD**)&m_regs.valueRegister;
+		l_bc += 1+AS_PTR_SIZE;
+		break;
+
+//----------------
+// path control instructions
+
+	// Begin execution of a script function
+	case asBC_CALL:
+		{
+			int i = asBC_INTARG(l_bc);
+			l_bc += 2;
+
+			asASSERT( i >= 0 );
+			asASSERT( (i & FUNC_IMPORTED) == 0 );
+
+			// Need to move the values back to the context
+			m_regs.programPointer = l_bc;
+			m_regs.stackPointer = l_sp;
+			m_regs.stackFramePointer = l_fp;
+
+			CallScriptFunction(m_engine->scriptFunctions[i]);
+
+			// Extract the values from the context again
+			l_bc = m_regs.programPointer;
+			l_sp = m_regs.stackPointer;
+			l_fp = m_regs.stackFramePointer;
+
+			// If status isn't active anymore then we must stop
+			if( m_status != asEXECUTION_ACTIVE )
+				return;
+		}
+		break;
+
+	// Return to the caller, and remove the arguments from the stack
+	case asBC_RET:
+		{
+			// Return if this was the first function, or a nested execution
+			if( m_callStack.GetLength() == 0 ||
+				m_callStack[m_callStack.GetLength() - CALLSTACK_FRAME_SIZE] == 0 )
+			{
+				m_status = asEXECUTION_FINISHED;
+				return;
+			}
+
+			asWORD w = asBC_WORDARG0(l_bc);
+
+			// Read the old framepointer, functionid, and programCounter from the call stack
+			PopCallState();
+
+			// Extract the values from the context again
+			l_bc = m_regs.programPointer;
+			l_sp = m_regs.stackPointer;
+			l_fp = m_regs.stackFramePointer;
+
+			// Pop arguments from stack
+			l_sp += w;
+		}
+		break;
+
+	// Jump to a relative position
+	case asBC_JMP:
+		l_bc += 2 + asBC_INTARG(l_bc);
+		break;
+
+//----------------
+// Conditional jumps
+
+	// Jump to a relative position if the value in the register is 0
+	case asBC_JZ:
+		if( *(int*)&m_regs.valueRegister == 0 )
+			l_bc += asBC_INTARG(l_bc) + 2;
+		else
+			l_bc += 2;
+		break;
+
+	// Jump to a relative position if the value in the register is not 0
+	case asBC_JNZ:
+		if( *(int*)&m_regs.valueRegister != 0 )
+			l_bc += asBC_INTARG(l_bc) + 2;
+		else
+			l_bc += 2;
+		break;
+
+	// Jump to a relative position if the value in the register is negative
+	case asBC_JS:
+		if( *(int*)&m_regs.valueRegister < 0 )
+			l_bc += asBC_INTARG(l_bc) + 2;
+		else
+			l_bc += 2;
+		break;
+
+	// Jump to a relative position if the value in the register it not negative
+	case asBC_JNS:
+		if( *(int*)&m_regs.valueRegister >= 0 )
+			l_bc += asBC_INTARG(l_bc) + 2;
+		else
+			l_bc += 2;
+		break;
+
+	// Jump to a relative position if the value in the register is greater than 0
+	case asBC_JP:
+		if( *(int*)&m_regs.valueRegister > 0 )
+			l_bc += asBC_INTARG(l_bc) + 2;
+		else
+			l_bc += 2;
+		break;
+
+	// Jump to a relative position if the value in the register is not greater than 0
+	case asBC_JNP:
+		if( *(int*)&m_regs.valueRegister <= 0 )
+			l_bc += asBC_INTARG(l_bc) + 2;
+		else
+			l_bc += 2;
+		break;
+//--------------------
+// test instructions
+
+	// If the value in the register is 0, then set the register to 1, else to 0
+	case asBC_TZ:
+#if AS_SIZEOF_BOOL == 1
+		{
+			// Set the value to true if it is equal to 0
+
+			// We need to use volatile here to tell the compiler it cannot
+			// change the order of read and write operations on valueRegister.
+
+			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
+			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
+			asBYTE val = (regPtr[0] == 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
+			regBptr[0] = val; // The result is stored in the lower byte
+			regBptr[1] = 0;   // Make sure the rest of the register is 0
+			regBptr[2] = 0;
+			regBptr[3] = 0;
+			regBptr[4] = 0;
+			regBptr[5] = 0;
+			regBptr[6] = 0;
+			regBptr[7] = 0;
+		}
+#else
+		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister == 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
+#endif
+		l_bc++;
+		break;
+
+	// If the value in the register is not 0, then set the register to 1, else to 0
+	case asBC_TNZ:
+#if AS_SIZEOF_BOOL == 1
+		{
+			// Set the value to true if it is not equal to 0
+
+			// We need to use volatile here to tell the compiler it cannot
+			// change the order of read and write operations on valueRegister.
+
+			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
+			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
+			asBYTE val = (regPtr[0] == 0) ? 0 : VALUE_OF_BOOLEAN_TRUE;
+			regBptr[0] = val; // The result is stored in the lower byte
+			regBptr[1] = 0;   // Make sure the rest of the register is 0
+			regBptr[2] = 0;
+			regBptr[3] = 0;
+			regBptr[4] = 0;
+			regBptr[5] = 0;
+			regBptr[6] = 0;
+			regBptr[7] = 0;
+		}
+#else
+		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister == 0 ? 0 : VALUE_OF_BOOLEAN_TRUE);
+#endif
+		l_bc++;
+		break;
+
+	// If the value in the register is negative, then set the register to 1, else to 0
+	case asBC_TS:
+#if AS_SIZEOF_BOOL == 1
+		{
+			// Set the value to true if it is less than 0
+
+			// We need to use volatile here to tell the compiler it cannot
+			// change the order of read and write operations on valueRegister.
+
+			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
+			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
+			asBYTE val = (regPtr[0] < 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
+			regBptr[0] = val; // The result is stored in the lower byte
+			regBptr[1] = 0;   // Make sure the rest of the register is 0
+			regBptr[2] = 0;
+			regBptr[3] = 0;
+			regBptr[4] = 0;
+			regBptr[5] = 0;
+			regBptr[6] = 0;
+			regBptr[7] = 0;
+		}
+#else
+		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister < 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
+#endif
+		l_bc++;
+		break;
+
+	// If the value in the register is not negative, then set the register to 1, else to 0
+	case asBC_TNS:
+#if AS_SIZEOF_BOOL == 1
+		{
+			// Set the value to true if it is not less than 0
+
+			// We need to use volatile here to tell the compiler it cannot
+			// change the order of read and write operations on valueRegister.
+
+			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
+			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
+			asBYTE val = (regPtr[0] >= 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
+			regBptr[0] = val; // The result is stored in the lower byte
+			regBptr[1] = 0;   // Make sure the rest of the register is 0
+			regBptr[2] = 0;
+			regBptr[3] = 0;
+			regBptr[4] = 0;
+			regBptr[5] = 0;
+			regBptr[6] = 0;
+			regBptr[7] = 0;
+		}
+#else
+		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister < 0 ? 0 : VALUE_OF_BOOLEAN_TRUE);
+#endif
+		l_bc++;
+		break;
+
+	// If the value in the register is greater than 0, then set the register to 1, else to 0
+	case asBC_TP:
+#if AS_SIZEOF_BOOL == 1
+		{
+			// Set the value to true if it is greater than 0
+
+			// We need to use volatile here to tell the compiler it cannot
+			// change the order of read and write operations on valueRegister.
+
+			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
+			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
+			asBYTE val = (regPtr[0] > 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
+			regBptr[0] = val; // The result is stored in the lower byte
+			regBptr[1] = 0;   // Make sure the rest of the register is 0
+			regBptr[2] = 0;
+			regBptr[3] = 0;
+			regBptr[4] = 0;
+			regBptr[5] = 0;
+			regBptr[6] = 0;
+			regBptr[7] = 0;
+		}
+#else
+		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister > 0 ? VALUE_OF_BOOLEAN_TRUE : 0);
+#endif
+		l_bc++;
+		break;
+
+	// If the value in the register is not greater than 0, then set the register to 1, else to 0
+	case asBC_TNP:
+#if AS_SIZEOF_BOOL == 1
+		{
+			// Set the value to true if it is not greater than 0
+
+			// We need to use volatile here to tell the compiler it cannot
+			// change the order of read and write operations on valueRegister.
+
+			volatile int    *regPtr  = (int*)&m_regs.valueRegister;
+			volatile asBYTE *regBptr = (asBYTE*)&m_regs.valueRegister;
+			asBYTE val = (regPtr[0] <= 0) ? VALUE_OF_BOOLEAN_TRUE : 0;
+			regBptr[0] = val; // The result is stored in the lower byte
+			regBptr[1] = 0;   // Make sure the rest of the register is 0
+			regBptr[2] = 0;
+			regBptr[3] = 0;
+			regBptr[4] = 0;
+			regBptr[5] = 0;
+			regBptr[6] = 0;
+			regBptr[7] = 0;
+		}
+#else
+		*(int*)&m_regs.valueRegister = (*(int*)&m_regs.valueRegister > 0 ? 0 : VALUE_OF_BOOLEAN_TRUE);
+#endif
+		l_bc++;
+		break;
+
+//--------------------
+// negate value
+
+	// Negate the integer value in the variable
+	case asBC_NEGi:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = asDWORD(-int(*(l_fp - asBC_SWORDARG0(l_bc))));
+		l_bc++;
+		break;
+
+	// Negate the float value in the variable
+	case asBC_NEGf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = -*(float*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	// Negate the double value in the variable
+	case asBC_NEGd:
+		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = -*(double*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+//-------------------------
+// Increment value pointed to by address in register
+
+	// Increment the short value pointed to by the register
+	case asBC_INCi16:
+		(**(short**)&m_regs.valueRegister)++;
+		l_bc++;
+		break;
+
+	// Increment the byte value pointed to by the register
+	case asBC_INCi8:
+		(**(char**)&m_regs.valueRegister)++;
+		l_bc++;
+		break;
+
+	// Decrement the short value pointed to by the register
+	case asBC_DECi16:
+		(**(short**)&m_regs.valueRegister)--;
+		l_bc++;
+		break;
+
+	// Decrement the byte value pointed to by the register
+	case asBC_DECi8:
+		(**(char**)&m_regs.valueRegister)--;
+		l_bc++;
+		break;
+
+	// Increment the integer value pointed to by the register
+	case asBC_INCi:
+		++(**(int**)&m_regs.valueRegister);
+		l_bc++;
+		break;
+
+	// Decrement the integer value pointed to by the register
+	case asBC_DECi:
+		--(**(int**)&m_regs.valueRegister);
+		l_bc++;
+		break;
+
+	// Increment the float value pointed to by the register
+	case asBC_INCf:
+		++(**(float**)&m_regs.valueRegister);
+		l_bc++;
+		break;
+
+	// Decrement the float value pointed to by the register
+	case asBC_DECf:
+		--(**(float**)&m_regs.valueRegister);
+		l_bc++;
+		break;
+
+	// Increment the double value pointed to by the register
+	case asBC_INCd:
+		++(**(double**)&m_regs.valueRegister);
+		l_bc++;
+		break;
+
+	// Decrement the double value pointed to by the register
+	case asBC_DECd:
+		--(**(double**)&m_regs.valueRegister);
+		l_bc++;
+		break;
+
+	// Increment the local integer variable
+	case asBC_IncVi:
+		(*(int*)(l_fp - asBC_SWORDARG0(l_bc)))++;
+		l_bc++;
+		break;
+
+	// Decrement the local integer variable
+	case asBC_DecVi:
+		(*(int*)(l_fp - asBC_SWORDARG0(l_bc)))--;
+		l_bc++;
+		break;
+
+//--------------------
+// bits instructions
+
+	// Do a bitwise not on the value in the variable
+	case asBC_BNOT:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = ~*(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	// Do a bitwise and of two variables and store the result in a third variable
+	case asBC_BAND:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) & *(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	// Do a bitwise or of two variables and store the result in a third variable
+	case asBC_BOR:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) | *(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	// Do a bitwise xor of two variables and store the result in a third variable
+	case asBC_BXOR:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) ^ *(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	// Do a logical shift left of two variables and store the result in a third variable
+	case asBC_BSLL:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) << *(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	// Do a logical shift right of two variables and store the result in a third variable
+	case asBC_BSRL:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc)) >> *(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	// Do an arithmetic shift right of two variables and store the result in a third variable
+	case asBC_BSRA:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(l_fp - asBC_SWORDARG1(l_bc))) >> *(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	case asBC_COPY:
+		{
+			void *d = (void*)*(asPWORD*)l_sp; l_sp += AS_PTR_SIZE;
+			void *s = (void*)*(asPWORD*)l_sp;
+			if( s == 0 || d == 0 )
+			{
+				// Need to move the values back to the context
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				// Raise exception
+				SetInternalException(TXT_NULL_POINTER_ACCESS);
+				return;
+			}
+			memcpy(d, s, asBC_WORDARG0(l_bc)*4);
+
+			// replace the pointer on the stack with the lvalue
+			*(asPWORD**)l_sp = (asPWORD*)d;
+		}
+		l_bc += 2;
+		break;
+
+	case asBC_PshC8:
+		l_sp -= 2;
+		*(asQWORD*)l_sp = asBC_QWORDARG(l_bc);
+		l_bc += 3;
+		break;
+
+	case asBC_PshVPtr:
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = *(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	case asBC_RDSPtr:
+		{
+			// The pointer must not be null
+			asPWORD a = *(asPWORD*)l_sp;
+			if( a == 0 )
+			{
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				SetInternalException(TXT_NULL_POINTER_ACCESS);
+				return;
+			}
+			// Pop an address from the stack, read a pointer from that address and push it on the stack
+			*(asPWORD*)l_sp = *(asPWORD*)a;
+		}
+		l_bc++;
+		break;
+
+	//----------------------------
+	// Comparisons
+	case asBC_CMPd:
+		{
+			// Do a comparison of the values, rather than a subtraction
+			// in order to get proper behaviour for infinity values.
+			double dbl1 = *(double*)(l_fp - asBC_SWORDARG0(l_bc));
+			double dbl2 = *(double*)(l_fp - asBC_SWORDARG1(l_bc));
+			if( dbl1 == dbl2 )     *(int*)&m_regs.valueRegister =  0;
+			else if( dbl1 < dbl2 ) *(int*)&m_regs.valueRegister = -1;
+			else                   *(int*)&m_regs.valueRegister =  1;
+			l_bc += 2;
+		}
+		break;
+
+	case asBC_CMPu:
+		{
+			asDWORD d1 = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+			asDWORD d2 = *(asDWORD*)(l_fp - asBC_SWORDARG1(l_bc));
+			if( d1 == d2 )     *(int*)&m_regs.valueRegister =  0;
+			else if( d1 < d2 ) *(int*)&m_regs.valueRegister = -1;
+			else               *(int*)&m_regs.valueRegister =  1;
+			l_bc += 2;
+		}
+		break;
+
+	case asBC_CMPf:
+		{
+			// Do a comparison of the values, rather than a subtraction
+			// in order to get proper behaviour for infinity values.
+			float f1 = *(float*)(l_fp - asBC_SWORDARG0(l_bc));
+			float f2 = *(float*)(l_fp - asBC_SWORDARG1(l_bc));
+			if( f1 == f2 )     *(int*)&m_regs.valueRegister =  0;
+			else if( f1 < f2 ) *(int*)&m_regs.valueRegister = -1;
+			else               *(int*)&m_regs.valueRegister =  1;
+			l_bc += 2;
+		}
+		break;
+
+	case asBC_CMPi:
+		{
+			int i1 = *(int*)(l_fp - asBC_SWORDARG0(l_bc));
+			int i2 = *(int*)(l_fp - asBC_SWORDARG1(l_bc));
+			if( i1 == i2 )     *(int*)&m_regs.valueRegister =  0;
+			else if( i1 < i2 ) *(int*)&m_regs.valueRegister = -1;
+			else               *(int*)&m_regs.valueRegister =  1;
+			l_bc += 2;
+		}
+		break;
+
+	//----------------------------
+	// Comparisons with constant value
+	case asBC_CMPIi:
+		{
+			int i1 = *(int*)(l_fp - asBC_SWORDARG0(l_bc));
+			int i2 = asBC_INTARG(l_bc);
+			if( i1 == i2 )     *(int*)&m_regs.valueRegister =  0;
+			else if( i1 < i2 ) *(int*)&m_regs.valueRegister = -1;
+			else               *(int*)&m_regs.valueRegister =  1;
+			l_bc += 2;
+		}
+		break;
+
+	case asBC_CMPIf:
+		{
+			// Do a comparison of the values, rather than a subtraction
+			// in order to get proper behaviour for infinity values.
+			float f1 = *(float*)(l_fp - asBC_SWORDARG0(l_bc));
+			float f2 = asBC_FLOATARG(l_bc);
+			if( f1 == f2 )     *(int*)&m_regs.valueRegister =  0;
+			else if( f1 < f2 ) *(int*)&m_regs.valueRegister = -1;
+			else               *(int*)&m_regs.valueRegister =  1;
+			l_bc += 2;
+		}
+		break;
+
+	case asBC_CMPIu:
+		{
+			asDWORD d1 = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+			asDWORD d2 = asBC_DWORDARG(l_bc);
+			if( d1 == d2 )     *(int*)&m_regs.valueRegister =  0;
+			else if( d1 < d2 ) *(int*)&m_regs.valueRegister = -1;
+			else               *(int*)&m_regs.valueRegister =  1;
+			l_bc += 2;
+		}
+		break;
+
+	case asBC_JMPP:
+		l_bc += 1 + (*(int*)(l_fp - asBC_SWORDARG0(l_bc)))*2;
+		break;
+
+	case asBC_PopRPtr:
+		*(asPWORD*)&m_regs.valueRegister = *(asPWORD*)l_sp;
+		l_sp += AS_PTR_SIZE;
+		l_bc++;
+		break;
+
+	case asBC_PshRPtr:
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = *(asPWORD*)&m_regs.valueRegister;
+		l_bc++;
+		break;
+
+	case asBC_STR:
+		{
+			// Get the string id from the argument
+			asWORD w = asBC_WORDARG0(l_bc);
+
+			// If the application created the string object in advance the 
+			// call to the string factory is skipped, and the object is used
+			if( w < m_engine->stringConstantObjects.GetLength() && m_engine->stringConstantObjects[w] &&
+				*(asBYTE*)(l_bc+1) == asBC_CALLSYS &&
+				m_engine->stringFactory && asBC_INTARG(l_bc+1) == m_engine->stringFactory->id )
+			{
+				*(asPWORD*)&m_regs.valueRegister = (asPWORD)m_engine->stringConstantObjects[w];
+				l_bc += 3;
+				break;
+			}
+
+			// Push the string pointer on the stack
+			const asCString &b = m_engine->GetConstantString(w);
+			l_sp -= AS_PTR_SIZE;
+			*(asPWORD*)l_sp = (asPWORD)b.AddressOf();
+			// Push the string length on the stack
+			--l_sp;
+			*l_sp = (asDWORD)b.GetLength();
+			l_bc++;
+		}
+		break;
+
+	case asBC_CALLSYS:
+		{
+			// Get function ID from the argument
+			int i = asBC_INTARG(l_bc);
+
+			// Need to move the values back to the context as the called functions
+			// may use the debug interface to inspect the registers
+			m_regs.programPointer    = l_bc;
+			m_regs.stackPointer      = l_sp;
+			m_regs.stackFramePointer = l_fp;
+
+			l_sp += CallSystemFunction(i, this, 0);
+
+			// Update the program position after the call so that line number is correct
+			l_bc += 2;
+
+			if( m_regs.doProcessSuspend )
+			{
+				// Should the execution be suspended?
+				if( m_doSuspend )
+				{
+					m_regs.programPointer    = l_bc;
+					m_regs.stackPointer      = l_sp;
+					m_regs.stackFramePointer = l_fp;
+
+					m_status = asEXECUTION_SUSPENDED;
+					return;
+				}
+				// An exception might have been raised
+				if( m_status != asEXECUTION_ACTIVE )
+				{
+					m_regs.programPointer    = l_bc;
+					m_regs.stackPointer      = l_sp;
+					m_regs.stackFramePointer = l_fp;
+
+					return;
+				}
+			}
+		}
+		break;
+
+	case asBC_CALLBND:
+		{
+			// Get the function ID from the stack
+			int i = asBC_INTARG(l_bc);
+			l_bc += 2;
+
+			asASSERT( i >= 0 );
+			asASSERT( i & FUNC_IMPORTED );
+
+			// Need to move the values back to the context
+			m_regs.programPointer    = l_bc;
+			m_regs.stackPointer      = l_sp;
+			m_regs.stackFramePointer = l_fp;
+
+			int funcId = m_engine->importedFunctions[i & ~FUNC_IMPORTED]->boundFunctionId;
+			if( funcId == -1 )
+			{
+				// Tell the exception handler to clean up the arguments to this function
+				m_needToCleanupArgs = true;
+				SetInternalException(TXT_UNBOUND_FUNCTION);
+				return;
+			}
+			else
+			{
+				asCScriptFunction *func = m_engine->GetScriptFunction(funcId);
+
+				CallScriptFunction(func);
+			}
+
+			// Extract the values from the context again
+			l_bc = m_regs.programPointer;
+			l_sp = m_regs.stackPointer;
+			l_fp = m_regs.stackFramePointer;
+
+			// If status isn't active anymore then we must stop
+			if( m_status != asEXECUTION_ACTIVE )
+				return;
+		}
+		break;
+
+	case asBC_SUSPEND:
+		if( m_regs.doProcessSuspend )
+		{
+			if( m_lineCallback )
+			{
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				CallLineCallback();
+			}
+			if( m_doSuspend )
+			{
+				l_bc++;
+
+				// Need to move the values back to the context
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				m_status = asEXECUTION_SUSPENDED;
+				return;
+			}
+		}
+
+		l_bc++;
+		break;
+
+	case asBC_ALLOC:
+		{
+			asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
+			int func = asBC_INTARG(l_bc+AS_PTR_SIZE);
+
+			if( objType->flags & asOBJ_SCRIPT_OBJECT )
+			{
+				// Need to move the values back to the context as the construction
+				// of the script object may reuse the context for nested calls.
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				// Pre-allocate the memory
+				asDWORD *mem = (asDWORD*)m_engine->CallAlloc(objType);
+
+				// Pre-initialize the memory by calling the constructor for asCScriptObject
+				ScriptObject_Construct(objType, (asCScriptObject*)mem);
+
+				// Call the constructor to initalize the memory
+				asCScriptFunction *f = m_engine->scriptFunctions[func];
+
+				asDWORD **a = (asDWORD**)*(asPWORD*)(m_regs.stackPointer + f->GetSpaceNeededForArguments());
+				if( a ) *a = mem;
+
+				// Push the object pointer on the stack
+				m_regs.stackPointer -= AS_PTR_SIZE;
+				*(asPWORD*)m_regs.stackPointer = (asPWORD)mem;
+
+				m_regs.programPointer += 2+AS_PTR_SIZE;
+
+				CallScriptFunction(f);
+
+				// Extract the values from the context again
+				l_bc = m_regs.programPointer;
+				l_sp = m_regs.stackPointer;
+				l_fp = m_regs.stackFramePointer;
+
+				// If status isn't active anymore then we must stop
+				if( m_status != asEXECUTION_ACTIVE )
+					return;
+			}
+			else
+			{
+				// Pre-allocate the memory
+				asDWORD *mem = (asDWORD*)m_engine->CallAlloc(objType);
+
+				if( func )
+				{
+					// Need to move the values back to the context as the called functions
+					// may use the debug interface to inspect the registers
+					m_regs.programPointer    = l_bc;
+					m_regs.stackPointer      = l_sp;
+					m_regs.stackFramePointer = l_fp;
+
+					l_sp += CallSystemFunction(func, this, mem);
+				}
+
+				// Pop the variable address from the stack
+				asDWORD **a = (asDWORD**)*(asPWORD*)l_sp;
+				l_sp += AS_PTR_SIZE;
+				if( a ) *a = mem;
+
+				l_bc += 2+AS_PTR_SIZE;
+
+				if( m_regs.doProcessSuspend )
+				{
+					// Should the execution be suspended?
+					if( m_doSuspend )
+					{
+						m_regs.programPointer    = l_bc;
+						m_regs.stackPointer      = l_sp;
+						m_regs.stackFramePointer = l_fp;
+
+						m_status = asEXECUTION_SUSPENDED;
+						return;
+					}
+					// An exception might have been raised
+					if( m_status != asEXECUTION_ACTIVE )
+					{
+						m_regs.programPointer    = l_bc;
+						m_regs.stackPointer      = l_sp;
+						m_regs.stackFramePointer = l_fp;
+
+						m_engine->CallFree(mem);
+						*a = 0;
+
+						return;
+					}
+				}
+			}
+		}
+		break;
+
+	case asBC_FREE:
+		{
+			// Get the variable that holds the object handle/reference
+			asPWORD *a = (asPWORD*)asPWORD(l_fp - asBC_SWORDARG0(l_bc));
+			if( *a )
+			{
+				asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
+				asSTypeBehaviour *beh = &objType->beh;
+
+				// Need to move the values back to the context as the called functions
+				// may use the debug interface to inspect the registers
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				if( objType->flags & asOBJ_REF )
+				{
+					asASSERT( (objType->flags & asOBJ_NOCOUNT) || beh->release );
+					if( beh->release )
+						m_engine->CallObjectMethod((void*)(asPWORD)*a, beh->release);
+				}
+				else
+				{
+					if( beh->destruct )
+						m_engine->CallObjectMethod((void*)(asPWORD)*a, beh->destruct);
+
+					m_engine->CallFree((void*)(asPWORD)*a);
+				}
+
+				// Clear the variable
+				*a = 0;
+			}
+		}
+		l_bc += 1+AS_PTR_SIZE;
+		break;
+
+	case asBC_LOADOBJ:
+		{
+			// Move the object pointer from the object variable into the object register
+			void **a = (void**)(l_fp - asBC_SWORDARG0(l_bc));
+			m_regs.objectType = 0;
+			m_regs.objectRegister = *a;
+			*a = 0;
+		}
+		l_bc++;
+		break;
+
+	case asBC_STOREOBJ:
+		// Move the object pointer from the object register to the object variable
+		*(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asPWORD(m_regs.objectRegister);
+		m_regs.objectRegister = 0;
+		l_bc++;
+		break;
+
+	case asBC_GETOBJ:
+		{
+			// Read variable index from location on stack
+			asPWORD *a = (asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
+			asDWORD offset = *(asDWORD*)a;
+			// Move pointer from variable to the same location on the stack
+			asPWORD *v = (asPWORD*)(l_fp - offset);
+			*a = *v;
+			// Clear variable
+			*v = 0;
+		}
+		l_bc++;
+		break;
+
+	case asBC_REFCPY:
+		{
+			asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
+			asSTypeBehaviour *beh = &objType->beh;
+
+			// Pop address of destination pointer from the stack
+			void **d = (void**)*(asPWORD*)l_sp;
+			l_sp += AS_PTR_SIZE;
+
+			// Read wanted pointer from the stack
+			void *s = (void*)*(asPWORD*)l_sp;
+
+			// Need to move the values back to the context as the called functions
+			// may use the debug interface to inspect the registers
+			m_regs.programPointer    = l_bc;
+			m_regs.stackPointer      = l_sp;
+			m_regs.stackFramePointer = l_fp;
+
+			if( !(objType->flags & asOBJ_NOCOUNT) )
+			{
+				// Release previous object held by destination pointer
+				if( *d != 0 )
+					m_engine->CallObjectMethod(*d, beh->release);
+				// Increase ref counter of wanted object
+				if( s != 0 )
+					m_engine->CallObjectMethod(s, beh->addref);
+			}
+
+			// Set the new object in the destination
+			*d = s;
+		}
+		l_bc += 1+AS_PTR_SIZE;
+		break;
+
+	case asBC_CHKREF:
+		{
+			// Verify if the pointer on the stack is null
+			// This is used when validating a pointer that an operator will work on
 			asPWORD a = *(asPWORD*)l_sp;
 			if( a == 0 )
 			{
@@ -2181,440 +3813,553 @@ void asCContext::ExecuteNext()
 				SetInternalException(TXT_NULL_POINTER_ACCESS);
 				return;
 			}
-			// Pop an address from the stack, read a pointer from that address and push it on the stack
-			*(asPWORD*)l_sp = *(asPWORD*)a;
 		}
 		l_bc++;
 		break;
 
-	//----------------------------
-	// Comparisons
-	case asBC_CMPd:
+	case asBC_GETOBJREF:
 		{
-			// Do a comparison of the values, rather than a subtraction
-			// in order to get proper behaviour for infinity values.
-			double dbl1 = *(double*)(l_fp - asBC_SWORDARG0(l_bc));
-			double dbl2 = *(double*)(l_fp - asBC_SWORDARG1(l_bc));
-			if( dbl1 == dbl2 )     *(int*)&m_regs.valueRegister =  0;
-			else if( dbl1 < dbl2 ) *(int*)&m_regs.valueRegister = -1;
-			else                   *(int*)&m_regs.valueRegister =  1;
-			l_bc += 2;
+			// Get the location on the stack where the reference will be placed
+			asPWORD *a = (asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
+
+			// Replace the variable index with the object handle held in the variable
+			*(asPWORD**)a = *(asPWORD**)(l_fp - *a);
 		}
+		l_bc++;
 		break;
 
-	case asBC_CMPu:
+	case asBC_GETREF:
 		{
-			asDWORD d1 = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-			asDWORD d2 = *(asDWORD*)(l_fp - asBC_SWORDARG1(l_bc));
-			if( d1 == d2 )     *(int*)&m_regs.valueRegister =  0;
-			else if( d1 < d2 ) *(int*)&m_regs.valueRegister = -1;
-			else               *(int*)&m_regs.valueRegister =  1;
-			l_bc += 2;
+			// Get the location on the stack where the reference will be placed
+			asPWORD *a = (asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
+
+			// Replace the variable index with the address of the variable
+			*(asPWORD**)a = (asPWORD*)(l_fp - (int)*a);
 		}
+		l_bc++;
 		break;
 
-	case asBC_CMPf:
+	case asBC_PshNull:
+		// Push a null pointer on the stack
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = 0;
+		l_bc++;
+		break;
+
+	case asBC_ClrVPtr:
+		// TODO: runtime optimize: Is this instruction really necessary?
+		//                         CallScriptFunction() can clear the null handles upon entry, just as is done for
+		//                         all other object variables
+		// Clear pointer variable
+		*(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = 0;
+		l_bc++;
+		break;
+
+	case asBC_OBJTYPE:
+		// Push the object type on the stack
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = asBC_PTRARG(l_bc);
+		l_bc += 1+AS_PTR_SIZE;
+		break;
+
+	case asBC_TYPEID:
+		// Equivalent to PshC4, but kept as separate instruction for bytecode serialization
+		--l_sp;
+		*l_sp = asBC_DWORDARG(l_bc);
+		l_bc += 2;
+		break;
+
+	case asBC_SetV4:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = asBC_DWORDARG(l_bc);
+		l_bc += 2;
+		break;
+
+	case asBC_SetV8:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asBC_QWORDARG(l_bc);
+		l_bc += 3;
+		break;
+
+	case asBC_ADDSi:
 		{
-			// Do a comparison of the values, rather than a subtraction
-			// in order to get proper behaviour for infinity values.
-			float f1 = *(float*)(l_fp - asBC_SWORDARG0(l_bc));
-			float f2 = *(float*)(l_fp - asBC_SWORDARG1(l_bc));
-			if( f1 == f2 )     *(int*)&m_regs.valueRegister =  0;
-			else if( f1 < f2 ) *(int*)&m_regs.valueRegister = -1;
-			else               *(int*)&m_regs.valueRegister =  1;
-			l_bc += 2;
+			// The pointer must not be null
+			asPWORD a = *(asPWORD*)l_sp;
+			if( a == 0 )
+			{
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				SetInternalException(TXT_NULL_POINTER_ACCESS);
+				return;
+			}
+			// Add an offset to the pointer
+			*(asPWORD*)l_sp = a + asBC_SWORDARG0(l_bc);
+		}
+		l_bc += 2;
+		break;
+
+	case asBC_CpyVtoV4:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc));
+		l_bc += 2;
+		break;
+
+	case asBC_CpyVtoV8:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc));
+		l_bc += 2;
+		break;
+
+	case asBC_CpyVtoR4:
+		*(asDWORD*)&m_regs.valueRegister = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	case asBC_CpyVtoR8:
+		*(asQWORD*)&m_regs.valueRegister = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	case asBC_CpyVtoG4:
+		*(asDWORD*)asBC_PTRARG(l_bc) = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc += 1 + AS_PTR_SIZE;
+		break;
+
+	case asBC_CpyRtoV4:
+		*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asDWORD*)&m_regs.valueRegister;
+		l_bc++;
+		break;
+
+	case asBC_CpyRtoV8:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = m_regs.valueRegister;
+		l_bc++;
+		break;
+
+	case asBC_CpyGtoV4:
+		*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asDWORD*)asBC_PTRARG(l_bc);
+		l_bc += 1 + AS_PTR_SIZE;
+		break;
+
+	case asBC_WRTV1:
+		// The pointer in the register points to a byte, and *(l_fp - offset) too
+		**(asBYTE**)&m_regs.valueRegister = *(asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	case asBC_WRTV2:
+		// The pointer in the register points to a word, and *(l_fp - offset) too
+		**(asWORD**)&m_regs.valueRegister = *(asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	case asBC_WRTV4:
+		**(asDWORD**)&m_regs.valueRegister = *(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	case asBC_WRTV8:
+		**(asQWORD**)&m_regs.valueRegister = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	case asBC_RDR1:
+		{
+			// The pointer in the register points to a byte, and *(l_fp - offset) will also point to a byte
+			asBYTE *bPtr = (asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
+			bPtr[0] = **(asBYTE**)&m_regs.valueRegister; // read the byte
+			bPtr[1] = 0;                      // 0 the rest of the DWORD
+			bPtr[2] = 0;
+			bPtr[3] = 0;
 		}
+		l_bc++;
+		break;
+
+	case asBC_RDR2:
+		{
+			// The pointer in the register points to a word, and *(l_fp - offset) will also point to a word
+			asWORD *wPtr = (asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+			wPtr[0] = **(asWORD**)&m_regs.valueRegister; // read the word
+			wPtr[1] = 0;                      // 0 the rest of the DWORD
+		}
+		l_bc++;
+		break;
+
+	case asBC_RDR4:
+		*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = **(asDWORD**)&m_regs.valueRegister;
+		l_bc++;
+		break;
+
+	case asBC_RDR8:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = **(asQWORD**)&m_regs.valueRegister;
+		l_bc++;
+		break;
+
+	case asBC_LDG:
+		*(asPWORD*)&m_regs.valueRegister = asBC_PTRARG(l_bc);
+		l_bc += 1+AS_PTR_SIZE;
+		break;
+
+	case asBC_LDV:
+		*(asDWORD**)&m_regs.valueRegister = (l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
+
+	case asBC_PGA:
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = asBC_PTRARG(l_bc);
+		l_bc += 1+AS_PTR_SIZE;
 		break;
 
-	case asBC_CMPi:
+	case asBC_CmpPtr:
 		{
-			int i1 = *(int*)(l_fp - asBC_SWORDARG0(l_bc));
-			int i2 = *(int*)(l_fp - asBC_SWORDARG1(l_bc));
-			if( i1 == i2 )     *(int*)&m_regs.valueRegister =  0;
-			else if( i1 < i2 ) *(int*)&m_regs.valueRegister = -1;
+			// TODO: runtime optimize: This instruction should really just be an equals, and return true or false.
+			//                         The instruction is only used for is and !is tests anyway.
+			asPWORD p1 = *(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+			asPWORD p2 = *(asPWORD*)(l_fp - asBC_SWORDARG1(l_bc));
+			if( p1 == p2 )     *(int*)&m_regs.valueRegister =  0;
+			else if( p1 < p2 ) *(int*)&m_regs.valueRegister = -1;
 			else               *(int*)&m_regs.valueRegister =  1;
 			l_bc += 2;
 		}
 		break;
 
+	case asBC_VAR:
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = (asPWORD)asBC_SWORDARG0(l_bc);
+		l_bc++;
+		break;
+
 	//----------------------------
-	// Comparisons with constant value
-	case asBC_CMPIi:
-		{
-			int i1 = *(int*)(l_fp - asBC_SWORDARG0(l_bc));
-			int i2 = asBC_INTARG(l_bc);
-			if( i1 == i2 )     *(int*)&m_regs.valueRegister =  0;
-			else if( i1 < i2 ) *(int*)&m_regs.valueRegister = -1;
-			else               *(int*)&m_regs.valueRegister =  1;
-			l_bc += 2;
-		}
+	// Type conversions
+	case asBC_iTOf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(int*)(l_fp - asBC_SWORDARG0(l_bc)));
+		l_bc++;
 		break;
 
-	case asBC_CMPIf:
-		{
-			// Do a comparison of the values, rather than a subtraction
-			// in order to get proper behaviour for infinity values.
-			float f1 = *(float*)(l_fp - asBC_SWORDARG0(l_bc));
-			float f2 = asBC_FLOATARG(l_bc);
-			if( f1 == f2 )     *(int*)&m_regs.valueRegister =  0;
-			else if( f1 < f2 ) *(int*)&m_regs.valueRegister = -1;
-			else               *(int*)&m_regs.valueRegister =  1;
-			l_bc += 2;
-		}
+	case asBC_fTOi:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(float*)(l_fp - asBC_SWORDARG0(l_bc)));
+		l_bc++;
 		break;
 
-	case asBC_CMPIu:
-		{
-			asDWORD d1 = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-			asDWORD d2 = asBC_DWORDARG(l_bc);
-			if( d1 == d2 )     *(int*)&m_regs.valueRegister =  0;
-			else if( d1 < d2 ) *(int*)&m_regs.valueRegister = -1;
-			else               *(int*)&m_regs.valueRegister =  1;
-			l_bc += 2;
-		}
+	case asBC_uTOf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(l_fp - asBC_SWORDARG0(l_bc)));
+		l_bc++;
 		break;
 
-	case asBC_JMPP:
-		l_bc += 1 + (*(int*)(l_fp - asBC_SWORDARG0(l_bc)))*2;
+	case asBC_fTOu:
+		// We must cast to int first, because on some compilers the cast of a negative float value to uint result in 0
+		*(l_fp - asBC_SWORDARG0(l_bc)) = asUINT(int(*(float*)(l_fp - asBC_SWORDARG0(l_bc))));
+		l_bc++;
 		break;
 
-	case asBC_PopRPtr:
-		*(asPWORD*)&m_regs.valueRegister = *(asPWORD*)l_sp;
-		l_sp += AS_PTR_SIZE;
+	case asBC_sbTOi:
+		// *(l_fp - offset) points to a char, and will point to an int afterwards
+		*(l_fp - asBC_SWORDARG0(l_bc)) = *(signed char*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
 		break;
 
-	case asBC_PshRPtr:
-		l_sp -= AS_PTR_SIZE;
-		*(asPWORD*)l_sp = *(asPWORD*)&m_regs.valueRegister;
+	case asBC_swTOi:
+		// *(l_fp - offset) points to a short, and will point to an int afterwards
+		*(l_fp - asBC_SWORDARG0(l_bc)) = *(short*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
 		break;
 
-	case asBC_STR:
-		{
-			// Get the string id from the argument
-			asWORD w = asBC_WORDARG0(l_bc);
-			// Push the string pointer on the stack
-			const asCString &b = m_engine->GetConstantString(w);
-			l_sp -= AS_PTR_SIZE;
-			*(asPWORD*)l_sp = (asPWORD)b.AddressOf();
-			// Push the string length on the stack
-			--l_sp;
-			*l_sp = (asDWORD)b.GetLength();
-			l_bc++;
-		}
+	case asBC_ubTOi:
+		// (l_fp - offset) points to a byte, and will point to an int afterwards
+		*(l_fp - asBC_SWORDARG0(l_bc)) = *(asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
 		break;
 
-	case asBC_CALLSYS:
-		{
-			// Get function ID from the argument
-			int i = asBC_INTARG(l_bc);
+	case asBC_uwTOi:
+		// *(l_fp - offset) points to a word, and will point to an int afterwards
+		*(l_fp - asBC_SWORDARG0(l_bc)) = *(asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
+		break;
 
-			// Need to move the values back to the context as the called functions
-			// may use the debug interface to inspect the registers
-			m_regs.programPointer    = l_bc;
-			m_regs.stackPointer      = l_sp;
-			m_regs.stackFramePointer = l_fp;
+	case asBC_dTOi:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(double*)(l_fp - asBC_SWORDARG1(l_bc)));
+		l_bc += 2;
+		break;
 
-			l_sp += CallSystemFunction(i, this, 0);
+	case asBC_dTOu:
+		// We must cast to int first, because on some compilers the cast of a negative float value to uint result in 0
+		*(l_fp - asBC_SWORDARG0(l_bc)) = asUINT(int(*(double*)(l_fp - asBC_SWORDARG1(l_bc))));
+		l_bc += 2;
+		break;
 
-			// Update the program position after the call so that line number is correct
-			l_bc += 2;
+	case asBC_dTOf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(double*)(l_fp - asBC_SWORDARG1(l_bc)));
+		l_bc += 2;
+		break;
 
-			if( m_regs.doProcessSuspend )
+	case asBC_iTOd:
+		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(int*)(l_fp - asBC_SWORDARG1(l_bc)));
+		l_bc += 2;
+		break;
+
+	case asBC_uTOd:
+		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)));
+		l_bc += 2;
+		break;
+
+	case asBC_fTOd:
+		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(float*)(l_fp - asBC_SWORDARG1(l_bc)));
+		l_bc += 2;
+		break;
+
+	//------------------------------
+	// Math operations
+	case asBC_ADDi:
+		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) + *(int*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	case asBC_SUBi:
+		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) - *(int*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	case asBC_MULi:
+		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) * *(int*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	case asBC_DIVi:
+		{
+			int divider = *(int*)(l_fp - asBC_SWORDARG2(l_bc));
+			if( divider == 0 )
 			{
-				// Should the execution be suspended?
-				if( m_doSuspend )
-				{
-					m_regs.programPointer    = l_bc;
-					m_regs.stackPointer      = l_sp;
-					m_regs.stackFramePointer = l_fp;
+				// Need to move the values back to the context
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
 
-					m_status = asEXECUTION_SUSPENDED;
-					return;
-				}
-				// An exception might have been raised
-				if( m_status != asEXECUTION_ACTIVE )
+				// Raise exception
+				SetInternalException(TXT_DIVIDE_BY_ZERO);
+				return;
+			}
+			else if( divider == -1 )
+			{
+				// Need to check if the value that is divided is 0x80000000
+				// as dividing it with -1 will cause an overflow exception
+				if( *(int*)(l_fp - asBC_SWORDARG1(l_bc)) == int(0x80000000) )
 				{
+					// Need to move the values back to the context
 					m_regs.programPointer    = l_bc;
 					m_regs.stackPointer      = l_sp;
 					m_regs.stackFramePointer = l_fp;
 
+					// Raise exception
+					SetInternalException(TXT_DIVIDE_OVERFLOW);
 					return;
 				}
 			}
+			*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
 		}
+		l_bc += 2;
 		break;
 
-	case asBC_CALLBND:
+	case asBC_MODi:
 		{
-			// Get the function ID from the stack
-			int i = asBC_INTARG(l_bc);
-			l_bc += 2;
-
-			asASSERT( i >= 0 );
-			asASSERT( i & FUNC_IMPORTED );
-
-			// Need to move the values back to the context
-			m_regs.programPointer    = l_bc;
-			m_regs.stackPointer      = l_sp;
-			m_regs.stackFramePointer = l_fp;
-
-			int funcId = m_engine->importedFunctions[i & ~FUNC_IMPORTED]->boundFunctionId;
-			if( funcId == -1 )
+			int divider = *(int*)(l_fp - asBC_SWORDARG2(l_bc));
+			if( divider == 0 )
 			{
-				// Tell the exception handler to clean up the arguments to this function
-				m_needToCleanupArgs = true;
-				SetInternalException(TXT_UNBOUND_FUNCTION);
+				// Need to move the values back to the context
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				// Raise exception
+				SetInternalException(TXT_DIVIDE_BY_ZERO);
 				return;
 			}
-			else
+			else if( divider == -1 )
 			{
-				asCScriptFunction *func = m_engine->GetScriptFunction(funcId);
+				// Need to check if the value that is divided is 0x80000000
+				// as dividing it with -1 will cause an overflow exception
+				if( *(int*)(l_fp - asBC_SWORDARG1(l_bc)) == int(0x80000000) )
+				{
+					// Need to move the values back to the context
+					m_regs.programPointer    = l_bc;
+					m_regs.stackPointer      = l_sp;
+					m_regs.stackFramePointer = l_fp;
 
-				CallScriptFunction(func);
+					// Raise exception
+					SetInternalException(TXT_DIVIDE_OVERFLOW);
+					return;
+				}
 			}
+			*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
+		}
+		l_bc += 2;
+		break;
 
-			// Extract the values from the context again
-			l_bc = m_regs.programPointer;
-			l_sp = m_regs.stackPointer;
-			l_fp = m_regs.stackFramePointer;
+	case asBC_ADDf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) + *(float*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
 
-			// If status isn't active anymore then we must stop
-			if( m_status != asEXECUTION_ACTIVE )
-				return;
-		}
+	case asBC_SUBf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) - *(float*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
 		break;
 
-	case asBC_SUSPEND:
-		if( m_regs.doProcessSuspend )
+	case asBC_MULf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) * *(float*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	case asBC_DIVf:
 		{
-			if( m_lineCallback )
+			float divider = *(float*)(l_fp - asBC_SWORDARG2(l_bc));
+			if( divider == 0 )
 			{
+				// Need to move the values back to the context
 				m_regs.programPointer    = l_bc;
 				m_regs.stackPointer      = l_sp;
 				m_regs.stackFramePointer = l_fp;
 
-				CallLineCallback();
+				// Raise exception
+				SetInternalException(TXT_DIVIDE_BY_ZERO);
+				return;
 			}
-			if( m_doSuspend )
-			{
-				l_bc++;
+			*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
+		}
+		l_bc += 2;
+		break;
 
+	case asBC_MODf:
+		{
+			float divider = *(float*)(l_fp - asBC_SWORDARG2(l_bc));
+			if( divider == 0 )
+			{
 				// Need to move the values back to the context
 				m_regs.programPointer    = l_bc;
 				m_regs.stackPointer      = l_sp;
 				m_regs.stackFramePointer = l_fp;
 
-				m_status = asEXECUTION_SUSPENDED;
+				// Raise exception
+				SetInternalException(TXT_DIVIDE_BY_ZERO);
 				return;
 			}
+			*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = fmodf(*(float*)(l_fp - asBC_SWORDARG1(l_bc)), divider);
 		}
+		l_bc += 2;
+		break;
 
-		l_bc++;
+	case asBC_ADDd:
+		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) + *(double*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
 		break;
 
-	case asBC_ALLOC:
-		{
-			asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
-			int func = asBC_INTARG(l_bc+AS_PTR_SIZE);
+	case asBC_SUBd:
+		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) - *(double*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
 
-			if( objType->flags & asOBJ_SCRIPT_OBJECT )
+	case asBC_MULd:
+		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) * *(double*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
+		break;
+
+	case asBC_DIVd:
+		{
+			double divider = *(double*)(l_fp - asBC_SWORDARG2(l_bc));
+			if( divider == 0 )
 			{
-				// Need to move the values back to the context as the construction
-				// of the script object may reuse the context for nested calls.
+				// Need to move the values back to the context
 				m_regs.programPointer    = l_bc;
 				m_regs.stackPointer      = l_sp;
 				m_regs.stackFramePointer = l_fp;
 
-				// Pre-allocate the memory
-				asDWORD *mem = (asDWORD*)m_engine->CallAlloc(objType);
-
-				// Pre-initialize the memory by calling the constructor for asCScriptObject
-				ScriptObject_Construct(objType, (asCScriptObject*)mem);
-
-				// Call the constructor to initalize the memory
-				asCScriptFunction *f = m_engine->scriptFunctions[func];
-
-				asDWORD **a = (asDWORD**)*(asPWORD*)(m_regs.stackPointer + f->GetSpaceNeededForArguments());
-				if( a ) *a = mem;
-
-				// Push the object pointer on the stack
-				m_regs.stackPointer -= AS_PTR_SIZE;
-				*(asPWORD*)m_regs.stackPointer = (asPWORD)mem;
-
-				m_regs.programPointer += 2+AS_PTR_SIZE;
-
-				CallScriptFunction(f);
-
-				// Extract the values from the context again
-				l_bc = m_regs.programPointer;
-				l_sp = m_regs.stackPointer;
-				l_fp = m_regs.stackFramePointer;
-
-				// If status isn't active anymore then we must stop
-				if( m_status != asEXECUTION_ACTIVE )
-					return;
+				// Raise exception
+				SetInternalException(TXT_DIVIDE_BY_ZERO);
+				return;
 			}
-			else
-			{
-				// Pre-allocate the memory
-				asDWORD *mem = (asDWORD*)m_engine->CallAlloc(objType);
-
-				if( func )
-				{
-					// Need to move the values back to the context as the called functions
-					// may use the debug interface to inspect the registers
-					m_regs.programPointer    = l_bc;
-					m_regs.stackPointer      = l_sp;
-					m_regs.stackFramePointer = l_fp;
-
-					l_sp += CallSystemFunction(func, this, mem);
-				}
-
-				// Pop the variable address from the stack
-				asDWORD **a = (asDWORD**)*(asPWORD*)l_sp;
-				l_sp += AS_PTR_SIZE;
-				if( a ) *a = mem;
-
-				l_bc += 2+AS_PTR_SIZE;
-
-				if( m_regs.doProcessSuspend )
-				{
-					// Should the execution be suspended?
-					if( m_doSuspend )
-					{
-						m_regs.programPointer    = l_bc;
-						m_regs.stackPointer      = l_sp;
-						m_regs.stackFramePointer = l_fp;
-
-						m_status = asEXECUTION_SUSPENDED;
-						return;
-					}
-					// An exception might have been raised
-					if( m_status != asEXECUTION_ACTIVE )
-					{
-						m_regs.programPointer    = l_bc;
-						m_regs.stackPointer      = l_sp;
-						m_regs.stackFramePointer = l_fp;
 
-						m_engine->CallFree(mem);
-						*a = 0;
-
-						return;
-					}
-				}
-			}
+			*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
+			l_bc += 2;
 		}
 		break;
 
-	case asBC_FREE:
+	case asBC_MODd:
 		{
-			// Get the variable that holds the object handle/reference
-			asPWORD *a = (asPWORD*)asPWORD(l_fp - asBC_SWORDARG0(l_bc));
-			if( *a )
+			double divider = *(double*)(l_fp - asBC_SWORDARG2(l_bc));
+			if( divider == 0 )
 			{
-				asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
-				asSTypeBehaviour *beh = &objType->beh;
-
-				// Need to move the values back to the context as the called functions
-				// may use the debug interface to inspect the registers
+				// Need to move the values back to the context
 				m_regs.programPointer    = l_bc;
 				m_regs.stackPointer      = l_sp;
 				m_regs.stackFramePointer = l_fp;
 
-				if( objType->flags & asOBJ_REF )
-				{
-					asASSERT( (objType->flags & asOBJ_NOCOUNT) || beh->release );
-					if( beh->release )
-						m_engine->CallObjectMethod((void*)(asPWORD)*a, beh->release);
-				}
-				else
-				{
-					if( beh->destruct )
-						m_engine->CallObjectMethod((void*)(asPWORD)*a, beh->destruct);
-
-					m_engine->CallFree((void*)(asPWORD)*a);
-				}
-
-				// Clear the variable
-				*a = 0;
+				// Raise exception
+				SetInternalException(TXT_DIVIDE_BY_ZERO);
+				return;
 			}
+
+			*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = fmod(*(double*)(l_fp - asBC_SWORDARG1(l_bc)), divider);
+			l_bc += 2;
 		}
-		l_bc += 1+AS_PTR_SIZE;
 		break;
 
-	case asBC_LOADOBJ:
-		{
-			// Move the object pointer from the object variable into the object register
-			void **a = (void**)(l_fp - asBC_SWORDARG0(l_bc));
-			m_regs.objectType = 0;
-			m_regs.objectRegister = *a;
-			*a = 0;
-		}
-		l_bc++;
+	//------------------------------
+	// Math operations with constant value
+	case asBC_ADDIi:
+		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) + asBC_INTARG(l_bc+1);
+		l_bc += 3;
 		break;
 
-	case asBC_STOREOBJ:
-		// Move the object pointer from the object register to the object variable
-		*(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asPWORD(m_regs.objectRegister);
-		m_regs.objectRegister = 0;
-		l_bc++;
+	case asBC_SUBIi:
+		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) - asBC_INTARG(l_bc+1);
+		l_bc += 3;
 		break;
 
-	case asBC_GETOBJ:
-		{
-			// Read variable index from location on stack
-			asPWORD *a = (asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
-			asDWORD offset = *(asDWORD*)a;
-			// Move pointer from variable to the same location on the stack
-			asPWORD *v = (asPWORD*)(l_fp - offset);
-			*a = *v;
-			// Clear variable
-			*v = 0;
-		}
-		l_bc++;
+	case asBC_MULIi:
+		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) * asBC_INTARG(l_bc+1);
+		l_bc += 3;
 		break;
 
-	case asBC_REFCPY:
-		{
-			asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
-			asSTypeBehaviour *beh = &objType->beh;
+	case asBC_ADDIf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) + asBC_FLOATARG(l_bc+1);
+		l_bc += 3;
+		break;
 
-			// Pop address of destination pointer from the stack
-			void **d = (void**)*(asPWORD*)l_sp;
-			l_sp += AS_PTR_SIZE;
+	case asBC_SUBIf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) - asBC_FLOATARG(l_bc+1);
+		l_bc += 3;
+		break;
 
-			// Read wanted pointer from the stack
-			void *s = (void*)*(asPWORD*)l_sp;
+	case asBC_MULIf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) * asBC_FLOATARG(l_bc+1);
+		l_bc += 3;
+		break;
 
-			// Need to move the values back to the context as the called functions
-			// may use the debug interface to inspect the registers
-			m_regs.programPointer    = l_bc;
-			m_regs.stackPointer      = l_sp;
-			m_regs.stackFramePointer = l_fp;
+	//-----------------------------------
+	case asBC_SetG4:
+		*(asDWORD*)asBC_PTRARG(l_bc) = asBC_DWORDARG(l_bc+AS_PTR_SIZE);
+		l_bc += 2 + AS_PTR_SIZE;
+		break;
+
+	case asBC_ChkRefS:
+		{
+			// Verify if the pointer on the stack refers to a non-null value
+			// This is used to validate a reference to a handle
+			asPWORD *a = (asPWORD*)*(asPWORD*)l_sp;
+			if( *a == 0 )
+			{
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
 
-			if( !(objType->flags & asOBJ_NOCOUNT) )
-			{
-				// Release previous object held by destination pointer
-				if( *d != 0 )
-					m_engine->CallObjectMethod(*d, beh->release);
-				// Increase ref counter of wanted object
-				if( s != 0 )
-					m_engine->CallObjectMethod(s, beh->addref);
+				SetInternalException(TXT_NULL_POINTER_ACCESS);
+				return;
 			}
-
-			// Set the new object in the destination
-			*d = s;
 		}
-		l_bc += 1+AS_PTR_SIZE;
+		l_bc++;
 		break;
 
-	case asBC_CHKREF:
+	case asBC_ChkNullV:
 		{
-			// Verify if the pointer on the stack is null
-			// This is used when validating a pointer that an operator will work on
-			asPWORD a = *(asPWORD*)l_sp;
+			// Verify if variable (on the stack) is not null
+			asDWORD *a = *(asDWORD**)(l_fp - asBC_SWORDARG0(l_bc));
 			if( a == 0 )
 			{
 				m_regs.programPointer    = l_bc;
@@ -2628,350 +4373,517 @@ void asCContext::ExecuteNext()
 		l_bc++;
 		break;
 
-	case asBC_GETOBJREF:
+	case asBC_CALLINTF:
 		{
-			// Get the location on the stack where the reference will be placed
-			asPWORD *a = (asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
+			int i = asBC_INTARG(l_bc);
+			l_bc += 2;
 
-			// Replace the variable index with the object handle held in the variable
-			*(asPWORD**)a = *(asPWORD**)(l_fp - *a);
+			asASSERT( i >= 0 );
+			asASSERT( (i & FUNC_IMPORTED) == 0 );
+
+			// Need to move the values back to the context
+			m_regs.programPointer    = l_bc;
+			m_regs.stackPointer      = l_sp;
+			m_regs.stackFramePointer = l_fp;
+
+			CallInterfaceMethod(m_engine->GetScriptFunction(i));
+
+			// Extract the values from the context again
+			l_bc = m_regs.programPointer;
+			l_sp = m_regs.stackPointer;
+			l_fp = m_regs.stackFramePointer;
+
+			// If status isn't active anymore then we must stop
+			if( m_status != asEXECUTION_ACTIVE )
+				return;
 		}
-		l_bc++;
 		break;
 
-	case asBC_GETREF:
+	case asBC_iTOb:
 		{
-			// Get the location on the stack where the reference will be placed
-			asPWORD *a = (asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
+			// *(l_fp - offset) points to an int, and will point to a byte afterwards
 
-			// Replace the variable index with the address of the variable
-			*(asPWORD**)a = (asPWORD*)(l_fp - (int)*a);
+			// We need to use volatile here to tell the compiler not to rearrange
+			// read and write operations during optimizations.
+			volatile asDWORD val  = *(l_fp - asBC_SWORDARG0(l_bc));
+			volatile asBYTE *bPtr = (asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
+			bPtr[0] = (asBYTE)val; // write the byte
+			bPtr[1] = 0;           // 0 the rest of the DWORD
+			bPtr[2] = 0;
+			bPtr[3] = 0;
 		}
 		l_bc++;
 		break;
 
-	case asBC_PshNull:
-		// Push a null pointer on the stack
-		l_sp -= AS_PTR_SIZE;
-		*(asPWORD*)l_sp = 0;
-		l_bc++;
-		break;
+	case asBC_iTOw:
+		{
+			// *(l_fp - offset) points to an int, and will point to word afterwards
 
-	case asBC_ClrVPtr:
-		// TODO: runtime optimize: Is this instruction really necessary?
-		//                         CallScriptFunction() can clear the null handles upon entry, just as is done for
-		//                         all other object variables
-		// Clear pointer variable
-		*(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = 0;
+			// We need to use volatile here to tell the compiler not to rearrange
+			// read and write operations during optimizations.
+			volatile asDWORD val  = *(l_fp - asBC_SWORDARG0(l_bc));
+			volatile asWORD *wPtr = (asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+			wPtr[0] = (asWORD)val; // write the word
+			wPtr[1] = 0;           // 0 the rest of the DWORD
+		}
 		l_bc++;
 		break;
 
-	case asBC_OBJTYPE:
-		// Push the object type on the stack
-		l_sp -= AS_PTR_SIZE;
-		*(asPWORD*)l_sp = asBC_PTRARG(l_bc);
-		l_bc += 1+AS_PTR_SIZE;
-		break;
+	case asBC_SetV1:
+		// TODO: This is exactly the same as SetV4. This is a left over from the time
+		//       when the bytecode instructions were more tightly packed. It can now
+		//       be removed. When removing it, make sure the value is correctly converted
+		//       on big-endian CPUs.
 
-	case asBC_TYPEID:
-		// Equivalent to PshC4, but kept as separate instruction for bytecode serialization
-		--l_sp;
-		*l_sp = asBC_DWORDARG(l_bc);
+		// The byte is already stored correctly in the argument
+		*(l_fp - asBC_SWORDARG0(l_bc)) = asBC_DWORDARG(l_bc);
 		l_bc += 2;
 		break;
 
-	case asBC_SetV4:
+	case asBC_SetV2:
+		// TODO: This is exactly the same as SetV4. This is a left over from the time
+		//       when the bytecode instructions were more tightly packed. It can now
+		//       be removed. When removing it, make sure the value is correctly converted
+		//       on big-endian CPUs.
+
+		// The word is already stored correctly in the argument
 		*(l_fp - asBC_SWORDARG0(l_bc)) = asBC_DWORDARG(l_bc);
 		l_bc += 2;
 		break;
 
-	case asBC_SetV8:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asBC_QWORDARG(l_bc);
-		l_bc += 3;
-		break;
-
-	case asBC_ADDSi:
+	case asBC_Cast:
+		// Cast the handle at the top of the stack to the type in the argument
 		{
-			// The pointer must not be null
-			asPWORD a = *(asPWORD*)l_sp;
-			if( a == 0 )
+			asDWORD **a = (asDWORD**)*(asPWORD*)l_sp;
+			if( a && *a )
 			{
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+				asDWORD typeId = asBC_DWORDARG(l_bc);
 
-				SetInternalException(TXT_NULL_POINTER_ACCESS);
-				return;
+				asCScriptObject *obj = (asCScriptObject *)* a;
+				asCObjectType *objType = obj->objType;
+				asCObjectType *to = m_engine->GetObjectTypeFromTypeId(typeId);
+
+				// This instruction can only be used with script classes and interfaces
+				asASSERT( objType->flags & asOBJ_SCRIPT_OBJECT );
+				asASSERT( to->flags & asOBJ_SCRIPT_OBJECT );
+
+				if( objType->Implements(to) || objType->DerivesFrom(to) )
+				{
+					m_regs.objectType = 0;
+					m_regs.objectRegister = obj;
+					obj->AddRef();
+				}
+				else
+				{
+					// The object register should already be null, so there
+					// is no need to clear it if the cast is unsuccessful
+					asASSERT( m_regs.objectRegister == 0 );
+				}
 			}
-			// Add an offset to the pointer
-			*(asPWORD*)l_sp = a + asBC_SWORDARG0(l_bc);
+			l_sp += AS_PTR_SIZE;
 		}
 		l_bc += 2;
 		break;
 
-	case asBC_CpyVtoV4:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = *(l_fp - asBC_SWORDARG1(l_bc));
+	case asBC_i64TOi:
+		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
 		break;
 
-	case asBC_CpyVtoV8:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc));
+	case asBC_uTOi64:
+		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)));
 		l_bc += 2;
 		break;
 
-	case asBC_CpyVtoR4:
-		*(asDWORD*)&m_regs.valueRegister = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
-
-	case asBC_CpyVtoR8:
-		*(asQWORD*)&m_regs.valueRegister = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
-
-	case asBC_CpyVtoG4:
-		*(asDWORD*)asBC_PTRARG(l_bc) = *(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc += 1 + AS_PTR_SIZE;
-		break;
-
-	case asBC_CpyRtoV4:
-		*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asDWORD*)&m_regs.valueRegister;
-		l_bc++;
-		break;
-
-	case asBC_CpyRtoV8:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = m_regs.valueRegister;
-		l_bc++;
-		break;
-
-	case asBC_CpyGtoV4:
-		*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asDWORD*)asBC_PTRARG(l_bc);
-		l_bc += 1 + AS_PTR_SIZE;
+	case asBC_iTOi64:
+		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(int*)(l_fp - asBC_SWORDARG1(l_bc)));
+		l_bc += 2;
 		break;
 
-	case asBC_WRTV1:
-		// The pointer in the register points to a byte, and *(l_fp - offset) too
-		**(asBYTE**)&m_regs.valueRegister = *(asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
+	case asBC_fTOi64:
+		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(float*)(l_fp - asBC_SWORDARG1(l_bc)));
+		l_bc += 2;
 		break;
 
-	case asBC_WRTV2:
-		// The pointer in the register points to a word, and *(l_fp - offset) too
-		**(asWORD**)&m_regs.valueRegister = *(asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+	case asBC_dTOi64:
+		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(double*)(l_fp - asBC_SWORDARG0(l_bc)));
 		l_bc++;
 		break;
 
-	case asBC_WRTV4:
-		**(asDWORD**)&m_regs.valueRegister = *(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
+	case asBC_fTOu64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asQWORD(asINT64(*(float*)(l_fp - asBC_SWORDARG1(l_bc))));
+		l_bc += 2;
 		break;
 
-	case asBC_WRTV8:
-		**(asQWORD**)&m_regs.valueRegister = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+	case asBC_dTOu64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asQWORD(asINT64(*(double*)(l_fp - asBC_SWORDARG0(l_bc))));
 		l_bc++;
 		break;
 
-	case asBC_RDR1:
-		{
-			// The pointer in the register points to a byte, and *(l_fp - offset) will also point to a byte
-			asBYTE *bPtr = (asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
-			bPtr[0] = **(asBYTE**)&m_regs.valueRegister; // read the byte
-			bPtr[1] = 0;                      // 0 the rest of the DWORD
-			bPtr[2] = 0;
-			bPtr[3] = 0;
-		}
-		l_bc++;
+	case asBC_i64TOf:
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)));
+		l_bc += 2;
 		break;
 
-	case asBC_RDR2:
+	case asBC_u64TOf:
+#if _MSC_VER <= 1200 // MSVC6
 		{
-			// The pointer in the register points to a word, and *(l_fp - offset) will also point to a word
-			asWORD *wPtr = (asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-			wPtr[0] = **(asWORD**)&m_regs.valueRegister; // read the word
-			wPtr[1] = 0;                      // 0 the rest of the DWORD
+			// MSVC6 doesn't permit UINT64 to double
+			asINT64 v = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc));
+			if( v < 0 )
+				*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = 18446744073709551615.0f+float(v);
+			else
+				*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(v);
 		}
-		l_bc++;
-		break;
-
-	case asBC_RDR4:
-		*(asDWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = **(asDWORD**)&m_regs.valueRegister;
-		l_bc++;
-		break;
-
-	case asBC_RDR8:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = **(asQWORD**)&m_regs.valueRegister;
-		l_bc++;
-		break;
-
-	case asBC_LDG:
-		*(asPWORD*)&m_regs.valueRegister = asBC_PTRARG(l_bc);
-		l_bc += 1+AS_PTR_SIZE;
+#else
+		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)));
+#endif
+		l_bc += 2;
 		break;
 
-	case asBC_LDV:
-		*(asDWORD**)&m_regs.valueRegister = (l_fp - asBC_SWORDARG0(l_bc));
+	case asBC_i64TOd:
+		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)));
 		l_bc++;
 		break;
 
-	case asBC_PGA:
-		l_sp -= AS_PTR_SIZE;
-		*(asPWORD*)l_sp = asBC_PTRARG(l_bc);
-		l_bc += 1+AS_PTR_SIZE;
-		break;
-
-	case asBC_CmpPtr:
+	case asBC_u64TOd:
+#if _MSC_VER <= 1200 // MSVC6
 		{
-			// TODO: runtime optimize: This instruction should really just be an equals, and return true or false.
-			//                         The instruction is only used for is and !is tests anyway.
-			asPWORD p1 = *(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-			asPWORD p2 = *(asPWORD*)(l_fp - asBC_SWORDARG1(l_bc));
-			if( p1 == p2 )     *(int*)&m_regs.valueRegister =  0;
-			else if( p1 < p2 ) *(int*)&m_regs.valueRegister = -1;
-			else               *(int*)&m_regs.valueRegister =  1;
-			l_bc += 2;
+			// MSVC6 doesn't permit UINT64 to double
+			asINT64 v = *(asINT64*)(l_fp - asBC_SWORDARG0(l_bc));
+			if( v < 0 )
+				*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = 18446744073709551615.0+double(v);
+			else
+				*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(v);
 		}
-		break;
-
-	case asBC_VAR:
-		l_sp -= AS_PTR_SIZE;
-		*(asPWORD*)l_sp = (asPWORD)asBC_SWORDARG0(l_bc);
+#else
+		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)));
+#endif
 		l_bc++;
 		break;
 
-	//----------------------------
-	// Type conversions
-	case asBC_iTOf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(int*)(l_fp - asBC_SWORDARG0(l_bc)));
+	case asBC_NEGi64:
+		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = -*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
 		break;
 
-	case asBC_fTOi:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(float*)(l_fp - asBC_SWORDARG0(l_bc)));
+	case asBC_INCi64:
+		++(**(asQWORD**)&m_regs.valueRegister);
 		l_bc++;
 		break;
 
-	case asBC_uTOf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(l_fp - asBC_SWORDARG0(l_bc)));
+	case asBC_DECi64:
+		--(**(asQWORD**)&m_regs.valueRegister);
 		l_bc++;
 		break;
 
-	case asBC_fTOu:
-		// We must cast to int first, because on some compilers the cast of a negative float value to uint result in 0
-		*(l_fp - asBC_SWORDARG0(l_bc)) = asUINT(int(*(float*)(l_fp - asBC_SWORDARG0(l_bc))));
+	case asBC_BNOT64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = ~*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
 		l_bc++;
 		break;
 
-	case asBC_sbTOi:
-		// *(l_fp - offset) points to a char, and will point to an int afterwards
-		*(l_fp - asBC_SWORDARG0(l_bc)) = *(signed char*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
+	case asBC_ADDi64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) + *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
 		break;
 
-	case asBC_swTOi:
-		// *(l_fp - offset) points to a short, and will point to an int afterwards
-		*(l_fp - asBC_SWORDARG0(l_bc)) = *(short*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
+	case asBC_SUBi64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) - *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
 		break;
 
-	case asBC_ubTOi:
-		// (l_fp - offset) points to a byte, and will point to an int afterwards
-		*(l_fp - asBC_SWORDARG0(l_bc)) = *(asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
+	case asBC_MULi64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) * *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
+		l_bc += 2;
 		break;
 
-	case asBC_uwTOi:
-		// *(l_fp - offset) points to a word, and will point to an int afterwards
-		*(l_fp - asBC_SWORDARG0(l_bc)) = *(asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
+	case asBC_DIVi64:
+		{
+			asINT64 divider = *(asINT64*)(l_fp - asBC_SWORDARG2(l_bc));
+			if( divider == 0 )
+			{
+				// Need to move the values back to the context
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				// Raise exception
+				SetInternalException(TXT_DIVIDE_BY_ZERO);
+				return;
+			}
+			else if( divider == -1 )
+            {
+				// Need to check if the value that is divided is 1<<63
+				// as dividing it with -1 will cause an overflow exception
+				if( *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) == (asINT64(1)<<63) )
+				{
+					// Need to move the values back to the context
+					m_regs.programPointer    = l_bc;
+					m_regs.stackPointer      = l_sp;
+					m_regs.stackFramePointer = l_fp;
+
+					// Raise exception
+					SetInternalException(TXT_DIVIDE_OVERFLOW);
+					return;
+				}
+            }
+
+			*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
+		}
+		l_bc += 2;
 		break;
 
-	case asBC_dTOi:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(double*)(l_fp - asBC_SWORDARG1(l_bc)));
+	case asBC_MODi64:
+		{
+			asINT64 divider = *(asINT64*)(l_fp - asBC_SWORDARG2(l_bc));
+			if( divider == 0 )
+			{
+				// Need to move the values back to the context
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				// Raise exception
+				SetInternalException(TXT_DIVIDE_BY_ZERO);
+				return;
+			}
+			else if( divider == -1 )
+            {
+				// Need to check if the value that is divided is 1<<63
+				// as dividing it with -1 will cause an overflow exception
+				if( *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) == (asINT64(1)<<63) )
+				{
+					// Need to move the values back to the context
+					m_regs.programPointer    = l_bc;
+					m_regs.stackPointer      = l_sp;
+					m_regs.stackFramePointer = l_fp;
+
+					// Raise exception
+					SetInternalException(TXT_DIVIDE_OVERFLOW);
+					return;
+				}
+            }
+			*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
+		}
 		l_bc += 2;
 		break;
 
-	case asBC_dTOu:
-		// We must cast to int first, because on some compilers the cast of a negative float value to uint result in 0
-		*(l_fp - asBC_SWORDARG0(l_bc)) = asUINT(int(*(double*)(l_fp - asBC_SWORDARG1(l_bc))));
+	case asBC_BAND64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) & *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
 		break;
 
-	case asBC_dTOf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(double*)(l_fp - asBC_SWORDARG1(l_bc)));
+	case asBC_BOR64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) | *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
 		break;
 
-	case asBC_iTOd:
-		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(int*)(l_fp - asBC_SWORDARG1(l_bc)));
+	case asBC_BXOR64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) ^ *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
 		break;
 
-	case asBC_uTOd:
-		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)));
+	case asBC_BSLL64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) << *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
 		break;
 
-	case asBC_fTOd:
-		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(float*)(l_fp - asBC_SWORDARG1(l_bc)));
+	case asBC_BSRL64:
+		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) >> *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
 		break;
 
-	//------------------------------
-	// Math operations
-	case asBC_ADDi:
-		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) + *(int*)(l_fp - asBC_SWORDARG2(l_bc));
+	case asBC_BSRA64:
+		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) >> *(l_fp - asBC_SWORDARG2(l_bc));
 		l_bc += 2;
 		break;
 
-	case asBC_SUBi:
-		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) - *(int*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+	case asBC_CMPi64:
+		{
+			asINT64 i1 = *(asINT64*)(l_fp - asBC_SWORDARG0(l_bc));
+			asINT64 i2 = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc));
+			if( i1 == i2 )     *(int*)&m_regs.valueRegister =  0;
+			else if( i1 < i2 ) *(int*)&m_regs.valueRegister = -1;
+			else               *(int*)&m_regs.valueRegister =  1;
+			l_bc += 2;
+		}
+		break;
+
+	case asBC_CMPu64:
+		{
+			asQWORD d1 = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+			asQWORD d2 = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc));
+			if( d1 == d2 )     *(int*)&m_regs.valueRegister =  0;
+			else if( d1 < d2 ) *(int*)&m_regs.valueRegister = -1;
+			else               *(int*)&m_regs.valueRegister =  1;
+			l_bc += 2;
+		}
+		break;
+
+	case asBC_ChkNullS:
+		{
+			// Verify if the pointer on the stack is null
+			// This is used for example when validating handles passed as function arguments
+			asPWORD a = *(asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
+			if( a == 0 )
+			{
+				m_regs.programPointer    = l_bc;
+				m_regs.stackPointer      = l_sp;
+				m_regs.stackFramePointer = l_fp;
+
+				SetInternalException(TXT_NULL_POINTER_ACCESS);
+				return;
+			}
+		}
+		l_bc++;
+		break;
+
+	case asBC_ClrHi:
+#if AS_SIZEOF_BOOL == 1
+		{
+			// Clear the upper bytes, so that trash data don't interfere with boolean operations
+
+			// We need to use volatile here to tell the compiler it cannot
+			// change the order of read and write operations on the pointer.
+
+			volatile asBYTE *ptr = (asBYTE*)&m_regs.valueRegister;
+			ptr[1] = 0;   // The boolean value is stored in the lower byte, so we clear the rest
+			ptr[2] = 0;
+			ptr[3] = 0;
+		}
+#else
+		// We don't have anything to do here
+#endif
+		l_bc++;
+		break;
+
+	case asBC_JitEntry:
+		{
+			if( m_currentFunction->jitFunction )
+			{
+				asPWORD jitArg = asBC_PTRARG(l_bc);
+
+				if( jitArg )
+				{
+					// Resume JIT operation
+					m_regs.programPointer    = l_bc;
+					m_regs.stackPointer      = l_sp;
+					m_regs.stackFramePointer = l_fp;
+
+					(m_currentFunction->jitFunction)(&m_regs, jitArg);
+
+					l_bc = m_regs.programPointer;
+					l_sp = m_regs.stackPointer;
+					l_fp = m_regs.stackFramePointer;
+
+					// If status isn't active anymore then we must stop
+					if( m_status != asEXECUTION_ACTIVE )
+						return;
 
-	case asBC_MULi:
-		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) * *(int*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
+					break;
+				}
+			}
+
+			// Not a JIT resume point, treat as nop
+			l_bc += 1+AS_PTR_SIZE;
+		}
 		break;
 
-	case asBC_DIVi:
+	case asBC_CallPtr:
 		{
-			int divider = *(int*)(l_fp - asBC_SWORDARG2(l_bc));
-			if( divider == 0 )
+			// Get the function pointer from the local variable
+			asCScriptFunction *func = *(asCScriptFunction**)(l_fp - asBC_SWORDARG0(l_bc));
+
+			// Need to move the values back to the context
+			m_regs.programPointer    = l_bc;
+			m_regs.stackPointer      = l_sp;
+			m_regs.stackFramePointer = l_fp;
+
+			if( func == 0 )
 			{
-				// Need to move the values back to the context
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+				// Need to update the program pointer anyway for the exception handler
+				m_regs.programPointer++;
 
-				// Raise exception
-				SetInternalException(TXT_DIVIDE_BY_ZERO);
+				// Tell the exception handler to clean up the arguments to this method
+				m_needToCleanupArgs = true;
+
+				// TODO: funcdef: Should we have a different exception string?
+				SetInternalException(TXT_UNBOUND_FUNCTION);
 				return;
 			}
-			else if( divider == -1 )
+			else
 			{
-				// Need to check if the value that is divided is 0x80000000
-				// as dividing it with -1 will cause an overflow exception
-				if( *(int*)(l_fp - asBC_SWORDARG1(l_bc)) == int(0x80000000) )
+				if( func->funcType == asFUNC_SCRIPT )
 				{
-					// Need to move the values back to the context
-					m_regs.programPointer    = l_bc;
-					m_regs.stackPointer      = l_sp;
-					m_regs.stackFramePointer = l_fp;
+					m_regs.programPointer++;
+					CallScriptFunction(func);
+				}
+				else if( func->funcType == asFUNC_DELEGATE )
+				{
+					// Push the object pointer on the stack. There is always a reserved space for this so 
+					// we don't don't need to worry about overflowing the allocated memory buffer
+					asASSERT( m_regs.stackPointer - AS_PTR_SIZE >= m_stackBlocks[m_stackIndex] );
+					m_regs.stackPointer -= AS_PTR_SIZE;
+					*(asPWORD*)m_regs.stackPointer = asPWORD(func->objForDelegate);
 
-					// Raise exception
-					SetInternalException(TXT_DIVIDE_OVERFLOW);
-					return;
+					// Call the delegated method
+					if( func->funcForDelegate->funcType == asFUNC_SYSTEM )
+					{
+						m_regs.stackPointer += CallSystemFunction(func->funcForDelegate->id, this, 0);
+
+						// Update program position after the call so the line number
+						// is correct in case the system function queries it
+						m_regs.programPointer++;
+					}
+					else
+					{
+						m_regs.programPointer++;
+
+						// TODO: run-time optimize: The true method could be figured out when creating the delegate
+						CallInterfaceMethod(func->funcForDelegate);
+					}
+				}
+				else
+				{
+					asASSERT( func->funcType == asFUNC_SYSTEM );
+
+					m_regs.stackPointer += CallSystemFunction(func->id, this, 0);
+
+					// Update program position after the call so the line number
+					// is correct in case the system function queries it
+					m_regs.programPointer++;
 				}
 			}
-			*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
+
+			// Extract the values from the context again
+			l_bc = m_regs.programPointer;
+			l_sp = m_regs.stackPointer;
+			l_fp = m_regs.stackFramePointer;
+
+			// The script cannot continue until a started asynchronous call has been completed
+			if( m_asyncCall && m_status == asEXECUTION_ACTIVE )
+				m_status = asEXECUTION_SUSPENDED;
+
+			// If status isn't active anymore then we must stop
+			if( m_status != asEXECUTION_ACTIVE )
+				return;
 		}
-		l_bc += 2;
 		break;
 
-	case asBC_MODi:
+	case asBC_FuncPtr:
+		// Push the function pointer on the stack. The pointer is in the argument
+		l_sp -= AS_PTR_SIZE;
+		*(asPWORD*)l_sp = asBC_PTRARG(l_bc);
+		l_bc += 1+AS_PTR_SIZE;
+		break;
+
+	case asBC_LoadThisR:
 		{
-			int divider = *(int*)(l_fp - asBC_SWORDARG2(l_bc));
-			if( divider == 0 )
+			// PshVPtr 0
+			asPWORD tmp = *(asPWORD*)l_fp;
+
+			// Make sure the pointer is not null
+			if( tmp == 0 )
 			{
 				// Need to move the values back to the context
 				m_regs.programPointer    = l_bc;
@@ -2979,48 +4891,29 @@ void asCContext::ExecuteNext()
 				m_regs.stackFramePointer = l_fp;
 
 				// Raise exception
-				SetInternalException(TXT_DIVIDE_BY_ZERO);
+				SetInternalException(TXT_NULL_POINTER_ACCESS);
 				return;
 			}
-			else if( divider == -1 )
-			{
-				// Need to check if the value that is divided is 0x80000000
-				// as dividing it with -1 will cause an overflow exception
-				if( *(int*)(l_fp - asBC_SWORDARG1(l_bc)) == int(0x80000000) )
-				{
-					// Need to move the values back to the context
-					m_regs.programPointer    = l_bc;
-					m_regs.stackPointer      = l_sp;
-					m_regs.stackFramePointer = l_fp;
-
-					// Raise exception
-					SetInternalException(TXT_DIVIDE_OVERFLOW);
-					return;
-				}
-			}
-			*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
-		}
-		l_bc += 2;
-		break;
 
-	case asBC_ADDf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) + *(float*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+			// ADDSi
+			tmp = tmp + asBC_SWORDARG0(l_bc);
 
-	case asBC_SUBf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) - *(float*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
+			// PopRPtr
+			*(asPWORD*)&m_regs.valueRegister = tmp;
+			l_bc += 2;
+		}
 		break;
 
-	case asBC_MULf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) * *(float*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
+	// Push the qword value of a variable on the stack
+	case asBC_PshV8:
+		l_sp -= 2;
+		*(asQWORD*)l_sp = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+		l_bc++;
 		break;
 
-	case asBC_DIVf:
+	case asBC_DIVu:
 		{
-			float divider = *(float*)(l_fp - asBC_SWORDARG2(l_bc));
+			asUINT divider = *(asUINT*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
 			{
 				// Need to move the values back to the context
@@ -3032,14 +4925,14 @@ void asCContext::ExecuteNext()
 				SetInternalException(TXT_DIVIDE_BY_ZERO);
 				return;
 			}
-			*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
+			*(asUINT*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
 		}
 		l_bc += 2;
 		break;
 
-	case asBC_MODf:
+	case asBC_MODu:
 		{
-			float divider = *(float*)(l_fp - asBC_SWORDARG2(l_bc));
+			asUINT divider = *(asUINT*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
 			{
 				// Need to move the values back to the context
@@ -3051,29 +4944,14 @@ void asCContext::ExecuteNext()
 				SetInternalException(TXT_DIVIDE_BY_ZERO);
 				return;
 			}
-			*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = fmodf(*(float*)(l_fp - asBC_SWORDARG1(l_bc)), divider);
+			*(asUINT*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
 		}
 		l_bc += 2;
 		break;
 
-	case asBC_ADDd:
-		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) + *(double*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
-
-	case asBC_SUBd:
-		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) - *(double*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
-
-	case asBC_MULd:
-		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) * *(double*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
-
-	case asBC_DIVd:
+	case asBC_DIVu64:
 		{
-			double divider = *(double*)(l_fp - asBC_SWORDARG2(l_bc));
+			asQWORD divider = *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
 			{
 				// Need to move the values back to the context
@@ -3085,15 +4963,14 @@ void asCContext::ExecuteNext()
 				SetInternalException(TXT_DIVIDE_BY_ZERO);
 				return;
 			}
-
-			*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = *(double*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
-			l_bc += 2;
+			*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
 		}
+		l_bc += 2;
 		break;
 
-	case asBC_MODd:
+	case asBC_MODu64:
 		{
-			double divider = *(double*)(l_fp - asBC_SWORDARG2(l_bc));
+			asQWORD divider = *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
 			if( divider == 0 )
 			{
 				// Need to move the values back to the context
@@ -3105,86 +4982,102 @@ void asCContext::ExecuteNext()
 				SetInternalException(TXT_DIVIDE_BY_ZERO);
 				return;
 			}
-
-			*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = fmod(*(double*)(l_fp - asBC_SWORDARG1(l_bc)), divider);
-			l_bc += 2;
+			*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
 		}
+		l_bc += 2;
 		break;
 
-	//------------------------------
-	// Math operations with constant value
-	case asBC_ADDIi:
-		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) + asBC_INTARG(l_bc+1);
-		l_bc += 3;
-		break;
-
-	case asBC_SUBIi:
-		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) - asBC_INTARG(l_bc+1);
-		l_bc += 3;
-		break;
-
-	case asBC_MULIi:
-		*(int*)(l_fp - asBC_SWORDARG0(l_bc)) = *(int*)(l_fp - asBC_SWORDARG1(l_bc)) * asBC_INTARG(l_bc+1);
-		l_bc += 3;
-		break;
-
-	case asBC_ADDIf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) + asBC_FLOATARG(l_bc+1);
-		l_bc += 3;
-		break;
-
-	case asBC_SUBIf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) - asBC_FLOATARG(l_bc+1);
-		l_bc += 3;
-		break;
-
-	case asBC_MULIf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = *(float*)(l_fp - asBC_SWORDARG1(l_bc)) * asBC_FLOATARG(l_bc+1);
-		l_bc += 3;
-		break;
-
-	//-----------------------------------
-	case asBC_SetG4:
-		*(asDWORD*)asBC_PTRARG(l_bc) = asBC_DWORDARG(l_bc+AS_PTR_SIZE);
-		l_bc += 2 + AS_PTR_SIZE;
-		break;
-
-	case asBC_ChkRefS:
+	case asBC_LoadRObjR:
 		{
-			// Verify if the pointer on the stack refers to a non-null value
-			// This is used to validate a reference to a handle
-			asPWORD *a = (asPWORD*)*(asPWORD*)l_sp;
-			if( *a == 0 )
+			// PshVPtr x
+			asPWORD tmp = *(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc));
+
+			// Make sure the pointer is not null
+			if( tmp == 0 )
 			{
+				// Need to move the values back to the context
 				m_regs.programPointer    = l_bc;
 				m_regs.stackPointer      = l_sp;
 				m_regs.stackFramePointer = l_fp;
 
+				// Raise exception
 				SetInternalException(TXT_NULL_POINTER_ACCESS);
 				return;
 			}
+
+			// ADDSi y
+			tmp = tmp + asBC_SWORDARG1(l_bc);
+
+			// PopRPtr
+			*(asPWORD*)&m_regs.valueRegister = tmp;
+			l_bc += 3;
 		}
-		l_bc++;
 		break;
 
-	case asBC_ChkNullV:
+	case asBC_LoadVObjR:
 		{
-			// Verify if variable (on the stack) is not null
-			asDWORD *a = *(asDWORD**)(l_fp - asBC_SWORDARG0(l_bc));
-			if( a == 0 )
-			{
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+			// PSF x
+			asPWORD tmp = (asPWORD)(l_fp - asBC_SWORDARG0(l_bc));
 
-				SetInternalException(TXT_NULL_POINTER_ACCESS);
-				return;
+			// ADDSi y
+			tmp = tmp + asBC_SWORDARG1(l_bc);
+
+			// PopRPtr
+			*(asPWORD*)&m_regs.valueRegister = tmp;
+			l_bc += 3;
+		}
+		break;
+
+	case asBC_RefCpyV:
+		// Same as PSF v, REFCPY
+		{
+			asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
+			asSTypeBehaviour *beh = &objType->beh;
+
+			// Determine destination from argument
+			void **d = (void**)asPWORD(l_fp - asBC_SWORDARG0(l_bc));
+
+			// Read wanted pointer from the stack
+			void *s = (void*)*(asPWORD*)l_sp;
+
+			// Need to move the values back to the context as the called functions
+			// may use the debug interface to inspect the registers
+			m_regs.programPointer    = l_bc;
+			m_regs.stackPointer      = l_sp;
+			m_regs.stackFramePointer = l_fp;
+
+			if( !(objType->flags & asOBJ_NOCOUNT) )
+			{
+				// Release previous object held by destination pointer
+				if( *d != 0 )
+					m_engine->CallObjectMethod(*d, beh->release);
+				// Increase ref counter of wanted object
+				if( s != 0 )
+					m_engine->CallObjectMethod(s, beh->addref);
 			}
+
+			// Set the new object in the destination
+			*d = s;
 		}
-		l_bc++;
+		l_bc += 1+AS_PTR_SIZE;
 		break;
 
-	case asBC_CALLINTF:
+	case asBC_JLowZ:
+		if( *(asBYTE*)&m_regs.valueRegister == 0 )
+			l_bc += asBC_INTARG(l_bc) + 2;
+		else
+			l_bc += 2;
+		break;
+
+	case asBC_JLowNZ:
+		if( *(asBYTE*)&m_regs.valueRegister != 0 )
+			l_bc += asBC_INTARG(l_bc) + 2;
+		else
+			l_bc += 2;
+		break;
+
+	// Begin execution of a script function in place of the current function
+	case asBC_TAILCALL:
 		{
 			int i = asBC_INTARG(l_bc);
 			l_bc += 2;
@@ -3193,11 +5086,11 @@ void asCContext::ExecuteNext()
 			asASSERT( (i & FUNC_IMPORTED) == 0 );
 
 			// Need to move the values back to the context
-			m_regs.programPointer    = l_bc;
-			m_regs.stackPointer      = l_sp;
+			m_regs.programPointer = l_bc;
+			m_regs.stackPointer = l_sp;
 			m_regs.stackFramePointer = l_fp;
 
-			CallInterfaceMethod(m_engine->GetScriptFunction(i));
+			TailCallScriptFunction(m_engine->scriptFunctions[i]);
 
 			// Extract the values from the context again
 			l_bc = m_regs.programPointer;
@@ -3210,1662 +5103,1589 @@ void asCContext::ExecuteNext()
 		}
 		break;
 
-	case asBC_iTOb:
-		{
-			// *(l_fp - offset) points to an int, and will point to a byte afterwards
-
-			// We need to use volatile here to tell the compiler not to rearrange
-			// read and write operations during optimizations.
-			volatile asDWORD val  = *(l_fp - asBC_SWORDARG0(l_bc));
-			volatile asBYTE *bPtr = (asBYTE*)(l_fp - asBC_SWORDARG0(l_bc));
-			bPtr[0] = (asBYTE)val; // write the byte
-			bPtr[1] = 0;           // 0 the rest of the DWORD
-			bPtr[2] = 0;
-			bPtr[3] = 0;
-		}
-		l_bc++;
-		break;
-
-	case asBC_iTOw:
-		{
-			// *(l_fp - offset) points to an int, and will point to word afterwards
-
-			// We need to use volatile here to tell the compiler not to rearrange
-			// read and write operations during optimizations.
-			volatile asDWORD val  = *(l_fp - asBC_SWORDARG0(l_bc));
-			volatile asWORD *wPtr = (asWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-			wPtr[0] = (asWORD)val; // write the word
-			wPtr[1] = 0;           // 0 the rest of the DWORD
-		}
-		l_bc++;
-		break;
-
-	case asBC_SetV1:
-		// TODO: This is exactly the same as SetV4. This is a left over from the time
-		//       when the bytecode instructions were more tightly packed. It can now
-		//       be removed. When removing it, make sure the value is correctly converted
-		//       on big-endian CPUs.
-
-		// The byte is already stored correctly in the argument
-		*(l_fp - asBC_SWORDARG0(l_bc)) = asBC_DWORDARG(l_bc);
-		l_bc += 2;
-		break;
-
-	case asBC_SetV2:
-		// TODO: This is exactly the same as SetV4. This is a left over from the time
-		//       when the bytecode instructions were more tightly packed. It can now
-		//       be removed. When removing it, make sure the value is correctly converted
-		//       on big-endian CPUs.
-
-		// The word is already stored correctly in the argument
-		*(l_fp - asBC_SWORDARG0(l_bc)) = asBC_DWORDARG(l_bc);
-		l_bc += 2;
-		break;
-
-	case asBC_Cast:
-		// Cast the handle at the top of the stack to the type in the argument
-		{
-			asDWORD **a = (asDWORD**)*(asPWORD*)l_sp;
-			if( a && *a )
-			{
-				asDWORD typeId = asBC_DWORDARG(l_bc);
-
-				asCScriptObject *obj = (asCScriptObject *)* a;
-				asCObjectType *objType = obj->objType;
-				asCObjectType *to = m_engine->GetObjectTypeFromTypeId(typeId);
-
-				// This instruction can only be used with script classes and interfaces
-				asASSERT( objType->flags & asOBJ_SCRIPT_OBJECT );
-				asASSERT( to->flags & asOBJ_SCRIPT_OBJECT );
+	// Don't let the optimizer optimize for size,
+	// since it requires extra conditions and jumps
+	case 190: l_bc = (asDWORD*)190; break;
+	case 191: l_bc = (asDWORD*)191; break;
+	case 192: l_bc = (asDWORD*)192; break;
+	case 193: l_bc = (asDWORD*)193; break;
+	case 194: l_bc = (asDWORD*)194; break;
+	case 195: l_bc = (asDWORD*)195; break;
+	case 196: l_bc = (asDWORD*)196; break;
+	case 197: l_bc = (asDWORD*)197; break;
+	case 198: l_bc = (asDWORD*)198; break;
+	case 199: l_bc = (asDWORD*)199; break;
+	case 200: l_bc = (asDWORD*)200; break;
+	case 201: l_bc = (asDWORD*)201; break;
+	case 202: l_bc = (asDWORD*)202; break;
+	case 203: l_bc = (asDWORD*)203; break;
+	case 204: l_bc = (asDWORD*)204; break;
+	case 205: l_bc = (asDWORD*)205; break;
+	case 206: l_bc = (asDWORD*)206; break;
+	case 207: l_bc = (asDWORD*)207; break;
+	case 208: l_bc = (asDWORD*)208; break;
+	case 209: l_bc = (asDWORD*)209; break;
+	case 210: l_bc = (asDWORD*)210; break;
+	case 211: l_bc = (asDWORD*)211; break;
+	case 212: l_bc = (asDWORD*)212; break;
+	case 213: l_bc = (asDWORD*)213; break;
+	case 214: l_bc = (asDWORD*)214; break;
+	case 215: l_bc = (asDWORD*)215; break;
+	case 216: l_bc = (asDWORD*)216; break;
+	case 217: l_bc = (asDWORD*)217; break;
+	case 218: l_bc = (asDWORD*)218; break;
+	case 219: l_bc = (asDWORD*)219; break;
+	case 220: l_bc = (asDWORD*)220; break;
+	case 221: l_bc = (asDWORD*)221; break;
+	case 222: l_bc = (asDWORD*)222; break;
+	case 223: l_bc = (asDWORD*)223; break;
+	case 224: l_bc = (asDWORD*)224; break;
+	case 225: l_bc = (asDWORD*)225; break;
+	case 226: l_bc = (asDWORD*)226; break;
+	case 227: l_bc = (asDWORD*)227; break;
+	case 228: l_bc = (asDWORD*)228; break;
+	case 229: l_bc = (asDWORD*)229; break;
+	case 230: l_bc = (asDWORD*)230; break;
+	case 231: l_bc = (asDWORD*)231; break;
+	case 232: l_bc = (asDWORD*)232; break;
+	case 233: l_bc = (asDWORD*)233; break;
+	case 234: l_bc = (asDWORD*)234; break;
+	case 235: l_bc = (asDWORD*)235; break;
+	case 236: l_bc = (asDWORD*)236; break;
+	case 237: l_bc = (asDWORD*)237; break;
+	case 238: l_bc = (asDWORD*)238; break;
+	case 239: l_bc = (asDWORD*)239; break;
+	case 240: l_bc = (asDWORD*)240; break;
+	case 241: l_bc = (asDWORD*)241; break;
+	case 242: l_bc = (asDWORD*)242; break;
+	case 243: l_bc = (asDWORD*)243; break;
+	case 244: l_bc = (asDWORD*)244; break;
+	case 245: l_bc = (asDWORD*)245; break;
+	case 246: l_bc = (asDWORD*)246; break;
+	case 247: l_bc = (asDWORD*)247; break;
+	case 248: l_bc = (asDWORD*)248; break;
+	case 249: l_bc = (asDWORD*)249; break;
+	case 250: l_bc = (asDWORD*)250; break;
+	case 251: l_bc = (asDWORD*)251; break;
+	case 252: l_bc = (asDWORD*)252; break;
+	case 253: l_bc = (asDWORD*)253; break;
+	case 254: l_bc = (asDWORD*)254; break;
+	case 255: l_bc = (asDWORD*)255; break;
 
-				if( objType->Implements(to) || objType->DerivesFrom(to) )
-				{
-					m_regs.objectType = 0;
-					m_regs.objectRegister = obj;
-					obj->AddRef();
-				}
-				else
-				{
-					// The object register should already be null, so there
-					// is no need to clear it if the cast is unsuccessful
-					asASSERT( m_regs.objectRegister == 0 );
-				}
-			}
-			l_sp += AS_PTR_SIZE;
-		}
-		l_bc += 2;
-		break;
+#ifdef AS_DEBUG
+	default:
+		asASSERT(false);
+		SetInternalException(TXT_UNRECOGNIZED_BYTE_CODE);
+#endif
+#if defined(_MSC_VER) && !defined(AS_DEBUG)
+	default:
+		// This Microsoft specific code allows the
+		// compiler to optimize the switch case as
+		// it will know that the code will never
+		// reach this point
+		__assume(0);
+#endif
+	}
 
-	case asBC_i64TOi:
-		*(l_fp - asBC_SWORDARG0(l_bc)) = int(*(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)));
-		l_bc += 2;
-		break;
+#ifdef AS_DEBUG
+		asDWORD instr = *(asBYTE*)old;
+		if( instr != asBC_JMP && instr != asBC_JMPP && (instr < asBC_JZ || instr > asBC_JNP) && instr != asBC_JLowZ && instr != asBC_JLowNZ &&
+			instr != asBC_CALL && instr != asBC_TAILCALL && instr != asBC_CALLBND && instr != asBC_CALLINTF && instr != asBC_RET && instr != asBC_ALLOC && instr != asBC_CallPtr &&
+			instr != asBC_JitEntry )
+		{
+			asASSERT( (l_bc - old) == asBCTypeSize[asBCInfo[instr].type] );
+		}
+#endif
+	}
+}
 
-	case asBC_uTOi64:
-		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)));
-		l_bc += 2;
-		break;
+int asCContext::SetException(const char *descr)
+{
+	// Only allow this if we're executing a CALL byte code
+	if( m_callingSystemFunction == 0 ) return asERROR;
 
-	case asBC_iTOi64:
-		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(int*)(l_fp - asBC_SWORDARG1(l_bc)));
-		l_bc += 2;
-		break;
+	SetInternalException(descr);
 
-	case asBC_fTOi64:
-		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(float*)(l_fp - asBC_SWORDARG1(l_bc)));
-		l_bc += 2;
-		break;
+	return 0;
+}
 
-	case asBC_dTOi64:
-		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = asINT64(*(double*)(l_fp - asBC_SWORDARG0(l_bc)));
-		l_bc++;
-		break;
+void asCContext::SetInternalException(const char *descr)
+{
+	if( m_inExceptionHandler )
+	{
+		asASSERT(false); // Shouldn't happen
+		return; // but if it does, at least this will not crash the application
+	}
 
-	case asBC_fTOu64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asQWORD(asINT64(*(float*)(l_fp - asBC_SWORDARG1(l_bc))));
-		l_bc += 2;
-		break;
+	m_status                = asEXECUTION_EXCEPTION;
+	m_regs.doProcessSuspend = true;
 
-	case asBC_dTOu64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = asQWORD(asINT64(*(double*)(l_fp - asBC_SWORDARG0(l_bc))));
-		l_bc++;
-		break;
+	m_exceptionString       = descr;
+	m_exceptionFunction     = m_currentFunction->id;
+	m_exceptionLine         = m_currentFunction->GetLineNumber(int(m_regs.programPointer - m_currentFunction->byteCode.AddressOf()), &m_exceptionSectionIdx);
+	m_exceptionColumn       = m_exceptionLine >> 20;
+	m_exceptionLine        &= 0xFFFFF;
 
-	case asBC_i64TOf:
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)));
-		l_bc += 2;
-		break;
+	if( m_exceptionCallback )
+		CallExceptionCallback();
+}
 
-	case asBC_u64TOf:
-#if _MSC_VER <= 1200 // MSVC6
-		{
-			// MSVC6 doesn't permit UINT64 to double
-			asINT64 v = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc));
-			if( v < 0 )
-				*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = 18446744073709551615.0f+float(v);
-			else
-				*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(v);
-		}
-#else
-		*(float*)(l_fp - asBC_SWORDARG0(l_bc)) = float(*(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)));
-#endif
-		l_bc += 2;
-		break;
+void asCContext::CleanReturnObject()
+{
+	if( m_initialFunction && m_initialFunction->DoesReturnOnStack() && m_status == asEXECUTION_FINISHED )
+	{
+		// If function returns on stack we need to call the destructor on the returned object
+		if( m_initialFunction->returnType.GetObjectType()->beh.destruct )
+			m_engine->CallObjectMethod(GetReturnObject(), m_initialFunction->returnType.GetObjectType()->beh.destruct);
 
-	case asBC_i64TOd:
-		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)));
-		l_bc++;
-		break;
+		return;
+	}
 
-	case asBC_u64TOd:
-#if _MSC_VER <= 1200 // MSVC6
-		{
-			// MSVC6 doesn't permit UINT64 to double
-			asINT64 v = *(asINT64*)(l_fp - asBC_SWORDARG0(l_bc));
-			if( v < 0 )
-				*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = 18446744073709551615.0+double(v);
-			else
-				*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(v);
-		}
-#else
-		*(double*)(l_fp - asBC_SWORDARG0(l_bc)) = double(*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)));
-#endif
-		l_bc++;
-		break;
+	if( m_regs.objectRegister == 0 ) return;
 
-	case asBC_NEGi64:
-		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = -*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
+	asASSERT( m_regs.objectType != 0 );
 
-	case asBC_INCi64:
-		++(**(asQWORD**)&m_regs.valueRegister);
-		l_bc++;
-		break;
+	if( m_regs.objectType )
+	{
+		// Call the destructor on the object
+		asSTypeBehaviour *beh = &((asCObjectType*)m_regs.objectType)->beh;
+		if( m_regs.objectType->GetFlags() & asOBJ_REF )
+		{
+			asASSERT( beh->release || (m_regs.objectType->GetFlags() & asOBJ_NOCOUNT) );
 
-	case asBC_DECi64:
-		--(**(asQWORD**)&m_regs.valueRegister);
-		l_bc++;
-		break;
+			if( beh->release )
+				m_engine->CallObjectMethod(m_regs.objectRegister, beh->release);
 
-	case asBC_BNOT64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = ~*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
+			m_regs.objectRegister = 0;
+		}
+		else
+		{
+			if( beh->destruct )
+				m_engine->CallObjectMethod(m_regs.objectRegister, beh->destruct);
 
-	case asBC_ADDi64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) + *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+			// Free the memory
+			m_engine->CallFree(m_regs.objectRegister);
+			m_regs.objectRegister = 0;
+		}
+	}
+}
 
-	case asBC_SUBi64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) - *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+void asCContext::CleanStack()
+{
+	m_inExceptionHandler = true;
 
-	case asBC_MULi64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) * *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+	DiscardAsyncCall();
 
-	case asBC_DIVi64:
-		{
-			asINT64 divider = *(asINT64*)(l_fp - asBC_SWORDARG2(l_bc));
-			if( divider == 0 )
-			{
-				// Need to move the values back to the context
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+	// Co-routines resumed in this execution are unwound before the state
+	// that resumed them. They cannot be resumed again after this
+	asEContextState coStatus = m_status == asEXECUTION_EXCEPTION ? asEXECUTION_EXCEPTION : asEXECUTION_ABORTED;
+	while( m_coroutine && m_coroutine->m_resumeLevel == m_nestedLevel )
+	{
+		CleanCallStack();
+		SwitchFromCoroutine(coStatus);
+		coStatus = asEXECUTION_ABORTED;
 
-				// Raise exception
-				SetInternalException(TXT_DIVIDE_BY_ZERO);
-				return;
-			}
-			else if( divider == -1 )
-            {
-				// Need to check if the value that is divided is 1<<63
-				// as dividing it with -1 will cause an overflow exception
-				if( *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) == (asINT64(1)<<63) )
-				{
-					// Need to move the values back to the context
-					m_regs.programPointer    = l_bc;
-					m_regs.stackPointer      = l_sp;
-					m_regs.stackFramePointer = l_fp;
+		// The resumer is suspended just after the call that resumed the co-routine
+		m_status = asEXECUTION_SUSPENDED;
+	}
 
-					// Raise exception
-					SetInternalException(TXT_DIVIDE_OVERFLOW);
-					return;
-				}
-            }
+	CleanCallStack();
 
-			*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
-		}
-		l_bc += 2;
-		break;
+	m_inExceptionHandler = false;
+}
 
-	case asBC_MODi64:
-		{
-			asINT64 divider = *(asINT64*)(l_fp - asBC_SWORDARG2(l_bc));
-			if( divider == 0 )
-			{
-				// Need to move the values back to the context
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+// internal
+void asCContext::CleanCallStack()
+{
+	// Run the clean up code for each of the functions called
+	CleanStackFrame();
 
-				// Raise exception
-				SetInternalException(TXT_DIVIDE_BY_ZERO);
-				return;
-			}
-			else if( divider == -1 )
-            {
-				// Need to check if the value that is divided is 1<<63
-				// as dividing it with -1 will cause an overflow exception
-				if( *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) == (asINT64(1)<<63) )
-				{
-					// Need to move the values back to the context
-					m_regs.programPointer    = l_bc;
-					m_regs.stackPointer      = l_sp;
-					m_regs.stackFramePointer = l_fp;
+	// Set the status to exception so that the stack unwind is done correctly.
+	// This shouldn't be done for the current function, which is why we only
+	// do this after the first CleanStackFrame() is done.
+	m_status = asEXECUTION_EXCEPTION;
 
-					// Raise exception
-					SetInternalException(TXT_DIVIDE_OVERFLOW);
-					return;
-				}
-            }
-			*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
-		}
-		l_bc += 2;
-		break;
+	while( m_callStack.GetLength() > 0 )
+	{
+		// Only clean up until the top most marker for a nested call
+		asPWORD *s = m_callStack.AddressOf() + m_callStack.GetLength() - CALLSTACK_FRAME_SIZE;
+		if( s[0] == 0 )
+			break;
 
-	case asBC_BAND64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) & *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+		PopCallState();
 
-	case asBC_BOR64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) | *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+		CleanStackFrame();
+	}
+}
 
-	case asBC_BXOR64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) ^ *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+// Interface
+bool asCContext::IsVarInScope(asUINT varIndex, asUINT stackLevel)
+{
+	// Don't return anything if there is no bytecode, e.g. before calling Execute()
+	if( m_regs.programPointer == 0 ) return false;
 
-	case asBC_BSLL64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) << *(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+	if( stackLevel >= GetCallstackSize() ) return false;
 
-	case asBC_BSRL64:
-		*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) >> *(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+	asCScriptFunction *func;
+	asUINT pos;
 
-	case asBC_BSRA64:
-		*(asINT64*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc)) >> *(l_fp - asBC_SWORDARG2(l_bc));
-		l_bc += 2;
-		break;
+	if( stackLevel == 0 )
+	{
+		func = m_currentFunction;
+		pos = asUINT(m_regs.programPointer - func->byteCode.AddressOf());
+	}
+	else
+	{
+		asPWORD *s = m_callStack.AddressOf() + (GetCallstackSize()-stackLevel-1)*CALLSTACK_FRAME_SIZE;
+		func = (asCScriptFunction*)s[1];
+		pos = asUINT((asDWORD*)s[2] - func->byteCode.AddressOf());
+	}
 
-	case asBC_CMPi64:
-		{
-			asINT64 i1 = *(asINT64*)(l_fp - asBC_SWORDARG0(l_bc));
-			asINT64 i2 = *(asINT64*)(l_fp - asBC_SWORDARG1(l_bc));
-			if( i1 == i2 )     *(int*)&m_regs.valueRegister =  0;
-			else if( i1 < i2 ) *(int*)&m_regs.valueRegister = -1;
-			else               *(int*)&m_regs.valueRegister =  1;
-			l_bc += 2;
-		}
-		break;
+	// First determine if the program position is after the variable declaration
+	if( func->variables.GetLength() <= varIndex ) return false;
+	if( func->variables[varIndex]->declaredAtProgramPos > pos ) return false;
 
-	case asBC_CMPu64:
-		{
-			asQWORD d1 = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-			asQWORD d2 = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc));
-			if( d1 == d2 )     *(int*)&m_regs.valueRegister =  0;
-			else if( d1 < d2 ) *(int*)&m_regs.valueRegister = -1;
-			else               *(int*)&m_regs.valueRegister =  1;
-			l_bc += 2;
-		}
-		break;
+	asUINT declaredAt = func->variables[varIndex]->declaredAtProgramPos;
 
-	case asBC_ChkNullS:
+	// If the program position is after the variable declaration it is necessary
+	// determine if the program position is still inside the statement block where
+	// the variable was delcared.
+	for( int n = 0; n < (int)func->objVariableInfo.GetLength(); n++ )
+	{
+		if( func->objVariableInfo[n].programPos >= declaredAt )
 		{
-			// Verify if the pointer on the stack is null
-			// This is used for example when validating handles passed as function arguments
-			asPWORD a = *(asPWORD*)(l_sp + asBC_WORDARG0(l_bc));
-			if( a == 0 )
+			// If the current block ends between the declaredAt and current
+			// program position, then we know the variable is no longer visible
+			int level = 0;
+			for( ; n < (int)func->objVariableInfo.GetLength(); n++ )
 			{
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+				if( func->objVariableInfo[n].programPos > pos )
+					break;
 
-				SetInternalException(TXT_NULL_POINTER_ACCESS);
-				return;
+				if( func->objVariableInfo[n].option == asBLOCK_BEGIN ) level++;
+				if( func->objVariableInfo[n].option == asBLOCK_END && --level < 0 )
+					return false;
 			}
-		}
-		l_bc++;
-		break;
-
-	case asBC_ClrHi:
-#if AS_SIZEOF_BOOL == 1
-		{
-			// Clear the upper bytes, so that trash data don't interfere with boolean operations
 
-			// We need to use volatile here to tell the compiler it cannot
-			// change the order of read and write operations on the pointer.
-
-			volatile asBYTE *ptr = (asBYTE*)&m_regs.valueRegister;
-			ptr[1] = 0;   // The boolean value is stored in the lower byte, so we clear the rest
-			ptr[2] = 0;
-			ptr[3] = 0;
+			break;
 		}
-#else
-		// We don't have anything to do here
-#endif
-		l_bc++;
-		break;
+	}
 
-	case asBC_JitEntry:
-		{
-			if( m_currentFunction->jitFunction )
-			{
-				asPWORD jitArg = asBC_PTRARG(l_bc);
+	// Variable is visible
+	return true;
+}
 
-				if( jitArg )
-				{
-					// Resume JIT operation
-					m_regs.programPointer    = l_bc;
-					m_regs.stackPointer      = l_sp;
-					m_regs.stackFramePointer = l_fp;
+// Internal
+void asCContext::DetermineLiveObjects(asCArray<int> &liveObjects, asUINT stackLevel)
+{
+	asASSERT( stackLevel < GetCallstackSize() );
 
-					(m_currentFunction->jitFunction)(&m_regs, jitArg);
+	asCScriptFunction *func;
+	asUINT pos;
 
-					l_bc = m_regs.programPointer;
-					l_sp = m_regs.stackPointer;
-					l_fp = m_regs.stackFramePointer;
+	if( stackLevel == 0 )
+	{
+		func = m_currentFunction;
+		pos = asUINT(m_regs.programPointer - func->byteCode.AddressOf());
 
-					// If status isn't active anymore then we must stop
-					if( m_status != asEXECUTION_ACTIVE )
-						return;
+		if( m_status == asEXECUTION_EXCEPTION )
+		{
+			// Don't consider the last instruction as executed, as it failed with an exception
+			// It's not actually necessary to decrease the exact size of the instruction. Just
+			// before the current position is enough to disconsider it.
+			pos--;
+		}
+	}
+	else
+	{
+		asPWORD *s = m_callStack.AddressOf() + (GetCallstackSize()-stackLevel-1)*CALLSTACK_FRAME_SIZE;
+		func = (asCScriptFunction*)s[1];
+		pos = asUINT((asDWORD*)s[2] - func->byteCode.AddressOf());
 
-					break;
-				}
-			}
+		// Don't consider the last instruction as executed, as the function that was called by it
+		// is still being executed. If we consider it as executed already, then a value object
+		// returned by value would be considered alive, which it is not.
+		pos--;
+	}
 
-			// Not a JIT resume point, treat as nop
-			l_bc += 1+AS_PTR_SIZE;
-		}
-		break;
+	// Determine which object variables that are really live ones
+	liveObjects.SetLength(func->objVariablePos.GetLength());
+	if( liveObjects.GetLength() )
+		memset(liveObjects.AddressOf(), 0, sizeof(int)*liveObjects.GetLength());
+
+	// Find the last range that begins at or before the current position with a
+	// binary search. As the variable info are always placed on the instruction right
+	// after the one that initialized or freed the object, the current position needs
+	// to be considered as valid.
+	const asCArray<asSLiveObjectRange> &ranges = func->liveObjectRanges;
+	asUINT lo = 0, hi = ranges.GetLength();
+	while( lo < hi )
+	{
+		asUINT mid = (lo + hi) / 2;
+		if( ranges[mid].programPos > pos )
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+	if( lo == 0 )
+		return;
 
-	case asBC_CallPtr:
-		{
-			// Get the function pointer from the local variable
-			asCScriptFunction *func = *(asCScriptFunction**)(l_fp - asBC_SWORDARG0(l_bc));
+	asUINT first = ranges[lo-1].firstVar;
+	asUINT last  = lo < ranges.GetLength() ? ranges[lo].firstVar : func->liveObjectVars.GetLength();
+	for( asUINT n = first; n < last; n++ )
+		liveObjects[func->liveObjectVars[n]] = 1;
+}
 
-			// Need to move the values back to the context
-			m_regs.programPointer    = l_bc;
-			m_regs.stackPointer      = l_sp;
-			m_regs.stackFramePointer = l_fp;
+void asCContext::CleanArgsOnStack()
+{
+	if( !m_needToCleanupArgs )
+		return;
 
-			if( func == 0 )
-			{
-				// Need to update the program pointer anyway for the exception handler
-				m_regs.programPointer++;
+	// Find the instruction just before the current program pointer
+	asDWORD *instr = m_currentFunction->byteCode.AddressOf();
+	asDWORD *prevInstr = 0;
+	while( instr < m_regs.programPointer )
+	{
+		prevInstr = instr;
+		instr += asBCTypeSize[asBCInfo[*(asBYTE*)(instr)].type];
+	}
 
-				// Tell the exception handler to clean up the arguments to this method
-				m_needToCleanupArgs = true;
+	// Determine what function was being called
+	asCScriptFunction *func = 0;
+	asBYTE bc = *(asBYTE*)prevInstr;
+	if( bc == asBC_CALL || bc == asBC_TAILCALL || bc == asBC_CALLSYS || bc == asBC_CALLINTF )
+	{
+		int funcId = asBC_INTARG(prevInstr);
+		func = m_engine->scriptFunctions[funcId];
+	}
+	else if( bc == asBC_CALLBND )
+	{
+		int funcId = asBC_INTARG(prevInstr);
+		func = m_engine->importedFunctions[funcId & ~FUNC_IMPORTED]->importedFunctionSignature;
+	}
+	else if( bc == asBC_CallPtr )
+	{
+		asUINT v;
+		int var = asBC_SWORDARG0(prevInstr);
 
-				// TODO: funcdef: Should we have a different exception string?
-				SetInternalException(TXT_UNBOUND_FUNCTION);
-				return;
+		// Find the funcdef from the local variable
+		for( v = 0; v < m_currentFunction->objVariablePos.GetLength(); v++ )
+			if( m_currentFunction->objVariablePos[v] == var )
+			{
+				func = m_currentFunction->funcVariableTypes[v];
+				break;
 			}
-			else
+
+		if( func == 0 )
+		{
+			// Look in parameters
+			int paramPos = 0;
+			if( m_currentFunction->objectType )
+				paramPos -= AS_PTR_SIZE;
+			if( m_currentFunction->DoesReturnOnStack() )
+				paramPos -= AS_PTR_SIZE;
+			for( v = 0; v < m_currentFunction->parameterTypes.GetLength(); v++ )
 			{
-				if( func->funcType == asFUNC_SCRIPT )
+				if( var == paramPos )
 				{
-					m_regs.programPointer++;
-					CallScriptFunction(func);
+					func = m_currentFunction->parameterTypes[v].GetFuncDef();
+					break;
 				}
-				else if( func->funcType == asFUNC_DELEGATE )
+				paramPos -= m_currentFunction->parameterTypes[v].GetSizeOnStackDWords();
+			}
+		}
+	}
+	else
+		asASSERT( false );
+
+	asASSERT( func );
+
+	// Clean parameters
+	int offset = 0;
+	if( func->objectType )
+		offset += AS_PTR_SIZE;
+	if( func->DoesReturnOnStack() )
+		offset += AS_PTR_SIZE;
+	for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
+	{
+		if( func->parameterTypes[n].IsObject() && !func->parameterTypes[n].IsReference() )
+		{
+			if( *(asPWORD*)&m_regs.stackPointer[offset] )
+			{
+				// Call the object's destructor
+				asSTypeBehaviour *beh = func->parameterTypes[n].GetBehaviour();
+				if( func->parameterTypes[n].GetObjectType()->flags & asOBJ_REF )
 				{
-					// Push the object pointer on the stack. There is always a reserved space for this so 
-					// we don't don't need to worry about overflowing the allocated memory buffer
-					asASSERT( m_regs.stackPointer - AS_PTR_SIZE >= m_stackBlocks[m_stackIndex] );
-					m_regs.stackPointer -= AS_PTR_SIZE;
-					*(asPWORD*)m_regs.stackPointer = asPWORD(func->objForDelegate);
-
-					// Call the delegated method
-					if( func->funcForDelegate->funcType == asFUNC_SYSTEM )
-					{
-						m_regs.stackPointer += CallSystemFunction(func->funcForDelegate->id, this, 0);
-
-						// Update program position after the call so the line number
-						// is correct in case the system function queries it
-						m_regs.programPointer++;
-					}
-					else
-					{
-						m_regs.programPointer++;
+					asASSERT( (func->parameterTypes[n].GetObjectType()->flags & asOBJ_NOCOUNT) || beh->release );
 
-						// TODO: run-time optimize: The true method could be figured out when creating the delegate
-						CallInterfaceMethod(func->funcForDelegate);
-					}
+					if( beh->release )
+						m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackPointer[offset], beh->release);
+					*(asPWORD*)&m_regs.stackPointer[offset] = 0;
 				}
 				else
 				{
-					asASSERT( func->funcType == asFUNC_SYSTEM );
-
-					m_regs.stackPointer += CallSystemFunction(func->id, this, 0);
+					if( beh->destruct )
+						m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackPointer[offset], beh->destruct);
 
-					// Update program position after the call so the line number
-					// is correct in case the system function queries it
-					m_regs.programPointer++;
+					// Free the memory
+					m_engine->CallFree((void*)*(asPWORD*)&m_regs.stackPointer[offset]);
+					*(asPWORD*)&m_regs.stackPointer[offset] = 0;
 				}
 			}
-
-			// Extract the values from the context again
-			l_bc = m_regs.programPointer;
-			l_sp = m_regs.stackPointer;
-			l_fp = m_regs.stackFramePointer;
-
-			// If status isn't active anymore then we must stop
-			if( m_status != asEXECUTION_ACTIVE )
-				return;
 		}
-		break;
 
-	case asBC_FuncPtr:
-		// Push the function pointer on the stack. The pointer is in the argument
-		l_sp -= AS_PTR_SIZE;
-		*(asPWORD*)l_sp = asBC_PTRARG(l_bc);
-		l_bc += 1+AS_PTR_SIZE;
-		break;
-
-	case asBC_LoadThisR:
-		{
-			// PshVPtr 0
-			asPWORD tmp = *(asPWORD*)l_fp;
-
-			// Make sure the pointer is not null
-			if( tmp == 0 )
-			{
-				// Need to move the values back to the context
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+		offset += func->parameterTypes[n].GetSizeOnStackDWords();
+	}
 
-				// Raise exception
-				SetInternalException(TXT_NULL_POINTER_ACCESS);
-				return;
-			}
+	m_needToCleanupArgs = false;
+}
 
-			// ADDSi
-			tmp = tmp + asBC_SWORDARG0(l_bc);
+void asCContext::CleanStackFrame()
+{
+	// Clean object variables on the stack
+	// If the stack memory is not allocated or the program pointer
+	// is not set, then there is nothing to clean up on the stack frame
+	if( !m_isStackMemoryNotAllocated && m_regs.programPointer )
+	{
+		// If the exception occurred while calling a function it is necessary
+		// to clean up the arguments that were put on the stack.
+		CleanArgsOnStack();
 
-			// PopRPtr
-			*(asPWORD*)&m_regs.valueRegister = tmp;
-			l_bc += 2;
-		}
-		break;
+		// Restore the stack pointer
+		m_regs.stackPointer += m_currentFunction->variableSpace;
 
-	// Push the qword value of a variable on the stack
-	case asBC_PshV8:
-		l_sp -= 2;
-		*(asQWORD*)l_sp = *(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-		l_bc++;
-		break;
+		// Determine which object variables that are really live ones
+		asCArray<int> liveObjects;
+		DetermineLiveObjects(liveObjects, 0);
 
-	case asBC_DIVu:
+		for( asUINT n = 0; n < m_currentFunction->objVariablePos.GetLength(); n++ )
 		{
-			asUINT divider = *(asUINT*)(l_fp - asBC_SWORDARG2(l_bc));
-			if( divider == 0 )
+			int pos = m_currentFunction->objVariablePos[n];
+			if( n < m_currentFunction->objVariablesOnHeap )
 			{
-				// Need to move the values back to the context
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+				// Check if the pointer is initialized
+				if( *(asPWORD*)&m_regs.stackFramePointer[-pos] )
+				{
+					// Call the object's destructor
+					asSTypeBehaviour *beh = &m_currentFunction->objVariableTypes[n]->beh;
+					if( m_currentFunction->objVariableTypes[n]->flags & asOBJ_REF )
+					{
+						asASSERT( (m_currentFunction->objVariableTypes[n]->flags & asOBJ_NOCOUNT) || beh->release );
+						if( beh->release )
+							m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackFramePointer[-pos], beh->release);
+						*(asPWORD*)&m_regs.stackFramePointer[-pos] = 0;
+					}
+					else
+					{
+						if( beh->destruct )
+							m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackFramePointer[-pos], beh->destruct);
 
-				// Raise exception
-				SetInternalException(TXT_DIVIDE_BY_ZERO);
-				return;
+						// Free the memory
+						m_engine->CallFree((void*)*(asPWORD*)&m_regs.stackFramePointer[-pos]);
+						*(asPWORD*)&m_regs.stackFramePointer[-pos] = 0;
+					}
+				}
 			}
-			*(asUINT*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
-		}
-		l_bc += 2;
-		break;
-
-	case asBC_MODu:
-		{
-			asUINT divider = *(asUINT*)(l_fp - asBC_SWORDARG2(l_bc));
-			if( divider == 0 )
+			else
 			{
-				// Need to move the values back to the context
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+				asASSERT( m_currentFunction->objVariableTypes[n]->GetFlags() & asOBJ_VALUE );
 
-				// Raise exception
-				SetInternalException(TXT_DIVIDE_BY_ZERO);
-				return;
+				// Only destroy the object if it is truly alive
+				if( liveObjects[n] > 0 )
+				{
+					asSTypeBehaviour *beh = &m_currentFunction->objVariableTypes[n]->beh;
+					if( beh->destruct )
+						m_engine->CallObjectMethod((void*)(asPWORD*)&m_regs.stackFramePointer[-pos], beh->destruct);
+				}
 			}
-			*(asUINT*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asUINT*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
 		}
-		l_bc += 2;
-		break;
 
-	case asBC_DIVu64:
+		// If the object is a script declared object, then we must release it
+		// as the compiler adds a reference at the entry of the function. Make sure
+		// the function has actually been entered
+		if( m_currentFunction->objectType && m_regs.programPointer != m_currentFunction->byteCode.AddressOf() )
 		{
-			asQWORD divider = *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
-			if( divider == 0 )
+			// Methods returning a reference or constructors don't add a reference
+			if( !m_currentFunction->returnType.IsReference() && m_currentFunction->name != m_currentFunction->objectType->name )
 			{
-				// Need to move the values back to the context
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
-
-				// Raise exception
-				SetInternalException(TXT_DIVIDE_BY_ZERO);
-				return;
+				asSTypeBehaviour *beh = &m_currentFunction->objectType->beh;
+				if( beh->release && *(asPWORD*)&m_regs.stackFramePointer[0] != 0 )
+				{
+					m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackFramePointer[0], beh->release);
+					*(asPWORD*)&m_regs.stackFramePointer[0] = 0;
+				}
 			}
-			*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) / divider;
 		}
-		l_bc += 2;
-		break;
-
-	case asBC_MODu64:
-		{
-			asQWORD divider = *(asQWORD*)(l_fp - asBC_SWORDARG2(l_bc));
-			if( divider == 0 )
-			{
-				// Need to move the values back to the context
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
+	}
+	else
+		m_isStackMemoryNotAllocated = false;
 
-				// Raise exception
-				SetInternalException(TXT_DIVIDE_BY_ZERO);
-				return;
-			}
-			*(asQWORD*)(l_fp - asBC_SWORDARG0(l_bc)) = *(asQWORD*)(l_fp - asBC_SWORDARG1(l_bc)) % divider;
-		}
-		l_bc += 2;
-		break;
+	// Functions that do not own the object and parameters shouldn't do any clean up
+	if( m_currentFunction->dontCleanUpOnException )
+		return;
 
-	case asBC_LoadRObjR:
+	// Clean object and parameters
+	int offset = 0;
+	if( m_currentFunction->objectType )
+		offset += AS_PTR_SIZE;
+	if( m_currentFunction->DoesReturnOnStack() )
+		offset += AS_PTR_SIZE;
+	for( asUINT n = 0; n < m_currentFunction->parameterTypes.GetLength(); n++ )
+	{
+		if( m_currentFunction->parameterTypes[n].IsObject() && !m_currentFunction->parameterTypes[n].IsReference() )
 		{
-			// PshVPtr x
-			asPWORD tmp = *(asPWORD*)(l_fp - asBC_SWORDARG0(l_bc));
-
-			// Make sure the pointer is not null
-			if( tmp == 0 )
+			if( *(asPWORD*)&m_regs.stackFramePointer[offset] )
 			{
-				// Need to move the values back to the context
-				m_regs.programPointer    = l_bc;
-				m_regs.stackPointer      = l_sp;
-				m_regs.stackFramePointer = l_fp;
-
-				// Raise exception
-				SetInternalException(TXT_NULL_POINTER_ACCESS);
-				return;
-			}
-
-			// ADDSi y
-			tmp = tmp + asBC_SWORDARG1(l_bc);
-
-			// PopRPtr
-			*(asPWORD*)&m_regs.valueRegister = tmp;
-			l_bc += 3;
-		}
-		break;
-
-	case asBC_LoadVObjR:
-		{
-			// PSF x
-			asPWORD tmp = (asPWORD)(l_fp - asBC_SWORDARG0(l_bc));
+				// Call the object's destructor
+				asSTypeBehaviour *beh = m_currentFunction->parameterTypes[n].GetBehaviour();
+				if( m_currentFunction->parameterTypes[n].GetObjectType()->flags & asOBJ_REF )
+				{
+					asASSERT( (m_currentFunction->parameterTypes[n].GetObjectType()->flags & asOBJ_NOCOUNT) || beh->release );
 
-			// ADDSi y
-			tmp = tmp + asBC_SWORDARG1(l_bc);
+					if( beh->release )
+						m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackFramePointer[offset], beh->release);
+					*(asPWORD*)&m_regs.stackFramePointer[offset] = 0;
+				}
+				else
+				{
+					if( beh->destruct )
+						m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackFramePointer[offset], beh->destruct);
 
-			// PopRPtr
-			*(asPWORD*)&m_regs.valueRegister = tmp;
-			l_bc += 3;
+					// Free the memory
+					m_engine->CallFree((void*)*(asPWORD*)&m_regs.stackFramePointer[offset]);
+					*(asPWORD*)&m_regs.stackFramePointer[offset] = 0;
+				}
+			}
 		}
-		break;
 
-	case asBC_RefCpyV:
-		// Same as PSF v, REFCPY
-		{
-			asCObjectType *objType = (asCObjectType*)asBC_PTRARG(l_bc);
-			asSTypeBehaviour *beh = &objType->beh;
+		offset += m_currentFunction->parameterTypes[n].GetSizeOnStackDWords();
+	}
+}
 
-			// Determine destination from argument
-			void **d = (void**)asPWORD(l_fp - asBC_SWORDARG0(l_bc));
+// interface
+int asCContext::GetExceptionLineNumber(int *column, const char **sectionName)
+{
+	if( GetState() != asEXECUTION_EXCEPTION ) return asERROR;
 
-			// Read wanted pointer from the stack
-			void *s = (void*)*(asPWORD*)l_sp;
+	if( column ) *column = m_exceptionColumn;
 
-			// Need to move the values back to the context as the called functions
-			// may use the debug interface to inspect the registers
-			m_regs.programPointer    = l_bc;
-			m_regs.stackPointer      = l_sp;
-			m_regs.stackFramePointer = l_fp;
+	if( sectionName ) *sectionName = m_engine->scriptSectionNames[m_exceptionSectionIdx]->AddressOf();
 
-			if( !(objType->flags & asOBJ_NOCOUNT) )
-			{
-				// Release previous object held by destination pointer
-				if( *d != 0 )
-					m_engine->CallObjectMethod(*d, beh->release);
-				// Increase ref counter of wanted object
-				if( s != 0 )
-					m_engine->CallObjectMethod(s, beh->addref);
-			}
+	return m_exceptionLine;
+}
 
-			// Set the new object in the destination
-			*d = s;
-		}
-		l_bc += 1+AS_PTR_SIZE;
-		break;
+// interface
+asIScriptFunction *asCContext::GetExceptionFunction()
+{
+	if( GetState() != asEXECUTION_EXCEPTION ) return 0;
 
-	case asBC_JLowZ:
-		if( *(asBYTE*)&m_regs.valueRegister == 0 )
-			l_bc += asBC_INTARG(l_bc) + 2;
-		else
-			l_bc += 2;
-		break;
+	return m_engine->scriptFunctions[m_exceptionFunction];
+}
 
-	case asBC_JLowNZ:
-		if( *(asBYTE*)&m_regs.valueRegister != 0 )
-			l_bc += asBC_INTARG(l_bc) + 2;
-		else
-			l_bc += 2;
-		break;
+// interface
+const char *asCContext::GetExceptionString()
+{
+	if( GetState() != asEXECUTION_EXCEPTION ) return 0;
 
-	// Don't let the optimizer optimize for size,
-	// since it requires extra conditions and jumps
-	case 189: l_bc = (asDWORD*)189; break;
-	case 190: l_bc = (asDWORD*)190; break;
-	case 191: l_bc = (asDWORD*)191; break;
-	case 192: l_bc = (asDWORD*)192; break;
-	case 193: l_bc = (asDWORD*)193; break;
-	case 194: l_bc = (asDWORD*)194; break;
-	case 195: l_bc = (asDWORD*)195; break;
-	case 196: l_bc = (asDWORD*)196; break;
-	case 197: l_bc = (asDWORD*)197; break;
-	case 198: l_bc = (asDWORD*)198; break;
-	case 199: l_bc = (asDWORD*)199; break;
-	case 200: l_bc = (asDWORD*)200; break;
-	case 201: l_bc = (asDWORD*)201; break;
-	case 202: l_bc = (asDWORD*)202; break;
-	case 203: l_bc = (asDWORD*)203; break;
-	case 204: l_bc = (asDWORD*)204; break;
-	case 205: l_bc = (asDWORD*)205; break;
-	case 206: l_bc = (asDWORD*)206; break;
-	case 207: l_bc = (asDWORD*)207; break;
-	case 208: l_bc = (asDWORD*)208; break;
-	case 209: l_bc = (asDWORD*)209; break;
-	case 210: l_bc = (asDWORD*)210; break;
-	case 211: l_bc = (asDWORD*)211; break;
-	case 212: l_bc = (asDWORD*)212; break;
-	case 213: l_bc = (asDWORD*)213; break;
-	case 214: l_bc = (asDWORD*)214; break;
-	case 215: l_bc = (asDWORD*)215; break;
-	case 216: l_bc = (asDWORD*)216; break;
-	case 217: l_bc = (asDWORD*)217; break;
-	case 218: l_bc = (asDWORD*)218; break;
-	case 219: l_bc = (asDWORD*)219; break;
-	case 220: l_bc = (asDWORD*)220; break;
-	case 221: l_bc = (asDWORD*)221; break;
-	case 222: l_bc = (asDWORD*)222; break;
-	case 223: l_bc = (asDWORD*)223; break;
-	case 224: l_bc = (asDWORD*)224; break;
-	case 225: l_bc = (asDWORD*)225; break;
-	case 226: l_bc = (asDWORD*)226; break;
-	case 227: l_bc = (asDWORD*)227; break;
-	case 228: l_bc = (asDWORD*)228; break;
-	case 229: l_bc = (asDWORD*)229; break;
-	case 230: l_bc = (asDWORD*)230; break;
-	case 231: l_bc = (asDWORD*)231; break;
-	case 232: l_bc = (asDWORD*)232; break;
-	case 233: l_bc = (asDWORD*)233; break;
-	case 234: l_bc = (asDWORD*)234; break;
-	case 235: l_bc = (asDWORD*)235; break;
-	case 236: l_bc = (asDWORD*)236; break;
-	case 237: l_bc = (asDWORD*)237; break;
-	case 238: l_bc = (asDWORD*)238; break;
-	case 239: l_bc = (asDWORD*)239; break;
-	case 240: l_bc = (asDWORD*)240; break;
-	case 241: l_bc = (asDWORD*)241; break;
-	case 242: l_bc = (asDWORD*)242; break;
-	case 243: l_bc = (asDWORD*)243; break;
-	case 244: l_bc = (asDWORD*)244; break;
-	case 245: l_bc = (asDWORD*)245; break;
-	case 246: l_bc = (asDWORD*)246; break;
-	case 247: l_bc = (asDWORD*)247; break;
-	case 248: l_bc = (asDWORD*)248; break;
-	case 249: l_bc = (asDWORD*)249; break;
-	case 250: l_bc = (asDWORD*)250; break;
-	case 251: l_bc = (asDWORD*)251; break;
-	case 252: l_bc = (asDWORD*)252; break;
-	case 253: l_bc = (asDWORD*)253; break;
-	case 254: l_bc = (asDWORD*)254; break;
-	case 255: l_bc = (asDWORD*)255; break;
+	return m_exceptionString.AddressOf();
+}
 
-#ifdef AS_DEBUG
-	default:
-		asASSERT(false);
-		SetInternalException(TXT_UNRECOGNIZED_BYTE_CODE);
-#endif
-#if defined(_MSC_VER) && !defined(AS_DEBUG)
-	default:
-		// This Microsoft specific code allows the
-		// compiler to optimize the switch case as
-		// it will know that the code will never
-		// reach this point
-		__assume(0);
-#endif
-	}
+// interface
+asEContextState asCContext::GetState() const
+{
+	return m_status;
+}
 
-#ifdef AS_DEBUG
-		asDWORD instr = *(asBYTE*)old;
-		if( instr != asBC_JMP && instr != asBC_JMPP && (instr < asBC_JZ || instr > asBC_JNP) && instr != asBC_JLowZ && instr != asBC_JLowNZ &&
-			instr != asBC_CALL && instr != asBC_CALLBND && instr != asBC_CALLINTF && instr != asBC_RET && instr != asBC_ALLOC && instr != asBC_CallPtr &&
-			instr != asBC_JitEntry )
+// interface
+int asCContext::SetLineCallback(asSFuncPtr callback, void *obj, int callConv)
+{
+	m_lineCallback = true;
+	m_regs.doProcessSuspend = true;
+	m_lineCallbackObj = obj;
+	bool isObj = false;
+	if( (unsigned)callConv == asCALL_GENERIC )
+	{
+		m_lineCallback = false;
+		m_regs.doProcessSuspend = m_doSuspend;
+		return asNOT_SUPPORTED;
+	}
+	if( (unsigned)callConv >= asCALL_THISCALL )
+	{
+		isObj = true;
+		if( obj == 0 )
 		{
-			asASSERT( (l_bc - old) == asBCTypeSize[asBCInfo[instr].type] );
+			m_lineCallback = false;
+			m_regs.doProcessSuspend = m_doSuspend;
+			return asINVALID_ARG;
 		}
-#endif
 	}
-}
 
-int asCContext::SetException(const char *descr)
-{
-	// Only allow this if we're executing a CALL byte code
-	if( m_callingSystemFunction == 0 ) return asERROR;
+	int r = DetectCallingConvention(isObj, callback, callConv, 0, &m_lineCallbackFunc);
+	if( r < 0 ) m_lineCallback = false;
 
-	SetInternalException(descr);
+	m_regs.doProcessSuspend = m_doSuspend || m_lineCallback;
 
-	return 0;
+	return r;
 }
 
-void asCContext::SetInternalException(const char *descr)
+void asCContext::CallLineCallback()
 {
-	if( m_inExceptionHandler )
+	if( m_lineCallbackFunc.callConv < ICC_THISCALL )
+		m_engine->CallGlobalFunction(this, m_lineCallbackObj, &m_lineCallbackFunc, 0);
+	else
+		m_engine->CallObjectMethod(m_lineCallbackObj, this, &m_lineCallbackFunc, 0);
+}
+
+// interface
+int asCContext::SetExceptionCallback(asSFuncPtr callback, void *obj, int callConv)
+{
+	m_exceptionCallback = true;
+	m_exceptionCallbackObj = obj;
+	bool isObj = false;
+	if( (unsigned)callConv == asCALL_GENERIC )
+		return asNOT_SUPPORTED;
+	if( (unsigned)callConv >= asCALL_THISCALL )
 	{
-		asASSERT(false); // Shouldn't happen
-		return; // but if it does, at least this will not crash the application
+		isObj = true;
+		if( obj == 0 )
+		{
+			m_exceptionCallback = false;
+			return asINVALID_ARG;
+		}
 	}
+	int r = DetectCallingConvention(isObj, callback, callConv, 0, &m_exceptionCallbackFunc);
+	if( r < 0 ) m_exceptionCallback = false;
+	return r;
+}
 
-	m_status                = asEXECUTION_EXCEPTION;
-	m_regs.doProcessSuspend = true;
+void asCContext::CallExceptionCallback()
+{
+	if( m_exceptionCallbackFunc.callConv < ICC_THISCALL )
+		m_engine->CallGlobalFunction(this, m_exceptionCallbackObj, &m_exceptionCallbackFunc, 0);
+	else
+		m_engine->CallObjectMethod(m_exceptionCallbackObj, this, &m_exceptionCallbackFunc, 0);
+}
 
-	m_exceptionString       = descr;
-	m_exceptionFunction     = m_currentFunction->id;
-	m_exceptionLine         = m_currentFunction->GetLineNumber(int(m_regs.programPointer - m_currentFunction->byteCode.AddressOf()), &m_exceptionSectionIdx);
-	m_exceptionColumn       = m_exceptionLine >> 20;
-	m_exceptionLine        &= 0xFFFFF;
+// interface
+void asCContext::ClearLineCallback()
+{
+	m_lineCallback = false;
+	m_regs.doProcessSuspend = m_doSuspend;
+}
 
-	if( m_exceptionCallback )
-		CallExceptionCallback();
+// interface
+void asCContext::ClearExceptionCallback()
+{
+	m_exceptionCallback = false;
 }
 
-void asCContext::CleanReturnObject()
+int asCContext::CallGeneric(int id, void *objectPointer)
 {
-	if( m_initialFunction && m_initialFunction->DoesReturnOnStack() && m_status == asEXECUTION_FINISHED )
+	asCScriptFunction *sysFunction = m_engine->scriptFunctions[id];
+	asSSystemFunctionInterface *sysFunc = sysFunction->sysFuncIntf;
+	void (*func)(asIScriptGeneric*) = (void (*)(asIScriptGeneric*))sysFunc->func;
+	int popSize = sysFunc->paramSize;
+	asDWORD *args = m_regs.stackPointer;
+
+	// Verify the object pointer if it is a class method
+	void *currentObject = 0;
+	if( sysFunc->callConv == ICC_GENERIC_METHOD )
 	{
-		// If function returns on stack we need to call the destructor on the returned object
-		if( m_initialFunction->returnType.GetObjectType()->beh.destruct )
-			m_engine->CallObjectMethod(GetReturnObject(), m_initialFunction->returnType.GetObjectType()->beh.destruct);
+		if( objectPointer )
+		{
+			currentObject = objectPointer;
 
-		return;
-	}
+			// Don't increase the reference of this pointer
+			// since it will not have been constructed yet
+		}
+		else
+		{
+			// The object pointer should be popped from the context stack
+			popSize += AS_PTR_SIZE;
 
-	if( m_regs.objectRegister == 0 ) return;
+			// Check for null pointer
+			currentObject = (void*)*(asPWORD*)(args);
+			if( currentObject == 0 )
+			{
+				SetInternalException(TXT_NULL_POINTER_ACCESS);
+				return 0;
+			}
 
-	asASSERT( m_regs.objectType != 0 );
+			// Add the base offset for multiple inheritance
+			currentObject = (void*)(asPWORD(currentObject) + sysFunc->baseOffset);
 
-	if( m_regs.objectType )
+			// Skip object pointer
+			args += AS_PTR_SIZE;
+		}
+	}
+
+	if( sysFunction->DoesReturnOnStack() )
 	{
-		// Call the destructor on the object
-		asSTypeBehaviour *beh = &((asCObjectType*)m_regs.objectType)->beh;
-		if( m_regs.objectType->GetFlags() & asOBJ_REF )
-		{
-			asASSERT( beh->release || (m_regs.objectType->GetFlags() & asOBJ_NOCOUNT) );
+		// Skip the address where the return value will be stored
+		args += AS_PTR_SIZE;
+		popSize += AS_PTR_SIZE;
+	}
 
-			if( beh->release )
-				m_engine->CallObjectMethod(m_regs.objectRegister, beh->release);
+	asCGeneric gen(m_engine, sysFunction, currentObject, args);
 
-			m_regs.objectRegister = 0;
-		}
-		else
+	m_callingSystemFunction = sysFunction;
+	func(&gen);
+	m_callingSystemFunction = 0;
+
+	m_regs.valueRegister = gen.returnVal;
+	m_regs.objectRegister = gen.objectRegister;
+	m_regs.objectType = sysFunction->returnType.GetObjectType();
+
+	// Clean up function parameters
+	int offset = 0;
+	for( asUINT n = 0; n < sysFunction->parameterTypes.GetLength(); n++ )
+	{
+		if( sysFunction->parameterTypes[n].IsObject() && !sysFunction->parameterTypes[n].IsReference() )
 		{
-			if( beh->destruct )
-				m_engine->CallObjectMethod(m_regs.objectRegister, beh->destruct);
+			void *obj = *(void**)&args[offset];
+			if( obj )
+			{
+				// Release the object
+				asSTypeBehaviour *beh = &sysFunction->parameterTypes[n].GetObjectType()->beh;
+				if( sysFunction->parameterTypes[n].GetObjectType()->flags & asOBJ_REF )
+				{
+					asASSERT( (sysFunction->parameterTypes[n].GetObjectType()->flags & asOBJ_NOCOUNT) || beh->release );
+					if( beh->release )
+						m_engine->CallObjectMethod(obj, beh->release);
+				}
+				else
+				{
+					// Call the destructor then free the memory
+					if( beh->destruct )
+						m_engine->CallObjectMethod(obj, beh->destruct);
 
-			// Free the memory
-			m_engine->CallFree(m_regs.objectRegister);
-			m_regs.objectRegister = 0;
+					m_engine->CallFree(obj);
+				}
+			}
 		}
+		offset += sysFunction->parameterTypes[n].GetSizeOnStackDWords();
 	}
+
+	// Return how much should be popped from the stack
+	return popSize;
 }
 
-void asCContext::CleanStack()
+// interface
+int asCContext::GetVarCount(asUINT stackLevel)
 {
-	m_inExceptionHandler = true;
+	asIScriptFunction *func = GetFunction(stackLevel);
+	if( func == 0 ) return asINVALID_ARG;
 
-	// Run the clean up code for each of the functions called
-	CleanStackFrame();
+	return func->GetVarCount();
+}
 
-	// Set the status to exception so that the stack unwind is done correctly.
-	// This shouldn't be done for the current function, which is why we only
-	// do this after the first CleanStackFrame() is done.
-	m_status = asEXECUTION_EXCEPTION;
+// interface
+const char *asCContext::GetVarName(asUINT varIndex, asUINT stackLevel)
+{
+	asIScriptFunction *func = GetFunction(stackLevel);
+	if( func == 0 ) return 0;
 
-	while( m_callStack.GetLength() > 0 )
-	{
-		// Only clean up until the top most marker for a nested call
-		asPWORD *s = m_callStack.AddressOf() + m_callStack.GetLength() - CALLSTACK_FRAME_SIZE;
-		if( s[0] == 0 )
-			break;
+	const char *name = 0;
+	int r = func->GetVar(varIndex, &name);
+	return r >= 0 ? name : 0;
+}
 
-		PopCallState();
+// interface
+const char *asCContext::GetVarDeclaration(asUINT varIndex, asUINT stackLevel)
+{
+	asIScriptFunction *func = GetFunction(stackLevel);
+	if( func == 0 ) return 0;
 
-		CleanStackFrame();
-	}
+	return func->GetVarDecl(varIndex);
+}
 
-	m_inExceptionHandler = false;
+// interface
+int asCContext::GetVarTypeId(asUINT varIndex, asUINT stackLevel)
+{
+	asIScriptFunction *func = GetFunction(stackLevel);
+	if( func == 0 ) return asINVALID_ARG;
+
+	int typeId;
+	int r = func->GetVar(varIndex, 0, &typeId);
+	return r < 0 ? r : typeId;
 }
 
-// Interface
-bool asCContext::IsVarInScope(asUINT varIndex, asUINT stackLevel)
+// interface
+void *asCContext::GetAddressOfVar(asUINT varIndex, asUINT stackLevel)
 {
 	// Don't return anything if there is no bytecode, e.g. before calling Execute()
-	if( m_regs.programPointer == 0 ) return false;
+	if( m_regs.programPointer == 0 ) return 0;
 
-	if( stackLevel >= GetCallstackSize() ) return false;
+	if( stackLevel >= GetCallstackSize() ) return 0;
 
 	asCScriptFunction *func;
-	asUINT pos;
-
+	asDWORD *sf;
 	if( stackLevel == 0 )
 	{
 		func = m_currentFunction;
-		pos = asUINT(m_regs.programPointer - func->byteCode.AddressOf());
+		sf = m_regs.stackFramePointer;
 	}
 	else
 	{
 		asPWORD *s = m_callStack.AddressOf() + (GetCallstackSize()-stackLevel-1)*CALLSTACK_FRAME_SIZE;
 		func = (asCScriptFunction*)s[1];
-		pos = asUINT((asDWORD*)s[2] - func->byteCode.AddressOf());
+		sf = (asDWORD*)s[0];
 	}
 
-	// First determine if the program position is after the variable declaration
-	if( func->variables.GetLength() <= varIndex ) return false;
-	if( func->variables[varIndex]->declaredAtProgramPos > pos ) return false;
+	if( func == 0 )
+		return 0;
 
-	asUINT declaredAt = func->variables[varIndex]->declaredAtProgramPos;
+	if( varIndex >= func->variables.GetLength() )
+		return 0;
 
-	// If the program position is after the variable declaration it is necessary
-	// determine if the program position is still inside the statement block where
-	// the variable was delcared.
-	for( int n = 0; n < (int)func->objVariableInfo.GetLength(); n++ )
+	// For object variables it's necessary to dereference the pointer to get the address of the value
+	// Reference parameters must also be dereferenced to give the address of the value
+	int pos = func->variables[varIndex]->stackOffset;
+	if( (func->variables[varIndex]->type.IsObject() && !func->variables[varIndex]->type.IsObjectHandle()) || (pos <= 0) )
 	{
-		if( func->objVariableInfo[n].programPos >= declaredAt )
+		// Determine if the object is really on the heap
+		bool onHeap = false;
+		if( func->variables[varIndex]->type.IsObject() &&
+			!func->variables[varIndex]->type.IsObjectHandle() )
 		{
-			// If the current block ends between the declaredAt and current
-			// program position, then we know the variable is no longer visible
-			int level = 0;
-			for( ; n < (int)func->objVariableInfo.GetLength(); n++ )
+			onHeap = true;
+			if( func->variables[varIndex]->type.GetObjectType()->GetFlags() & asOBJ_VALUE )
 			{
-				if( func->objVariableInfo[n].programPos > pos )
+				for( asUINT n = 0; n < func->objVariablePos.GetLength(); n++ )
+				{
+					if( func->objVariablePos[n] == pos )
+					{
+						onHeap = n < func->objVariablesOnHeap;
+
+						if( !onHeap )
+						{
+							// If the object on the stack is not initialized return a null pointer instead
+							asCArray<int> liveObjects;
+							DetermineLiveObjects(liveObjects, stackLevel);
+
+							if( liveObjects[n] <= 0 )
+								return 0;
+						}
+
+						break;
+					}
+				}
+			}
+		}
+
+		// If it wasn't an object on the heap, then check if it is a reference parameter
+		if( !onHeap && pos <= 0 )
+		{
+			// Determine what function argument this position matches
+			int stackPos = 0;
+			if( func->objectType )
+				stackPos -= AS_PTR_SIZE;
+
+			if( func->DoesReturnOnStack() )
+				stackPos -= AS_PTR_SIZE;
+
+			for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
+			{
+				if( stackPos == pos )
+				{
+					// The right argument was found. Is this a reference parameter?
+					if( func->inOutFlags[n] != asTM_NONE )
+						onHeap = true;
+
 					break;
+				}
+				stackPos -= func->parameterTypes[n].GetSizeOnStackDWords();
+			}
+		}
+
+		if( onHeap )
+			return *(void**)(sf - func->variables[varIndex]->stackOffset);
+	}
+
+	return sf - func->variables[varIndex]->stackOffset;
+}
+
+// interface
+// returns the typeId of the 'this' object at the given call stack level (-1 for current)
+// returns 0 if the function call at the given stack level is not a method
+int asCContext::GetThisTypeId(asUINT stackLevel)
+{
+	asIScriptFunction *func = GetFunction(stackLevel);
+	if( func == 0 ) return asINVALID_ARG;
 
-				if( func->objVariableInfo[n].option == asBLOCK_BEGIN ) level++;
-				if( func->objVariableInfo[n].option == asBLOCK_END && --level < 0 )
-					return false;
-			}
+	if( func->GetObjectType() == 0 )
+		return 0; // not in a method
 
-			break;
-		}
-	}
+	// create a datatype
+	asCDataType dt = asCDataType::CreateObject((asCObjectType*)func->GetObjectType(), false);
 
-	// Variable is visible
-	return true;
+	// return a typeId from the data type
+	return m_engine->GetTypeIdFromDataType(dt);
 }
 
-// Internal
-void asCContext::DetermineLiveObjects(asCArray<int> &liveObjects, asUINT stackLevel)
+// interface
+// returns the 'this' object pointer at the given call stack level (-1 for current)
+// returns 0 if the function call at the given stack level is not a method
+void *asCContext::GetThisPointer(asUINT stackLevel)
 {
-	asASSERT( stackLevel < GetCallstackSize() );
+	if( stackLevel >= GetCallstackSize() )
+		return 0;
 
 	asCScriptFunction *func;
-	asUINT pos;
-
+	asDWORD *sf;
 	if( stackLevel == 0 )
 	{
 		func = m_currentFunction;
-		pos = asUINT(m_regs.programPointer - func->byteCode.AddressOf());
-
-		if( m_status == asEXECUTION_EXCEPTION )
-		{
-			// Don't consider the last instruction as executed, as it failed with an exception
-			// It's not actually necessary to decrease the exact size of the instruction. Just
-			// before the current position is enough to disconsider it.
-			pos--;
-		}
+		sf = m_regs.stackFramePointer;
 	}
 	else
 	{
 		asPWORD *s = m_callStack.AddressOf() + (GetCallstackSize()-stackLevel-1)*CALLSTACK_FRAME_SIZE;
 		func = (asCScriptFunction*)s[1];
-		pos = asUINT((asDWORD*)s[2] - func->byteCode.AddressOf());
-
-		// Don't consider the last instruction as executed, as the function that was called by it
-		// is still being executed. If we consider it as executed already, then a value object
-		// returned by value would be considered alive, which it is not.
-		pos--;
-	}
-
-	// Determine which object variables that are really live ones
-	liveObjects.SetLength(func->objVariablePos.GetLength());
-	memset(liveObjects.AddressOf(), 0, sizeof(int)*liveObjects.GetLength());
-	for( int n = 0; n < (int)func->objVariableInfo.GetLength(); n++ )
-	{
-		// Find the first variable info with a larger position than the current
-		// As the variable info are always placed on the instruction right after the
-		// one that initialized or freed the object, the current position needs to be
-		// considered as valid.
-		if( func->objVariableInfo[n].programPos > pos )
-		{
-			// We've determined how far the execution ran, now determine which variables are alive
-			for( --n; n >= 0; n-- )
-			{
-				switch( func->objVariableInfo[n].option )
-				{
-				case asOBJ_UNINIT: // Object was destroyed
-					{
-						// TODO: optimize: This should have been done by the compiler already
-						// Which variable is this?
-						asUINT var = 0;
-						for( asUINT v = 0; v < func->objVariablePos.GetLength(); v++ )
-							if( func->objVariablePos[v] == func->objVariableInfo[n].variableOffset )
-							{
-								var = v;
-								break;
-							}
-						liveObjects[var] -= 1;
-					}
-					break;
-				case asOBJ_INIT: // Object was created
-					{
-						// Which variable is this?
-						asUINT var = 0;
-						for( asUINT v = 0; v < func->objVariablePos.GetLength(); v++ )
-							if( func->objVariablePos[v] == func->objVariableInfo[n].variableOffset )
-							{
-								var = v;
-								break;
-							}
-						liveObjects[var] += 1;
-					}
-					break;
-				case asBLOCK_BEGIN: // Start block
-					// We should ignore start blocks, since it just means the
-					// program was within the block when the exception ocurred
-					break;
-				case asBLOCK_END: // End block
-					// We need to skip the entire block, as the objects created
-					// and destroyed inside this block are already out of scope
-					{
-						int nested = 1;
-						while( nested > 0 )
-						{
-							int option = func->objVariableInfo[--n].option;
-							if( option == 3 )
-								nested++;
-							if( option == 2 )
-								nested--;
-						}
-					}
-					break;
-				}
-			}
-
-			// We're done with the investigation
-			break;
-		}
+		sf = (asDWORD*)s[0];
 	}
-}
 
-void asCContext::CleanArgsOnStack()
-{
-	if( !m_needToCleanupArgs )
-		return;
+	if( func == 0 )
+		return 0;
 
-	// Find the instruction just before the current program pointer
-	asDWORD *instr = m_currentFunction->byteCode.AddressOf();
-	asDWORD *prevInstr = 0;
-	while( instr < m_regs.programPointer )
-	{
-		prevInstr = instr;
-		instr += asBCTypeSize[asBCInfo[*(asBYTE*)(instr)].type];
-	}
+	if( func->objectType == 0 )
+		return 0; // not in a method
 
-	// Determine what function was being called
-	asCScriptFunction *func = 0;
-	asBYTE bc = *(asBYTE*)prevInstr;
-	if( bc == asBC_CALL || bc == asBC_CALLSYS || bc == asBC_CALLINTF )
-	{
-		int funcId = asBC_INTARG(prevInstr);
-		func = m_engine->scriptFunctions[funcId];
-	}
-	else if( bc == asBC_CALLBND )
+	void *thisPointer = (void*)*(asPWORD*)(sf);
+	if( thisPointer == 0 )
 	{
-		int funcId = asBC_INTARG(prevInstr);
-		func = m_engine->importedFunctions[funcId & ~FUNC_IMPORTED]->importedFunctionSignature;
+		return 0;
 	}
-	else if( bc == asBC_CallPtr )
-	{
-		asUINT v;
-		int var = asBC_SWORDARG0(prevInstr);
 
-		// Find the funcdef from the local variable
-		for( v = 0; v < m_currentFunction->objVariablePos.GetLength(); v++ )
-			if( m_currentFunction->objVariablePos[v] == var )
-			{
-				func = m_currentFunction->funcVariableTypes[v];
-				break;
-			}
+	// NOTE: this returns the pointer to the 'this' while the GetVarPointer functions return
+	// a pointer to a pointer. I can't imagine someone would want to change the 'this'
+	return thisPointer;
+}
 
-		if( func == 0 )
-		{
-			// Look in parameters
-			int paramPos = 0;
-			if( m_currentFunction->objectType )
-				paramPos -= AS_PTR_SIZE;
-			if( m_currentFunction->DoesReturnOnStack() )
-				paramPos -= AS_PTR_SIZE;
-			for( v = 0; v < m_currentFunction->parameterTypes.GetLength(); v++ )
-			{
-				if( var == paramPos )
-				{
-					func = m_currentFunction->parameterTypes[v].GetFuncDef();
-					break;
-				}
-				paramPos -= m_currentFunction->parameterTypes[v].GetSizeOnStackDWords();
-			}
-		}
-	}
-	else
-		asASSERT( false );
+asCCoroutine::asCCoroutine(asCContext *ctx, asCScriptFunction *func)
+{
+	m_refCount.set(1);
 
-	asASSERT( func );
+	// Add the co-routine to the context's list
+	m_ctx = ctx;
+	m_prevCoroutine = 0;
+	m_nextCoroutine = ctx->m_coroutineList;
+	if( m_nextCoroutine )
+		m_nextCoroutine->m_prevCoroutine = this;
+	ctx->m_coroutineList = this;
+
+	m_function = func;
+	m_function->AddRef();
+
+	m_status            = asEXECUTION_UNINITIALIZED;
+	m_userData          = 0;
+	m_resumer           = 0;
+	m_resumeLevel       = 0;
+	m_stackBlockSize    = 0;
+	m_stackIndex        = 0;
+	m_currentFunction   = 0;
+	m_programPointer    = 0;
+	m_stackFramePointer = 0;
+	m_stackPointer      = 0;
+	m_valueRegister     = 0;
+	m_objectRegister    = 0;
+	m_objectType        = 0;
+}
 
-	// Clean parameters
-	int offset = 0;
-	if( func->objectType )
-		offset += AS_PTR_SIZE;
-	if( func->DoesReturnOnStack() )
-		offset += AS_PTR_SIZE;
-	for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
+asCCoroutine::~asCCoroutine()
+{
+	if( m_ctx )
 	{
-		if( func->parameterTypes[n].IsObject() && !func->parameterTypes[n].IsReference() )
-		{
-			if( *(asPWORD*)&m_regs.stackPointer[offset] )
-			{
-				// Call the object's destructor
-				asSTypeBehaviour *beh = func->parameterTypes[n].GetBehaviour();
-				if( func->parameterTypes[n].GetObjectType()->flags & asOBJ_REF )
-				{
-					asASSERT( (func->parameterTypes[n].GetObjectType()->flags & asOBJ_NOCOUNT) || beh->release );
-
-					if( beh->release )
-						m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackPointer[offset], beh->release);
-					*(asPWORD*)&m_regs.stackPointer[offset] = 0;
-				}
-				else
-				{
-					if( beh->destruct )
-						m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackPointer[offset], beh->destruct);
-
-					// Free the memory
-					m_engine->CallFree((void*)*(asPWORD*)&m_regs.stackPointer[offset]);
-					*(asPWORD*)&m_regs.stackPointer[offset] = 0;
-				}
-			}
-		}
+		// The co-routine may still hold objects on its stack
+		if( m_status == asEXECUTION_PREPARED || m_status == asEXECUTION_SUSPENDED )
+			m_ctx->DiscardCoroutine(this);
 
-		offset += func->parameterTypes[n].GetSizeOnStackDWords();
+		RemoveFromContext();
 	}
 
-	m_needToCleanupArgs = false;
+	FreeStack();
+
+	m_function->Release();
 }
 
-void asCContext::CleanStackFrame()
+// internal
+bool asCCoroutine::Prepare()
 {
-	// Clean object variables on the stack
-	// If the stack memory is not allocated or the program pointer
-	// is not set, then there is nothing to clean up on the stack frame
-	if( !m_isStackMemoryNotAllocated && m_regs.programPointer )
-	{
-		// If the exception occurred while calling a function it is necessary
-		// to clean up the arguments that were put on the stack.
-		CleanArgsOnStack();
+	int argumentsSize = m_function->GetSpaceNeededForArguments();
 
-		// Restore the stack pointer
-		m_regs.stackPointer += m_currentFunction->variableSpace;
-
-		// Determine which object variables that are really live ones
-		asCArray<int> liveObjects;
-		DetermineLiveObjects(liveObjects, 0);
-
-		for( asUINT n = 0; n < m_currentFunction->objVariablePos.GetLength(); n++ )
-		{
-			int pos = m_currentFunction->objVariablePos[n];
-			if( n < m_currentFunction->objVariablesOnHeap )
-			{
-				// Check if the pointer is initialized
-				if( *(asPWORD*)&m_regs.stackFramePointer[-pos] )
-				{
-					// Call the object's destructor
-					asSTypeBehaviour *beh = &m_currentFunction->objVariableTypes[n]->beh;
-					if( m_currentFunction->objVariableTypes[n]->flags & asOBJ_REF )
-					{
-						asASSERT( (m_currentFunction->objVariableTypes[n]->flags & asOBJ_NOCOUNT) || beh->release );
-						if( beh->release )
-							m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackFramePointer[-pos], beh->release);
-						*(asPWORD*)&m_regs.stackFramePointer[-pos] = 0;
-					}
-					else
-					{
-						if( beh->destruct )
-							m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackFramePointer[-pos], beh->destruct);
+	// The stack starts small, as there may be very many co-routines
+	m_stackBlockSize = argumentsSize + m_function->stackNeeded + RESERVE_STACK;
+	if( m_stackBlockSize < MIN_COROUTINE_STACK_SIZE )
+		m_stackBlockSize = MIN_COROUTINE_STACK_SIZE;
 
-						// Free the memory
-						m_engine->CallFree((void*)*(asPWORD*)&m_regs.stackFramePointer[-pos]);
-						*(asPWORD*)&m_regs.stackFramePointer[-pos] = 0;
-					}
-				}
-			}
-			else
-			{
-				asASSERT( m_currentFunction->objVariableTypes[n]->GetFlags() & asOBJ_VALUE );
+	asDWORD *stack = asNEWARRAY(asDWORD, m_stackBlockSize);
+	if( stack == 0 )
+		return false;
 
-				// Only destroy the object if it is truly alive
-				if( liveObjects[n] > 0 )
-				{
-					asSTypeBehaviour *beh = &m_currentFunction->objVariableTypes[n]->beh;
-					if( beh->destruct )
-						m_engine->CallObjectMethod((void*)(asPWORD*)&m_regs.stackFramePointer[-pos], beh->destruct);
-				}
-			}
-		}
+	m_stackBlocks.PushLast(stack);
+	m_stackIndex = 0;
 
-		// If the object is a script declared object, then we must release it
-		// as the compiler adds a reference at the entry of the function. Make sure
-		// the function has actually been entered
-		if( m_currentFunction->objectType && m_regs.programPointer != m_currentFunction->byteCode.AddressOf() )
-		{
-			// Methods returning a reference or constructors don't add a reference
-			if( !m_currentFunction->returnType.IsReference() && m_currentFunction->name != m_currentFunction->objectType->name )
-			{
-				asSTypeBehaviour *beh = &m_currentFunction->objectType->beh;
-				if( beh->release && *(asPWORD*)&m_regs.stackFramePointer[0] != 0 )
-				{
-					m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackFramePointer[0], beh->release);
-					*(asPWORD*)&m_regs.stackFramePointer[0] = 0;
-				}
-			}
-		}
-	}
+	// Reserve space for the arguments at the top of the stack
+	m_stackFramePointer = stack + m_stackBlockSize - argumentsSize;
+	m_stackPointer      = m_stackFramePointer;
+	memset(m_stackPointer, 0, 4*argumentsSize);
+
+	m_currentFunction = m_function;
+	m_programPointer  = 0;
+	m_status          = asEXECUTION_PREPARED;
+
+	return true;
+}
+
+// internal
+void asCCoroutine::RemoveFromContext()
+{
+	if( m_prevCoroutine )
+		m_prevCoroutine->m_nextCoroutine = m_nextCoroutine;
 	else
-		m_isStackMemoryNotAllocated = false;
+		m_ctx->m_coroutineList = m_nextCoroutine;
+	if( m_nextCoroutine )
+		m_nextCoroutine->m_prevCoroutine = m_prevCoroutine;
 
-	// Functions that do not own the object and parameters shouldn't do any clean up
-	if( m_currentFunction->dontCleanUpOnException )
-		return;
+	m_prevCoroutine = 0;
+	m_nextCoroutine = 0;
+	m_ctx = 0;
+}
 
-	// Clean object and parameters
-	int offset = 0;
-	if( m_currentFunction->objectType )
-		offset += AS_PTR_SIZE;
-	if( m_currentFunction->DoesReturnOnStack() )
-		offset += AS_PTR_SIZE;
-	for( asUINT n = 0; n < m_currentFunction->parameterTypes.GetLength(); n++ )
+// internal
+void asCCoroutine::FreeStack()
+{
+	for( asUINT n = 0; n < m_stackBlocks.GetLength(); n++ )
 	{
-		if( m_currentFunction->parameterTypes[n].IsObject() && !m_currentFunction->parameterTypes[n].IsReference() )
+		if( m_stackBlocks[n] )
 		{
-			if( *(asPWORD*)&m_regs.stackFramePointer[offset] )
-			{
-				// Call the object's destructor
-				asSTypeBehaviour *beh = m_currentFunction->parameterTypes[n].GetBehaviour();
-				if( m_currentFunction->parameterTypes[n].GetObjectType()->flags & asOBJ_REF )
-				{
-					asASSERT( (m_currentFunction->parameterTypes[n].GetObjectType()->flags & asOBJ_NOCOUNT) || beh->release );
-
-					if( beh->release )
-						m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackFramePointer[offset], beh->release);
-					*(asPWORD*)&m_regs.stackFramePointer[offset] = 0;
-				}
-				else
-				{
-					if( beh->destruct )
-						m_engine->CallObjectMethod((void*)*(asPWORD*)&m_regs.stackFramePointer[offset], beh->destruct);
-
-					// Free the memory
-					m_engine->CallFree((void*)*(asPWORD*)&m_regs.stackFramePointer[offset]);
-					*(asPWORD*)&m_regs.stackFramePointer[offset] = 0;
-				}
-			}
+			asDELETEARRAY(m_stackBlocks[n]);
 		}
-
-		offset += m_currentFunction->parameterTypes[n].GetSizeOnStackDWords();
 	}
+	m_stackBlocks.SetLength(0);
+	m_callStack.SetLength(0);
 }
 
 // interface
-int asCContext::GetExceptionLineNumber(int *column, const char **sectionName)
+int asCCoroutine::AddRef() const
 {
-	if( GetState() != asEXECUTION_EXCEPTION ) return asERROR;
+	return m_refCount.atomicInc();
+}
 
-	if( column ) *column = m_exceptionColumn;
+// interface
+int asCCoroutine::Release() const
+{
+	int r = m_refCount.atomicDec();
 
-	if( sectionName ) *sectionName = m_engine->scriptSectionNames[m_exceptionSectionIdx]->AddressOf();
+	if( r == 0 )
+	{
+		asDELETE(const_cast<asCCoroutine*>(this),asCCoroutine);
+		return 0;
+	}
 
-	return m_exceptionLine;
+	return r;
 }
 
 // interface
-asIScriptFunction *asCContext::GetExceptionFunction()
+asIScriptContext *asCCoroutine::GetContext() const
 {
-	if( GetState() != asEXECUTION_EXCEPTION ) return 0;
-
-	return m_engine->scriptFunctions[m_exceptionFunction];
+	return m_ctx;
 }
 
 // interface
-const char *asCContext::GetExceptionString()
+asIScriptFunction *asCCoroutine::GetFunction() const
 {
-	if( GetState() != asEXECUTION_EXCEPTION ) return 0;
-
-	return m_exceptionString.AddressOf();
+	return m_function;
 }
 
 // interface
-asEContextState asCContext::GetState() const
+asEContextState asCCoroutine::GetState() const
 {
 	return m_status;
 }
 
+// internal
+int asCCoroutine::GetArgOffset(asUINT arg) const
+{
+	int offset = 0;
+	for( asUINT n = 0; n < arg; n++ )
+		offset += m_function->parameterTypes[n].GetSizeOnStackDWords();
+
+	return offset;
+}
+
 // interface
-int asCContext::SetLineCallback(asSFuncPtr callback, void *obj, int callConv)
+int asCCoroutine::SetArgDWord(asUINT arg, asDWORD value)
 {
-	m_lineCallback = true;
-	m_regs.doProcessSuspend = true;
-	m_lineCallbackObj = obj;
-	bool isObj = false;
-	if( (unsigned)callConv == asCALL_GENERIC )
-	{
-		m_lineCallback = false;
-		m_regs.doProcessSuspend = m_doSuspend;
-		return asNOT_SUPPORTED;
-	}
-	if( (unsigned)callConv >= asCALL_THISCALL )
-	{
-		isObj = true;
-		if( obj == 0 )
-		{
-			m_lineCallback = false;
-			m_regs.doProcessSuspend = m_doSuspend;
-			return asINVALID_ARG;
-		}
-	}
+	if( m_status != asEXECUTION_PREPARED )
+		return asCONTEXT_NOT_PREPARED;
 
-	int r = DetectCallingConvention(isObj, callback, callConv, 0, &m_lineCallbackFunc);
-	if( r < 0 ) m_lineCallback = false;
+	if( arg >= m_function->parameterTypes.GetLength() )
+		return asINVALID_ARG;
 
-	m_regs.doProcessSuspend = m_doSuspend || m_lineCallback;
+	// Verify the type of the argument
+	asCDataType *dt = &m_function->parameterTypes[arg];
+	if( dt->IsObject() || dt->IsReference() || dt->GetSizeInMemoryBytes() != 4 )
+		return asINVALID_TYPE;
 
-	return r;
+	*(asDWORD*)&m_stackFramePointer[GetArgOffset(arg)] = value;
+
+	return 0;
 }
 
-void asCContext::CallLineCallback()
+// interface
+int asCCoroutine::SetArgQWord(asUINT arg, asQWORD value)
 {
-	if( m_lineCallbackFunc.callConv < ICC_THISCALL )
-		m_engine->CallGlobalFunction(this, m_lineCallbackObj, &m_lineCallbackFunc, 0);
-	else
-		m_engine->CallObjectMethod(m_lineCallbackObj, this, &m_lineCallbackFunc, 0);
+	if( m_status != asEXECUTION_PREPARED )
+		return asCONTEXT_NOT_PREPARED;
+
+	if( arg >= m_function->parameterTypes.GetLength() )
+		return asINVALID_ARG;
+
+	// Verify the type of the argument
+	asCDataType *dt = &m_function->parameterTypes[arg];
+	if( dt->IsObject() || dt->IsReference() || dt->GetSizeOnStackDWords() != 2 )
+		return asINVALID_TYPE;
+
+	*(asQWORD*)&m_stackFramePointer[GetArgOffset(arg)] = value;
+
+	return 0;
 }
 
 // interface
-int asCContext::SetExceptionCallback(asSFuncPtr callback, void *obj, int callConv)
+int asCCoroutine::SetArgObject(asUINT arg, void *obj)
 {
-	m_exceptionCallback = true;
-	m_exceptionCallbackObj = obj;
-	bool isObj = false;
-	if( (unsigned)callConv == asCALL_GENERIC )
-		return asNOT_SUPPORTED;
-	if( (unsigned)callConv >= asCALL_THISCALL )
+	if( m_status != asEXECUTION_PREPARED )
+		return asCONTEXT_NOT_PREPARED;
+
+	if( arg >= m_function->parameterTypes.GetLength() )
+		return asINVALID_ARG;
+
+	// Verify the type of the argument
+	asCDataType *dt = &m_function->parameterTypes[arg];
+	if( !dt->IsObject() )
+		return asINVALID_TYPE;
+
+	// If the object should be sent by value we must make a copy of it
+	if( !dt->IsReference() )
 	{
-		isObj = true;
-		if( obj == 0 )
+		asCScriptEngine *engine = m_ctx->m_engine;
+		if( dt->IsObjectHandle() )
 		{
-			m_exceptionCallback = false;
-			return asINVALID_ARG;
+			// Increase the reference counter
+			asSTypeBehaviour *beh = &dt->GetObjectType()->beh;
+			if( obj && beh->addref )
+				engine->CallObjectMethod(obj, beh->addref);
+		}
+		else
+		{
+			obj = engine->CreateScriptObjectCopy(obj, engine->GetTypeIdFromDataType(*dt));
 		}
 	}
-	int r = DetectCallingConvention(isObj, callback, callConv, 0, &m_exceptionCallbackFunc);
-	if( r < 0 ) m_exceptionCallback = false;
-	return r;
+
+	*(asPWORD*)(&m_stackFramePointer[GetArgOffset(arg)]) = (asPWORD)obj;
+
+	return 0;
 }
 
-void asCContext::CallExceptionCallback()
+// interface
+void *asCCoroutine::GetAddressOfArg(asUINT arg)
 {
-	if( m_exceptionCallbackFunc.callConv < ICC_THISCALL )
-		m_engine->CallGlobalFunction(this, m_exceptionCallbackObj, &m_exceptionCallbackFunc, 0);
-	else
-		m_engine->CallObjectMethod(m_exceptionCallbackObj, this, &m_exceptionCallbackFunc, 0);
+	if( m_status != asEXECUTION_PREPARED )
+		return 0;
+
+	if( arg >= m_function->parameterTypes.GetLength() )
+		return 0;
+
+	return &m_stackFramePointer[GetArgOffset(arg)];
 }
 
 // interface
-void asCContext::ClearLineCallback()
+void *asCCoroutine::SetUserData(void *data)
 {
-	m_lineCallback = false;
-	m_regs.doProcessSuspend = m_doSuspend;
+	void *oldData = m_userData;
+	m_userData = data;
+	return oldData;
 }
 
 // interface
-void asCContext::ClearExceptionCallback()
+void *asCCoroutine::GetUserData() const
 {
-	m_exceptionCallback = false;
+	return m_userData;
 }
 
-int asCContext::CallGeneric(int id, void *objectPointer)
+asCAsyncCall::asCAsyncCall(asCContext *ctx, asCScriptFunction *func)
 {
-	asCScriptFunction *sysFunction = m_engine->scriptFunctions[id];
-	asSSystemFunctionInterface *sysFunc = sysFunction->sysFuncIntf;
-	void (*func)(asIScriptGeneric*) = (void (*)(asIScriptGeneric*))sysFunc->func;
-	int popSize = sysFunc->paramSize;
-	asDWORD *args = m_regs.stackPointer;
+	m_refCount.set(1);
 
-	// Verify the object pointer if it is a class method
-	void *currentObject = 0;
-	if( sysFunc->callConv == ICC_GENERIC_METHOD )
-	{
-		if( objectPointer )
-		{
-			currentObject = objectPointer;
+	m_engine = ctx->m_engine;
 
-			// Don't increase the reference of this pointer
-			// since it will not have been constructed yet
-		}
-		else
-		{
-			// The object pointer should be popped from the context stack
-			popSize += AS_PTR_SIZE;
+	// The call keeps the context alive until the execution can continue
+	m_ctx = ctx;
+	m_ctx->AddRef();
+	m_holdsContextRef = true;
 
-			// Check for null pointer
-			currentObject = (void*)*(asPWORD*)(args);
-			if( currentObject == 0 )
-			{
-				SetInternalException(TXT_NULL_POINTER_ACCESS);
-				return 0;
-			}
+	m_function = func;
+	m_function->AddRef();
 
-			// Add the base offset for multiple inheritance
-			currentObject = (void*)(asPWORD(currentObject) + sysFunc->baseOffset);
+	m_userData       = 0;
+	m_isWaiting      = false;
+	m_isCompleted    = false;
+	m_isDiscarded    = false;
+	m_returnVal      = 0;
+	m_objectRegister = 0;
+	m_hasException   = false;
+}
 
-			// Skip object pointer
-			args += AS_PTR_SIZE;
-		}
+asCAsyncCall::~asCAsyncCall()
+{
+	ReleaseReturnObject();
+
+	m_function->Release();
+}
+
+// internal
+// Called by the context when the execution is suspended to wait for the call.
+// If the call was completed while the context was still executing then the
+// callback is invoked here instead, unless the application suspended the context
+void asCAsyncCall::Wait(bool notifyIfCompleted)
+{
+	bool notify = false;
+
+	ENTERCRITICALSECTION(m_lock);
+	if( m_isCompleted )
+	{
+		notify = notifyIfCompleted && m_holdsContextRef;
+		if( notify )
+			m_holdsContextRef = false;
 	}
+	else
+		m_isWaiting = true;
+	LEAVECRITICALSECTION(m_lock);
 
-	if( sysFunction->DoesReturnOnStack() )
+	if( notify )
 	{
-		// Skip the address where the return value will be stored
-		args += AS_PTR_SIZE;
-		popSize += AS_PTR_SIZE;
+		asCContext *ctx = m_ctx;
+		m_engine->CallAsyncCallCallback(ctx);
+		ctx->Release();
 	}
+}
 
-	asCGeneric gen(m_engine, sysFunction, currentObject, args);
+// internal
+// Returns true if the caller must release the reference to the context
+bool asCAsyncCall::Discard()
+{
+	ENTERCRITICALSECTION(m_lock);
+	m_isDiscarded = true;
+	m_isWaiting = false;
+	bool completed = m_isCompleted;
+	bool holdsContextRef = m_holdsContextRef;
+	m_holdsContextRef = false;
+	m_ctx = 0;
+	LEAVECRITICALSECTION(m_lock);
+
+	// If the call hasn't been completed yet the returned object will be released by Complete()
+	if( completed )
+		ReleaseReturnObject();
+
+	return holdsContextRef;
+}
 
-	m_callingSystemFunction = sysFunction;
-	func(&gen);
-	m_callingSystemFunction = 0;
+// internal
+// Called by the context when it resumes the execution after the call was completed.
+// Returns true if the caller must release the reference to the context
+bool asCAsyncCall::TakeContextRef()
+{
+	ENTERCRITICALSECTION(m_lock);
+	bool holdsContextRef = m_holdsContextRef;
+	m_holdsContextRef = false;
+	m_ctx = 0;
+	LEAVECRITICALSECTION(m_lock);
 
-	m_regs.valueRegister = gen.returnVal;
-	m_regs.objectRegister = gen.objectRegister;
-	m_regs.objectType = sysFunction->returnType.GetObjectType();
+	return holdsContextRef;
+}
+
+// internal
+void asCAsyncCall::ReleaseReturnObject()
+{
+	if( m_objectRegister )
+	{
+		m_engine->ReleaseScriptObject(m_objectRegister, m_function->returnType.GetObjectType());
+		m_objectRegister = 0;
+	}
+}
+
+// interface
+int asCAsyncCall::AddRef() const
+{
+	return m_refCount.atomicInc();
+}
 
-	// Clean up function parameters
-	int offset = 0;
-	for( asUINT n = 0; n < sysFunction->parameterTypes.GetLength(); n++ )
-	{
-		if( sysFunction->parameterTypes[n].IsObject() && !sysFunction->parameterTypes[n].IsReference() )
-		{
-			void *obj = *(void**)&args[offset];
-			if( obj )
-			{
-				// Release the object
-				asSTypeBehaviour *beh = &sysFunction->parameterTypes[n].GetObjectType()->beh;
-				if( sysFunction->parameterTypes[n].GetObjectType()->flags & asOBJ_REF )
-				{
-					asASSERT( (sysFunction->parameterTypes[n].GetObjectType()->flags & asOBJ_NOCOUNT) || beh->release );
-					if( beh->release )
-						m_engine->CallObjectMethod(obj, beh->release);
-				}
-				else
-				{
-					// Call the destructor then free the memory
-					if( beh->destruct )
-						m_engine->CallObjectMethod(obj, beh->destruct);
+// interface
+int asCAsyncCall::Release() const
+{
+	int r = m_refCount.atomicDec();
 
-					m_engine->CallFree(obj);
-				}
-			}
-		}
-		offset += sysFunction->parameterTypes[n].GetSizeOnStackDWords();
+	if( r == 0 )
+	{
+		asDELETE(const_cast<asCAsyncCall*>(this),asCAsyncCall);
+		return 0;
 	}
 
-	// Return how much should be popped from the stack
-	return popSize;
+	return r;
 }
 
 // interface
-int asCContext::GetVarCount(asUINT stackLevel)
+asIScriptContext *asCAsyncCall::GetContext() const
 {
-	asIScriptFunction *func = GetFunction(stackLevel);
-	if( func == 0 ) return asINVALID_ARG;
+	return m_ctx;
+}
 
-	return func->GetVarCount();
+// interface
+asIScriptFunction *asCAsyncCall::GetFunction() const
+{
+	return m_function;
 }
 
 // interface
-const char *asCContext::GetVarName(asUINT varIndex, asUINT stackLevel)
+bool asCAsyncCall::IsCompleted() const
 {
-	asIScriptFunction *func = GetFunction(stackLevel);
-	if( func == 0 ) return 0;
+	ENTERCRITICALSECTION(const_cast<asCAsyncCall*>(this)->m_lock);
+	bool completed = m_isCompleted;
+	LEAVECRITICALSECTION(const_cast<asCAsyncCall*>(this)->m_lock);
 
-	const char *name = 0;
-	int r = func->GetVar(varIndex, &name);
-	return r >= 0 ? name : 0;
+	return completed;
 }
 
 // interface
-const char *asCContext::GetVarDeclaration(asUINT varIndex, asUINT stackLevel)
+int asCAsyncCall::SetReturnByte(asBYTE val)
 {
-	asIScriptFunction *func = GetFunction(stackLevel);
-	if( func == 0 ) return 0;
+	if( m_isCompleted )
+		return asERROR;
 
-	return func->GetVarDecl(varIndex);
+	// Verify the type of the return value
+	if( m_function->returnType.IsObject() || m_function->returnType.IsReference() )
+		return asINVALID_TYPE;
+
+	if( m_function->returnType.GetSizeInMemoryBytes() != 1 )
+		return asINVALID_TYPE;
+
+	m_returnVal = 0;
+	*(asBYTE*)&m_returnVal = val;
+
+	return 0;
 }
 
 // interface
-int asCContext::GetVarTypeId(asUINT varIndex, asUINT stackLevel)
+int asCAsyncCall::SetReturnWord(asWORD val)
 {
-	asIScriptFunction *func = GetFunction(stackLevel);
-	if( func == 0 ) return asINVALID_ARG;
+	if( m_isCompleted )
+		return asERROR;
 
-	int typeId;
-	int r = func->GetVar(varIndex, 0, &typeId);
-	return r < 0 ? r : typeId;
+	// Verify the type of the return value
+	if( m_function->returnType.IsObject() || m_function->returnType.IsReference() )
+		return asINVALID_TYPE;
+
+	if( m_function->returnType.GetSizeInMemoryBytes() != 2 )
+		return asINVALID_TYPE;
+
+	m_returnVal = 0;
+	*(asWORD*)&m_returnVal = val;
+
+	return 0;
 }
 
 // interface
-void *asCContext::GetAddressOfVar(asUINT varIndex, asUINT stackLevel)
+int asCAsyncCall::SetReturnDWord(asDWORD val)
 {
-	// Don't return anything if there is no bytecode, e.g. before calling Execute()
-	if( m_regs.programPointer == 0 ) return 0;
+	if( m_isCompleted )
+		return asERROR;
 
-	if( stackLevel >= GetCallstackSize() ) return 0;
+	// Verify the type of the return value
+	if( m_function->returnType.IsObject() || m_function->returnType.IsReference() )
+		return asINVALID_TYPE;
 
-	asCScriptFunction *func;
-	asDWORD *sf;
-	if( stackLevel == 0 )
-	{
-		func = m_currentFunction;
-		sf = m_regs.stackFramePointer;
-	}
-	else
-	{
-		asPWORD *s = m_callStack.AddressOf() + (GetCallstackSize()-stackLevel-1)*CALLSTACK_FRAME_SIZE;
-		func = (asCScriptFunction*)s[1];
-		sf = (asDWORD*)s[0];
-	}
+	if( m_function->returnType.GetSizeInMemoryBytes() != 4 )
+		return asINVALID_TYPE;
 
-	if( func == 0 )
-		return 0;
+	m_returnVal = 0;
+	*(asDWORD*)&m_returnVal = val;
 
-	if( varIndex >= func->variables.GetLength() )
-		return 0;
+	return 0;
+}
 
-	// For object variables it's necessary to dereference the pointer to get the address of the value
-	// Reference parameters must also be dereferenced to give the address of the value
-	int pos = func->variables[varIndex]->stackOffset;
-	if( (func->variables[varIndex]->type.IsObject() && !func->variables[varIndex]->type.IsObjectHandle()) || (pos <= 0) )
-	{
-		// Determine if the object is really on the heap
-		bool onHeap = false;
-		if( func->variables[varIndex]->type.IsObject() &&
-			!func->variables[varIndex]->type.IsObjectHandle() )
-		{
-			onHeap = true;
-			if( func->variables[varIndex]->type.GetObjectType()->GetFlags() & asOBJ_VALUE )
-			{
-				for( asUINT n = 0; n < func->objVariablePos.GetLength(); n++ )
-				{
-					if( func->objVariablePos[n] == pos )
-					{
-						onHeap = n < func->objVariablesOnHeap;
+// interface
+int asCAsyncCall::SetReturnQWord(asQWORD val)
+{
+	if( m_isCompleted )
+		return asERROR;
 
-						if( !onHeap )
-						{
-							// If the object on the stack is not initialized return a null pointer instead
-							asCArray<int> liveObjects;
-							DetermineLiveObjects(liveObjects, stackLevel);
+	// Verify the type of the return value
+	if( m_function->returnType.IsObject() || m_function->returnType.IsReference() )
+		return asINVALID_TYPE;
 
-							if( liveObjects[n] <= 0 )
-								return 0;
-						}
+	if( m_function->returnType.GetSizeOnStackDWords() != 2 )
+		return asINVALID_TYPE;
 
-						break;
-					}
-				}
-			}
-		}
+	m_returnVal = val;
 
-		// If it wasn't an object on the heap, then check if it is a reference parameter
-		if( !onHeap && pos <= 0 )
-		{
-			// Determine what function argument this position matches
-			int stackPos = 0;
-			if( func->objectType )
-				stackPos -= AS_PTR_SIZE;
+	return 0;
+}
 
-			if( func->DoesReturnOnStack() )
-				stackPos -= AS_PTR_SIZE;
+// interface
+int asCAsyncCall::SetReturnFloat(float val)
+{
+	if( m_isCompleted )
+		return asERROR;
 
-			for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
-			{
-				if( stackPos == pos )
-				{
-					// The right argument was found. Is this a reference parameter?
-					if( func->inOutFlags[n] != asTM_NONE )
-						onHeap = true;
+	// Verify the type of the return value
+	if( m_function->returnType.IsObject() || m_function->returnType.IsReference() )
+		return asINVALID_TYPE;
 
-					break;
-				}
-				stackPos -= func->parameterTypes[n].GetSizeOnStackDWords();
-			}
-		}
+	if( m_function->returnType.GetSizeOnStackDWords() != 1 )
+		return asINVALID_TYPE;
 
-		if( onHeap )
-			return *(void**)(sf - func->variables[varIndex]->stackOffset);
-	}
+	m_returnVal = 0;
+	*(float*)&m_returnVal = val;
 
-	return sf - func->variables[varIndex]->stackOffset;
+	return 0;
 }
 
 // interface
-// returns the typeId of the 'this' object at the given call stack level (-1 for current)
-// returns 0 if the function call at the given stack level is not a method
-int asCContext::GetThisTypeId(asUINT stackLevel)
+int asCAsyncCall::SetReturnDouble(double val)
 {
-	asIScriptFunction *func = GetFunction(stackLevel);
-	if( func == 0 ) return asINVALID_ARG;
+	if( m_isCompleted )
+		return asERROR;
 
-	if( func->GetObjectType() == 0 )
-		return 0; // not in a method
+	// Verify the type of the return value
+	if( m_function->returnType.IsObject() || m_function->returnType.IsReference() )
+		return asINVALID_TYPE;
 
-	// create a datatype
-	asCDataType dt = asCDataType::CreateObject((asCObjectType*)func->GetObjectType(), false);
+	if( m_function->returnType.GetSizeOnStackDWords() != 2 )
+		return asINVALID_TYPE;
 
-	// return a typeId from the data type
-	return m_engine->GetTypeIdFromDataType(dt);
+	*(double*)&m_returnVal = val;
+
+	return 0;
 }
 
 // interface
-// returns the 'this' object pointer at the given call stack level (-1 for current)
-// returns 0 if the function call at the given stack level is not a method
-void *asCContext::GetThisPointer(asUINT stackLevel)
+int asCAsyncCall::SetReturnAddress(void *val)
 {
-	if( stackLevel >= GetCallstackSize() )
-		return 0;
+	if( m_isCompleted )
+		return asERROR;
 
-	asCScriptFunction *func;
-	asDWORD *sf;
-	if( stackLevel == 0 )
+	// Verify the type of the return value
+	if( m_function->returnType.IsReference() )
 	{
-		func = m_currentFunction;
-		sf = m_regs.stackFramePointer;
+		m_returnVal = 0;
+		*(void**)&m_returnVal = val;
+		return 0;
 	}
-	else
+	else if( m_function->returnType.IsObject() )
 	{
-		asPWORD *s = m_callStack.AddressOf() + (GetCallstackSize()-stackLevel-1)*CALLSTACK_FRAME_SIZE;
-		func = (asCScriptFunction*)s[1];
-		sf = (asDWORD*)s[0];
+		// Store the handle without increasing the reference
+		ReleaseReturnObject();
+		m_objectRegister = val;
+		return 0;
 	}
 
-	if( func == 0 )
-		return 0;
+	return asINVALID_TYPE;
+}
 
-	if( func->objectType == 0 )
-		return 0; // not in a method
+// interface
+int asCAsyncCall::SetReturnObject(void *obj)
+{
+	if( m_isCompleted )
+		return asERROR;
 
-	void *thisPointer = (void*)*(asPWORD*)(sf);
-	if( thisPointer == 0 )
+	asCDataType &dt = m_function->returnType;
+	if( !dt.IsObject() )
+		return asINVALID_TYPE;
+
+	if( dt.IsReference() )
 	{
+		m_returnVal = 0;
+		*(void**)&m_returnVal = obj;
 		return 0;
 	}
 
-	// NOTE: this returns the pointer to the 'this' while the GetVarPointer functions return
-	// a pointer to a pointer. I can't imagine someone would want to change the 'this'
-	return thisPointer;
+	// Increase the reference counter, as the context will own the returned handle
+	asSTypeBehaviour *beh = &dt.GetObjectType()->beh;
+	if( obj && beh->addref )
+		m_engine->CallObjectMethod(obj, beh->addref);
+
+	ReleaseReturnObject();
+	m_objectRegister = obj;
+
+	return 0;
 }
 
-END_AS_NAMESPACE
+// interface
+int asCAsyncCall::Complete()
+{
+	asCContext *ctx = 0;
+
+	ENTERCRITICALSECTION(m_lock);
+	if( m_isCompleted )
+	{
+		LEAVECRITICALSECTION(m_lock);
+		return asERROR;
+	}
+	m_isCompleted = true;
+	bool discarded = m_isDiscarded;
+	if( m_isWaiting )
+	{
+		// The reference to the context is handed over to the callback
+		m_isWaiting = false;
+		m_holdsContextRef = false;
+		ctx = m_ctx;
+	}
+	LEAVECRITICALSECTION(m_lock);
+
+	if( discarded )
+	{
+		// Nobody is waiting for the result anymore
+		ReleaseReturnObject();
+		return asCONTEXT_NOT_PREPARED;
+	}
+
+	if( ctx )
+	{
+		// Let the application schedule the context for execution
+		m_engine->CallAsyncCallCallback(ctx);
+		ctx->Release();
+	}
+
+	return asSUCCESS;
+}
+
+// interface
+int asCAsyncCall::CompleteWithException(const char *info)
+{
+	if( m_isCompleted )
+		return asERROR;
+
+	// The exception is raised in the script function that made the call when the execution resumes
+	ReleaseReturnObject();
+	m_hasException = true;
+	m_exceptionString = info ? info : "";
+
+	return Complete();
+}
 
+// interface
+void *asCAsyncCall::SetUserData(void *data)
+{
+	void *oldData = m_userData;
+	m_userData = data;
+	return oldData;
+}
 
+// interface
+void *asCAsyncCall::GetUserData() const
+{
+	return m_userData;
+}
 
+END_AS_NAMESPACE
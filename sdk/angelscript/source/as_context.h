@@ -45,11 +45,14 @@
 #include "as_string.h"
 #include "as_objecttype.h"
 #include "as_callfunc.h"
+#include "as_criticalsection.h"
 
 BEGIN_AS_NAMESPACE
 
 class asCScriptFunction;
 class asCScriptEngine;
+class asCCoroutine;
+class asCAsyncCall;
 
 class asCContext : public asIScriptContext
 {
@@ -76,6 +79,20 @@ public:
 	int             PopState();
 	bool            IsNested(asUINT *nestCount = 0) const;
 
+	// Co-routines
+	asIScriptCoroutine *CreateCoroutine(asIScriptFunction *func);
+	int                 ResumeCoroutine(asIScriptCoroutine *co);
+	int                 YieldCoroutine();
+	asIScriptCoroutine *GetCoroutine() const;
+
+	// Asynchronous calls
+	asIAsyncCall *BeginAsyncCall();
+	asIAsyncCall *GetAsyncCall() const;
+
+	// Saving and restoring a suspended execution
+	int SaveExecutionState(asIBinaryStream *out, asIContextSerializer *serializer);
+	int LoadExecutionState(asIBinaryStream *in, asIContextSerializer *serializer);
+
 	// Object pointer for calling class methods
 	int SetObject(void *obj);
 
@@ -154,11 +171,22 @@ public:
 	void PushCallState();
 	void PopCallState();
 	void CallScriptFunction(asCScriptFunction *func);
+	void TailCallScriptFunction(asCScriptFunction *func);
 	void CallInterfaceMethod(asCScriptFunction *func);
 	void PrepareScriptFunction();
 
 	bool ReserveStackSpace(asUINT size);
 
+	void SwapCoroutineState(asCCoroutine *co);
+	void SwitchToCoroutine(asCCoroutine *co);
+	void SwitchFromCoroutine(asEContextState coStatus);
+	bool ProcessCoroutineSwitch();
+	void DiscardCoroutine(asCCoroutine *co);
+	void CleanCallStack();
+
+	void ResumeAfterAsyncCall();
+	void DiscardAsyncCall();
+
 	void SetInternalException(const char *descr);
 
 	// Must be protected for multiple accesses
@@ -210,10 +238,155 @@ public:
 
 	void *m_userData;
 
+	// The co-routine currently executing in the context, or null if it is
+	// the main execution. A pending switch is done when the VM is suspended
+	asCCoroutine *m_coroutine;
+	asCCoroutine *m_coroutineList;
+	asCCoroutine *m_coroutineRequest;
+	bool          m_yieldRequest;
+	asUINT        m_nestedLevel;
+
+	// The asynchronous call that the context is waiting for, if any
+	asCAsyncCall *m_asyncCall;
+
 	// Registers available to JIT compiler functions
 	asSVMRegisters m_regs;
 };
 
+// A co-routine holds a suspended execution with its own call stack and stack memory.
+// It is executed by the context that created it, by exchanging its state with
+// the current state of the context whenever it is resumed or yields. The co-routine
+// doesn't hold a reference to the context, as the context may hold references to
+// the co-routine in its variables. Instead the context keeps a list of its co-routines
+// so it can discard them if it is destroyed first.
+class asCCoroutine : public asIScriptCoroutine
+{
+public:
+	// Memory management
+	int AddRef() const;
+	int Release() const;
+
+	// Miscellaneous
+	asIScriptContext  *GetContext() const;
+	asIScriptFunction *GetFunction() const;
+	asEContextState    GetState() const;
+
+	// Arguments
+	int   SetArgDWord(asUINT arg, asDWORD value);
+	int   SetArgQWord(asUINT arg, asQWORD value);
+	int   SetArgObject(asUINT arg, void *obj);
+	void *GetAddressOfArg(asUINT arg);
+
+	// User data
+	void *SetUserData(void *data);
+	void *GetUserData() const;
+
+public:
+	// Internal public functions
+	asCCoroutine(asCContext *ctx, asCScriptFunction *func);
+	virtual ~asCCoroutine();
+
+	bool Prepare();
+	void FreeStack();
+	void RemoveFromContext();
+	int  GetArgOffset(asUINT arg) const;
+
+	mutable asCAtomic m_refCount;
+
+	asCContext        *m_ctx;
+	asCCoroutine      *m_prevCoroutine;
+	asCCoroutine      *m_nextCoroutine;
+	asCScriptFunction *m_function;
+	asEContextState    m_status;
+	void              *m_userData;
+
+	// The co-routine that was executing when this one was resumed, and the nested
+	// level of the context at that time, so it is known where to return on yield
+	asCCoroutine      *m_resumer;
+	asUINT             m_resumeLevel;
+
+	// The execution state that is exchanged with the context
+	asCArray<size_t>    m_callStack;
+	asCArray<asDWORD *> m_stackBlocks;
+	asUINT              m_stackBlockSize;
+	asUINT              m_stackIndex;
+	asCScriptFunction  *m_currentFunction;
+	asDWORD            *m_programPointer;
+	asDWORD            *m_stackFramePointer;
+	asDWORD            *m_stackPointer;
+	asQWORD             m_valueRegister;
+	void               *m_objectRegister;
+	asIObjectType      *m_objectType;
+};
+
+// An asynchronous call is started by a registered function that cannot give the result
+// immediately. The context is suspended when the function returns, and waits for the
+// application to complete the call, possibly from another thread. The call holds a
+// reference to the context while it is waiting so the application doesn't have to keep
+// track of it. On completion the reference is handed over to the engine's callback
+// so the application can schedule the context to resume the execution.
+class asCAsyncCall : public asIAsyncCall
+{
+public:
+	// Memory management
+	int AddRef() const;
+	int Release() const;
+
+	// Miscellaneous
+	asIScriptContext  *GetContext() const;
+	asIScriptFunction *GetFunction() const;
+	bool               IsCompleted() const;
+
+	// Return value
+	int SetReturnByte(asBYTE val);
+	int SetReturnWord(asWORD val);
+	int SetReturnDWord(asDWORD val);
+	int SetReturnQWord(asQWORD val);
+	int SetReturnFloat(float val);
+	int SetReturnDouble(double val);
+	int SetReturnAddress(void *addr);
+	int SetReturnObject(void *obj);
+
+	// Completion
+	int Complete();
+	int CompleteWithException(const char *info);
+
+	// User data
+	void *SetUserData(void *data);
+	void *GetUserData() const;
+
+public:
+	// Internal public functions
+	asCAsyncCall(asCContext *ctx, asCScriptFunction *func);
+	virtual ~asCAsyncCall();
+
+	void Wait(bool notifyIfCompleted);
+	bool Discard();
+	bool TakeContextRef();
+	void ReleaseReturnObject();
+
+	mutable asCAtomic m_refCount;
+
+	asCScriptEngine   *m_engine;
+	asCContext        *m_ctx;
+	asCScriptFunction *m_function;
+	void              *m_userData;
+
+	// The state is shared between the thread that executes the
+	// context and the thread that completes the call
+	DECLARECRITICALSECTION(m_lock)
+	bool               m_holdsContextRef;
+	bool               m_isWaiting;
+	bool               m_isCompleted;
+	bool               m_isDiscarded;
+
+	// The result that is given to the script when the execution resumes
+	asQWORD            m_returnVal;
+	void              *m_objectRegister;
+	bool               m_hasException;
+	asCString          m_exceptionString;
+};
+
 END_AS_NAMESPACE
 
 #endif
@@ -310,6 +310,13 @@ void *asCGeneric::GetAddressOfArg(asUINT arg)
 	return &stackPointer[offset];
 }
 
+// interface
+void *asCGeneric::GetAddressOfArgs()
+{
+	// The arguments are stored consecutively, in the same layout as on the script stack
+	return stackPointer;
+}
+
 // interface
 int asCGeneric::GetArgTypeId(asUINT arg) const
 {
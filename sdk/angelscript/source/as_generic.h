@@ -77,6 +77,7 @@ public:
 	void   *GetArgAddress(asUINT arg);
 	void   *GetArgObject(asUINT arg);
 	void   *GetAddressOfArg(asUINT arg);
+	void   *GetAddressOfArgs();
 
 	// Return value
 	int     GetReturnTypeId() const;
@@ -53,6 +53,8 @@ asCModule::asCModule(const char *name, asCScriptEngine *engine)
 
 	userData = 0;
 	builder = 0;
+	lazyReader = 0;
+	buildId = engine->moduleBuildCounter.atomicInc();
 	isGlobalVarInitialized = false;
 
 	accessMask = 1;
@@ -188,6 +190,31 @@ void asCModule::JITCompile()
 	}
 }
 
+// internal
+int asCModule::LoadFunctionBody(asCScriptFunction *func)
+{
+	if( lazyReader == 0 || func->module != this )
+		return asERROR;
+
+	return lazyReader->LoadFunctionBody(func);
+}
+
+// internal
+int asCModule::LoadAllFunctionBodies()
+{
+	if( lazyReader == 0 )
+		return asSUCCESS;
+
+	for( asUINT n = 0; n < scriptFunctions.GetLength(); n++ )
+	{
+		if( scriptFunctions[n]->isBodyPending &&
+			LoadFunctionBody(scriptFunctions[n]) < 0 )
+			return asERROR;
+	}
+
+	return asSUCCESS;
+}
+
 // interface
 int asCModule::Build()
 {
@@ -256,6 +283,12 @@ int asCModule::Build()
 #endif
 }
 
+// interface
+asUINT asCModule::GetBuildId() const
+{
+	return buildId;
+}
+
 // interface
 int asCModule::ResetGlobalVars(asIScriptContext *ctx)
 {
@@ -410,8 +443,20 @@ void asCModule::InternalReset()
 {
 	CallExit();
 
+	// The content of the module is replaced, so it gets a new id that
+	// can't be confused with that of any other module in the engine
+	buildId = engine->moduleBuildCounter.atomicInc();
+
 	size_t n;
 
+	// Functions whose bodies haven't been loaded yet can no longer be 
+	// executed, as the information needed to load them is discarded
+	if( lazyReader )
+	{
+		asDELETE(lazyReader, asCReader);
+		lazyReader = 0;
+	}
+
 	// Release all global functions
 	asCSymbolTable<asCScriptFunction>::iterator funcIt = globalFunctions.List();
 	for( ; funcIt; funcIt++ )
@@ -1178,6 +1223,10 @@ int asCModule::SaveByteCode(asIBinaryStream *out, bool stripDebugInfo) const
 #else
 	if( out == 0 ) return asINVALID_ARG;
 
+	// Load the bodies of the functions that haven't been called yet
+	if( const_cast<asCModule*>(this)->LoadAllFunctionBodies() < 0 )
+		return asERROR;
+
 	asCWriter write(const_cast<asCModule*>(this), out, engine, stripDebugInfo);
 	return write.Write();
 #endif
@@ -1194,8 +1243,20 @@ int asCModule::LoadByteCode(asIBinaryStream *in, bool *wasDebugInfoStripped)
 	if( r < 0 )
 		return r;
 
-	asCReader read(this, in, engine);
-	r = read.Read(wasDebugInfoStripped);
+	asCReader *read = asNEW(asCReader)(this, in, engine);
+	if( read == 0 )
+	{
+		engine->BuildCompleted();
+		return asOUT_OF_MEMORY;
+	}
+
+	r = read->Read(wasDebugInfoStripped);
+
+	// Keep the reader if there are function bodies that will be loaded on demand
+	if( r >= 0 && read->HasPendingBodies() )
+		lazyReader = read;
+	else
+		asDELETE(read, asCReader);
 
     JITCompile();
 
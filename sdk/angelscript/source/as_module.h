@@ -58,6 +58,7 @@ class asCCompiler;
 class asCBuilder;
 class asCContext;
 class asCConfigGroup;
+class asCReader;
 struct asSNameSpace;
 
 struct sBindInfo
@@ -104,6 +105,7 @@ public:
 	// Compilation
 	virtual int         AddScriptSection(const char *name, const char *code, size_t codeLength, int lineOffset);
 	virtual int         Build();
+	virtual asUINT      GetBuildId() const;
 	virtual int         CompileFunction(const char *sectionName, const char *code, int lineOffset, asDWORD reserved, asIScriptFunction **outFunc);
 	virtual int         CompileGlobalVar(const char *sectionName, const char *code, int lineOffset);
 	virtual asDWORD     SetAccessMask(asDWORD accessMask);
@@ -192,6 +194,9 @@ public:
 
 	void JITCompile();
 
+	int  LoadFunctionBody(asCScriptFunction *func);
+	int  LoadAllFunctionBodies();
+
 #ifndef AS_NO_COMPILER
 	int  AddScriptFunction(int sectionIdx, int id, const asCString &name, const asCDataType &returnType, const asCArray<asCDataType> &params, const asCArray<asETypeModifiers> &inOutFlags, const asCArray<asCString *> &defaultArgs, bool isInterface, asCObjectType *objType = 0, bool isConstMethod = false, bool isGlobalFunction = false, bool isPrivate = false, bool isFinal = false, bool isOverride = false, bool isShared = false, asSNameSpace *ns = 0);
 	int  AddScriptFunction(asCScriptFunction *func);
@@ -205,6 +210,7 @@ public:
 	asCGlobalProperty *AllocateGlobalProperty(const char *name, const asCDataType &dt, asSNameSpace *ns);
 
 	asCString name;
+	asUINT    buildId;
 
 	asCScriptEngine *engine;
 	asCBuilder      *builder;
@@ -231,6 +237,9 @@ public:
 	asCArray<asCObjectType*>       typeDefs;
 	// This array holds the funcdefs declared in the module
 	asCArray<asCScriptFunction*>   funcDefs;
+
+	// Holds the function bodies that haven't been loaded yet, see asEP_LAZY_LOAD_FUNCTIONS
+	asCReader                     *lazyReader;
 };
 
 END_AS_NAMESPACE
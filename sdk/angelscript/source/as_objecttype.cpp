@@ -130,6 +130,7 @@ asCObjectType::asCObjectType()
 
 	acceptValueSubType = true;
 	acceptRefSubType = true;
+	returnsSubTypeByValue = false;
 
 	accessMask = 0xFFFFFFFF;
 	nameSpace = 0;
@@ -144,6 +145,7 @@ asCObjectType::asCObjectType(asCScriptEngine *engine)
 
 	acceptValueSubType = true;
 	acceptRefSubType = true;
+	returnsSubTypeByValue = false;
 
 	accessMask = 0xFFFFFFFF;
 	nameSpace = engine->nameSpaces[0];
@@ -618,30 +620,52 @@ asIScriptFunction *asCObjectType::GetMethodByDecl(const char *decl, bool getVirt
 	return engine->scriptFunctions[id];
 }
 
+// internal
+// The properties that alias the fields of registered accessors are only
+// used by the compiler, so they are not exposed to the application
+asCObjectProperty *asCObjectType::GetReflectedProperty(asUINT index) const
+{
+	for( asUINT n = 0; n < properties.GetLength(); n++ )
+	{
+		if( properties[n]->isFieldAlias )
+			continue;
+		if( index-- == 0 )
+			return properties[n];
+	}
+
+	return 0;
+}
+
 // interface
 asUINT asCObjectType::GetPropertyCount() const
 {
-	return (asUINT)properties.GetLength();
+	asUINT count = 0;
+	for( asUINT n = 0; n < properties.GetLength(); n++ )
+		if( !properties[n]->isFieldAlias )
+			count++;
+
+	return count;
 }
 
 // interface
 int asCObjectType::GetProperty(asUINT index, const char **name, int *typeId, bool *isPrivate, int *offset, bool *isReference, asDWORD *accessMask) const
 {
-	if( index >= properties.GetLength() )
+	asCObjectProperty *prop = GetReflectedProperty(index);
+	if( prop == 0 )
 		return asINVALID_ARG;
 
 	if( name )
-		*name = properties[index]->name.AddressOf();
+		*name = prop->name.AddressOf();
 	if( typeId )
-		*typeId = engine->GetTypeIdFromDataType(properties[index]->type);
+		*typeId = engine->GetTypeIdFromDataType(prop->type);
 	if( isPrivate )
-		*isPrivate = properties[index]->isPrivate;
+		*isPrivate = prop->isPrivate;
 	if( offset )
-		*offset = properties[index]->byteOffset;
+		*offset = prop->byteOffset;
 	if( isReference )
-		*isReference = properties[index]->type.IsReference();
+		*isReference = prop->type.IsReference();
 	if( accessMask )
-		*accessMask = properties[index]->accessMask;
+		*accessMask = prop->accessMask;
 
 	return 0;
 }
@@ -649,17 +673,18 @@ int asCObjectType::GetProperty(asUINT index, const char **name, int *typeId, boo
 // interface
 const char *asCObjectType::GetPropertyDeclaration(asUINT index) const
 {
-	if( index >= properties.GetLength() )
+	asCObjectProperty *prop = GetReflectedProperty(index);
+	if( prop == 0 )
 		return 0;
 
 	asCString *tempString = &asCThreadManager::GetLocalData()->string;
-	if( properties[index]->isPrivate )
+	if( prop->isPrivate )
 		*tempString = "private ";
 	else
 		*tempString = "";
-	*tempString += properties[index]->type.Format();
+	*tempString += prop->type.Format();
 	*tempString += " ";
-	*tempString += properties[index]->name;
+	*tempString += prop->name;
 
 	return tempString->AddressOf();
 }
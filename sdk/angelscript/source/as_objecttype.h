@@ -215,6 +215,7 @@ public:
 
 	asCObjectProperty *AddPropertyToClass(const asCString &name, const asCDataType &dt, bool isPrivate);
 	void ReleaseAllProperties();
+	asCObjectProperty *GetReflectedProperty(asUINT index) const;
 
 	asCString                    name;
 	asSNameSpace                *nameSpace;
@@ -235,6 +236,7 @@ public:
 	asCArray<asCDataType> templateSubTypes;
 	bool                  acceptValueSubType;
 	bool                  acceptRefSubType;
+	bool                  returnsSubTypeByValue;
 
 	asCScriptEngine  *engine;
 	asCModule        *module;
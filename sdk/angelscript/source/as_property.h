@@ -53,12 +53,13 @@ struct asSNameSpace;
 class asCObjectProperty
 {
 public:
-	asCObjectProperty() {accessMask = 0xFFFFFFFF;}
+	asCObjectProperty() {accessMask = 0xFFFFFFFF; isFieldAlias = false;}
 	asCString   name;
 	asCDataType type;
 	int         byteOffset;
 	bool		isPrivate;
 	asDWORD     accessMask;
+	bool        isFieldAlias;
 };
 
 class asCGlobalProperty
@@ -43,10 +43,373 @@
 
 BEGIN_AS_NAMESPACE
 
+asCMemoryStream::asCMemoryStream()
+{
+	readPos     = 0;
+	readPastEnd = false;
+}
+
+void asCMemoryStream::Write(const void *ptr, asUINT size)
+{
+	if( size == 0 ) return;
+
+	// Grow the buffer exponentially to avoid copying the data for each write
+	asUINT length = (asUINT)buffer.GetLength();
+	if( buffer.GetCapacity() < length + size )
+		buffer.AllocateNoConstruct(2*(length + size), true);
+	buffer.SetLengthNoConstruct(length + size);
+	memcpy(buffer.AddressOf() + length, ptr, size);
+}
+
+void asCMemoryStream::Read(void *ptr, asUINT size)
+{
+	if( size == 0 ) return;
+
+	if( readPos + size > buffer.GetLength() )
+	{
+		// Return zeroes, the reader will detect the error afterwards
+		memset(ptr, 0, size);
+		readPastEnd = true;
+		return;
+	}
+
+	memcpy(ptr, buffer.AddressOf() + readPos, size);
+	readPos += size;
+}
+
+// The compressed blocks hold at most 64KB so the match offsets fit in 16 bits
+static const asUINT COMPRESS_BLOCK_SIZE = 0x10000;
+static const asUINT COMPRESS_HASH_BITS  = 13;
+static const asUINT COMPRESS_MIN_MATCH  = 4;
+
+static void WriteBlockDWord(asIBinaryStream *out, asDWORD v)
+{
+	asBYTE b[4] = {asBYTE(v), asBYTE(v >> 8), asBYTE(v >> 16), asBYTE(v >> 24)};
+	out->Write(b, 4);
+}
+
+static asDWORD ReadBlockDWord(asIBinaryStream *in)
+{
+	asBYTE b[4];
+	in->Read(b, 4);
+	return asDWORD(b[0]) | (asDWORD(b[1]) << 8) | (asDWORD(b[2]) << 16) | (asDWORD(b[3]) << 24);
+}
+
+// Adler-32 is used to detect corrupt blocks
+static asDWORD BlockChecksum(const asBYTE *data, asUINT length)
+{
+	asDWORD a = 1, b = 0;
+	while( length )
+	{
+		// This is the largest count that can be summed before b overflows
+		asUINT n = length < 5552 ? length : 5552;
+		length -= n;
+		while( n-- )
+		{
+			a += *data++;
+			b += a;
+		}
+		a %= 65521;
+		b %= 65521;
+	}
+	return (b << 16) | a;
+}
+
+static void WriteLengthExtension(asCArray<asBYTE> &dst, asUINT length)
+{
+	while( length >= 255 )
+	{
+		dst.PushLast(255);
+		length -= 255;
+	}
+	dst.PushLast(asBYTE(length));
+}
+
+// Each sequence is a token with the number of literals in the high nibble and
+// the match length in the low nibble, followed by the literals and the 16 bit 
+// match offset. Lengths that don't fit in the nibbles continue in extra bytes.
+// The last sequence of a block only has literals.
+static void EmitSequence(asCArray<asBYTE> &dst, const asBYTE *literals, asUINT numLiterals, asUINT offset, asUINT matchLength)
+{
+	asBYTE token = asBYTE((numLiterals < 15 ? numLiterals : 15) << 4);
+	if( matchLength )
+	{
+		asUINT m = matchLength - COMPRESS_MIN_MATCH;
+		token |= asBYTE(m < 15 ? m : 15);
+	}
+	dst.PushLast(token);
+
+	if( numLiterals >= 15 )
+		WriteLengthExtension(dst, numLiterals - 15);
+	if( numLiterals )
+	{
+		asUINT pos = dst.GetLength();
+		dst.SetLengthNoConstruct(pos + numLiterals);
+		memcpy(dst.AddressOf() + pos, literals, numLiterals);
+	}
+
+	if( matchLength )
+	{
+		dst.PushLast(asBYTE(offset));
+		dst.PushLast(asBYTE(offset >> 8));
+		if( matchLength - COMPRESS_MIN_MATCH >= 15 )
+			WriteLengthExtension(dst, matchLength - COMPRESS_MIN_MATCH - 15);
+	}
+}
+
+asCCompressStream::asCCompressStream(asIBinaryStream *_out) : out(_out)
+{
+	block.AllocateNoConstruct(COMPRESS_BLOCK_SIZE, false);
+}
+
+void asCCompressStream::Write(const void *ptr, asUINT size)
+{
+	const asBYTE *data = (const asBYTE*)ptr;
+	while( size )
+	{
+		asUINT length = (asUINT)block.GetLength();
+		if( block.GetCapacity() < COMPRESS_BLOCK_SIZE )
+			block.AllocateNoConstruct(COMPRESS_BLOCK_SIZE, true);
+
+		asUINT n = COMPRESS_BLOCK_SIZE - length;
+		if( n > size ) n = size;
+		block.SetLengthNoConstruct(length + n);
+		memcpy(block.AddressOf() + length, data, n);
+		data += n;
+		size -= n;
+
+		if( block.GetLength() == COMPRESS_BLOCK_SIZE )
+			CompressBlock();
+	}
+}
+
+void asCCompressStream::Read(void *, asUINT)
+{
+	asASSERT( false );
+}
+
+void asCCompressStream::Flush()
+{
+	if( block.GetLength() )
+		CompressBlock();
+}
+
+void asCCompressStream::CompressBlock()
+{
+	const asBYTE *src = block.AddressOf();
+	asUINT length = (asUINT)block.GetLength();
+
+	// The hash table holds the last position where each 4 byte sequence was seen
+	asCArray<asUINT> table;
+	table.SetLengthNoConstruct(1 << COMPRESS_HASH_BITS);
+	memset(table.AddressOf(), 0xFF, sizeof(asUINT) << COMPRESS_HASH_BITS);
+
+	compressed.SetLength(0);
+	compressed.AllocateNoConstruct(length + length/255 + 16, false);
+
+	asUINT anchor = 0;
+	asUINT pos = 0;
+	while( pos + COMPRESS_MIN_MATCH <= length )
+	{
+		asDWORD seq;
+		memcpy(&seq, src + pos, 4);
+		asUINT hash = (seq * 2654435761u) >> (32 - COMPRESS_HASH_BITS);
+		asUINT candidate = table[hash];
+		table[hash] = pos;
+
+		bool found = false;
+		if( candidate != asUINT(-1) )
+		{
+			asDWORD prev;
+			memcpy(&prev, src + candidate, 4);
+			found = (prev == seq);
+		}
+
+		if( found )
+		{
+			asUINT matchLength = COMPRESS_MIN_MATCH;
+			while( pos + matchLength < length && src[candidate + matchLength] == src[pos + matchLength] )
+				matchLength++;
+
+			EmitSequence(compressed, src + anchor, pos - anchor, pos - candidate, matchLength);
+			pos += matchLength;
+			anchor = pos;
+		}
+		else
+			pos++;
+	}
+	EmitSequence(compressed, src + anchor, length - anchor, 0, 0);
+
+	// Store the block uncompressed if it didn't get any smaller
+	bool isCompressed = compressed.GetLength() < length;
+	WriteBlockDWord(out, length);
+	WriteBlockDWord(out, isCompressed ? (asDWORD)compressed.GetLength() : length);
+	WriteBlockDWord(out, BlockChecksum(src, length));
+	if( isCompressed )
+		out->Write(compressed.AddressOf(), (asUINT)compressed.GetLength());
+	else
+		out->Write(src, length);
+
+	block.SetLength(0);
+}
+
+asCDecompressStream::asCDecompressStream(asIBinaryStream *_in) : in(_in)
+{
+	failed  = false;
+	readPos = 0;
+}
+
+void asCDecompressStream::Write(const void *, asUINT)
+{
+	asASSERT( false );
+}
+
+void asCDecompressStream::Read(void *ptr, asUINT size)
+{
+	asBYTE *data = (asBYTE*)ptr;
+	while( size )
+	{
+		if( !failed && readPos == block.GetLength() && !DecompressBlock() )
+		{
+			// Don't let the reader see any part of the corrupt block
+			failed = true;
+			block.SetLengthNoConstruct(0);
+			readPos = 0;
+		}
+
+		if( failed )
+		{
+			// Return zeroes, the reader will report the error afterwards
+			memset(data, 0, size);
+			return;
+		}
+
+		asUINT n = (asUINT)block.GetLength() - readPos;
+		if( n > size ) n = size;
+		memcpy(data, block.AddressOf() + readPos, n);
+		readPos += n;
+		data += n;
+		size -= n;
+	}
+}
+
+bool asCDecompressStream::DecompressBlock()
+{
+	asUINT length   = ReadBlockDWord(in);
+	asUINT stored   = ReadBlockDWord(in);
+	asDWORD checksum = ReadBlockDWord(in);
+	if( length == 0 || length > COMPRESS_BLOCK_SIZE || stored > length )
+		return false;
+
+	readPos = 0;
+	block.SetLengthNoConstruct(0);
+	block.AllocateNoConstruct(length, false);
+	block.SetLengthNoConstruct(length);
+	asBYTE *dst = block.AddressOf();
+
+	if( stored == length )
+		in->Read(dst, length);
+	else
+	{
+		compressed.SetLengthNoConstruct(0);
+		compressed.AllocateNoConstruct(stored, false);
+		compressed.SetLengthNoConstruct(stored);
+		in->Read(compressed.AddressOf(), stored);
+
+		const asBYTE *src = compressed.AddressOf();
+		const asBYTE *srcEnd = src + stored;
+		asUINT pos = 0;
+		while( src < srcEnd )
+		{
+			asBYTE token = *src++;
+
+			// Copy the literals
+			asUINT numLiterals = token >> 4;
+			if( numLiterals == 15 )
+			{
+				asBYTE b;
+				do 
+				{
+					if( src >= srcEnd ) return false;
+					b = *src++;
+					numLiterals += b;
+				} while( b == 255 );
+			}
+			if( numLiterals > asUINT(srcEnd - src) || numLiterals > length - pos )
+				return false;
+			memcpy(dst + pos, src, numLiterals);
+			src += numLiterals;
+			pos += numLiterals;
+
+			// The last sequence doesn't have a match
+			if( src == srcEnd )
+				break;
+
+			if( srcEnd - src < 2 ) return false;
+			asUINT offset = asUINT(src[0]) | (asUINT(src[1]) << 8);
+			src += 2;
+
+			asUINT matchLength = (token & 15) + COMPRESS_MIN_MATCH;
+			if( (token & 15) == 15 )
+			{
+				asBYTE b;
+				do 
+				{
+					if( src >= srcEnd ) return false;
+					b = *src++;
+					matchLength += b;
+				} while( b == 255 );
+			}
+			if( offset == 0 || offset > pos || matchLength > length - pos )
+				return false;
+
+			// The match may overlap the bytes being written, so copy byte by byte
+			const asBYTE *match = dst + pos - offset;
+			for( asUINT n = 0; n < matchLength; n++ )
+				dst[pos + n] = match[n];
+			pos += matchLength;
+		}
+
+		if( pos != length )
+			return false;
+	}
+
+	return BlockChecksum(dst, length) == checksum;
+}
+
+// The shared functions are only stored with the first module in a bundle
+// that uses them. The modules that follow just refer to the loaded function
+static bool IsBundleSharedFunction(asCScriptFunction *func)
+{
+	return (func->funcType == asFUNC_SCRIPT ||
+	        func->funcType == asFUNC_VIRTUAL ||
+	        func->funcType == asFUNC_INTERFACE) && func->IsShared();
+}
+
 asCReader::asCReader(asCModule* _module, asIBinaryStream* _stream, asCScriptEngine* _engine)
- : module(_module), stream(_stream), engine(_engine)
+ : module(_module), stream(_stream), engine(_engine), decompressor(_stream)
 {
 	error = false;
+	noDebugInfo = false;
+	sizedBodies = false;
+	isBundle = false;
+	inFunctionBody = false;
+	holdsUsedReferences = false;
+}
+
+asCReader::~asCReader()
+{
+	// Release the references held on behalf of the functions that were never called
+	if( holdsUsedReferences )
+	{
+		asUINT n;
+		for( n = 0; n < usedTypes.GetLength(); n++ )
+			if( usedTypes[n] )
+				usedTypes[n]->Release();
+		for( n = 0; n < usedFunctions.GetLength(); n++ )
+			if( usedFunctions[n] )
+				usedFunctions[n]->Release();
+	}
 }
 
 void asCReader::ReadData(void *data, asUINT size)
@@ -67,8 +430,90 @@ int asCReader::Read(bool *wasDebugInfoStripped)
 	// any existing resources have been freed
 	module->InternalReset();
 
+	int r = ReadFlags(false);
+	if( r >= 0 )
+		r = ReadModule();
+
+	if( r >= 0 && wasDebugInfoStripped )
+		*wasDebugInfoStripped = noDebugInfo;
+
+	return r;
+}
+
+int asCReader::ReadBundle(bool *wasDebugInfoStripped)
+{
+	int r = ReadFlags(true);
+	if( r < 0 )
+		return r;
+
+	asUINT count = ReadEncodedUInt();
+	for( asUINT n = 0; n < count && r >= 0; n++ )
+	{
+		asCString name;
+		ReadString(&name);
+		module = static_cast<asCModule*>(engine->GetModule(name.AddressOf(), asGM_ALWAYS_CREATE));
+		if( module == 0 )
+			return asOUT_OF_MEMORY;
+
+		r = ReadModule();
+		if( r < 0 )
+			break;
+
+		module->JITCompile();
+
+		// The shared functions can now be referred to by the modules that follow
+		for( asUINT i = 0; i < bundleSharedSlots.GetLength(); i++ )
+			bundleSharedFunctions.PushLast(savedFunctions[bundleSharedSlots[i]]);
+		bundleSharedSlots.SetLength(0);
+
+		// The functions are only referred to within the module
+		savedFunctions.SetLength(0);
+		existingShared.EraseAll();
+		dontTranslate.EraseAll();
+	}
+
+	if( r >= 0 && decompressor.failed )
+	{
+		engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, TXT_COMPRESSED_BYTECODE_CORRUPT);
+		r = asERROR;
+	}
+
+	if( r >= 0 && wasDebugInfoStripped )
+		*wasDebugInfoStripped = noDebugInfo;
+
+	return r;
+}
+
+int asCReader::ReadFlags(bool bundle)
+{
+	asBYTE flags;
+	ReadData(&flags, 1);
+	noDebugInfo = (flags & BCF_NO_DEBUG_INFO) ? true : false;
+	sizedBodies = (flags & BCF_SIZED_BODIES) ? true : false;
+	isBundle    = (flags & BCF_BUNDLE) ? true : false;
+
+	if( isBundle != bundle )
+	{
+		engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, isBundle ? TXT_BYTECODE_IS_BUNDLE : TXT_BYTECODE_NOT_BUNDLE);
+		return asERROR;
+	}
+
+	// Everything after the flags is compressed
+	if( flags & BCF_COMPRESSED )
+		stream = &decompressor;
+
+	return asSUCCESS;
+}
+
+int asCReader::ReadModule()
+{
 	// Call the inner method to do the actual loading
 	int r = ReadInner();
+	if( decompressor.failed )
+	{
+		engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, TXT_COMPRESSED_BYTECODE_CORRUPT);
+		r = asERROR;
+	}
 	if( r < 0 )
 	{
 		// Something went wrong while loading the bytecode, so we need
@@ -96,9 +541,6 @@ int asCReader::Read(bool *wasDebugInfoStripped)
 		// Initialize the global variables (unless requested not to)
 		if( engine->ep.initGlobalVarsAfterBuild )
 			r = module->ResetGlobalVars(0);
-
-		if( wasDebugInfoStripped )
-			*wasDebugInfoStripped = noDebugInfo;
 	}
 
 	return r;
@@ -115,8 +557,6 @@ int asCReader::ReadInner()
 	unsigned long i, count;
 	asCScriptFunction* func;
 
-	ReadData(&noDebugInfo, 1);
-
 	// Read enums
 	count = ReadEncodedUInt();
 	module->enumTypes.Allocate(count, 0);
@@ -320,7 +760,7 @@ int asCReader::ReadInner()
 		}
 		
 		// Is the function shared and was it created now?
-		if( func->isShared && len != module->scriptFunctions.GetLength() )
+		if( func->isShared && isNew && len != module->scriptFunctions.GetLength() )
 		{
 			// If the function already existed in another module, then
 			// we need to replace it with previously existing one
@@ -404,8 +844,10 @@ int asCReader::ReadInner()
 	if( error ) return asERROR;
 
 	// usedTypes[]
+	// In a bundle the tables are shared, so each module only adds to them
+	asUINT firstUsedType = (asUINT)usedTypes.GetLength();
 	count = ReadEncodedUInt();
-	usedTypes.Allocate(count, 0);
+	usedTypes.Allocate(firstUsedType + count, true);
 	for( i = 0; i < count && !error; ++i )
 	{
 		asCObjectType *ot = ReadObjectType();
@@ -435,7 +877,7 @@ int asCReader::ReadInner()
 	// Validate the template types
 	if( !error )
 	{
-		for( i = 0; i < usedTypes.GetLength() && !error; i++ )
+		for( i = firstUsedType; i < usedTypes.GetLength() && !error; i++ )
 		{
 			if( !(usedTypes[i]->flags & asOBJ_TEMPLATE) || 
 				!usedTypes[i]->beh.templateCallback )
@@ -465,7 +907,8 @@ int asCReader::ReadInner()
 	// Update the loaded bytecode to point to the correct types, property offsets,
 	// function ids, etc. This is basically a linking stage.
 	for( i = 0; i < module->scriptFunctions.GetLength() && !error; i++ )
-		if( module->scriptFunctions[i]->funcType == asFUNC_SCRIPT )
+		if( module->scriptFunctions[i]->funcType == asFUNC_SCRIPT &&
+			!module->scriptFunctions[i]->isBodyPending )
 			TranslateFunction(module->scriptFunctions[i]);
 
 	asCSymbolTable<asCGlobalProperty>::iterator globIt = module->scriptGlobals.List();
@@ -492,16 +935,81 @@ int asCReader::ReadInner()
 			initFunc->AddReferences();
 		globIt++;
 	}
+
+	// The types and functions used by the pending function bodies 
+	// must be kept alive until the bodies have been loaded
+	if( !error && pendingBodyOffsets.GetCount() )
+	{
+		for( i = 0; i < usedTypes.GetLength(); i++ )
+			if( usedTypes[i] )
+				usedTypes[i]->AddRef();
+		for( i = 0; i < usedFunctions.GetLength(); i++ )
+			if( usedFunctions[i] )
+				usedFunctions[i]->AddRef();
+		holdsUsedReferences = true;
+	}
+
 	return error ? asERROR : asSUCCESS;
 }
 
+bool asCReader::HasPendingBodies() const
+{
+	return pendingBodyOffsets.GetCount() > 0;
+}
+
+int asCReader::LoadFunctionBody(asCScriptFunction *func)
+{
+	int r = asSUCCESS;
+
+	ENTERCRITICALSECTION(pendingCritical);
+
+	// Another thread may have loaded the function while this one was waiting
+	if( func->isBodyPending )
+	{
+		asSMapNode<asCScriptFunction*, asUINT> *cursor = 0;
+		if( pendingBodyOffsets.MoveTo(&cursor, func) )
+		{
+			pendingBodies.readPos     = pendingBodyOffsets.GetValue(cursor);
+			pendingBodies.readPastEnd = false;
+			pendingBodyOffsets.Erase(cursor);
+
+			stream = &pendingBodies;
+			error  = false;
+			ReadFunctionBody(func);
+			if( !error && !pendingBodies.readPastEnd )
+				TranslateFunction(func);
+
+			if( error || pendingBodies.readPastEnd )
+			{
+				// Leave the function without bytecode, so it will not be executed
+				func->byteCode.SetLength(0);
+				r = asERROR;
+			}
+			else
+			{
+				func->AddReferences();
+				func->JITCompile();
+				func->isBodyPending = false;
+			}
+
+			stream = 0;
+		}
+		else
+			r = asERROR;
+	}
+
+	LEAVECRITICALSECTION(pendingCritical);
+
+	return r;
+}
+
 void asCReader::ReadUsedStringConstants()
 {
 	asCString str;
 
 	asUINT count;
 	count = ReadEncodedUInt();
-	usedStringConstants.Allocate(count, 0);
+	usedStringConstants.Allocate(usedStringConstants.GetLength() + count, true);
 	for( asUINT i = 0; i < count; ++i ) 
 	{
 		ReadString(&str);
@@ -513,10 +1021,12 @@ void asCReader::ReadUsedFunctions()
 {
 	asUINT count;
 	count = ReadEncodedUInt();
-	usedFunctions.SetLength(count);
-	memset(usedFunctions.AddressOf(), 0, sizeof(asCScriptFunction *)*count);
+	asUINT first = (asUINT)usedFunctions.GetLength();
+	usedFunctions.SetLength(first + count);
+	if( count )
+		memset(usedFunctions.AddressOf() + first, 0, sizeof(asCScriptFunction *)*count);
 
-	for( asUINT n = 0; n < usedFunctions.GetLength(); n++ )
+	for( asUINT n = first; n < usedFunctions.GetLength(); n++ )
 	{
 		char c;
 
@@ -685,6 +1195,27 @@ asCScriptFunction *asCReader::ReadFunction(bool &isNew, bool addToModule, bool a
 		}
 	}
 
+	if( c == 's' )
+	{
+		// This is a shared function that was loaded with a previous module in the bundle
+		asUINT index = ReadEncodedUInt();
+		if( !isBundle || index >= bundleSharedFunctions.GetLength() )
+		{
+			error = true;
+			return 0;
+		}
+
+		asCScriptFunction *func = bundleSharedFunctions[index];
+		savedFunctions.PushLast(func);
+		if( addToModule )
+		{
+			module->scriptFunctions.PushLast(func);
+			func->AddRef();
+			dontTranslate.Insert(func, true);
+		}
+		return func;
+	}
+
 	// Load the new function
 	isNew = true;
 	asCScriptFunction *func = asNEW(asCScriptFunction)(engine,module,asFUNC_DUMMY);
@@ -694,98 +1225,48 @@ asCScriptFunction *asCReader::ReadFunction(bool &isNew, bool addToModule, bool a
 		error = true;
 		return 0;
 	}
+	asUINT slot = (asUINT)savedFunctions.GetLength();
 	savedFunctions.PushLast(func);
 
-	int i, count;
-	asCDataType dt;
-	int num;
-
 	ReadFunctionSignature(func);
 
 	if( func->funcType == asFUNC_SCRIPT )
 	{
 		if( addToGC && !addToModule )
 			engine->gc.AddScriptObjectToGC(func, &engine->functionBehaviours);
-		
-		ReadByteCode(func);
-
-		func->variableSpace = ReadEncodedUInt();
-
-		count = ReadEncodedUInt();
-		func->objVariablePos.Allocate(count, 0);
-		func->objVariableTypes.Allocate(count, 0);
-		func->funcVariableTypes.Allocate(count, 0);
-		for( i = 0; i < count; ++i )
-		{
-			func->objVariableTypes.PushLast(ReadObjectType());
-			asUINT idx = ReadEncodedUInt();
-			func->funcVariableTypes.PushLast((asCScriptFunction*)(asPWORD)idx);
-			num = ReadEncodedUInt();
-			func->objVariablePos.PushLast(num);
-		}
-		if( count > 0 )
-			func->objVariablesOnHeap = ReadEncodedUInt();
-		else
-			func->objVariablesOnHeap = 0;
-
-		int length = ReadEncodedUInt();
-		func->objVariableInfo.SetLength(length);
-		for( i = 0; i < length; ++i )
-		{
-			func->objVariableInfo[i].programPos     = ReadEncodedUInt();
-			func->objVariableInfo[i].variableOffset = ReadEncodedUInt();
-			func->objVariableInfo[i].option         = ReadEncodedUInt();
-		}
-
-		if( !noDebugInfo )
-		{
-			length = ReadEncodedUInt();
-			func->lineNumbers.SetLength(length);
-			for( i = 0; i < length; ++i )
-				func->lineNumbers[i] = ReadEncodedUInt();
-
-			// Read the array of script sections 
-			length = ReadEncodedUInt();
-			func->sectionIdxs.SetLength(length);
-			for( i = 0; i < length; ++i )
-			{
-				if( (i & 1) == 0 )
-					func->sectionIdxs[i] = ReadEncodedUInt();
-				else
-				{
-					asCString str;
-					ReadString(&str);
-					func->sectionIdxs[i] = engine->GetScriptSectionNameIndex(str.AddressOf());
-				}
-			}
-		}
-
-		ReadData(&func->isShared, 1);
 
-		// Read the variable information
-		if( !noDebugInfo )
+		if( sizedBodies )
 		{
-			length = ReadEncodedUInt();
-			func->variables.Allocate(length, 0);
-			for( i = 0; i < length; i++ )
+			// The shared flag is also stored in the body, but it is needed before it is read
+			ReadData(&func->isShared, 1);
+			asUINT size = ReadEncodedUInt();
+
+			// Only the module's own functions can be loaded on demand. The shared
+			// functions may be replaced by the ones already loaded in another module.
+			// The modules in a bundle are loaded completely as they share the reader
+			if( engine->ep.lazyLoadFunctions && addToModule && !isBundle && !func->isShared &&
+				!(func->objectType && func->objectType->IsShared()) )
 			{
-				asSScriptVariable *var = asNEW(asSScriptVariable);
-				if( var == 0 )
+				asUINT offset = (asUINT)pendingBodies.buffer.GetLength();
+				if( pendingBodies.buffer.GetCapacity() < offset + size )
+					pendingBodies.buffer.AllocateNoConstruct(2*(offset + size), true);
+				if( !pendingBodies.buffer.SetLengthNoConstruct(offset + size) )
 				{
 					// Out of memory
 					error = true;
 					return 0;
 				}
-				func->variables.PushLast(var);
+				if( size )
+					stream->Read(pendingBodies.buffer.AddressOf() + offset, size);
 
-				var->declaredAtProgramPos = ReadEncodedUInt();
-				var->stackOffset = ReadEncodedUInt();
-				ReadString(&var->name);
-				ReadDataType(&var->type);
+				pendingBodyOffsets.Insert(func, offset);
+				func->isBodyPending = true;
 			}
+			else
+				ReadFunctionBody(func);
 		}
-
-		ReadData(&func->dontCleanUpOnException, 1);
+		else
+			ReadFunctionBody(func);
 	}
 	else if( func->funcType == asFUNC_VIRTUAL )
 	{
@@ -813,23 +1294,120 @@ asCScriptFunction *asCReader::ReadFunction(bool &isNew, bool addToModule, bool a
 	if( func->objectType )
 		func->ComputeSignatureId();
 
+	// The function may still be replaced by a pre-existing shared function, 
+	// so the slot is remembered until the module has been completely loaded
+	if( isBundle && IsBundleSharedFunction(func) )
+		bundleSharedSlots.PushLast(slot);
+
 	return func;
 }
 
-void asCReader::ReadObjectTypeDeclaration(asCObjectType *ot, int phase)
+void asCReader::ReadFunctionBody(asCScriptFunction *func)
 {
-	if( phase == 1 )
-	{
-		// Read the initial attributes
-		ReadString(&ot->name);
-		ReadData(&ot->flags, 4);
-		ot->size = ReadEncodedUInt();
-		asCString ns;
-		ReadString(&ns);
-		ot->nameSpace = engine->AddNameSpace(ns.AddressOf());
+	int i, count;
+	int num;
 
-		// Reset the size of script classes, since it will be recalculated as properties are added
-		if( (ot->flags & asOBJ_SCRIPT_OBJECT) && ot->size != 0 )
+	// Sized bodies may refer to the shared strings and data types, but the ones
+	// they introduce are not shared, so the bodies can be read in any order
+	inFunctionBody = sizedBodies;
+
+	ReadByteCode(func);
+
+	func->variableSpace = ReadEncodedUInt();
+
+	count = ReadEncodedUInt();
+	func->objVariablePos.Allocate(count, 0);
+	func->objVariableTypes.Allocate(count, 0);
+	func->funcVariableTypes.Allocate(count, 0);
+	for( i = 0; i < count; ++i )
+	{
+		func->objVariableTypes.PushLast(ReadObjectType());
+		asUINT idx = ReadEncodedUInt();
+		func->funcVariableTypes.PushLast((asCScriptFunction*)(asPWORD)idx);
+		num = ReadEncodedUInt();
+		func->objVariablePos.PushLast(num);
+	}
+	if( count > 0 )
+		func->objVariablesOnHeap = ReadEncodedUInt();
+	else
+		func->objVariablesOnHeap = 0;
+
+	int length = ReadEncodedUInt();
+	func->objVariableInfo.SetLength(length);
+	for( i = 0; i < length; ++i )
+	{
+		func->objVariableInfo[i].programPos     = ReadEncodedUInt();
+		func->objVariableInfo[i].variableOffset = ReadEncodedUInt();
+		func->objVariableInfo[i].option         = ReadEncodedUInt();
+	}
+
+	if( !noDebugInfo )
+	{
+		length = ReadEncodedUInt();
+		func->lineNumbers.SetLength(length);
+		for( i = 0; i < length; ++i )
+			func->lineNumbers[i] = ReadEncodedUInt();
+
+		// Read the array of script sections 
+		length = ReadEncodedUInt();
+		func->sectionIdxs.SetLength(length);
+		for( i = 0; i < length; ++i )
+		{
+			if( (i & 1) == 0 )
+				func->sectionIdxs[i] = ReadEncodedUInt();
+			else
+			{
+				asCString str;
+				ReadString(&str);
+				func->sectionIdxs[i] = engine->GetScriptSectionNameIndex(str.AddressOf());
+			}
+		}
+	}
+
+	ReadData(&func->isShared, 1);
+
+	// Read the variable information
+	if( !noDebugInfo )
+	{
+		length = ReadEncodedUInt();
+		func->variables.Allocate(length, 0);
+		for( i = 0; i < length; i++ )
+		{
+			asSScriptVariable *var = asNEW(asSScriptVariable);
+			if( var == 0 )
+			{
+				// Out of memory
+				error = true;
+				break;
+			}
+			func->variables.PushLast(var);
+
+			var->declaredAtProgramPos = ReadEncodedUInt();
+			var->stackOffset = ReadEncodedUInt();
+			ReadString(&var->name);
+			ReadDataType(&var->type);
+		}
+	}
+
+	ReadData(&func->dontCleanUpOnException, 1);
+
+	inFunctionBody = false;
+}
+
+void asCReader::ReadObjectTypeDeclaration(asCObjectType *ot, int phase)
+{
+	if( phase == 1 )
+	{
+		// Read the initial attributes
+		ReadString(&ot->name);
+		ReadData(&ot->flags, 4);
+		ot->size = ReadEncodedUInt();
+		asCString ns;
+		ReadString(&ns);
+		ot->nameSpace = engine->AddNameSpace(ns.AddressOf());
+
+		// Reset the size of script classes, since it will be recalculated as properties are added
+		if( (ot->flags & asOBJ_SCRIPT_OBJECT) && ot->size != 0 )
 			ot->size = sizeof(asCScriptObject);
 
 		// Use the default script class behaviours
@@ -1355,7 +1933,8 @@ void asCReader::ReadString(asCString* str)
 		str->SetLength(len);
 		stream->Read(str->AddressOf(), len);
 
-		savedStrings.PushLast(*str);
+		if( !inFunctionBody )
+			savedStrings.PushLast(*str);
 	}
 	else
 	{
@@ -1425,13 +2004,17 @@ void asCReader::ReadDataType(asCDataType *dt)
 	{
 		// Get the datatype from the cache
 		asUINT n = ReadEncodedUInt();
-		*dt = savedDataTypes[n];
+		if( n < savedDataTypes.GetLength() )
+			*dt = savedDataTypes[n];
+		else
+			error = true;
 		return;
 	}
 
 	// Reserve a spot in the savedDataTypes
 	size_t saveSlot = savedDataTypes.GetLength();
-	savedDataTypes.PushLast(asCDataType());
+	if( !inFunctionBody )
+		savedDataTypes.PushLast(asCDataType());
 
 	// Read the datatype for the first time
 	asCObjectType *objType = 0;
@@ -1500,7 +2083,8 @@ void asCReader::ReadDataType(asCDataType *dt)
 	dt->MakeReference(isReference);
 
 	// Update the previously saved slot
-	savedDataTypes[saveSlot] = *dt;
+	if( !inFunctionBody )
+		savedDataTypes[saveSlot] = *dt;
 }
 
 asCObjectType* asCReader::ReadObjectType() 
@@ -1868,7 +2452,7 @@ void asCReader::ReadByteCode(asCScriptFunction *func)
 void asCReader::ReadUsedTypeIds()
 {
 	asUINT count = ReadEncodedUInt();
-	usedTypeIds.Allocate(count, 0);
+	usedTypeIds.Allocate(usedTypeIds.GetLength() + count, true);
 	for( asUINT n = 0; n < count; n++ )
 	{
 		asCDataType dt;
@@ -1881,7 +2465,7 @@ void asCReader::ReadUsedGlobalProps()
 {
 	int c = ReadEncodedUInt();
 
-	usedGlobalProperties.Allocate(c, 0);
+	usedGlobalProperties.Allocate(usedGlobalProperties.GetLength() + c, true);
 
 	for( int n = 0; n < c; n++ )
 	{
@@ -1920,9 +2504,10 @@ void asCReader::ReadUsedGlobalProps()
 void asCReader::ReadUsedObjectProps()
 {
 	asUINT c = ReadEncodedUInt();
+	asUINT first = (asUINT)usedObjectProperties.GetLength();
 
-	usedObjectProperties.SetLength(c);
-	for( asUINT n = 0; n < c; n++ )
+	usedObjectProperties.SetLength(first + c);
+	for( asUINT n = first; n < first + c; n++ )
 	{
 		asCObjectType *objType = ReadObjectType();
 		if( objType == 0 )
@@ -1996,7 +2581,7 @@ void asCReader::TranslateFunction(asCScriptFunction *func)
 	{
 		int c = *(asBYTE*)&bc[n];
 		asUINT size = asBCTypeSize[asBCInfo[c].type];
-		if( size == 0 )
+		if( size == 0 || n + size > func->byteCode.GetLength() )
 		{
 			error = true;
 			return;
@@ -2006,6 +2591,10 @@ void asCReader::TranslateFunction(asCScriptFunction *func)
 		n += size;
 	}
 
+	// Positions may also refer to the end of the function
+	asUINT numInstructions = bcSizes.GetLength();
+	instructionNbrToPos.PushLast(n);
+
 	asUINT bcNum = 0;
 	for( n = 0; n < func->byteCode.GetLength(); bcNum++ )
 	{
@@ -2081,6 +2670,7 @@ void asCReader::TranslateFunction(asCScriptFunction *func)
 			asBC_WORDARG0(&bc[n]) = dw;
 		}
 		else if( c == asBC_CALL ||
+				 c == asBC_TAILCALL ||
 				 c == asBC_CALLINTF ||
 				 c == asBC_CALLSYS )
 		{
@@ -2194,6 +2784,13 @@ void asCReader::TranslateFunction(asCScriptFunction *func)
 			// Get the offset 
 			int offset = int(bc[n+1]);
 
+			// The destination must be within the function
+			if( int(bcNum) + 1 + offset < 0 || int(bcNum) + 1 + offset >= (int)numInstructions )
+			{
+				error = true;
+				return;
+			}
+
 			// Count the instruction sizes to the destination instruction
 			int size = 0;
 			if( offset >= 0 )
@@ -2266,6 +2863,11 @@ void asCReader::TranslateFunction(asCScriptFunction *func)
 	// Adjust the variable information. This will be used during the adjustment below
 	for( n = 0; n < func->variables.GetLength(); n++ )
 	{
+		if( func->variables[n]->declaredAtProgramPos > numInstructions )
+		{
+			error = true;
+			return;
+		}
 		func->variables[n]->declaredAtProgramPos = instructionNbrToPos[func->variables[n]->declaredAtProgramPos];
 		func->variables[n]->stackOffset = AdjustStackPosition(func->variables[n]->stackOffset);
 	}
@@ -2302,6 +2904,11 @@ void asCReader::TranslateFunction(asCScriptFunction *func)
 	for( n = 0; n < func->objVariableInfo.GetLength(); n++ )
 	{
 		// The program position must be adjusted as it is stored in number of instructions
+		if( func->objVariableInfo[n].programPos > numInstructions )
+		{
+			error = true;
+			return;
+		}
 		func->objVariableInfo[n].programPos = instructionNbrToPos[func->objVariableInfo[n].programPos];
 		func->objVariableInfo[n].variableOffset = AdjustStackPosition(func->objVariableInfo[n].variableOffset);
 	}
@@ -2309,9 +2916,37 @@ void asCReader::TranslateFunction(asCScriptFunction *func)
 	// The program position (every even number) needs to be adjusted
 	// for the line numbers to be in number of dwords instead of number of instructions 
 	for( n = 0; n < func->lineNumbers.GetLength(); n += 2 )
+	{
+		if( asUINT(func->lineNumbers[n]) > numInstructions )
+		{
+			error = true;
+			return;
+		}
 		func->lineNumbers[n] = instructionNbrToPos[func->lineNumbers[n]];
+	}
 	for( n = 0; n < func->sectionIdxs.GetLength(); n += 2 )
+	{
+		if( asUINT(func->sectionIdxs[n]) > numInstructions )
+		{
+			error = true;
+			return;
+		}
 		func->sectionIdxs[n] = instructionNbrToPos[func->sectionIdxs[n]];
+	}
+
+	func->ComputeLiveObjectRanges();
+
+	if( engine->ep.verifyByteCode )
+	{
+		// Don't trust the loaded bytecode until it has been verified. The
+		// verification also gives the stack size so it isn't calculated twice
+		int stackSize;
+		if( error || func->VerifyByteCode(&stackSize) < 0 )
+			error = true;
+		else
+			func->stackNeeded = stackSize;
+		return;
+	}
 
 	CalculateStackNeeded(func);
 }
@@ -2347,13 +2982,14 @@ void asCReader::CalculateStackNeeded(asCScriptFunction *func)
 		{
 			// Determine the true delta from the instruction arguments
 			if( bc == asBC_CALL ||
+			    bc == asBC_TAILCALL ||
 			    bc == asBC_CALLSYS ||
 				bc == asBC_CALLBND ||
 				bc == asBC_ALLOC ||
 				bc == asBC_CALLINTF ||
 				bc == asBC_CallPtr )
 			{
-				asCScriptFunction *called = GetCalledFunction(func, pos);
+				asCScriptFunction *called = func->GetCalledFunction(pos);
 				if( called )
 				{
 					stackInc = -called->GetSpaceNeededForArguments();
@@ -2566,164 +3202,733 @@ int asCReader::AdjustStackPosition(int pos)
 	else if( -pos >= (int)adjustNegativeStackByPos.GetLength() )
 		error = true;
 	else
-		pos += (short)adjustNegativeStackByPos[-pos];
+		pos += (short)adjustNegativeStackByPos[-pos];
+
+	return pos;
+}
+
+int asCReader::AdjustGetOffset(int offset, asCScriptFunction *func, asDWORD programPos)
+{
+	// TODO: optimize: multiple instructions for the same function doesn't need to look for the function everytime
+	//                 the function can remember where it found the function and check if the programPos is still valid
+
+	// Get offset 0 doesn't need adjustment
+	if( offset == 0 ) return 0;
+
+	// Find out which function that will be called
+	asCScriptFunction *calledFunc = 0;
+	for( asUINT n = programPos; n < func->byteCode.GetLength(); )
+	{
+		asBYTE bc = *(asBYTE*)&func->byteCode[n];
+		if( bc == asBC_CALL ||
+			bc == asBC_TAILCALL ||
+			bc == asBC_CALLSYS ||
+			bc == asBC_CALLINTF || 
+			bc == asBC_ALLOC ||
+			bc == asBC_CALLBND ||
+			bc == asBC_CallPtr )
+		{
+			calledFunc = func->GetCalledFunction(n);
+			break;
+		}
+		else if( bc == asBC_REFCPY ||
+				 bc == asBC_COPY )
+		{
+			// In this case we know there is only 1 pointer on the stack above
+			asASSERT( offset == 1 );
+			return offset - (1 - AS_PTR_SIZE);
+		}
+
+		n += asBCTypeSize[asBCInfo[bc].type];
+	}
+
+	if( calledFunc == 0 )
+	{
+		// TODO: Report error
+		error = true;
+		return offset;
+	}
+
+	// Count the number of pointers pushed on the stack above the 
+	// current offset, and then adjust the offset accordingly
+	asUINT numPtrs = 0;
+	int currOffset = 0;
+	if( offset > currOffset && calledFunc->GetObjectType() )
+	{
+		numPtrs++;
+		currOffset++;
+	}
+	if( offset > currOffset && calledFunc->DoesReturnOnStack() )
+	{
+		numPtrs++;
+		currOffset++;
+	}
+	for( asUINT p = 0; p < calledFunc->parameterTypes.GetLength(); p++ )
+	{
+		if( offset <= currOffset ) break;
+
+		if( !calledFunc->parameterTypes[p].IsPrimitive() ||
+			calledFunc->parameterTypes[p].IsReference() )
+		{
+			numPtrs++;
+			currOffset++;
+
+			// The variable arg ? has an additiona 32bit integer with the typeid
+			if( calledFunc->parameterTypes[p].IsAnyType() )
+				currOffset += 1;
+		}
+		else
+		{
+			// Enums or built-in primitives are passed by value
+			asASSERT( calledFunc->parameterTypes[p].IsPrimitive() );
+			currOffset += calledFunc->parameterTypes[p].GetSizeOnStackDWords();
+		}
+	}
+
+	return offset - numPtrs * (1 - AS_PTR_SIZE);
+}
+
+int asCReader::FindTypeId(int idx)
+{
+	if( idx >= 0 && idx < (int)usedTypeIds.GetLength() )
+		return usedTypeIds[idx];
+	else
+	{
+		// TODO: Write to message callback
+		error = true;
+		return 0;
+	}
+}
+
+asCObjectType *asCReader::FindObjectType(int idx)
+{
+	if( idx < 0 || idx >= (int)usedTypes.GetLength() )
+	{
+		// TODO: Write to message callback
+		error = true;
+		return 0;
+	}
+
+	return usedTypes[idx];
+}
+
+asCConfigImage::asCConfigImage(asCScriptEngine *_engine) : engine(_engine)
+{
+	isInvalid      = false;
+	readPos        = 0;
+	readEnd        = 0;
+	numRecorded    = 0;
+	entryFailed    = false;
+	cachedObjTypes = 0;
+	cachedEnums    = 0;
+	cachedFuncDefs = 0;
+	cachedSubTypes = 0;
+}
+
+asCConfigImage::~asCConfigImage()
+{
+}
+
+// The image starts with this header, followed by the number of entries and the size of the entry data
+static const asBYTE configImageMagic[4] = {'A', 'S', 'C', 'I'};
+
+static void WriteImageDWord(asIBinaryStream *stream, asDWORD value)
+{
+	// Always stored as little endian so the image can be shared between platforms
+	asBYTE bytes[4];
+	for( int n = 0; n < 4; n++ )
+		bytes[n] = asBYTE(value >> (n*8));
+	stream->Write(bytes, 4);
+}
+
+static asDWORD ReadImageDWord(asIBinaryStream *stream)
+{
+	asBYTE bytes[4];
+	stream->Read(bytes, 4);
+	asDWORD value = 0;
+	for( int n = 0; n < 4; n++ )
+		value |= asDWORD(bytes[n]) << (n*8);
+	return value;
+}
+
+int asCConfigImage::Save(asIBinaryStream *stream) const
+{
+	if( !IsRecording() )
+	{
+		engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, TXT_CONFIG_IMAGE_NOT_RECORDED);
+		return asERROR;
+	}
+
+	stream->Write(configImageMagic, 4);
+	WriteImageDWord(stream, ANGELSCRIPT_VERSION);
+	WriteImageDWord(stream, numRecorded);
+	WriteImageDWord(stream, (asDWORD)recorded.GetLength());
+	if( recorded.GetLength() )
+		stream->Write(recorded.AddressOf(), (asUINT)recorded.GetLength());
+
+	return asSUCCESS;
+}
+
+int asCConfigImage::Load(asIBinaryStream *stream)
+{
+	image.SetLength(0);
+	entries.EraseAll();
+	readPos = readEnd = 0;
+
+	// A null stream just discards the previously loaded image
+	if( stream == 0 )
+		return asSUCCESS;
+
+	asBYTE magic[4];
+	stream->Read(magic, 4);
+	asDWORD version = ReadImageDWord(stream);
+	asDWORD count   = ReadImageDWord(stream);
+	asDWORD length  = ReadImageDWord(stream);
+	if( memcmp(magic, configImageMagic, 4) != 0 || version != ANGELSCRIPT_VERSION )
+	{
+		engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, TXT_CONFIG_IMAGE_INVALID);
+		return asERROR;
+	}
+
+	image.SetLength(length);
+	if( image.GetLength() != length )
+		return asOUT_OF_MEMORY;
+	if( length )
+		stream->Read(image.AddressOf(), length);
+
+	// Build the look-up map with the position of each entry
+	asUINT pos = 0;
+	for( asDWORD n = 0; n < count; n++ )
+	{
+		asQWORD key = 0;
+		asUINT entryLength = 0;
+		bool ok = pos + 8 <= length;
+		if( ok )
+		{
+			for( int b = 0; b < 8; b++ )
+				key |= asQWORD(image[pos+b]) << (b*8);
+
+			readPos = pos + 8;
+			readEnd = length;
+			ok = ReadUInt(&entryLength) && entryLength <= readEnd - readPos;
+		}
+		if( !ok )
+		{
+			image.SetLength(0);
+			entries.EraseAll();
+			engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, TXT_CONFIG_IMAGE_INVALID);
+			return asERROR;
+		}
+
+		// If the same registration was recorded twice, only the first is kept
+		asSMapNode<asQWORD, asUINT> *cursor = 0;
+		if( !entries.MoveTo(&cursor, key) )
+			entries.Insert(key, pos + 8);
+
+		pos = readPos + entryLength;
+	}
+
+	readPos = readEnd = 0;
+
+	return asSUCCESS;
+}
+
+void asCConfigImage::Invalidate()
+{
+	// Removing a config group changes the indices of the registered types
+	// so the recording can no longer be replayed on a new engine
+	isInvalid = true;
+	recorded.SetLength(0);
+	numRecorded = 0;
+	indexCache.EraseAll();
+	cachedObjTypes = 0;
+	cachedEnums    = 0;
+	cachedFuncDefs = 0;
+	cachedSubTypes = 0;
+}
+
+bool asCConfigImage::IsRecording() const
+{
+	return engine->ep.recordConfigImage && !isInvalid;
+}
+
+asQWORD asCConfigImage::GetKey(EEntryKind kind, const char *obj, const char *decl, int behaviour) const
+{
+	// Don't spend time on the hash if there is nothing to look up or record
+	if( entries.GetCount() == 0 && !IsRecording() )
+		return 0;
+
+	// 64bit FNV-1a hash of the arguments to the registration together
+	// with the namespace that was the default when it was called
+	const asQWORD prime = (asQWORD(0x100) << 32) | 0x1b3;
+	asQWORD hash = (asQWORD(0xcbf29ce4) << 32) | 0x84222325;
+
+	hash = (hash ^ asBYTE(kind)) * prime;
+	hash = (hash ^ asBYTE(behaviour)) * prime;
+
+	const char *strs[3] = {engine->defaultNamespace->name.AddressOf(), obj, decl};
+	for( int n = 0; n < 3; n++ )
+	{
+		for( const char *c = strs[n]; c && *c; c++ )
+			hash = (hash ^ asBYTE(*c)) * prime;
+
+		// Include the terminator so the strings can't run into each other
+		hash *= prime;
+	}
+
+	return hash;
+}
+
+bool asCConfigImage::FindEntry(asQWORD key)
+{
+	asSMapNode<asQWORD, asUINT> *cursor = 0;
+	if( key == 0 || !entries.MoveTo(&cursor, key) )
+		return false;
+
+	readPos = entries.GetValue(cursor);
+	readEnd = (asUINT)image.GetLength();
+
+	// Each entry is used only once, so if the application registers the same
+	// declaration twice the second call will be validated as usual
+	entries.Erase(cursor);
+
+	asUINT length;
+	if( !ReadUInt(&length) )
+		return false;
+	readEnd = readPos + length;
+
+	return true;
+}
+
+bool asCConfigImage::RestoreObjectType(asCObjectType **ot)
+{
+	asCScriptFunction *funcDef = 0;
+	*ot = 0;
+	if( !ReadObjectTypeRef(ot, &funcDef) || funcDef )
+		return false;
+
+	return *ot != 0;
+}
+
+bool asCConfigImage::RestoreFunction(asCScriptFunction *func, asCArray<bool> *paramAutoHandles, bool *returnAutoHandle)
+{
+	asCString nsName;
+	asBYTE flags = 0;
+	asUINT count = 0;
+	bool ok = ReadString(&func->name) &&
+	          ReadString(&nsName) &&
+	          ReadDataType(&func->returnType) &&
+	          ReadByte(&flags) &&
+	          ReadUInt(&count);
+	if( ok )
+	{
+		func->nameSpace = engine->FindNameSpace(nsName.AddressOf());
+		ok = func->nameSpace != 0;
+	}
+
+	func->isReadOnly = (flags & 1) ? true : false;
+	if( returnAutoHandle ) *returnAutoHandle = (flags & 2) ? true : false;
+
+	for( asUINT n = 0; ok && n < count; n++ )
+	{
+		asCDataType type;
+		asUINT inOutFlags = 0;
+		asBYTE paramFlags = 0;
+		ok = ReadDataType(&type) &&
+		     ReadUInt(&inOutFlags) &&
+		     ReadByte(&paramFlags);
+
+		asCString *defaultArg = 0;
+		if( ok && (paramFlags & 2) )
+		{
+			defaultArg = asNEW(asCString);
+			if( defaultArg == 0 || !ReadString(defaultArg) )
+			{
+				if( defaultArg )
+					asDELETE(defaultArg, asCString);
+				ok = false;
+			}
+		}
+
+		if( ok )
+		{
+			func->parameterTypes.PushLast(type);
+			func->inOutFlags.PushLast((asETypeModifiers)inOutFlags);
+			func->defaultArgs.PushLast(defaultArg);
+			if( paramAutoHandles ) paramAutoHandles->PushLast((paramFlags & 1) ? true : false);
+		}
+	}
+
+	if( !ok )
+	{
+		// Leave the parameters empty so the declaration can be parsed instead
+		for( asUINT n = 0; n < func->defaultArgs.GetLength(); n++ )
+			if( func->defaultArgs[n] )
+				asDELETE(func->defaultArgs[n], asCString);
+		func->defaultArgs.SetLength(0);
+		func->parameterTypes.SetLength(0);
+		func->inOutFlags.SetLength(0);
+		if( paramAutoHandles ) paramAutoHandles->SetLength(0);
+	}
+
+	return ok;
+}
+
+bool asCConfigImage::RestoreProperty(asCString &name, asCDataType &type)
+{
+	return ReadString(&name) && ReadDataType(&type);
+}
+
+bool asCConfigImage::ReadByte(asBYTE *b)
+{
+	if( readPos >= readEnd )
+		return false;
+
+	*b = image[readPos++];
+	return true;
+}
+
+bool asCConfigImage::ReadUInt(asUINT *v)
+{
+	*v = 0;
+	for( int shift = 0; shift < 35; shift += 7 )
+	{
+		asBYTE b;
+		if( !ReadByte(&b) )
+			return false;
+
+		*v |= asUINT(b & 0x7F) << shift;
+		if( (b & 0x80) == 0 )
+			return true;
+	}
+
+	return false;
+}
+
+bool asCConfigImage::ReadString(asCString *str)
+{
+	asUINT length;
+	if( !ReadUInt(&length) || length > readEnd - readPos )
+		return false;
+
+	str->Assign((const char*)&image[readPos], length);
+	readPos += length;
+	return true;
+}
+
+bool asCConfigImage::ReadName(const asCString &name)
+{
+	// Verify that the type found by index has the expected name. If it doesn't
+	// then the application didn't register the interface in the same order
+	asUINT length;
+	if( !ReadUInt(&length) || length > readEnd - readPos || length != name.GetLength() )
+		return false;
+
+	bool match = length == 0 || memcmp(&image[readPos], name.AddressOf(), length) == 0;
+	readPos += length;
+	return match;
+}
+
+bool asCConfigImage::ReadDataType(asCDataType *dt)
+{
+	asUINT tokenType;
+	if( !ReadUInt(&tokenType) )
+		return false;
+
+	asCObjectType *ot = 0;
+	asCScriptFunction *funcDef = 0;
+	if( tokenType == ttIdentifier && !ReadObjectTypeRef(&ot, &funcDef) )
+		return false;
+
+	asBYTE flags;
+	if( !ReadByte(&flags) )
+		return false;
+
+	if( funcDef )
+		*dt = asCDataType::CreateFuncDef(funcDef);
+	else if( tokenType == ttIdentifier )
+		*dt = asCDataType::CreateObject(ot, false);
+	else
+		*dt = asCDataType::CreatePrimitive((eTokenType)tokenType, false);
+	if( flags & 1 )
+	{
+		dt->MakeReadOnly((flags & 2) ? true : false);
 
-	return pos;
+		// Scoped types are allowed to be handles in system functions
+		dt->MakeHandle(true, true);
+	}
+	dt->MakeReadOnly((flags & 8) ? true : false);
+	dt->MakeReference((flags & 4) ? true : false);
+
+	return true;
 }
 
-asCScriptFunction *asCReader::GetCalledFunction(asCScriptFunction *func, asDWORD programPos)
+bool asCConfigImage::ReadObjectTypeRef(asCObjectType **ot, asCScriptFunction **funcDef)
 {
-	asBYTE bc = *(asBYTE*)&func->byteCode[programPos];
+	asBYTE c;
+	asUINT idx;
+	if( !ReadByte(&c) || !ReadUInt(&idx) )
+		return false;
 
-	if( bc == asBC_CALL ||
-		bc == asBC_CALLSYS ||
-		bc == asBC_CALLINTF )
+	if( c == 'o' )
+	{
+		if( idx >= engine->registeredObjTypes.GetLength() || engine->registeredObjTypes[idx] == 0 )
+			return false;
+		*ot = engine->registeredObjTypes[idx];
+		return ReadName((*ot)->name);
+	}
+	else if( c == 'e' )
 	{
-		// Find the function from the function id in bytecode
-		int funcId = asBC_INTARG(&func->byteCode[programPos]);
-		return engine->scriptFunctions[funcId];
+		if( idx >= engine->registeredEnums.GetLength() || engine->registeredEnums[idx] == 0 )
+			return false;
+		*ot = engine->registeredEnums[idx];
+		return ReadName((*ot)->name);
 	}
-	else if( bc == asBC_ALLOC )
+	else if( c == 's' )
 	{
-		// Find the function from the function id in the bytecode
-		int funcId = asBC_INTARG(&func->byteCode[programPos+AS_PTR_SIZE]);
-		return engine->scriptFunctions[funcId];
+		if( idx >= engine->templateSubTypes.GetLength() || engine->templateSubTypes[idx] == 0 )
+			return false;
+		*ot = engine->templateSubTypes[idx];
+		return ReadName((*ot)->name);
 	}
-	else if( bc == asBC_CALLBND )
+	else if( c == 'f' )
 	{
-		// Find the function from the engine's bind array
-		int funcId = asBC_INTARG(&func->byteCode[programPos]);
-		return engine->importedFunctions[funcId & ~FUNC_IMPORTED]->importedFunctionSignature;
+		if( idx >= engine->registeredFuncDefs.GetLength() || engine->registeredFuncDefs[idx] == 0 )
+			return false;
+		*funcDef = engine->registeredFuncDefs[idx];
+		*ot = &engine->functionBehaviours;
+		return ReadName((*funcDef)->name);
 	}
-	else if( bc == asBC_CallPtr )
+	else if( c == 't' )
 	{
-		asUINT v;
-		int var = asBC_SWORDARG0(&func->byteCode[programPos]);
+		if( idx >= engine->registeredObjTypes.GetLength() || engine->registeredObjTypes[idx] == 0 )
+			return false;
+		asCObjectType *tmpl = engine->registeredObjTypes[idx];
+		if( !ReadName(tmpl->name) || !(tmpl->flags & asOBJ_TEMPLATE) )
+			return false;
 
-		// Find the funcdef from the local variable
-		for( v = 0; v < func->objVariablePos.GetLength(); v++ )
-			if( func->objVariablePos[v] == var )
-				return func->funcVariableTypes[v];
+		asUINT count;
+		if( !ReadUInt(&count) || count != tmpl->templateSubTypes.GetLength() )
+			return false;
 
-		// Look in parameters
-		int paramPos = 0;
-		if( func->objectType )
-			paramPos -= AS_PTR_SIZE;
-		if( func->DoesReturnOnStack() )
-			paramPos -= AS_PTR_SIZE;
-		for( v = 0; v < func->parameterTypes.GetLength(); v++ )
+		asCArray<asCDataType> subTypes;
+		for( asUINT n = 0; n < count; n++ )
 		{
-			if( var == paramPos )
-				return func->parameterTypes[v].GetFuncDef();
-			paramPos -= func->parameterTypes[v].GetSizeOnStackDWords();
+			asCDataType dt;
+			if( !ReadDataType(&dt) )
+				return false;
+			subTypes.PushLast(dt);
 		}
+
+		// This will give the same template instance, or
+		// registered template specialization, as the parser
+		*ot = engine->GetTemplateInstanceType(tmpl, subTypes);
+		return *ot != 0;
 	}
 
-	return 0;
+	return false;
 }
 
-int asCReader::AdjustGetOffset(int offset, asCScriptFunction *func, asDWORD programPos)
+void asCConfigImage::RecordFunction(asQWORD key, asCObjectType *ot, asCScriptFunction *func)
 {
-	// TODO: optimize: multiple instructions for the same function doesn't need to look for the function everytime
-	//                 the function can remember where it found the function and check if the programPos is still valid
+	if( !IsRecording() )
+		return;
 
-	// Get offset 0 doesn't need adjustment
-	if( offset == 0 ) return 0;
+	BeginEntry(key);
 
-	// Find out which function that will be called
-	asCScriptFunction *calledFunc = 0;
-	for( asUINT n = programPos; func->byteCode.GetLength(); )
+	if( ot )
+		WriteObjectTypeRef(ot, 0);
+
+	WriteString(func->name);
+	WriteString(func->nameSpace ? func->nameSpace->name : asCString());
+	WriteDataType(func->returnType);
+
+	asSSystemFunctionInterface *intf = func->sysFuncIntf;
+	asBYTE flags = 0;
+	if( func->isReadOnly ) flags |= 1;
+	if( intf && intf->returnAutoHandle ) flags |= 2;
+	WriteByte(flags);
+
+	WriteUInt((asUINT)func->parameterTypes.GetLength());
+	for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
 	{
-		asBYTE bc = *(asBYTE*)&func->byteCode[n];
-		if( bc == asBC_CALL ||
-			bc == asBC_CALLSYS ||
-			bc == asBC_CALLINTF || 
-			bc == asBC_ALLOC ||
-			bc == asBC_CALLBND ||
-			bc == asBC_CallPtr )
-		{
-			calledFunc = GetCalledFunction(func, n);
-			break;
-		}
-		else if( bc == asBC_REFCPY ||
-				 bc == asBC_COPY )
-		{
-			// In this case we know there is only 1 pointer on the stack above
-			asASSERT( offset == 1 );
-			return offset - (1 - AS_PTR_SIZE);
-		}
+		WriteDataType(func->parameterTypes[n]);
+		WriteUInt(func->inOutFlags[n]);
 
-		n += asBCTypeSize[asBCInfo[bc].type];
+		asBYTE paramFlags = 0;
+		if( intf && n < intf->paramAutoHandles.GetLength() && intf->paramAutoHandles[n] ) paramFlags |= 1;
+		if( n < func->defaultArgs.GetLength() && func->defaultArgs[n] ) paramFlags |= 2;
+		WriteByte(paramFlags);
+		if( paramFlags & 2 )
+			WriteString(*func->defaultArgs[n]);
 	}
 
-	if( calledFunc == 0 )
+	EndEntry();
+}
+
+void asCConfigImage::RecordProperty(asQWORD key, asCObjectType *ot, const asCString &name, const asCDataType &type)
+{
+	if( !IsRecording() )
+		return;
+
+	BeginEntry(key);
+
+	if( ot )
+		WriteObjectTypeRef(ot, 0);
+
+	WriteString(name);
+	WriteDataType(type);
+
+	EndEntry();
+}
+
+void asCConfigImage::BeginEntry(asQWORD key)
+{
+	current.SetLength(0);
+	entryFailed = false;
+
+	for( int n = 0; n < 8; n++ )
+		current.PushLast(asBYTE(key >> (n*8)));
+}
+
+void asCConfigImage::EndEntry()
+{
+	// Entries that refer to types that cannot be stored
+	// are left out, so these will always be parsed
+	if( entryFailed )
+		return;
+
+	// The entry data is prefixed with the key and the length
+	asUINT length = (asUINT)current.GetLength() - 8;
+	recorded.Concatenate(current.AddressOf(), 8);
+	while( length >= 0x80 )
 	{
-		// TODO: Report error
-		error = true;
-		return offset;
+		recorded.PushLast(asBYTE(length | 0x80));
+		length >>= 7;
 	}
+	recorded.PushLast(asBYTE(length));
+	recorded.Concatenate(current.AddressOf() + 8, (unsigned int)current.GetLength() - 8);
 
-	// Count the number of pointers pushed on the stack above the 
-	// current offset, and then adjust the offset accordingly
-	asUINT numPtrs = 0;
-	int currOffset = 0;
-	if( offset > currOffset && calledFunc->GetObjectType() )
+	numRecorded++;
+}
+
+void asCConfigImage::WriteByte(asBYTE b)
+{
+	current.PushLast(b);
+}
+
+void asCConfigImage::WriteUInt(asUINT v)
+{
+	while( v >= 0x80 )
 	{
-		numPtrs++;
-		currOffset++;
+		current.PushLast(asBYTE(v | 0x80));
+		v >>= 7;
 	}
-	if( offset > currOffset && calledFunc->DoesReturnOnStack() )
+	current.PushLast(asBYTE(v));
+}
+
+void asCConfigImage::WriteString(const asCString &str)
+{
+	WriteUInt((asUINT)str.GetLength());
+	for( asUINT n = 0; n < str.GetLength(); n++ )
+		current.PushLast(asBYTE(str[n]));
+}
+
+void asCConfigImage::WriteDataType(const asCDataType &dt)
+{
+	WriteUInt(dt.GetTokenType());
+	if( dt.GetTokenType() == ttIdentifier )
+		WriteObjectTypeRef(dt.GetObjectType(), dt.GetFuncDef());
+
+	asBYTE flags = 0;
+	if( dt.IsObjectHandle() )  flags |= 1;
+	if( dt.IsHandleToConst() ) flags |= 2;
+	if( dt.IsReference() )     flags |= 4;
+	if( dt.IsReadOnly() )      flags |= 8;
+	WriteByte(flags);
+}
+
+void asCConfigImage::WriteObjectTypeRef(asCObjectType *ot, asCScriptFunction *funcDef)
+{
+	asUINT idx;
+
+	if( funcDef )
 	{
-		numPtrs++;
-		currOffset++;
+		if( FindIndex(funcDef, (void**)engine->registeredFuncDefs.AddressOf(), (asUINT)engine->registeredFuncDefs.GetLength(), cachedFuncDefs, &idx) )
+		{
+			WriteByte('f');
+			WriteUInt(idx);
+			WriteString(funcDef->name);
+			return;
+		}
 	}
-	for( asUINT p = 0; p < calledFunc->parameterTypes.GetLength(); p++ )
+	else if( ot == 0 )
 	{
-		if( offset <= currOffset ) break;
-
-		if( !calledFunc->parameterTypes[p].IsPrimitive() ||
-			calledFunc->parameterTypes[p].IsReference() )
+	}
+	else if( ot->flags & asOBJ_TEMPLATE_SUBTYPE )
+	{
+		if( FindIndex(ot, (void**)engine->templateSubTypes.AddressOf(), (asUINT)engine->templateSubTypes.GetLength(), cachedSubTypes, &idx) )
 		{
-			numPtrs++;
-			currOffset++;
-
-			// The variable arg ? has an additiona 32bit integer with the typeid
-			if( calledFunc->parameterTypes[p].IsAnyType() )
-				currOffset += 1;
+			WriteByte('s');
+			WriteUInt(idx);
+			WriteString(ot->name);
+			return;
 		}
-		else
+	}
+	else if( ot->flags & asOBJ_ENUM )
+	{
+		if( FindIndex(ot, (void**)engine->registeredEnums.AddressOf(), (asUINT)engine->registeredEnums.GetLength(), cachedEnums, &idx) )
 		{
-			// Enums or built-in primitives are passed by value
-			asASSERT( calledFunc->parameterTypes[p].IsPrimitive() );
-			currOffset += calledFunc->parameterTypes[p].GetSizeOnStackDWords();
+			WriteByte('e');
+			WriteUInt(idx);
+			WriteString(ot->name);
+			return;
 		}
 	}
-
-	return offset - numPtrs * (1 - AS_PTR_SIZE);
-}
-
-int asCReader::FindTypeId(int idx)
-{
-	if( idx >= 0 && idx < (int)usedTypeIds.GetLength() )
-		return usedTypeIds[idx];
-	else
+	else if( FindIndex(ot, (void**)engine->registeredObjTypes.AddressOf(), (asUINT)engine->registeredObjTypes.GetLength(), cachedObjTypes, &idx) )
 	{
-		// TODO: Write to message callback
-		error = true;
-		return 0;
+		WriteByte('o');
+		WriteUInt(idx);
+		WriteString(ot->name);
+		return;
+	}
+	else if( ot->templateSubTypes.GetLength() )
+	{
+		// Template instances and specializations are stored as the
+		// template type and the subtypes, so they can be looked up
+		// or instanciated again on the new engine
+		for( idx = 0; idx < engine->registeredObjTypes.GetLength(); idx++ )
+		{
+			asCObjectType *tmpl = engine->registeredObjTypes[idx];
+			if( tmpl && (tmpl->flags & asOBJ_TEMPLATE) && tmpl->name == ot->name )
+			{
+				WriteByte('t');
+				WriteUInt(idx);
+				WriteString(tmpl->name);
+				WriteUInt((asUINT)ot->templateSubTypes.GetLength());
+				for( asUINT n = 0; n < ot->templateSubTypes.GetLength(); n++ )
+					WriteDataType(ot->templateSubTypes[n]);
+				return;
+			}
+		}
 	}
+
+	// The type isn't part of the registered interface
+	entryFailed = true;
 }
 
-asCObjectType *asCReader::FindObjectType(int idx)
+bool asCConfigImage::FindIndex(void *ptr, void **arr, asUINT length, asUINT &cached, asUINT *idx)
 {
-	if( idx < 0 || idx >= (int)usedTypes.GetLength() )
-	{
-		// TODO: Write to message callback
-		error = true;
-		return 0;
-	}
+	// Add the entries that were registered since the previous look-up
+	for( ; cached < length; cached++ )
+		indexCache.Insert(arr[cached], cached);
 
-	return usedTypes[idx];
+	asSMapNode<void*, asUINT> *cursor = 0;
+	if( !indexCache.MoveTo(&cursor, ptr) )
+		return false;
+
+	*idx = indexCache.GetValue(cursor);
+	return true;
 }
 
 #ifndef AS_NO_COMPILER
@@ -2731,6 +3936,10 @@ asCObjectType *asCReader::FindObjectType(int idx)
 asCWriter::asCWriter(asCModule* _module, asIBinaryStream* _stream, asCScriptEngine* _engine, bool _stripDebug)
  : module(_module), stream(_stream), engine(_engine), stripDebugInfo(_stripDebug)
 {
+	isBundle = false;
+	sizedBodies = false;
+	inFunctionBody = false;
+	memset(&written, 0, sizeof(written));
 }
 
 void asCWriter::WriteData(const void *data, asUINT size)
@@ -2746,6 +3955,65 @@ void asCWriter::WriteData(const void *data, asUINT size)
 }
 
 int asCWriter::Write() 
+{
+	asCModule *mod = module;
+	return WriteModules(&mod, 1, false);
+}
+
+int asCWriter::WriteBundle(asCModule **modules, asUINT count)
+{
+	return WriteModules(modules, count, true);
+}
+
+int asCWriter::WriteModules(asCModule **modules, asUINT count, bool bundle)
+{
+	// The size of the function bodies is only needed for loading them on 
+	// demand, so it is only written when the application has asked for it
+	sizedBodies = engine->ep.lazyLoadFunctions;
+
+	asBYTE flags = 0;
+	if( sizedBodies )
+		flags |= BCF_SIZED_BODIES;
+	if( stripDebugInfo )
+		flags |= BCF_NO_DEBUG_INFO;
+	if( engine->ep.compressByteCode )
+		flags |= BCF_COMPRESSED;
+	if( bundle )
+		flags |= BCF_BUNDLE;
+	WriteData(&flags, 1);
+
+	// Everything after the flags is compressed
+	asIBinaryStream *outerStream = stream;
+	asCCompressStream compressor(outerStream);
+	if( flags & BCF_COMPRESSED )
+		stream = &compressor;
+
+	isBundle = bundle;
+	if( bundle )
+		WriteEncodedInt64(count);
+
+	for( asUINT n = 0; n < count; n++ )
+	{
+		module = modules[n];
+		if( bundle )
+			WriteString(&module->name);
+
+		WriteModule();
+
+		// The functions are only referred to within the module
+		savedFunctions.SetLength(0);
+	}
+
+	if( flags & BCF_COMPRESSED )
+	{
+		compressor.Flush();
+		stream = outerStream;
+	}
+
+	return asSUCCESS;
+}
+
+void asCWriter::WriteModule()
 {
 	unsigned long i, count;
 
@@ -2754,7 +4022,6 @@ int asCWriter::Write()
 	// TODO: Should be possible to skip saving the enum values. They are usually not needed after the script is compiled anyway
 	// TODO: Should be possible to skip saving the typedefs. They are usually not needed after the script is compiled anyway
 	// TODO: Should be possible to skip saving constants. They are usually not needed after the script is compiled anyway
-	WriteData(&stripDebugInfo, sizeof(stripDebugInfo));
 
 	// Store enums
 	count = (asUINT)module->enumTypes.GetLength();
@@ -2849,9 +4116,10 @@ int asCWriter::Write()
 
 	// usedTypes[]
 	count = (asUINT)usedTypes.GetLength();
-	WriteEncodedInt64(count);
-	for( i = 0; i < count; ++i )
+	WriteEncodedInt64(count - written.types);
+	for( i = written.types; i < count; ++i )
 		WriteObjectType(usedTypes[i]);
+	written.types = count;
 
 	// usedTypeIds[]
 	WriteUsedTypeIds();
@@ -2867,8 +4135,6 @@ int asCWriter::Write()
 
 	// usedObjectProperties[]
 	WriteUsedObjectProps();
-
-	return asSUCCESS;
 }
 
 int asCWriter::FindStringConstantIndex(int id)
@@ -2886,17 +4152,18 @@ int asCWriter::FindStringConstantIndex(int id)
 void asCWriter::WriteUsedStringConstants()
 {
 	asUINT count = (asUINT)usedStringConstants.GetLength();
-	WriteEncodedInt64(count);
-	for( asUINT i = 0; i < count; ++i )
+	WriteEncodedInt64(count - written.stringConstants);
+	for( asUINT i = written.stringConstants; i < count; ++i )
 		WriteString(engine->stringConstants[usedStringConstants[i]]);
+	written.stringConstants = count;
 }
 
 void asCWriter::WriteUsedFunctions()
 {
 	asUINT count = (asUINT)usedFunctions.GetLength();
-	WriteEncodedInt64(count);
+	WriteEncodedInt64(count - written.functions);
 
-	for( asUINT n = 0; n < usedFunctions.GetLength(); n++ )
+	for( asUINT n = written.functions; n < count; n++ )
 	{
 		char c;
 
@@ -2916,6 +4183,7 @@ void asCWriter::WriteUsedFunctions()
 			WriteData(&c, 1);
 		}
 	}
+	written.functions = count;
 }
 
 void asCWriter::WriteFunctionSignature(asCScriptFunction *func)
@@ -2992,115 +4260,161 @@ void asCWriter::WriteFunction(asCScriptFunction* func)
 		}
 	}
 
+	// Shared functions that were stored with a previous module in the bundle
+	bool isShared = isBundle && IsBundleSharedFunction(func);
+	if( isShared )
+	{
+		asSMapNode<asCScriptFunction*, asUINT> *cursor = 0;
+		if( bundleSharedFunctions.MoveTo(&cursor, func) )
+		{
+			savedFunctions.PushLast(func);
+
+			c = 's';
+			WriteData(&c, 1);
+			WriteEncodedInt64(bundleSharedFunctions.GetValue(cursor));
+			return;
+		}
+	}
+
 	// Keep a reference to the function in the list
 	savedFunctions.PushLast(func);
+	if( isShared )
+		bundleSharedFunctions.Insert(func, bundleSharedFunctions.GetCount());
 
 	c = 'f';
 	WriteData(&c, 1);
 
-	asUINT i, count;
-
 	WriteFunctionSignature(func);
 
 	if( func->funcType == asFUNC_SCRIPT )
 	{
-		// Calculate the adjustment by position lookup table
-		CalculateAdjustmentByPos(func);
-
-		WriteByteCode(func);
+		// The shared flag is needed by the reader before the body is loaded
+		if( sizedBodies )
+			WriteData(&func->isShared, 1);
 
-		asDWORD varSpace = AdjustStackPosition(func->variableSpace);
-		WriteEncodedInt64(varSpace);
+		WriteFunctionBody(func);
+	}
+	else if( func->funcType == asFUNC_VIRTUAL )
+	{
+		WriteEncodedInt64(func->vfTableIdx);
+	}
 
-		count = (asUINT)func->objVariablePos.GetLength();
-		WriteEncodedInt64(count);
-		for( i = 0; i < count; ++i )
+	// Store script section name
+	if( !stripDebugInfo )
+	{
+		if( func->scriptSectionIdx >= 0 )
+			WriteString(engine->scriptSectionNames[func->scriptSectionIdx]);
+		else
 		{
-			WriteObjectType(func->objVariableTypes[i]);
-			// TODO: Only write this if the object type is the builtin function type
-			WriteEncodedInt64(FindFunctionIndex(func->funcVariableTypes[i]));
-			WriteEncodedInt64(AdjustStackPosition(func->objVariablePos[i]));
+			char c = 0;
+			WriteData(&c, 1);
 		}
-		if( count > 0 )
-			WriteEncodedInt64(func->objVariablesOnHeap);
+	}
+}
+
+void asCWriter::WriteFunctionBody(asCScriptFunction *func)
+{
+	asUINT i, count;
+
+	// Sized bodies are written to a separate buffer so the size can be stored
+	// before it. This allows the reader to skip it and load it on the first
+	// call. The body may refer to the shared strings and data types, but 
+	// the ones it introduces are not shared with the rest of the bytecode
+	asCMemoryStream body;
+	asIBinaryStream *outerStream = stream;
+	if( sizedBodies )
+		stream = &body;
+	inFunctionBody = sizedBodies;
+
+	// Calculate the adjustment by position lookup table
+	CalculateAdjustmentByPos(func);
+
+	WriteByteCode(func);
+
+	asDWORD varSpace = AdjustStackPosition(func->variableSpace);
+	WriteEncodedInt64(varSpace);
+
+	count = (asUINT)func->objVariablePos.GetLength();
+	WriteEncodedInt64(count);
+	for( i = 0; i < count; ++i )
+	{
+		WriteObjectType(func->objVariableTypes[i]);
+		// TODO: Only write this if the object type is the builtin function type
+		WriteEncodedInt64(FindFunctionIndex(func->funcVariableTypes[i]));
+		WriteEncodedInt64(AdjustStackPosition(func->objVariablePos[i]));
+	}
+	if( count > 0 )
+		WriteEncodedInt64(func->objVariablesOnHeap);
+
+	WriteEncodedInt64((asUINT)func->objVariableInfo.GetLength());
+	for( i = 0; i < func->objVariableInfo.GetLength(); ++i )
+	{
+		// The program position must be adjusted to be in number of instructions
+		WriteEncodedInt64(bytecodeNbrByPos[func->objVariableInfo[i].programPos]);
+		WriteEncodedInt64(AdjustStackPosition(func->objVariableInfo[i].variableOffset));
+		WriteEncodedInt64(func->objVariableInfo[i].option);
+	}
 
-		WriteEncodedInt64((asUINT)func->objVariableInfo.GetLength());
-		for( i = 0; i < func->objVariableInfo.GetLength(); ++i )
+	// The program position (every even number) needs to be adjusted
+	// to be in number of instructions instead of DWORD offset
+	if( !stripDebugInfo )
+	{
+		asUINT length = (asUINT)func->lineNumbers.GetLength();
+		WriteEncodedInt64(length);
+		for( i = 0; i < length; ++i )
 		{
-			// The program position must be adjusted to be in number of instructions
-			WriteEncodedInt64(bytecodeNbrByPos[func->objVariableInfo[i].programPos]);
-			WriteEncodedInt64(AdjustStackPosition(func->objVariableInfo[i].variableOffset));
-			WriteEncodedInt64(func->objVariableInfo[i].option);
+			if( (i & 1) == 0 )
+				WriteEncodedInt64(bytecodeNbrByPos[func->lineNumbers[i]]);
+			else
+				WriteEncodedInt64(func->lineNumbers[i]);
 		}
 
-		// The program position (every even number) needs to be adjusted
-		// to be in number of instructions instead of DWORD offset
-		if( !stripDebugInfo )
+		// Write the array of script sections
+		length = (asUINT)func->sectionIdxs.GetLength();
+		WriteEncodedInt64(length);
+		for( i = 0; i < length; ++i )
 		{
-			asUINT length = (asUINT)func->lineNumbers.GetLength();
-			WriteEncodedInt64(length);
-			for( i = 0; i < length; ++i )
-			{
-				if( (i & 1) == 0 )
-					WriteEncodedInt64(bytecodeNbrByPos[func->lineNumbers[i]]);
-				else
-					WriteEncodedInt64(func->lineNumbers[i]);
-			}
-
-			// Write the array of script sections
-			length = (asUINT)func->sectionIdxs.GetLength();
-			WriteEncodedInt64(length);
-			for( i = 0; i < length; ++i )
+			if( (i & 1) == 0 )
+				WriteEncodedInt64(bytecodeNbrByPos[func->sectionIdxs[i]]);
+			else
 			{
-				if( (i & 1) == 0 )
-					WriteEncodedInt64(bytecodeNbrByPos[func->sectionIdxs[i]]);
+				if( func->sectionIdxs[i] >= 0 )
+					WriteString(engine->scriptSectionNames[func->sectionIdxs[i]]);
 				else
 				{
-					if( func->sectionIdxs[i] >= 0 )
-						WriteString(engine->scriptSectionNames[func->sectionIdxs[i]]);
-					else
-					{
-						char c = 0;
-						WriteData(&c, 1);
-					}
+					char c = 0;
+					WriteData(&c, 1);
 				}
 			}
 		}
+	}
 
-		WriteData(&func->isShared, 1);
+	WriteData(&func->isShared, 1);
 
-		// Write the variable information
-		if( !stripDebugInfo )
+	// Write the variable information
+	if( !stripDebugInfo )
+	{
+		WriteEncodedInt64((asUINT)func->variables.GetLength());
+		for( i = 0; i < func->variables.GetLength(); i++ )
 		{
-			WriteEncodedInt64((asUINT)func->variables.GetLength());
-			for( i = 0; i < func->variables.GetLength(); i++ )
-			{
-				// The program position must be adjusted to be in number of instructions
-				WriteEncodedInt64(bytecodeNbrByPos[func->variables[i]->declaredAtProgramPos]);
-				// The stack position must be adjusted according to the pointer sizes
-				WriteEncodedInt64(AdjustStackPosition(func->variables[i]->stackOffset));
-				WriteString(&func->variables[i]->name);
-				WriteDataType(&func->variables[i]->type);
-			}
+			// The program position must be adjusted to be in number of instructions
+			WriteEncodedInt64(bytecodeNbrByPos[func->variables[i]->declaredAtProgramPos]);
+			// The stack position must be adjusted according to the pointer sizes
+			WriteEncodedInt64(AdjustStackPosition(func->variables[i]->stackOffset));
+			WriteString(&func->variables[i]->name);
+			WriteDataType(&func->variables[i]->type);
 		}
-
-		WriteData(&func->dontCleanUpOnException, 1);
-	}
-	else if( func->funcType == asFUNC_VIRTUAL )
-	{
-		WriteEncodedInt64(func->vfTableIdx);
 	}
 
-	// Store script section name
-	if( !stripDebugInfo )
+	WriteData(&func->dontCleanUpOnException, 1);
+
+	inFunctionBody = false;
+	if( sizedBodies )
 	{
-		if( func->scriptSectionIdx >= 0 )
-			WriteString(engine->scriptSectionNames[func->scriptSectionIdx]);
-		else
-		{
-			char c = 0;
-			WriteData(&c, 1);
-		}
+		stream = outerStream;
+		WriteEncodedInt64(body.buffer.GetLength());
+		if( body.buffer.GetLength() )
+			stream->Write(body.buffer.AddressOf(), (asUINT)body.buffer.GetLength());
 	}
 }
 
@@ -3306,8 +4620,11 @@ void asCWriter::WriteString(asCString* str)
 	WriteEncodedInt64(len);
 	stream->Write(str->AddressOf(), (asUINT)len);
 
-	savedStrings.PushLast(*str);
-	stringToIdMap.Insert(asCStringPointer(str), int(savedStrings.GetLength()) - 1);
+	if( !inFunctionBody )
+	{
+		savedStrings.PushLast(*str);
+		stringToIdMap.Insert(asCStringPointer(str), int(savedStrings.GetLength()) - 1);
+	}
 }
 
 void asCWriter::WriteGlobalProperty(asCGlobalProperty* prop) 
@@ -3355,7 +4672,8 @@ void asCWriter::WriteDataType(const asCDataType *dt)
 	}
 
 	// Save the new datatype
-	savedDataTypes.PushLast(*dt);
+	if( !inFunctionBody )
+		savedDataTypes.PushLast(*dt);
 
 	bool b;
 	int t = dt->GetTokenType();
@@ -3568,6 +4886,7 @@ int asCWriter::AdjustGetOffset(int offset, asCScriptFunction *func, asDWORD prog
 	{
 		asBYTE bc = *(asBYTE*)&func->byteCode[n];
 		if( bc == asBC_CALL ||
+			bc == asBC_TAILCALL ||
 			bc == asBC_CALLSYS ||
 			bc == asBC_CALLINTF )
 		{
@@ -3762,6 +5081,7 @@ void asCWriter::WriteByteCode(asCScriptFunction *func)
 			asBC_WORDARG0(tmp) = 0;
 		}
 		else if( c == asBC_CALL ||     // DW_ARG
+				 c == asBC_TAILCALL || // DW_ARG
 				 c == asBC_CALLINTF || // DW_ARG
 				 c == asBC_CALLSYS )   // DW_ARG
 		{
@@ -4054,12 +5374,13 @@ void asCWriter::WriteByteCode(asCScriptFunction *func)
 void asCWriter::WriteUsedTypeIds()
 {
 	asUINT count = (asUINT)usedTypeIds.GetLength();
-	WriteEncodedInt64(count);
-	for( asUINT n = 0; n < count; n++ )
+	WriteEncodedInt64(count - written.typeIds);
+	for( asUINT n = written.typeIds; n < count; n++ )
 	{
 		asCDataType dt = engine->GetDataTypeFromTypeId(usedTypeIds[n]);
 		WriteDataType(&dt);
 	}
+	written.typeIds = count;
 }
 
 int asCWriter::FindGlobalPropPtrIndex(void *ptr)
@@ -4073,10 +5394,10 @@ int asCWriter::FindGlobalPropPtrIndex(void *ptr)
 
 void asCWriter::WriteUsedGlobalProps()
 {
-	int c = (int)usedGlobalProperties.GetLength();
-	WriteEncodedInt64(c);
+	asUINT c = (asUINT)usedGlobalProperties.GetLength();
+	WriteEncodedInt64(c - written.globalProps);
 
-	for( int n = 0; n < c; n++ )
+	for( asUINT n = written.globalProps; n < c; n++ )
 	{
 		asPWORD *p = (asPWORD*)usedGlobalProperties[n];
 		
@@ -4118,14 +5439,15 @@ void asCWriter::WriteUsedGlobalProps()
 		// Also store whether the property is a module property or a registered property
 		WriteData(&moduleProp, 1);
 	}
+	written.globalProps = c;
 }
 
 void asCWriter::WriteUsedObjectProps()
 {
-	int c = (int)usedObjectProperties.GetLength();
-	WriteEncodedInt64(c);
+	asUINT c = (asUINT)usedObjectProperties.GetLength();
+	WriteEncodedInt64(c - written.objectProps);
 
-	for( asUINT n = 0; n < usedObjectProperties.GetLength(); n++ )
+	for( asUINT n = written.objectProps; n < c; n++ )
 	{
 		asCObjectType *objType = usedObjectProperties[n].objType;
 		WriteObjectType(objType);
@@ -4140,6 +5462,7 @@ void asCWriter::WriteUsedObjectProps()
 			}
 		}
 	}
+	written.objectProps = c;
 }
 
 int asCWriter::FindObjectPropIndex(short offset, int typeId)
@@ -42,29 +42,106 @@
 #include "as_scriptengine.h"
 #include "as_context.h"
 #include "as_map.h"
+#include "as_criticalsection.h"
 
 BEGIN_AS_NAMESPACE
 
+// The first byte of the saved bytecode holds these flags. Older
+// versions only stored a bool telling if the debug info was stripped
+enum EByteCodeFlags
+{
+	BCF_NO_DEBUG_INFO  = 1,
+	BCF_SIZED_BODIES   = 2,
+	BCF_COMPRESSED     = 4,
+	BCF_BUNDLE         = 8
+};
+
+// Stream used to hold the function bodies in memory
+class asCMemoryStream : public asIBinaryStream
+{
+public:
+	asCMemoryStream();
+
+	void Write(const void *ptr, asUINT size);
+	void Read(void *ptr, asUINT size);
+
+	asCArray<asBYTE> buffer;
+	asUINT           readPos;
+	bool             readPastEnd;
+};
+
+// When asEP_COMPRESS_BYTECODE is set everything after the flags is stored in
+// blocks compressed with a simple LZ77 scheme that is quick to decompress
+class asCCompressStream : public asIBinaryStream
+{
+public:
+	asCCompressStream(asIBinaryStream *out);
+
+	void Write(const void *ptr, asUINT size);
+	void Read(void *ptr, asUINT size);
+	void Flush();
+
+protected:
+	void CompressBlock();
+
+	asIBinaryStream  *out;
+	asCArray<asBYTE>  block;
+	asCArray<asBYTE>  compressed;
+};
+
+class asCDecompressStream : public asIBinaryStream
+{
+public:
+	asCDecompressStream(asIBinaryStream *in);
+
+	void Write(const void *ptr, asUINT size);
+	void Read(void *ptr, asUINT size);
+
+	bool failed;
+
+protected:
+	bool DecompressBlock();
+
+	asIBinaryStream  *in;
+	asCArray<asBYTE>  block;
+	asCArray<asBYTE>  compressed;
+	asUINT            readPos;
+};
+
 class asCReader
 {
 public:
 	asCReader(asCModule *module, asIBinaryStream *stream, asCScriptEngine *engine);
+	~asCReader();
 
 	int Read(bool *wasDebugInfoStripped);
+	int ReadBundle(bool *wasDebugInfoStripped);
+
+	// Used when the module was loaded with asEP_LAZY_LOAD_FUNCTIONS
+	bool HasPendingBodies() const;
+	int  LoadFunctionBody(asCScriptFunction *func);
 
 protected:
 	asCModule       *module;
 	asIBinaryStream *stream;
 	asCScriptEngine *engine;
 	bool             noDebugInfo;
+	bool             sizedBodies;
+	bool             isBundle;
+	bool             inFunctionBody;
 	bool             error;
 
+	asCDecompressStream decompressor;
+
+	int                ReadFlags(bool bundle);
+	int                ReadModule();
 	int                ReadInner();
 
 	void               ReadData(void *data, asUINT size);
 	void               ReadString(asCString *str);
 	asCScriptFunction *ReadFunction(bool &isNew, bool addToModule = true, bool addToEngine = true, bool addToGC = true);
 	void               ReadFunctionSignature(asCScriptFunction *func);
+	void               ReadFunctionBody(asCScriptFunction *func);
 	void               ReadGlobalProperty();
 	void               ReadObjectProperty(asCObjectType *ot);
 	void               ReadDataType(asCDataType *dt);
@@ -92,7 +169,6 @@ protected:
 	int  AdjustStackPosition(int pos);
 	int  AdjustGetOffset(int offset, asCScriptFunction *func, asDWORD programPos);
 	void CalculateStackNeeded(asCScriptFunction *func);
-	asCScriptFunction *GetCalledFunction(asCScriptFunction *func, asDWORD programPos);
 
 	// Temporary storage for persisting variable data
 	asCArray<int>                usedTypeIds;
@@ -117,6 +193,95 @@ protected:
 
 	asCMap<void*,bool>              existingShared;
 	asCMap<asCScriptFunction*,bool> dontTranslate;
+
+	// The shared functions that have been loaded with the previous modules in the
+	// bundle, and the savedFunctions slots of the ones loaded with the current module
+	asCArray<asCScriptFunction*>    bundleSharedFunctions;
+	asCArray<asUINT>                bundleSharedSlots;
+
+	// The bodies of the functions that will be loaded on the first call.
+	// The map holds the offset of each function's body in the buffer
+	asCMemoryStream                   pendingBodies;
+	asCMap<asCScriptFunction*,asUINT> pendingBodyOffsets;
+	bool                              holdsUsedReferences;
+	DECLARECRITICALSECTION(pendingCritical)
+};
+
+// The config image stores the parsed result of the declarations given to the
+// Register methods so that a new engine configured with the same application
+// interface can skip the parsing and validation of each declaration. The
+// entries are keyed on a hash of the registration call, and the types they
+// refer to are stored as indices in the engine's registered type arrays,
+// which is why the application must perform the registration in the same order.
+class asCConfigImage
+{
+public:
+	asCConfigImage(asCScriptEngine *engine);
+	~asCConfigImage();
+
+	enum EEntryKind
+	{
+		GLOBAL_FUNCTION = 1,
+		GLOBAL_PROPERTY,
+		OBJECT_METHOD,
+		OBJECT_BEHAVIOUR,
+		OBJECT_PROPERTY,
+		FUNCDEF
+	};
+
+	int  Save(asIBinaryStream *stream) const;
+	int  Load(asIBinaryStream *stream);
+	void Invalidate();
+
+	asQWORD GetKey(EEntryKind kind, const char *obj, const char *decl, int behaviour = 0) const;
+
+	// Restoring from a loaded image
+	bool FindEntry(asQWORD key);
+	bool RestoreObjectType(asCObjectType **ot);
+	bool RestoreFunction(asCScriptFunction *func, asCArray<bool> *paramAutoHandles, bool *returnAutoHandle);
+	bool RestoreProperty(asCString &name, asCDataType &type);
+
+	// Recording the registrations made on this engine
+	void RecordFunction(asQWORD key, asCObjectType *ot, asCScriptFunction *func);
+	void RecordProperty(asQWORD key, asCObjectType *ot, const asCString &name, const asCDataType &type);
+
+protected:
+	asCScriptEngine *engine;
+	bool             isInvalid;
+
+	// Loaded image
+	asCArray<asBYTE>          image;
+	asCMap<asQWORD, asUINT>   entries;
+	asUINT                    readPos;
+	asUINT                    readEnd;
+
+	bool    ReadByte(asBYTE *b);
+	bool    ReadUInt(asUINT *v);
+	bool    ReadString(asCString *str);
+	bool    ReadName(const asCString &name);
+	bool    ReadDataType(asCDataType *dt);
+	bool    ReadObjectTypeRef(asCObjectType **ot, asCScriptFunction **funcDef);
+
+	// Recorded entries
+	asCArray<asBYTE>          recorded;
+	asUINT                    numRecorded;
+	asCArray<asBYTE>          current;
+	bool                      entryFailed;
+	asCMap<void*, asUINT>     indexCache;
+	asUINT                    cachedObjTypes;
+	asUINT                    cachedEnums;
+	asUINT                    cachedFuncDefs;
+	asUINT                    cachedSubTypes;
+
+	bool    IsRecording() const;
+	void    BeginEntry(asQWORD key);
+	void    EndEntry();
+	void    WriteByte(asBYTE b);
+	void    WriteUInt(asUINT v);
+	void    WriteString(const asCString &str);
+	void    WriteDataType(const asCDataType &dt);
+	void    WriteObjectTypeRef(asCObjectType *ot, asCScriptFunction *funcDef);
+	bool    FindIndex(void *ptr, void **arr, asUINT length, asUINT &cached, asUINT *idx);
 };
 
 #ifndef AS_NO_COMPILER
@@ -127,18 +292,26 @@ public:
 	asCWriter(asCModule *module, asIBinaryStream *stream, asCScriptEngine *engine, bool stripDebugInfo);
 
 	int Write();
+	int WriteBundle(asCModule **modules, asUINT count);
 
 protected:
 	asCModule       *module;
 	asIBinaryStream *stream;
 	asCScriptEngine *engine;
 	bool             stripDebugInfo;
+	bool             isBundle;
+	bool             sizedBodies;
+	bool             inFunctionBody;
+
+	int  WriteModules(asCModule **modules, asUINT count, bool bundle);
+	void WriteModule();
 
 	void WriteData(const void *data, asUINT size);
 
 	void WriteString(asCString *str);
 	void WriteFunction(asCScriptFunction *func);
 	void WriteFunctionSignature(asCScriptFunction *func);
+	void WriteFunctionBody(asCScriptFunction *func);
 	void WriteGlobalProperty(asCGlobalProperty *prop);
 	void WriteObjectProperty(asCObjectProperty *prop);
 	void WriteDataType(const asCDataType *dt);
@@ -189,6 +362,20 @@ protected:
 		int            offset;
 	};
 	asCArray<SObjProp>           usedObjectProperties;
+
+	// The modules in a bundle share the tables above, so each 
+	// module only stores the entries added since the previous one
+	struct SWrittenCounts
+	{
+		asUINT types;
+		asUINT typeIds;
+		asUINT functions;
+		asUINT globalProps;
+		asUINT stringConstants;
+		asUINT objectProps;
+	};
+	SWrittenCounts                      written;
+	asCMap<asCScriptFunction*, asUINT>  bundleSharedFunctions;
 };
 
 #endif
@@ -353,6 +353,26 @@ int asCScriptEngine::SetEngineProperty(asEEngineProp property, asPWORD value)
 		ep.disallowValueAssignForRefType = value ? true : false;
 		break;
 
+	case asEP_RECORD_CONFIG_IMAGE:
+		ep.recordConfigImage = value ? true : false;
+		break;
+
+	case asEP_LAZY_LOAD_FUNCTIONS:
+		ep.lazyLoadFunctions = value ? true : false;
+		break;
+
+	case asEP_COMPRESS_BYTECODE:
+		ep.compressByteCode = value ? true : false;
+		break;
+
+	case asEP_VERIFY_BYTECODE:
+		ep.verifyByteCode = value ? true : false;
+		break;
+
+	case asEP_ELIMINATE_TAIL_CALLS:
+		ep.eliminateTailCalls = value ? true : false;
+		break;
+
 	default:
 		return asINVALID_ARG;
 	}
@@ -423,6 +443,21 @@ asPWORD asCScriptEngine::GetEngineProperty(asEEngineProp property) const
 
 	case asEP_DISALLOW_VALUE_ASSIGN_FOR_REF_TYPE:
 		return ep.disallowValueAssignForRefType;
+
+	case asEP_RECORD_CONFIG_IMAGE:
+		return ep.recordConfigImage;
+
+	case asEP_LAZY_LOAD_FUNCTIONS:
+		return ep.lazyLoadFunctions;
+
+	case asEP_COMPRESS_BYTECODE:
+		return ep.compressByteCode;
+
+	case asEP_VERIFY_BYTECODE:
+		return ep.verifyByteCode;
+
+	case asEP_ELIMINATE_TAIL_CALLS:
+		return ep.eliminateTailCalls;
 	}
 
 	return 0;
@@ -457,6 +492,11 @@ asCScriptEngine::asCScriptEngine()
 		ep.compilerWarnings              = 1;         // 0 = no warnings, 1 = warning, 2 = treat as error
 		// TODO: 3.0.0: disallowValueAssignForRefType should be true by default
 		ep.disallowValueAssignForRefType = false;
+		ep.recordConfigImage             = false;
+		ep.lazyLoadFunctions             = false;
+		ep.compressByteCode              = false;
+		ep.verifyByteCode                = false;
+		ep.eliminateTailCalls            = false;
 	}
 
 	gc.engine = this;
@@ -464,6 +504,8 @@ asCScriptEngine::asCScriptEngine()
 
 	refCount.set(1);
 	stringFactory = 0;
+	stringConstantCallback = 0;
+	stringConstantParam = 0;
 	configFailed = false;
 	isPrepared = false;
 	isBuilding = false;
@@ -483,7 +525,10 @@ asCScriptEngine::asCScriptEngine()
 	currentGroup      = &defaultGroup;
 	defaultAccessMask = 1;
 
+	configImage = asNEW(asCConfigImage)(this);
+
 	msgCallback = 0;
+	asyncCallback = 0;
     jitCompiler = 0;
 
 	// Create the global namespace
@@ -707,11 +752,15 @@ asCScriptEngine::~asCScriptEngine()
 		}
 	funcDefs.SetLength(0);
 
+	asDELETE(configImage, asCConfigImage);
+	configImage = 0;
+
 	// Free string constants
 	for( n = 0; n < stringConstants.GetLength(); n++ )
 		asDELETE(stringConstants[n],asCString);
 	stringConstants.SetLength(0);
 	stringToIdMap.EraseAll();
+	stringConstantObjects.SetLength(0);
 
 	// Free the script section names
 	for( n = 0; n < scriptSectionNames.GetLength(); n++ )
@@ -939,6 +988,51 @@ int asCScriptEngine::WriteMessage(const char *section, int row, int col, asEMsgT
 	return 0;
 }
 
+// interface
+int asCScriptEngine::SetAsyncCallCallback(const asSFuncPtr &callback, void *obj, asDWORD callConv)
+{
+	asyncCallback = true;
+	asyncCallbackObj = obj;
+	bool isObj = false;
+	if( (unsigned)callConv == asCALL_GENERIC )
+	{
+		asyncCallback = false;
+		return asNOT_SUPPORTED;
+	}
+	if( (unsigned)callConv >= asCALL_THISCALL )
+	{
+		isObj = true;
+		if( obj == 0 )
+		{
+			asyncCallback = false;
+			return asINVALID_ARG;
+		}
+	}
+	int r = DetectCallingConvention(isObj, callback, callConv, 0, &asyncCallbackFunc);
+	if( r < 0 ) asyncCallback = false;
+	return r;
+}
+
+// interface
+int asCScriptEngine::ClearAsyncCallCallback()
+{
+	asyncCallback = false;
+	return 0;
+}
+
+// internal
+// This may be called from any thread, i.e. the one that completed the asynchronous call
+void asCScriptEngine::CallAsyncCallCallback(asIScriptContext *ctx)
+{
+	if( !asyncCallback )
+		return;
+
+	if( asyncCallbackFunc.callConv < ICC_THISCALL )
+		CallGlobalFunction(ctx, asyncCallbackObj, &asyncCallbackFunc, 0);
+	else
+		CallObjectMethod(asyncCallbackObj, ctx, &asyncCallbackFunc, 0);
+}
+
 int asCScriptEngine::SetJITCompiler(asIJITCompiler *compiler)
 {
     jitCompiler = compiler;
@@ -1005,6 +1099,59 @@ int asCScriptEngine::DiscardModule(const char *module)
 	return 0;
 }
 
+// interface
+int asCScriptEngine::SaveByteCodeBundle(asIScriptModule **modules, asUINT count, asIBinaryStream *out, bool stripDebugInfo) const
+{
+#ifdef AS_NO_COMPILER
+	UNUSED_VAR(modules);
+	UNUSED_VAR(count);
+	UNUSED_VAR(out);
+	UNUSED_VAR(stripDebugInfo);
+	return asNOT_SUPPORTED;
+#else
+	if( modules == 0 || out == 0 ) return asINVALID_ARG;
+
+	asCArray<asCModule*> mods;
+	mods.Allocate(count, false);
+	for( asUINT n = 0; n < count; n++ )
+	{
+		asCModule *mod = reinterpret_cast<asCModule*>(modules[n]);
+		if( mod == 0 || mod->engine != this )
+			return asINVALID_ARG;
+
+		// Load the bodies of the functions that haven't been called yet
+		if( mod->LoadAllFunctionBodies() < 0 )
+			return asERROR;
+
+		mods.PushLast(mod);
+	}
+
+	asCWriter write(0, out, const_cast<asCScriptEngine*>(this), stripDebugInfo);
+	return write.WriteBundle(mods.AddressOf(), count);
+#endif
+}
+
+// interface
+int asCScriptEngine::LoadByteCodeBundle(asIBinaryStream *in, bool *wasDebugInfoStripped)
+{
+	if( in == 0 ) return asINVALID_ARG;
+
+	// Only permit loading bytecode if no other thread is currently compiling
+	int r = RequestBuild();
+	if( r < 0 )
+		return r;
+
+	// The modules are created with the names they were saved with. All of
+	// them are loaded with the same reader so the symbols they have in 
+	// common only have to be resolved once
+	asCReader read(0, in, this);
+	r = read.ReadBundle(wasDebugInfoStripped);
+
+	BuildCompleted();
+
+	return r;
+}
+
 // internal
 int asCScriptEngine::ClearUnusedTypes()
 {
@@ -1260,20 +1407,36 @@ int asCScriptEngine::RegisterObjectProperty(const char *obj, const char *declara
 {
 	int r;
 	asCDataType dt;
-	asCBuilder bld(this, 0);
-	r = bld.ParseDataType(obj, &dt, defaultNamespace);
-	if( r < 0 )
-		return ConfigError(r, "RegisterObjectProperty", obj, declaration);
-
-	// Verify that the correct config group is used
-	if( currentGroup->FindType(dt.GetObjectType()->name.AddressOf()) == 0 )
-		return ConfigError(asWRONG_CONFIG_GROUP, "RegisterObjectProperty", obj, declaration);
-
 	asCDataType type;
 	asCString name;
 
-	if( (r = bld.VerifyProperty(&dt, declaration, name, type, 0)) < 0 )
-		return ConfigError(r, "RegisterObjectProperty", obj, declaration);
+	// If the declaration is in the loaded config image it doesn't have to be parsed and verified again
+	asQWORD imageKey = configImage->GetKey(asCConfigImage::OBJECT_PROPERTY, obj, declaration);
+	asCObjectType *ot = 0;
+	if( configImage->FindEntry(imageKey) &&
+		configImage->RestoreObjectType(&ot) &&
+		configImage->RestoreProperty(name, type) )
+	{
+		dt = asCDataType::CreateObject(ot, false);
+
+		// Verify that the correct config group is used
+		if( currentGroup->FindType(ot->name.AddressOf()) == 0 )
+			return ConfigError(asWRONG_CONFIG_GROUP, "RegisterObjectProperty", obj, declaration);
+	}
+	else
+	{
+		asCBuilder bld(this, 0);
+		r = bld.ParseDataType(obj, &dt, defaultNamespace);
+		if( r < 0 )
+			return ConfigError(r, "RegisterObjectProperty", obj, declaration);
+
+		// Verify that the correct config group is used
+		if( currentGroup->FindType(dt.GetObjectType()->name.AddressOf()) == 0 )
+			return ConfigError(asWRONG_CONFIG_GROUP, "RegisterObjectProperty", obj, declaration);
+
+		if( (r = bld.VerifyProperty(&dt, declaration, name, type, 0)) < 0 )
+			return ConfigError(r, "RegisterObjectProperty", obj, declaration);
+	}
 
 	// Store the property info
 	if( dt.GetObjectType() == 0 )
@@ -1301,6 +1464,8 @@ int asCScriptEngine::RegisterObjectProperty(const char *obj, const char *declara
 
 	currentGroup->RefConfigGroup(FindConfigGroupForObjectType(type.GetObjectType()));
 
+	configImage->RecordProperty(imageKey, dt.GetObjectType(), name, type);
+
 	return asSUCCESS;
 }
 
@@ -1715,23 +1880,35 @@ int asCScriptEngine::RegisterObjectBehaviour(const char *datatype, asEBehaviours
 	if( datatype == 0 ) return ConfigError(asINVALID_ARG, "RegisterObjectBehaviour", datatype, decl);
 
 	// Determine the object type
-	asCBuilder bld(this, 0);
-	asCDataType type;
-	int r = bld.ParseDataType(datatype, &type, defaultNamespace);
-	if( r < 0 )
-		return ConfigError(r, "RegisterObjectBehaviour", datatype, decl);
+	asQWORD imageKey = configImage->GetKey(asCConfigImage::OBJECT_BEHAVIOUR, datatype, decl, behaviour);
+	asCObjectType *ot = 0;
+	bool fromImage = configImage->FindEntry(imageKey) && configImage->RestoreObjectType(&ot);
+	if( !fromImage )
+	{
+		asCBuilder bld(this, 0);
+		asCDataType type;
+		int r = bld.ParseDataType(datatype, &type, defaultNamespace);
+		if( r < 0 )
+			return ConfigError(r, "RegisterObjectBehaviour", datatype, decl);
+
+		if( type.GetObjectType() == 0 )
+			return ConfigError(asINVALID_TYPE, "RegisterObjectBehaviour", datatype, decl);
 
-	if( type.GetObjectType() == 0 )
-		return ConfigError(asINVALID_TYPE, "RegisterObjectBehaviour", datatype, decl);
+		if( type.IsReadOnly() || type.IsReference() )
+			return ConfigError(asINVALID_TYPE, "RegisterObjectBehaviour", datatype, decl);
+
+		ot = type.GetObjectType();
+	}
 
-	if( type.IsReadOnly() || type.IsReference() )
-		return ConfigError(asINVALID_TYPE, "RegisterObjectBehaviour", datatype, decl);
+	int r = RegisterBehaviourToObjectType(ot, behaviour, decl, funcPointer, callConv, fromImage);
+	if( r >= 0 )
+		configImage->RecordFunction(imageKey, ot, scriptFunctions[r]);
 
-	return RegisterBehaviourToObjectType(type.GetObjectType(), behaviour, decl, funcPointer, callConv);
+	return r;
 }
 
 // internal
-int asCScriptEngine::RegisterBehaviourToObjectType(asCObjectType *objectType, asEBehaviours behaviour, const char *decl, const asSFuncPtr &funcPointer, asDWORD callConv)
+int asCScriptEngine::RegisterBehaviourToObjectType(asCObjectType *objectType, asEBehaviours behaviour, const char *decl, const asSFuncPtr &funcPointer, asDWORD callConv, bool fromImage)
 {
 	asSSystemFunctionInterface internal;
 	if( behaviour == asBEHAVE_FACTORY ||
@@ -1771,10 +1948,13 @@ int asCScriptEngine::RegisterBehaviourToObjectType(asCObjectType *objectType, as
 	// Verify function declaration
 	asCScriptFunction func(this, 0, asFUNC_DUMMY);
 
-	asCBuilder bld(this, 0);
-	int r = bld.ParseFunctionDeclaration(objectType, decl, &func, true, &internal.paramAutoHandles, &internal.returnAutoHandle);
-	if( r < 0 )
-		return ConfigError(asINVALID_DECLARATION, "RegisterObjectBehaviour", objectType->name.AddressOf(), decl);
+	if( !fromImage || !configImage->RestoreFunction(&func, &internal.paramAutoHandles, &internal.returnAutoHandle) )
+	{
+		asCBuilder bld(this, 0);
+		int r = bld.ParseFunctionDeclaration(objectType, decl, &func, true, &internal.paramAutoHandles, &internal.returnAutoHandle);
+		if( r < 0 )
+			return ConfigError(asINVALID_DECLARATION, "RegisterObjectBehaviour", objectType->name.AddressOf(), decl);
+	}
 	func.name.Format("_beh_%d_", behaviour);
 
 	if( behaviour != asBEHAVE_FACTORY && behaviour != asBEHAVE_LIST_FACTORY )
@@ -1790,7 +1970,7 @@ int asCScriptEngine::RegisterBehaviourToObjectType(asCObjectType *objectType, as
 				if( func.returnType.IsObjectHandle() )
 					objectType->acceptValueSubType = false;
 				else if( !func.returnType.IsReference() )
-					objectType->acceptRefSubType = false;
+					objectType->returnsSubTypeByValue = true;
 			}
 
 			for( asUINT n = 0; n < func.parameterTypes.GetLength(); n++ )
@@ -2223,10 +2403,16 @@ int asCScriptEngine::RegisterGlobalProperty(const char *declaration, void *point
 	asCDataType type;
 	asCString name;
 
-	int r;
-	asCBuilder bld(this, 0);
-	if( (r = bld.VerifyProperty(0, declaration, name, type, defaultNamespace)) < 0 )
-		return ConfigError(r, "RegisterGlobalProperty", declaration, 0);
+	// If the declaration is in the loaded config image it doesn't have to be parsed and verified again
+	asQWORD imageKey = configImage->GetKey(asCConfigImage::GLOBAL_PROPERTY, 0, declaration);
+	if( !configImage->FindEntry(imageKey) ||
+		!configImage->RestoreProperty(name, type) )
+	{
+		int r;
+		asCBuilder bld(this, 0);
+		if( (r = bld.VerifyProperty(0, declaration, name, type, defaultNamespace)) < 0 )
+			return ConfigError(r, "RegisterGlobalProperty", declaration, 0);
+	}
 
 	// Don't allow registering references as global properties
 	if( type.IsReference() )
@@ -2252,6 +2438,8 @@ int asCScriptEngine::RegisterGlobalProperty(const char *declaration, void *point
 		currentGroup->RefConfigGroup(group);
 	}
 
+	configImage->RecordProperty(imageKey, 0, name, type);
+
 	return asSUCCESS;
 }
 
@@ -2370,20 +2558,32 @@ int asCScriptEngine::RegisterObjectMethod(const char *obj, const char *declarati
 		return ConfigError(asINVALID_ARG, "RegisterObjectMethod", obj, declaration);
 
 	// Determine the object type
-	asCDataType dt;
-	asCBuilder bld(this, 0);
-	int r = bld.ParseDataType(obj, &dt, defaultNamespace);
-	if( r < 0 )
-		return ConfigError(r, "RegisterObjectMethod", obj, declaration);
+	asQWORD imageKey = configImage->GetKey(asCConfigImage::OBJECT_METHOD, obj, declaration);
+	asCObjectType *ot = 0;
+	bool fromImage = configImage->FindEntry(imageKey) && configImage->RestoreObjectType(&ot);
+	if( !fromImage )
+	{
+		asCDataType dt;
+		asCBuilder bld(this, 0);
+		int r = bld.ParseDataType(obj, &dt, defaultNamespace);
+		if( r < 0 )
+			return ConfigError(r, "RegisterObjectMethod", obj, declaration);
 
-	if( dt.GetObjectType() == 0 )
-		return ConfigError(asINVALID_ARG, "RegisterObjectMethod", obj, declaration);
+		if( dt.GetObjectType() == 0 )
+			return ConfigError(asINVALID_ARG, "RegisterObjectMethod", obj, declaration);
 
-	return RegisterMethodToObjectType(dt.GetObjectType(), declaration, funcPointer, callConv);
+		ot = dt.GetObjectType();
+	}
+
+	int r = RegisterMethodToObjectType(ot, declaration, funcPointer, callConv, fromImage);
+	if( r >= 0 )
+		configImage->RecordFunction(imageKey, ot, scriptFunctions[r]);
+
+	return r;
 }
 
 // internal
-int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv)
+int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, bool fromImage)
 {
 	asSSystemFunctionInterface internal;
 	int r = DetectCallingConvention(true, funcPointer, callConv, 0, &internal);
@@ -2419,36 +2619,41 @@ int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const
 	func->sysFuncIntf = newInterface;
 	func->objectType  = objectType;
 
-	asCBuilder bld(this, 0);
-	r = bld.ParseFunctionDeclaration(func->objectType, declaration, func, true, &newInterface->paramAutoHandles, &newInterface->returnAutoHandle);
-	if( r < 0 )
-	{
-		// Set as dummy function before deleting
-		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
-		return ConfigError(asINVALID_DECLARATION, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
-	}
-
-	// Check name conflicts
-	r = bld.CheckNameConflictMember(objectType, func->name.AddressOf(), 0, 0, false);
-	if( r < 0 )
-	{
-		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
-		return ConfigError(asNAME_TAKEN, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
-	}
-
-	// Check against duplicate methods
+	// The declarations in the config image have already been validated
+	// when it was recorded, so the checks can be skipped in that case
 	asUINT n;
-	for( n = 0; n < func->objectType->methods.GetLength(); n++ )
+	if( !fromImage || !configImage->RestoreFunction(func, &newInterface->paramAutoHandles, &newInterface->returnAutoHandle) )
 	{
-		asCScriptFunction *f = scriptFunctions[func->objectType->methods[n]];
-		if( f->name == func->name &&
-			f->IsSignatureExceptNameAndReturnTypeEqual(func) )
+		asCBuilder bld(this, 0);
+		r = bld.ParseFunctionDeclaration(func->objectType, declaration, func, true, &newInterface->paramAutoHandles, &newInterface->returnAutoHandle);
+		if( r < 0 )
 		{
+			// Set as dummy function before deleting
 			func->funcType = asFUNC_DUMMY;
 			asDELETE(func,asCScriptFunction);
-			return ConfigError(asALREADY_REGISTERED, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+			return ConfigError(asINVALID_DECLARATION, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+		}
+
+		// Check name conflicts
+		r = bld.CheckNameConflictMember(objectType, func->name.AddressOf(), 0, 0, false);
+		if( r < 0 )
+		{
+			func->funcType = asFUNC_DUMMY;
+			asDELETE(func,asCScriptFunction);
+			return ConfigError(asNAME_TAKEN, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+		}
+
+		// Check against duplicate methods
+		for( n = 0; n < func->objectType->methods.GetLength(); n++ )
+		{
+			asCScriptFunction *f = scriptFunctions[func->objectType->methods[n]];
+			if( f->name == func->name &&
+				f->IsSignatureExceptNameAndReturnTypeEqual(func) )
+			{
+				func->funcType = asFUNC_DUMMY;
+				asDELETE(func,asCScriptFunction);
+				return ConfigError(asALREADY_REGISTERED, "RegisterObjectMethod", objectType->name.AddressOf(), declaration);
+			}
 		}
 	}
 
@@ -2483,7 +2688,7 @@ int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const
 				if( func->returnType.IsObjectHandle() )
 					func->objectType->acceptValueSubType = false;
 				else if( !func->returnType.IsReference() )
-					func->objectType->acceptRefSubType = false;
+					func->objectType->returnsSubTypeByValue = true;
 			}
 
 			for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
@@ -2498,6 +2703,21 @@ int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const
 				}
 			}
 		}
+
+		// The template may already have been instanciated, e.g. by the declaration of one of
+		// its own methods, so the instances must also receive the new method
+		for( n = 0; n < templateInstanceTypes.GetLength(); n++ )
+		{
+			asCObjectType *ot = templateInstanceTypes[n];
+			if( ot == 0 || ot == func->objectType || !(ot->flags & asOBJ_TEMPLATE) ||
+				ot->name != func->objectType->name || ot->nameSpace != func->objectType->nameSpace )
+				continue;
+
+			asCScriptFunction *instFunc = func;
+			if( !GenerateNewTemplateFunction(func->objectType, ot, func, &instFunc) )
+				func->AddRef();
+			ot->methods.PushLast(instFunc->id);
+		}
 	}
 
 	// TODO: beh.copy member will be removed, so this is not necessary
@@ -2513,6 +2733,109 @@ int asCScriptEngine::RegisterMethodToObjectType(asCObjectType *objectType, const
 	return func->id;
 }
 
+// internal
+// The implementation of the accessors registered with RegisterObjectFieldAccessor. The
+// compiler normally accesses the field directly, but the accessor can still be called
+// like any other method, e.g. through a delegate or by the application
+static void FieldAccessor_Generic(asIScriptGeneric *gen)
+{
+	asCScriptFunction *func  = static_cast<asCScriptFunction*>(gen->GetFunction());
+	asBYTE            *field = reinterpret_cast<asBYTE*>(gen->GetObject()) + func->sysFuncIntf->fieldOffset;
+
+	if( func->parameterTypes.GetLength() == 0 )
+		memcpy(gen->GetAddressOfReturnLocation(), field, func->returnType.GetSizeInMemoryBytes());
+	else
+		memcpy(field, gen->GetAddressOfArg(0), func->parameterTypes[0].GetSizeInMemoryBytes());
+}
+
+// interface
+int asCScriptEngine::RegisterObjectFieldAccessor(const char *obj, const char *declaration, int byteOffset)
+{
+	if( obj == 0 || declaration == 0 )
+		return ConfigError(asINVALID_ARG, "RegisterObjectFieldAccessor", obj, declaration);
+
+	asCDataType dt;
+	asCBuilder bld(this, 0);
+	int r = bld.ParseDataType(obj, &dt, defaultNamespace);
+	if( r < 0 )
+		return ConfigError(r, "RegisterObjectFieldAccessor", obj, declaration);
+
+	// The field of a template type may not be at the same offset in all template instances
+	asCObjectType *ot = dt.GetObjectType();
+	if( ot == 0 || (ot->flags & asOBJ_TEMPLATE) )
+		return ConfigError(asINVALID_ARG, "RegisterObjectFieldAccessor", obj, declaration);
+
+	// The VM currently only supports 16bit offsets
+	if( byteOffset > 32767 || byteOffset < -32768 )
+		return ConfigError(asINVALID_ARG, "RegisterObjectFieldAccessor", obj, declaration);
+
+	// Only 'T get_name()' or 'void set_name(T)' with a primitive T by value can be an alias for a field
+	asCScriptFunction func(this, 0, asFUNC_DUMMY);
+	r = bld.ParseFunctionDeclaration(ot, declaration, &func, true);
+	if( r < 0 )
+		return ConfigError(asINVALID_DECLARATION, "RegisterObjectFieldAccessor", obj, declaration);
+
+	asCDataType type;
+	bool isGet = func.name.SubString(0, 4) == "get_" && func.parameterTypes.GetLength() == 0;
+	bool isSet = func.name.SubString(0, 4) == "set_" && func.parameterTypes.GetLength() == 1 && func.returnType == asCDataType::CreatePrimitive(ttVoid, false);
+	if( isGet )
+		type = func.returnType;
+	else if( isSet )
+		type = func.parameterTypes[0];
+	if( (!isGet && !isSet) || func.name.GetLength() == 4 || !type.IsPrimitive() || type.IsReference() || type.GetTokenType() == ttVoid )
+		return ConfigError(asINVALID_DECLARATION, "RegisterObjectFieldAccessor", obj, declaration);
+	type.MakeReadOnly(false);
+
+	// If the other accessor for the same field has already been registered the
+	// property exists, otherwise the name must not be used for another property
+	asCString name = func.name.SubString(4);
+	asCObjectProperty *prop = 0;
+	for( asUINT n = 0; n < ot->properties.GetLength(); n++ )
+	{
+		if( ot->properties[n]->name == name )
+		{
+			prop = ot->properties[n];
+			if( prop->byteOffset != byteOffset || !prop->type.IsEqualExceptConst(type) )
+				return ConfigError(asNAME_TAKEN, "RegisterObjectFieldAccessor", obj, declaration);
+			break;
+		}
+	}
+
+	// Register the accessor as a normal method so it can be found and called like any other
+	r = RegisterObjectMethod(obj, declaration, asFUNCTION(FieldAccessor_Generic), asCALL_GENERIC);
+	if( r < 0 )
+		return r;
+
+	scriptFunctions[r]->sysFuncIntf->isFieldAccessor = true;
+	scriptFunctions[r]->sysFuncIntf->fieldOffset     = byteOffset;
+
+	// The compiler accesses the field through a property with the same name as the accessors.
+	// The property is read-only unless the set accessor has been registered, and it is hidden
+	// from the application since the accessors are what was registered.
+	if( prop == 0 )
+	{
+		prop = asNEW(asCObjectProperty);
+		if( prop == 0 )
+			return ConfigError(asOUT_OF_MEMORY, "RegisterObjectFieldAccessor", obj, declaration);
+
+		prop->name       = name;
+		prop->type       = type;
+		prop->type.MakeReadOnly(true);
+		prop->byteOffset = byteOffset;
+		prop->isPrivate  = false;
+		prop->accessMask = defaultAccessMask;
+		prop->isFieldAlias = true;
+
+		ot->properties.PushLast(prop);
+
+		currentGroup->RefConfigGroup(FindConfigGroupForObjectType(type.GetObjectType()));
+	}
+	if( isSet )
+		prop->type.MakeReadOnly(false);
+
+	return r;
+}
+
 // interface
 int asCScriptEngine::RegisterGlobalFunction(const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall)
 {
@@ -2548,41 +2871,52 @@ int asCScriptEngine::RegisterGlobalFunction(const char *declaration, const asSFu
 
 	func->sysFuncIntf = newInterface;
 
-	asCBuilder bld(this, 0);
-	r = bld.ParseFunctionDeclaration(0, declaration, func, true, &newInterface->paramAutoHandles, &newInterface->returnAutoHandle, defaultNamespace);
-	if( r < 0 )
+	// The declarations in the config image have already been validated
+	// when it was recorded, so the checks can be skipped in that case
+	asQWORD imageKey = configImage->GetKey(asCConfigImage::GLOBAL_FUNCTION, 0, declaration);
+	asUINT n;
+	if( configImage->FindEntry(imageKey) &&
+		configImage->RestoreFunction(func, &newInterface->paramAutoHandles, &newInterface->returnAutoHandle) )
 	{
-		// Set as dummy function before deleting
-		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
-		return ConfigError(asINVALID_DECLARATION, "RegisterGlobalFunction", declaration, 0);
+		func->nameSpace = defaultNamespace;
 	}
-
-	// TODO: namespace: What if the declaration defined an explicit namespace?
-	func->nameSpace = defaultNamespace;
-
-	// Check name conflicts
-	r = bld.CheckNameConflict(func->name.AddressOf(), 0, 0, defaultNamespace);
-	if( r < 0 )
+	else
 	{
-		// Set as dummy function before deleting
-		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
-		return ConfigError(asNAME_TAKEN, "RegisterGlobalFunction", declaration, 0);
-	}
+		asCBuilder bld(this, 0);
+		r = bld.ParseFunctionDeclaration(0, declaration, func, true, &newInterface->paramAutoHandles, &newInterface->returnAutoHandle, defaultNamespace);
+		if( r < 0 )
+		{
+			// Set as dummy function before deleting
+			func->funcType = asFUNC_DUMMY;
+			asDELETE(func,asCScriptFunction);
+			return ConfigError(asINVALID_DECLARATION, "RegisterGlobalFunction", declaration, 0);
+		}
 
-	// Make sure the function is not identical to a previously registered function
-	asUINT n;
-	for( n = 0; n < registeredGlobalFuncs.GetLength(); n++ )
-	{
-		asCScriptFunction *f = registeredGlobalFuncs[n];
-		if( f->name == func->name &&
-			f->nameSpace == func->nameSpace &&
-			f->IsSignatureExceptNameAndReturnTypeEqual(func) )
+		// TODO: namespace: What if the declaration defined an explicit namespace?
+		func->nameSpace = defaultNamespace;
+
+		// Check name conflicts
+		r = bld.CheckNameConflict(func->name.AddressOf(), 0, 0, defaultNamespace);
+		if( r < 0 )
 		{
+			// Set as dummy function before deleting
 			func->funcType = asFUNC_DUMMY;
 			asDELETE(func,asCScriptFunction);
-			return ConfigError(asALREADY_REGISTERED, "RegisterGlobalFunction", declaration, 0);
+			return ConfigError(asNAME_TAKEN, "RegisterGlobalFunction", declaration, 0);
+		}
+
+		// Make sure the function is not identical to a previously registered function
+		for( n = 0; n < registeredGlobalFuncs.GetLength(); n++ )
+		{
+			asCScriptFunction *f = registeredGlobalFuncs[n];
+			if( f->name == func->name &&
+				f->nameSpace == func->nameSpace &&
+				f->IsSignatureExceptNameAndReturnTypeEqual(func) )
+			{
+				func->funcType = asFUNC_DUMMY;
+				asDELETE(func,asCScriptFunction);
+				return ConfigError(asALREADY_REGISTERED, "RegisterGlobalFunction", declaration, 0);
+			}
 		}
 	}
 
@@ -2608,6 +2942,8 @@ int asCScriptEngine::RegisterGlobalFunction(const char *declaration, const asSFu
 		}
 	}
 
+	configImage->RecordFunction(imageKey, 0, func);
+
 	// Return the function id as success
 	return func->id;
 }
@@ -2690,6 +3026,31 @@ asIScriptFunction *asCScriptEngine::GetGlobalFunctionByDecl(const char *decl) co
 	return scriptFunctions[id];
 }
 
+// interface
+int asCScriptEngine::SetGlobalFunctionPure(asIScriptFunction *f, bool isPure)
+{
+	asCScriptFunction *func = static_cast<asCScriptFunction*>(f);
+	if( func == 0 || func->funcType != asFUNC_SYSTEM || func->objectType || func->GetEngine() != this )
+		return asINVALID_ARG;
+
+	if( isPure )
+	{
+		// The compiler can only evaluate functions that take and
+		// return primitives by value, as these can be constants
+		if( !func->returnType.IsPrimitive() || func->returnType.IsReference() || func->returnType.GetTokenType() == ttVoid )
+			return asNOT_SUPPORTED;
+		for( asUINT n = 0; n < func->parameterTypes.GetLength(); n++ )
+		{
+			if( !func->parameterTypes[n].IsPrimitive() || func->parameterTypes[n].IsReference() )
+				return asNOT_SUPPORTED;
+		}
+	}
+
+	func->sysFuncIntf->isPure = isPure;
+
+	return asSUCCESS;
+}
+
 
 asCObjectType *asCScriptEngine::GetObjectType(const char *type, asSNameSpace *ns)
 {
@@ -2918,6 +3279,25 @@ int asCScriptEngine::GetStringFactoryReturnTypeId() const
 	return GetTypeIdFromDataType(stringFactory->returnType);
 }
 
+// interface
+int asCScriptEngine::SetStringConstantCallback(asSTRINGCONSTANTFUNC_t callback, void *param)
+{
+	// The call to the string factory can only be replaced with 
+	// the object if the string factory returns a reference
+	if( callback && (stringFactory == 0 || !stringFactory->returnType.IsReference()) )
+		return asNOT_SUPPORTED;
+
+	stringConstantCallback = callback;
+	stringConstantParam    = param;
+
+	// Create the objects for the constants that already exist
+	stringConstantObjects.SetLength(0);
+	if( stringConstantCallback )
+		CreateStringConstantObjects();
+
+	return asSUCCESS;
+}
+
 // interface
 asCModule *asCScriptEngine::GetModule(const char *_name, bool create)
 {
@@ -3100,6 +3480,13 @@ asCObjectType *asCScriptEngine::GetTemplateInstanceType(asCObjectType *templateT
 
 		if( !templateType->acceptRefSubType && (subTypes[n].IsObject() && (subTypes[n].GetObjectType()->flags & asOBJ_REF)) )
 			return 0;
+
+		// Reference types returned by value are returned as handles in the 
+		// template instance, so the subtype must support handles
+		if( templateType->returnsSubTypeByValue && !subTypes[n].IsObjectHandle() &&
+			(subTypes[n].IsObject() && (subTypes[n].GetObjectType()->flags & asOBJ_REF)) &&
+			(subTypes[n].GetObjectType()->flags & (asOBJ_NOHANDLE | asOBJ_SCOPED)) )
+			return 0;
 	}
 
 	// Create a new template instance type based on the templateType
@@ -3296,12 +3683,49 @@ asCDataType asCScriptEngine::DetermineTypeForTemplate(const asCDataType &orig, a
 		dt.MakeReference(orig.IsReference());
 		dt.MakeReadOnly(orig.IsReadOnly());
 	}
+	else if( IsTemplateOfSubTypes(orig.GetObjectType()) )
+	{
+		// Another template declared with the template's subtypes, e.g. arrayview<T> in 
+		// a method of array<T>, is replaced with the instance for the same subtypes
+		asCObjectType *origType = orig.GetObjectType();
+		asCArray<asCDataType> subTypes;
+		for( asUINT n = 0; n < origType->templateSubTypes.GetLength(); n++ )
+			subTypes.PushLast(DetermineTypeForTemplate(origType->templateSubTypes[n], tmpl, ot));
+
+		dt = orig;
+		asCObjectType *instance = GetTemplateInstanceType(origType, subTypes);
+		if( instance )
+		{
+			if( orig.IsObjectHandle() )
+				dt = asCDataType::CreateObjectHandle(instance, false);
+			else
+				dt = asCDataType::CreateObject(instance, false);
+
+			dt.MakeReference(orig.IsReference());
+			dt.MakeReadOnly(orig.IsReadOnly());
+		}
+	}
 	else
 		dt = orig;
 
 	return dt;
 }
 
+// internal
+bool asCScriptEngine::IsTemplateOfSubTypes(asCObjectType *ot)
+{
+	if( ot == 0 || !(ot->flags & asOBJ_TEMPLATE) )
+		return false;
+
+	// The template instances have the actual types as subtypes
+	for( asUINT n = 0; n < ot->templateSubTypes.GetLength(); n++ )
+		if( ot->templateSubTypes[n].GetObjectType() && 
+			(ot->templateSubTypes[n].GetObjectType()->flags & asOBJ_TEMPLATE_SUBTYPE) )
+			return true;
+
+	return false;
+}
+
 // internal
 asCScriptFunction *asCScriptEngine::GenerateTemplateFactoryStub(asCObjectType *templateType, asCObjectType *ot, int factoryId)
 {
@@ -3320,7 +3744,6 @@ asCScriptFunction *asCScriptEngine::GenerateTemplateFactoryStub(asCObjectType *t
 
 	func->funcType         = asFUNC_SCRIPT;
 	func->name             = "factstub";
-	func->id               = GetNextScriptFunctionId();
 	func->returnType       = asCDataType::CreateObjectHandle(ot, false);
 	func->isShared         = true;
 
@@ -3334,6 +3757,9 @@ asCScriptFunction *asCScriptEngine::GenerateTemplateFactoryStub(asCObjectType *t
 	}
 	func->objVariablesOnHeap = 0;
 
+	// The parameter types may instanciate other templates, so the id is taken last
+	func->id               = GetNextScriptFunctionId();
+
 	SetScriptFunction(func);
 
 	// Generate the bytecode for the factory stub
@@ -3378,14 +3804,16 @@ bool asCScriptEngine::GenerateNewTemplateFunction(asCObjectType *templateType, a
 {
 	bool needNewFunc = false;
 	if( (func->returnType.GetObjectType() && (func->returnType.GetObjectType()->flags & asOBJ_TEMPLATE_SUBTYPE)) ||
-		func->returnType.GetObjectType() == templateType )
+		func->returnType.GetObjectType() == templateType ||
+		IsTemplateOfSubTypes(func->returnType.GetObjectType()) )
 		needNewFunc = true;
 	else
 	{
 		for( asUINT p = 0; p < func->parameterTypes.GetLength(); p++ )
 		{
 			if( (func->parameterTypes[p].GetObjectType() && (func->parameterTypes[p].GetObjectType()->flags & asOBJ_TEMPLATE_SUBTYPE)) ||
-				func->parameterTypes[p].GetObjectType() == templateType )
+				func->parameterTypes[p].GetObjectType() == templateType ||
+				IsTemplateOfSubTypes(func->parameterTypes[p].GetObjectType()) )
 			{
 				needNewFunc = true;
 				break;
@@ -3404,20 +3832,35 @@ bool asCScriptEngine::GenerateNewTemplateFunction(asCObjectType *templateType, a
 	}
 
 	func2->name     = func->name;
-	func2->id       = GetNextScriptFunctionId();
 
+	// Determining the types may instanciate other templates, so the 
+	// function id must not be taken until all the types are known
 	func2->returnType = DetermineTypeForTemplate(func->returnType, templateType, ot);
 
+	// A subtype returned by value is returned as a handle when the subtype is a reference type
+	if( func->returnType.GetObjectType() && (func->returnType.GetObjectType()->flags & asOBJ_TEMPLATE_SUBTYPE) &&
+		!func->returnType.IsObjectHandle() && !func->returnType.IsReference() &&
+		func2->returnType.IsObject() && !func2->returnType.IsObjectHandle() &&
+		(func2->returnType.GetObjectType()->flags & asOBJ_REF) )
+		func2->returnType.MakeHandle(true, true);
+
 	func2->parameterTypes.SetLength(func->parameterTypes.GetLength());
 	for( asUINT p = 0; p < func->parameterTypes.GetLength(); p++ )
 		func2->parameterTypes[p] = DetermineTypeForTemplate(func->parameterTypes[p], templateType, ot);
 
+	func2->id       = GetNextScriptFunctionId();
+
 	// TODO: template: Must be careful when instanciating templates for garbage collected types
 	//                 If the template hasn't been registered with the behaviours, it shouldn't
 	//                 permit instanciation of garbage collected types that in turn may refer to
 	//                 this instance.
 
 	func2->inOutFlags = func->inOutFlags;
+
+	// Each function owns its default args
+	for( asUINT d = 0; d < func->defaultArgs.GetLength(); d++ )
+		func2->defaultArgs.PushLast(func->defaultArgs[d] ? asNEW(asCString)(*func->defaultArgs[d]) : 0);
+
 	func2->isReadOnly = func->isReadOnly;
 	func2->objectType = ot;
 	func2->stackNeeded = func->stackNeeded;
@@ -4353,12 +4796,31 @@ int asCScriptEngine::RemoveConfigGroup(const char *groupName)
 			group->RemoveConfiguration(this);
 
 			asDELETE(group,asCConfigGroup);
+
+			// The recorded config image refers to the registered types by index
+			configImage->Invalidate();
 		}
 	}
 
 	return 0;
 }
 
+// interface
+int asCScriptEngine::SaveConfigImage(asIBinaryStream *out) const
+{
+	if( out == 0 )
+		return asINVALID_ARG;
+
+	return configImage->Save(out);
+}
+
+// interface
+int asCScriptEngine::LoadConfigImage(asIBinaryStream *in)
+{
+	// The image is only used by the registrations made after it has been loaded
+	return configImage->Load(in);
+}
+
 asCConfigGroup *asCScriptEngine::FindConfigGroupForFunction(int funcId) const
 {
 	for( asUINT n = 0; n < configGroups.GetLength(); n++ )
@@ -4506,22 +4968,29 @@ int asCScriptEngine::RegisterFuncdef(const char *decl)
 	if( func == 0 )
 		return ConfigError(asOUT_OF_MEMORY, "RegisterFuncdef", decl, 0);
 
-	asCBuilder bld(this, 0);
-	int r = bld.ParseFunctionDeclaration(0, decl, func, false, 0, 0, defaultNamespace);
-	if( r < 0 )
+	// The declarations in the config image have already been validated
+	// when it was recorded, so the checks can be skipped in that case
+	asQWORD imageKey = configImage->GetKey(asCConfigImage::FUNCDEF, 0, decl);
+	if( !configImage->FindEntry(imageKey) ||
+		!configImage->RestoreFunction(func, 0, 0) )
 	{
-		// Set as dummy function before deleting
-		func->funcType = asFUNC_DUMMY;
-		asDELETE(func,asCScriptFunction);
-		return ConfigError(asINVALID_DECLARATION, "RegisterFuncdef", decl, 0);
-	}
+		asCBuilder bld(this, 0);
+		int r = bld.ParseFunctionDeclaration(0, decl, func, false, 0, 0, defaultNamespace);
+		if( r < 0 )
+		{
+			// Set as dummy function before deleting
+			func->funcType = asFUNC_DUMMY;
+			asDELETE(func,asCScriptFunction);
+			return ConfigError(asINVALID_DECLARATION, "RegisterFuncdef", decl, 0);
+		}
 
-	// Check name conflicts
-	r = bld.CheckNameConflict(func->name.AddressOf(), 0, 0, defaultNamespace);
-	if( r < 0 )
-	{
-		asDELETE(func,asCScriptFunction);
-		return ConfigError(asNAME_TAKEN, "RegisterFuncdef", decl, 0);
+		// Check name conflicts
+		r = bld.CheckNameConflict(func->name.AddressOf(), 0, 0, defaultNamespace);
+		if( r < 0 )
+		{
+			asDELETE(func,asCScriptFunction);
+			return ConfigError(asNAME_TAKEN, "RegisterFuncdef", decl, 0);
+		}
 	}
 
 	func->id = GetNextScriptFunctionId();
@@ -4546,6 +5015,8 @@ int asCScriptEngine::RegisterFuncdef(const char *decl)
 		}
 	}
 
+	configImage->RecordFunction(imageKey, 0, func);
+
 	// Return the function id as success
 	return func->id;
 }
@@ -4565,6 +5036,15 @@ asIScriptFunction *asCScriptEngine::GetFuncdefByIndex(asUINT index) const
 	return registeredFuncDefs[index];
 }
 
+// interface
+asIScriptFunction *asCScriptEngine::GetFuncdefFromTypeId(int typeId) const
+{
+	// The function handles don't have an object type, instead the data
+	// type refers to the function that describes the signature
+	asCDataType dt = GetDataTypeFromTypeId(typeId);
+	return dt.GetFuncDef();
+}
+
 // interface
 // TODO: typedef: Accept complex types for the typedefs
 int asCScriptEngine::RegisterTypedef(const char *type, const char *decl)
@@ -4925,6 +5405,9 @@ int asCScriptEngine::AddConstantString(const char *str, size_t len)
 		// The VM currently doesn't handle string ids larger than 65535
 		asASSERT(stringConstants.GetLength() <= 65536);
 
+		if( stringConstantCallback )
+			CreateStringConstantObjects();
+
 		return index;
 	}
 
@@ -4937,6 +5420,18 @@ const asCString &asCScriptEngine::GetConstantString(int id)
 	return *stringConstants[id];
 }
 
+// internal
+void asCScriptEngine::CreateStringConstantObjects()
+{
+	// The application creates the string object once for each constant, so 
+	// the context doesn't have to call the string factory when executing
+	for( asUINT n = stringConstantObjects.GetLength(); n < stringConstants.GetLength(); n++ )
+	{
+		const asCString *str = stringConstants[n];
+		stringConstantObjects.PushLast(stringConstantCallback(str->AddressOf(), (asUINT)str->GetLength(), stringConstantParam));
+	}
+}
+
 // internal
 int asCScriptEngine::GetScriptSectionNameIndex(const char *name)
 {
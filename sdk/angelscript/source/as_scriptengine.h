@@ -58,6 +58,7 @@ BEGIN_AS_NAMESPACE
 
 class asCBuilder;
 class asCContext;
+class asCConfigImage;
 
 // TODO: import: Remove this when import is removed
 struct sBindInfo;
@@ -92,6 +93,10 @@ public:
     virtual int SetJITCompiler(asIJITCompiler *compiler);
     virtual asIJITCompiler *GetJITCompiler() const;
 
+	// Asynchronous calls
+	virtual int SetAsyncCallCallback(const asSFuncPtr &callback, void *obj, asDWORD callConv);
+	virtual int ClearAsyncCallCallback();
+
 	// Global functions
 	virtual int                RegisterGlobalFunction(const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, void *objForThiscall = 0);
 	virtual asUINT             GetGlobalFunctionCount() const;
@@ -101,6 +106,7 @@ public:
 #endif
 	virtual asIScriptFunction *GetGlobalFunctionByIndex(asUINT index) const;
 	virtual asIScriptFunction *GetGlobalFunctionByDecl(const char *declaration) const;
+	virtual int                SetGlobalFunctionPure(asIScriptFunction *func, bool isPure);
 
 	// Global properties
 	virtual int    RegisterGlobalProperty(const char *declaration, void *pointer);
@@ -113,6 +119,7 @@ public:
 	virtual int            RegisterObjectType(const char *obj, int byteSize, asDWORD flags);
 	virtual int            RegisterObjectProperty(const char *obj, const char *declaration, int byteOffset);
 	virtual int            RegisterObjectMethod(const char *obj, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv);
+	virtual int            RegisterObjectFieldAccessor(const char *obj, const char *declaration, int byteOffset);
 	virtual int            RegisterObjectBehaviour(const char *obj, asEBehaviours behaviour, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv);
 	virtual int            RegisterInterface(const char *name);
 	virtual int            RegisterInterfaceMethod(const char *intf, const char *declaration);
@@ -123,6 +130,7 @@ public:
 	// String factory
 	virtual int RegisterStringFactory(const char *datatype, const asSFuncPtr &factoryFunc, asDWORD callConv);
 	virtual int GetStringFactoryReturnTypeId() const;
+	virtual int SetStringConstantCallback(asSTRINGCONSTANTFUNC_t callback, void *param);
 
 	// Default array type
 	virtual int RegisterDefaultArrayType(const char *type);
@@ -140,6 +148,7 @@ public:
 	virtual int                RegisterFuncdef(const char *decl);
 	virtual asUINT             GetFuncdefCount() const;
 	virtual asIScriptFunction *GetFuncdefByIndex(asUINT index) const;
+	virtual asIScriptFunction *GetFuncdefFromTypeId(int typeId) const;
 
 	// Typedefs
 	// TODO: interface: Should perhaps rename this to Alias, since it doesn't really create a new type
@@ -155,9 +164,15 @@ public:
 	virtual int         SetDefaultNamespace(const char *nameSpace);
 	virtual const char *GetDefaultNamespace() const;
 
+	// Configuration image
+	virtual int SaveConfigImage(asIBinaryStream *out) const;
+	virtual int LoadConfigImage(asIBinaryStream *in);
+
 	// Script modules
 	virtual asIScriptModule *GetModule(const char *module, asEGMFlags flag);
 	virtual int              DiscardModule(const char *module);
+	virtual int              SaveByteCodeBundle(asIScriptModule **modules, asUINT count, asIBinaryStream *out, bool stripDebugInfo) const;
+	virtual int              LoadByteCodeBundle(asIBinaryStream *in, bool *wasDebugInfoStripped);
 
 	// Script functions
 	virtual asIScriptFunction *GetFunctionById(int funcId) const;
@@ -229,8 +244,8 @@ public:
 	friend class asCByteCode;
 	friend int PrepareSystemFunction(asCScriptFunction *func, asSSystemFunctionInterface *internal, asCScriptEngine *engine);
 
-	int RegisterMethodToObjectType(asCObjectType *objectType, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv);
-	int RegisterBehaviourToObjectType(asCObjectType *objectType, asEBehaviours behaviour, const char *decl, const asSFuncPtr &funcPointer, asDWORD callConv);
+	int RegisterMethodToObjectType(asCObjectType *objectType, const char *declaration, const asSFuncPtr &funcPointer, asDWORD callConv, bool fromImage = false);
+	int RegisterBehaviourToObjectType(asCObjectType *objectType, asEBehaviours behaviour, const char *decl, const asSFuncPtr &funcPointer, asDWORD callConv, bool fromImage = false);
 
 	int VerifyVarTypeNotInFunction(asCScriptFunction *func);
 
@@ -248,6 +263,7 @@ public:
 	bool  CallObjectMethodRetBool(void *obj, int func);
 	int   CallObjectMethodRetInt(void *obj, int func);
 	void  CallGlobalFunction(void *param1, void *param2, asSSystemFunctionInterface *func, asCScriptFunction *desc);
+	void  CallAsyncCallCallback(asIScriptContext *ctx);
 	bool  CallGlobalFunctionRetBool(void *param1, void *param2, asSSystemFunctionInterface *func, asCScriptFunction *desc);
 
 	void ConstructScriptObjectCopy(void *mem, void *obj, asCObjectType *type);
@@ -300,11 +316,13 @@ public:
 	bool               GenerateNewTemplateFunction(asCObjectType *templateType, asCObjectType *templateInstanceType, asCScriptFunction *templateFunc, asCScriptFunction **newFunc);
 	void               OrphanTemplateInstances(asCObjectType *subType);
 	asCDataType        DetermineTypeForTemplate(const asCDataType &orig, asCObjectType *tmpl, asCObjectType *ot);
+	bool               IsTemplateOfSubTypes(asCObjectType *ot);
 
 	// String constants
 	// TODO: Must free unused string constants, thus the ref count for each must be tracked
 	int              AddConstantString(const char *str, size_t length);
 	const asCString &GetConstantString(int id);
+	void             CreateStringConstantObjects();
 
 	// Global property management
 	asCGlobalProperty *AllocateGlobalProperty();
@@ -369,6 +387,7 @@ public:
 	mutable asCAtomic      refCount;
 	asCArray<asCModule *>  scriptModules;
 	asCModule             *lastModule;
+	asCAtomic              moduleBuildCounter;
 	bool                   isBuilding;
 	bool                   deferValidationOfTemplateTypes;
 
@@ -399,11 +418,19 @@ public:
 	asDWORD                    defaultAccessMask;
 	asSNameSpace              *defaultNamespace;
 
+	// Parsed declarations of the application interface
+	asCConfigImage            *configImage;
+
 	// Message callback
 	bool                        msgCallback;
 	asSSystemFunctionInterface  msgCallbackFunc;
 	void                       *msgCallbackObj;
 
+	// Called when an asynchronous call completes for a context that is waiting for it
+	bool                        asyncCallback;
+	asSSystemFunctionInterface  asyncCallbackFunc;
+	void                       *asyncCallbackObj;
+
     asIJITCompiler              *jitCompiler;
 
 	// Namespaces
@@ -417,6 +444,12 @@ public:
 	asCArray<asCString*>          stringConstants;
 	asCMap<asCStringPointer, int> stringToIdMap;
 
+	// The string objects that the application created in advance 
+	// for the string constants, in the same order as the constants
+	asSTRINGCONSTANTFUNC_t        stringConstantCallback;
+	void                         *stringConstantParam;
+	asCArray<void*>               stringConstantObjects;
+
 	// User data
 	asCArray<asPWORD>       userData;
 
@@ -454,6 +487,11 @@ public:
 		bool   alwaysImplDefaultConstruct;
 		int    compilerWarnings;
 		bool   disallowValueAssignForRefType;
+		bool   recordConfigImage;
+		bool   lazyLoadFunctions;
+		bool   compressByteCode;
+		bool   verifyByteCode;
+		bool   eliminateTailCalls;
 	} ep;
 };
 
@@ -209,6 +209,8 @@ asCScriptFunction::asCScriptFunction(asCScriptEngine *engine, asCModule *mod, as
 	accessMask             = 0xFFFFFFFF;
 	isShared               = false;
 	variableSpace          = 0;
+	isBodyPending          = false;
+	isByteCodeVerified     = false;
 	nameSpace              = engine->nameSpaces[0];
 	objForDelegate         = 0;
 	funcForDelegate        = 0;
@@ -791,6 +793,7 @@ void asCScriptFunction::AddReferences()
 
 		// Functions
 		case asBC_CALL:
+		case asBC_TAILCALL:
 		case asBC_CALLINTF:
 			{
 				int func = asBC_INTARG(&byteCode[n]);
@@ -913,6 +916,7 @@ void asCScriptFunction::ReleaseReferences()
 
 		// Functions
 		case asBC_CALL:
+		case asBC_TAILCALL:
 		case asBC_CALLINTF:
 			{
 				int func = asBC_INTARG(&byteCode[n]);
@@ -1031,6 +1035,10 @@ void asCScriptFunction::JITCompile()
     if( !jit )
         return;
 
+    // The function will be compiled when the bytecode is loaded
+    if( isBodyPending )
+        return;
+
 	// Release the previous function, if any
     if( jitFunction )
     {
@@ -1060,6 +1068,553 @@ asDWORD *asCScriptFunction::GetByteCode(asUINT *length)
 	return 0;
 }
 
+// internal
+asCScriptFunction *asCScriptFunction::GetCalledFunction(asDWORD programPos)
+{
+	if( programPos >= byteCode.GetLength() )
+		return 0;
+
+	asBYTE bc = *(asBYTE*)&byteCode[programPos];
+
+	if( bc == asBC_CALL ||
+		bc == asBC_TAILCALL ||
+		bc == asBC_CALLSYS ||
+		bc == asBC_CALLINTF )
+	{
+		// Find the function from the function id in bytecode
+		int funcId = asBC_INTARG(&byteCode[programPos]);
+		if( funcId > 0 && funcId < (int)engine->scriptFunctions.GetLength() )
+			return engine->scriptFunctions[funcId];
+	}
+	else if( bc == asBC_ALLOC )
+	{
+		// Find the function from the function id in the bytecode
+		int funcId = asBC_INTARG(&byteCode[programPos+AS_PTR_SIZE]);
+		if( funcId > 0 && funcId < (int)engine->scriptFunctions.GetLength() )
+			return engine->scriptFunctions[funcId];
+	}
+	else if( bc == asBC_CALLBND )
+	{
+		// Find the function from the engine's bind array
+		asUINT idx = asBC_INTARG(&byteCode[programPos]) & ~FUNC_IMPORTED;
+		if( idx < engine->importedFunctions.GetLength() && engine->importedFunctions[idx] )
+			return engine->importedFunctions[idx]->importedFunctionSignature;
+	}
+	else if( bc == asBC_CallPtr )
+	{
+		asUINT v;
+		int var = asBC_SWORDARG0(&byteCode[programPos]);
+
+		// Find the funcdef from the local variable
+		for( v = 0; v < objVariablePos.GetLength(); v++ )
+			if( objVariablePos[v] == var )
+				return funcVariableTypes[v];
+
+		// Look in parameters
+		int paramPos = 0;
+		if( objectType )
+			paramPos -= AS_PTR_SIZE;
+		if( DoesReturnOnStack() )
+			paramPos -= AS_PTR_SIZE;
+		for( v = 0; v < parameterTypes.GetLength(); v++ )
+		{
+			if( var == paramPos )
+				return parameterTypes[v].GetFuncDef();
+			paramPos -= parameterTypes[v].GetSizeOnStackDWords();
+		}
+	}
+
+	return 0;
+}
+
+// Returns true if the instruction treats its variable as an object pointer
+static bool IsPointerInstruction(asBYTE c)
+{
+	switch( c )
+	{
+	case asBC_PshVPtr:
+	case asBC_FREE:
+	case asBC_LOADOBJ:
+	case asBC_STOREOBJ:
+	case asBC_RefCpyV:
+	case asBC_ClrVPtr:
+	case asBC_ChkNullV:
+	case asBC_CmpPtr:
+	case asBC_LoadRObjR:
+	case asBC_CallPtr:
+		return true;
+	}
+	return false;
+}
+
+// Returns the number of dwords the instruction reads or writes in its n:th variable
+static int GetVariableAccessSize(asBYTE c, int n)
+{
+	if( IsPointerInstruction(c) )
+		return AS_PTR_SIZE;
+
+	switch( c )
+	{
+	case asBC_SetV8:
+	case asBC_CpyVtoV8:
+	case asBC_CpyVtoR8:
+	case asBC_CpyRtoV8:
+	case asBC_WRTV8:
+	case asBC_RDR8:
+	case asBC_PshV8:
+	case asBC_NEGd:
+	case asBC_CMPd:
+	case asBC_ADDd:
+	case asBC_SUBd:
+	case asBC_MULd:
+	case asBC_DIVd:
+	case asBC_MODd:
+	case asBC_dTOi64:
+	case asBC_dTOu64:
+	case asBC_i64TOd:
+	case asBC_u64TOd:
+	case asBC_NEGi64:
+	case asBC_BNOT64:
+	case asBC_ADDi64:
+	case asBC_SUBi64:
+	case asBC_MULi64:
+	case asBC_DIVi64:
+	case asBC_MODi64:
+	case asBC_DIVu64:
+	case asBC_MODu64:
+	case asBC_BAND64:
+	case asBC_BOR64:
+	case asBC_BXOR64:
+	case asBC_CMPi64:
+	case asBC_CMPu64:
+		return 2;
+
+	// The shift amount is a 32bit integer
+	case asBC_BSLL64:
+	case asBC_BSRL64:
+	case asBC_BSRA64:
+		return n < 2 ? 2 : 1;
+
+	// Conversions to a 64bit type
+	case asBC_iTOd:
+	case asBC_uTOd:
+	case asBC_fTOd:
+	case asBC_iTOi64:
+	case asBC_uTOi64:
+	case asBC_fTOi64:
+	case asBC_fTOu64:
+		return n == 0 ? 2 : 1;
+
+	// Conversions from a 64bit type
+	case asBC_dTOi:
+	case asBC_dTOu:
+	case asBC_dTOf:
+	case asBC_i64TOi:
+	case asBC_i64TOf:
+	case asBC_u64TOf:
+		return n == 1 ? 2 : 1;
+	}
+
+	return 1;
+}
+
+// internal
+// Checks that the bytecode can be executed without the VM reading or writing outside
+// the memory it owns. The VM itself trusts the bytecode in order to keep the execution
+// fast, so this should be done for any bytecode that doesn't come from the compiler.
+// On success the size of the stack the function needs is returned in stackSize.
+int asCScriptFunction::VerifyByteCode(int *stackSize)
+{
+	isByteCodeVerified = false;
+
+	asUINT length = byteCode.GetLength();
+
+	// Variables are in the range (-argSpace, variableSpace]
+	int varSpace = (int)variableSpace;
+	int argSpace = GetSpaceNeededForArguments();
+	if( objectType ) argSpace += AS_PTR_SIZE;
+	if( DoesReturnOnStack() ) argSpace += AS_PTR_SIZE;
+
+	// The variables that hold pointers are the object variables allocated on the 
+	// heap, the object pointer, the return location, and the parameters that are
+	// passed by reference or as objects. These may only be used by the instructions
+	// that treat them as pointers, or the bytecode could forge a pointer
+	asCArray<int> ptrVars;
+	for( asUINT n = 0; n < objVariablesOnHeap && n < objVariablePos.GetLength(); n++ )
+		ptrVars.PushLast(objVariablePos[n]);
+	int paramPos = 0;
+	if( objectType )
+	{
+		ptrVars.PushLast(paramPos);
+		paramPos -= AS_PTR_SIZE;
+	}
+	if( DoesReturnOnStack() )
+	{
+		ptrVars.PushLast(paramPos);
+		paramPos -= AS_PTR_SIZE;
+	}
+	for( asUINT n = 0; n < parameterTypes.GetLength(); n++ )
+	{
+		if( parameterTypes[n].GetTokenType() != ttQuestion &&
+			(parameterTypes[n].IsReference() || parameterTypes[n].IsObject() || parameterTypes[n].IsObjectHandle()) )
+			ptrVars.PushLast(paramPos);
+		paramPos -= parameterTypes[n].GetSizeOnStackDWords();
+	}
+
+	const char *reason = 0;
+	asUINT pos = 0;
+	if( length == 0 )
+		reason = TXT_VERIFY_END_OF_CODE;
+
+	// First verify each of the instructions in isolation, and mark where they start
+	asCArray<asBYTE> isInstruction;
+	isInstruction.SetLength(length);
+	memset(isInstruction.AddressOf(), 0, length);
+	for( pos = 0; pos < length && reason == 0; )
+	{
+		asDWORD *bc = &byteCode[pos];
+		asBYTE c = *(asBYTE*)bc;
+		asUINT size = asBCTypeSize[asBCInfo[c].type];
+		if( c >= asBC_MAXBYTECODE || size == 0 || pos + size > length )
+		{
+			reason = TXT_VERIFY_INVALID_INSTRUCTION;
+			break;
+		}
+		isInstruction[pos] = 1;
+
+		// Verify the variable offsets
+		int vars[3];
+		int numVars = 0;
+		switch( asBCInfo[c].type )
+		{
+		case asBCTYPE_wW_ARG:
+		case asBCTYPE_rW_DW_ARG:
+		case asBCTYPE_wW_QW_ARG:
+		case asBCTYPE_rW_ARG:
+		case asBCTYPE_wW_DW_ARG:
+		case asBCTYPE_wW_W_ARG:
+		case asBCTYPE_rW_QW_ARG:
+		case asBCTYPE_rW_W_DW_ARG:
+			vars[numVars++] = asBC_SWORDARG0(bc);
+			break;
+
+		case asBCTYPE_wW_rW_ARG:
+		case asBCTYPE_wW_rW_DW_ARG:
+		case asBCTYPE_rW_rW_ARG:
+			vars[numVars++] = asBC_SWORDARG0(bc);
+			vars[numVars++] = asBC_SWORDARG1(bc);
+			break;
+
+		case asBCTYPE_wW_rW_rW_ARG:
+			vars[numVars++] = asBC_SWORDARG0(bc);
+			vars[numVars++] = asBC_SWORDARG1(bc);
+			vars[numVars++] = asBC_SWORDARG2(bc);
+			break;
+
+		default:
+			break;
+		}
+		for( int v = 0; v < numVars; v++ )
+			if( vars[v] <= -argSpace || vars[v] > varSpace )
+				reason = TXT_VERIFY_INVALID_VARIABLE;
+
+		// Verify that the pointers are only used as pointers, and that the instructions
+		// that take over or release the object are only used on variables holding pointers.
+		// A variable occupies the dwords from its offset and downwards. PSF, VAR, and 
+		// LoadVObjR only take the address of the variable, so they work with any variable
+		bool isPointer = IsPointerInstruction(c);
+		if( c == asBC_PSF || c == asBC_VAR || c == asBC_LoadVObjR )
+			numVars = 0;
+		for( int v = 0; v < numVars && reason == 0; v++ )
+		{
+			int size = GetVariableAccessSize(c, v);
+			bool found = false;
+			for( asUINT p = 0; p < ptrVars.GetLength(); p++ )
+			{
+				if( isPointer && vars[v] == ptrVars[p] )
+					found = true;
+				else if( vars[v] > ptrVars[p] - AS_PTR_SIZE && vars[v] - size < ptrVars[p] )
+					reason = TXT_VERIFY_INCONSISTENT_VARIABLE;
+			}
+
+			if( !found && (c == asBC_FREE || c == asBC_LOADOBJ || c == asBC_STOREOBJ || c == asBC_RefCpyV) )
+				reason = TXT_VERIFY_INCONSISTENT_VARIABLE;
+		}
+
+		// Verify the references to functions, types, and other entities
+		if( c == asBC_CALL || c == asBC_TAILCALL || c == asBC_CALLSYS || c == asBC_CALLINTF || c == asBC_CALLBND || c == asBC_CallPtr )
+		{
+			asCScriptFunction *called = GetCalledFunction(pos);
+			if( called == 0 ||
+				((c == asBC_CALL || c == asBC_TAILCALL) && called->funcType != asFUNC_SCRIPT) ||
+				(c == asBC_CALLSYS && called->funcType != asFUNC_SYSTEM) ||
+				(c == asBC_CALLINTF && called->funcType != asFUNC_VIRTUAL && called->funcType != asFUNC_INTERFACE) ||
+				(c == asBC_CALLBND && !(asBC_INTARG(bc) & FUNC_IMPORTED)) ||
+				(c == asBC_CallPtr && called->funcType != asFUNC_FUNCDEF) )
+				reason = TXT_VERIFY_INVALID_FUNCTION;
+		}
+		else if( c == asBC_ALLOC )
+		{
+			if( asBC_PTRARG(bc) == 0 )
+				reason = TXT_VERIFY_INVALID_TYPE;
+			else if( asBC_INTARG(bc+AS_PTR_SIZE) != 0 && GetCalledFunction(pos) == 0 )
+				reason = TXT_VERIFY_INVALID_FUNCTION;
+		}
+		else if( c == asBC_FuncPtr )
+		{
+			asCScriptFunction *f = (asCScriptFunction*)asBC_PTRARG(bc);
+			if( f == 0 || f->id < 0 || f->id >= (int)engine->scriptFunctions.GetLength() || engine->scriptFunctions[f->id] != f )
+				reason = TXT_VERIFY_INVALID_FUNCTION;
+		}
+		else if( c == asBC_FREE || c == asBC_REFCPY || c == asBC_RefCpyV || c == asBC_OBJTYPE )
+		{
+			if( asBC_PTRARG(bc) == 0 )
+				reason = TXT_VERIFY_INVALID_TYPE;
+		}
+		else if( c == asBC_TYPEID || c == asBC_Cast || c == asBC_COPY || c == asBC_ADDSi || c == asBC_LoadThisR )
+		{
+			int typeId = asBC_INTARG(bc);
+			if( typeId && !engine->GetDataTypeFromTypeId(typeId).IsValid() )
+				reason = TXT_VERIFY_INVALID_TYPE;
+		}
+		else if( c == asBC_LoadRObjR || c == asBC_LoadVObjR )
+		{
+			int typeId = asBC_INTARG(bc+1);
+			if( !engine->GetDataTypeFromTypeId(typeId).IsValid() )
+				reason = TXT_VERIFY_INVALID_TYPE;
+		}
+		else if( c == asBC_STR )
+		{
+			if( asBC_WORDARG0(bc) >= engine->stringConstants.GetLength() )
+				reason = TXT_VERIFY_INVALID_STRING;
+		}
+		else if( c == asBC_PGA      ||
+			     c == asBC_PshGPtr  ||
+			     c == asBC_LDG      ||
+				 c == asBC_PshG4    ||
+				 c == asBC_LdGRdR4  ||
+				 c == asBC_CpyGtoV4 ||
+				 c == asBC_CpyVtoG4 ||
+				 c == asBC_SetG4    )
+		{
+			if( asBC_PTRARG(bc) == 0 )
+				reason = TXT_VERIFY_INVALID_GLOBAL;
+		}
+		else if( c == asBC_RET )
+		{
+			if( asBC_WORDARG0(bc) != argSpace )
+				reason = TXT_VERIFY_INVALID_RETURN;
+		}
+
+		if( reason == 0 )
+			pos += size;
+	}
+
+	// Then follow each of the code paths to verify the jumps and the stack usage
+	int largestStackUsed = varSpace;
+	asCArray<int> stackAtPos;
+	if( reason == 0 )
+	{
+		stackAtPos.SetLength(length);
+		memset(stackAtPos.AddressOf(), -1, length*sizeof(int));
+
+		asCArray<asUINT> paths;
+		paths.PushLast(0);
+		stackAtPos[0] = varSpace;
+
+		for( asUINT p = 0; p < paths.GetLength() && reason == 0; ++p )
+		{
+			pos = paths[p];
+			int currStackSize = stackAtPos[pos];
+			asBYTE c = *(asBYTE*)&byteCode[pos];
+			// The VM restores the stack pointer on return so there
+			// is no need to check that the stack has been cleared
+			if( c == asBC_RET )
+				continue;
+
+			// Determine the change in stack size for this instruction
+			int stackInc = asBCInfo[c].stackInc;
+			if( stackInc == 0xFFFF )
+			{
+				asCScriptFunction *called = GetCalledFunction(pos);
+				if( called )
+				{
+					stackInc = -called->GetSpaceNeededForArguments();
+					if( called->objectType )
+						stackInc -= AS_PTR_SIZE;
+					if( called->DoesReturnOnStack() )
+						stackInc -= AS_PTR_SIZE;
+				}
+				else
+				{
+					// It is an allocation for an object without a constructor
+					stackInc = -AS_PTR_SIZE;
+				}
+			}
+
+			currStackSize += stackInc;
+			if( currStackSize < varSpace )
+			{
+				reason = TXT_VERIFY_STACK_UNDERFLOW;
+				break;
+			}
+			if( currStackSize > largestStackUsed )
+				largestStackUsed = currStackSize;
+
+			// Determine the instructions that may follow this one
+			asUINT next[2];
+			asUINT numNext = 0;
+			if( c == asBC_JMP )
+				next[numNext++] = pos + 2 + asBC_INTARG(&byteCode[pos]);
+			else if( c == asBC_JZ    || c == asBC_JNZ    ||
+					 c == asBC_JLowZ || c == asBC_JLowNZ ||
+					 c == asBC_JS    || c == asBC_JNS    ||
+					 c == asBC_JP    || c == asBC_JNP )
+			{
+				next[numNext++] = pos + 2;
+				next[numNext++] = pos + 2 + asBC_INTARG(&byteCode[pos]);
+			}
+			else if( c == asBC_JMPP )
+			{
+				// The jump table is formed by the subsequent JMP instructions
+				pos++;
+				if( pos >= length || *(asBYTE*)&byteCode[pos] != asBC_JMP )
+				{
+					reason = TXT_VERIFY_INVALID_JUMP;
+					break;
+				}
+				while( pos < length && *(asBYTE*)&byteCode[pos] == asBC_JMP )
+				{
+					if( stackAtPos[pos] == -1 )
+					{
+						stackAtPos[pos] = currStackSize;
+						paths.PushLast(pos);
+					}
+					else if( stackAtPos[pos] != currStackSize )
+						reason = TXT_VERIFY_STACK_MISMATCH;
+					pos += 2;
+				}
+				continue;
+			}
+			else
+				next[numNext++] = pos + asBCTypeSize[asBCInfo[c].type];
+
+			for( asUINT n = 0; n < numNext; n++ )
+			{
+				pos = next[n];
+				if( pos >= length )
+				{
+					// Negative offsets wrap around and are caught here too
+					reason = n == 0 && c != asBC_JMP ? TXT_VERIFY_END_OF_CODE : TXT_VERIFY_INVALID_JUMP;
+					break;
+				}
+				if( !isInstruction[pos] )
+				{
+					reason = TXT_VERIFY_INVALID_JUMP;
+					break;
+				}
+				if( stackAtPos[pos] == -1 )
+				{
+					stackAtPos[pos] = currStackSize;
+					paths.PushLast(pos);
+				}
+				else if( stackAtPos[pos] != currStackSize )
+				{
+					reason = TXT_VERIFY_STACK_MISMATCH;
+					break;
+				}
+			}
+		}
+	}
+
+	if( reason )
+	{
+		asCString msg;
+		msg.Format(TXT_FUNC_s_FAILED_VERIFICATION_s_d, GetDeclaration(), reason, pos);
+		engine->WriteMessage("", 0, 0, asMSGTYPE_ERROR, msg.AddressOf());
+		return asERROR;
+	}
+
+	isByteCodeVerified = true;
+	if( stackSize )
+		*stackSize = largestStackUsed;
+
+	return asSUCCESS;
+}
+
+// internal
+void asCScriptFunction::ComputeLiveObjectRanges()
+{
+	liveObjectRanges.SetLength(0);
+	liveObjectVars.SetLength(0);
+
+	// Replay the object variable info in the order of the bytecode. When a
+	// block ends the objects created and destroyed inside it are out of scope,
+	// so the state from the beginning of the block is restored
+	asCArray<int> live;
+	live.SetLength(objVariablePos.GetLength());
+	if( live.GetLength() )
+		memset(live.AddressOf(), 0, sizeof(int)*live.GetLength());
+	asCArray<int> blocks;
+
+	for( asUINT n = 0; n < objVariableInfo.GetLength(); )
+	{
+		// Apply all the info for the same program position at once
+		asUINT pos = objVariableInfo[n].programPos;
+		for( ; n < objVariableInfo.GetLength() && objVariableInfo[n].programPos == pos; n++ )
+		{
+			switch( objVariableInfo[n].option )
+			{
+			case asOBJ_UNINIT:
+			case asOBJ_INIT:
+				{
+					// Which variable is this?
+					asUINT var = 0;
+					for( asUINT v = 0; v < objVariablePos.GetLength(); v++ )
+						if( objVariablePos[v] == objVariableInfo[n].variableOffset )
+						{
+							var = v;
+							break;
+						}
+					if( var < live.GetLength() )
+						live[var] += objVariableInfo[n].option == asOBJ_INIT ? 1 : -1;
+				}
+				break;
+			case asBLOCK_BEGIN:
+				for( asUINT v = 0; v < live.GetLength(); v++ )
+					blocks.PushLast(live[v]);
+				break;
+			case asBLOCK_END:
+				if( blocks.GetLength() >= live.GetLength() )
+				{
+					for( asUINT v = live.GetLength(); v-- > 0; )
+						live[v] = blocks.PopLast();
+				}
+				break;
+			}
+		}
+
+		asSLiveObjectRange range;
+		range.programPos = pos;
+		range.firstVar   = liveObjectVars.GetLength();
+		liveObjectRanges.PushLast(range);
+
+		// Nothing is considered live after the last info, as the function is returning
+		if( n == objVariableInfo.GetLength() )
+			break;
+
+		for( asUINT v = 0; v < live.GetLength(); v++ )
+			if( live[v] > 0 )
+				liveObjectVars.PushLast(v);
+	}
+}
+
+// interface
+bool asCScriptFunction::IsByteCodeVerified() const
+{
+	return isByteCodeVerified;
+}
+
 // interface
 void *asCScriptFunction::SetUserData(void *data)
 {
@@ -1108,16 +1663,20 @@ bool asCScriptFunction::GetFlag()
 // internal
 void asCScriptFunction::EnumReferences(asIScriptEngine *)
 {
-	// Notify the GC of all object types used
-	if( returnType.IsObject() )
-		engine->GCEnumCallback(returnType.GetObjectType());
+	// Notify the GC of all object types used. The references
+	// are only held if there is any bytecode, see AddReferences
+	if( byteCode.GetLength() )
+	{
+		if( returnType.IsObject() )
+			engine->GCEnumCallback(returnType.GetObjectType());
 
-	for( asUINT p = 0; p < parameterTypes.GetLength(); p++ )
-		if( parameterTypes[p].IsObject() )
-			engine->GCEnumCallback(parameterTypes[p].GetObjectType());
+		for( asUINT p = 0; p < parameterTypes.GetLength(); p++ )
+			if( parameterTypes[p].IsObject() )
+				engine->GCEnumCallback(parameterTypes[p].GetObjectType());
 
-	for( asUINT t = 0; t < objVariableTypes.GetLength(); t++ )
-		engine->GCEnumCallback(objVariableTypes[t]);
+		for( asUINT t = 0; t < objVariableTypes.GetLength(); t++ )
+			engine->GCEnumCallback(objVariableTypes[t]);
+	}
 
 	// Notify the GC of all script functions that is accessed
 	for( asUINT n = 0; n < byteCode.GetLength(); n += asBCTypeSize[asBCInfo[*(asBYTE*)&byteCode[n]].type] )
@@ -1146,6 +1705,7 @@ void asCScriptFunction::EnumReferences(asIScriptEngine *)
 			break;
 
 		case asBC_CALL:
+		case asBC_TAILCALL:
 		case asBC_CALLINTF:
 			{
 				int func = asBC_INTARG(&byteCode[n]);
@@ -1254,6 +1814,7 @@ void asCScriptFunction::ReleaseAllHandles(asIScriptEngine *)
 			break;
 
 		case asBC_CALL:
+		case asBC_TAILCALL:
 		case asBC_CALLINTF:
 			{
 				int func = asBC_INTARG(&byteCode[n]);
@@ -1304,6 +1865,13 @@ bool asCScriptFunction::IsShared() const
 	return isShared;
 }
 
+// interface
+bool asCScriptFunction::IsPure() const
+{
+	// Only registered functions can be marked as pure, see asIScriptEngine::SetGlobalFunctionPure
+	return sysFuncIntf && sysFuncIntf->isPure;
+}
+
 // internal
 bool asCScriptFunction::IsFinal() const
 {
@@ -77,6 +77,12 @@ struct asSObjectVariableInfo
 	asUINT option;
 };
 
+struct asSLiveObjectRange
+{
+	asUINT programPos; // The range ends where the next range begins
+	asUINT firstVar;   // Index of the first live object variable in liveObjectVars
+};
+
 struct asSSystemFunctionInterface;
 
 // TODO: GetModuleName should be removed. A function won't belong to a specific module anymore
@@ -118,6 +124,7 @@ public:
 	bool                 IsFinal() const;
 	bool                 IsOverride() const;
 	bool                 IsShared() const;
+	bool                 IsPure() const;
 	asUINT               GetParamCount() const;
 	int                  GetParamTypeId(asUINT index, asDWORD *flags = 0) const;
 	int                  GetReturnTypeId() const;
@@ -134,6 +141,7 @@ public:
 
 	// For JIT compilation
 	asDWORD             *GetByteCode(asUINT *length = 0);
+	bool                 IsByteCodeVerified() const;
 
 	// User data
 	void                *SetUserData(void *userData);
@@ -167,6 +175,10 @@ public:
 
 	bool      DoesReturnOnStack() const;
 
+	asCScriptFunction *GetCalledFunction(asDWORD programPos);
+	int       VerifyByteCode(int *stackSize = 0);
+	void      ComputeLiveObjectRanges();
+
 	void      JITCompile();
 
 	void      AddReferences();
@@ -234,6 +246,10 @@ public:
 
 	// Holds information on scope for object variables on the stack
 	asCArray<asSObjectVariableInfo> objVariableInfo;
+	// The object variables that are live in each range of the bytecode, computed from
+	// objVariableInfo so the exception handler doesn't have to interpret it at runtime
+	asCArray<asSLiveObjectRange>    liveObjectRanges;
+	asCArray<asUINT>                liveObjectVars;
 
 	// Holds information on explicitly declared variables
 	asCArray<asSScriptVariable*>    variables;        // debug info
@@ -243,6 +259,8 @@ public:
 	int                             scriptSectionIdx; // debug info
 	asCArray<int>                   sectionIdxs;      // debug info. Store position/index pairs if the bytecode is compiled from multiple script sections
 	bool                            dontCleanUpOnException;   // Stub functions don't own the object and parameters
+	bool                            isBodyPending;    // The bytecode will be loaded on the first call, see asEP_LAZY_LOAD_FUNCTIONS
+	bool                            isByteCodeVerified; // The bytecode has passed the verification, see asEP_VERIFY_BYTECODE
 
 	// Used by asFUNC_VIRTUAL
 	int                          vfTableIdx;
@@ -272,6 +272,25 @@
 #define TXT_EXCEPTION_IN_NESTED_CALL                  "An exception occurred in a nested call"
 #define TXT_TYPE_s_IS_STILL_USED_BY_FUNC_s            "Type '%s' is still used by function '%s'"
 #define TXT_PREV_TYPE_IS_NAMED_s                      "The builtin type in previous message is named '%s'"
+#define TXT_CONFIG_IMAGE_INVALID                      "The config image is invalid or was saved with a different version of the library"
+#define TXT_CONFIG_IMAGE_NOT_RECORDED                 "The config image wasn't recorded. Set asEP_RECORD_CONFIG_IMAGE before registering the application interface"
+#define TXT_COMPRESSED_BYTECODE_CORRUPT               "The compressed bytecode is corrupt"
+#define TXT_BYTECODE_IS_BUNDLE                        "The bytecode holds a bundle of modules and must be loaded with LoadByteCodeBundle"
+#define TXT_BYTECODE_NOT_BUNDLE                       "The bytecode doesn't hold a bundle of modules"
+#define TXT_FUNC_s_FAILED_VERIFICATION_s_d            "The bytecode of function '%s' failed the verification: %s at position %d"
+#define TXT_VERIFY_INVALID_INSTRUCTION                "Invalid instruction"
+#define TXT_VERIFY_INVALID_VARIABLE                   "Invalid variable offset"
+#define TXT_VERIFY_INCONSISTENT_VARIABLE              "Variable used both as pointer and value"
+#define TXT_VERIFY_INVALID_JUMP                       "Invalid jump target"
+#define TXT_VERIFY_INVALID_FUNCTION                   "Invalid function"
+#define TXT_VERIFY_INVALID_TYPE                       "Invalid type"
+#define TXT_VERIFY_INVALID_STRING                     "Invalid string constant"
+#define TXT_VERIFY_INVALID_GLOBAL                     "Invalid global variable"
+#define TXT_VERIFY_INVALID_RETURN                     "Invalid return"
+#define TXT_VERIFY_STACK_MISMATCH                     "Inconsistent stack size"
+#define TXT_VERIFY_STACK_UNDERFLOW                    "Stack underflow"
+#define TXT_VERIFY_STACK_OVERFLOW                     "The stack size exceeds the reserved space"
+#define TXT_VERIFY_END_OF_CODE                        "Execution continues past the end of the function"
 
 // Internal names
 
@@ -290,5 +309,6 @@
 #define TXT_UNBOUND_FUNCTION              "Unbound function called"
 #define TXT_OUT_OF_BOUNDS                 "Out of range"
 #define TXT_EXCEPTION_CAUGHT              "Caught an exception from the application"
+#define TXT_BYTECODE_NOT_LOADED           "Failed to load the function's bytecode"
 
 #endif
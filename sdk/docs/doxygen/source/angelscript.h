@@ -123,7 +123,19 @@ enum asEEngineProp
 	//! When true, the compiler will always provide a default constructor for script classes. Default: false
 	asEP_ALWAYS_IMPL_DEFAULT_CONSTRUCT = 18,
 	//! Set how warnings should be treated: 0 - dismiss, 1 - emit, 2 - treat as error
-	asEP_COMPILER_WARNINGS             = 19
+	asEP_COMPILER_WARNINGS             = 19,
+	//! When true, the value assignment operator for reference types will be disabled. Default: false
+	asEP_DISALLOW_VALUE_ASSIGN_FOR_REF_TYPE = 20,
+	//! When true, the engine records the registered declarations so they can be saved with \ref asIScriptEngine::SaveConfigImage "SaveConfigImage". Default: false
+	asEP_RECORD_CONFIG_IMAGE           = 21,
+	//! When true, the bodies of the functions in loaded bytecode are only restored when first used. The bytecode must also be saved with this turned on. Default: false
+	asEP_LAZY_LOAD_FUNCTIONS           = 22,
+	//! When true, saved bytecode is compressed. Default: false
+	asEP_COMPRESS_BYTECODE             = 23,
+	//! When true, the bytecode is verified after it has been compiled or loaded. Default: false
+	asEP_VERIFY_BYTECODE               = 24,
+	//! When true, tail calls between script functions are replaced with jumps. Default: false
+	asEP_ELIMINATE_TAIL_CALLS          = 25
 };
 
 // Calling conventions
@@ -592,6 +604,8 @@ typedef void (*asCLEANCONTEXTFUNC_t)(asIScriptContext *);
 typedef void (*asCLEANFUNCTIONFUNC_t)(asIScriptFunction *);
 //! The function signature for the object type cleanup callback function
 typedef void (*asCLEANOBJECTTYPEFUNC_t)(asIObjectType *);
+//! The function signature for the string constant callback function
+typedef void *(*asSTRINGCONSTANTFUNC_t)(const char *, asUINT, void *);
 
 // This macro does basically the same thing as offsetof defined in stddef.h, but
 // GNUC should not complain about the usage as I'm not using 0 as the base pointer.
@@ -1223,6 +1237,34 @@ public:
 	//! \return The type id of the type that the string type returns, or a negative value on error.
 	//! \retval asNO_FUNCTION The string factory has not been registered.
 	virtual int GetStringFactoryReturnTypeId() const = 0;
+	//! \brief Sets a callback for creating the string objects for the string constants in advance.
+	//! \param[in] callback The function that creates the string object, or null to stop using the objects.
+	//! \param[in] param A user defined parameter that will be passed to the callback.
+	//! \return A negative value on error.
+	//! \retval asNOT_SUPPORTED The string factory hasn't been registered or doesn't return a reference.
+	//!
+	//! The callback is called once for each string constant when a script is compiled or 
+	//! loaded, and once for each of the existing constants when the callback is set. It will 
+	//! receive the character data, the length of the string constant in bytes, and the \a param. 
+	//! It should return a pointer to the string object that the \ref RegisterStringFactory 
+	//! "string factory" would return a reference to for the same constant.
+	//!
+	//! The engine keeps the returned objects, so when the script evaluates a string constant 
+	//! the object is used directly instead of calling the string factory. The string factory 
+	//! must still be registered, as it is called by JIT compiled code and for the constants 
+	//! that the callback returned null for. The objects must stay valid until the engine is released.
+	//!
+	//! \code
+	//! // The objects are kept in the engine's string pool
+	//! void *CreateStringConstant(const char *s, asUINT length, void *param)
+	//! {
+	//!     StringPool *pool = reinterpret_cast<StringPool*>(param);
+	//!     return pool->Add(std::string(s, length));
+	//! }
+	//!
+	//! int r = engine->SetStringConstantCallback(CreateStringConstant, pool); assert( r >= 0 );
+	//! \endcode
+	virtual int SetStringConstantCallback(asSTRINGCONSTANTFUNC_t callback, void *param) = 0;
 	//! \}
 
 	// Default array type
@@ -1406,6 +1448,38 @@ public:
 	virtual const char *GetDefaultNamespace() const = 0;
 	//! \}
 
+	// Configuration image
+	//! \name Configuration image
+	//! \{
+
+	//! \brief Saves the recorded configuration image to a stream.
+	//! \param[in] out The output stream
+	//! \return A negative value on error
+	//! \retval asINVALID_ARG The stream is null.
+	//! \retval asERROR The engine property \ref asEP_RECORD_CONFIG_IMAGE wasn't set before the registration.
+	//!
+	//! The configuration image holds the result of parsing and validating the declarations 
+	//! given to the registration methods. Set the engine property \ref asEP_RECORD_CONFIG_IMAGE 
+	//! before registering the application interface, and then call this method to save the image.
+	//!
+	//! \see \ref doc_finetuning_6
+	virtual int SaveConfigImage(asIBinaryStream *out) const = 0;
+	//! \brief Loads a configuration image that will be used by the following registrations.
+	//! \param[in] in The input stream, or null to discard the previously loaded image
+	//! \return A negative value on error
+	//! \retval asERROR The image is invalid or was saved with a different version of the library.
+	//! \retval asOUT_OF_MEMORY There wasn't enough memory to load the image.
+	//!
+	//! The application must still make the same registration calls as when the image was 
+	//! saved, so that the engine receives the function pointers. For each declaration that is 
+	//! found in the image the engine skips the parsing and restores the signature directly. 
+	//! Declarations that are not found in the image, or that no longer match the registered 
+	//! types, are parsed as normal.
+	//!
+	//! \see \ref doc_finetuning_6
+	virtual int LoadConfigImage(asIBinaryStream *in) = 0;
+	//! \}
+
 	// Script modules
 	//! \name Script modules
 	//! \{
@@ -1823,6 +1897,14 @@ public:
 	//! asINIT_GLOBAL_VARS_FAILED, then it is probable that one of the global variables during the initialization 
 	//! is trying to access another global variable before it has been initialized. 
 	virtual int         Build() = 0;
+	//! \brief Returns an id that identifies the current content of the module.
+	//! \return The build id.
+	//!
+	//! The id changes each time the module is built, loaded from bytecode, or discarded, and
+	//! it is unique among all the modules in the engine. The application can use it to tell
+	//! if the functions it has obtained from a module are still the ones the module holds,
+	//! even if another module has since been created at the same address.
+	virtual asUINT      GetBuildId() const = 0;
 	//! \brief Compile a single function.
 	//! \param[in] sectionName The name of the script section
 	//! \param[in] code The script code buffer
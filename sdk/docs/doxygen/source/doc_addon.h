@@ -242,8 +242,13 @@ Multiple context managers can be used, for example when you have a group of scri
 ingame objects, and another group of scripts controlling GUI elements, then each of these groups
 may be managed by different context managers.
 
-Observe, that the context manager class hasn't been designed for multithreading, so you need to
-be careful if your application needs to execute scripts from multiple threads.
+The context manager can spread the execution of the scripts over multiple threads with 
+<code>SetWorkerThreadCount</code>. Each script, together with its co-routines, is always executed by
+one thread at a time, and is normally given to the same thread as the last time. Threads that run out 
+of scripts to execute take over scripts from the others. Apart from that the class hasn't been designed 
+for multithreading, so the application must not call the methods from other threads while 
+<code>ExecuteScripts</code> is running. The worker threads require a compiler with support for C++11 
+threads, and can be turned off by defining AS_NO_CONTEXTMGR_THREADS.
 
 \see The samples \ref doc_samples_concurrent and \ref doc_samples_corout for uses
 
@@ -270,29 +275,55 @@ public:
   //
   //  void createCoRoutine(const string &in functionName, any @arg)
   //  void yield()
+  //
+  // Each co-routine is executed in a context of its own, and continues after the
+  // script that created it has ended, unless SetLightWeightCoRoutines() is used.
   void RegisterCoRoutineSupport(asIScriptEngine *engine);
 
+  // Let createCoRoutine() create light weight co-routines that are executed by the
+  // context of the script that created them, so each co-routine only needs its own
+  // small stack. These co-routines end with the main script function of the thread.
+  // The default is false, i.e. each co-routine is given a context of its own.
+  void SetLightWeightCoRoutines(bool enable);
+  bool GetLightWeightCoRoutines() const;
+
   // Create a new context, prepare it with the function, then return 
   // it so that the application can pass the argument values. The context
   // will be released by the manager after the execution has completed.
   asIScriptContext *AddContext(asIScriptEngine *engine, asIScriptContext *func);
 
+  // Create a new co-routine for the function in the context, then return
+  // it so that the application can pass the argument values. The co-routine
+  // will be added in the same thread as the currCtx.
+  asIScriptCoroutine *AddCoRoutine(asIScriptContext *currCtx, asIScriptFunction *func);
+
   // Create a new context, prepare it with the function, then return
-  // it so that the application can pass the argument values. The context
-  // will be added as a co-routine in the same thread as the currCtx.
-  asIScriptContext *AddContextForCoRoutine(asIScriptContext *currCtx, asIScriptContext *func);
+  // it so that the application can pass the argument values. The function
+  // is executed in a context of its own, like the scripts added with 
+  // AddContext(), so unlike the co-routines above it continues after the 
+  // currCtx has finished.
+  asIScriptContext *AddContextForCoRoutine(asIScriptContext *currCtx, asIScriptFunction *func);
 
   // Execute each script that is not currently sleeping. The function returns after 
   // each script has been executed once. The application should call this function
   // for each iteration of the message pump, or game loop, or whatever.
   void ExecuteScripts();
 
+  // Set the number of threads that ExecuteScripts() uses, including the calling thread.
+  // The default is 1, i.e. all scripts are executed by the calling thread. With more
+  // threads each script is still executed once per call, and a script is always executed
+  // by one thread at a time, together with its co-routines. Each script is given to the
+  // thread that executed it the last time, and threads that run out of scripts take over
+  // scripts from the others. Returns asNOT_SUPPORTED if compiled without thread support.
+  int    SetWorkerThreadCount(asUINT numThreads);
+  asUINT GetWorkerThreadCount() const;
+
   // Put a script to sleep for a while
   void SetSleeping(asIScriptContext *ctx, asUINT milliSeconds);
 
-  // Switch the execution to the next co-routine in the group.
-  // Returns true if the switch was successful.
-  void NextCoRoutine();
+  // Switch the execution to the next co-routine in the group after
+  // the current one. The switch is done when the context is suspended.
+  void NextCoRoutine(asIScriptCoroutine *current);
 
   // Abort all scripts
   void AbortAll();
@@ -381,12 +412,100 @@ public:
   void SortAsc(asUINT index, asUINT count);
   void SortDesc();
   void SortDesc(asUINT index, asUINT count);
+  void StableSortAsc();
+  void StableSortAsc(asUINT index, asUINT count);
+  void StableSortDesc();
+  void StableSortDesc(asUINT index, asUINT count);
+  void Sort(asUINT index, asUINT count, bool asc, bool stable = false);
+  void Sort(asIScriptFunction *less, asUINT index, asUINT count, bool stable = false);
   void Reverse();
   int  Find(void *value) const;
   int  Find(asUINT index, void *value) const;
+  // Returns a new array<uint> with the indices of the equal elements
+  CScriptArray *FindAll(void *value) const;
+  void Fill(void *value);
+
+  // Compute the sum, or find the smallest or largest element. Only arrays of 
+  // primitives are supported. Sum stores the result in sum, which must have room 
+  // for one element, and returns false on failure. Min and Max return 0 on failure
+  bool        Sum(void *sum) const;
+  const void *Min() const;
+  const void *Max() const;
+
+  // Returns a new arrayview<T> of count elements beginning at start, and then every 
+  // stride element. The count is reduced to the number of available elements
+  CScriptArrayView *View(asUINT start = 0, asUINT count = asUINT(-1), asUINT stride = 1);
 };
+
+// A view of a part of an array, which shares the elements with the array
+class CScriptArrayView
+{
+public:
+  // Memory management
+  void AddRef() const;
+  void Release() const;
+
+  // Type information
+  asIObjectType *GetViewObjectType() const;
+  int            GetElementTypeId() const;
+
+  // The array and the position of the elements in it
+  CScriptArray  *GetArray() const;
+  asUINT         GetOffset() const;
+  asUINT         GetStride() const;
+
+  // Get the number of elements in the view
+  asUINT GetSize() const;
+  bool   IsEmpty() const;
+
+  // Get a pointer to an element. Returns 0 if out of bounds
+  void       *At(asUINT index);
+  const void *At(asUINT index) const;
+  void        SetValue(asUINT index, void *value);
+
+  // Compare the elements of two views
+  bool operator==(const CScriptArrayView &) const;
+
+  // Returns a new view of the elements of this view
+  CScriptArrayView *View(asUINT start = 0, asUINT count = asUINT(-1), asUINT stride = 1);
+
+  // The same algorithms as the array, applied to the elements of the view
+  void SortAsc();
+  void SortDesc();
+  void StableSortAsc();
+  void StableSortDesc();
+  void Sort(asIScriptFunction *less, bool stable = false);
+  void Reverse();
+  int  Find(void *value) const;
+  int  Find(asUINT index, void *value) const;
+  CScriptArray *FindAll(void *value) const;
+  void Fill(void *value);
+  bool        Sum(void *sum) const;
+  const void *Min() const;
+  const void *Max() const;
+};
+
+// Sorting, fill(), sum(), min(), max(), and find() split the work between up to numThreads
+// threads for arrays of primitives and handles with at least minElements elements
+void SetScriptArrayParallelism(asIScriptEngine *engine, asUINT numThreads, asUINT minElements = 100000, ARRAYPARALLELFUNC_t callback = 0);
 \endcode
 
+The application can let the array use its own thread pool by passing a callback to SetScriptArrayParallelism(). The 
+callback must call the task function once for each task number, and only return when all of them have completed. 
+Without a callback the add-on starts its own worker threads with the C++11 thread library, unless it is compiled 
+with AS_NO_SCRIPTARRAY_THREADS. The workers are reused by all the calls until the setting is changed or the engine 
+is released. The setting is stored per engine, and must not be changed while scripts are executing in the engine. Only the algorithms that don't call script functions, e.g. the opCmp of objects, 
+are executed in parallel. The sum is computed in the same order regardless of the number of threads, so the result 
+of floating point arrays doesn't vary with the setting.
+
+When compiled for a target with SSE2 the add-on also uses vector instructions to find, compare, reverse, and 
+fill arrays of primitives and handles. Define AS_NO_SCRIPTARRAY_SIMD to compile the add-on without them.
+
+The views hold a reference to the array, so the array stays alive as long as any view of it. The views don't 
+follow the changes in the size of the array, and accessing an element that the array no longer holds raises a 
+script exception. Views with a stride other than 1 copy the primitive values or the pointers to a temporary 
+buffer for the sorting and searching algorithms, while views without a stride work directly on the array's buffer.
+
 \section doc_addon_array_2 Public script interface
 
 \see \ref doc_datatypes_arrays_addon "Arrays in the script language"
@@ -619,8 +738,10 @@ in the script code. However, this is most likely only a problem for scripts
 that perform a lot of string operations.
 
 Register the type with <code>RegisterStdString(asIScriptEngine*)</code>. Register the optional
-split method and global join function with <code>RegisterStdStringUtils(asIScriptEngine*)</code>. 
+split, tokenize, replace, and count methods and global join function with <code>RegisterStdStringUtils(asIScriptEngine*)</code>. 
 The optional functions require that the \ref doc_addon_array has been registered first.
+Register the optional \ref doc_datatypes_strings_addon_builder "stringbuilder" type with 
+<code>RegisterStdStringBuilder(asIScriptEngine*)</code>, after the string type.
 
 Compile the add-on with the pre-processor define AS_USE_STLNAMES = 1 to register the methods with the same names as used by C++ STL where 
 the methods have the same significance. Not all methods from STL is implemented in the add-on, but many of the most frequent ones are 
@@ -657,6 +778,12 @@ Compile the add-on with the pre-processor define AS_USE_STLNAMES=1 to register t
 the methods have the same significance. Not all methods from STL is implemented in the add-on, but many of the most frequent once are 
 so a port from script to C++ and vice versa might be easier if STL names are used.
 
+The keys are stored in a hash table, so the time to find a key doesn't depend on the number of keys in the 
+dictionary. Compile the add-on with AS_USE_DICTIONARY_KEYCACHE=1 to make the dictionary remember where the most 
+recently used keys were found by the address of the string, so a script that uses the pooled string constants 
+as keys will normally not have to compute the hash of the key. The cache is updated by the const methods too, 
+so it must not be turned on if the same dictionary is read by multiple threads at the same time.
+
 \section doc_addon_dict_1 Public C++ interface
 
 \code
@@ -694,6 +821,9 @@ public:
   
   // Returns the number of keys in the dictionary
   asUINT GetSize() const;
+
+  // Allocates memory for numKeys keys, so they can be added without growing the table
+  void Reserve(asUINT numKeys);
   
   // Deletes the key
   void Delete(const std::string &key);
@@ -726,6 +856,7 @@ public:
     void deleteAll();
     bool isEmpty() const;
     uint getSize() const;
+    void reserve(uint numKeys);
   }
 </pre>
 
@@ -762,7 +893,15 @@ public:
 
 This object provides support for reading and writing files.
 
-Register with <code>RegisterScriptFile(asIScriptEngine*)</code>.
+Register with <code>RegisterScriptFile(asIScriptEngine*)</code>. The methods that read many 
+values into arrays are registered with <code>RegisterScriptFileUtils(asIScriptEngine*)</code>, 
+which requires that the \ref doc_addon_array has been registered first. These are implemented 
+in scriptfile_utils.cpp so that applications that don't use them don't need to include the array add-on.
+
+Large files can be opened with the mode "rl", which reads the file through a 
+buffer of AS_SCRIPTFILE_BUFFER_SIZE bytes, or the mode "rm", which maps the whole 
+file into memory. If the file cannot be mapped, e.g. because the platform doesn't 
+support it or the file is empty, the "rm" mode falls back to the "rl" mode.
 
 If you do not want to provide write access for scripts then you can compile 
 the add on with the define AS_WRITE_OPS 0, which will disable support for writing. 
@@ -786,6 +925,8 @@ public:
   // mode = "r" -> open the file for reading
   // mode = "w" -> open the file for writing (overwrites existing files)
   // mode = "a" -> open the file for appending
+  // mode = "rl" -> open the file for reading through a large buffer
+  // mode = "rm" -> map the file into memory for reading
   int Open(const std::string &filename, const std::string &mode);
   int Close();
   
@@ -812,6 +953,20 @@ public:
 
   // Reads a double
   double   ReadDouble();
+
+  // Reads the rest of the file into the string
+  int      ReadToEnd(std::string &str);
+
+  // Reads the next line without the new-line characters. The line is 
+  // stored in a string that is reused so no memory is allocated per line
+  bool     ReadNextLine();
+  const std::string &GetLine() const;
+
+  // Reads up to count values into a new array (requires scriptfile_utils.cpp)
+  CScriptArray *ReadInts(asUINT count, asUINT bytes);
+  CScriptArray *ReadUInts(asUINT count, asUINT bytes);
+  CScriptArray *ReadFloats(asUINT count);
+  CScriptArray *ReadDoubles(asUINT count);
     
   // Writes a string to the file
   int WriteString(const std::string &str);
@@ -839,7 +994,7 @@ public:
   {
     int      open(const string &in filename, const string &in mode);
     int      close();
-    int      getSize() const;
+    int64    getSize() const;
     bool     isEndOfFile() const;
     int      readString(uint length, string &out str);
     int      readLine(string &out str);
@@ -847,15 +1002,24 @@ public:
     uint64   readUInt(uint bytes);
     float    readFloat();
     double   readDouble();
+    int64    readToEnd(string &out str);
+    bool     readNextLine();
+    const string &line;   // read-only
     int      writeString(const string &in string);
     int      writeInt(int64 value, uint bytes);
     int      writeUInt(uint64 value, uint bytes);
     int      writeFloat(float value);
     int      writeDouble(double value);
-    int      getPos() const;
-    int      setPos(int pos);
-    int      movePos(int delta);
+    int64    getPos() const;
+    int      setPos(int64 pos);
+    int      movePos(int64 delta);
     bool     mostSignificantByteFirst;
+
+    // Registered with RegisterScriptFileUtils
+    array<int64>@  readInts(uint count, uint bytes);
+    array<uint64>@ readUInts(uint count, uint bytes);
+    array<float>@  readFloats(uint count);
+    array<double>@ readDoubles(uint count);
   }
 </pre>
 
@@ -871,6 +1035,16 @@ public:
       f.readString(f.getSize(), str); 
       f.close();
   }
+
+  // Iterate over the lines of a large file
+  if( f.open("log.txt", "rm") >= 0 )
+  {
+      int errors = 0;
+      while( f.readNextLine() )
+          if( f.line.findFirst("ERROR") >= 0 )
+              errors++;
+      f.close();
+  }
 </pre>
 
 
@@ -1225,7 +1399,13 @@ void RegisterWrapper(asIScriptEngine *engine)
 
 \section doc_addon_autowrap_2 Adding support for more parameters
 
-The aswrappedcall.h header file is by default prepared to support functions with up to 4 arguments. 
+When the compiler supports C++11 the wrappers are implemented with variadic templates, so functions
+with any number of arguments are supported. These wrappers read the arguments directly from the argument
+buffer returned by \ref asIScriptGeneric::GetAddressOfArgs "GetAddressOfArgs", with the offset of each argument
+computed at compile time, so they are about as fast as a hand written wrapper. Define AS_NO_VARIADIC_WRAPPERS
+to use the older templates instead.
+
+Without C++11 the aswrappedcall.h header file is by default prepared to support functions with up to 4 arguments. 
 If you have a need for more arguments then you can use the generator that you find in the sub-directory 
 to prepare a new header file.
 
@@ -1263,6 +1443,31 @@ int CompareEquality(asIScriptEngine *engine, void *leftObj, void *rightObj, int
 // The caller can optionally provide its own context, for example if a context should be reused.
 int ExecuteString(asIScriptEngine *engine, const char *code, asIScriptModule *mod = 0, asIScriptContext *ctx = 0);
 
+// Keeps the functions compiled by ExecuteString in an LRU cache keyed by the code and the name of 
+// the module, and reuses the contexts, so statements that are executed repeatedly are only compiled 
+// once. The functions compiled for a module that has been rebuilt or no longer exists are dropped when 
+// the next function is compiled. Call ClearModule() before a module that has been used with the cache 
+// is rebuilt to release the references to the old entities right away.
+class CExecuteStringCache
+{
+public:
+  CExecuteStringCache(asIScriptEngine *engine, asUINT maxFunctions = 64);
+
+  // Same as ExecuteString, but reuses the compiled function and the context
+  int Execute(const char *code, asIScriptModule *mod = 0, asIScriptContext *ctx = 0);
+
+  // Prepares a context for executing code that takes parameters, e.g. "int a, const string &in b".
+  // The arguments are set with the context's SetArg methods before calling Execute on the context,
+  // and then the context is given back with ReturnContext.
+  int  Prepare(const char *code, const char *params, asIScriptModule *mod, asIScriptContext **ctx);
+  void ReturnContext(asIScriptContext *ctx);
+
+  // Release the cached functions
+  void   Clear();
+  void   ClearModule(asIScriptModule *mod);
+  asUINT GetCachedCount() const;
+};
+
 // Write registered application interface to file.
 // This function creates a file with the configuration for the offline compiler, asbuild, in the samples.
 // If you wish to use the offline compiler you should call this function from you application after the 
@@ -6,8 +6,9 @@ Co-routines is a way to allow multiple execution paths in parallel, but without
 \ref doc_adv_concurrent "multithreading" where one thread can be suspended at any moment so another can resume. Because co-routines always voluntarily
 suspend themselves in favor of the next co-routine, there is no need to worry about atomic instructions and critical sections. 
 
-Co-routines are not natively built-into the AngelScript library, but it can easily be implemented from the application side. 
-In fact, the \ref doc_addon_ctxmgr add-on already provides a default implementation for this.
+Co-routines can be implemented from the application side with one context per co-routine, or with the 
+\ref doc_adv_coroutine_1 "light weight co-routines" that the contexts provide. The \ref doc_addon_ctxmgr add-on already 
+provides a default implementation that uses the latter.
 
 To implement your own version of co-routines you will need a couple of pieces:
 
@@ -96,6 +97,45 @@ void Execute()
 \endcode
 
 
+
+\section doc_adv_coroutine_1 Light weight co-routines
+
+A context is a rather heavy object, so if the application needs very many co-routines it is better to let them 
+share the same context. \ref asIScriptContext::CreateCoroutine "CreateCoroutine" creates an \ref asIScriptCoroutine 
+for a global script function that returns void. The co-routine only holds its own call stack and a small stack
+memory, that grows when needed, while all other settings, e.g. the line callback, are taken from the context.
+
+A script function can be executed as a co-routine like this:
+
+\code
+void Resume(asIScriptCoroutine *co)
+{
+  asIScriptContext *ctx = asGetActiveContext();
+
+  // The co-routine will execute as soon as this function returns, until it yields or returns
+  if( ctx->ResumeCoroutine(co) < 0 )
+    ctx->SetException("Cannot resume co-routine");
+}
+
+void Yield()
+{
+  asIScriptContext *ctx = asGetActiveContext();
+
+  // The execution will continue right after the call that resumed the co-routine
+  if( ctx->YieldCoroutine() < 0 )
+    ctx->SetException("Not in a co-routine");
+}
+\endcode
+
+The switch is done by the VM without returning from \ref asIScriptContext::Execute "Execute", so it is as cheap as a
+normal function call. A co-routine can resume other co-routines, in which case a yield returns to the co-routine that 
+resumed it. The application can also resume or yield a co-routine while the context is suspended, in which case the 
+switch is made immediately and the execution continues with the next call to Execute.
+
+If a script exception occurs in a co-routine the execution of the context is ended, and the co-routine and those that 
+resumed it are cleaned up when the context is prepared again. A co-routine that hasn't finished when it is released, or when
+the context is released, is discarded and the objects on its stack are released.
+
 \see \ref doc_addon_ctxmgr, \ref doc_samples_corout, \ref doc_adv_concurrent
 
 
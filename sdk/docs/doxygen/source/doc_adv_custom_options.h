@@ -140,6 +140,12 @@ CPU can be spared.
 
 Compiler warnings can be turned off or treated as errors by setting this engine property.
 
+\ref asEP_ELIMINATE_TAIL_CALLS
+
+When this option is turned on the compiler will let a call to a script function that is immediately followed by the return 
+reuse the stack frame of the calling function. This allows deeply recursive scripts to execute without growing the stack, 
+but as the frames of the calling functions are gone they will no longer be seen in the callstack when debugging.
+
 
 
 
@@ -403,6 +403,10 @@ Setup the VM to begin execution of the other script function
  - \ref asBC_CALLINTF
  - \ref asBC_CALLBND
  - \ref asBC_CallPtr
+
+Setup the VM to replace the current function with the other script function
+
+ - \ref asBC_TAILCALL
  
 Setup the VM to return to the calling function 
  
@@ -75,6 +75,63 @@ protected:
    line numbers, and the name and type of local variables. 
 
 
+\section doc_adv_precompile_2 Saving a suspended execution
+
+A script that has been suspended can also be saved, so it can be continued later on, perhaps after the 
+application has been restarted or in another process. \ref asIScriptContext::SaveExecutionState "SaveExecutionState" 
+writes the call stack of the suspended context to the binary stream, with the local variables and the position 
+in each of the functions. The functions are identified by the module name and the declaration, so 
+\ref asIScriptContext::LoadExecutionState "LoadExecutionState" can restore the execution in a fresh context, 
+on any engine where the same modules have been built or loaded.
+
+The engine doesn't know how to save the objects that the script holds, so the application must implement
+the \ref asIContextSerializer interface to save and restore them. Value types are to be constructed in the
+memory given to \ref asIContextSerializer::LoadObject "LoadObject", while reference types are returned with
+a reference that the context will own. The same object can be saved more than once, e.g. if a method is 
+executing on an object held by the calling function, so the application should keep track of the objects 
+if it is important that they are restored as a single instance.
+
+\code
+class CStateSerializer : public asIContextSerializer
+{
+public:
+  int SaveObject(asIBinaryStream *out, void *obj, int typeId)
+  {
+    if( typeId != stringTypeId ) return -1;
+    std::string &str = *(std::string*)obj;
+    asUINT len = (asUINT)str.length();
+    out->Write(&len, sizeof(len));
+    out->Write(str.c_str(), len);
+    return 0;
+  }
+  void *LoadObject(asIBinaryStream *in, void *mem, int typeId)
+  {
+    if( typeId != stringTypeId ) return 0;
+    asUINT len;
+    in->Read(&len, sizeof(len));
+    std::string str(len, ' ');
+    in->Read(&str[0], len);
+    return new(mem) std::string(str);
+  }
+  int stringTypeId;
+};
+\endcode
+
+Some things to be aware of:
+
+ - Only the execution is saved. Global variables must be saved separately, e.g. with the \ref doc_addon_serializer add-on.
+
+ - The saved state is not platform independent, as the local variables are stored as they are in memory.
+
+ - The execution cannot be saved while it is nested, executing co-routines, or waiting for an asynchronous 
+   call. Neither can it be saved if a function holds a reference to something that isn't restored with the
+   execution, e.g. an object member or the memory of the application. In these cases the method returns \ref asNOT_SUPPORTED.
+
+ - The execution can only be saved between statements, i.e. when suspended from the line callback, or by a 
+   registered function whose call completes the statement in each of the functions on the call stack. Otherwise
+   temporary values that may refer to memory outside the context are kept on the stack, and the method returns
+   \ref asNOT_SUPPORTED. For the same reason the script must not be built with \ref asEP_BUILD_WITHOUT_LINE_CUES.
+
 
 
 */
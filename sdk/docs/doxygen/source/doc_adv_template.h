@@ -54,9 +54,13 @@ r = engine->RegisterObjectBehaviour("myTemplate<T>", asBEHAVE_LIST_FACTORY, "myT
 
 
 Remember that since the subtype must be determined dynamically at runtime, it is not possible to declare
-functions to receive the subtype by value, nor to return it by value. Instead you'll have to design the
-methods and behaviours to take the type by reference. It is possible to use object handles, but then
-the script engine won't be able to instanciate the template type for primitives and other values types.
+functions to receive the subtype by value. Instead you'll have to design the methods and behaviours to 
+take the type by reference. It is possible to use object handles, but then the script engine won't be 
+able to instanciate the template type for primitives and other values types.
+
+Functions that return the subtype by value must use the \ref doc_generic "generic calling convention", 
+and store the value at \ref asIScriptGeneric::GetAddressOfReturnLocation "GetAddressOfReturnLocation". 
+When the template is instanciated for a reference type the function returns a handle to the object instead.
 
 \see \ref doc_addon_array
 
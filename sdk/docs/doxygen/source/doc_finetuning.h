@@ -135,4 +135,27 @@ engine->SetEngineProperty(asEP_AUTO_GARBAGE_COLLECT, false);
 
 
 
+
+\section doc_finetuning_6 Skip parsing the registered interface with a configuration image
+
+Applications that register a large interface spend a considerable amount of time parsing 
+the declarations each time a new engine is created. The result of the parsing can be saved 
+in a configuration image, and then loaded into the engines that are created afterwards.
+
+\code
+// Record the configuration while registering the interface
+engine->SetEngineProperty(asEP_RECORD_CONFIG_IMAGE, true);
+RegisterApplicationInterface(engine);
+engine->SaveConfigImage(&stream);
+
+// Load the image in a new engine before registering the same interface
+engine2->LoadConfigImage(&stream);
+RegisterApplicationInterface(engine2);
+\endcode
+
+The registration calls must still be made as the engine needs the function pointers. The
+image is only valid for the same version of the library.
+
+
+
 */
\ No newline at end of file
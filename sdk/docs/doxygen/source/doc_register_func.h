@@ -160,6 +160,73 @@ If you have a lot of classes with virtual inheritance, you should probably think
 you don't have to manually write all the proxy functions. 
 
 
+\section doc_register_func_5 Pure functions
+
+Global functions whose result only depends on the arguments, and that have no side effects, e.g. most mathematical functions,
+can be marked as pure with \ref asIScriptEngine::SetGlobalFunctionPure "SetGlobalFunctionPure". When a pure function is called
+with constant arguments the compiler will call the function already during the compilation and use the result as a constant,
+which also allows it to be used to initialize constant global variables without any code executed during the module initialization.
+
+\code
+int r = engine->RegisterGlobalFunction("float sqrt(float)", asFUNCTIONPR(sqrtf, (float), float), asCALL_CDECL); assert( r >= 0 );
+r = engine->SetGlobalFunctionPure(engine->GetFunctionById(r), true); assert( r >= 0 );
+\endcode
+
+Only functions that take and return primitive types by value can be marked as pure. If the function sets a script exception
+when called by the compiler, the call is instead compiled as usual so the exception is raised when the script is executed.
+
+
+
+\section doc_register_func_6 Asynchronous functions
+
+A registered function that depends on something that takes time, e.g. a database query or a file being loaded, doesn't have 
+to block the thread until the result is ready. Instead it can start an asynchronous call with \ref asIScriptContext::BeginAsyncCall 
+"BeginAsyncCall" and return right away. The context is then suspended when the function returns, and the thread that called 
+\ref asIScriptContext::Execute "Execute" is free to do other work. 
+
+When the result is ready the application gives it to the \ref asIAsyncCall and calls \ref asIAsyncCall::Complete "Complete", 
+or \ref asIAsyncCall::CompleteWithException "CompleteWithException" if the call failed. This may be done from any thread. 
+On completion the engine invokes the callback set with \ref asIScriptEngine::SetAsyncCallCallback "SetAsyncCallCallback" 
+so the application can schedule the context to continue the execution, just as if the registered function had returned the 
+result directly.
+
+\code
+void CountRows(asIScriptGeneric *gen)
+{
+  asIAsyncCall *call = asGetActiveContext()->BeginAsyncCall();
+
+  // The query will call OnQueryDone from a worker thread when it is done
+  StartQuery(*(std::string*)gen->GetArgObject(0), call);
+}
+
+void OnQueryDone(asIAsyncCall *call, bool ok, int rows)
+{
+  if( ok )
+  {
+    call->SetReturnDWord(rows);
+    call->Complete();
+  }
+  else
+    call->CompleteWithException("The query failed");
+  call->Release();
+}
+
+// Called when the context can continue the execution
+void ScheduleContext(asIScriptContext *ctx, void *param)
+{
+  ctx->AddRef();
+  readyQueue.push(ctx);
+}
+\endcode
+
+While the context is waiting the call holds a reference to it, so the application doesn't have to keep track of it. The 
+reference is given to the callback on completion, so the callback must add its own reference if it will keep the context. 
+If the call is completed before the registered function returns the script continues without being suspended. 
+
+Only functions that are called from a script function can complete asynchronously, and they cannot return value types by value. 
+If the context is aborted while waiting, the call is discarded and \ref asIAsyncCall::Complete "Complete" will return an error.
+
+
 
 
 
@@ -441,6 +441,17 @@ These methods should be registered with \ref doc_register_func "RegisterObjectMe
 useful when the offset of the property cannot be determined, or if the type of the property is 
 not registered in the script and some translation must occur, i.e. from <tt>char*</tt> to <tt>string</tt>.
 
+If the accessors only read or write a member of a primitive type, i.e. they exist to keep the interface
+stable rather than to do any work, they can be registered with RegisterObjectFieldAccessor together with
+the offset of the member. The compiler will then access the member directly, just as if it had been
+registered with RegisterObjectProperty, while the script still sees the accessors. A property with the
+same name is added to the type for this, which is read-only unless the set accessor is registered.
+
+\code
+r = engine->RegisterObjectFieldAccessor("mytype", "int get_a() const", asOFFSET(MyStruct,a)); assert( r >= 0 );
+r = engine->RegisterObjectFieldAccessor("mytype", "void set_a(int)", asOFFSET(MyStruct,a)); assert( r >= 0 );
+\endcode
+
 If the application class contains a C++ array as a member, it may be advantageous to expose the array
 through \ref doc_script_class_prop "indexed property accessors" rather than attempting to matching the
 C++ array type to a registered type in AngelScript. To do this you can create a couple of simple proxy functions
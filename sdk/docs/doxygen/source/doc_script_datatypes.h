@@ -138,10 +138,45 @@ to use handles to the array object when passing it around to avoid costly copies
   - void sortAsc(uint index, uint count);
   - void sortDesc();
   - void sortDesc(uint index, uint count);
+  - void stableSortAsc();
+  - void stableSortAsc(uint index, uint count);
+  - void stableSortDesc();
+  - void stableSortDesc(uint index, uint count);
+  - void sort(const less &in, uint startAt = 0, uint count = uint(-1));
+  - void stableSort(const less &in, uint startAt = 0, uint count = uint(-1));
   - int  find(const T& in);
   - int  find(uint index, const T& in);
+  - array<uint>@ findAll(const T& in) const;
+  - void fill(const T& in);
+  - T sum() const;
+  - const T& min() const;
+  - const T& max() const;
+  - arrayview<T>@ view(uint start = 0, uint count = uint(-1), uint stride = 1);
 
 The T represents the type of the array elements.
+
+The sortAsc() and sortDesc() methods don't preserve the order of equal elements. Use the stable 
+variants if that is needed. The sort() and stableSort() methods take a handle to a function with 
+the signature <tt>bool less(const T &in a, const T &in b)</tt> that should return true if a 
+should be placed before b. For primitive types the parameters can also be taken by value.
+
+The sum(), min(), and max() methods are only supported for arrays of primitives, and min() and max() will 
+raise an exception if the array is empty. The sum() method doesn't support arrays of bool. 
+
+The view() method returns a handle to an arrayview<T> with count elements of the array, beginning at 
+start and then every stride element. The view doesn't copy the elements, so changes made through the view 
+are seen in the array and vice versa. The count is reduced to the number of elements that are available. 
+The view has the index operator, the length, offset, and stride properties, and the same methods as the 
+array for sorting, searching, filling, and computing the sum, minimum, and maximum of the elements, except 
+that these always work on all the elements of the view. The view also has a view() method that returns a 
+view of the elements of the view. If the array is made smaller so it no longer has all the elements of 
+the view, then the view will raise an exception when the missing elements are accessed.
+
+<pre>
+  array<int> arr = {5,4,3,2,1,0};
+  arrayview<int> @odd = arr.view(1, uint(-1), 2); // 4,2,0
+  odd.sortAsc();                                  // arr is now 5,0,3,2,1,4
+</pre>
   
 Script example:
 
@@ -354,6 +389,14 @@ a default transformation of the primitive to a string.
  - int            findFirst(const string &in str, uint start = 0) const;
  - int            findLast(const string &in str, int start = -1) const;
  - array<string>@ split(const string &in delimiter) const;  
+ - array<string>@ tokenize(const string &in delimiters) const;
+ - string         replace(const string &in search, const string &in replacement) const;
+ - uint           count(const string &in str) const;
+
+The tokenize method splits the string at any of the characters in delimiters, and 
+unlike split it leaves out the empty parts. The replace method returns a copy where
+each non-overlapping occurrence of search has been replaced, and count returns the 
+number of non-overlapping occurrences.
 
 \subsection doc_datatypes_strings_addon_funcs Functions
 
@@ -388,6 +431,42 @@ Examples:
   string num = formatFloat(number, '0', 8, 2);
 </pre>
 
+\subsection doc_datatypes_strings_addon_builder String builder
+
+When the application has registered the string builder, the stringbuilder type can be used to build a long 
+text out of many small pieces. Each append adds the text to the end of a single buffer, instead of creating 
+a new string for each concatenation as <tt>s += a + b + c</tt> does.
+
+ - stringbuilder &opAddAssign(const string &in);
+ - stringbuilder &opAddAssign(int64);
+ - stringbuilder &opAddAssign(uint64);
+ - stringbuilder &opAddAssign(double);
+ - stringbuilder &opAddAssign(bool);
+ - stringbuilder &append(const string &in);
+ - stringbuilder &append(int64);
+ - stringbuilder &append(uint64);
+ - stringbuilder &append(double);
+ - stringbuilder &append(bool);
+ - stringbuilder &appendInt(int64 val, const string &in options, uint width = 0);
+ - stringbuilder &appendFloat(double val, const string &in options, uint width = 0, uint precision = 0);
+ - void           reserve(uint length);
+ - uint           length() const;
+ - uint           get_length() const;
+ - bool           isEmpty() const;
+ - void           clear();
+ - string         str();
+
+The appendInt() and appendFloat() methods take the same options as formatInt() and formatFloat(). The 
+get_length() method lets the length be read as the property <tt>sb.length</tt>. The str() method moves the 
+text out of the builder without copying it, so the builder is empty afterwards.
+
+<pre>
+  stringbuilder sb;
+  for( uint n = 0; n < items.length(); n++ )
+    sb.append(items[n].name).append(': ').appendFloat(items[n].price, '', 0, 2).append('\\n');
+  string report = sb.str();
+</pre>
+
 
 
 
@@ -99,6 +99,10 @@ SOURCE=..\..\source\test_2func.cpp
 # End Source File
 # Begin Source File
 
+SOURCE=..\..\source\test_addon_contextmgr.cpp
+# End Source File
+# Begin Source File
+
 SOURCE=..\..\source\test_addon_debugger.cpp
 # End Source File
 # Begin Source File
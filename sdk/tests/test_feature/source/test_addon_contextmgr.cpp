@@ -0,0 +1,284 @@
+#include "utils.h"
+#include "../../../add_on/contextmgr/contextmgr.h"
+#include "../../../add_on/scriptany/scriptany.h"
+
+namespace Test_Addon_ContextMgr
+{
+
+static const char *TESTNAME = "Test_Addon_ContextMgr";
+
+// The number of times each script has called record(). Each script
+// writes to its own slot so the worker threads don't need any locks
+static int records[32];
+
+static void Record_Generic(asIScriptGeneric *gen)
+{
+	records[gen->GetArgDWord(0)]++;
+}
+
+// The registered functions that use the context manager the way the earlier
+// versions did, i.e. with a context for each co-routine
+static CContextMgr *mgr = 0;
+
+static void Spawn_Generic(asIScriptGeneric *gen)
+{
+	asIScriptContext *ctx = asGetActiveContext();
+	asIScriptModule *mod = gen->GetEngine()->GetModule(ctx->GetFunction()->GetModuleName());
+	asIScriptContext *co = mgr->AddContextForCoRoutine(ctx, mod->GetFunctionByDecl("void run(int)"));
+	if( co )
+		co->SetArgDWord(0, gen->GetArgDWord(0));
+}
+
+static void OldYield_Generic(asIScriptGeneric *)
+{
+	mgr->NextCoRoutine();
+	asGetActiveContext()->Suspend();
+}
+
+// The time is controlled by the test so the scripts wake up when expected
+static asUINT currentTime = 0;
+
+static asUINT GetTime()
+{
+	return currentTime;
+}
+
+static const char *script =
+"void run(int id) \n"
+"{ \n"
+"  for( int n = 0; n < 10; n++ ) \n"
+"  { \n"
+"    record(id); \n"
+"    yield(); \n"
+"  } \n"
+"} \n"
+"void sleeper(int id) \n"
+"{ \n"
+"  record(id); \n"
+"  sleep(100 * (id + 1)); \n"
+"  record(id); \n"
+"} \n"
+"void main(int id) \n"
+"{ \n"
+"  createCoRoutine('co', any(int64(id + 8))); \n"
+"  for( int n = 0; n < 5; n++ ) \n"
+"  { \n"
+"    record(id); \n"
+"    yield(); \n"
+"  } \n"
+"} \n"
+"void co(any @arg) \n"
+"{ \n"
+"  int64 id; \n"
+"  arg.retrieve(id); \n"
+"  for( int n = 0; n < 5; n++ ) \n"
+"  { \n"
+"    record(int(id)); \n"
+"    yield(); \n"
+"  } \n"
+"} \n"
+"void shortMain(int id) \n"
+"{ \n"
+"  createCoRoutine('endlessCo', any(int64(id + 8))); \n"
+"  record(id); \n"
+"  oldYield(); \n"
+"} \n"
+"void endlessCo(any @arg) \n"
+"{ \n"
+"  int64 id; \n"
+"  arg.retrieve(id); \n"
+"  for(;;) \n"
+"  { \n"
+"    record(int(id)); \n"
+"    oldYield(); \n"
+"  } \n"
+"} \n"
+"void oldMain(int id) \n"
+"{ \n"
+"  spawn(id + 8); \n"
+"  record(id); \n"
+"} \n";
+
+static void AddScripts(CContextMgr &mgr, asIScriptModule *mod, const char *decl, asUINT count)
+{
+	asIScriptFunction *func = mod->GetFunctionByDecl(decl);
+	for( asUINT n = 0; n < count; n++ )
+	{
+		asIScriptContext *ctx = mgr.AddContext(mod->GetEngine(), func);
+		if( ctx )
+			ctx->SetArgDWord(0, n);
+	}
+}
+
+bool Test()
+{
+	bool fail = false;
+	int r;
+	COutStream out;
+
+	if( strstr(asGetLibraryOptions(), "AS_MAX_PORTABILITY") )
+	{
+		printf("Skipped due to max portability\n");
+		return fail;
+	}
+
+	asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+	RegisterStdString(engine);
+	RegisterScriptAny(engine);
+	engine->RegisterGlobalFunction("void record(int)", asFUNCTION(Record_Generic), asCALL_GENERIC);
+	engine->RegisterGlobalFunction("void spawn(int)", asFUNCTION(Spawn_Generic), asCALL_GENERIC);
+	engine->RegisterGlobalFunction("void oldYield()", asFUNCTION(OldYield_Generic), asCALL_GENERIC);
+
+	mgr = new CContextMgr();
+	mgr->SetGetTimeCallback(GetTime);
+	mgr->RegisterThreadSupport(engine);
+	mgr->RegisterCoRoutineSupport(engine);
+
+	asIScriptModule *mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+	mod->AddScriptSection(TESTNAME, script);
+	r = mod->Build();
+	if( r < 0 )
+		TEST_FAILED;
+
+	// By default the scripts are executed by the calling thread only
+	if( mgr->GetWorkerThreadCount() != 1 )
+		TEST_FAILED;
+	if( mgr->SetWorkerThreadCount(0) != asINVALID_ARG )
+		TEST_FAILED;
+#ifdef AS_CONTEXTMGR_THREADS
+	bool threads = true;
+	if( mgr->SetWorkerThreadCount(4) != 0 || mgr->GetWorkerThreadCount() != 4 )
+		TEST_FAILED;
+#else
+	// Without the thread support only the calling thread can be used
+	bool threads = false;
+	if( mgr->SetWorkerThreadCount(4) != asNOT_SUPPORTED || mgr->GetWorkerThreadCount() != 1 )
+		TEST_FAILED;
+	if( mgr->SetWorkerThreadCount(1) != 0 )
+		TEST_FAILED;
+#endif
+
+	// Each script is executed exactly once per call to ExecuteScripts, even
+	// though the scripts are distributed over multiple worker threads
+	memset(records, 0, sizeof(records));
+	AddScripts(*mgr, mod, "void run(int)", 20);
+	for( asUINT round = 1; round <= 11; round++ )
+	{
+		mgr->ExecuteScripts();
+		for( asUINT n = 0; n < 20; n++ )
+		{
+			if( records[n] != int(round < 10 ? round : 10) )
+			{
+				TEST_FAILED;
+				break;
+			}
+		}
+	}
+
+	// The sleeping scripts are only executed when the time has come to wake them up
+	memset(records, 0, sizeof(records));
+	if( threads )
+		mgr->SetWorkerThreadCount(2);
+	currentTime = 0;
+	AddScripts(*mgr, mod, "void sleeper(int)", 3);
+	mgr->ExecuteScripts();
+	if( records[0] != 1 || records[1] != 1 || records[2] != 1 )
+		TEST_FAILED;
+	currentTime = 50;
+	mgr->ExecuteScripts();
+	if( records[0] != 1 || records[1] != 1 || records[2] != 1 )
+		TEST_FAILED;
+	currentTime = 150;
+	mgr->ExecuteScripts();
+	if( records[0] != 2 || records[1] != 1 || records[2] != 1 )
+		TEST_FAILED;
+	currentTime = 1000;
+	mgr->ExecuteScripts();
+	if( records[0] != 2 || records[1] != 2 || records[2] != 2 )
+		TEST_FAILED;
+
+	// By default each co-routine is given a context of its own, so it is executed
+	// in each call too, and continues after the script that created it has ended
+	if( mgr->GetLightWeightCoRoutines() )
+		TEST_FAILED;
+	memset(records, 0, sizeof(records));
+	AddScripts(*mgr, mod, "void main(int)", 8);
+	for( asUINT round = 1; round <= 7; round++ )
+	{
+		mgr->ExecuteScripts();
+		for( asUINT n = 0; n < 8; n++ )
+		{
+			if( records[n] != int(round < 5 ? round : 5) ||
+				records[n+8] != int(round < 6 ? round-1 : 5) )
+			{
+				TEST_FAILED;
+				break;
+			}
+		}
+	}
+
+	// A script and its light weight co-routines take turns, and the group continues where it 
+	// left off when it is handed over to another worker because the number of threads change
+	mgr->SetLightWeightCoRoutines(true);
+	memset(records, 0, sizeof(records));
+	AddScripts(*mgr, mod, "void main(int)", 8);
+	for( asUINT round = 1; round <= 11; round++ )
+	{
+		if( threads )
+			mgr->SetWorkerThreadCount(1 + round % 4);
+
+		mgr->ExecuteScripts();
+		for( asUINT n = 0; n < 8; n++ )
+		{
+			if( records[n] != int(round < 10 ? (round+1)/2 : 5) ||
+				records[n+8] != int(round < 10 ? round/2 : 5) )
+			{
+				TEST_FAILED;
+				break;
+			}
+		}
+	}
+
+	// The light weight co-routines end with the script that created them
+	memset(records, 0, sizeof(records));
+	AddScripts(*mgr, mod, "void shortMain(int)", 8);
+	for( asUINT round = 1; round <= 5; round++ )
+		mgr->ExecuteScripts();
+	for( asUINT n = 0; n < 8; n++ )
+	{
+		if( records[n] != 1 || records[n+8] != 1 )
+		{
+			TEST_FAILED;
+			break;
+		}
+	}
+
+	// The functions added with AddContextForCoRoutine continue on their own
+	memset(records, 0, sizeof(records));
+	AddScripts(*mgr, mod, "void oldMain(int)", 8);
+	for( asUINT round = 1; round <= 12; round++ )
+		mgr->ExecuteScripts();
+	for( asUINT n = 0; n < 8; n++ )
+	{
+		if( records[n] != 1 || records[n+8] != 10 )
+		{
+			TEST_FAILED;
+			break;
+		}
+	}
+
+	// Scripts that are still running are aborted with the manager
+	AddScripts(*mgr, mod, "void main(int)", 8);
+	mgr->ExecuteScripts();
+	mgr->ExecuteScripts();
+	delete mgr;
+	mgr = 0;
+
+	engine->Release();
+
+	return fail;
+}
+
+} // namespace
+
@@ -59,6 +59,8 @@ const char *script =
 "  array<string> @keys = dict.getKeys(); \n"
 "  assert( keys.find('a') != -1 ); \n"
 "  assert( keys.length == 6 ); \n"
+"  for( uint n = 1; n < keys.length; n++ ) \n"
+"    assert( keys[n-1] < keys[n] ); \n"
 "}                                 \n";
 
 // Test circular reference including a script class and the dictionary
@@ -251,6 +253,74 @@ bool Test()
 		engine->Release();
 	}
 
+	{
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+
+		engine->SetMessageCallback(asMETHOD(COutStream, Callback), &out, asCALL_THISCALL);
+
+		RegisterStdString(engine);
+		RegisterScriptArray(engine, true);
+		RegisterScriptDictionary(engine);
+
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+		mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+	
+		const char *script =
+			"void main() \n"
+			"{ \n"
+			// Test many keys, where the deletes move the other entries
+			"  dictionary big; \n"
+			"  big.reserve(1000); \n"
+			"  for( int n = 0; n < 1000; n++ ) \n"
+			"    big.set('k' + n, n); \n"
+			"  for( int n = 0; n < 1000; n += 2 ) \n"
+			"    big.delete('k' + n); \n"
+			"  assert( big.getSize() == 500 ); \n"
+			"  for( int n = 0; n < 1000; n++ ) \n"
+			"  { \n"
+			"    int v = -1; \n"
+			"    bool found = big.get('k' + n, v); \n"
+			"    assert( found == (n % 2 == 1) ); \n"
+			"    assert( !found || v == n ); \n"
+			"  } \n"
+			// Test that the keys are found again after they were deleted or modified
+			"  for( int n = 0; n < 3; n++ ) \n"
+			"  { \n"
+			"    assert( !big.exists('lit') ); \n"
+			"    big.set('lit', n); \n"
+			"    int l = -1; \n"
+			"    big.get('lit', l); \n"
+			"    assert( l == n ); \n"
+			"    big.delete('lit'); \n"
+			"  } \n"
+			"  string key = 'k1'; \n"
+			"  assert( big.exists(key) ); \n"
+			"  key = 'k2'; \n"
+			"  assert( !big.exists(key) ); \n"
+			"  big.deleteAll(); \n"
+			"  assert( big.isEmpty() ); \n"
+			"  assert( !big.exists('k1') ); \n"
+			"} \n";
+
+		mod->AddScriptSection("script", script);
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+
+		ctx = engine->CreateContext();
+		r = ExecuteString(engine, "main()", mod, ctx);
+		if( r != asEXECUTION_FINISHED )
+		{
+			if( r == asEXECUTION_EXCEPTION )
+				PrintException(ctx);
+			TEST_FAILED;
+		}
+		ctx->Release();
+
+		engine->Release();
+	}
+
 	return fail;
 }
 
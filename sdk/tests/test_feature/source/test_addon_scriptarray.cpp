@@ -143,6 +143,16 @@ static const char *script7 =
 
 bool Test2();
 
+static asUINT parallelCalls = 0;
+static void ParallelFor(ARRAYTASKFUNC_t task, void *param, asUINT numTasks)
+{
+	parallelCalls++;
+
+	// Execute the tasks in reverse order to make sure they don't depend on the order
+	for( asUINT n = numTasks; n-- > 0; )
+		task(n, param);
+}
+
 CScriptArray *CreateArrayOfStrings()
 {
 	asIScriptContext *ctx = asGetActiveContext();
@@ -618,6 +628,380 @@ bool Test()
 		engine->Release();
 	}
 
+	// Test sorting large arrays, stable sorting and sorting with a comparison function
+	{
+		asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream, Callback), &out, asCALL_THISCALL);
+		RegisterScriptArray(engine, true);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+		const char *script = 
+			"class Item \n"
+			"{ \n"
+			"  int key; \n"
+			"  int id; \n"
+			"  Item() {} \n"
+			"  Item(int k, int i) { key = k; id = i; } \n"
+			"  int opCmp(const Item &in o) { return key - o.key; } \n"
+			"} \n"
+			"bool byKeyDesc(const Item @&in a, const Item @&in b) { return a.key > b.key; } \n"
+			"bool greater(int a, int b) { return a > b; } \n"
+			"bool wrongArgs(const float &in a, const float &in b) { return a < b; } \n"
+			"void main() \n"
+			"{ \n"
+			"  uint seed = 12345; \n"
+			"  array<int> a(10000); \n"
+			"  for( uint n = 0; n < a.length(); n++ ) \n"
+			"  { \n"
+			"    seed = seed * 1103515245 + 12345; \n"
+			"    a[n] = int(seed >> 16) % 1000 - 500; \n"
+			"  } \n"
+			"  array<int> b = a; \n"
+			"  a.sortAsc(); \n"
+			"  for( uint n = 1; n < a.length(); n++ ) \n"
+			"    assert( a[n-1] <= a[n] ); \n"
+			"  b.sort(@greater); \n"
+			"  for( uint n = 0; n < b.length(); n++ ) \n"
+			"    assert( b[n] == a[a.length() - n - 1] ); \n"
+			"  array<double> d = {3.5, -1, 2, 0.25, 2, -7}; \n"
+			"  d.sortDesc(1, 4); \n"
+			"  assert( d[0] == 3.5 && d[1] == 2 && d[2] == 2 && d[3] == 0.25 && d[4] == -1 && d[5] == -7 ); \n"
+			"  array<Item> items; \n"
+			"  for( int n = 0; n < 100; n++ ) \n"
+			"    items.insertLast(Item(n % 7, n)); \n"
+			"  items.stableSortAsc(); \n"
+			"  for( uint n = 1; n < items.length(); n++ ) \n"
+			"    assert( items[n-1].key < items[n].key || (items[n-1].key == items[n].key && items[n-1].id < items[n].id) ); \n"
+			"  array<Item@> handles; \n"
+			"  for( int n = 0; n < 100; n++ ) \n"
+			"    handles.insertLast(Item(n % 5, n)); \n"
+			"  handles.stableSort(@byKeyDesc); \n"
+			"  for( uint n = 1; n < handles.length(); n++ ) \n"
+			"    assert( handles[n-1].key > handles[n].key || (handles[n-1].key == handles[n].key && handles[n-1].id < handles[n].id) ); \n"
+			"} \n";
+
+		asIScriptModule *mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+		mod->AddScriptSection("script", script);
+		r = mod->Build();
+		if( r < 0 ) TEST_FAILED;
+		r = ExecuteString(engine, "main()", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		// The comparison function must take the element type
+		asIScriptContext *ctx = engine->CreateContext();
+		r = ExecuteString(engine, "array<int> a = {2, 1}; a.sort(@wrongArgs);", mod, ctx);
+		if( r != asEXECUTION_EXCEPTION || std::string(ctx->GetExceptionString()) != "Invalid comparison function" )
+			TEST_FAILED;
+		ctx->Release();
+
+		engine->Release();
+	}
+
+	// Test the vectorized operations on arrays of primitives, including the remaining elements at the end
+	{
+		asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream, Callback), &out, asCALL_THISCALL);
+		RegisterScriptArray(engine, true);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+		const char *script = 
+			"class Value \n"
+			"{ \n"
+			"  int v; \n"
+			"  Value() {} \n"
+			"  Value(int a) { v = a; } \n"
+			"  bool opEquals(const Value &in o) const { return v == o.v; } \n"
+			"} \n"
+			"void checkIndices(array<uint> @idx, int n) \n"
+			"{ \n"
+			"  assert( idx.length() == uint(n/5) ); \n"
+			"  for( uint i = 0; i < idx.length(); i++ ) \n"
+			"    assert( idx[i] == 5*i + 4 ); \n"
+			"} \n"
+			"void check(int n) \n"
+			"{ \n"
+			"  array<int8> a(n); array<int16> b(n); array<int> c(n); array<int64> d(n); array<float> e(n); array<double> f(n); \n"
+			"  for( int i = 0; i < n; i++ ) \n"
+			"  { \n"
+			"    a[i] = int8(i % 5); b[i] = int16(i % 5); c[i] = i % 5; d[i] = int64(i % 5) << 40; e[i] = float(i % 5); f[i] = i % 5; \n"
+			"  } \n"
+			"  checkIndices(a.findAll(4), n); checkIndices(b.findAll(4), n); checkIndices(c.findAll(4), n); \n"
+			"  checkIndices(d.findAll(int64(4) << 40), n); checkIndices(e.findAll(4), n); checkIndices(f.findAll(4), n); \n"
+			"  int first = n > 4 ? 4 : -1; \n"
+			"  assert( a.find(4) == first && b.find(4) == first && c.find(4) == first && d.find(int64(4) << 40) == first && e.find(4) == first && f.find(4) == first ); \n"
+			"  assert( d.find(4) == -1 && c.find(5) == -1 && c.find(n > 9 ? 5 : 0, 4) == (n > 9 ? 9 : first) ); \n"
+			"  array<int8> ra = a; array<int16> rb = b; array<int> rc = c; array<int64> rd = d; \n"
+			"  ra.reverse(); rb.reverse(); rc.reverse(); rd.reverse(); \n"
+			"  for( int i = 0; i < n; i++ ) \n"
+			"    assert( ra[i] == a[n-1-i] && rb[i] == b[n-1-i] && rc[i] == c[n-1-i] && rd[i] == d[n-1-i] ); \n"
+			"  ra.reverse(); rd.reverse(); \n"
+			"  assert( ra == a && rd == d ); \n"
+			"  if( n > 0 ) \n"
+			"  { \n"
+			"    ra[n-1] = 9; rd[n-1] = 1; \n"
+			"    assert( !(ra == a) && !(rd == d) ); \n"
+			"    array<float> e2 = e; e2[0] = -0.0f; \n"
+			"    assert( e2 == e ); \n"
+			"  } \n"
+			"  c.fill(3); d.fill(-1); \n"
+			"  for( int i = 0; i < n; i++ ) \n"
+			"    assert( c[i] == 3 && d[i] == -1 ); \n"
+			"} \n"
+			"void main() \n"
+			"{ \n"
+			"  for( int n = 0; n < 40; n++ ) \n"
+			"    check(n); \n"
+			"  check(1003); \n"
+			"  array<Value> v = {Value(1), Value(4), Value(1)}; \n"
+			"  array<uint> @idx = v.findAll(Value(1)); \n"
+			"  assert( idx.length() == 2 && idx[0] == 0 && idx[1] == 2 ); \n"
+			"  assert( idx.findAll(2).length() == 1 ); \n"
+			"  array<Value@> h = {v[0], null, v[1], null}; \n"
+			"  idx = h.findAll(null); \n"
+			"  assert( idx.length() == 2 && idx[0] == 1 && idx[1] == 3 ); \n"
+			"  h.reverse(); \n"
+			"  assert( h[0] is null && h[1] is v[1] && h[3] is v[0] ); \n"
+			"} \n";
+
+		asIScriptModule *mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+		mod->AddScriptSection("script", script);
+		r = mod->Build();
+		if( r < 0 ) TEST_FAILED;
+		r = ExecuteString(engine, "main()", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		engine->Release();
+	}
+
+	// Test the array views, which share the elements with the array
+	{
+		asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream, Callback), &out, asCALL_THISCALL);
+		RegisterScriptArray(engine, true);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+		const char *script = 
+			"class Value \n"
+			"{ \n"
+			"  int v; \n"
+			"  Value() {} \n"
+			"  Value(int a) { v = a; } \n"
+			"  int opCmp(const Value &in o) const { return v - o.v; } \n"
+			"} \n"
+			"class Node \n"
+			"{ \n"
+			"  arrayview<Node@> @siblings; \n"
+			"} \n"
+			"bool greater(const int &in a, const int &in b) { return a > b; } \n"
+			"arrayview<int> @makeView() \n"
+			"{ \n"
+			"  array<int> a = {0,1,2,3,4,5,6,7,8,9}; \n"
+			"  return a.view(5); \n"
+			"} \n"
+			"void main() \n"
+			"{ \n"
+			"  array<int> a = {0,1,2,3,4,5,6,7,8,9}; \n"
+			"  arrayview<int> @v = a.view(2, 5); \n"
+			"  assert( v.length == 5 && v.offset == 2 && v.stride == 1 && v[0] == 2 && v[4] == 6 ); \n"
+			"  v[1] = 30; \n"
+			"  assert( a[3] == 30 ); \n"
+			"  a[4] = 40; \n"
+			"  assert( v[2] == 40 ); \n"
+			"  assert( v.find(40) == 2 && v.find(0) == -1 && v.sum() == 2+30+40+5+6 && v.min() == 2 && v.max() == 40 ); \n"
+			"  v.sortDesc(); \n"
+			"  assert( a[1] == 1 && a[2] == 40 && a[3] == 30 && a[6] == 2 && a[7] == 7 ); \n"
+			"  v.fill(-1); \n"
+			"  assert( a[1] == 1 && a[2] == -1 && a[6] == -1 && a[7] == 7 ); \n"
+			"  for( uint n = 0; n < a.length; n++ ) \n"
+			"    a[n] = n; \n"
+			"  arrayview<int> @odd = a.view(1, uint(-1), 2); \n"
+			"  assert( odd.length == 5 && odd.stride == 2 && odd[0] == 1 && odd[4] == 9 ); \n"
+			"  odd.reverse(); \n"
+			"  assert( a[0] == 0 && a[1] == 9 && a[2] == 2 && a[3] == 7 && a[9] == 1 ); \n"
+			"  odd.sortAsc(); \n"
+			"  assert( a[1] == 1 && a[3] == 3 && a[9] == 9 && a[8] == 8 ); \n"
+			"  odd.sort(greater); \n"
+			"  assert( a[1] == 9 && a[9] == 1 ); \n"
+			"  assert( odd.find(5) == 2 && odd.find(3, 5) == -1 && odd.findAll(1)[0] == 4 ); \n"
+			"  assert( odd.sum() == 25 && odd.min() == 1 && odd.max() == 9 ); \n"
+			"  odd.fill(0); \n"
+			"  assert( a.sum() == 0+2+4+6+8 ); \n"
+			"  arrayview<int> @sub = odd.view(1, 2, 2); \n"
+			"  assert( sub.length == 2 && sub.offset == 3 && sub.stride == 4 ); \n"
+			"  sub[1] = 11; \n"
+			"  assert( a[7] == 11 ); \n"
+			"  assert( a.view(0, 3) == a.view(0, 3) && !(a.view(0, 3) == a.view(1, 3)) ); \n"
+			"  assert( a.view(0, 5, 2).view(0, 3) == a.view(0, 5).view(0, 3, 2) ); \n"
+			"  assert( a.view(10).isEmpty() && a.view(4, 0).length == 0 && a.view(8, 100).length == 2 ); \n"
+			"  assert( makeView()[4] == 9 ); \n"
+			"  array<Value> vals = {Value(3), Value(2), Value(1), Value(0)}; \n"
+			"  vals.view(0, 2, 2).sortAsc(); \n"
+			"  assert( vals[0].v == 1 && vals[1].v == 2 && vals[2].v == 3 ); \n"
+			"  array<Node@> nodes = {Node(), Node(), null}; \n"
+			"  nodes.view(0, 2).reverse(); \n"
+			"  assert( nodes[2] is null && nodes.view().findAll(null).length == 1 ); \n"
+			"  @nodes[0].siblings = nodes.view(); \n"
+			"} \n"
+			"void outOfBounds() \n"
+			"{ \n"
+			"  array<int> a(10); \n"
+			"  arrayview<int> @v = a.view(5); \n"
+			"  a.resize(8); \n"
+			"  v[1] = 1; \n"
+			"  v[3] = 1; \n"
+			"  v.sortAsc(); \n"
+			"} \n";
+
+		asIScriptModule *mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+		mod->AddScriptSection("script", script);
+		r = mod->Build();
+		if( r < 0 ) TEST_FAILED;
+		r = ExecuteString(engine, "main()", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		// The view still refers to the array after it was resized, but not to the removed elements
+		asIScriptContext *ctx = engine->CreateContext();
+		r = ExecuteString(engine, "outOfBounds()", mod, ctx);
+		if( r != asEXECUTION_EXCEPTION || std::string(ctx->GetExceptionString()) != "Index out of bounds" )
+			TEST_FAILED;
+		ctx->Release();
+
+		r = ExecuteString(engine, "array<int> a(10); a.view(0, 2, 0);", mod);
+		if( r != asEXECUTION_EXCEPTION )
+			TEST_FAILED;
+
+		// The node refers to a view that refers to the array holding the node
+		engine->GarbageCollect();
+		asUINT currentSize;
+		engine->GetGCStatistics(&currentSize);
+		if( currentSize != 0 )
+			TEST_FAILED;
+
+		engine->Release();
+	}
+
+	// Test the parallel algorithms for large arrays
+	{
+		asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream, Callback), &out, asCALL_THISCALL);
+		RegisterScriptArray(engine, true);
+		RegisterStdString(engine);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+		const char *script = 
+			"void main() \n"
+			"{ \n"
+			"  uint seed = 4321; \n"
+			"  array<int> a(100000); \n"
+			"  array<double> d(a.length()); \n"
+			"  int sum = 0, lo = 1000000, hi = -1000000; \n"
+			"  for( uint n = 0; n < a.length(); n++ ) \n"
+			"  { \n"
+			"    seed = seed * 1103515245 + 12345; \n"
+			"    a[n] = int(seed >> 8) % 200000 - 100000; \n"
+			"    d[n] = a[n] / 4.0; \n"
+			"    sum += a[n]; \n"
+			"    if( a[n] < lo ) lo = a[n]; \n"
+			"    if( a[n] > hi ) hi = a[n]; \n"
+			"  } \n"
+			"  assert( a.sum() == sum && a.min() == lo && a.max() == hi ); \n"
+			"  assert( d.sum() == sum / 4.0 && d.min() == lo / 4.0 && d.max() == hi / 4.0 ); \n"
+			"  assert( a.find(hi) >= 0 && a[a.find(hi)] == hi ); \n"
+			"  a[99999] = 1000000; \n"
+			"  assert( a.find(1000000) == 99999 && a.find(10, 1000000) == 99999 && a.find(1000001) == -1 ); \n"
+			"  a.sortAsc(); \n"
+			"  for( uint n = 1; n < a.length(); n++ ) \n"
+			"    assert( a[n-1] <= a[n] ); \n"
+			"  d.stableSortDesc(); \n"
+			"  for( uint n = 1; n < d.length(); n++ ) \n"
+			"    assert( d[n-1] >= d[n] ); \n"
+			"  a.fill(7); \n"
+			"  assert( a.sum() == 700000 && a.min() == 7 && a.max() == 7 && a.find(0) == -1 ); \n"
+			"  array<int8> b(1000, 100); \n"
+			"  assert( b.sum() == int8(100000) ); \n"
+			"} \n";
+
+		asIScriptModule *mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+		mod->AddScriptSection("script", script);
+		r = mod->Build();
+		if( r < 0 ) TEST_FAILED;
+
+		// Serially, with the application's thread pool, and with the threads started by the add-on
+		for( int n = 0; n < 3; n++ )
+		{
+			parallelCalls = 0;
+			if( n == 1 )
+				SetScriptArrayParallelism(engine, 4, 1000, ParallelFor);
+			else if( n == 2 )
+				SetScriptArrayParallelism(engine, 4, 1000);
+
+			// The worker threads are reused by the following calls
+			for( int i = 0; i < 2; i++ )
+			{
+				r = ExecuteString(engine, "main()", mod);
+				if( r != asEXECUTION_FINISHED )
+					TEST_FAILED;
+			}
+			if( (n == 1) != (parallelCalls > 0) )
+				TEST_FAILED;
+		}
+
+		// The setting is stored per engine, so other engines still do the work serially
+		{
+			SetScriptArrayParallelism(engine, 4, 1000, ParallelFor);
+
+			asIScriptEngine *engine2 = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+			engine2->SetMessageCallback(asMETHOD(COutStream, Callback), &out, asCALL_THISCALL);
+			RegisterScriptArray(engine2, true);
+			engine2->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+			asIScriptModule *mod2 = engine2->GetModule(0, asGM_ALWAYS_CREATE);
+			mod2->AddScriptSection("script", script);
+			r = mod2->Build();
+			if( r < 0 ) TEST_FAILED;
+
+			parallelCalls = 0;
+			r = ExecuteString(engine2, "main()", mod2);
+			if( r != asEXECUTION_FINISHED )
+				TEST_FAILED;
+			if( parallelCalls != 0 )
+				TEST_FAILED;
+
+			engine2->Release();
+		}
+		SetScriptArrayParallelism(engine, 1);
+
+		// The sums of different arrays are kept apart
+		r = ExecuteString(engine, "array<int> a = {1, 2}, b = {3, 4}; \n"
+		                          "assert( a.sum() + b.sum() == 10 ); \n"
+		                          "assert( a.view().sum() - b.view().sum() == -4 ); \n"
+		                          "array<float> f = {1.5f, 2.25f}; \n"
+		                          "assert( f.sum() == 3.75f && f.view(1).sum() == 2.25f );", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		// Only arrays of primitives can be reduced
+		asIScriptContext *ctx = engine->CreateContext();
+		r = ExecuteString(engine, "array<int> a; a.min();", mod, ctx);
+		if( r != asEXECUTION_EXCEPTION || std::string(ctx->GetExceptionString()) != "The array is empty" )
+			TEST_FAILED;
+		r = ExecuteString(engine, "array<array<int>@> a(1); array<int>@ s = a.sum();", mod, ctx);
+		if( r != asEXECUTION_EXCEPTION || std::string(ctx->GetExceptionString()) != "The element type is not a primitive" )
+			TEST_FAILED;
+		r = ExecuteString(engine, "array<string> a(1); string s = a.sum();", mod, ctx);
+		if( r != asEXECUTION_EXCEPTION || std::string(ctx->GetExceptionString()) != "The element type is not a primitive" )
+			TEST_FAILED;
+		r = ExecuteString(engine, "array<bool> a = {true, true}; a.sum();", mod, ctx);
+		if( r != asEXECUTION_EXCEPTION || std::string(ctx->GetExceptionString()) != "The sum of bool elements is not defined" )
+			TEST_FAILED;
+		ctx->Release();
+
+		engine->Release();
+	}
+
 	// Test 
 	{
 		asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
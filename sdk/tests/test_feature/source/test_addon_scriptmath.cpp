@@ -25,6 +25,28 @@ static const char *script =
 "  v.i=2;                           \n"
 "}                                  \n";
 
+static int divCalls = 0;
+int CheckedDiv(int a, int b)
+{
+	divCalls++;
+	if( b == 0 )
+	{
+		asGetActiveContext()->SetException("Division by zero");
+		return 0;
+	}
+	return a / b;
+}
+
+bool HasCallSys(asIScriptFunction *func)
+{
+	asUINT len;
+	asDWORD *bc = func->GetByteCode(&len);
+	for( asUINT n = 0; n < len; n += asBCTypeSize[asBCInfo[asBYTE(bc[n])].type] )
+		if( asBYTE(bc[n]) == asBC_CALLSYS )
+			return true;
+	return false;
+}
+
 bool Test()
 {
 	bool fail = false;
@@ -179,6 +201,71 @@ bool Test()
 
 	engine->Release();
 
+	// Test compile time evaluation of pure functions
+	{
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+		RegisterScriptMath(engine);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+		r = engine->RegisterGlobalFunction("int checkedDiv(int, int)", asFUNCTION(CheckedDiv), asCALL_CDECL); assert( r >= 0 );
+		r = engine->SetGlobalFunctionPure(engine->GetFunctionById(r), true);
+		if( r < 0 )
+			TEST_FAILED;
+
+		// Functions are not pure unless the application says so
+		r = engine->RegisterGlobalFunction("int impureDiv(int, int)", asFUNCTION(CheckedDiv), asCALL_CDECL); assert( r >= 0 );
+		if( engine->GetFunctionById(r)->IsPure() )
+			TEST_FAILED;
+
+		// Only functions that take and return primitives by value can be pure
+		r = engine->SetGlobalFunctionPure(engine->GetGlobalFunctionByDecl("void assert(bool)"), true);
+		if( r != asNOT_SUPPORTED )
+			TEST_FAILED;
+		if( !engine->GetGlobalFunctionByDecl("float sqrt(float)")->IsPure() )
+			TEST_FAILED;
+
+		divCalls = 0;
+		asIScriptModule *mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+		mod->AddScriptSection(TESTNAME,
+			"const float a = sqrt(16.0f) + pow(2, 3); \n"
+			"const int b = checkedDiv(10, 2); \n"
+			"float f() { return cos(0.0f) * a + b; } \n"
+			"int g() { return checkedDiv(10, 0); } \n"
+			"float h(float x) { return sqrt(x); } \n"
+			"int k() { return impureDiv(10, 2); } \n");
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+
+		// The constant global is initialized without any calls, and the function that
+		// raised an exception during the build is called at runtime instead
+		if( divCalls != 2 )
+			TEST_FAILED;
+		if( *(float*)mod->GetAddressOfGlobalVar(mod->GetGlobalVarIndexByName("a")) != 12 )
+			TEST_FAILED;
+		if( HasCallSys(mod->GetFunctionByName("f")) ||
+			!HasCallSys(mod->GetFunctionByName("g")) ||
+			!HasCallSys(mod->GetFunctionByName("h")) ||
+			!HasCallSys(mod->GetFunctionByName("k")) )
+			TEST_FAILED;
+
+		r = ExecuteString(engine, "assert( f() == 17 ); assert( h(4) == 2 );", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+		r = ExecuteString(engine, "g();", mod);
+		if( r != asEXECUTION_EXCEPTION )
+			TEST_FAILED;
+
+		// The function that isn't pure is called at runtime even though the args are constant
+		r = ExecuteString(engine, "assert( k() == 5 );", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+		if( divCalls != 4 )
+			TEST_FAILED;
+
+		engine->Release();
+	}
+
 	return fail;
 }
 
@@ -355,13 +355,57 @@ void DumpModule(asIScriptModule *mod)
 		" void sortAsc(uint, uint)\n"
 		" void sortDesc()\n"
 		" void sortDesc(uint, uint)\n"
+		" void stableSortAsc()\n"
+		" void stableSortAsc(uint, uint)\n"
+		" void stableSortDesc()\n"
+		" void stableSortDesc(uint, uint)\n"
+		" void sort(?&in, uint arg1 = 0, uint arg2 = uint ( - 1 ))\n"
+		" void stableSort(?&in, uint arg1 = 0, uint arg2 = uint ( - 1 ))\n"
 		" void reverse()\n"
 		" int find(const T&in) const\n"
 		" int find(uint, const T&in) const\n"
+		" uint[]@ findAll(const T&in) const\n"
+		" void fill(const T&in)\n"
+		" T sum() const\n"
+		" const T& min() const\n"
+		" const T& max() const\n"
 		" bool opEquals(const T[]&in) const\n"
 		" bool isEmpty() const\n"
 		" uint get_length() const\n"
 		" void set_length(uint)\n"
+		" arrayview<T>@ view(uint arg0 = 0, uint arg1 = uint ( - 1 ), uint arg2 = 1)\n"
+		"reg type: ref arrayview group: <null>\n"
+		" beh(4) void _beh_4_()\n"
+		" beh(5) void _beh_5_()\n"
+		" beh(11) int _beh_11_()\n"
+		" beh(12) void _beh_12_()\n"
+		" beh(13) bool _beh_13_()\n"
+		" beh(14) void _beh_14_(int&in)\n"
+		" beh(15) void _beh_15_(int&in)\n"
+		" beh(10) bool _beh_10_(int&in, bool&out)\n"
+		" T& opIndex(uint)\n"
+		" const T& opIndex(uint) const\n"
+		" arrayview<T>@ view(uint arg0 = 0, uint arg1 = uint ( - 1 ), uint arg2 = 1)\n"
+		" uint length() const\n"
+		" bool isEmpty() const\n"
+		" void sortAsc()\n"
+		" void sortDesc()\n"
+		" void stableSortAsc()\n"
+		" void stableSortDesc()\n"
+		" void sort(?&in)\n"
+		" void stableSort(?&in)\n"
+		" void reverse()\n"
+		" int find(const T&in) const\n"
+		" int find(uint, const T&in) const\n"
+		" uint[]@ findAll(const T&in) const\n"
+		" void fill(const T&in)\n"
+		" T sum() const\n"
+		" const T& min() const\n"
+		" const T& max() const\n"
+		" bool opEquals(const arrayview<T>&in) const\n"
+		" uint get_length() const\n"
+		" uint get_offset() const\n"
+		" uint get_stride() const\n"
 		"reg type: val string group: <null>\n"
 		" beh(1) void _beh_1_()\n"
 		" beh(0) void _beh_0_()\n"
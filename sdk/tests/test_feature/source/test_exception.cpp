@@ -1,4 +1,5 @@
 #include "utils.h"
+#include <algorithm>
 using namespace std;
 
 static const char * const TESTNAME = "TestException";
@@ -20,6 +21,30 @@ static void print(asIScriptGeneric *gen)
 	UNUSED_VAR(s);
 }
 
+// Records the destruction of the objects so the test can verify that 
+// exactly the objects that were alive when the exception occurred are destroyed
+static std::string destroyed;
+
+static void Tracked_DefConstruct(asIScriptGeneric *gen)
+{
+	*(int*)gen->GetObject() = 0;
+}
+
+static void Tracked_Construct(asIScriptGeneric *gen)
+{
+	*(int*)gen->GetObject() = (int)gen->GetArgDWord(0);
+}
+
+static void Tracked_Destruct(asIScriptGeneric *gen)
+{
+	destroyed += char('0' + *(int*)gen->GetObject());
+}
+
+static void Record(asIScriptGeneric *gen)
+{
+	destroyed += *(std::string*)gen->GetArgAddress(0);
+}
+
 bool TestException()
 {
 	bool fail = false;
@@ -262,6 +287,83 @@ bool TestException()
 		engine->Release();
 	}
 
+	// Test exception in the middle of nested blocks with object variables
+	// Only the variables that are in scope and already initialized must be destroyed
+	{
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream, Callback), &out, asCALL_THISCALL);
+		RegisterStdString(engine);
+		engine->RegisterGlobalFunction("void record(const string &in)", asFUNCTION(Record), asCALL_GENERIC);
+
+		r = engine->RegisterObjectType("tracked", sizeof(int), asOBJ_VALUE | asOBJ_APP_CLASS_CD); assert( r >= 0 );
+		r = engine->RegisterObjectBehaviour("tracked", asBEHAVE_CONSTRUCT, "void f()", asFUNCTION(Tracked_DefConstruct), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectBehaviour("tracked", asBEHAVE_CONSTRUCT, "void f(int)", asFUNCTION(Tracked_Construct), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectBehaviour("tracked", asBEHAVE_DESTRUCT, "void f()", asFUNCTION(Tracked_Destruct), asCALL_GENERIC); assert( r >= 0 );
+
+		mod = engine->GetModule("test", asGM_ALWAYS_CREATE);
+		mod->AddScriptSection("test",
+			"class obj \n"
+			"{ \n"
+			"  obj(const string &in n) { name = n; } \n"
+			"  ~obj() { record(name); } \n"
+			"  string name; \n"
+			"} \n"
+			"void main() \n"
+			"{ \n"
+			"  tracked a(1); \n"
+			"  { \n"
+			"    tracked b(2); \n"
+			"    obj o('b'); \n"
+			"  } \n"
+			"  obj c('c'); \n"
+			"  for( int n = 0; n < 2; n++ ) \n"
+			"  { \n"
+			"    tracked d(3); \n"
+			"    if( n == 1 ) \n"
+			"    { \n"
+			"      obj e('e'); \n"
+			"      tracked g(4); \n"
+			"      int z = 0; \n"
+			"      z = 10/z; \n"
+			"      tracked h(5); \n"
+			"      obj f('f'); \n"
+			"    } \n"
+			"  } \n"
+			"  tracked i(6); \n"
+			"} \n");
+
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+
+		destroyed = "";
+		asIScriptContext *ctx = engine->CreateContext();
+		r = ExecuteString(engine, "main();", mod, ctx);
+		if( r != asEXECUTION_EXCEPTION )
+			TEST_FAILED;
+		if( ctx->GetExceptionLineNumber() != 23 )
+			TEST_FAILED;
+		ctx->Release();
+		engine->GarbageCollect();
+
+		// The objects of the first block and of the first iteration of the loop are destroyed
+		// when they go out of scope, and the ones that were alive when the exception occurred
+		// are destroyed with the context. The objects declared after the statement that threw
+		// the exception must not be destroyed as they were never constructed
+		if( destroyed.length() < 8 )
+			destroyed.resize(8, ' ');
+		string inBlock = destroyed.substr(0, 2), inLoop = destroyed.substr(2, 1), alive = destroyed.substr(3);
+		std::sort(inBlock.begin(), inBlock.end());
+		std::sort(alive.begin(), alive.end());
+		if( inBlock != "2b" || inLoop != "3" || alive != "134ce" )
+		{
+			printf("destroyed: %s\n", destroyed.c_str());
+			TEST_FAILED;
+		}
+
+		engine->Release();
+	}
+
 	// Success
 	return fail;
 }
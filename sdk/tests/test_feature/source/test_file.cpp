@@ -43,6 +43,95 @@ bool Test()
 
 	engine->Release();
 
+	// Test the buffered and memory mapped read modes, and the bulk readers
+	{
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+		RegisterStdString(engine);
+		RegisterScriptArray(engine, true);
+		RegisterScriptFile(engine);
+		RegisterScriptFileUtils(engine);
+
+		const char *script =
+			"void main() \n"
+			"{ \n"
+			"  file f; \n"
+			"  assert( f.open('test_file.tmp', 'w') >= 0 ); \n"
+			"  f.writeString('line1\\nline2\\r\\n\\nlast\\n'); \n"
+			"  f.writeInt(-2, 2); f.writeInt(3, 2); \n"
+			"  f.writeUInt(1000, 4); f.writeUInt(70000, 4); \n"
+			"  f.writeFloat(1.5f); f.writeFloat(-2); \n"
+			"  f.writeDouble(3.25); \n"
+			"  f.close(); \n"
+			// More lines than fit in the buffer of the 'rl' mode
+			"  assert( f.open('test_file2.tmp', 'w') >= 0 ); \n"
+			"  for( int n = 0; n < 100000; n++ ) \n"
+			"    f.writeString('line' + n + '\\n'); \n"
+			"  f.close(); \n"
+			"  array<string> modes = {'r', 'rl', 'rm'}; \n"
+			"  for( uint m = 0; m < modes.length(); m++ ) \n"
+			"  { \n"
+			"    assert( f.open('test_file.tmp', modes[m]) >= 0 ); \n"
+			"    int64 size = f.getSize(); \n"
+			"    string all; \n"
+			"    assert( f.readToEnd(all) == size ); \n"
+			"    assert( f.isEndOfFile() ); \n"
+			"    assert( f.setPos(0) >= 0 && !f.isEndOfFile() ); \n"
+			"    array<string> lines; \n"
+			"    for( int n = 0; n < 4 && f.readNextLine(); n++ ) \n"
+			"      lines.insertLast(f.line); \n"
+			"    assert( lines.length() == 4 && lines[0] == 'line1' && lines[1] == 'line2' && lines[2] == '' && lines[3] == 'last' ); \n"
+			"    assert( f.getPos() == 19 ); \n"
+			"    array<int64> @i = f.readInts(2, 2); \n"
+			"    assert( i.length() == 2 && i[0] == -2 && i[1] == 3 ); \n"
+			"    array<uint64> @u = f.readUInts(2, 4); \n"
+			"    assert( u.length() == 2 && u[0] == 1000 && u[1] == 70000 ); \n"
+			"    array<float> @fl = f.readFloats(2); \n"
+			"    assert( fl.length() == 2 && fl[0] == 1.5f && fl[1] == -2 ); \n"
+			"    array<double> @d = f.readDoubles(5); \n"
+			"    assert( d.length() == 1 && d[0] == 3.25 ); \n"
+			"    assert( f.isEndOfFile() ); \n"
+			"    assert( f.setPos(19) >= 0 && f.movePos(2) >= 0 && f.readInt(2) == 3 ); \n"
+			// The count is limited to the values left in the file
+			"    assert( f.setPos(0) >= 0 && f.readInts(0xFFFFFFFF, 8).length() == uint(size / 8) && f.isEndOfFile() ); \n"
+			"    f.setPos(0); \n"
+			"    string s; \n"
+			"    while( !f.isEndOfFile() ) \n"
+			"    { \n"
+			"      string line; f.readLine(line); \n"
+			"      s += line; \n"
+			"    } \n"
+			"    assert( s == all ); \n"
+			"    f.close(); \n"
+			"    assert( f.open('test_file2.tmp', modes[m]) >= 0 ); \n"
+			"    int count = 0; \n"
+			"    while( f.readNextLine() ) \n"
+			"    { \n"
+			"      if( f.line != 'line' + count ) break; \n"
+			"      count++; \n"
+			"    } \n"
+			"    assert( count == 100000 ); \n"
+			"    f.close(); \n"
+			"  } \n"
+			"} \n";
+
+		asIScriptModule *mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+		mod->AddScriptSection("script", script);
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+
+		r = ExecuteString(engine, "main()", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		remove("test_file.tmp");
+		remove("test_file2.tmp");
+
+		engine->Release();
+	}
+
 	// Success
 	return fail;
 }
@@ -216,6 +216,24 @@ void TestOverload(int) {}
 
 void TestOverload(float) {}
 
+#ifdef AS_VARIADIC_WRAPPERS
+// The variadic wrappers have no limit on the number of arguments and
+// must compute the correct offsets for arguments of different sizes
+double TestMixedArgs(char a, double b, const std::string &c, asINT64 d, std::string e, float f, bool g) {
+	assert(a == 1 && b == 2.5 && c == "c" && d == asINT64(1) << 40 && e == "e" && f == 3.5f && g);
+	return b + f;
+}
+
+void TestObjFirstArgs(std::string *obj, int a, double b) {
+	assert(*obj == "obj" && a == 1 && b == 2.5);
+}
+
+int TestObjLastArgs(double a, const std::string &b, std::string &obj) {
+	assert(a == 2.5 && b == "b");
+	return int(obj.length());
+}
+#endif
+
 class A
 {
 public:
@@ -373,6 +391,19 @@ bool Test2()
 		TEST_FAILED;
 	}
 
+#ifdef AS_VARIADIC_WRAPPERS
+	r = engine->RegisterGlobalFunction("double TestMixedArgs(int8, double, const string &in, int64, string, float, bool)", WRAP_FN(TestMixedArgs), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("string", "void TestObjFirstArgs(int, double)", WRAP_OBJ_FIRST(TestObjFirstArgs), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("string", "int TestObjLastArgs(double, const string &in)", WRAP_OBJ_LAST(TestObjLastArgs), asCALL_GENERIC); assert( r >= 0 );
+	r = ExecuteString(engine, "assert( TestMixedArgs(1, 2.5, 'c', int64(1) << 40, 'e', 3.5f, true) == 6 ); \n"
+	                          "string s = 'obj'; s.TestObjFirstArgs(1, 2.5); \n"
+	                          "assert( s.TestObjLastArgs(2.5, 'b') == 3 ); \n");
+	if( r != asEXECUTION_FINISHED )
+	{
+		TEST_FAILED;
+	}
+#endif
+
 	engine->Release();
 
 	// http://www.gamedev.net/topic/639902-premature-destruction-of-object-in-android/
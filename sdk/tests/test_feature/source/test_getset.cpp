@@ -77,6 +77,27 @@ void formattedPrintAS( std::string& format, void* a, int typeId_a )
 	}
 }
 
+struct CEntity
+{
+	int    health;
+	float  speed;
+	bool   alive;
+	double mass;
+};
+
+// Normal accessors that compute the property rather than alias a field
+static void Entity_GetLevel_Generic(asIScriptGeneric *gen)
+{
+	CEntity *e = (CEntity*)gen->GetObject();
+	gen->SetReturnDWord(e->health / 10);
+}
+
+static void Entity_SetLevel_Generic(asIScriptGeneric *gen)
+{
+	CEntity *e = (CEntity*)gen->GetObject();
+	e->health = int(gen->GetArgDWord(0)) * 10;
+}
+
 bool Test()
 {
 	if( strstr(asGetLibraryOptions(), "AS_MAX_PORTABILITY") )
@@ -1705,6 +1726,204 @@ bool Test()
 		engine->Release();
 	}
 
+	// Test accessors registered as aliases for fields
+	{
+		bout.buffer = "";
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(CBufferedOutStream,Callback), &bout, asCALL_THISCALL);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+		CEntity entity = {100, 1.5f, true, 80.0};
+		engine->RegisterObjectType("Entity", 0, asOBJ_REF | asOBJ_NOCOUNT);
+		r = engine->RegisterObjectFieldAccessor("Entity", "int get_health() const", asOFFSET(CEntity, health)); assert( r >= 0 );
+		r = engine->RegisterObjectFieldAccessor("Entity", "void set_health(int)", asOFFSET(CEntity, health)); assert( r >= 0 );
+		r = engine->RegisterObjectFieldAccessor("Entity", "void set_speed(float)", asOFFSET(CEntity, speed)); assert( r >= 0 );
+		r = engine->RegisterObjectFieldAccessor("Entity", "float get_speed() const", asOFFSET(CEntity, speed)); assert( r >= 0 );
+		r = engine->RegisterObjectFieldAccessor("Entity", "bool get_alive() const", asOFFSET(CEntity, alive)); assert( r >= 0 );
+		r = engine->RegisterObjectFieldAccessor("Entity", "void set_alive(bool)", asOFFSET(CEntity, alive)); assert( r >= 0 );
+		r = engine->RegisterObjectFieldAccessor("Entity", "double get_mass() const", asOFFSET(CEntity, mass)); assert( r >= 0 );
+		r = engine->RegisterGlobalProperty("Entity e", &entity); assert( r >= 0 );
+
+		mod = engine->GetModule("test", asGM_ALWAYS_CREATE);
+		mod->AddScriptSection("test",
+			"void func() \n"
+			"{ \n"
+			"  e.health -= 10; \n"
+			"  e.speed = e.speed * float(e.mass) / 40; \n"
+			"  if( e.health < 100 ) e.alive = !e.alive; \n"
+			"} \n");
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+		if( bout.buffer != "" )
+		{
+			printf("%s", bout.buffer.c_str());
+			TEST_FAILED;
+		}
+
+		// The fields must be accessed directly without calling the accessors
+		asIScriptFunction *func = mod->GetFunctionByName("func");
+		asUINT len;
+		asDWORD *bc = func->GetByteCode(&len);
+		for( asUINT n = 0; n < len; n += asBCTypeSize[asBCInfo[asBYTE(bc[n])].type] )
+		{
+			if( asBYTE(bc[n]) == asBC_CALLSYS )
+			{
+				TEST_FAILED;
+				break;
+			}
+		}
+
+		r = ExecuteString(engine, "func()", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+		if( entity.health != 90 || entity.speed != 3.0f || entity.alive )
+			TEST_FAILED;
+
+		// The accessors can still be called explicitly
+		r = ExecuteString(engine, "e.set_health(e.get_health() + 5); assert( e.get_mass() == 80 ); e.set_alive(true);", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+		if( entity.health != 95 || !entity.alive )
+			TEST_FAILED;
+
+		// A field without a set accessor is read-only
+		r = ExecuteString(engine, "e.mass = 1;", mod);
+		if( r >= 0 )
+			TEST_FAILED;
+		if( bout.buffer != "ExecuteString (1, 8) : Error   : Reference is read-only\n" )
+		{
+			printf("%s", bout.buffer.c_str());
+			TEST_FAILED;
+		}
+
+		engine->Release();
+	}
+
+	// Test normal accessors mixed with accessors that are aliases for fields
+	{
+		bout.buffer = "";
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(CBufferedOutStream,Callback), &bout, asCALL_THISCALL);
+
+		CEntity entity = {100, 1.5f, true, 80.0};
+		engine->RegisterObjectType("Entity", 0, asOBJ_REF | asOBJ_NOCOUNT);
+		r = engine->RegisterObjectMethod("Entity", "int get_level() const", asFUNCTION(Entity_GetLevel_Generic), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectFieldAccessor("Entity", "int get_health() const", asOFFSET(CEntity, health)); assert( r >= 0 );
+		r = engine->RegisterObjectMethod("Entity", "void set_level(int)", asFUNCTION(Entity_SetLevel_Generic), asCALL_GENERIC); assert( r >= 0 );
+		r = engine->RegisterObjectFieldAccessor("Entity", "void set_health(int)", asOFFSET(CEntity, health)); assert( r >= 0 );
+		r = engine->RegisterGlobalProperty("Entity e", &entity); assert( r >= 0 );
+
+		mod = engine->GetModule("test", asGM_ALWAYS_CREATE);
+		mod->AddScriptSection("test",
+			"void func() \n"
+			"{ \n"
+			"  e.level = e.level + 1; \n"
+			"  e.health += 5; \n"
+			"} \n");
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+		if( bout.buffer != "" )
+		{
+			printf("%s", bout.buffer.c_str());
+			TEST_FAILED;
+		}
+
+		// Only the normal accessors must be called
+		asIScriptFunction *func = mod->GetFunctionByName("func");
+		asUINT len, calls = 0;
+		asDWORD *bc = func->GetByteCode(&len);
+		for( asUINT n = 0; n < len; n += asBCTypeSize[asBCInfo[asBYTE(bc[n])].type] )
+		{
+			if( asBYTE(bc[n]) == asBC_CALLSYS )
+				calls++;
+		}
+		if( calls != 2 )
+			TEST_FAILED;
+
+		r = ExecuteString(engine, "func()", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+		if( entity.health != 115 )
+			TEST_FAILED;
+
+		engine->Release();
+	}
+
+	// Test that a field with only a set accessor alias can't be read, and that
+	// the properties for the aliases are not seen by the application
+	{
+		bout.buffer = "";
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(CBufferedOutStream,Callback), &bout, asCALL_THISCALL);
+
+		CEntity entity = {100, 1.5f, true, 80.0};
+		engine->RegisterObjectType("Entity", 0, asOBJ_REF | asOBJ_NOCOUNT);
+		r = engine->RegisterObjectFieldAccessor("Entity", "void set_speed(float)", asOFFSET(CEntity, speed)); assert( r >= 0 );
+		r = engine->RegisterObjectFieldAccessor("Entity", "double get_mass() const", asOFFSET(CEntity, mass)); assert( r >= 0 );
+		r = engine->RegisterObjectProperty("Entity", "int health", asOFFSET(CEntity, health)); assert( r >= 0 );
+		r = engine->RegisterGlobalProperty("Entity e", &entity); assert( r >= 0 );
+
+		mod = engine->GetModule("test", asGM_ALWAYS_CREATE);
+		r = ExecuteString(engine, "e.speed = 2;", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+		if( entity.speed != 2.0f )
+			TEST_FAILED;
+
+		r = ExecuteString(engine, "float f = e.speed;", mod);
+		if( r >= 0 )
+			TEST_FAILED;
+		if( bout.buffer != "ExecuteString (1, 11) : Error   : The property has no get accessor\n" )
+		{
+			printf("%s", bout.buffer.c_str());
+			TEST_FAILED;
+		}
+
+		asIObjectType *type = engine->GetObjectTypeByName("Entity");
+		if( type->GetPropertyCount() != 1 )
+			TEST_FAILED;
+		const char *name = 0;
+		type->GetProperty(0, &name);
+		if( name == 0 || std::string(name) != "health" )
+			TEST_FAILED;
+		if( type->GetProperty(1, &name) != asINVALID_ARG || type->GetPropertyDeclaration(1) != 0 )
+			TEST_FAILED;
+
+		engine->Release();
+	}
+
+	// Test invalid registrations of field accessors
+	{
+		bout.buffer = "";
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(CBufferedOutStream,Callback), &bout, asCALL_THISCALL);
+
+		engine->RegisterObjectType("Entity", 0, asOBJ_REF | asOBJ_NOCOUNT);
+		r = engine->RegisterObjectFieldAccessor("Entity", "double get_mass() const", asOFFSET(CEntity, mass)); assert( r >= 0 );
+
+		// Only simple accessors of primitives can be aliases, and the offset must match the other accessor
+		r = engine->RegisterObjectFieldAccessor("Entity", "int &get_ref()", 0);
+		if( r != asINVALID_DECLARATION )
+			TEST_FAILED;
+		r = engine->RegisterObjectFieldAccessor("Entity", "int get_idx(uint)", 0);
+		if( r != asINVALID_DECLARATION )
+			TEST_FAILED;
+		r = engine->RegisterObjectFieldAccessor("Entity", "void set_mass(double)", 0);
+		if( r != asNAME_TAKEN )
+			TEST_FAILED;
+		if( bout.buffer != " (0, 0) : Error   : Failed in call to function 'RegisterObjectFieldAccessor' with 'Entity' and 'int &get_ref()' (Code: -10)\n"
+		                   " (0, 0) : Error   : Failed in call to function 'RegisterObjectFieldAccessor' with 'Entity' and 'int get_idx(uint)' (Code: -10)\n"
+		                   " (0, 0) : Error   : Failed in call to function 'RegisterObjectFieldAccessor' with 'Entity' and 'void set_mass(double)' (Code: -9)\n" )
+		{
+			printf("%s", bout.buffer.c_str());
+			TEST_FAILED;
+		}
+
+		engine->Release();
+	}
+
 	fail = Test2() || fail;
 
 	// Success
@@ -325,6 +325,11 @@ public:
 };
 
 bool TestAndrewPrice();
+bool TestConfigImage();
+bool TestLazyLoad();
+bool TestCompressedByteCode();
+bool TestBundle();
+bool TestVerifyByteCode();
 
 bool Test()
 {
@@ -419,6 +424,21 @@ bool Test()
 	Test2();
 	TestAndrewPrice();
 
+	if( TestConfigImage() )
+		TEST_FAILED;
+
+	if( TestLazyLoad() )
+		TEST_FAILED;
+
+	if( TestCompressedByteCode() )
+		TEST_FAILED;
+
+	if( TestBundle() )
+		TEST_FAILED;
+
+	if( TestVerifyByteCode() )
+		TEST_FAILED;
+
 
 	// Test saving/loading with array of function pointers
 	// http://www.gamedev.net/topic/627737-bytecode-loading-error/
@@ -1780,5 +1800,822 @@ bool TestAndrewPrice()
 	return fail;
 }
 
-} // namespace
+struct CfgPoint
+{
+	int x;
+	int y;
+	int Sum() const { return x + y; }
+};
+
+static int CfgAdd(int a, int b)
+{
+	return a + b;
+}
+
+static int g_cfgValue = 0;
+
+// Registers the same application interface each time it is called
+static void RegisterCfgInterface(asIScriptEngine *engine)
+{
+	RegisterScriptArray(engine, true);
+	RegisterStdString(engine);
+
+	engine->RegisterEnum("ECfg");
+	engine->RegisterEnumValue("ECfg", "ECfg_A", 1);
+	engine->RegisterEnumValue("ECfg", "ECfg_B", 2);
+	engine->RegisterFuncdef("void CfgCallback(ECfg, const string &in)");
+
+	engine->RegisterObjectType("point", sizeof(CfgPoint), asOBJ_VALUE | asOBJ_POD | asOBJ_APP_CLASS | asOBJ_APP_CLASS_ALLINTS);
+	engine->RegisterObjectProperty("point", "int x", asOFFSET(CfgPoint, x));
+	engine->RegisterObjectProperty("point", "int y", asOFFSET(CfgPoint, y));
+	engine->RegisterObjectMethod("point", "int sum() const", asMETHOD(CfgPoint, Sum), asCALL_THISCALL);
+
+	engine->RegisterObjectType("ref", 0, asOBJ_REF);
+	engine->RegisterObjectBehaviour("ref", asBEHAVE_FACTORY, "ref @f(ECfg e = ECfg_B)", asFUNCTION(Dummy), asCALL_GENERIC);
+	engine->RegisterObjectBehaviour("ref", asBEHAVE_ADDREF, "void f()", asFUNCTION(Dummy), asCALL_GENERIC);
+	engine->RegisterObjectBehaviour("ref", asBEHAVE_RELEASE, "void f()", asFUNCTION(Dummy), asCALL_GENERIC);
+	engine->RegisterObjectMethod("ref", "void set(CfgCallback @+ cb, const array<point> &in pts)", asFUNCTION(Dummy), asCALL_GENERIC);
+
+	engine->SetDefaultNamespace("cfg");
+	engine->RegisterGlobalFunction("int add(int a, int b = 2)", asFUNCTION(CfgAdd), asCALL_CDECL);
+	engine->SetDefaultNamespace("");
+	engine->RegisterGlobalFunction("array<int> @+ makeArray(ECfg e, const string &in s = \"test\")", asFUNCTION(Dummy), asCALL_GENERIC);
+	engine->RegisterGlobalProperty("int cfgValue", &g_cfgValue);
+}
+
+// Produces a textual listing of the registered interface that can be compared between engines
+static string DescribeCfgInterface(asIScriptEngine *engine)
+{
+	string desc;
+	char buf[64];
+
+	for( asUINT n = 0; n < engine->GetGlobalFunctionCount(); n++ )
+	{
+		asIScriptFunction *func = engine->GetGlobalFunctionByIndex(n);
+		desc += func->GetDeclaration(true, true);
+		desc += "\n";
+	}
+	for( asUINT n = 0; n < engine->GetFuncdefCount(); n++ )
+	{
+		desc += engine->GetFuncdefByIndex(n)->GetDeclaration();
+		desc += "\n";
+	}
+	for( asUINT n = 0; n < engine->GetGlobalPropertyCount(); n++ )
+	{
+		const char *name;
+		int typeId;
+		bool isConst;
+		engine->GetGlobalPropertyByIndex(n, &name, 0, &typeId, &isConst);
+		desc += engine->GetTypeDeclaration(typeId);
+		desc += " ";
+		desc += name;
+		desc += "\n";
+	}
+	for( asUINT n = 0; n < engine->GetObjectTypeCount(); n++ )
+	{
+		asIObjectType *ot = engine->GetObjectTypeByIndex(n);
+		if( string(ot->GetName()) == "first" )
+			continue;
+		for( asUINT m = 0; m < ot->GetFactoryCount(); m++ )
+		{
+			desc += ot->GetFactoryByIndex(m)->GetDeclaration();
+			desc += "\n";
+		}
+		for( asUINT m = 0; m < ot->GetBehaviourCount(); m++ )
+		{
+			asEBehaviours beh;
+			asIScriptFunction *func = ot->GetBehaviourByIndex(m, &beh);
+			sprintf(buf, "%d: ", beh);
+			desc += buf;
+			desc += func->GetDeclaration();
+			desc += "\n";
+		}
+		for( asUINT m = 0; m < ot->GetMethodCount(); m++ )
+		{
+			desc += ot->GetMethodByIndex(m)->GetDeclaration();
+			desc += "\n";
+		}
+		for( asUINT m = 0; m < ot->GetPropertyCount(); m++ )
+		{
+			desc += ot->GetPropertyDeclaration(m);
+			desc += "\n";
+		}
+	}
+
+	return desc;
+}
+
+bool TestConfigImage()
+{
+	bool fail = false;
+	int r;
+	COutStream out;
+	CBufferedOutStream bout;
+	asIScriptEngine *engine;
+	CBytecodeStream stream(__FILE__"cfg");
+
+	// Count the allocations made when the declarations are parsed
+	engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+	int allocs = GetNumAllocations();
+	RegisterCfgInterface(engine);
+	int parseAllocs = GetNumAllocations() - allocs;
+	engine->Release();
+
+	// Record the configuration image while registering the interface
+	engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+	engine->SetEngineProperty(asEP_RECORD_CONFIG_IMAGE, true);
+	RegisterCfgInterface(engine);
+	string original = DescribeCfgInterface(engine);
+	r = engine->SaveConfigImage(&stream);
+	if( r < 0 )
+		TEST_FAILED;
+	r = engine->SaveConfigImage(0);
+	if( r != asINVALID_ARG )
+		TEST_FAILED;
+	engine->Release();
+
+	// Configure a new engine from the image
+	const char *script = 
+		"int test() \n"
+		"{ \n"
+		"  point p; p.x = 1; p.y = 2; \n"
+		"  cfgValue = cfg::add(p.sum()); \n"
+		"  return cfgValue; \n"
+		"} \n";
+
+	engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+	stream.Restart();
+	r = engine->LoadConfigImage(&stream);
+	if( r < 0 )
+		TEST_FAILED;
+	allocs = GetNumAllocations();
+	RegisterCfgInterface(engine);
+
+	// The declarations must not be parsed again. Restoring them from the 
+	// image makes little over half the allocations that parsing them does
+	if( GetNumAllocations() - allocs >= parseAllocs*3/4 )
+	{
+		printf("%d allocations with the image, %d without\n", GetNumAllocations() - allocs, parseAllocs);
+		TEST_FAILED;
+	}
+	if( DescribeCfgInterface(engine) != original )
+	{
+		printf("%s", DescribeCfgInterface(engine).c_str());
+		TEST_FAILED;
+	}
+
+	asIScriptModule *mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+	mod->AddScriptSection("test", script);
+	r = mod->Build();
+	if( r < 0 )
+		TEST_FAILED;
+	g_cfgValue = 0;
+	r = ExecuteString(engine, "test();", mod);
+	if( r != asEXECUTION_FINISHED || g_cfgValue != 5 )
+		TEST_FAILED;
+	engine->Release();
+
+	// When the registration order differs the mismatching entries must
+	// be ignored and the declarations parsed as usual
+	engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+	stream.Restart();
+	r = engine->LoadConfigImage(&stream);
+	if( r < 0 )
+		TEST_FAILED;
+	engine->RegisterObjectType("first", 4, asOBJ_VALUE | asOBJ_POD | asOBJ_APP_PRIMITIVE);
+	engine->RegisterEnum("EFirst");
+	RegisterCfgInterface(engine);
+	if( DescribeCfgInterface(engine) != original )
+	{
+		printf("%s", DescribeCfgInterface(engine).c_str());
+		TEST_FAILED;
+	}
+	mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+	mod->AddScriptSection("test", script);
+	r = mod->Build();
+	if( r < 0 )
+		TEST_FAILED;
+	g_cfgValue = 0;
+	r = ExecuteString(engine, "test();", mod);
+	if( r != asEXECUTION_FINISHED || g_cfgValue != 5 )
+		TEST_FAILED;
+	engine->Release();
+
+	// The image can't be saved if it wasn't recorded
+	engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asMETHOD(CBufferedOutStream,Callback), &bout, asCALL_THISCALL);
+	CBytecodeStream stream2(__FILE__"cfg2");
+	r = engine->SaveConfigImage(&stream2);
+	if( r != asERROR )
+		TEST_FAILED;
+	if( bout.buffer != " (0, 0) : Error   : The config image wasn't recorded. Set asEP_RECORD_CONFIG_IMAGE before registering the application interface\n" )
+	{
+		printf("%s", bout.buffer.c_str());
+		TEST_FAILED;
+	}
+
+	// Loading an invalid image must fail
+	bout.buffer = "";
+	const char garbage[] = "this is not a config image";
+	stream2.Write(garbage, sizeof(garbage));
+	r = engine->LoadConfigImage(&stream2);
+	if( r != asERROR )
+		TEST_FAILED;
+	if( bout.buffer != " (0, 0) : Error   : The config image is invalid or was saved with a different version of the library\n" )
+	{
+		printf("%s", bout.buffer.c_str());
+		TEST_FAILED;
+	}
+	engine->Release();
+
+	return fail;
+}
+
+bool TestLazyLoad()
+{
+	bool fail = false;
+	int r;
+	COutStream out;
+	asIScriptEngine *engine;
+	asIScriptModule *mod;
+
+	const char *script = 
+		"int g_count = 0; \n"
+		"array<string> g_names = {'a', 'b'}; \n"
+		"class Base \n"
+		"{ \n"
+		"  int value() { return 1; } \n"
+		"} \n"
+		"class Derived : Base \n"
+		"{ \n"
+		"  int value() { return helper(10); } \n"
+		"} \n"
+		"int helper(int a) { g_count++; return a + g_names.length(); } \n"
+		"int unused(int a) { array<int> arr = {a}; return arr[0]; } \n"
+		"int run() \n"
+		"{ \n"
+		"  Base @b = Derived(); \n"
+		"  return b.value(); \n"
+		"} \n";
+
+	engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+	RegisterScriptArray(engine, true);
+	RegisterStdString(engine);
+	engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+	mod = engine->GetModule("a", asGM_ALWAYS_CREATE);
+	mod->AddScriptSection("test", script);
+	r = mod->Build();
+	if( r < 0 )
+		TEST_FAILED;
+
+	// Without the property the function bodies are saved without their size,
+	// so they are loaded immediately even if the property is turned on later
+	CBytecodeStream unsized(__FILE__"unsized");
+	r = mod->SaveByteCode(&unsized);
+	if( r < 0 )
+		TEST_FAILED;
+	engine->SetEngineProperty(asEP_LAZY_LOAD_FUNCTIONS, true);
+	CBytecodeStream stream(__FILE__"lazy");
+	r = mod->SaveByteCode(&stream);
+	if( r < 0 )
+		TEST_FAILED;
+	engine->DiscardModule("a");
+
+	if( unsized.buffer.size() >= stream.buffer.size() )
+		TEST_FAILED;
+	mod = engine->GetModule("u", asGM_ALWAYS_CREATE);
+	r = mod->LoadByteCode(&unsized);
+	if( r < 0 )
+		TEST_FAILED;
+	asUINT length = 0;
+	asIScriptFunction *func = mod->GetFunctionByName("unused");
+	if( func == 0 || func->GetByteCode(&length) == 0 || length == 0 )
+		TEST_FAILED;
+	engine->DiscardModule("u");
+
+	// Load the module with the function bodies deferred until the first call
+	mod = engine->GetModule("b", asGM_ALWAYS_CREATE);
+	r = mod->LoadByteCode(&stream);
+	if( r < 0 )
+		TEST_FAILED;
+
+	asIScriptFunction *helper = mod->GetFunctionByName("helper");
+	asIScriptFunction *unused = mod->GetFunctionByName("unused");
+	if( helper == 0 || unused == 0 )
+		TEST_FAILED;
+	else
+	{
+		if( helper->GetByteCode(&length) != 0 || length != 0 )
+			TEST_FAILED;
+
+		r = ExecuteString(engine, "assert( run() == 12 ); assert( g_count == 1 );", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		// Only the functions that were called have been loaded
+		if( helper->GetByteCode(&length) == 0 || length == 0 )
+			TEST_FAILED;
+		if( unused->GetByteCode(&length) != 0 )
+			TEST_FAILED;
+
+		// The functions can also be called directly by the application
+		asIScriptContext *ctx = engine->CreateContext();
+		r = ctx->Prepare(unused);
+		if( r < 0 )
+			TEST_FAILED;
+		ctx->SetArgDWord(0, 42);
+		r = ctx->Execute();
+		if( r != asEXECUTION_FINISHED || ctx->GetReturnDWord() != 42 )
+			TEST_FAILED;
+		ctx->Release();
+	}
+
+	// Saving the module must load the remaining function bodies first
+	CBytecodeStream stream2(__FILE__"lazy2");
+	mod = engine->GetModule("c", asGM_ALWAYS_CREATE);
+	stream.Restart();
+	r = mod->LoadByteCode(&stream);
+	if( r < 0 )
+		TEST_FAILED;
+	r = mod->SaveByteCode(&stream2);
+	if( r < 0 )
+		TEST_FAILED;
+	engine->SetEngineProperty(asEP_LAZY_LOAD_FUNCTIONS, false);
+	mod = engine->GetModule("d", asGM_ALWAYS_CREATE);
+	r = mod->LoadByteCode(&stream2);
+	if( r < 0 )
+		TEST_FAILED;
+	r = ExecuteString(engine, "assert( run() == 12 ); assert( unused(3) == 3 );", mod);
+	if( r != asEXECUTION_FINISHED )
+		TEST_FAILED;
+
+	// A function that wasn't loaded before the module was discarded can no longer be executed
+	engine->SetEngineProperty(asEP_LAZY_LOAD_FUNCTIONS, true);
+	mod = engine->GetModule("e", asGM_ALWAYS_CREATE);
+	stream.Restart();
+	r = mod->LoadByteCode(&stream);
+	if( r < 0 )
+		TEST_FAILED;
+	unused = mod->GetFunctionByName("unused");
+	unused->AddRef();
+	engine->DiscardModule("e");
+	CBufferedOutStream bout;
+	engine->SetMessageCallback(asMETHOD(CBufferedOutStream,Callback), &bout, asCALL_THISCALL);
+	asIScriptContext *ctx = engine->CreateContext();
+	r = ctx->Prepare(unused);
+	if( r != asERROR )
+		TEST_FAILED;
+	if( bout.buffer != " (0, 0) : Error   : Failed in call to function 'Prepare' (Code: -1)\n" )
+	{
+		printf("%s", bout.buffer.c_str());
+		TEST_FAILED;
+	}
+	ctx->Release();
+	unused->Release();
+
+	engine->Release();
+
+	return fail;
+}
+
+bool TestCompressedByteCode()
+{
+	bool fail = false;
+	int r;
+	COutStream out;
+	CBufferedOutStream bout;
+	asIScriptEngine *engine;
+	asIScriptModule *mod;
+
+	// Generate enough code to fill more than one compressed block
+	string script = 
+		"class Counter \n"
+		"{ \n"
+		"  int total = 0; \n"
+		"  void add(int v) { total += v; } \n"
+		"} \n";
+	string run = "int run() \n{ \n  Counter c; \n";
+	for( int n = 0; n < 300; n++ )
+	{
+		char buf[512];
+		sprintf(buf, "int func%d(int a) \n"
+		             "{ \n"
+		             "  array<string> names = {'first', 'second', 'third'}; \n"
+		             "  string s = names[a %% 3] + %d; \n"
+		             "  return int(s.length()) + %d; \n"
+		             "} \n", n, n, n);
+		script += buf;
+		sprintf(buf, "  c.add(func%d(%d)); \n", n, n);
+		run += buf;
+	}
+	run += "  return c.total; \n} \n";
+	script += run;
+
+	engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+	RegisterScriptArray(engine, true);
+	RegisterStdString(engine);
+	engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+	mod = engine->GetModule("a", asGM_ALWAYS_CREATE);
+	mod->AddScriptSection("test", script.c_str(), script.size());
+	r = mod->Build();
+	if( r < 0 )
+		TEST_FAILED;
+
+	int expected = 0;
+	r = ExecuteString(engine, "assert( run() > 0 );", mod);
+	if( r != asEXECUTION_FINISHED )
+		TEST_FAILED;
+	asIScriptContext *ctx = engine->CreateContext();
+	ctx->Prepare(mod->GetFunctionByName("run"));
+	if( ctx->Execute() != asEXECUTION_FINISHED )
+		TEST_FAILED;
+	expected = (int)ctx->GetReturnDWord();
+	ctx->Release();
+
+	CBytecodeStream plain(__FILE__"plain");
+	r = mod->SaveByteCode(&plain);
+	if( r < 0 )
+		TEST_FAILED;
+
+	engine->SetEngineProperty(asEP_COMPRESS_BYTECODE, true);
+	CBytecodeStream compressed(__FILE__"compressed");
+	r = mod->SaveByteCode(&compressed);
+	if( r < 0 )
+		TEST_FAILED;
+	engine->SetEngineProperty(asEP_COMPRESS_BYTECODE, false);
+
+	if( compressed.buffer.size() >= plain.buffer.size() / 2 )
+	{
+		printf("Compressed bytecode is %d bytes, uncompressed is %d bytes\n", (int)compressed.buffer.size(), (int)plain.buffer.size());
+		TEST_FAILED;
+	}
+
+	// The compressed bytecode can be loaded both normally and lazily
+	for( int lazy = 0; lazy < 2; lazy++ )
+	{
+		engine->SetEngineProperty(asEP_LAZY_LOAD_FUNCTIONS, lazy ? true : false);
+		mod = engine->GetModule("b", asGM_ALWAYS_CREATE);
+		compressed.Restart();
+		r = mod->LoadByteCode(&compressed);
+		if( r < 0 )
+			TEST_FAILED;
+
+		ctx = engine->CreateContext();
+		ctx->Prepare(mod->GetFunctionByName("run"));
+		if( ctx->Execute() != asEXECUTION_FINISHED || (int)ctx->GetReturnDWord() != expected )
+			TEST_FAILED;
+		ctx->Release();
+	}
+	engine->SetEngineProperty(asEP_LAZY_LOAD_FUNCTIONS, false);
+
+	// A corrupt block must be detected
+	CBytecodeStream corrupt(__FILE__"corrupt");
+	corrupt.buffer = compressed.buffer;
+	corrupt.buffer[40] ^= 0x55;
+	engine->SetMessageCallback(asMETHOD(CBufferedOutStream,Callback), &bout, asCALL_THISCALL);
+	mod = engine->GetModule("c", asGM_ALWAYS_CREATE);
+	r = mod->LoadByteCode(&corrupt);
+	if( r >= 0 )
+		TEST_FAILED;
+	if( bout.buffer != " (0, 0) : Error   : The compressed bytecode is corrupt\n" )
+	{
+		printf("%s", bout.buffer.c_str());
+		TEST_FAILED;
+	}
+
+	engine->Release();
+
+	return fail;
+}
+
+static const char *bundleShared =
+"shared class Shape \n"
+"{ \n"
+"  Shape(int s) { sides = s; } \n"
+"  int count() { return sides; } \n"
+"  int sides; \n"
+"} \n"
+"shared int twice(int a) \n"
+"{ \n"
+"  int r = 0; \n"
+"  for( int n = 0; n < 2; n++ ) \n"
+"    r += a; \n"
+"  return r; \n"
+"} \n";
+
+static asIScriptEngine *CreateBundleEngine(CBufferedOutStream &bout)
+{
+	asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asMETHOD(CBufferedOutStream,Callback), &bout, asCALL_THISCALL);
+	RegisterScriptArray(engine, true);
+	RegisterStdString(engine);
+	engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+	return engine;
+}
 
+static int RunBundleMain(asIScriptModule *mod)
+{
+	if( mod == 0 )
+		return -1;
+
+	int result = -1;
+	asIScriptContext *ctx = mod->GetEngine()->CreateContext();
+	ctx->Prepare(mod->GetFunctionByDecl("int main()"));
+	if( ctx->Execute() == asEXECUTION_FINISHED )
+		result = (int)ctx->GetReturnDWord();
+	ctx->Release();
+	return result;
+}
+
+bool TestBundle()
+{
+	bool fail = false;
+	int r;
+	CBufferedOutStream bout;
+	asIScriptEngine *engine;
+	const int numModules = 3;
+	const char *names[numModules] = {"first", "second", "third"};
+	asIScriptModule *mods[numModules];
+
+	engine = CreateBundleEngine(bout);
+	for( int n = 0; n < numModules; n++ )
+	{
+		char buf[512];
+		sprintf(buf, "int g = %d; \n"
+		             "int main() \n"
+		             "{ \n"
+		             "  Shape s(%d); \n"
+		             "  array<string> a = {'a', 'b'}; \n"
+		             "  string str = 'module ' + g; \n"
+		             "  assert( str.length() > 0 ); \n"
+		             "  return twice(s.count()) + g + int(a.length()); \n"
+		             "} \n", (n+1)*10, n+1);
+		mods[n] = engine->GetModule(names[n], asGM_ALWAYS_CREATE);
+		mods[n]->AddScriptSection("shared", bundleShared);
+		mods[n]->AddScriptSection(names[n], buf);
+		r = mods[n]->Build();
+		if( r < 0 )
+			TEST_FAILED;
+	}
+
+	// The bundle stores the symbols and shared code only once
+	asUINT separateSize = 0;
+	for( int n = 0; n < numModules; n++ )
+	{
+		CBytecodeStream stream(__FILE__"single");
+		mods[n]->SaveByteCode(&stream);
+		separateSize += (asUINT)stream.buffer.size();
+	}
+
+	CBytecodeStream bundle(__FILE__"bundle");
+	r = engine->SaveByteCodeBundle(mods, numModules, &bundle);
+	if( r < 0 )
+		TEST_FAILED;
+	if( bundle.buffer.size() >= separateSize )
+	{
+		printf("The bundle is %d bytes, the separate modules are %d bytes\n", (int)bundle.buffer.size(), (int)separateSize);
+		TEST_FAILED;
+	}
+
+	engine->SetEngineProperty(asEP_COMPRESS_BYTECODE, true);
+	CBytecodeStream compressed(__FILE__"compressed");
+	r = engine->SaveByteCodeBundle(mods, numModules, &compressed);
+	if( r < 0 )
+		TEST_FAILED;
+
+	// A single module can't be loaded from a bundle
+	asIScriptModule *mod = engine->GetModule("single", asGM_ALWAYS_CREATE);
+	r = mod->LoadByteCode(&bundle);
+	if( r >= 0 )
+		TEST_FAILED;
+	if( bout.buffer != " (0, 0) : Error   : The bytecode holds a bundle of modules and must be loaded with LoadByteCodeBundle\n" )
+	{
+		printf("%s", bout.buffer.c_str());
+		TEST_FAILED;
+	}
+	bout.buffer = "";
+
+	CBytecodeStream single(__FILE__"single");
+	mods[0]->SaveByteCode(&single);
+	r = engine->LoadByteCodeBundle(&single);
+	if( r >= 0 )
+		TEST_FAILED;
+	if( bout.buffer != " (0, 0) : Error   : The bytecode doesn't hold a bundle of modules\n" )
+	{
+		printf("%s", bout.buffer.c_str());
+		TEST_FAILED;
+	}
+	bout.buffer = "";
+
+	engine->Release();
+
+	// Load the bundle in a new engine, both with and without compression
+	for( int c = 0; c < 2; c++ )
+	{
+		engine = CreateBundleEngine(bout);
+		CBytecodeStream &stream = c ? compressed : bundle;
+		stream.Restart();
+		r = engine->LoadByteCodeBundle(&stream);
+		if( r < 0 )
+			TEST_FAILED;
+
+		for( int n = 0; n < numModules; n++ )
+		{
+			mods[n] = engine->GetModule(names[n]);
+			if( RunBundleMain(mods[n]) != 2*(n+1) + (n+1)*10 + 2 )
+				TEST_FAILED;
+		}
+
+		// The shared code is the same in all the modules
+		if( mods[0] && mods[2] &&
+			mods[0]->GetFunctionByName("twice") != mods[2]->GetFunctionByName("twice") )
+			TEST_FAILED;
+
+		// The modules must be independent of each other
+		engine->DiscardModule(names[0]);
+		if( RunBundleMain(engine->GetModule(names[1])) != 2*2 + 20 + 2 )
+			TEST_FAILED;
+
+		if( bout.buffer != "" )
+		{
+			printf("%s", bout.buffer.c_str());
+			TEST_FAILED;
+		}
+
+		engine->Release();
+	}
+
+	return fail;
+}
+
+static bool AllFunctionsVerified(asIScriptModule *mod)
+{
+	for( asUINT n = 0; n < mod->GetFunctionCount(); n++ )
+		if( !mod->GetFunctionByIndex(n)->IsByteCodeVerified() )
+			return false;
+	return true;
+}
+
+bool TestVerifyByteCode()
+{
+	bool fail = false;
+	int r;
+	CBufferedOutStream bout;
+	asIScriptEngine *engine;
+	asIScriptModule *mod;
+
+	const char *script =
+		"funcdef int CALLBACK(int); \n"
+		"class Acc \n"
+		"{ \n"
+		"  int total = 0; \n"
+		"  void add(int v) { total += v; } \n"
+		"} \n"
+		"int dbl(int a) { return a*2; } \n"
+		"int f() { int a = 42; return a; } \n"
+		"int main() \n"
+		"{ \n"
+		"  Acc acc; \n"
+		// A function name by itself doesn't push anything on the stack
+		"  dbl; \n"
+		"  CALLBACK @cb = dbl; \n"
+		"  array<string> strs = {'a', 'bb', 'ccc'}; \n"
+		"  for( uint n = 0; n < strs.length(); n++ ) \n"
+		"  { \n"
+		"    switch( n ) \n"
+		"    { \n"
+		"    case 0: acc.add(cb(int(strs[n].length()))); break; \n"
+		"    case 1: acc.add(dbl(2)); break; \n"
+		"    default: acc.add(f()); \n"
+		"    } \n"
+		"  } \n"
+		"  return acc.total; \n"
+		"} \n";
+
+	// The bytecode produced by the compiler must pass the verification
+	engine = CreateVerifyingScriptEngine(ANGELSCRIPT_VERSION);
+	engine->SetMessageCallback(asMETHOD(CBufferedOutStream,Callback), &bout, asCALL_THISCALL);
+	RegisterScriptArray(engine, true);
+	RegisterStdString(engine);
+
+	mod = engine->GetModule("a", asGM_ALWAYS_CREATE);
+	mod->AddScriptSection("test", script);
+	r = mod->Build();
+	if( r < 0 )
+		TEST_FAILED;
+	if( !AllFunctionsVerified(mod) )
+		TEST_FAILED;
+
+	CBytecodeStream stream(__FILE__"verify");
+	r = mod->SaveByteCode(&stream);
+	if( r < 0 )
+		TEST_FAILED;
+
+	// Loaded bytecode is only verified when asked for
+	for( int verify = 0; verify < 2; verify++ )
+	{
+		engine->SetEngineProperty(asEP_VERIFY_BYTECODE, verify ? true : false);
+		mod = engine->GetModule("b", asGM_ALWAYS_CREATE);
+		stream.Restart();
+		r = mod->LoadByteCode(&stream);
+		if( r < 0 )
+			TEST_FAILED;
+		if( AllFunctionsVerified(mod) != (verify ? true : false) )
+			TEST_FAILED;
+
+		asIScriptContext *ctx = engine->CreateContext();
+		ctx->Prepare(mod->GetFunctionByDecl("int main()"));
+		if( ctx->Execute() != asEXECUTION_FINISHED || ctx->GetReturnDWord() != 2*1 + 2*2 + 42 )
+			TEST_FAILED;
+		ctx->Release();
+	}
+
+	// Make the variable offset in f() point outside the stack frame, and
+	// save the bytecode again. The verification must detect it when loading
+	asUINT length;
+	asDWORD *bc = mod->GetFunctionByDecl("int f()")->GetByteCode(&length);
+	asUINT pos;
+	short var = 0;
+	for( pos = 0; pos < length; pos += asBCTypeSize[asBCInfo[*(asBYTE*)&bc[pos]].type] )
+	{
+		if( *(asBYTE*)&bc[pos] == asBC_SetV4 )
+		{
+			var = asBC_SWORDARG0(&bc[pos]);
+			asBC_SWORDARG0(&bc[pos]) = 100;
+			break;
+		}
+	}
+	if( pos == length )
+		TEST_FAILED;
+
+	CBytecodeStream corrupt(__FILE__"verifycorrupt");
+	r = mod->SaveByteCode(&corrupt);
+	if( r < 0 )
+		TEST_FAILED;
+
+	// Restore f() and instead make main() store an integer in the variable 
+	// that holds the pointer to the object. That must be detected too
+	if( pos < length )
+		asBC_SWORDARG0(&bc[pos]) = var;
+	bc = mod->GetFunctionByDecl("int main()")->GetByteCode(&length);
+	short objVar = 0;
+	asUINT pos2;
+	for( pos2 = 0; pos2 < length; pos2 += asBCTypeSize[asBCInfo[*(asBYTE*)&bc[pos2]].type] )
+	{
+		if( *(asBYTE*)&bc[pos2] == asBC_STOREOBJ && objVar == 0 )
+			objVar = asBC_SWORDARG0(&bc[pos2]);
+		else if( *(asBYTE*)&bc[pos2] == asBC_SetV4 && objVar != 0 )
+		{
+			asBC_SWORDARG0(&bc[pos2]) = objVar;
+			break;
+		}
+	}
+	if( pos2 == length )
+		TEST_FAILED;
+
+	CBytecodeStream corrupt2(__FILE__"verifycorrupt2");
+	r = mod->SaveByteCode(&corrupt2);
+	if( r < 0 )
+		TEST_FAILED;
+	engine->DiscardModule("b");
+
+	mod = engine->GetModule("c", asGM_ALWAYS_CREATE);
+	r = mod->LoadByteCode(&corrupt);
+	if( r >= 0 )
+		TEST_FAILED;
+
+	char expected[256];
+	sprintf(expected, " (0, 0) : Error   : The bytecode of function 'int f()' failed the verification: Invalid variable offset at position %d\n", pos);
+	if( bout.buffer.substr(0, strlen(expected)) != expected )
+	{
+		printf("%s", bout.buffer.c_str());
+		TEST_FAILED;
+	}
+
+	bout.buffer = "";
+	mod = engine->GetModule("d", asGM_ALWAYS_CREATE);
+	r = mod->LoadByteCode(&corrupt2);
+	if( r >= 0 )
+		TEST_FAILED;
+
+	sprintf(expected, " (0, 0) : Error   : The bytecode of function 'int main()' failed the verification: Variable used both as pointer and value at position %d\n", pos2);
+	if( bout.buffer.substr(0, strlen(expected)) != expected )
+	{
+		printf("%s", bout.buffer.c_str());
+		TEST_FAILED;
+	}
+
+	engine->Release();
+
+	return fail;
+}
+
+} // namespace
@@ -56,6 +56,170 @@ void STDCALL LineCallback(asIScriptContext *ctx, void * /*param*/)
 	ctx->Suspend();
 }
 
+// Script interface for the engine's co-routines
+void CoAddRef(asIScriptGeneric *gen)
+{
+	reinterpret_cast<asIScriptCoroutine*>(gen->GetObject())->AddRef();
+}
+
+void CoRelease(asIScriptGeneric *gen)
+{
+	reinterpret_cast<asIScriptCoroutine*>(gen->GetObject())->Release();
+}
+
+void CoCreate(asIScriptGeneric *gen)
+{
+	asIScriptContext *ctx = asGetActiveContext();
+	asIScriptFunction *func = *reinterpret_cast<asIScriptFunction**>(gen->GetAddressOfArg(0));
+	asIScriptCoroutine *co = ctx->CreateCoroutine(func);
+	if( co == 0 )
+	{
+		ctx->SetException("Invalid co-routine function");
+		return;
+	}
+
+	co->SetArgDWord(0, gen->GetArgDWord(1));
+	gen->SetReturnObject(co);
+	co->Release();
+}
+
+void CoResume(asIScriptGeneric *gen)
+{
+	asIScriptContext *ctx = asGetActiveContext();
+	if( ctx->ResumeCoroutine(reinterpret_cast<asIScriptCoroutine*>(gen->GetObject())) < 0 )
+		ctx->SetException("Cannot resume co-routine");
+}
+
+void CoFinished(asIScriptGeneric *gen)
+{
+	asIScriptCoroutine *co = reinterpret_cast<asIScriptCoroutine*>(gen->GetObject());
+	gen->SetReturnByte(co->GetState() == asEXECUTION_FINISHED);
+}
+
+void CoYield(asIScriptGeneric *)
+{
+	asIScriptContext *ctx = asGetActiveContext();
+	if( ctx->YieldCoroutine() < 0 )
+		ctx->SetException("Not in a co-routine");
+}
+
+void RegisterCoroutine(asIScriptEngine *engine)
+{
+	int r;
+	r = engine->RegisterFuncdef("void CO_FUNC(int)"); assert( r >= 0 );
+	r = engine->RegisterObjectType("coroutine", 0, asOBJ_REF); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("coroutine", asBEHAVE_ADDREF, "void f()", asFUNCTION(CoAddRef), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectBehaviour("coroutine", asBEHAVE_RELEASE, "void f()", asFUNCTION(CoRelease), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("coroutine", "void resume()", asFUNCTION(CoResume), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterObjectMethod("coroutine", "bool get_finished()", asFUNCTION(CoFinished), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterGlobalFunction("coroutine @createCoroutine(CO_FUNC @, int)", asFUNCTION(CoCreate), asCALL_GENERIC); assert( r >= 0 );
+	r = engine->RegisterGlobalFunction("void yield()", asFUNCTION(CoYield), asCALL_GENERIC); assert( r >= 0 );
+}
+
+// Asynchronous calls that are completed by the application
+std::vector<asIAsyncCall*> pendingCalls;
+std::vector<asIScriptContext*> readyContexts;
+
+void AsyncFetch(asIScriptGeneric * /*gen*/)
+{
+	asIAsyncCall *call = asGetActiveContext()->BeginAsyncCall();
+	if( call )
+		pendingCalls.push_back(call);
+}
+
+void AsyncFetchNow(asIScriptGeneric *gen)
+{
+	// The result is known immediately so the script continues without being suspended
+	asIAsyncCall *call = asGetActiveContext()->BeginAsyncCall();
+	if( call )
+	{
+		call->SetReturnDouble(gen->GetArgDouble(0)*2);
+		call->Complete();
+		call->Release();
+	}
+}
+
+void AsyncCallback(asIScriptContext *ctx, void * /*param*/)
+{
+	// The context is made runnable again
+	ctx->AddRef();
+	readyContexts.push_back(ctx);
+}
+
+// Saves the objects referenced by a suspended context. Script objects are
+// given an id so that references to the same object are restored as one
+class CStateSerializer : public asIContextSerializer
+{
+public:
+	CStateSerializer(asIScriptEngine *engine) : engine(engine) {}
+	~CStateSerializer()
+	{
+		for( size_t n = 0; n < loaded.size(); n++ )
+			loaded[n]->Release();
+	}
+
+	int SaveObject(asIBinaryStream *out, void *obj, int typeId)
+	{
+		if( typeId & asTYPEID_SCRIPTOBJECT )
+		{
+			asUINT id = 0;
+			while( id < saved.size() && saved[id] != obj )
+				id++;
+			out->Write(&id, sizeof(id));
+			if( id == saved.size() )
+			{
+				saved.push_back(obj);
+				out->Write(((asIScriptObject*)obj)->GetAddressOfProperty(0), sizeof(int));
+			}
+			return 0;
+		}
+		if( typeId == engine->GetTypeIdByDecl("string") )
+		{
+			std::string &str = *(std::string*)obj;
+			asUINT len = (asUINT)str.length();
+			out->Write(&len, sizeof(len));
+			out->Write(str.c_str(), len);
+			return 0;
+		}
+		return -1;
+	}
+
+	void *LoadObject(asIBinaryStream *in, void *mem, int typeId)
+	{
+		if( typeId & asTYPEID_SCRIPTOBJECT )
+		{
+			asUINT id = 0;
+			in->Read(&id, sizeof(id));
+			if( id == loaded.size() )
+			{
+				asIScriptObject *obj = (asIScriptObject*)engine->CreateScriptObject(typeId);
+				in->Read(obj->GetAddressOfProperty(0), sizeof(int));
+				loaded.push_back(obj);
+			}
+			loaded[id]->AddRef();
+			return loaded[id];
+		}
+		if( typeId == engine->GetTypeIdByDecl("string") )
+		{
+			asUINT len = 0;
+			in->Read(&len, sizeof(len));
+			std::string str(len, ' ');
+			in->Read(&str[0], len);
+			return new(mem) std::string(str);
+		}
+		return 0;
+	}
+
+	asIScriptEngine *engine;
+	std::vector<void*> saved;
+	std::vector<asIScriptObject*> loaded;
+};
+
+void Wait(asIScriptGeneric * /*gen*/)
+{
+	asGetActiveContext()->Suspend();
+}
+
 bool Test()
 { 
 	bool fail = false;
@@ -206,6 +370,415 @@ bool Test()
 		engine->Release();
 	}
 
+	// Test co-routines executed within the same context
+#if 1
+	{
+		asIScriptEngine *engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+		RegisterStdString(engine);
+		RegisterScriptArray(engine, true);
+		RegisterCoroutine(engine);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+		engine->RegisterGlobalFunction("void Suspend()", asFUNCTION(Suspend), asCALL_GENERIC);
+
+		asIScriptModule *mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+		mod->AddScriptSection(":1",
+			"int value = 0; \n"
+			"int destroyed = 0; \n"
+			"string log; \n"
+			"class Obj { ~Obj() { destroyed++; } } \n"
+			// A generator that yields a new value each time it is resumed
+			"void generator(int count) \n"
+			"{ \n"
+			"  string s = 'gen'; \n"
+			"  for( int n = 1; n <= count; n++ ) \n"
+			"  { \n"
+			"    value = n; \n"
+			"    yield(); \n"
+			"  } \n"
+			"  value = -1; \n"
+			"} \n"
+			"void inner(int) \n"
+			"{ \n"
+			"  log += 'i1'; \n"
+			"  yield(); \n"
+			"  log += 'i2'; \n"
+			"} \n"
+			// A co-routine that resumes another yields back to its own resumer
+			"void outer(int) \n"
+			"{ \n"
+			"  coroutine @co = createCoroutine(inner, 0); \n"
+			"  co.resume(); \n"
+			"  log += 'o1'; \n"
+			"  yield(); \n"
+			"  co.resume(); \n"
+			"  log += 'o2'; \n"
+			"} \n"
+			"void holder(int) \n"
+			"{ \n"
+			"  Obj o; \n"
+			"  yield(); \n"
+			"} \n"
+			"void thrower(int) \n"
+			"{ \n"
+			"  Obj o; \n"
+			"  int a = 0; \n"
+			"  a = 1/a; \n"
+			"} \n"
+			"void waiter() \n"
+			"{ \n"
+			"  Suspend(); \n"
+			"  log = 'done'; \n"
+			"} \n");
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+
+		r = ExecuteString(engine,
+			"coroutine @co = createCoroutine(generator, 3); \n"
+			"int sum = 0; \n"
+			"co.resume(); \n"
+			"while( !co.finished ) \n"
+			"{ \n"
+			"  sum += value; \n"
+			"  co.resume(); \n"
+			"} \n"
+			"assert( sum == 6 ); \n"
+			"assert( value == -1 ); \n", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		r = ExecuteString(engine,
+			"coroutine @co = createCoroutine(outer, 0); \n"
+			"co.resume(); \n"
+			"log += 'm1'; \n"
+			"co.resume(); \n"
+			"log += 'm2'; \n"
+			"assert( co.finished ); \n"
+			"assert( log == 'i1o1m1i2o2m2' ); \n", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		// Suspended co-routines must release the objects on their stack when discarded
+		r = ExecuteString(engine,
+			"coroutine@[] cos; \n"
+			"for( int n = 0; n < 1000; n++ ) \n"
+			"{ \n"
+			"  coroutine @co = createCoroutine(holder, n); \n"
+			"  co.resume(); \n"
+			"  cos.insertLast(co); \n"
+			"} \n"
+			"assert( destroyed == 0 ); \n"
+			"cos.resize(0); \n"
+			"assert( destroyed == 1000 ); \n", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		// Yielding outside a co-routine or resuming a finished one is an error
+		r = ExecuteString(engine, "yield();", mod);
+		if( r != asEXECUTION_EXCEPTION )
+			TEST_FAILED;
+		r = ExecuteString(engine,
+			"coroutine @co = createCoroutine(inner, 0); \n"
+			"co.resume(); co.resume(); co.resume(); \n", mod);
+		if( r != asEXECUTION_EXCEPTION )
+			TEST_FAILED;
+
+		// An exception in a co-routine unwinds it and the state that resumed it
+		ctx = engine->CreateContext();
+		r = ExecuteString(engine,
+			"destroyed = 0; \n"
+			"Obj o; \n"
+			"coroutine @co = createCoroutine(thrower, 0); \n"
+			"co.resume(); \n", mod, ctx);
+		if( r != asEXECUTION_EXCEPTION )
+			TEST_FAILED;
+		if( std::string(ctx->GetExceptionFunction()->GetName()) != "thrower" ||
+			std::string(ctx->GetExceptionString()) != "Divide by zero" )
+			TEST_FAILED;
+		if( ctx->GetCoroutine() == 0 )
+			TEST_FAILED;
+		ctx->Unprepare();
+		if( ctx->GetCoroutine() != 0 )
+			TEST_FAILED;
+		int *destroyed = (int*)mod->GetAddressOfGlobalVar(mod->GetGlobalVarIndexByName("destroyed"));
+		if( *destroyed != 2 )
+			TEST_FAILED;
+
+		// The application can create and resume co-routines while the context is suspended
+		r = ctx->Prepare(mod->GetFunctionByDecl("void waiter()"));
+		if( r < 0 )
+			TEST_FAILED;
+		r = ctx->Execute();
+		if( r != asEXECUTION_SUSPENDED )
+			TEST_FAILED;
+		asIScriptCoroutine *co = ctx->CreateCoroutine(mod->GetFunctionByDecl("void generator(int)"));
+		if( co == 0 || co->SetArgDWord(0, 2) < 0 )
+			TEST_FAILED;
+		if( ctx->ResumeCoroutine(co) < 0 || ctx->GetCoroutine() != co )
+			TEST_FAILED;
+		r = ctx->Execute();
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+		if( co->GetState() != asEXECUTION_SUSPENDED )
+			TEST_FAILED;
+		r = ExecuteString(engine, "assert( value == 1 ); assert( log == 'done' );", mod);
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		// The co-routine is discarded if the context is released first
+		ctx->Release();
+		if( co->GetContext() != 0 || co->GetState() != asEXECUTION_ABORTED )
+			TEST_FAILED;
+		co->Release();
+		engine->Release();
+	}
+#endif
+
+	// Test asynchronous calls that resume the script when the result is ready
+	{
+		COutStream out;
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+		RegisterScriptString_Generic(engine);
+		engine->RegisterGlobalFunction("int fetch()", asFUNCTION(AsyncFetch), asCALL_GENERIC);
+		engine->RegisterGlobalFunction("string @fetchName()", asFUNCTION(AsyncFetch), asCALL_GENERIC);
+		engine->RegisterGlobalFunction("double fetchNow(double)", asFUNCTION(AsyncFetchNow), asCALL_GENERIC);
+		r = engine->SetAsyncCallCallback(asFUNCTION(AsyncCallback), 0, asCALL_CDECL);
+		if( r < 0 )
+			TEST_FAILED;
+
+		mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+		mod->AddScriptSection(TESTNAME,
+			"int total = 0; \n"
+			"string name; \n"
+			"void main() \n"
+			"{ \n"
+			"  total += fetch(); \n"
+			"  total += fetch(); \n"
+			"  total += int(fetchNow(4)); \n"
+			"  name = fetchName(); \n"
+			"} \n");
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+
+		// The context is suspended while it waits for the call
+		ctx = engine->CreateContext();
+		ctx->Prepare(mod->GetFunctionByDecl("void main()"));
+		r = ctx->Execute();
+		if( r != asEXECUTION_SUSPENDED || pendingCalls.size() != 1 || ctx->GetAsyncCall() != pendingCalls[0] )
+			TEST_FAILED;
+		r = ctx->Execute();
+		if( r != asEXECUTION_SUSPENDED )
+			TEST_FAILED;
+
+		// The application doesn't need to keep the context while it waits
+		ctx->Release();
+		ctx = 0;
+
+		int values[] = {10, 20};
+		for( int n = 0; n < 2; n++ )
+		{
+			asIAsyncCall *call = pendingCalls[0];
+			pendingCalls.clear();
+			if( call->SetReturnObject(0) != asINVALID_TYPE )
+				TEST_FAILED;
+			call->SetReturnDWord(values[n]);
+			if( call->Complete() < 0 || !call->IsCompleted() )
+				TEST_FAILED;
+			call->Release();
+
+			// The completion made the context runnable
+			if( readyContexts.size() != 1 )
+				TEST_FAILED;
+			else
+			{
+				ctx = readyContexts[0];
+				readyContexts.clear();
+				r = ctx->Execute();
+				if( r != asEXECUTION_SUSPENDED || pendingCalls.size() != 1 )
+					TEST_FAILED;
+				ctx->Release();
+			}
+		}
+
+		// Complete the call with a handle
+		CScriptString *str = new CScriptString("hello");
+		pendingCalls[0]->SetReturnObject(str);
+		str->Release();
+		pendingCalls[0]->Complete();
+		pendingCalls[0]->Release();
+		pendingCalls.clear();
+		if( readyContexts.size() != 1 )
+			TEST_FAILED;
+		ctx = readyContexts[0];
+		readyContexts.clear();
+		r = ctx->Execute();
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+		if( *(int*)mod->GetAddressOfGlobalVar(0) != 38 ||
+			((CScriptString*)mod->GetAddressOfGlobalVar(1))->buffer != "hello" )
+			TEST_FAILED;
+		ctx->Release();
+
+		// An exception can be raised in the script when the call fails
+		ctx = engine->CreateContext();
+		ctx->Prepare(mod->GetFunctionByDecl("void main()"));
+		r = ctx->Execute();
+		if( r != asEXECUTION_SUSPENDED || pendingCalls.size() != 1 )
+			TEST_FAILED;
+		pendingCalls[0]->CompleteWithException("Not found");
+		pendingCalls[0]->Release();
+		pendingCalls.clear();
+		readyContexts[0]->Release();
+		readyContexts.clear();
+		r = ctx->Execute();
+		if( r != asEXECUTION_EXCEPTION || std::string(ctx->GetExceptionString()) != "Not found" )
+			TEST_FAILED;
+
+		// A call that is still pending when the context is aborted cannot be completed
+		ctx->Prepare(mod->GetFunctionByDecl("void main()"));
+		r = ctx->Execute();
+		if( r != asEXECUTION_SUSPENDED || pendingCalls.size() != 1 )
+			TEST_FAILED;
+		ctx->Abort();
+		if( ctx->GetAsyncCall() != 0 || pendingCalls[0]->GetContext() != 0 )
+			TEST_FAILED;
+		if( pendingCalls[0]->Complete() != asCONTEXT_NOT_PREPARED || readyContexts.size() != 0 )
+			TEST_FAILED;
+		pendingCalls[0]->Release();
+		pendingCalls.clear();
+		ctx->Release();
+
+		engine->Release();
+	}
+
+	// Test saving a suspended execution and restoring it on another engine
+	{
+		const char *script =
+			"class Quest \n"
+			"{ \n"
+			"  int stage = 0; \n"
+			"  void Run(const string &in greeting) \n"
+			"  { \n"
+			"    string msg = greeting + '!'; \n"
+			"    for( int n = 0; n < 3; n++ ) \n"
+			"    { \n"
+			"      stage++; \n"
+			"      wait(); \n"
+			"      log += msg + stage; \n"
+			"    } \n"
+			"  } \n"
+			"} \n"
+			"string log; \n"
+			"void main() \n"
+			"{ \n"
+			"  Quest q; \n"
+			"  double d = 1.5; \n"
+			"  string greeting = 'hi'; \n"
+			"  q.Run(greeting); \n"
+			"  log += ' ' + d + ' ' + q.stage; \n"
+			"} \n"
+			"int pause() \n"
+			"{ \n"
+			"  wait(); \n"
+			"  return 1; \n"
+			"} \n"
+			"void interrupted() \n"
+			"{ \n"
+			"  log += 'x' + pause(); \n"
+			"} \n";
+
+		COutStream out;
+		asIScriptEngine *engines[2];
+		for( int n = 0; n < 2; n++ )
+		{
+			engines[n] = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+			engines[n]->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+			RegisterStdString(engines[n]);
+			engines[n]->RegisterGlobalFunction("void wait()", asFUNCTION(Wait), asCALL_GENERIC);
+
+			mod = engines[n]->GetModule("quest", asGM_ALWAYS_CREATE);
+			mod->AddScriptSection(TESTNAME, script);
+			r = mod->Build();
+			if( r < 0 )
+				TEST_FAILED;
+		}
+
+		// Run the quest until it is suspended for the second time
+		ctx = engines[0]->CreateContext();
+		ctx->Prepare(engines[0]->GetModule("quest")->GetFunctionByDecl("void main()"));
+		CBytecodeStream stream(__FILE__"1");
+		CStateSerializer saver(engines[0]);
+		if( ctx->SaveExecutionState(&stream, &saver) != asERROR )
+			TEST_FAILED;
+		r = ctx->Execute();
+		if( r != asEXECUTION_SUSPENDED )
+			TEST_FAILED;
+		r = ctx->Execute();
+		if( r != asEXECUTION_SUSPENDED )
+			TEST_FAILED;
+		r = ctx->SaveExecutionState(&stream, &saver);
+		if( r < 0 )
+			TEST_FAILED;
+		ctx->Release();
+
+		// The state can only be restored where the same module exists
+		asIScriptContext *ctx2 = engines[1]->CreateContext();
+		mod = engines[1]->GetModule("quest");
+		mod->SetName("other");
+		{
+			CStateSerializer loader(engines[1]);
+			r = ctx2->LoadExecutionState(&stream, &loader);
+			if( r != asERROR || ctx2->GetState() == asEXECUTION_SUSPENDED )
+				TEST_FAILED;
+		}
+		mod->SetName("quest");
+
+		// Continue the execution on the other engine
+		stream.Restart();
+		{
+			CStateSerializer loader(engines[1]);
+			r = ctx2->LoadExecutionState(&stream, &loader);
+			if( r < 0 || ctx2->GetState() != asEXECUTION_SUSPENDED )
+				TEST_FAILED;
+			if( loader.loaded.size() != 1 || *(int*)loader.loaded[0]->GetAddressOfProperty(0) != 2 )
+				TEST_FAILED;
+		}
+		if( ctx2->LoadExecutionState(&stream, 0) != asINVALID_ARG )
+			TEST_FAILED;
+		r = ctx2->Execute();
+		if( r != asEXECUTION_SUSPENDED )
+			TEST_FAILED;
+		r = ctx2->Execute();
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+		std::string log = *(std::string*)mod->GetAddressOfGlobalVar(0);
+		if( log != "hi!2hi!3 1.5 3" )
+		{
+			printf("%s\n", log.c_str());
+			TEST_FAILED;
+		}
+		ctx2->Release();
+
+		// The execution cannot be saved in the middle of a statement, as
+		// the temporary values may refer to memory that isn't restored
+		ctx = engines[0]->CreateContext();
+		ctx->Prepare(engines[0]->GetModule("quest")->GetFunctionByDecl("void interrupted()"));
+		r = ctx->Execute();
+		if( r != asEXECUTION_SUSPENDED )
+			TEST_FAILED;
+		CBytecodeStream stream2(__FILE__"2");
+		r = ctx->SaveExecutionState(&stream2, &saver);
+		if( r != asNOT_SUPPORTED )
+			TEST_FAILED;
+		ctx->Release();
+
+		engines[0]->Release();
+		engines[1]->Release();
+	}
+
 	// Success
 	return fail;
 }
@@ -616,6 +616,38 @@ bool Test()
 		engine->Release();
 	}
 
+	// Methods registered for a template after it has been instanced must be added to the existing instances too
+	{
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream, Callback), &out, asCALL_THISCALL);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+		RegisterStdString(engine);
+
+		r = engine->RegisterObjectType("MyTmpl<class T>", 0, asOBJ_REF | asOBJ_TEMPLATE); assert( r >= 0 );
+		r = engine->RegisterObjectBehaviour("MyTmpl<T>", asBEHAVE_FACTORY, "MyTmpl<T> @f(int &in)", asFUNCTIONPR(MyTmpl_factory, (asIObjectType*), MyTmpl*), asCALL_CDECL); assert( r >= 0 );
+		r = engine->RegisterObjectBehaviour("MyTmpl<T>", asBEHAVE_ADDREF, "void f()", asMETHOD(MyTmpl, AddRef), asCALL_THISCALL); assert( r >= 0 );
+		r = engine->RegisterObjectBehaviour("MyTmpl<T>", asBEHAVE_RELEASE, "void f()", asMETHOD(MyTmpl, Release), asCALL_THISCALL); assert( r >= 0 );
+
+		// The declaration of the property creates the template instance
+		MyTmpl *prop = 0;
+		r = engine->RegisterGlobalProperty("MyTmpl<int> @prop", &prop); assert( r >= 0 );
+		asIObjectType *ot = engine->GetObjectTypeById(engine->GetTypeIdByDecl("MyTmpl<int>"));
+		if( ot == 0 || ot->GetMethodCount() != 0 )
+			TEST_FAILED;
+
+		r = engine->RegisterObjectMethod("MyTmpl<T>", "string typeName()", asMETHOD(MyTmpl, GetNameOfType), asCALL_THISCALL); assert( r >= 0 );
+		if( ot == 0 || ot->GetMethodCount() != 1 || ot->GetMethodByName("typeName") == 0 )
+			TEST_FAILED;
+
+		// The existing instance and the ones created afterwards have the method
+		r = ExecuteString(engine, "MyTmpl<int> a; assert( a.typeName() == 'MyTmpl<int>' ); \n"
+		                          "MyTmpl<float> b; assert( b.typeName() == 'MyTmpl<float>' );");
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		engine->Release();
+	}
+
  	return fail;
 }
 
@@ -127,6 +127,46 @@ static CComplex cfunction5(int f1, double f3, float f2, int f4)
 }
 
 
+// These functions test the different ways the arguments can be
+// distributed over the registers, and the stack when they don't fit
+static float cfunction6(int a, int b, int c, int d, int e, int f)
+{
+	return float(a + b + c + d + e + f) + 0.5f;
+}
+
+static double cfunction7(int a, double b, int c, float d, asINT64 e, double f, int g, float h, int i, double j)
+{
+	return a + b + c + d + e + f + g + h + i + j;
+}
+
+static int cfunction8(int a, int b, int c, int d, int e, int f, int g, double h, double i, double j, double k, double l, double m, double n, double o, double p)
+{
+	return a + b + c + d + e + f + g + int(h + i + j + k + l + m + n + o + p);
+}
+
+static int cfunction9(void *ref, int typeId, float f)
+{
+	if( typeId == asTYPEID_INT32 )
+		return *(int*)ref + int(f);
+	return -1;
+}
+
+class CMixedArgs
+{
+public:
+	CMixedArgs() : base(1000) {}
+	asINT64 method(int a, asINT64 b, char c, int d, short e) { return base + a + b + c + d + e; }
+	float methodFloat(float a, int b) { return a * b + base; }
+	int base;
+};
+
+static float objLast(float a, CMixedArgs *obj)
+{
+	return a + obj->base;
+}
+
+static CMixedArgs mixedArgsObj;
+
 bool TestExecuteMixedArgs()
 {
 	bool fail = false;
@@ -210,6 +250,28 @@ bool TestExecuteMixedArgs()
 			printf("\n%s: testVal is not of expected value. Got (%d, %f, %f, %c), expected (%d, %f, %f, %c)\n\n", TESTNAME, t1, t2, t3, t4, 10, 1.92f, 3.88, 97);
 			TEST_FAILED;
 		}
+
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+		engine->RegisterGlobalFunction("float cfunction6(int, int, int, int, int, int)", asFUNCTION(cfunction6), asCALL_CDECL);
+		engine->RegisterGlobalFunction("double cfunction7(int, double, int, float, int64, double, int, float, int, double)", asFUNCTION(cfunction7), asCALL_CDECL);
+		engine->RegisterGlobalFunction("int cfunction8(int, int, int, int, int, int, int, double, double, double, double, double, double, double, double, double)", asFUNCTION(cfunction8), asCALL_CDECL);
+		engine->RegisterGlobalFunction("int cfunction9(?&in, float)", asFUNCTION(cfunction9), asCALL_CDECL);
+		engine->RegisterObjectType("mixed", 0, asOBJ_REF | asOBJ_NOHANDLE);
+		engine->RegisterObjectMethod("mixed", "int64 method(int, int64, int8, int, int16)", asMETHOD(CMixedArgs, method), asCALL_THISCALL);
+		engine->RegisterObjectMethod("mixed", "float methodFloat(float, int)", asMETHOD(CMixedArgs, methodFloat), asCALL_THISCALL);
+		engine->RegisterObjectMethod("mixed", "float objLast(float)", asFUNCTION(objLast), asCALL_CDECL_OBJLAST);
+		engine->RegisterGlobalProperty("mixed obj", &mixedArgsObj);
+
+		int r = ExecuteString(engine,
+			"assert( cfunction6(1, 2, 3, 4, 5, 6) == 21.5f ); \n"
+			"assert( cfunction7(1, 2.5, 3, 4.5f, 0x100000000, 6.5, 7, 8.5f, 9, 10.5) == 4294967348.5 ); \n"
+			"assert( cfunction8(1, 2, 3, 4, 5, 6, 7, 1.5, 2.5, 3, 4, 5, 6, 7, 8, 9) == 74 ); \n"
+			"assert( cfunction9(40, 2.5f) == 42 ); \n"
+			"assert( obj.method(1, 0x100000000, -3, 4, -5) == 0x100000000 + 997 ); \n"
+			"assert( obj.methodFloat(1.5f, 2) == 1003 ); \n"
+			"assert( obj.objLast(0.25f) == 1000.25f ); \n");
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
 	}
 
 	engine->Release();
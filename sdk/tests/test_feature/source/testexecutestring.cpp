@@ -35,13 +35,111 @@ bool TestExecuteString()
 	ExecuteString(engine, "g_Obj.a = true;\n"
 		                  "g_Obj.b = false;\n");
 
-	engine->Release();
-
 	if( !g_Obj.a || g_Obj.b )
 	{
 		printf("%s: ExecuteString() didn't execute correctly\n", TESTNAME);
 		TEST_FAILED;
 	}
+
+	// Test the cache of compiled statements
+	{
+		int r;
+		CExecuteStringCache cache(engine, 2);
+
+		// The same code is only compiled once
+		for( int n = 0; n < 3; n++ )
+		{
+			r = cache.Execute("g_Obj.a = !g_Obj.a;");
+			if( r != asEXECUTION_FINISHED )
+				TEST_FAILED;
+		}
+		if( g_Obj.a || cache.GetCachedCount() != 1 )
+			TEST_FAILED;
+
+		// Bind the arguments through the context
+		for( int n = 0; n < 2; n++ )
+		{
+			asIScriptContext *ctx = 0;
+			r = cache.Prepare("g_Obj.b = v;", "bool v", 0, &ctx);
+			if( r < 0 || ctx == 0 )
+				TEST_FAILED;
+			else
+			{
+				ctx->SetArgByte(0, n == 0);
+				r = ctx->Execute();
+				if( r != asEXECUTION_FINISHED || g_Obj.b != (n == 0) )
+					TEST_FAILED;
+				cache.ReturnContext(ctx);
+			}
+		}
+		if( cache.GetCachedCount() != 2 )
+			TEST_FAILED;
+
+		// Code that doesn't compile is not cached
+		CBufferedOutStream bout;
+		engine->SetMessageCallback(asMETHOD(CBufferedOutStream,Callback), &bout, asCALL_THISCALL);
+		r = cache.Execute("g_Obj.c = true;");
+		if( r >= 0 || bout.buffer == "" || cache.GetCachedCount() != 2 )
+			TEST_FAILED;
+		engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+
+		// The least recently used function is discarded when the cache is full
+		asIScriptModule *mod = engine->GetModule("mod", asGM_ALWAYS_CREATE);
+		mod->AddScriptSection("script", "int g = 0;");
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+		cache.Execute("g++;", mod);
+		cache.Execute("g++;", mod);
+		if( *(int*)mod->GetAddressOfGlobalVar(0) != 2 || cache.GetCachedCount() != 2 )
+			TEST_FAILED;
+		cache.Execute("g_Obj.a = true;");
+		if( !g_Obj.a || cache.GetCachedCount() != 2 )
+			TEST_FAILED;
+
+		// The functions compiled for a module can be released before the module is rebuilt
+		cache.ClearModule(mod);
+		if( cache.GetCachedCount() != 1 )
+			TEST_FAILED;
+
+		// The functions compiled for a module that has been discarded are 
+		// dropped when the next function is compiled
+		cache.Execute("g++;", mod);
+		if( cache.GetCachedCount() != 2 )
+			TEST_FAILED;
+		engine->DiscardModule("mod");
+		cache.Execute("g_Obj.b = true;");
+		if( !g_Obj.b || cache.GetCachedCount() != 2 )
+			TEST_FAILED;
+
+		// A new module with the same name gets its own function
+		mod = engine->GetModule("mod", asGM_ALWAYS_CREATE);
+		mod->AddScriptSection("script", "int g = 10;");
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+		r = cache.Execute("g++;", mod);
+		if( r != asEXECUTION_FINISHED || *(int*)mod->GetAddressOfGlobalVar(0) != 11 || cache.GetCachedCount() != 2 )
+			TEST_FAILED;
+
+		// The function is compiled again when the module is rebuilt
+		asUINT buildId = mod->GetBuildId();
+		mod->AddScriptSection("script", "int g = 20;");
+		r = mod->Build();
+		if( r < 0 || mod->GetBuildId() == buildId )
+			TEST_FAILED;
+		r = cache.Execute("g++;", mod);
+		if( r != asEXECUTION_FINISHED || *(int*)mod->GetAddressOfGlobalVar(0) != 21 || cache.GetCachedCount() != 2 )
+			TEST_FAILED;
+		cache.ClearModule(mod);
+		engine->DiscardModule("mod");
+	}
+
+	// The module used for the statements without a module is discarded with the cache
+	if( engine->GetModule("ExecuteStringCache", asGM_ONLY_IF_EXISTS) != 0 )
+		TEST_FAILED;
+
+	engine->Release();
 	
 	// Success
 	return fail;
@@ -47,5 +47,64 @@ bool TestStack()
 	ctx->Release();
 	engine->Release();
 
+	// Calls in tail position reuse the stack frame of the caller when asEP_ELIMINATE_TAIL_CALLS is set
+	{
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+		engine->SetEngineProperty(asEP_ELIMINATE_TAIL_CALLS, true);
+		engine->SetEngineProperty(asEP_MAX_STACK_SIZE, 1024);
+
+		mod = engine->GetModule(0, asGM_ALWAYS_CREATE);
+		mod->AddScriptSection(TESTNAME,
+			"int sum(int n, int acc) \n"
+			"{ \n"
+			"  if( n == 0 ) \n"
+			"    return acc; \n"
+			"  return sum(n - 1, acc + n); \n"
+			"} \n"
+			"bool isEven(uint n) \n"
+			"{ \n"
+			"  if( n == 0 ) return true; \n"
+			"  return isOdd(n - 1); \n"
+			"} \n"
+			"bool isOdd(uint n) \n"
+			"{ \n"
+			"  if( n == 0 ) return false; \n"
+			"  return isEven(n - 1); \n"
+			"} \n"
+			"int notTail(int n) \n"
+			"{ \n"
+			"  if( n == 0 ) return 0; \n"
+			"  return notTail(n - 1) + 1; \n"
+			"} \n");
+		r = mod->Build();
+		if( r < 0 )
+			TEST_FAILED;
+
+		ctx = engine->CreateContext();
+		ctx->Prepare(mod->GetFunctionByDecl("int sum(int, int)"));
+		ctx->SetArgDWord(0, 100000);
+		ctx->SetArgDWord(1, 0);
+		r = ctx->Execute();
+		if( r != asEXECUTION_FINISHED || ctx->GetReturnDWord() != 705082704 )
+			TEST_FAILED;
+
+		ctx->Prepare(mod->GetFunctionByDecl("bool isEven(uint)"));
+		ctx->SetArgDWord(0, 100001);
+		r = ctx->Execute();
+		if( r != asEXECUTION_FINISHED || ctx->GetReturnByte() != 0 )
+			TEST_FAILED;
+
+		// Calls that are not in tail position must still grow the stack
+		ctx->Prepare(mod->GetFunctionByDecl("int notTail(int)"));
+		ctx->SetArgDWord(0, 100000);
+		r = ctx->Execute();
+		if( r != asEXECUTION_EXCEPTION )
+			TEST_FAILED;
+
+		ctx->Release();
+		engine->Release();
+	}
+
 	return fail;
 }
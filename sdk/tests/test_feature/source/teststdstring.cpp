@@ -6,6 +6,7 @@
 //
 
 #include "utils.h"
+#include <list>
 using namespace std;
 
 static const char * const TESTNAME = "TestStdString";
@@ -22,6 +23,14 @@ static void PrintStringVal(string str)
 	printOutput = str;
 }
 
+static list<string> constants;
+
+static void *CreateConstant(const char *s, asUINT length, void *)
+{
+	constants.push_back(string(s, length));
+	return &constants.back();
+}
+
 // This script tests that variables are created and destroyed in the correct order
 static const char *script =
 "void blah1()\n"
@@ -346,6 +355,25 @@ bool TestStdString()
 			"      arr[2] == ''  && \n"
 			"      arr[3] == 'D' ); \n"
 			"  assert( join(arr, ';') == 'A;B;;D' ); \n"
+			"  assert( 'A::B::'.split('::').length() == 3 ); \n"
+			"  assert( 'AB'.split('').length() == 1 ); \n"
+			"  assert( join(array<string>(), ';') == '' ); \n"
+			"  @arr = ' a, b;;c '.tokenize(',; '); \n"
+			"  assert( arr.length() == 3 && arr[0] == 'a' && arr[1] == 'b' && arr[2] == 'c' ); \n"
+			"  assert( ',;'.tokenize(',;').length() == 0 ); \n"
+			"  @arr = 'ab,c'.tokenize(','); \n"
+			"  assert( arr.length() == 2 && arr[0] == 'ab' && arr[1] == 'c' ); \n"
+			"  assert( 'a-b-c'.replace('-', '+-') == 'a+-b+-c' ); \n"
+			"  assert( 'aaaa'.replace('aa', 'b') == 'bb' ); \n"
+			"  assert( 'abc'.replace('', 'x') == 'abc' ); \n"
+			"  assert( 'aaaa'.count('aa') == 2 ); \n"
+			"  assert( 'abc'.count('') == 0 ); \n"
+			// Count over more than 255 blocks of 16 characters
+			"  string long; \n"
+			"  for( int n = 0; n < 5000; n++ ) \n"
+			"    long += (n % 3 == 0) ? '|' : 'x'; \n"
+			"  assert( long.count('|') == 1667 ); \n"
+			"  assert( long.split('|').length() == 1668 ); \n"
 			"  assert( formatInt(123456789012345, 'l', 20).length() == 20 ); \n"
 			"  assert( formatFloat(123.456, '', 20, 10).length() == 20 ); \n"
 		    "  assert( parseInt('1234') == 1234 ); \n"
@@ -357,6 +385,94 @@ bool TestStdString()
 		engine->Release();
 	}
 
+	// Test the string builder
+	{
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+
+		RegisterStdString(engine);
+		RegisterStdStringBuilder(engine);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+		r = ExecuteString(engine, 
+			"  stringbuilder sb; \n"
+			"  assert( sb.isEmpty() ); \n"
+			"  sb.reserve(100); \n"
+			"  sb += 'a'; \n"
+			"  sb += 1; \n"
+			"  sb += -23; \n"
+			"  sb += 4.5; \n"
+			"  sb += true; \n"
+			"  sb.append('|').append(uint64(18446744073709551615)).append('|').append(int64(-9223372036854775807-1)); \n"
+			"  sb.append('|').appendInt(255, 'H', 4).append('|').appendFloat(3.14159, '', 0, 2); \n"
+			"  stringbuilder copy = sb; \n"
+			"  string str = sb.str(); \n"
+			"  assert( str == 'a1-234.5true|18446744073709551615|-9223372036854775808|  FF|3.14' ); \n"
+			// The text is moved out of the builder
+			"  assert( sb.length == 0 ); \n"
+			"  assert( copy.str() == str ); \n"
+			"  for( int n = 0; n < 1000; n++ ) \n"
+			"    sb += n % 10; \n"
+			"  assert( sb.length() == 1000 ); \n"
+			"  sb.clear(); \n"
+			"  assert( sb.str() == '' ); \n");
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		engine->Release();
+	}
+
+	// Test that the string constants are created in advance, so 
+	// the literals are evaluated without calling the string factory
+	{
+		engine = asCreateScriptEngine(ANGELSCRIPT_VERSION);
+		engine->SetMessageCallback(asMETHOD(COutStream,Callback), &out, asCALL_THISCALL);
+
+		// The objects can't be used without a string factory that returns a reference
+		r = engine->SetStringConstantCallback(CreateConstant, 0);
+		if( r != asNOT_SUPPORTED )
+			TEST_FAILED;
+
+		RegisterStdString(engine);
+		engine->RegisterGlobalFunction("void assert(bool)", asFUNCTION(Assert), asCALL_GENERIC);
+
+		r = engine->SetStringConstantCallback(CreateConstant, 0);
+		if( r < 0 )
+			TEST_FAILED;
+
+		constants.clear();
+		r = ExecuteString(engine, 
+			"  for( int n = 0; n < 10; n++ ) \n"
+			"  { \n"
+			"    string str = 'abc'; \n"
+			"    str += 'def'; \n"
+			"    assert( str == 'abcdef' ); \n"
+			"    assert( 'abc' != 'def' ); \n"
+			"  } \n");
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+
+		// Each constant is created once when the script is built
+		if( constants.size() != 3 )
+			TEST_FAILED;
+
+		// Without the objects created in advance the string factory is called instead
+		r = engine->SetStringConstantCallback(0, 0);
+		if( r < 0 )
+			TEST_FAILED;
+
+		r = ExecuteString(engine, 
+			"  string str = 'abc'; \n"
+			"  str += 'ghi'; \n"
+			"  assert( str == 'abcghi' ); \n");
+		if( r != asEXECUTION_FINISHED )
+			TEST_FAILED;
+		if( constants.size() != 3 )
+			TEST_FAILED;
+
+		engine->Release();
+	}
+
 	return fail;
 }
 
@@ -5,6 +5,15 @@
 #endif
 #include <map>
 
+// The memory functions are also called from the worker threads of the context manager
+#if __cplusplus >= 201103L || (defined(_MSC_VER) && _MSC_VER >= 1900)
+#include <mutex>
+static std::mutex memLock;
+#define MEMORY_LOCK std::lock_guard<std::mutex> memoryLock(memLock)
+#else
+#define MEMORY_LOCK
+#endif
+
 using namespace std;
 
 
@@ -77,6 +86,8 @@ void *MyAllocWithStats(size_t size, const char *file, int line)
 	UNUSED_VAR(line);
 	UNUSED_VAR(file);
 
+	MEMORY_LOCK;
+
 	// Allocate the memory
 	void *ptr = malloc(size);
 
@@ -124,6 +135,8 @@ void *MyAllocWithStats(size_t size, const char *file, int line)
 
 void MyFreeWithStats(void *address)
 {
+	MEMORY_LOCK;
+
 	// Count the number of deallocations made
 	numFrees++;
 
@@ -152,6 +165,12 @@ void MyFreeWithStats(void *address)
 	free(address);
 }
 
+// Returns the number of allocations made through the memory manager so far
+int GetNumAllocations()
+{
+	return numAllocs;
+}
+
 void InstallMemoryManager()
 {
 #ifdef TRACK_LOCATIONS
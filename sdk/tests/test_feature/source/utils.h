@@ -36,6 +36,15 @@ using std::memcpy;
 using namespace AngelScript;
 #endif
 
+// Creates an engine that verifies the bytecode of all functions as they are compiled or loaded
+inline asIScriptEngine *CreateVerifyingScriptEngine(asDWORD version)
+{
+	asIScriptEngine *engine = asCreateScriptEngine(version);
+	if( engine )
+		engine->SetEngineProperty(asEP_VERIFY_BYTECODE, true);
+	return engine;
+}
+
 #if defined(__GNUC__) && !(defined(__ppc__) || defined(__PPC__))
 #define STDCALL __attribute__((stdcall))
 #elif defined(_MSC_VER) || defined(__BORLANDC__)
@@ -164,6 +173,7 @@ protected:
 void Assert(asIScriptGeneric *gen);
 
 void InstallMemoryManager();
+int  GetNumAllocations();
 void RemoveMemoryManager();
 int  GetNumAllocs();
 